@@ -109,91 +109,67 @@ void FiffProducer::run()
     //
     fiff_int_t from = m_pFiffSimulator->m_RawInfo.first_samp;
     fiff_int_t to = m_pFiffSimulator->m_RawInfo.last_samp;
-//    float quantum_sec = (float)uiSamplePeriod/1000000.0f; //read and write in 10 sec junks
-    fiff_int_t quantum = m_pFiffSimulator->m_uiBufferSampleSize;//ceil(quantum_sec*m_pFiffSimulator->m_pRawInfo->info.sfreq);
+    fiff_int_t quantum = m_pFiffSimulator->m_uiBufferSampleSize;
 
-    qDebug() << "quantum " << quantum;
+    //One segment read fills the whole circular buffer, fewer and larger reads keep up with high replay rates
+    fiff_int_t t_iSegmentSize = quantum*RAW_BUFFFER_SIZE;
+
+    qDebug() << "quantum " << quantum << "segment" << t_iSegmentSize;
 
     //
-    //   To read the whole file at once set
-    //
-    //quantum     = to - from + 1;
-    //
-    //
-    //   Read and write all the data
+    //   Read ahead of the simulator, which paces the buffers by its clock. The samples of a segment are
+    //   copied straight into the free slots of the circular buffer, the file restarts from the beginning
+    //   at its end.
     //
-
-    fiff_int_t first, last;
+    fiff_int_t first = from;
+    fiff_int_t last;
     MatrixXd data;
     MatrixXd times;
+    MatrixXf t_matSegment;
+    qint32 t_iSegmentOffset = 0;
 
-    first = from;
-
-//    //Calibration - Is taken care of during read_raw_segment(...) later in the code
-//    qint32 nchan = m_pFiffSimulator->m_RawInfo.info.nchan;
-//    MatrixXd cals(1,nchan);
-//    SparseMatrix<double> inv_calsMat(nchan, nchan);
-//    for(qint32 i = 0; i < nchan; ++i)
-//        inv_calsMat.insert(i, i) = 1.0f/m_pFiffSimulator->m_RawInfo.info.chs[i].cal;
-
-    //Not good cause production time is not accurate
-    //loading and thread sleep is longer than thread sleep time - better to have a extra loading thread
-    // ToDo restructure this producer as laoding buffer --> and thread sleep to simulator buffer
-    fiff_int_t t_iDiff;
-    bool t_bRestart = false;
+    MatrixXf* t_pSlot = NULL;
+    qint32 t_iSlotFilled = 0;
 
     while(m_bIsRunning)
     {
-        last = first+quantum-1;
-        if (last > to)
+        if(t_iSegmentOffset >= t_matSegment.cols())
         {
-            t_iDiff = last - to;
-            t_bRestart = true;
-
-            last = to;
-        }
-
-        if (!m_pFiffSimulator->m_RawInfo.read_raw_segment(data,times,first,last))
-        {
-            printf("error during read_raw_segment\n");
-        }
-
-        MatrixXf tmp = data.cast<float>();//(inv_calsMat*data).cast<float>();
-
-        if(t_bRestart)
-        {
-            //
-            // Case end of Simulation: restart file from the beginning and read remaining bytes
-            //
-            printf("### RESTART Simulation File ###\r\n");
-
-            first = from;
-            last = first+t_iDiff-1;
+            last = qMin(first+t_iSegmentSize-1, to);
 
             if (!m_pFiffSimulator->m_RawInfo.read_raw_segment(data,times,first,last))
             {
                 printf("error during read_raw_segment\n");
+                msleep(100);
+                continue;
             }
 
-            MatrixXf tmp2 = data.cast<float>();//(inv_calsMat*data).cast<float>();
+            t_matSegment = data.cast<float>();
+            t_iSegmentOffset = 0;
 
-            MatrixXf tmp3(tmp.rows(), tmp.cols()+tmp2.cols());
+            first = last+1;
+            if(first > to)
+            {
+                printf("### RESTART Simulation File ###\r\n");
+                first = from;
+            }
+        }
 
-            tmp3.block(0,0,tmp.rows(),tmp.cols()) = tmp;
-            tmp3.block(0,tmp.cols(),tmp.rows(),tmp2.cols()) = tmp2;
+        //Waits at most 100ms for a free slot to react to stop()
+        if(!t_pSlot && !(t_pSlot = m_pFiffSimulator->m_pRawMatrixBuffer->acquireWrite(100)))
+            continue;
 
-            tmp = tmp3;
+        qint32 t_iCount = qMin<qint32>(quantum - t_iSlotFilled, t_matSegment.cols() - t_iSegmentOffset);
+        t_pSlot->middleCols(t_iSlotFilled, t_iCount) = t_matSegment.middleCols(t_iSegmentOffset, t_iCount);
+        t_iSlotFilled += t_iCount;
+        t_iSegmentOffset += t_iCount;
 
-            t_bRestart = false;
-            first += t_iDiff;
-        }
-        else
+        if(t_iSlotFilled == quantum)
         {
-            first += quantum;
+            m_pFiffSimulator->m_pRawMatrixBuffer->commit();
+            t_pSlot = NULL;
+            t_iSlotFilled = 0;
         }
-
-        // call blocks until there is free space in the buffer
-        m_pFiffSimulator->m_pRawMatrixBuffer->push(&tmp);
     }
 
     // close datastream in this thread
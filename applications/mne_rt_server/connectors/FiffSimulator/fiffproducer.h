@@ -82,7 +82,10 @@ class FiffSimulator;
 /**
 * DECLARE CLASS FiffProducer
 *
-* @brief The FiffProducer class provides a ECG data producer for a given sampling rate.
+* The FiffProducer reads the simulation file ahead of the FiffSimulator in segments of several raw buffers and
+* fills the free slots of the circular buffer, the FiffSimulator paces the buffers by its clock.
+*
+* @brief The FiffProducer class provides the reader thread of the FiffSimulator.
 */
 class FiffProducer : public QThread
 {
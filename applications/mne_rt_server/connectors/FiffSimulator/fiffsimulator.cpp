@@ -78,6 +78,7 @@
 #include <QFile>
 #include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
 
 
 //*************************************************************************************************************
@@ -99,6 +100,8 @@ const QString FiffSimulator::Commands::GETBUFSIZE   = "getbufsize";
 const QString FiffSimulator::Commands::ACCEL        = "accel";
 const QString FiffSimulator::Commands::GETACCEL     = "getaccel";
 const QString FiffSimulator::Commands::SIMFILE      = "simfile";
+const QString FiffSimulator::Commands::PACING       = "pacing";
+const QString FiffSimulator::Commands::SIMSTATS     = "simstats";
 
 
 //*************************************************************************************************************
@@ -114,6 +117,8 @@ FiffSimulator::FiffSimulator()
 , m_TrueSamplingRate(0.0)
 , m_pRawMatrixBuffer(NULL)
 , m_bIsRunning(false)
+, m_bMaxThroughput(false)
+, m_statistics(PacingStatistics())
 {
     this->init();
 }
@@ -285,6 +290,75 @@ void FiffSimulator::comSimfile(Command p_command)
 }
 
 
+//*************************************************************************************************************
+
+void FiffSimulator::comPacing(Command p_command)
+{
+    QString t_sMode = p_command.pValues()[0].toString().trimmed();
+
+    if(t_sMode == "clock" || t_sMode == "max")
+    {
+        //Takes effect with the next buffer, no restart needed
+        m_qMutexPacing.lock();
+        m_bMaxThroughput = (t_sMode == "max");
+        m_qMutexPacing.unlock();
+
+        QString str = QString("\tSet %1 pacing to %2\r\n\n").arg(getName()).arg(t_sMode);
+        m_commandManager[Commands::PACING].reply(str);
+    }
+    else
+        m_commandManager[Commands::PACING].reply("Pacing not set, use clock or max\r\n");
+}
+
+
+//*************************************************************************************************************
+
+void FiffSimulator::comSimstats(Command p_command)
+{
+    m_qMutexPacing.lock();
+    PacingStatistics t_statistics = m_statistics;
+    bool t_bMaxThroughput = m_bMaxThroughput;
+    m_qMutexPacing.unlock();
+
+    double t_dElapsedSec = t_statistics.iElapsedNs / 1.0e9;
+    double t_dRate = t_dElapsedSec > 0.0 ? t_statistics.iSamples / t_dElapsedSec : 0.0;
+    double t_dJitterMeanUs = t_statistics.iPacedBuffers > 0 ? t_statistics.dJitterSumUs / t_statistics.iPacedBuffers : 0.0;
+
+    bool t_bCommandIsJson = p_command.isJson();
+    if(t_bCommandIsJson)
+    {
+        //
+        //create JSON statistics object
+        //
+        QJsonObject t_qJsonObjectStats;
+        t_qJsonObjectStats.insert("pacing", QJsonValue(QString(t_bMaxThroughput ? "max" : "clock")));
+        t_qJsonObjectStats.insert("buffers", QJsonValue((double)t_statistics.iBuffers));
+        t_qJsonObjectStats.insert("samples", QJsonValue((double)t_statistics.iSamples));
+        t_qJsonObjectStats.insert("elapsed", QJsonValue(t_dElapsedSec));
+        t_qJsonObjectStats.insert("rate", QJsonValue(t_dRate));
+        t_qJsonObjectStats.insert("sfreq", QJsonValue((double)m_RawInfo.info.sfreq));
+        t_qJsonObjectStats.insert("jitter_mean_us", QJsonValue(t_dJitterMeanUs));
+        t_qJsonObjectStats.insert("jitter_max_us", QJsonValue(t_statistics.dJitterMaxUs));
+        t_qJsonObjectStats.insert("resyncs", QJsonValue((double)t_statistics.iResyncs));
+
+        QJsonObject t_qJsonObjectRoot;
+        t_qJsonObjectRoot.insert(Commands::SIMSTATS, t_qJsonObjectStats);
+        QJsonDocument p_qJsonDocument(t_qJsonObjectRoot);
+
+        m_commandManager[Commands::SIMSTATS].reply(p_qJsonDocument.toJson());
+    }
+    else
+    {
+        QString str = QString("\tPacing: %1\r\n\tBuffers: %2 (%3 samples in %4 s)\r\n\tRate: %5 Hz of %6 Hz\r\n")
+                .arg(t_bMaxThroughput ? "max" : "clock").arg(t_statistics.iBuffers).arg(t_statistics.iSamples)
+                .arg(t_dElapsedSec, 0, 'f', 3).arg(t_dRate, 0, 'f', 1).arg(m_RawInfo.info.sfreq, 0, 'f', 1);
+        str.append(QString("\tJitter: %1 us mean, %2 us max\r\n\tResyncs: %3\r\n\n")
+                .arg(t_dJitterMeanUs, 0, 'f', 1).arg(t_statistics.dJitterMaxUs, 0, 'f', 1).arg(t_statistics.iResyncs));
+        m_commandManager[Commands::SIMSTATS].reply(str);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void FiffSimulator::connectCommandManager()
@@ -295,6 +369,8 @@ void FiffSimulator::connectCommandManager()
     QObject::connect(&m_commandManager[Commands::ACCEL], &Command::executed, this, &FiffSimulator::comAccel);
     QObject::connect(&m_commandManager[Commands::GETACCEL], &Command::executed, this, &FiffSimulator::comGetAccel);
     QObject::connect(&m_commandManager[Commands::SIMFILE], &Command::executed, this, &FiffSimulator::comSimfile);
+    QObject::connect(&m_commandManager[Commands::PACING], &Command::executed, this, &FiffSimulator::comPacing);
+    QObject::connect(&m_commandManager[Commands::SIMSTATS], &Command::executed, this, &FiffSimulator::comSimstats);
 }
 
 
@@ -514,26 +590,101 @@ bool FiffSimulator::readRawInfo()
 }
 
 
+//*************************************************************************************************************
+
+void FiffSimulator::printStatistics()
+{
+    m_qMutexPacing.lock();
+    PacingStatistics t_statistics = m_statistics;
+    m_qMutexPacing.unlock();
+
+    if(t_statistics.iBuffers == 0)
+        return;
+
+    double t_dElapsedSec = t_statistics.iElapsedNs / 1.0e9;
+    printf("%s: %lld buffers, %.1f Hz of %.1f Hz, jitter %.1f us mean, %.1f us max, %lld resyncs\r\n", getName(),
+           (long long)t_statistics.iBuffers, t_dElapsedSec > 0.0 ? t_statistics.iSamples / t_dElapsedSec : 0.0,
+           m_RawInfo.info.sfreq, t_statistics.iPacedBuffers > 0 ? t_statistics.dJitterSumUs / t_statistics.iPacedBuffers : 0.0,
+           t_statistics.dJitterMaxUs, (long long)t_statistics.iResyncs);
+}
+
+
 //*************************************************************************************************************
 
 void FiffSimulator::run()
 {
     m_bIsRunning = true;
 
-    float t_fSamplingFrequency = m_RawInfo.info.sfreq;
-    float t_fBuffSampleSize = (float)m_uiBufferSampleSize;
+    const double t_dSamplingFrequency = m_RawInfo.info.sfreq;
+
+    m_qMutexPacing.lock();
+    m_statistics = PacingStatistics();
+    bool t_bMaxThroughput = m_bMaxThroughput;
+    m_qMutexPacing.unlock();
 
-    quint32 uiSamplePeriod = (unsigned int) ((t_fBuffSampleSize/t_fSamplingFrequency)*1000000.0f);
+    //
+    // Every buffer has an absolute deadline, the time its last sample would have been acquired. The deadlines
+    // follow from the emitted samples and a monotonic clock, a late wake up delays one buffer but never the
+    // following ones.
+    //
+    QElapsedTimer t_timer;
+    t_timer.start();
 
-//    quint32 count = 0;
+    qint64 t_iOriginNs = 0;         //Clock time of the first sample since the last resync
+    qint64 t_iOriginSamples = 0;    //Samples emitted before the last resync
 
     while(m_bIsRunning)
     {
-        QSharedPointer<Eigen::MatrixXf> t_pRawBuffer(new Eigen::MatrixXf(m_pRawMatrixBuffer->pop()));
-//        ++count;
-//        printf("%d raw buffer (%d x %d) generated\r\n", count, t_pRawBuffer->rows(), t_pRawBuffer->cols());
+        //Waits at most 100ms for the reader to react to stop()
+        QSharedPointer<Eigen::MatrixXf> t_pRawBuffer(new Eigen::MatrixXf);
+        if(!m_pRawMatrixBuffer->tryPop(*t_pRawBuffer, 100))
+            continue;
+
+        m_qMutexPacing.lock();
+        const qint64 t_iSamples = m_statistics.iSamples;
+        const bool t_bWasMaxThroughput = t_bMaxThroughput;
+        t_bMaxThroughput = m_bMaxThroughput;
+        m_qMutexPacing.unlock();
+
+        qint64 t_iDeadlineNs = t_iOriginNs + (qint64)((t_iSamples - t_iOriginSamples + t_pRawBuffer->cols()) * 1.0e9 / t_dSamplingFrequency);
+        double t_dJitterUs = 0.0;
+        bool t_bResync = false;
+
+        if(!t_bMaxThroughput)
+        {
+            //A stalled reader or a switch from maximal throughput restarts the clock instead of bursting
+            if(t_bWasMaxThroughput || t_timer.nsecsElapsed() - t_iDeadlineNs > 1000000000)
+            {
+                t_bResync = !t_bWasMaxThroughput;
+                t_iOriginNs = t_timer.nsecsElapsed();
+                t_iOriginSamples = t_iSamples;
+                t_iDeadlineNs = t_iOriginNs + (qint64)(t_pRawBuffer->cols() * 1.0e9 / t_dSamplingFrequency);
+            }
+
+            //Sleep coarsely and yield for the last half millisecond, sleeping threads tend to wake up late
+            qint64 t_iWaitNs = t_iDeadlineNs - t_timer.nsecsElapsed();
+            if(t_iWaitNs > 500000)
+                usleep((t_iWaitNs - 500000)/1000);
+            while(t_timer.nsecsElapsed() < t_iDeadlineNs && m_bIsRunning)
+                QThread::yieldCurrentThread();
+
+            t_dJitterUs = qAbs(t_timer.nsecsElapsed() - t_iDeadlineNs) / 1000.0;
+        }
 
         emit remitRawBuffer(t_pRawBuffer);
-        usleep(uiSamplePeriod);
+
+        m_qMutexPacing.lock();
+        ++m_statistics.iBuffers;
+        m_statistics.iSamples += t_pRawBuffer->cols();
+        m_statistics.iElapsedNs = t_timer.nsecsElapsed();
+        if(!t_bMaxThroughput)
+            ++m_statistics.iPacedBuffers;
+        m_statistics.dJitterSumUs += t_dJitterUs;
+        m_statistics.dJitterMaxUs = qMax(m_statistics.dJitterMaxUs, t_dJitterUs);
+        if(t_bResync)
+            ++m_statistics.iResyncs;
+        m_qMutexPacing.unlock();
     }
+
+    printStatistics();
 }
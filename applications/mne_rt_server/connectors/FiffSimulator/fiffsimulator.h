@@ -111,6 +111,8 @@ public:
         static const QString ACCEL;
         static const QString GETACCEL;
         static const QString SIMFILE;
+        static const QString PACING;
+        static const QString SIMSTATS;
     };
 
     //=========================================================================================================
@@ -183,6 +185,22 @@ private:
     */
     void comSimfile(Command p_command);
 
+    //=========================================================================================================
+    /**
+    * Switches between clock driven pacing and maximal throughput
+    *
+    * @param[in] p_command  The pacing command.
+    */
+    void comPacing(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Returns the pacing statistics of the running simulation
+    *
+    * @param[in] p_command  The simulation statistics command.
+    */
+    void comSimstats(Command p_command);
+
     //////////
 
     //=========================================================================================================
@@ -193,6 +211,26 @@ private:
 
     bool readRawInfo();
 
+    //=========================================================================================================
+    /**
+    * Prints the pacing statistics, i.e. the achieved sampling rate and the deviation from the deadlines.
+    */
+    void printStatistics();
+
+    /**
+    * Pacing statistics since the start of the simulation.
+    */
+    struct PacingStatistics
+    {
+        qint64  iBuffers;           /**< Emitted raw buffers. */
+        qint64  iPacedBuffers;      /**< Raw buffers which were emitted at their deadline, i.e. not at maximal throughput. */
+        qint64  iSamples;           /**< Emitted samples. */
+        qint64  iElapsedNs;         /**< Time from the start to the last emitted buffer. */
+        double  dJitterSumUs;       /**< Sum of the absolute deviations of the paced buffers from their deadlines. */
+        double  dJitterMaxUs;       /**< Largest absolute deviation from a deadline. */
+        qint64  iResyncs;           /**< Restarts of the clock after the simulation fell more than a second behind. */
+    };
+
     QMutex mutex;
 
     FiffProducer*   m_pFiffProducer;        /**< Holds the DataProducer.*/
@@ -205,6 +243,10 @@ private:
     RawMatrixBuffer* m_pRawMatrixBuffer;    /**< The Circular Raw Matrix Buffer. */
 
     bool            m_bIsRunning;
+
+    QMutex           m_qMutexPacing;        /**< Guards the pacing mode and the statistics. */
+    bool             m_bMaxThroughput;      /**< Whether the buffers are emitted as fast as they are read, e.g. for load tests. */
+    PacingStatistics m_statistics;          /**< The pacing statistics of the current run. */
 };
 
 } // NAMESPACE
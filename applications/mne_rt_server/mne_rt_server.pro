@@ -39,6 +39,7 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     mne_rt_server \
-    connectors
+    connectors \
+    mne_rt_server_bench
 
 CONFIG += ordered
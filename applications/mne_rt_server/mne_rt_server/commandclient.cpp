@@ -0,0 +1,221 @@
+//=============================================================================================================
+/**
+* @file     commandclient.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief     implementation of the CommandClient Class. Replaces the CommandThread of July, 2012,
+*            its socket is served by an event loop of the IOThreadPool.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "commandclient.h"
+
+#include <realtime/rtCommand/commandparser.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtNetwork>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVER;
+using namespace REALTIMELIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+CommandClient::CommandClient(qintptr socketDescriptor, qint32 p_iId)
+: QObject()
+, m_iSocketDescriptor(socketDescriptor)
+, m_iThreadID(p_iId)
+, m_pTcpSocket(Q_NULLPTR)
+, m_iBlockSize(0)
+{
+
+}
+
+
+//*************************************************************************************************************
+
+CommandClient::~CommandClient()
+{
+    if(m_pTcpSocket)
+    {
+        m_pTcpSocket->disconnect(this);
+        m_pTcpSocket->abort();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void CommandClient::attachCommandReply(QString p_blockReply, qint32 p_iID)
+{
+    if(p_iID != m_iThreadID || !m_pTcpSocket)
+        return;
+
+    QByteArray block;
+    QDataStream out(&block, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_1);
+    out << (quint16)0;
+    out << p_blockReply;
+    out.device()->seek(0);
+    out << (quint16)(block.size() - sizeof(quint16));
+
+    m_pTcpSocket->write(block);
+    m_pTcpSocket->flush();
+}
+
+
+//*************************************************************************************************************
+
+void CommandClient::attachTaggedReply(QByteArray p_blockReply, qint32 p_iID)
+{
+    if(p_iID != m_iThreadID || !m_pTcpSocket)
+        return;
+
+    //The frame size has 16 bits, an oversized reply is split into several frames
+    QByteArray block;
+    QDataStream out(&block, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_1);
+
+    QList<QByteArray> t_qListFrames = CommandParser::splitReply(p_blockReply, 65000);
+    for(qint32 i = 0; i < t_qListFrames.size(); ++i)
+    {
+        out << (quint16)t_qListFrames[i].size();
+        out.writeRawData(t_qListFrames[i].constData(), t_qListFrames[i].size());
+    }
+
+    m_pTcpSocket->write(block);
+    m_pTcpSocket->flush();
+}
+
+
+//*************************************************************************************************************
+
+void CommandClient::open()
+{
+    m_pTcpSocket = new QTcpSocket(this);
+
+    if (!m_pTcpSocket->setSocketDescriptor(m_iSocketDescriptor)) {
+        emit error(m_pTcpSocket->error());
+        emit disconnected(m_iThreadID);
+        return;
+    }
+
+    m_pTcpSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+    printf("CommandClient connection accepted from\n\tIP:\t%s\n\tPort:\t%d\n\n",
+           QHostAddress(m_pTcpSocket->peerAddress()).toString().toUtf8().constData(),
+           m_pTcpSocket->peerPort());
+
+    connect(m_pTcpSocket, &QTcpSocket::readyRead, this, &CommandClient::readCommands);
+    connect(m_pTcpSocket, &QTcpSocket::disconnected, this, &CommandClient::onDisconnected);
+
+    readCommands();
+}
+
+
+//*************************************************************************************************************
+
+void CommandClient::onDisconnected()
+{
+    emit disconnected(m_iThreadID);
+}
+
+
+//*************************************************************************************************************
+
+void CommandClient::readCommands()
+{
+    if(!m_pTcpSocket)
+        return;
+
+    QDataStream t_FiffStreamIn(m_pTcpSocket);
+    t_FiffStreamIn.setVersion(QDataStream::Qt_5_1);
+
+    forever
+    {
+        if(m_iBlockSize == 0)
+        {
+            if(m_pTcpSocket->bytesAvailable() < (int)sizeof(quint16))
+                return;
+
+            t_FiffStreamIn >> m_iBlockSize;
+
+            if(m_iBlockSize >= 65000)//Sanity Check -> allowed maximal blocksize is 65.000
+            {
+                printf("CommandClient: command block too large, closing connection\n");
+                m_pTcpSocket->abort();
+                return;
+            }
+        }
+
+        if(m_pTcpSocket->bytesAvailable() < m_iBlockSize)
+            return;
+
+        QByteArray t_blockCommand = m_pTcpSocket->read(m_iBlockSize);
+        m_iBlockSize = 0;
+
+        if(CommandParser::isBinaryCommand(t_blockCommand))
+        {
+            emit newBinaryCommand(t_blockCommand, m_iThreadID);
+            continue;
+        }
+
+        QString t_sCommand;
+        QDataStream t_streamCommand(t_blockCommand);
+        t_streamCommand.setVersion(QDataStream::Qt_5_1);
+        t_streamCommand >> t_sCommand;
+
+        t_sCommand = t_sCommand.simplified();
+
+        //
+        // Parse command
+        //
+        if(!t_sCommand.isEmpty())
+            emit newCommand(t_sCommand, m_iThreadID);
+    }
+}
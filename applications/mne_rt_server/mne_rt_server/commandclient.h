@@ -0,0 +1,140 @@
+//=============================================================================================================
+/**
+* @file     commandclient.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief     CommandClient class declaration. Replaces the CommandThread of July, 2012, its socket is served
+*            by an event loop of the IOThreadPool.
+*
+*/
+
+#ifndef COMMANDCLIENT_H
+#define COMMANDCLIENT_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QObject>
+#include <QTcpSocket>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVER
+//=============================================================================================================
+
+namespace RTSERVER
+{
+
+//=============================================================================================================
+/**
+* A command client connection. The object lives in the I/O thread of the CommandServer, its socket is serviced
+* by the event loop of that thread.
+*
+* @brief CommandClient serves one command client
+*/
+class CommandClient : public QObject
+{
+    Q_OBJECT
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a CommandClient. The socket is opened by open() in the thread the client was moved to.
+    *
+    * @param[in] socketDescriptor   The socket descriptor of the accepted connection.
+    * @param[in] p_iId              The client id.
+    */
+    CommandClient(qintptr socketDescriptor, qint32 p_iId);
+
+    ~CommandClient();
+
+    //=========================================================================================================
+    /**
+    * Writes the reply to the client if it is addressed to it. Runs in the I/O thread.
+    *
+    * @param[in] p_blockReply   The reply.
+    * @param[in] p_iID          The id of the addressed client.
+    */
+    void attachCommandReply(QString p_blockReply, qint32 p_iID);
+
+    //=========================================================================================================
+    /**
+    * Writes the tagged reply to a request with id if it is addressed to this client, split into several frames if
+    * it exceeds the frame size. Runs in the I/O thread.
+    *
+    * @param[in] p_blockReply   The tagged reply, see CommandParser::encodeReply.
+    * @param[in] p_iID          The id of the addressed client.
+    */
+    void attachTaggedReply(QByteArray p_blockReply, qint32 p_iID);
+
+signals:
+    void error(QTcpSocket::SocketError socketError);
+    void newCommand(QString p_sCommand, qint32 p_iThreadID);
+    void newBinaryCommand(QByteArray p_blockCommand, qint32 p_iThreadID);
+
+    //=========================================================================================================
+    /**
+    * Emitted when the peer closed the connection.
+    *
+    * @param[in] p_iId  The client id.
+    */
+    void disconnected(qint32 p_iId);
+
+private slots:
+    //=========================================================================================================
+    /**
+    * Creates the socket from the descriptor. Has to run in the I/O thread.
+    */
+    void open();
+
+    //=========================================================================================================
+    /**
+    * Reads all complete command blocks which are available on the socket. A pipelining client writes several
+    * blocks at once.
+    */
+    void readCommands();
+
+    //=========================================================================================================
+    /**
+    * Forwards the disconnect of the socket together with the client id.
+    */
+    void onDisconnected();
+
+private:
+    qintptr m_iSocketDescriptor;
+    qint32 m_iThreadID;
+    QTcpSocket* m_pTcpSocket;   /**< The client socket, owned by this object and living in its thread. */
+    quint16 m_iBlockSize;       /**< Size of the command block which is currently received, 0 while waiting for a new block. */
+};
+
+} // NAMESPACE
+
+#endif //COMMANDCLIENT_H
@@ -39,12 +39,12 @@
 //=============================================================================================================
 
 #include "commandserver.h"
-#include "commandthread.h"
+#include "commandclient.h"
 
 #include "mne_rt_server.h"
 
 #include "fiffstreamserver.h"
-#include "fiffstreamthread.h"
+#include "fiffstreamclient.h"
 #include "mne_rt_server.h"
 #include "connectormanager.h"
 
@@ -75,6 +75,8 @@ CommandServer::CommandServer(QObject *parent)
 : QTcpServer(parent)
 , m_iThreadCount(0)
 , m_iCurrentCommandThreadID(0)
+, m_bParsing(false)
+, m_ioThreadPool(1, "CommandServer I/O")
 {
     QObject::connect(&m_commandParser, &CommandParser::response, this, &CommandServer::prepareReply);
 }
@@ -85,6 +87,12 @@ CommandServer::CommandServer(QObject *parent)
 CommandServer::~CommandServer()
 {
     emit closeCommandThreads();
+
+    //The clients are deleted in their thread before the I/O thread finishes
+    QMap<qint32, CommandClient*>::const_iterator i = m_qClientList.constBegin();
+    for(; i != m_qClientList.constEnd(); ++i)
+        i.value()->deleteLater();
+    m_qClientList.clear();
 }
 
 
@@ -95,15 +103,55 @@ void CommandServer::incommingCommand(QString p_sCommand, qint32 p_iThreadID)
     QStringList t_qListParsedCommands;
 
     m_iCurrentCommandThreadID = p_iThreadID;
+    m_sTaggedReply.clear();
+
+    m_bParsing = true;
+    bool t_bParsed = m_commandParser.parse(p_sCommand, t_qListParsedCommands);
+    m_bParsing = false;
+
+    finishCommand(t_bParsed, p_iThreadID);
+}
+
+
+//*************************************************************************************************************
+
+void CommandServer::incommingBinaryCommand(QByteArray p_blockCommand, qint32 p_iThreadID)
+{
+    QStringList t_qListParsedCommands;
+
+    m_iCurrentCommandThreadID = p_iThreadID;
+    m_sTaggedReply.clear();
+
+    m_bParsing = true;
+    bool t_bParsed = m_commandParser.parse(p_blockCommand, t_qListParsedCommands);
+    m_bParsing = false;
+
+    finishCommand(t_bParsed, p_iThreadID);
+}
+
 
-    if(!m_commandParser.parse(p_sCommand, t_qListParsedCommands))
+//*************************************************************************************************************
+
+void CommandServer::finishCommand(bool p_bParsed, qint32 p_iThreadID)
+{
+    if(!p_bParsed)
     {
         QByteArray t_blockReply;
         t_blockReply.append("command unknown\r\n");
         printf("%s", t_blockReply.data());
 
         //send reply
-        emit replyCommand(t_blockReply, p_iThreadID);
+        if(m_commandParser.requestId() < 0)
+            emit replyCommand(t_blockReply, p_iThreadID);
+        else
+            m_sTaggedReply.append(t_blockReply);
+    }
+
+    //Exactly one reply per request with id, even if no command replied
+    if(m_commandParser.requestId() >= 0)
+    {
+        emit replyTaggedCommand(CommandParser::encodeReply(m_commandParser.requestId(), m_sTaggedReply), p_iThreadID);
+        m_sTaggedReply.clear();
     }
 }
 
@@ -112,22 +160,44 @@ void CommandServer::incommingCommand(QString p_sCommand, qint32 p_iThreadID)
 
 void CommandServer::incomingConnection(qintptr socketDescriptor)
 {
-    CommandThread* t_pCommandThread = new CommandThread(socketDescriptor, m_iThreadCount, this);
+    CommandClient* t_pCommandClient = new CommandClient(socketDescriptor, m_iThreadCount);
+    t_pCommandClient->moveToThread(m_ioThreadPool.nextThread());
+
+    m_qClientList.insert(m_iThreadCount, t_pCommandClient);
     ++m_iThreadCount;
 
-    //when thread has finished it gets deleted
-    connect(t_pCommandThread, SIGNAL(finished()), t_pCommandThread, SLOT(deleteLater()));
-    connect(this, SIGNAL(closeCommandThreads()), t_pCommandThread, SLOT(deleteLater()));
+    //when the client disconnected it gets deleted
+    connect(t_pCommandClient, &CommandClient::disconnected,
+            this, &CommandServer::removeClient);
 
-    //Forwards for thread safety
+    //Forwards for thread safety, both directions are queued to the receiving thread
     //Connect incomming commands
-    connect(t_pCommandThread, &CommandThread::newCommand,
+    connect(t_pCommandClient, &CommandClient::newCommand,
             this, &CommandServer::incommingCommand);
+    connect(t_pCommandClient, &CommandClient::newBinaryCommand,
+            this, &CommandServer::incommingBinaryCommand);
     //Connect command Replies
     connect(this, &CommandServer::replyCommand,
-            t_pCommandThread, &CommandThread::attachCommandReply);
+            t_pCommandClient, &CommandClient::attachCommandReply);
+    connect(this, &CommandServer::replyTaggedCommand,
+            t_pCommandClient, &CommandClient::attachTaggedReply);
+
+    QMetaObject::invokeMethod(t_pCommandClient, "open", Qt::QueuedConnection);
+}
+
+
+//*************************************************************************************************************
 
-    t_pCommandThread->start();
+void CommandServer::removeClient(qint32 p_iId)
+{
+    CommandClient* t_pCommandClient = m_qClientList.take(p_iId);
+
+    if(t_pCommandClient)
+    {
+        //No reply may be queued to a client which is being deleted
+        disconnect(this, 0, t_pCommandClient, 0);
+        t_pCommandClient->deleteLater();
+    }
 }
 
 
@@ -160,7 +230,11 @@ void CommandServer::prepareReply(QString p_sReply, Command p_command)
     //print
 //    printf("%s",p_sReply.toUtf8().constData());
 
-    emit replyCommand(p_sReply, t_iThreadID);
+    //The replies to a request with id are sent together when it is processed
+    if(m_bParsing && m_commandParser.requestId() >= 0)
+        m_sTaggedReply.append(p_sReply);
+    else
+        emit replyCommand(p_sReply, t_iThreadID);
 
     Q_UNUSED(p_command);
 }
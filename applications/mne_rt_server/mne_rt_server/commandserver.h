@@ -41,6 +41,8 @@
 // INCLUDES
 //=============================================================================================================
 
+#include "iothreadpool.h"
+
 #include <realtime/rtCommand/commandparser.h>
 #include <realtime/rtCommand/commandmanager.h>
 
@@ -50,6 +52,7 @@
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QMap>
 #include <QStringList>
 #include <QTcpServer>
 
@@ -75,11 +78,13 @@ using namespace REALTIMELIB;
 // FORWARD DECLARATIONS
 //=============================================================================================================
 
+class CommandClient;
+
 //=============================================================================================================
 /**
-* Command Server which manages command connections in seperate threads
+* Command Server which manages command connections. The client sockets are serviced by an I/O thread.
 *
-* @brief CommandServer manages threaded command connections
+* @brief CommandServer manages command connections
 */
 class CommandServer : public QTcpServer
 {
@@ -117,6 +122,15 @@ public:
     */
     void incommingCommand(QString p_sCommand, qint32 p_iThreadID);
 
+    //=========================================================================================================
+    /**
+    * Slot which is called when a new binary command is available.
+    *
+    * @param[in] p_blockCommand     Binary command, see CommandParser::encodeCommand.
+    * @param[in] p_iThreadID        ID of the thread which received the command.
+    */
+    void incommingBinaryCommand(QByteArray p_blockCommand, qint32 p_iThreadID);
+
     //=========================================================================================================
     /**
     * Registers a CommandManager (Observer) at CommandParser (Subject) to include in the chain of notifications
@@ -134,6 +148,14 @@ public:
     */
     void prepareReply(QString p_sReply, Command p_command);
 
+    //=========================================================================================================
+    /**
+    * Removes a disconnected client and deletes it in its I/O thread.
+    *
+    * @param[in] p_iId  The client id.
+    */
+    void removeClient(qint32 p_iId);
+
 signals:
     //=========================================================================================================
     /**
@@ -144,6 +166,15 @@ signals:
     */
     void replyCommand(QString p_blockReply, qint32 p_iID);
 
+    //=========================================================================================================
+    /**
+    * Reply to a request with id, it holds all replies of the request.
+    *
+    * @param[in] p_blockReply   The tagged reply, see CommandParser::encodeReply.
+    * @param[in] p_iID          ID of the client thread to identify the target.
+    */
+    void replyTaggedCommand(QByteArray p_blockReply, qint32 p_iID);
+
     //=========================================================================================================
     /**
     * Signal which triggers closing all command clients
@@ -158,12 +189,26 @@ protected:
     void incomingConnection(qintptr socketDescriptor);
 
 private:
+    //=========================================================================================================
+    /**
+    * Answers unknown commands and sends the collected replies of a request with id.
+    *
+    * @param[in] p_bParsed      Whether the command was parsed.
+    * @param[in] p_iThreadID    ID of the thread which received the command.
+    */
+    void finishCommand(bool p_bParsed, qint32 p_iThreadID);
+
     qint32 m_iThreadCount;              /**< Is incresed each time a new command client connects to mne_rt_server. */
 
     CommandParser m_commandParser;      /**< Command parser. */
 
 //    QMultiMap<QString, qint32> m_qMultiMapCommandThreadID;//This is need when commands are processed by different threads; currently its only one command per time processed by one thread --> m_iCurrentCommandThreadID
     qint32 m_iCurrentCommandThreadID;   /**< Command Thread ID of the current command. */
+    QString m_sTaggedReply;             /**< Replies to the current request with id, they are sent together. */
+    bool m_bParsing;                    /**< True while a command is parsed, later replies are not part of its tagged reply. */
+
+    QMap<qint32, CommandClient*> m_qClientList; /**< The connected command clients. */
+    IoThreadPool m_ioThreadPool;        /**< The thread which services the client sockets. */
 };
 
 
@@ -62,6 +62,7 @@
 //=============================================================================================================
 
 #include <QDir>
+#include <QJsonArray>
 #include <QVector>
 #include <QString>
 #include <QStringList>
@@ -86,8 +87,11 @@ using namespace RTSERVER;
 ConnectorManager::ConnectorManager(FiffStreamServer* p_pFiffStreamServer, QObject *parent)
 : QPluginLoader(parent)
 , m_pFiffStreamServer(p_pFiffStreamServer)
+, m_iPrimaryConnectorId(-1)
 {
-
+    // the measurement info depends on the stream the client subscribed to
+    QObject::connect(   this->m_pFiffStreamServer, &FiffStreamServer::requestMeasInfo,
+                        this, &ConnectorManager::requestMeasInfo);
 }
 
 
@@ -157,12 +161,131 @@ void ConnectorManager::comSelcon(Command p_command)
 }
 
 
+//*************************************************************************************************************
+
+void ConnectorManager::comAddcon(Command p_command)
+{
+    bool t_bIsInt;
+
+    qint32 t_id = p_command.pValues()[0].toInt(&t_bIsInt);
+    if(t_bIsInt)
+    {
+        QByteArray t_blockReply = this->addConnector(t_id);
+
+        if(!p_command.isJson())
+            t_blockReply.append(this->getConnectorList());
+        else
+            t_blockReply = this->getConnectorList(true);
+
+        qobject_cast<MNERTServer*> (this->parent())->getCommandManager()["addcon"].reply(t_blockReply);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::comRemcon(Command p_command)
+{
+    bool t_bIsInt;
+
+    qint32 t_id = p_command.pValues()[0].toInt(&t_bIsInt);
+    if(t_bIsInt)
+    {
+        QByteArray t_blockReply = this->removeConnector(t_id);
+
+        if(!p_command.isJson())
+            t_blockReply.append(this->getConnectorList());
+        else
+            t_blockReply = this->getConnectorList(true);
+
+        qobject_cast<MNERTServer*> (this->parent())->getCommandManager()["remcon"].reply(t_blockReply);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::comMerge(Command p_command)
+{
+    double t_dSamplingFreq = p_command.pValues()[0].toDouble();
+    QString t_sStreams = p_command.pValues()[1].toString().simplified();
+
+    QString t_sReply;
+
+    if(t_sStreams.isEmpty() || t_sStreams.compare("none", Qt::CaseInsensitive) == 0)
+    {
+        m_pStreamMerger.clear();
+        m_qSetMergedInfoIds.clear();
+        t_sReply = QString("\tMerged stream stopped.\r\n\n");
+    }
+    else
+    {
+        QList<qint32> t_qListStreamIds;
+        if(!StreamMerger::parseStreamIds(t_sStreams, t_qListStreamIds) || t_dSamplingFreq < 0)
+            t_sReply = QString("\tCan't merge '%1', at least two connector IDs are required.\r\n\n").arg(t_sStreams);
+        else
+        {
+            QString t_sInactive;
+            for(qint32 i = 0; i < t_qListStreamIds.size(); ++i)
+            {
+                IConnector* t_pConnector = findConnector(t_qListStreamIds[i]);
+                if(!t_pConnector || !t_pConnector->isActive())
+                    t_sInactive.append(QString(" %1").arg(t_qListStreamIds[i]));
+            }
+
+            if(!t_sInactive.isEmpty())
+                t_sReply = QString("\tConnector%1 not active, activate with addcon first.\r\n\n").arg(t_sInactive);
+            else
+            {
+                m_pStreamMerger = StreamMerger::SPtr(new StreamMerger(t_qListStreamIds, t_dSamplingFreq));
+                m_qSetMergedInfoIds.clear();
+
+                // infos which clients of the connector streams already requested
+                for(qint32 i = 0; i < t_qListStreamIds.size(); ++i)
+                    if(m_qMapStreamInfos.contains(t_qListStreamIds[i]))
+                        m_pStreamMerger->setMeasInfo(t_qListStreamIds[i], m_qMapStreamInfos[t_qListStreamIds[i]]);
+
+                t_sReply = QString("\tMerging %1 into stream %2.\r\n\n").arg(t_sStreams).arg(StreamMerger::MergedStreamId);
+            }
+        }
+    }
+
+    // clients of a removed merged stream fall back to the primary stream
+    updateStreams();
+
+    printf("%s", t_sReply.toUtf8().constData());
+
+    MNERTServer* t_pMNERTServer = qobject_cast<MNERTServer*> (this->parent());
+    if(!p_command.isJson())
+        t_pMNERTServer->getCommandManager()["merge"].reply(t_sReply.toUtf8().append(getStreamList()));
+    else
+        t_pMNERTServer->getCommandManager()["merge"].reply(getStreamList(true));
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::comStreams(Command p_command)
+{
+    MNERTServer* t_pMNERTServer = qobject_cast<MNERTServer*> (this->parent());
+
+    if(!p_command.isJson())
+        t_pMNERTServer->getCommandManager()["streams"].reply(this->getStreamList());
+    else
+        t_pMNERTServer->getCommandManager()["streams"].reply(this->getStreamList(true));
+}
+
+
 //*************************************************************************************************************
 
 void ConnectorManager::comStart(Command p_command)//comMeas
 {
-    getActiveConnector()->start();
-    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["start"].reply("Starting active connector.\n");
+    QList<IConnector*> t_qListConnectors = getActiveConnectors();
+    for(qint32 i = 0; i < t_qListConnectors.size(); ++i)
+        if(!t_qListConnectors[i]->isRunning())
+            t_qListConnectors[i]->start();
+
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["start"].reply("Starting active connectors.\n");
 
     Q_UNUSED(p_command);
 }
@@ -172,7 +295,10 @@ void ConnectorManager::comStart(Command p_command)//comMeas
 
 void ConnectorManager::comStopAll(Command p_command)
 {
-    getActiveConnector()->stop();
+    QList<IConnector*> t_qListConnectors = getActiveConnectors();
+    for(qint32 i = 0; i < t_qListConnectors.size(); ++i)
+        t_qListConnectors[i]->stop();
+
     qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["stop-all"].reply("Stoping all connectors.\r\n");
 
     Q_UNUSED(p_command);
@@ -183,41 +309,14 @@ void ConnectorManager::comStopAll(Command p_command)
 
 void ConnectorManager::connectActiveConnector()
 {
-    IConnector* t_activeConnector = ConnectorManager::getActiveConnector();
+    QList<IConnector*> t_qListConnectors = getActiveConnectors();
 
-    if(t_activeConnector)
+    if(!t_qListConnectors.isEmpty())
     {
-        // use signal slots instead of call backs
-        //Consulting the Signal/Slot documentation describes why the Signal/Slot approach is better:
-        //    Callbacks have two fundamental flaws: Firstly, they are not type-safe. We can never be certain
-        //    that the processing function will call the callback with the correct arguments.
-        //    Secondly, the callback is strongly coupled to the processing function since the processing
-        //    function must know which callback to call.
-        //Do be aware of the following though:
-        //    Compared to callbacks, signals and slots are slightly slower because of the increased
-        //    flexibility they provide
-        //The speed probably doesn't matter for most cases, but there may be some extreme cases of repeated
-        //calling that makes a difference.
-
-        //
-        // Meas Info
-        //
-        // connect command server and connector manager
-        QObject::connect(   this->m_pFiffStreamServer, &FiffStreamServer::requestMeasInfo,
-                            t_activeConnector, &IConnector::info);
-
-        // connect connector manager and fiff stream server
-        QObject::connect(   t_activeConnector, &IConnector::remitMeasInfo,
-                            this->m_pFiffStreamServer, &FiffStreamServer::forwardMeasInfo);
-
-        //
-        // Raw Data
-        //
-        // connect command server and connector manager
-
-        // connect connector manager and fiff stream server
-        QObject::connect(   t_activeConnector, &IConnector::remitRawBuffer,
-                            this->m_pFiffStreamServer, &FiffStreamServer::forwardRawBuffer);
+        for(qint32 i = 0; i < t_qListConnectors.size(); ++i)
+            connectConnector(t_qListConnectors[i]);
+
+        updateStreams();
     }
     else
     {
@@ -230,44 +329,12 @@ void ConnectorManager::connectActiveConnector()
 
 void ConnectorManager::disconnectActiveConnector()
 {
-    IConnector* t_activeConnector = ConnectorManager::getActiveConnector();
+    QList<IConnector*> t_qListConnectors = getActiveConnectors();
 
-    if(t_activeConnector)
+    if(!t_qListConnectors.isEmpty())
     {
-        // use signal slots instead of call backs
-        //Consulting the Signal/Slot documentation describes why the Signal/Slot approach is better:
-        //    Callbacks have two fundamental flaws: Firstly, they are not type-safe. We can never be certain
-        //    that the processing function will call the callback with the correct arguments.
-        //    Secondly, the callback is strongly coupled to the processing function since the processing
-        //    function must know which callback to call.
-        //Do be aware of the following though:
-        //    Compared to callbacks, signals and slots are slightly slower because of the increased
-        //    flexibility they provide
-        //The speed probably doesn't matter for most cases, but there may be some extreme cases of repeated
-        //calling that makes a difference.
-
-        //
-        // Meas Info
-        //
-        this->disconnect(t_activeConnector);
-        //
-        t_activeConnector->disconnect(this->m_pFiffStreamServer);
-
-        this->m_pFiffStreamServer->disconnect(t_activeConnector);
-
-        //
-        // Raw Data
-        //
-//        t_pMNERTServer->m_pCommandServer->disconnect(t_activeConnector);
-        //
-//        t_activeConnector->disconnect(t_pMNERTServer->m_pFiffStreamServer);
-        // connect command server and connector manager
-//        t_pMNERTServer->m_pCommandServer->disconnect(t_activeConnector);
-
-        //
-        // Reset Raw Buffer
-        //
-//        t_pMNERTServer->m_pCommandServer->disconnect(t_activeConnector);
+        for(qint32 i = 0; i < t_qListConnectors.size(); ++i)
+            t_qListConnectors[i]->disconnect(this);
     }
     else
     {
@@ -280,6 +347,10 @@ void ConnectorManager::disconnectActiveConnector()
 
 IConnector* ConnectorManager::getActiveConnector()
 {
+    IConnector* t_pConnector = findConnector(m_iPrimaryConnectorId);
+    if(t_pConnector && t_pConnector->isActive())
+        return t_pConnector;
+
     QVector<IConnector*>::const_iterator it = s_vecConnectors.begin();
     for( ; it != s_vecConnectors.end(); ++it)
     {
@@ -291,6 +362,21 @@ IConnector* ConnectorManager::getActiveConnector()
 }
 
 
+//*************************************************************************************************************
+
+QList<IConnector*> ConnectorManager::getActiveConnectors()
+{
+    QList<IConnector*> t_qListConnectors;
+
+    QVector<IConnector*>::const_iterator it = s_vecConnectors.begin();
+    for( ; it != s_vecConnectors.end(); ++it)
+        if((*it)->isActive())
+            t_qListConnectors.append(*it);
+
+    return t_qListConnectors;
+}
+
+
 //*************************************************************************************************************
 
 QByteArray ConnectorManager::getConnectorList(bool p_bFlagJSON) const
@@ -312,6 +398,9 @@ QByteArray ConnectorManager::getConnectorList(bool p_bFlagJSON) const
             //insert isActive
             t_qJsonObjectConnector.insert(QString("active"), QJsonValue((*it)->isActive()));
 
+            //insert isPrimary
+            t_qJsonObjectConnector.insert(QString("primary"), QJsonValue((*it)->isActive() && (*it)->getConnectorID() == m_iPrimaryConnectorId));
+
             //insert Connector JsonObject
             t_qJsonObjectConnectors.insert((*it)->getName(),t_qJsonObjectConnector);//QJsonObject());//QJsonValue());
 
@@ -330,8 +419,11 @@ QByteArray ConnectorManager::getConnectorList(bool p_bFlagJSON) const
             QVector<IConnector*>::const_iterator it = s_vecConnectors.begin();
             for( ; it != s_vecConnectors.end(); ++it)
             {
-                if((*it)->isActive())
+                // * marks the selected connector, + the ones acquiring concurrently
+                if((*it)->isActive() && (*it)->getConnectorID() == m_iPrimaryConnectorId)
                     t_blockConnectorList.append(QString("  *  (%1) %2\r\n").arg((*it)->getConnectorID()).arg((*it)->getName()));
+                else if((*it)->isActive())
+                    t_blockConnectorList.append(QString("  +  (%1) %2\r\n").arg((*it)->getConnectorID()).arg((*it)->getName()));
                 else
                     t_blockConnectorList.append(QString("     (%1) %2\r\n").arg((*it)->getConnectorID()).arg((*it)->getName()));
             }
@@ -343,6 +435,110 @@ QByteArray ConnectorManager::getConnectorList(bool p_bFlagJSON) const
     return t_blockConnectorList;
 }
 
+
+//*************************************************************************************************************
+
+QByteArray ConnectorManager::getStreamList(bool p_bFlagJSON) const
+{
+    QByteArray t_blockStreamList;
+
+    QList<qint32> t_qListStreamIds;
+    QVector<IConnector*>::const_iterator it = s_vecConnectors.begin();
+    for( ; it != s_vecConnectors.end(); ++it)
+        if((*it)->isActive())
+            t_qListStreamIds.append((*it)->getConnectorID());
+    if(m_pStreamMerger)
+        t_qListStreamIds.append(StreamMerger::MergedStreamId);
+
+    if(p_bFlagJSON)
+    {
+        QJsonObject t_qJsonObjectStreams;
+
+        for(qint32 i = 0; i < t_qListStreamIds.size(); ++i)
+        {
+            qint32 t_iStreamId = t_qListStreamIds[i];
+            QJsonObject t_qJsonObjectStream;
+
+            if(t_iStreamId == StreamMerger::MergedStreamId)
+            {
+                QJsonArray t_qJsonArrayInputs;
+                for(qint32 j = 0; j < m_pStreamMerger->streamIds().size(); ++j)
+                    t_qJsonArrayInputs.append(QJsonValue(m_pStreamMerger->streamIds()[j]));
+                t_qJsonObjectStream.insert(QString("merged"), t_qJsonArrayInputs);
+                if(m_pStreamMerger->hasMeasInfo())
+                {
+                    t_qJsonObjectStream.insert(QString("nchan"), QJsonValue(m_pStreamMerger->mergedInfo().nchan));
+                    t_qJsonObjectStream.insert(QString("sfreq"), QJsonValue(m_pStreamMerger->samplingFrequency()));
+                }
+            }
+            else
+            {
+                IConnector* t_pConnector = findConnector(t_iStreamId);
+                t_qJsonObjectStream.insert(QString("connector"), QJsonValue(QString(t_pConnector->getName())));
+                t_qJsonObjectStream.insert(QString("primary"), QJsonValue(t_iStreamId == m_iPrimaryConnectorId));
+                t_qJsonObjectStream.insert(QString("running"), QJsonValue(t_pConnector->isRunning()));
+                if(m_qMapStreamInfos.contains(t_iStreamId))
+                {
+                    t_qJsonObjectStream.insert(QString("nchan"), QJsonValue(m_qMapStreamInfos[t_iStreamId].nchan));
+                    t_qJsonObjectStream.insert(QString("sfreq"), QJsonValue(m_qMapStreamInfos[t_iStreamId].sfreq));
+                }
+            }
+            t_qJsonObjectStream.insert(QString("subscribers"), QJsonValue(m_pFiffStreamServer->subscriberCount(t_iStreamId)));
+
+            t_qJsonObjectStreams.insert(QString::number(t_iStreamId), t_qJsonObjectStream);
+        }
+
+        QJsonObject t_qJsonObjectRoot;
+        t_qJsonObjectRoot.insert("streams", t_qJsonObjectStreams);
+        QJsonDocument p_qJsonDocument(t_qJsonObjectRoot);
+
+        t_blockStreamList.append(p_qJsonDocument.toJson());
+    }
+    else
+    {
+        if(!t_qListStreamIds.isEmpty())
+        {
+            t_blockStreamList.append("\tStream\tSource\t\t\tChannels\tsfreq\tSubscribers\r\n");
+            for(qint32 i = 0; i < t_qListStreamIds.size(); ++i)
+            {
+                qint32 t_iStreamId = t_qListStreamIds[i];
+                QString t_sSource;
+                QString t_sChannels("-");
+                QString t_sSamplingFreq("-");
+
+                if(t_iStreamId == StreamMerger::MergedStreamId)
+                {
+                    QStringList t_qListInputs;
+                    for(qint32 j = 0; j < m_pStreamMerger->streamIds().size(); ++j)
+                        t_qListInputs.append(QString::number(m_pStreamMerger->streamIds()[j]));
+                    t_sSource = QString("merged %1").arg(t_qListInputs.join(","));
+                    if(m_pStreamMerger->hasMeasInfo())
+                    {
+                        t_sChannels = QString::number(m_pStreamMerger->mergedInfo().nchan);
+                        t_sSamplingFreq = QString::number(m_pStreamMerger->samplingFrequency());
+                    }
+                }
+                else
+                {
+                    IConnector* t_pConnector = findConnector(t_iStreamId);
+                    t_sSource = QString("%1%2").arg(t_pConnector->getName()).arg(t_iStreamId == m_iPrimaryConnectorId ? " *" : "");
+                    if(m_qMapStreamInfos.contains(t_iStreamId))
+                    {
+                        t_sChannels = QString::number(m_qMapStreamInfos[t_iStreamId].nchan);
+                        t_sSamplingFreq = QString::number(m_qMapStreamInfos[t_iStreamId].sfreq);
+                    }
+                }
+
+                t_blockStreamList.append(QString("\t%1\t%2\t\t%3\t\t%4\t%5\r\n").arg(t_iStreamId).arg(t_sSource, -16).arg(t_sChannels).arg(t_sSamplingFreq).arg(m_pFiffStreamServer->subscriberCount(t_iStreamId)));
+            }
+        }
+        else
+            t_blockStreamList.append(" - no stream available - \r\n");
+        t_blockStreamList.append("\r\n");
+    }
+    return t_blockStreamList;
+}
+
 //*************************************************************************************************************
 
 void ConnectorManager::connectCommands()
@@ -350,10 +546,14 @@ void ConnectorManager::connectCommands()
     //Connect slots
     MNERTServer* t_pMNERTServer = qobject_cast<MNERTServer*> (this->parent());
 
+    QObject::connect(&t_pMNERTServer->getCommandManager()["addcon"], &Command::executed, this, &ConnectorManager::comAddcon);
     QObject::connect(&t_pMNERTServer->getCommandManager()["conlist"], &Command::executed, this, &ConnectorManager::comConlist);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["merge"], &Command::executed, this, &ConnectorManager::comMerge);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["remcon"], &Command::executed, this, &ConnectorManager::comRemcon);
     QObject::connect(&t_pMNERTServer->getCommandManager()["selcon"], &Command::executed, this, &ConnectorManager::comSelcon);
     QObject::connect(&t_pMNERTServer->getCommandManager()["start"], &Command::executed, this, &ConnectorManager::comStart);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop-all"], &Command::executed, this, &ConnectorManager::comStopAll);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["streams"], &Command::executed, this, &ConnectorManager::comStreams);
 }
 
 
@@ -436,6 +636,7 @@ void ConnectorManager::loadConnectors(const QString& dir)
                 if(s_vecConnectors[i]->getConnectorID() == configConnector)
                 {
                     s_vecConnectors[i]->setStatus(true);
+                    m_iPrimaryConnectorId = configConnector;
                     printf("activate %s... ", s_vecConnectors[i]->getName());
                     activated = true;
                     break;
@@ -446,7 +647,10 @@ void ConnectorManager::loadConnectors(const QString& dir)
 
         //default
         if(!activated)
+        {
             s_vecConnectors[0]->setStatus(true);
+            m_iPrimaryConnectorId = s_vecConnectors[0]->getConnectorID();
+        }
     }
 
     //print
@@ -462,27 +666,28 @@ QByteArray ConnectorManager::setActiveConnector(qint32 ID)
     QByteArray p_blockClientList;
     QString str;
 
-    if(ID != getActiveConnector()->getConnectorID())
+    IConnector* t_pActiveConnector = getActiveConnector();
+
+    if(!t_pActiveConnector || ID != t_pActiveConnector->getConnectorID())
     {
-        IConnector* t_pNewActiveConnector = NULL;
-        QVector<IConnector*>::const_iterator it = s_vecConnectors.begin();
-        for( ; it != s_vecConnectors.end(); ++it)
-            if((*it)->getConnectorID() == ID)
-                t_pNewActiveConnector = *it;
+        IConnector* t_pNewActiveConnector = findConnector(ID);
 
         if (t_pNewActiveConnector)
         {
+            //Stop, disconnect and deactivate the previous primary connector
+            if(t_pActiveConnector)
+                deactivateConnector(t_pActiveConnector);
 
-           IConnector* t_pActiveConnector = getActiveConnector();
-
-           //Stop and disconnect active connector
-           t_pActiveConnector->stop();
-           this->disconnectActiveConnector();
-           t_pActiveConnector->setStatus(false);
+            //set new active connector, it may already acquire concurrently
+            if(!t_pNewActiveConnector->isActive())
+            {
+                t_pNewActiveConnector->setStatus(true);
+                connectConnector(t_pNewActiveConnector);
+            }
+            m_iPrimaryConnectorId = ID;
 
-           //set new active connector
-           t_pNewActiveConnector->setStatus(true);
-           this->connectActiveConnector();
+            // the clients of the previous primary stream follow
+            updateStreams();
 
             str = QString("\t%1 activated.\r\n\n").arg(t_pNewActiveConnector->getName());
             p_blockClientList.append(str);
@@ -496,7 +701,7 @@ QByteArray ConnectorManager::setActiveConnector(qint32 ID)
     }
     else
     {
-        str = QString("\t%1 is already active.\r\n\n").arg(getActiveConnector()->getName());
+        str = QString("\t%1 is already active.\r\n\n").arg(t_pActiveConnector->getName());
         p_blockClientList.append(str);
     }
 
@@ -504,6 +709,260 @@ QByteArray ConnectorManager::setActiveConnector(qint32 ID)
 }
 
 
+//*************************************************************************************************************
+
+QByteArray ConnectorManager::addConnector(qint32 ID)
+{
+    QString str;
+
+    IConnector* t_pConnector = findConnector(ID);
+
+    if(!t_pConnector)
+        str = QString("\tID %1 doesn't match a connector ID.\r\n\n").arg(ID);
+    else if(t_pConnector->isActive())
+        str = QString("\t%1 is already active.\r\n\n").arg(t_pConnector->getName());
+    else
+    {
+        t_pConnector->setStatus(true);
+        connectConnector(t_pConnector);
+        updateStreams();
+
+        // join a running measurement
+        IConnector* t_pActiveConnector = getActiveConnector();
+        if(t_pActiveConnector && t_pActiveConnector->isRunning())
+            t_pConnector->start();
+
+        str = QString("\t%1 added as stream %2.\r\n\n").arg(t_pConnector->getName()).arg(ID);
+    }
+
+    printf("%s", str.toUtf8().constData());
+
+    return str.toUtf8();
+}
+
+
+//*************************************************************************************************************
+
+QByteArray ConnectorManager::removeConnector(qint32 ID)
+{
+    QString str;
+
+    IConnector* t_pConnector = findConnector(ID);
+
+    if(!t_pConnector)
+        str = QString("\tID %1 doesn't match a connector ID.\r\n\n").arg(ID);
+    else if(!t_pConnector->isActive())
+        str = QString("\t%1 is not active.\r\n\n").arg(t_pConnector->getName());
+    else if(ID == m_iPrimaryConnectorId)
+        str = QString("\t%1 is the selected connector, select another one with selcon.\r\n\n").arg(t_pConnector->getName());
+    else
+    {
+        deactivateConnector(t_pConnector);
+        updateStreams();
+
+        str = QString("\t%1 removed.\r\n\n").arg(t_pConnector->getName());
+    }
+
+    printf("%s", str.toUtf8().constData());
+
+    return str.toUtf8();
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::requestMeasInfo(qint32 ID)
+{
+    qint32 t_iStreamId;
+    if(!m_pFiffStreamServer->getClientStream(ID, t_iStreamId))
+        return;
+
+    if(t_iStreamId == StreamMerger::MergedStreamId)
+    {
+        if(!m_pStreamMerger)
+            return;
+
+        if(m_pStreamMerger->hasMeasInfo())
+            m_pFiffStreamServer->forwardMeasInfo(ID, m_pStreamMerger->mergedInfo());
+        else
+        {
+            // the merged info is sent once all connectors answered
+            m_qSetMergedInfoIds.insert(ID);
+            for(qint32 i = 0; i < m_pStreamMerger->streamIds().size(); ++i)
+            {
+                IConnector* t_pConnector = findConnector(m_pStreamMerger->streamIds()[i]);
+                if(t_pConnector && t_pConnector->isActive())
+                    t_pConnector->info(ID);
+            }
+        }
+    }
+    else
+    {
+        // _default is the primary stream before any connector is connected
+        IConnector* t_pConnector = t_iStreamId == _default ? getActiveConnector() : findConnector(t_iStreamId);
+        if(t_pConnector && t_pConnector->isActive())
+            t_pConnector->info(ID);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::onMeasInfo(qint32 ID, FiffInfo p_fiffInfo)
+{
+    IConnector* t_pConnector = qobject_cast<IConnector*>(sender());
+    if(!t_pConnector)
+        return;
+
+    qint32 t_iStreamId = t_pConnector->getConnectorID();
+
+    m_qMapStreamInfos.insert(t_iStreamId, p_fiffInfo);
+    m_pFiffStreamServer->setStreamChannels(t_iStreamId, p_fiffInfo.nchan);
+
+    if(m_pStreamMerger && m_pStreamMerger->streamIds().contains(t_iStreamId))
+    {
+        m_pStreamMerger->setMeasInfo(t_iStreamId, p_fiffInfo);
+        if(m_pStreamMerger->hasMeasInfo())
+            m_pFiffStreamServer->setStreamChannels(StreamMerger::MergedStreamId, m_pStreamMerger->mergedInfo().nchan);
+    }
+
+    qint32 t_iClientStreamId;
+    if(m_pFiffStreamServer->getClientStream(ID, t_iClientStreamId) && t_iClientStreamId == t_iStreamId)
+        m_pFiffStreamServer->forwardMeasInfo(ID, p_fiffInfo);
+
+    releaseMergedInfo();
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::onRawBuffer(QSharedPointer<Eigen::MatrixXf> p_pMatRawBuffer)
+{
+    IConnector* t_pConnector = qobject_cast<IConnector*>(sender());
+    if(!t_pConnector || !p_pMatRawBuffer)
+        return;
+
+    qint32 t_iStreamId = t_pConnector->getConnectorID();
+
+    m_pFiffStreamServer->forwardStreamBuffer(t_iStreamId, p_pMatRawBuffer);
+
+    if(m_pStreamMerger && m_pStreamMerger->streamIds().contains(t_iStreamId))
+    {
+        QSharedPointer<Eigen::MatrixXf> t_pMatMerged = m_pStreamMerger->addBuffer(t_iStreamId, *p_pMatRawBuffer);
+        if(t_pMatMerged)
+            m_pFiffStreamServer->forwardStreamBuffer(StreamMerger::MergedStreamId, t_pMatMerged);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::connectConnector(IConnector* p_pConnector)
+{
+    // use signal slots instead of call backs
+    //Consulting the Signal/Slot documentation describes why the Signal/Slot approach is better:
+    //    Callbacks have two fundamental flaws: Firstly, they are not type-safe. We can never be certain
+    //    that the processing function will call the callback with the correct arguments.
+    //    Secondly, the callback is strongly coupled to the processing function since the processing
+    //    function must know which callback to call.
+    //Do be aware of the following though:
+    //    Compared to callbacks, signals and slots are slightly slower because of the increased
+    //    flexibility they provide
+    //The speed probably doesn't matter for most cases, but there may be some extreme cases of repeated
+    //calling that makes a difference.
+
+    //
+    // Meas Info
+    //
+    // connect connector and connector manager, the info is routed to the clients of the connector's stream
+    QObject::connect(   p_pConnector, &IConnector::remitMeasInfo,
+                        this, &ConnectorManager::onMeasInfo, Qt::UniqueConnection);
+
+    //
+    // Raw Data
+    //
+    // connect connector and connector manager, the connector emits from its acquisition thread
+    QObject::connect(   p_pConnector, &IConnector::remitRawBuffer,
+                        this, &ConnectorManager::onRawBuffer, Qt::UniqueConnection);
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::deactivateConnector(IConnector* p_pConnector)
+{
+    qint32 t_iStreamId = p_pConnector->getConnectorID();
+
+    p_pConnector->stop();
+    p_pConnector->disconnect(this);
+    p_pConnector->setStatus(false);
+
+    m_qMapStreamInfos.remove(t_iStreamId);
+
+    if(m_pStreamMerger && m_pStreamMerger->streamIds().contains(t_iStreamId))
+    {
+        printf("Merged stream stopped, %s left.\n", p_pConnector->getName());
+        m_pStreamMerger.clear();
+        m_qSetMergedInfoIds.clear();
+    }
+}
+
+
+//*************************************************************************************************************
+
+IConnector* ConnectorManager::findConnector(qint32 ID) const
+{
+    QVector<IConnector*>::const_iterator it = s_vecConnectors.begin();
+    for( ; it != s_vecConnectors.end(); ++it)
+        if((*it)->getConnectorID() == ID)
+            return *it;
+
+    return NULL;
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::updateStreams()
+{
+    QList<qint32> t_qListStreamIds;
+
+    QList<IConnector*> t_qListConnectors = getActiveConnectors();
+    for(qint32 i = 0; i < t_qListConnectors.size(); ++i)
+        t_qListStreamIds.append(t_qListConnectors[i]->getConnectorID());
+
+    if(m_pStreamMerger)
+        t_qListStreamIds.append(StreamMerger::MergedStreamId);
+
+    m_pFiffStreamServer->setAvailableStreams(t_qListStreamIds);
+
+    IConnector* t_pActiveConnector = getActiveConnector();
+    if(t_pActiveConnector)
+        m_pFiffStreamServer->setPrimaryStream(t_pActiveConnector->getConnectorID());
+}
+
+
+//*************************************************************************************************************
+
+void ConnectorManager::releaseMergedInfo()
+{
+    if(!m_pStreamMerger || m_qSetMergedInfoIds.isEmpty() || !m_pStreamMerger->hasMeasInfo())
+        return;
+
+    FiffInfo t_fiffInfo = m_pStreamMerger->mergedInfo();
+
+    QSet<qint32>::const_iterator it = m_qSetMergedInfoIds.begin();
+    for( ; it != m_qSetMergedInfoIds.end(); ++it)
+    {
+        qint32 t_iStreamId;
+        if(m_pFiffStreamServer->getClientStream(*it, t_iStreamId) && t_iStreamId == StreamMerger::MergedStreamId)
+            m_pFiffStreamServer->forwardMeasInfo(*it, t_fiffInfo);
+    }
+
+    m_qSetMergedInfoIds.clear();
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // STATIC DEFINITIONS
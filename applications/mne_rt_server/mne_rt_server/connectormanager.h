@@ -43,6 +43,7 @@
 //=============================================================================================================
 
 #include "IConnector.h"
+#include "streammerger.h"
 
 
 //*************************************************************************************************************
@@ -58,6 +59,9 @@
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QList>
+#include <QMap>
+#include <QSet>
 #include <QVector>
 #include <QPluginLoader>
 
@@ -97,6 +101,11 @@ class FiffStreamServer;
 /**
 * DECLARE CLASS ConnectorManager
 *
+* Several connectors can acquire concurrently, e.g. a MEG system and a separate EEG amplifier. Each active
+* connector produces its own measurement stream, the stream id is the connector id. The primary connector is the
+* one selected with selcon, new data clients subscribe to its stream. Optionally the streams of several connectors
+* are aligned on the server clock and resampled into one merged stream, see StreamMerger.
+*
 * @brief The ConnectorManager class provides a dynamic plugin loader. As well as the handling of the loaded plugins.
 */
 class ConnectorManager : public QPluginLoader
@@ -135,18 +144,34 @@ public:
 
     static void clearConnectorActivation();
 
+    //=========================================================================================================
+    /**
+    * Connects all active connectors to the fiff stream server.
+    */
     void connectActiveConnector();
 
+    //=========================================================================================================
+    /**
+    * Disconnects all active connectors from the fiff stream server.
+    */
     void disconnectActiveConnector();
 
     //=========================================================================================================
     /**
-    * Returns vector containing active ISensor plugins.
+    * Returns the primary connector.
     *
-    * @return reference to vector containing active ISensor plugins.
+    * @return the primary connector, NULL if no connector is active.
     */
     IConnector* getActiveConnector();
 
+    //=========================================================================================================
+    /**
+    * Returns all active connectors, the primary one and those which acquire concurrently.
+    *
+    * @return the active connectors.
+    */
+    QList<IConnector*> getActiveConnectors();
+
     //=========================================================================================================
     /**
     * Returns vector containing all plugins.
@@ -165,10 +190,43 @@ public:
 
     //=========================================================================================================
     /**
-    * ToDo
+    * Selects the primary connector. The previous primary connector is stopped, its clients follow the new one.
+    *
+    * @param[in] ID     The connector id.
+    *
+    * @return the status message.
     */
     QByteArray setActiveConnector(qint32 ID);
 
+    //=========================================================================================================
+    /**
+    * Activates a connector which acquires concurrently to the primary one, in its own measurement stream. It is
+    * started right away if the primary connector is running.
+    *
+    * @param[in] ID     The connector id.
+    *
+    * @return the status message.
+    */
+    QByteArray addConnector(qint32 ID);
+
+    //=========================================================================================================
+    /**
+    * Stops and deactivates a concurrently acquiring connector.
+    *
+    * @param[in] ID     The connector id.
+    *
+    * @return the status message.
+    */
+    QByteArray removeConnector(qint32 ID);
+
+    //=========================================================================================================
+    /**
+    * Prints a list of the measurement streams and their subscribers.
+    *
+    * @param[in] p_bFlagJSON    if true, function return JSON formatted (default = false)
+    */
+    QByteArray getStreamList(bool p_bFlagJSON = false) const;
+
 signals:
     void sendMeasInfo(qint32, FIFFLIB::FiffInfo);
 //    void setBufferSize(qint32 ID);
@@ -194,6 +252,38 @@ private:
     */
     void comSelcon(Command p_command);
 
+    //=========================================================================================================
+    /**
+    * Activates a concurrently acquiring connector
+    *
+    * @param[in] p_command  The add connector command.
+    */
+    void comAddcon(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Deactivates a concurrently acquiring connector
+    *
+    * @param[in] p_command  The remove connector command.
+    */
+    void comRemcon(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Sets up or stops the merged stream
+    *
+    * @param[in] p_command  The merge command.
+    */
+    void comMerge(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Sends the stream list
+    *
+    * @param[in] p_command  The stream list command.
+    */
+    void comStreams(Command p_command);
+
     //=========================================================================================================
     /**
     * Starts the Measurement
@@ -210,12 +300,79 @@ private:
     */
     void comStopAll(Command p_command);
 
+    //=========================================================================================================
+    /**
+    * Asks the connector of the client's stream for the measurement info. The info of the merged stream is
+    * assembled from the infos of its connectors.
+    *
+    * @param[in] ID     The client id.
+    */
+    void requestMeasInfo(qint32 ID);
+
+    //=========================================================================================================
+    /**
+    * Receives the measurement info of a connector and forwards it to the client if it subscribed to the
+    * connector's stream.
+    *
+    * @param[in] ID             The client id.
+    * @param[in] p_fiffInfo     The measurement info.
+    */
+    void onMeasInfo(qint32 ID, FIFFLIB::FiffInfo p_fiffInfo);
+
+    //=========================================================================================================
+    /**
+    * Receives a raw buffer of a connector, forwards it in the connector's stream and feeds the merged stream.
+    *
+    * @param[in] p_pMatRawBuffer    The raw buffer.
+    */
+    void onRawBuffer(QSharedPointer<Eigen::MatrixXf> p_pMatRawBuffer);
+
+    //=========================================================================================================
+    /**
+    * Connects the signals of a connector.
+    *
+    * @param[in] p_pConnector   The connector.
+    */
+    void connectConnector(IConnector* p_pConnector);
+
+    //=========================================================================================================
+    /**
+    * Stops, disconnects and deactivates a connector, a merged stream which uses it ends.
+    *
+    * @param[in] p_pConnector   The connector.
+    */
+    void deactivateConnector(IConnector* p_pConnector);
+
+    //=========================================================================================================
+    /**
+    * Returns a loaded connector.
+    *
+    * @param[in] ID     The connector id.
+    *
+    * @return the connector, NULL if no connector has this id.
+    */
+    IConnector* findConnector(qint32 ID) const;
 
+    //=========================================================================================================
+    /**
+    * Tells the fiff stream server which streams exist and which one is primary.
+    */
+    void updateStreams();
 
+    //=========================================================================================================
+    /**
+    * Sends the merged measurement info to the clients which wait for it, once it is complete.
+    */
+    void releaseMergedInfo();
 
     static QVector<IConnector*> s_vecConnectors;       /**< Holds vector of all plugins. */
 
     FiffStreamServer* m_pFiffStreamServer;
+
+    qint32                      m_iPrimaryConnectorId;  /**< Id of the primary connector. */
+    QMap<qint32, FiffInfo>      m_qMapStreamInfos;      /**< The last measurement info of each connector stream. */
+    StreamMerger::SPtr          m_pStreamMerger;        /**< Produces the merged stream, null if no streams are merged. */
+    QSet<qint32>                m_qSetMergedInfoIds;    /**< Clients which wait for the merged measurement info. */
 };
 
 
@@ -0,0 +1,714 @@
+//=============================================================================================================
+/**
+* @file     fiffstreamclient.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Limin Sun <liminsun@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh, Limin Sun and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief     implementation of the FiffStreamClient Class. Replaces the FiffStreamThread of July, 2012,
+*            its socket is served by an event loop of the IOThreadPool.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiffstreamclient.h"
+#include "mne_rt_commands.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Fiff INCLUDES
+//=============================================================================================================
+
+#include <utils/ioutils.h>
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_tag.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtNetwork>
+#include <QtEndian>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace RTSERVER;
+using namespace FIFFLIB;
+using namespace REALTIMELIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// CONST
+//=============================================================================================================
+
+/**
+* Bytes which are handed to the socket at most. The backlog of a slow client stays in the shared send queue
+* instead of being copied into the socket buffer.
+*/
+const qint64 socketWriteWatermark = 1024*1024;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffStreamClient::FiffStreamClient(qint32 id, qintptr socketDescriptor)
+: QObject()
+, m_iDataClientId(id)
+, m_sDataClientAlias(QString(""))
+, m_iSocketDescriptor(socketDescriptor)
+, m_pTcpSocket(Q_NULLPTR)
+, m_iHeadOffset(0)
+, m_iQueuedBytes(0)
+, m_iMaxQueueDepth(0)
+, m_bFlushScheduled(false)
+, m_sendPolicy(DropOldest)
+, m_iQueueLimit(100)
+, m_iQueuedBuffers(0)
+, m_iSentBuffers(0)
+, m_iDroppedBuffers(0)
+, m_iDecimatedBuffers(0)
+, m_bSkipNextBuffer(false)
+, m_iStreamId(-1)
+, m_bIsSendingRawBuffer(false)
+{
+}
+
+
+//*************************************************************************************************************
+
+FiffStreamClient::~FiffStreamClient()
+{
+    if(m_pTcpSocket)
+    {
+        m_pTcpSocket->disconnect(this);
+        m_pTcpSocket->abort();
+    }
+}
+
+
+//*************************************************************************************************************
+
+QString FiffStreamClient::getAlias()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_sDataClientAlias;
+}
+
+
+//*************************************************************************************************************
+
+int FiffStreamClient::queueDepth()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_qSendQueue.size();
+}
+
+
+//*************************************************************************************************************
+
+int FiffStreamClient::maxQueueDepth()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iMaxQueueDepth;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffStreamClient::queuedBytes()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iQueuedBytes - m_iHeadOffset;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffStreamClient::sentBuffers()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iSentBuffers;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffStreamClient::droppedBuffers()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iDroppedBuffers;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffStreamClient::decimatedBuffers()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iDecimatedBuffers;
+}
+
+
+//*************************************************************************************************************
+
+FiffStreamClient::SendPolicy FiffStreamClient::sendPolicy()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_sendPolicy;
+}
+
+
+//*************************************************************************************************************
+
+int FiffStreamClient::queueLimit()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iQueueLimit;
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::setSendPolicy(SendPolicy p_policy, int p_iQueueLimit)
+{
+    QMutexLocker t_locker(&m_qMutex);
+    m_sendPolicy = p_policy;
+    m_iQueueLimit = qMax(1, p_iQueueLimit);
+
+    //A smaller limit applies right away
+    while(m_iQueuedBuffers > m_iQueueLimit && m_sendPolicy != Disconnect)
+    {
+        int t_iQueuedBuffers = m_iQueuedBuffers;
+        dropOldestBuffer();
+        if(m_iQueuedBuffers == t_iQueuedBuffers)
+            break;
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStreamClient::parseSendPolicy(const QString& p_sName, SendPolicy& p_policy)
+{
+    QString t_sName = p_sName.trimmed().toLower();
+
+    if(t_sName == "drop")
+        p_policy = DropOldest;
+    else if(t_sName == "decimate")
+        p_policy = Decimate;
+    else if(t_sName == "disconnect")
+        p_policy = Disconnect;
+    else
+        return false;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+QString FiffStreamClient::sendPolicyName(SendPolicy p_policy)
+{
+    switch(p_policy)
+    {
+        case Decimate:
+            return QString("decimate");
+        case Disconnect:
+            return QString("disconnect");
+        case DropOldest:
+        default:
+            return QString("drop");
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStreamClient::openSharedMemory(const QString& p_sKey, qint32 p_iCapacity)
+{
+    SharedMemoryRing::SPtr t_pSharedMemoryRing;
+
+    if(p_iCapacity > 0)
+    {
+        t_pSharedMemoryRing = SharedMemoryRing::SPtr(new SharedMemoryRing);
+        if(!t_pSharedMemoryRing->create(p_sKey, p_iCapacity))
+            return false;
+    }
+
+    //The previous ring wakes its reader when it is released
+    QMutexLocker t_locker(&m_qMutex);
+    m_pSharedMemoryRing = t_pSharedMemoryRing;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStreamClient::usesSharedMemory()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return !m_pSharedMemoryRing.isNull();
+}
+
+
+//*************************************************************************************************************
+
+QString FiffStreamClient::profileKey()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_sProfileKey;
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::setProfileKey(const QString& p_sKey)
+{
+    QMutexLocker t_locker(&m_qMutex);
+    m_sProfileKey = p_sKey;
+}
+
+
+//*************************************************************************************************************
+
+qint32 FiffStreamClient::streamId()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    return m_iStreamId;
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::setStreamId(qint32 p_iStreamId)
+{
+    QMutexLocker t_locker(&m_qMutex);
+    m_iStreamId = p_iStreamId;
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::enqueue(const QByteArray& p_blockEncoded, bool p_bRawBuffer)
+{
+    if(p_blockEncoded.isEmpty())
+        return;
+
+    SendBlock t_sendBlock;
+    t_sendBlock.block = p_blockEncoded;
+    t_sendBlock.bRawBuffer = p_bRawBuffer;
+
+    m_qSendQueue.enqueue(t_sendBlock);
+    m_iQueuedBytes += p_blockEncoded.size();
+    if(p_bRawBuffer)
+        ++m_iQueuedBuffers;
+    m_iMaxQueueDepth = qMax(m_iMaxQueueDepth, m_qSendQueue.size());
+
+    //One pending flush serves all blocks which are enqueued until it runs
+    if(!m_bFlushScheduled)
+    {
+        m_bFlushScheduled = true;
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::dropOldestBuffer()
+{
+    //The head is skipped while it is partially written, the client would receive a truncated tag otherwise
+    for(int i = m_iHeadOffset > 0 ? 1 : 0; i < m_qSendQueue.size(); ++i)
+    {
+        if(m_qSendQueue.at(i).bRawBuffer)
+        {
+            m_iQueuedBytes -= m_qSendQueue.at(i).block.size();
+            m_qSendQueue.removeAt(i);
+            --m_iQueuedBuffers;
+            ++m_iDroppedBuffers;
+            return;
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::startMeas(qint32 ID)
+{
+    if(ID == m_iDataClientId)
+    {
+        qDebug() << "Activate raw buffer sending.";
+
+        QByteArray t_blockStart;
+        FiffStream t_FiffStreamOut(&t_blockStart, QIODevice::WriteOnly);
+        t_FiffStreamOut.start_block(FIFFB_RAW_DATA);
+
+        m_qMutex.lock();
+        if(m_pSharedMemoryRing)
+            m_pSharedMemoryRing->write(t_blockStart.constData(), t_blockStart.size());
+        else
+            enqueue(t_blockStart);
+        m_bSkipNextBuffer = false;
+        m_bIsSendingRawBuffer = true;
+        m_qMutex.unlock();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::stopMeas(qint32 ID)
+{
+    if(ID == m_iDataClientId || ID == -1)
+    {
+        qDebug() << "stop raw buffer sending.";
+
+        QByteArray t_blockEnd;
+        FiffStream t_FiffStreamOut(&t_blockEnd, QIODevice::WriteOnly);
+        t_FiffStreamOut.end_block(FIFFB_RAW_DATA);
+
+        m_qMutex.lock();
+        if(m_pSharedMemoryRing)
+            m_pSharedMemoryRing->write(t_blockEnd.constData(), t_blockEnd.size());
+        else
+            enqueue(t_blockEnd);
+        m_bIsSendingRawBuffer = false;
+        m_qMutex.unlock();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::parseCommand(FiffTag::SPtr p_pTag)
+{
+    if(p_pTag->size() >= 4)
+    {
+        qint32* t_pInt = (qint32*)p_pTag->data();
+        IOUtils::swap_intp(t_pInt);
+        qint32 t_iCmd = t_pInt[0];
+
+        if(t_iCmd == MNE_RT_SET_CLIENT_ALIAS)
+        {
+            //
+            // Set Client Alias
+            //
+            m_qMutex.lock();
+            m_sDataClientAlias = QString(p_pTag->mid(4, p_pTag->size()-4));
+            m_qMutex.unlock();
+            printf("FiffStreamClient (ID %d): new alias = '%s'\r\n\n", m_iDataClientId, getAlias().toUtf8().constData());
+        }
+        else if(t_iCmd == MNE_RT_GET_CLIENT_ID)
+        {
+            //
+            // Send Client ID
+            //
+            printf("FiffStreamClient (ID %d): send client ID %d\r\n\n", m_iDataClientId, m_iDataClientId);
+            writeClientId();
+        }
+        else
+        {
+            printf("FiffStreamClient (ID %d): unknown command\r\n\n", m_iDataClientId);
+        }
+    }
+    else
+    {
+        printf("FiffStreamClient (ID %d): unknown command\r\n\n", m_iDataClientId);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::sendRawBuffer(const QByteArray& p_blockEncodedTag)
+{
+    if(!m_bIsSendingRawBuffer)
+        return;
+
+    QMutexLocker t_locker(&m_qMutex);
+
+    //A local client reads the ring itself, a full ring drops the buffer
+    if(m_pSharedMemoryRing)
+    {
+        if(m_pSharedMemoryRing->write(p_blockEncodedTag.constData(), p_blockEncodedTag.size()))
+            ++m_iSentBuffers;
+        else
+            ++m_iDroppedBuffers;
+        return;
+    }
+
+    switch(m_sendPolicy)
+    {
+        case Decimate:
+            if(m_iQueuedBuffers >= (m_iQueueLimit+1)/2)
+            {
+                m_bSkipNextBuffer = !m_bSkipNextBuffer;
+                if(m_bSkipNextBuffer)
+                {
+                    ++m_iDecimatedBuffers;
+                    return;
+                }
+            }
+            else
+            {
+                m_bSkipNextBuffer = false;
+            }
+            if(m_iQueuedBuffers >= m_iQueueLimit)
+                dropOldestBuffer();
+            break;
+        case Disconnect:
+            if(m_iQueuedBuffers >= m_iQueueLimit)
+            {
+                printf("FiffStreamClient (ID %d): send queue full, closing connection\r\n\n", m_iDataClientId);
+                ++m_iDroppedBuffers;
+                m_bIsSendingRawBuffer = false;
+                QMetaObject::invokeMethod(this, "abortConnection", Qt::QueuedConnection);
+                return;
+            }
+            break;
+        case DropOldest:
+        default:
+            if(m_iQueuedBuffers >= m_iQueueLimit)
+                dropOldestBuffer();
+            break;
+    }
+
+    //Nothing could be dropped, i.e. the only queued raw buffer is partially written
+    if(m_iQueuedBuffers >= m_iQueueLimit)
+    {
+        ++m_iDroppedBuffers;
+        return;
+    }
+
+    enqueue(p_blockEncodedTag, true);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::sendRawBuffers(qint32 p_iStreamId, const QHash<QString, QByteArray>& p_hashEncodedTags)
+{
+    if(!m_bIsSendingRawBuffer)
+        return;
+
+    m_qMutex.lock();
+    QString t_sProfileKey = m_sProfileKey;
+    bool t_bSubscribed = m_iStreamId == p_iStreamId;
+    m_qMutex.unlock();
+
+    if(!t_bSubscribed)
+        return;
+
+    //A decimating profile leaves some buffers without samples
+    QHash<QString, QByteArray>::const_iterator t_it = p_hashEncodedTags.constFind(t_sProfileKey);
+    if(t_it != p_hashEncodedTags.constEnd() && !t_it.value().isEmpty())
+        sendRawBuffer(t_it.value());
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo)
+{
+    if(ID == m_iDataClientId)
+    {
+        QByteArray t_blockMeasInfo;
+        FiffStream t_FiffStreamOut(&t_blockMeasInfo, QIODevice::WriteOnly);
+
+        p_fiffInfo.writeToStream(&t_FiffStreamOut);
+
+        m_qMutex.lock();
+        enqueue(t_blockMeasInfo);
+        m_qMutex.unlock();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::writeClientId()
+{
+    QByteArray t_blockClientId;
+    FiffStream t_FiffStreamOut(&t_blockClientId, QIODevice::WriteOnly);
+
+    t_FiffStreamOut.write_int(FIFF_MNE_RT_CLIENT_ID, &m_iDataClientId);
+
+    m_qMutex.lock();
+    enqueue(t_blockClientId);
+    m_qMutex.unlock();
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::open()
+{
+    m_pTcpSocket = new QTcpSocket(this);
+
+    if (!m_pTcpSocket->setSocketDescriptor(m_iSocketDescriptor)) {
+        emit error(m_pTcpSocket->error());
+        emit disconnected(m_iDataClientId);
+        return;
+    }
+
+    //Latency matters more than packet count for streamed buffers
+    m_pTcpSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+    printf("FiffStreamClient (assigned ID %d) accepted from\n\tIP:\t%s\n\tPort:\t%d\n\n",
+           m_iDataClientId,
+           QHostAddress(m_pTcpSocket->peerAddress()).toString().toUtf8().constData(),
+           m_pTcpSocket->peerPort());
+
+    connect(m_pTcpSocket, &QTcpSocket::readyRead, this, &FiffStreamClient::readTags);
+    connect(m_pTcpSocket, &QTcpSocket::bytesWritten, this, &FiffStreamClient::flush);
+    connect(m_pTcpSocket, &QTcpSocket::disconnected, this, &FiffStreamClient::onDisconnected);
+
+    //Blocks which were enqueued before the socket was open
+    flush();
+    readTags();
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::onDisconnected()
+{
+    //No raw buffer is queued for a client which is gone
+    m_qMutex.lock();
+    m_bIsSendingRawBuffer = false;
+    if(m_pSharedMemoryRing)
+        m_pSharedMemoryRing->close();
+    m_qMutex.unlock();
+
+    emit disconnected(m_iDataClientId);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::abortConnection()
+{
+    if(m_pTcpSocket)
+        m_pTcpSocket->abort();
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::readTags()
+{
+    if(!m_pTcpSocket)
+        return;
+
+    FiffStream t_FiffStreamIn(m_pTcpSocket);
+
+    while(m_pTcpSocket->bytesAvailable() >= (int)sizeof(qint32)*4)
+    {
+        //The tag is only read once it is complete, the size is the third field of the big endian tag header
+        QByteArray t_blockHeader = m_pTcpSocket->peek(sizeof(qint32)*4);
+        qint32 t_iSize = qFromBigEndian<qint32>(reinterpret_cast<const uchar*>(t_blockHeader.constData()) + 2*sizeof(qint32));
+
+        if(t_iSize < 0)
+        {
+            printf("FiffStreamClient (ID %d): invalid tag size, closing connection\r\n\n", m_iDataClientId);
+            m_pTcpSocket->abort();
+            return;
+        }
+
+        if(m_pTcpSocket->bytesAvailable() < (qint64)sizeof(qint32)*4 + t_iSize)
+            break;
+
+        FiffTag::SPtr t_pTag;
+        t_FiffStreamIn.read_tag_info(t_pTag, false);
+        t_FiffStreamIn.read_tag_data(t_pTag);
+
+        //
+        // Parse the tag
+        //
+        if(t_pTag->kind == FIFF_MNE_RT_COMMAND)
+        {
+            parseCommand(t_pTag);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamClient::flush()
+{
+    if(!m_pTcpSocket || m_pTcpSocket->state() != QAbstractSocket::ConnectedState)
+        return;
+
+    m_qMutex.lock();
+    m_bFlushScheduled = false;
+
+    //Gather as many queued blocks as the watermark allows, they leave with as few system calls as possible
+    while(!m_qSendQueue.isEmpty() && m_pTcpSocket->bytesToWrite() < socketWriteWatermark)
+    {
+        const QByteArray& t_blockHead = m_qSendQueue.head().block;
+        qint64 t_iBytesWritten = m_pTcpSocket->write(t_blockHead.constData() + m_iHeadOffset, t_blockHead.size() - m_iHeadOffset);
+
+        if(t_iBytesWritten < 0)
+            break;
+
+        m_iHeadOffset += t_iBytesWritten;
+        if(m_iHeadOffset < t_blockHead.size())
+            break;
+
+        m_iQueuedBytes -= t_blockHead.size();
+        m_iHeadOffset = 0;
+        if(m_qSendQueue.dequeue().bRawBuffer)
+        {
+            --m_iQueuedBuffers;
+            ++m_iSentBuffers;
+        }
+    }
+    m_qMutex.unlock();
+
+    //Write without waiting for the next event loop round, this never blocks. Unlocked, since the socket
+    //reports the written bytes right away, which calls flush again.
+    m_pTcpSocket->flush();
+}
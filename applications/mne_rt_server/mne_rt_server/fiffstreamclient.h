@@ -0,0 +1,389 @@
+//=============================================================================================================
+/**
+* @file     fiffstreamclient.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief     FiffStreamClient class declaration. Replaces the FiffStreamThread of July, 2012, its socket is served
+*            by an event loop of the IOThreadPool.
+*
+*/
+
+#ifndef FIFFSTREAMCLIENT_H
+#define FIFFSTREAMCLIENT_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_info.h>
+#include <realtime/rtClient/sharedmemoryring.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QHash>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVER
+//=============================================================================================================
+
+namespace RTSERVER
+{
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+
+//=============================================================================================================
+/**
+* A fiff data client connection. The object lives in one of the I/O threads of the FiffStreamServer, its socket
+* is serviced by the event loop of that thread. Encoded tags are enqueued from any thread and written as soon
+* as the socket can take them. The number of queued raw buffers is bounded, the send policy decides what happens
+* when a client can not keep up. A client on the same host may receive the raw buffers through a shared memory
+* ring instead, the measurement info and the client id still go through the socket.
+*
+* @brief FiffStreamClient serves one fiff data client
+*/
+class FiffStreamClient : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+    * What happens to a raw buffer when the send queue of the client is full. The buffers are handed out in the
+    * main thread, so no policy waits for the client.
+    */
+    enum SendPolicy {
+        DropOldest,         /**< The oldest queued raw buffer is dropped. */
+        Decimate,           /**< Every second raw buffer is skipped once the queue is half full, the oldest is dropped when it is full. */
+        Disconnect          /**< The client is disconnected. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a FiffStreamClient. The socket is opened by open() in the thread the client was moved to.
+    *
+    * @param[in] id                 The client id.
+    * @param[in] socketDescriptor   The socket descriptor of the accepted connection.
+    */
+    FiffStreamClient(qint32 id, qintptr socketDescriptor);
+
+    ~FiffStreamClient();
+
+    inline qint32 getID();
+
+    QString getAlias();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of encoded tags waiting to be written to the client socket.
+    *
+    * @return the current send queue depth.
+    */
+    int queueDepth();
+
+    //=========================================================================================================
+    /**
+    * Returns the largest send queue depth since the client connected.
+    *
+    * @return the maximal send queue depth.
+    */
+    int maxQueueDepth();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of bytes waiting to be written to the client socket.
+    *
+    * @return the queued bytes.
+    */
+    qint64 queuedBytes();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of raw buffers which were written to the client socket.
+    *
+    * @return the sent raw buffers.
+    */
+    qint64 sentBuffers();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of raw buffers which were dropped because the send queue was full.
+    *
+    * @return the dropped raw buffers.
+    */
+    qint64 droppedBuffers();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of raw buffers which were skipped by the Decimate policy.
+    *
+    * @return the skipped raw buffers.
+    */
+    qint64 decimatedBuffers();
+
+    //=========================================================================================================
+    /**
+    * Returns the current send policy.
+    *
+    * @return the send policy.
+    */
+    SendPolicy sendPolicy();
+
+    //=========================================================================================================
+    /**
+    * Returns the maximal number of queued raw buffers.
+    *
+    * @return the queue limit.
+    */
+    int queueLimit();
+
+    //=========================================================================================================
+    /**
+    * Sets the policy which is applied when the send queue is full.
+    *
+    * @param[in] p_policy       The send policy.
+    * @param[in] p_iQueueLimit  The maximal number of queued raw buffers, at least one.
+    */
+    void setSendPolicy(SendPolicy p_policy, int p_iQueueLimit);
+
+    //=========================================================================================================
+    /**
+    * Parses a send policy name, i.e. drop, decimate or disconnect.
+    *
+    * @param[in] p_sName    The policy name.
+    * @param[out] p_policy  The parsed policy.
+    *
+    * @return true if the name is valid.
+    */
+    static bool parseSendPolicy(const QString& p_sName, SendPolicy& p_policy);
+
+    //=========================================================================================================
+    /**
+    * Returns the name of a send policy, as accepted by parseSendPolicy.
+    *
+    * @param[in] p_policy   The send policy.
+    *
+    * @return the policy name.
+    */
+    static QString sendPolicyName(SendPolicy p_policy);
+
+    //=========================================================================================================
+    /**
+    * Creates a shared memory ring which carries the raw buffers from now on, or returns to the socket.
+    *
+    * @param[in] p_sKey         The key of the ring, the client attaches with it.
+    * @param[in] p_iCapacity    Bytes of the ring, 0 returns to the socket.
+    *
+    * @return true if the transport was switched.
+    */
+    bool openSharedMemory(const QString& p_sKey, qint32 p_iCapacity);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the raw buffers are written to a shared memory ring.
+    *
+    * @return true if a shared memory ring is used.
+    */
+    bool usesSharedMemory();
+
+    //=========================================================================================================
+    /**
+    * Returns the key of the stream profile the client receives.
+    *
+    * @return the profile key, empty for the full stream.
+    */
+    QString profileKey();
+
+    //=========================================================================================================
+    /**
+    * Selects the stream profile the client receives from now on.
+    *
+    * @param[in] p_sKey     The profile key, empty for the full stream.
+    */
+    void setProfileKey(const QString& p_sKey);
+
+    //=========================================================================================================
+    /**
+    * Returns the measurement stream the client subscribed to.
+    *
+    * @return the stream id.
+    */
+    qint32 streamId();
+
+    //=========================================================================================================
+    /**
+    * Subscribes the client to a measurement stream, it receives the raw buffers of this stream only.
+    *
+    * @param[in] p_iStreamId    The stream id.
+    */
+    void setStreamId(qint32 p_iStreamId);
+
+    void startMeas(qint32 ID);
+
+    void stopMeas(qint32 ID);
+
+    void sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo);
+
+    void sendRawBuffer(const QByteArray& p_blockEncodedTag);
+
+    //=========================================================================================================
+    /**
+    * Sends the tag of the stream profile of this client if it subscribed to the stream of the raw buffer.
+    *
+    * @param[in] p_iStreamId        The stream of the raw buffer.
+    * @param[in] p_hashEncodedTags  The encoded tags of the current raw buffer by profile key, the full stream has
+    *                               an empty key.
+    */
+    void sendRawBuffers(qint32 p_iStreamId, const QHash<QString, QByteArray>& p_hashEncodedTags);
+
+signals:
+    void error(QTcpSocket::SocketError socketError);
+
+    //=========================================================================================================
+    /**
+    * Emitted when the peer closed the connection.
+    *
+    * @param[in] id     The client id.
+    */
+    void disconnected(qint32 id);
+
+private slots:
+    //=========================================================================================================
+    /**
+    * Creates the socket from the descriptor. Has to run in the I/O thread.
+    */
+    void open();
+
+    //=========================================================================================================
+    /**
+    * Reads and parses all complete tags which are available on the socket.
+    */
+    void readTags();
+
+    //=========================================================================================================
+    /**
+    * Hands queued blocks to the socket until its write buffer reaches the watermark and pushes them out
+    * without blocking. Called whenever blocks were enqueued and whenever the socket wrote bytes.
+    */
+    void flush();
+
+    //=========================================================================================================
+    /**
+    * Forwards the disconnect of the socket together with the client id.
+    */
+    void onDisconnected();
+
+    //=========================================================================================================
+    /**
+    * Aborts the connection, called by the Disconnect policy.
+    */
+    void abortConnection();
+
+private:
+    /**
+    * A block of the send queue.
+    */
+    struct SendBlock {
+        QByteArray  block;          /**< The encoded block. Implicitly shared, raw buffers are shared among all clients. */
+        bool        bRawBuffer;     /**< Whether the block is a raw buffer tag, only those may be dropped. */
+    };
+
+    void parseCommand(QSharedPointer<FiffTag> p_pTag);
+
+    void writeClientId();
+
+    //=========================================================================================================
+    /**
+    * Appends an encoded block to the send queue and schedules a flush in the I/O thread. Has to be called with
+    * m_qMutex locked.
+    *
+    * @param[in] p_blockEncoded     The encoded block. Implicitly shared, the data is not copied.
+    * @param[in] p_bRawBuffer       Whether the block is a raw buffer tag.
+    */
+    void enqueue(const QByteArray& p_blockEncoded, bool p_bRawBuffer = false);
+
+    //=========================================================================================================
+    /**
+    * Drops the oldest queued raw buffer which is not being written. Has to be called with m_qMutex locked.
+    */
+    void dropOldestBuffer();
+
+    qint32 m_iDataClientId;
+    QString m_sDataClientAlias;
+
+    qintptr m_iSocketDescriptor;
+    QTcpSocket* m_pTcpSocket;           /**< The client socket, owned by this object and living in its thread. */
+
+    QMutex m_qMutex;
+    QQueue<SendBlock> m_qSendQueue;     /**< Encoded tags in sending order. */
+    qint64 m_iHeadOffset;               /**< Bytes of the queue head which were already written to the socket. */
+    qint64 m_iQueuedBytes;              /**< Bytes of all queued tags which are not yet written. */
+    int m_iMaxQueueDepth;               /**< The largest queue depth seen so far. */
+    bool m_bFlushScheduled;             /**< Whether a flush is already pending in the I/O thread. */
+
+    SendPolicy m_sendPolicy;            /**< What happens to a raw buffer when the queue is full. */
+    int m_iQueueLimit;                  /**< Maximal number of queued raw buffers. */
+    int m_iQueuedBuffers;               /**< Number of queued raw buffers. */
+    qint64 m_iSentBuffers;              /**< Raw buffers written to the socket. */
+    qint64 m_iDroppedBuffers;           /**< Raw buffers dropped because the queue was full. */
+    qint64 m_iDecimatedBuffers;         /**< Raw buffers skipped by the Decimate policy. */
+    bool m_bSkipNextBuffer;             /**< Whether the Decimate policy skips the next raw buffer. */
+
+    REALTIMELIB::SharedMemoryRing::SPtr m_pSharedMemoryRing;    /**< Carries the raw buffers of a local client, null for the socket. */
+    QString m_sProfileKey;              /**< Key of the stream profile, empty for the full stream. */
+    qint32 m_iStreamId;                 /**< The subscribed measurement stream. */
+
+    bool m_bIsSendingRawBuffer;
+};
+
+
+inline qint32 FiffStreamClient::getID()
+{
+    return m_iDataClientId;
+}
+
+} // NAMESPACE
+
+#endif //FIFFSTREAMCLIENT_H
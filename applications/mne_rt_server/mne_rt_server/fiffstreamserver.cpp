@@ -39,10 +39,13 @@
 //=============================================================================================================
 
 #include "fiffstreamserver.h"
-#include "fiffstreamthread.h"
+#include "fiffstreamclient.h"
 
 #include "mne_rt_server.h"
 
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_stream.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -52,6 +55,19 @@
 #include <stdlib.h>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -69,6 +85,10 @@ using namespace FIFFLIB;
 FiffStreamServer::FiffStreamServer(QObject *parent)
 : QTcpServer(parent)
 , m_iNextClientId(0)
+, m_defaultSendPolicy(FiffStreamClient::DropOldest)
+, m_iDefaultQueueLimit(100)
+, m_iPrimaryStreamId(_default)
+, m_ioThreadPool(IoThreadPool::defaultThreadCount(), "FiffStreamServer I/O")
 {
 
 }
@@ -79,6 +99,12 @@ FiffStreamServer::FiffStreamServer(QObject *parent)
 FiffStreamServer::~FiffStreamServer()
 {
     emit closeFiffStreamServer();
+
+    //The clients are deleted in their threads before the I/O threads finish
+    QMap<qint32, FiffStreamClient*>::const_iterator i = m_qClientList.constBegin();
+    for(; i != m_qClientList.constEnd(); ++i)
+        i.value()->deleteLater();
+    m_qClientList.clear();
 }
 
 
@@ -88,11 +114,17 @@ void FiffStreamServer::comClist(Command p_command)
 {
     //ToDo JSON
     QString t_sOutput("");
-    t_sOutput.append("\tID\tAlias\r\n");
-    QMap<qint32, FiffStreamThread*>::iterator i;
+    t_sOutput.append("\tID\tAlias\tStream\tQueue\tMax queue\tQueued bytes\tPolicy\tSent\tDropped\tDecimated\tTransport\tProfile\r\n");
+    QMap<qint32, FiffStreamClient*>::iterator i;
     for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
     {
-        QString str = QString("\t%1\t%2\r\n").arg(i.key()).arg(i.value()->getAlias());
+        QString str = QString("\t%1\t%2\t%3\t%4\t%5\t%6").arg(i.key()).arg(i.value()->getAlias()).arg(i.value()->streamId())
+                .arg(i.value()->queueDepth()).arg(i.value()->maxQueueDepth()).arg(i.value()->queuedBytes());
+        QString t_sProfileKey = i.value()->profileKey();
+        str.append(QString("\t%1/%2\t%3\t%4\t%5\t%6\t%7\r\n").arg(FiffStreamClient::sendPolicyName(i.value()->sendPolicy()))
+                .arg(i.value()->queueLimit()).arg(i.value()->sentBuffers()).arg(i.value()->droppedBuffers())
+                .arg(i.value()->decimatedBuffers()).arg(i.value()->usesSharedMemory() ? "shm" : "tcp")
+                .arg(t_sProfileKey.isEmpty() ? QString("full") : t_sProfileKey));
         t_sOutput.append(str);
     }
     t_sOutput.append("\n");
@@ -173,6 +205,188 @@ void FiffStreamServer::comStopAll(Command p_command)
 }
 
 
+//*************************************************************************************************************
+
+void FiffStreamServer::comSendpolicy(Command p_command)
+{
+    QString t_sOutput("");
+    QString t_sAlias(p_command.pValues()[0].toString());
+    QString t_sPolicy(p_command.pValues()[1].toString());
+    int t_iQueueLimit = p_command.pValues()[2].toInt();
+
+    FiffStreamClient::SendPolicy t_policy;
+    if(!FiffStreamClient::parseSendPolicy(t_sPolicy, t_policy))
+    {
+        t_sOutput.append(QString("\twarning: unknown send policy '%1', use drop, decimate or disconnect\r\n\n").arg(t_sPolicy));
+    }
+    else if(t_iQueueLimit < 1)
+    {
+        t_sOutput.append("\twarning: the queue limit has to be at least one raw buffer\r\n\n");
+    }
+    else if(t_sAlias.trimmed() == "-1")
+    {
+        m_defaultSendPolicy = t_policy;
+        m_iDefaultQueueLimit = t_iQueueLimit;
+
+        QMap<qint32, FiffStreamClient*>::iterator i;
+        for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
+            i.value()->setSendPolicy(t_policy, t_iQueueLimit);
+
+        t_sOutput.append(QString("\tall FiffStreamClients use send policy %1 with a queue of %2 raw buffers\r\n\n")
+                         .arg(FiffStreamClient::sendPolicyName(t_policy)).arg(t_iQueueLimit));
+    }
+    else
+    {
+        qint32 t_id = -1;
+        t_sOutput.append(parseToId(t_sAlias,t_id));
+
+        if(t_id != -1)
+        {
+            m_qClientList[t_id]->setSendPolicy(t_policy, t_iQueueLimit);
+
+            QString str = QString("\tFiffStreamClient (ID: %1) uses send policy %2 with a queue of %3 raw buffers\r\n\n")
+                    .arg(t_id).arg(FiffStreamClient::sendPolicyName(t_policy)).arg(t_iQueueLimit);
+            t_sOutput.append(str);
+        }
+    }
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["sendpolicy"].reply(t_sOutput);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::comShmem(Command p_command)
+{
+    qint32 t_id = -1;
+    QString t_sOutput("");
+    QString t_sAlias(p_command.pValues()[0].toString());
+    qint32 t_iCapacity = p_command.pValues()[1].toInt();
+    t_sOutput.append(parseToId(t_sAlias,t_id));
+
+    //The key is unique per server process and client
+    QString t_sKey;
+    if(t_id != -1)
+    {
+        t_sKey = t_iCapacity > 0 ? QString("mne_rt_server_%1_%2").arg(QCoreApplication::applicationPid()).arg(t_id) : QString("");
+
+        if(m_qClientList[t_id]->openSharedMemory(t_sKey, t_iCapacity))
+        {
+            QString str = t_iCapacity > 0 ? QString("\tFiffStreamClient (ID: %1) receives raw buffers via shared memory '%2'\r\n\n").arg(t_id).arg(t_sKey)
+                                          : QString("\tFiffStreamClient (ID: %1) receives raw buffers via TCP\r\n\n").arg(t_id);
+            t_sOutput.append(str);
+        }
+        else
+        {
+            t_sKey.clear();
+            t_sOutput.append("\twarning: unable to create the shared memory ring\r\n\n");
+        }
+    }
+
+    if(p_command.isJson())
+    {
+        //The client reads the key, an empty key means TCP
+        QJsonObject t_qJsonObjectShmem;
+        t_qJsonObjectShmem.insert("id", QJsonValue(t_id));
+        t_qJsonObjectShmem.insert("key", QJsonValue(t_sKey));
+
+        QJsonObject t_qJsonObjectRoot;
+        t_qJsonObjectRoot.insert("shmem", t_qJsonObjectShmem);
+        QJsonDocument p_qJsonDocument(t_qJsonObjectRoot);
+
+        qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["shmem"].reply(p_qJsonDocument.toJson());
+    }
+    else
+    {
+        qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["shmem"].reply(t_sOutput);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::comProfile(Command p_command)
+{
+    QString t_sOutput("");
+    QString t_sChannels(p_command.pValues()[0].toString());
+    QString t_sCompress(p_command.pValues()[1].toString().trimmed());
+    int t_iDecimation = p_command.pValues()[2].toInt();
+    QString t_sFormat(p_command.pValues()[3].toString().trimmed());
+    QString t_sAlias(p_command.pValues()[4].toString());
+
+    QList<int> t_qListChannels;
+    if(!StreamProfile::parseChannels(t_sChannels, t_qListChannels))
+    {
+        t_sOutput.append(QString("\twarning: invalid channel selection '%1', use indices and ranges like 0-9,20 or all\r\n\n").arg(t_sChannels));
+    }
+    else if(t_sCompress != "none" && t_sCompress != "zlib")
+    {
+        t_sOutput.append(QString("\twarning: unknown compression '%1', use none or zlib\r\n\n").arg(t_sCompress));
+    }
+    else if(t_sFormat != "float" && t_sFormat != "int16")
+    {
+        t_sOutput.append(QString("\twarning: unknown format '%1', use float or int16\r\n\n").arg(t_sFormat));
+    }
+    else if(t_iDecimation < 1)
+    {
+        t_sOutput.append("\twarning: the decimation factor has to be at least 1\r\n\n");
+    }
+    else
+    {
+        qint32 t_id = -1;
+        qint32 t_iStreamId = -1;
+        t_sOutput.append(parseToId(t_sAlias,t_id));
+
+        //The list is sorted, its last index has to be a channel of the client's stream once the channels are known
+        if(t_id != -1 && getClientStream(t_id, t_iStreamId) && !t_qListChannels.isEmpty()
+                && streamChannels(t_iStreamId) >= 0 && t_qListChannels.last() >= streamChannels(t_iStreamId))
+        {
+            t_sOutput.append(QString("\twarning: channel %1 is beyond the %2 channels of stream %3\r\n\n")
+                             .arg(t_qListChannels.last()).arg(streamChannels(t_iStreamId)).arg(t_iStreamId));
+        }
+        else if(t_id != -1)
+        {
+            StreamProfile::SPtr t_pProfile(new StreamProfile(t_qListChannels, t_iDecimation, t_sFormat == "int16", t_sCompress == "zlib"));
+            setStreamProfile(t_id, t_pProfile);
+
+            QString str = QString("\tFiffStreamClient (ID: %1) receives the stream profile %2\r\n\n")
+                    .arg(t_id).arg(t_pProfile->isFullStream() ? QString("full") : t_pProfile->key());
+            t_sOutput.append(str);
+        }
+    }
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["profile"].reply(t_sOutput);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::comSubscribe(Command p_command)
+{
+    qint32 t_id = -1;
+    QString t_sOutput("");
+    QString t_sAlias(p_command.pValues()[0].toString());
+    qint32 t_iStreamId = p_command.pValues()[1].toInt();
+
+    if(t_iStreamId != m_iPrimaryStreamId && !m_qListStreamIds.contains(t_iStreamId))
+    {
+        t_sOutput.append(QString("\twarning: stream %1 is not available, see streams\r\n\n").arg(t_iStreamId));
+    }
+    else
+    {
+        t_sOutput.append(parseToId(t_sAlias,t_id));
+
+        if(t_id != -1)
+        {
+            subscribe(t_id, t_iStreamId);
+
+            QString str = QString("\tFiffStreamClient (ID: %1) receives stream %2, request the measurement info again\r\n\n")
+                    .arg(t_id).arg(t_iStreamId);
+            t_sOutput.append(str);
+        }
+    }
+    qobject_cast<MNERTServer*>(this->parent())->getCommandManager()["subscribe"].reply(t_sOutput);
+}
+
+
 //*************************************************************************************************************
 
 void FiffStreamServer::connectCommands()
@@ -182,9 +396,13 @@ void FiffStreamServer::connectCommands()
 
     QObject::connect(&t_pMNERTServer->getCommandManager()["clist"], &Command::executed, this, &FiffStreamServer::comClist);
     QObject::connect(&t_pMNERTServer->getCommandManager()["measinfo"], &Command::executed, this, &FiffStreamServer::comMeasinfo);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["profile"], &Command::executed, this, &FiffStreamServer::comProfile);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["sendpolicy"], &Command::executed, this, &FiffStreamServer::comSendpolicy);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["shmem"], &Command::executed, this, &FiffStreamServer::comShmem);
     QObject::connect(&t_pMNERTServer->getCommandManager()["start"], &Command::executed, this, &FiffStreamServer::comStart);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop"], &Command::executed, this, &FiffStreamServer::comStop);
     QObject::connect(&t_pMNERTServer->getCommandManager()["stop-all"], &Command::executed, this, &FiffStreamServer::comStopAll);
+    QObject::connect(&t_pMNERTServer->getCommandManager()["subscribe"], &Command::executed, this, &FiffStreamServer::comSubscribe);
 
 //    t_pMNERTServer->getCommandManager().connectSlot(QString("clist"), this, &FiffStreamServer::comClist);
 //    t_pMNERTServer->getCommandManager().connectSlot(QString("measinfo"), this, &FiffStreamServer::comMeasinfo);
@@ -208,7 +426,7 @@ void FiffStreamServer::connectCommands()
 //        printf("clist\n");
 
 //        p_blockOutputInfo.append("\tID\tAlias\r\n");
-//        QMap<qint32, FiffStreamThread*>::iterator i;
+//        QMap<qint32, FiffStreamClient*>::iterator i;
 //        for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
 //        {
 //            QString str = QString("\t%1\t%2\r\n").arg(i.key()).arg(i.value()->getAlias());
@@ -322,7 +540,7 @@ QByteArray FiffStreamServer::parseToId(QString& p_sRawId, qint32& p_iParsedId)
         }
         else
         {
-            QMap<qint32, FiffStreamThread*>::iterator i;
+            QMap<qint32, FiffStreamClient*>::iterator i;
             for (i = this->m_qClientList.begin(); i != this->m_qClientList.end(); ++i)
             {
                 if(i.value()->getAlias().compare(p_sRawId) == 0)
@@ -354,7 +572,7 @@ QByteArray FiffStreamServer::parseToId(QString& p_sRawId, qint32& p_iParsedId)
 
 //void FiffStreamServer::clearClients()
 //{
-//    QMap<qint32, FiffStreamThread*>::const_iterator i = m_qClientList.constBegin();
+//    QMap<qint32, FiffStreamClient*>::const_iterator i = m_qClientList.constBegin();
 //    while (i != m_qClientList.constEnd()) {
 //        if(i.value())
 //            delete i.value();
@@ -368,15 +586,291 @@ QByteArray FiffStreamServer::parseToId(QString& p_sRawId, qint32& p_iParsedId)
 
 void FiffStreamServer::forwardMeasInfo(qint32 ID, const FiffInfo& p_fiffInfo)
 {
-    emit remitMeasInfo(ID, p_fiffInfo);
+    //A profiled client gets the channels and the sampling frequency of its stream
+    StreamProfile::SPtr t_pProfile;
+    FiffStreamClient* t_pClient = m_qClientList.value(ID);
+    if(t_pClient)
+    {
+        QString t_sProfileKey = t_pClient->profileKey();
+        qint32 t_iStreamId = t_pClient->streamId();
+
+        setStreamChannels(t_iStreamId, p_fiffInfo.nchan);
+
+        QMutexLocker t_locker(&m_qMutexProfiles);
+        t_pProfile = m_qMapProfiles.value(t_iStreamId).value(t_sProfileKey);
+    }
+
+    //A profile set before the channels were known may pick none of them, the client gets the full stream then
+    if(t_pProfile && !t_pProfile->channels().isEmpty() && t_pProfile->channels().first() >= p_fiffInfo.nchan)
+    {
+        qWarning() << "FiffStreamServer::forwardMeasInfo - the profile" << t_pProfile->key() << "of client" << ID
+                   << "picks none of the" << p_fiffInfo.nchan << "channels, sending the full stream";
+        setStreamProfile(ID, StreamProfile::SPtr());
+        t_pProfile.clear();
+    }
+
+    if(t_pProfile)
+        emit remitMeasInfo(ID, t_pProfile->applyTo(p_fiffInfo));
+    else
+        emit remitMeasInfo(ID, p_fiffInfo);
 }
 
 
 //*************************************************************************************************************
-//ToDo increase preformance --> try inline
+
 void FiffStreamServer::forwardRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData)
 {
-    emit remitRawBuffer(m_pMatRawData);
+    forwardStreamBuffer(m_iPrimaryStreamId, m_pMatRawData);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::forwardStreamBuffer(qint32 p_iStreamId, QSharedPointer<Eigen::MatrixXf> p_pMatRawData)
+{
+    if(m_qClientList.isEmpty())
+        return;
+
+    QHash<QString, QByteArray> t_hashEncodedTags;
+
+    QMutexLocker t_locker(&m_qMutexProfiles);
+
+    //Serialize (byte swap) once, all clients of the full stream share the encoded tag
+    if(m_qSetFullStreams.contains(p_iStreamId))
+    {
+        QByteArray t_blockEncodedTag;
+        FiffStream t_FiffStreamOut(&t_blockEncodedTag, QIODevice::WriteOnly);
+        t_FiffStreamOut.write_float(FIFF_DATA_BUFFER,p_pMatRawData->data(),p_pMatRawData->rows()*p_pMatRawData->cols());
+
+        t_hashEncodedTags.insert(QString(), t_blockEncodedTag);
+    }
+
+    //Each profile is encoded once, no matter how many clients use it
+    const QMap<QString, StreamProfile::SPtr> t_qMapProfiles = m_qMapProfiles.value(p_iStreamId);
+    QMap<QString, StreamProfile::SPtr>::const_iterator i;
+    for(i = t_qMapProfiles.constBegin(); i != t_qMapProfiles.constEnd(); ++i)
+        t_hashEncodedTags.insert(i.key(), i.value()->encode(*p_pMatRawData));
+
+    t_locker.unlock();
+
+    if(!t_hashEncodedTags.isEmpty())
+        emit remitRawBuffers(p_iStreamId, t_hashEncodedTags);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::setAvailableStreams(const QList<qint32>& p_qListStreamIds)
+{
+    m_qListStreamIds = p_qListStreamIds;
+
+    QMap<qint32, qint32>::iterator j = m_qMapStreamChannels.begin();
+    while(j != m_qMapStreamChannels.end())
+    {
+        if(j.key() != m_iPrimaryStreamId && !m_qListStreamIds.contains(j.key()))
+            j = m_qMapStreamChannels.erase(j);
+        else
+            ++j;
+    }
+
+    //Clients of a stream which ended fall back to the primary stream
+    QMap<qint32, FiffStreamClient*>::const_iterator i;
+    for(i = m_qClientList.constBegin(); i != m_qClientList.constEnd(); ++i)
+    {
+        qint32 t_iStreamId = i.value()->streamId();
+        if(t_iStreamId != m_iPrimaryStreamId && !m_qListStreamIds.contains(t_iStreamId))
+        {
+            i.value()->setProfileKey(QString());
+            i.value()->setStreamId(m_iPrimaryStreamId);
+        }
+    }
+
+    pruneProfiles();
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::setPrimaryStream(qint32 p_iStreamId)
+{
+    if(p_iStreamId == m_iPrimaryStreamId)
+        return;
+
+    QMap<qint32, FiffStreamClient*>::const_iterator i;
+    for(i = m_qClientList.constBegin(); i != m_qClientList.constEnd(); ++i)
+    {
+        if(i.value()->streamId() == m_iPrimaryStreamId)
+        {
+            i.value()->setProfileKey(QString());
+            i.value()->setStreamId(p_iStreamId);
+        }
+    }
+
+    m_iPrimaryStreamId = p_iStreamId;
+
+    pruneProfiles();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStreamServer::subscribe(qint32 ID, qint32 p_iStreamId)
+{
+    FiffStreamClient* t_pClient = m_qClientList.value(ID);
+    if(!t_pClient)
+        return false;
+
+    t_pClient->setProfileKey(QString());
+    t_pClient->setStreamId(p_iStreamId);
+
+    pruneProfiles();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStreamServer::getClientStream(qint32 ID, qint32& p_iStreamId)
+{
+    FiffStreamClient* t_pClient = m_qClientList.value(ID);
+    if(!t_pClient)
+        return false;
+
+    p_iStreamId = t_pClient->streamId();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::setStreamChannels(qint32 p_iStreamId, qint32 p_iChannels)
+{
+    m_qMapStreamChannels.insert(p_iStreamId, p_iChannels);
+}
+
+
+//*************************************************************************************************************
+
+qint32 FiffStreamServer::streamChannels(qint32 p_iStreamId) const
+{
+    return m_qMapStreamChannels.value(p_iStreamId, -1);
+}
+
+
+//*************************************************************************************************************
+
+int FiffStreamServer::subscriberCount(qint32 p_iStreamId)
+{
+    int t_iCount = 0;
+    QMap<qint32, FiffStreamClient*>::const_iterator i;
+    for(i = m_qClientList.constBegin(); i != m_qClientList.constEnd(); ++i)
+        if(i.value()->streamId() == p_iStreamId)
+            ++t_iCount;
+
+    return t_iCount;
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::removeClient(qint32 ID)
+{
+    FiffStreamClient* t_pClient = m_qClientList.take(ID);
+
+    if(t_pClient)
+    {
+        //The direct connections hand out the raw buffers in this (the main) thread, so none is in progress here.
+        //Once disconnected, no call reaches the client before its I/O thread deletes it.
+        disconnect(this, 0, t_pClient, 0);
+
+        t_pClient->deleteLater();
+    }
+
+    pruneProfiles();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStreamServer::setStreamProfile(qint32 ID, const StreamProfile::SPtr& p_pProfile)
+{
+    FiffStreamClient* t_pClient = m_qClientList.value(ID);
+    if(!t_pClient)
+        return false;
+
+    //Clients of a stream with equal keys share one profile, i.e. one filter state and one encoded tag per buffer
+    QString t_sProfileKey;
+    if(p_pProfile && !p_pProfile->isFullStream())
+    {
+        t_sProfileKey = p_pProfile->key();
+        qint32 t_iStreamId = t_pClient->streamId();
+
+        QMutexLocker t_locker(&m_qMutexProfiles);
+        if(!m_qMapProfiles[t_iStreamId].contains(t_sProfileKey))
+            m_qMapProfiles[t_iStreamId].insert(t_sProfileKey, p_pProfile);
+    }
+
+    t_pClient->setProfileKey(t_sProfileKey);
+
+    pruneProfiles();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+int FiffStreamServer::profileCount()
+{
+    QMutexLocker t_locker(&m_qMutexProfiles);
+
+    int t_iCount = 0;
+    QMap<qint32, QMap<QString, StreamProfile::SPtr> >::const_iterator i;
+    for(i = m_qMapProfiles.constBegin(); i != m_qMapProfiles.constEnd(); ++i)
+        t_iCount += i.value().size();
+
+    return t_iCount;
+}
+
+
+//*************************************************************************************************************
+
+void FiffStreamServer::pruneProfiles()
+{
+    QMap<qint32, QSet<QString> > t_qMapUsedKeys;
+    QMap<qint32, FiffStreamClient*>::const_iterator i;
+    for(i = m_qClientList.constBegin(); i != m_qClientList.constEnd(); ++i)
+        t_qMapUsedKeys[i.value()->streamId()].insert(i.value()->profileKey());
+
+    QMutexLocker t_locker(&m_qMutexProfiles);
+
+    QMap<qint32, QMap<QString, StreamProfile::SPtr> >::iterator j = m_qMapProfiles.begin();
+    while(j != m_qMapProfiles.end())
+    {
+        const QSet<QString> t_qSetUsedKeys = t_qMapUsedKeys.value(j.key());
+
+        QMap<QString, StreamProfile::SPtr>::iterator k = j.value().begin();
+        while(k != j.value().end())
+        {
+            if(t_qSetUsedKeys.contains(k.key()))
+                ++k;
+            else
+                k = j.value().erase(k);
+        }
+
+        if(j.value().isEmpty())
+            j = m_qMapProfiles.erase(j);
+        else
+            ++j;
+    }
+
+    m_qSetFullStreams.clear();
+    QMap<qint32, QSet<QString> >::const_iterator t_it;
+    for(t_it = t_qMapUsedKeys.constBegin(); t_it != t_qMapUsedKeys.constEnd(); ++t_it)
+        if(t_it.value().contains(QString()))
+            m_qSetFullStreams.insert(t_it.key());
 }
 
 
@@ -384,14 +878,31 @@ void FiffStreamServer::forwardRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRa
 
 void FiffStreamServer::incomingConnection(qintptr socketDescriptor)
 {
-    FiffStreamThread* t_pStreamThread = new FiffStreamThread(m_iNextClientId, socketDescriptor, this);
+    FiffStreamClient* t_pClient = new FiffStreamClient(m_iNextClientId, socketDescriptor);
+    t_pClient->setSendPolicy(m_defaultSendPolicy, m_iDefaultQueueLimit);
+    t_pClient->setStreamId(m_iPrimaryStreamId);
+    t_pClient->moveToThread(m_ioThreadPool.nextThread());
 
-    m_qClientList.insert(m_iNextClientId, t_pStreamThread);
+    m_qClientList.insert(m_iNextClientId, t_pClient);
     ++m_iNextClientId;
 
-    //when thread has finished it gets deleted
-    connect(t_pStreamThread, SIGNAL(finished()), t_pStreamThread, SLOT(deleteLater()));
-    connect(this, SIGNAL(closeFiffStreamServer()), t_pStreamThread, SLOT(deleteLater()));
-
-    t_pStreamThread->start();
+    //New clients receive the full primary stream
+    m_qMutexProfiles.lock();
+    m_qSetFullStreams.insert(m_iPrimaryStreamId);
+    m_qMutexProfiles.unlock();
+
+    //when the client disconnected it gets deleted
+    connect(t_pClient, &FiffStreamClient::disconnected, this, &FiffStreamServer::removeClient);
+
+    //Enqueueing is thread safe, the client schedules the socket write in its own thread
+    connect(this, &FiffStreamServer::remitMeasInfo,
+            t_pClient, &FiffStreamClient::sendMeasurementInfo, Qt::DirectConnection);
+    connect(this, &FiffStreamServer::remitRawBuffers,
+            t_pClient, &FiffStreamClient::sendRawBuffers, Qt::DirectConnection);
+    connect(this, &FiffStreamServer::startMeasFiffStreamClient,
+            t_pClient, &FiffStreamClient::startMeas, Qt::DirectConnection);
+    connect(this, &FiffStreamServer::stopMeasFiffStreamClient,
+            t_pClient, &FiffStreamClient::stopMeas, Qt::DirectConnection);
+
+    QMetaObject::invokeMethod(t_pClient, "open", Qt::QueuedConnection);
 }
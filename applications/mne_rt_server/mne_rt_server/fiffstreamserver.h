@@ -41,6 +41,9 @@
 // MNE INCLUDES
 //=============================================================================================================
 
+#include "iothreadpool.h"
+#include "streamprofile.h"
+
 #include <fiff/fiff_info.h>
 #include <realtime/rtCommand/commandmanager.h>
 
@@ -50,6 +53,11 @@
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
 #include <QStringList>
 #include <QTcpServer>
 
@@ -76,20 +84,19 @@ using namespace REALTIMELIB;
 // FORWARD DECLARATIONS
 //=============================================================================================================
 
-class FiffStreamThread;
+class FiffStreamClient;
 
 //=============================================================================================================
 /**
 * DECLARE CLASS FiffStreamServer
 *
-* @brief The FiffStreamServer class provides
+* @brief The FiffStreamServer class provides the fiff data connections. The client sockets are serviced by a few
+* I/O threads instead of one thread per client.
 */
 class FiffStreamServer : public QTcpServer//, public ICommandParser //OLD remove this
 {
     Q_OBJECT
 
-    friend class FiffStreamThread;
-
 public:
 
     FiffStreamServer(QObject *parent = 0);
@@ -104,7 +111,15 @@ public:
     /**
     * ToDo...
     */
-    inline FiffStreamThread* getClient(qint32 id);
+    inline FiffStreamClient* getClient(qint32 id);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of connected fiff data clients.
+    *
+    * @return the number of clients.
+    */
+    inline qint32 clientCount() const;
 
     //=========================================================================================================
     /**
@@ -123,8 +138,133 @@ public:
 
 //public slots: --> in Qt 5 not anymore declared as slot
     void forwardMeasInfo(qint32 ID, const FiffInfo& p_fiffInfo);
+
+    //=========================================================================================================
+    /**
+    * Forwards a raw buffer of the primary stream, see forwardStreamBuffer.
+    *
+    * @param[in] m_pMatRawData  The raw buffer to forward.
+    */
     void forwardRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData);
 
+    //=========================================================================================================
+    /**
+    * Serializes the raw buffer of a measurement stream once to a FIFF_DATA_BUFFER tag and once per stream profile
+    * in use on this stream, and hands the encoded tags to the clients which subscribed to the stream. The tags
+    * are implicitly shared, the clients enqueue them without copying the data.
+    *
+    * @param[in] p_iStreamId    The measurement stream, the connector id or the merged stream.
+    * @param[in] p_pMatRawData  The raw buffer to forward.
+    */
+    void forwardStreamBuffer(qint32 p_iStreamId, QSharedPointer<Eigen::MatrixXf> p_pMatRawData);
+
+    //=========================================================================================================
+    /**
+    * Sets the measurement streams clients can subscribe to. Clients of a stream which is not available anymore
+    * fall back to the full primary stream.
+    *
+    * @param[in] p_qListStreamIds   The stream ids.
+    */
+    void setAvailableStreams(const QList<qint32>& p_qListStreamIds);
+
+    //=========================================================================================================
+    /**
+    * Sets the primary stream, the stream of new clients and of forwardRawBuffer. The clients of the previous
+    * primary stream follow it and fall back to the full stream, profiles refer to the channels of a stream.
+    *
+    * @param[in] p_iStreamId    The stream id.
+    */
+    void setPrimaryStream(qint32 p_iStreamId);
+
+    //=========================================================================================================
+    /**
+    * Returns the primary stream.
+    *
+    * @return the stream id.
+    */
+    inline qint32 primaryStream() const;
+
+    //=========================================================================================================
+    /**
+    * Subscribes a client to a measurement stream. The client receives the full stream, the measurement info
+    * should be requested again.
+    *
+    * @param[in] ID             The client id.
+    * @param[in] p_iStreamId    The stream id.
+    *
+    * @return true if the client exists.
+    */
+    bool subscribe(qint32 ID, qint32 p_iStreamId);
+
+    //=========================================================================================================
+    /**
+    * Returns the stream a client subscribed to.
+    *
+    * @param[in] ID             The client id.
+    * @param[out] p_iStreamId   The stream id.
+    *
+    * @return true if the client exists.
+    */
+    bool getClientStream(qint32 ID, qint32& p_iStreamId);
+
+    //=========================================================================================================
+    /**
+    * Sets the number of channels of a stream, profiles are checked against it.
+    *
+    * @param[in] p_iStreamId    The stream id.
+    * @param[in] p_iChannels    The number of channels of the measurement info.
+    */
+    void setStreamChannels(qint32 p_iStreamId, qint32 p_iChannels);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of channels of a stream, known once a measurement info of the stream arrived.
+    *
+    * @param[in] p_iStreamId    The stream id.
+    *
+    * @return the number of channels, -1 if unknown.
+    */
+    qint32 streamChannels(qint32 p_iStreamId) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of clients which subscribed to a stream.
+    *
+    * @param[in] p_iStreamId    The stream id.
+    *
+    * @return the number of subscribers.
+    */
+    int subscriberCount(qint32 p_iStreamId);
+
+    //=========================================================================================================
+    /**
+    * Removes a disconnected client and deletes it in its I/O thread.
+    *
+    * @param[in] ID     The client id.
+    */
+    void removeClient(qint32 ID);
+
+    //=========================================================================================================
+    /**
+    * Selects the stream profile of a client. If another client of the same stream already uses a profile with the
+    * same key, that profile is shared. The measurement info should be requested again after the profile changed.
+    *
+    * @param[in] ID             The client id.
+    * @param[in] p_pProfile     The stream profile, a null pointer selects the full stream.
+    *
+    * @return true if the client exists.
+    */
+    bool setStreamProfile(qint32 ID, const StreamProfile::SPtr& p_pProfile);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of distinct stream profiles in use on all streams, i.e. the number of encodings per raw
+    * buffer besides the full streams.
+    *
+    * @return the number of stream profiles.
+    */
+    int profileCount();
+
 signals:
     void requestMeasInfo(qint32 ID);
 
@@ -132,7 +272,7 @@ signals:
     void stopMeasFiffStreamClient(qint32 ID);
 
     void remitMeasInfo(qint32 ID, const FIFFLIB::FiffInfo& p_fiffInfo);
-    void remitRawBuffer(QSharedPointer<Eigen::MatrixXf>);
+    void remitRawBuffers(qint32 p_iStreamId, const QHash<QString, QByteArray>& p_hashEncodedTags);
 
     void closeFiffStreamServer();
 
@@ -181,11 +321,63 @@ private:
     */
     void comStopAll(Command p_command);
 
+    //=========================================================================================================
+    /**
+    * Sets the send policy and the queue limit of a client, or of all clients and new ones with id -1.
+    *
+    * @param[in] p_command  The send policy command.
+    */
+    void comSendpolicy(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Switches a local client to a shared memory ring, or back to TCP with size 0. A JSON request is answered
+    * with the key of the ring.
+    *
+    * @param[in] p_command  The shared memory command.
+    */
+    void comShmem(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Sets the stream profile of a client: channel subset, decimation, sample format and compression.
+    *
+    * @param[in] p_command  The profile command.
+    */
+    void comProfile(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Subscribes a client to a measurement stream.
+    *
+    * @param[in] p_command  The subscribe command.
+    */
+    void comSubscribe(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Removes the stream profiles which no client uses anymore.
+    */
+    void pruneProfiles();
+
     QByteArray parseToId(QString& p_sRawId, qint32& p_iParsedId);
 
-    QMap<qint32, FiffStreamThread*> m_qClientList;
+    QMap<qint32, FiffStreamClient*> m_qClientList;
     qint32                          m_iNextClientId;
 
+    FiffStreamClient::SendPolicy    m_defaultSendPolicy;    /**< The send policy of new clients. */
+    int                             m_iDefaultQueueLimit;   /**< The queue limit of new clients. */
+
+    QMutex                                          m_qMutexProfiles;   /**< Guards the profiles, they are encoded in the acquisition thread. */
+    QMap<qint32, QMap<QString, StreamProfile::SPtr> > m_qMapProfiles;     /**< The stream profiles in use by stream and key. */
+    QSet<qint32>                                    m_qSetFullStreams;  /**< The streams with clients of the full stream. */
+
+    qint32                          m_iPrimaryStreamId;     /**< The stream of new clients. */
+    QList<qint32>                   m_qListStreamIds;       /**< The streams clients can subscribe to. */
+    QMap<qint32, qint32>            m_qMapStreamChannels;   /**< The number of channels of each stream with a known measurement info. */
+
+    IoThreadPool                    m_ioThreadPool;     /**< The threads which service the client sockets. */
+
 };
 
 
@@ -194,11 +386,27 @@ private:
 // INLINE DEFINITIONS
 //=============================================================================================================
 
-FiffStreamThread* FiffStreamServer::getClient(qint32 id)
+FiffStreamClient* FiffStreamServer::getClient(qint32 id)
 {
     return m_qClientList[id];
 }
 
+
+//*************************************************************************************************************
+
+qint32 FiffStreamServer::clientCount() const
+{
+    return m_qClientList.size();
+}
+
+
+//*************************************************************************************************************
+
+qint32 FiffStreamServer::primaryStream() const
+{
+    return m_iPrimaryStreamId;
+}
+
 } // NAMESPACE
 
 #endif //FIFFSTREAMSERVER_H
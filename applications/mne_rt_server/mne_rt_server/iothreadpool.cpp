@@ -1,14 +1,14 @@
 //=============================================================================================================
 /**
-* @file     fiffstreamthread.h
+* @file     iothreadpool.cpp
 * @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
 *           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
 * @version  1.0
-* @date     July, 2012
+* @date     October, 2026
 *
 * @section  LICENSE
 *
-* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
 *
 * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
 * the following conditions are met:
@@ -29,117 +29,71 @@
 * POSSIBILITY OF SUCH DAMAGE.
 *
 *
-* @brief     implementation of the FiffStreamThread Class.
+* @brief    Definition of the IoThreadPool class.
 *
 */
 
-#ifndef FIFFSTREAMTHREAD_H
-#define FIFFSTREAMTHREAD_H
-
 //*************************************************************************************************************
 //=============================================================================================================
 // INCLUDES
 //=============================================================================================================
 
-#include <fiff/fiff_stream.h>
-#include <fiff/fiff_info.h>
+#include "iothreadpool.h"
 
 
 //*************************************************************************************************************
 //=============================================================================================================
-// QT INCLUDES
+// USED NAMESPACES
 //=============================================================================================================
 
-#include <QThread>
-#include <QTcpSocket>
-#include <QMutex>
-#include <QSharedPointer>
+using namespace RTSERVER;
 
 
 //*************************************************************************************************************
 //=============================================================================================================
-// DEFINE NAMESPACE RTSERVER
+// DEFINE MEMBER METHODS
 //=============================================================================================================
 
-namespace RTSERVER
+IoThreadPool::IoThreadPool(int p_iNumThreads, const QString& p_sName)
+: m_iNext(0)
 {
-
-//*************************************************************************************************************
-//=============================================================================================================
-// USED NAMESPACES
-//=============================================================================================================
-
-using namespace FIFFLIB;
+    for(int i = 0; i < qMax(p_iNumThreads, 1); ++i)
+    {
+        QThread* t_pThread = new QThread;
+        t_pThread->setObjectName(QString("%1 %2").arg(p_sName).arg(i));
+        t_pThread->start();
+        m_vecThreads.append(t_pThread);
+    }
+}
 
 
 //*************************************************************************************************************
-//=============================================================================================================
-// FORWARD DECLARATIONS
-//=============================================================================================================
 
-class FiffStreamThread : public QThread
+IoThreadPool::~IoThreadPool()
 {
-    Q_OBJECT
-public:
-    FiffStreamThread(qint32 id, int socketDescriptor, QObject *parent);
-
-    ~FiffStreamThread();
-
-    void run();
-
-    inline qint32 getID();
-
-    inline QString getAlias();
-
-//    void deactivateRawBufferSending();
-
-
-    void parseCommand(QSharedPointer<FiffTag> p_pTag);
-
-    void writeClientId();
-
-//    void sendData(QTcpSocket& p_qTcpSocket);
-
-signals:
-    void error(QTcpSocket::SocketError socketError);
-
-private:
-    qint32 m_iDataClientId;
-    QString m_sDataClientAlias;
-
-    int m_iSocketDescriptor;
-
-    QMutex m_qMutex;
-    QByteArray m_qSendBlock;
-
-    bool m_bIsSendingRawBuffer;
-
-    bool m_bIsRunning;
-
-    void startMeas(qint32 ID);
-
-    void stopMeas(qint32 ID);
-
-    void sendMeasurementInfo(qint32 ID, const FiffInfo& p_fiffInfo);
+    for(int i = 0; i < m_vecThreads.size(); ++i)
+    {
+        m_vecThreads[i]->quit();
+        m_vecThreads[i]->wait();
+        delete m_vecThreads[i];
+    }
+}
 
-    void sendRawBuffer(QSharedPointer<Eigen::MatrixXf> m_pMatRawData);
-    //void readToBuffer1();
-//    void readProc(QTcpSocket& p_qTcpSocket);
-};
 
+//*************************************************************************************************************
 
-inline qint32 FiffStreamThread::getID()
+QThread* IoThreadPool::nextThread()
 {
-    return m_iDataClientId;
-}
-
+    QThread* t_pThread = m_vecThreads[m_iNext];
+    m_iNext = (m_iNext + 1) % m_vecThreads.size();
 
-inline QString FiffStreamThread::getAlias()
-{
-    return m_sDataClientAlias;
+    return t_pThread;
 }
 
 
-} // NAMESPACE
+//*************************************************************************************************************
 
-#endif //FIFFSTREAMTHREAD_H
+int IoThreadPool::defaultThreadCount()
+{
+    return qBound(1, QThread::idealThreadCount() / 2, 4);
+}
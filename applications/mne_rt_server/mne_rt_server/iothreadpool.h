@@ -0,0 +1,124 @@
+//=============================================================================================================
+/**
+* @file     iothreadpool.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the IoThreadPool class.
+*
+*/
+
+#ifndef IOTHREADPOOL_H
+#define IOTHREADPOOL_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QThread>
+#include <QVector>
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVER
+//=============================================================================================================
+
+namespace RTSERVER
+{
+
+//=============================================================================================================
+/**
+* A fixed set of event loop threads which service the sockets of many clients. Each client object is moved to
+* one of the threads, its socket is then driven by readyRead and bytesWritten instead of a polling loop.
+*
+* @brief IoThreadPool provides event loop threads for non blocking client sockets
+*/
+class IoThreadPool
+{
+public:
+    //=========================================================================================================
+    /**
+    * Starts the I/O threads.
+    *
+    * @param[in] p_iNumThreads  Number of threads, at least one thread is started.
+    * @param[in] p_sName        Name prefix of the threads, shown by debuggers and profilers.
+    */
+    IoThreadPool(int p_iNumThreads, const QString& p_sName);
+
+    //=========================================================================================================
+    /**
+    * Stops all threads. Objects which were scheduled for deletion in a thread are deleted before it finishes.
+    */
+    ~IoThreadPool();
+
+    //=========================================================================================================
+    /**
+    * Returns the thread the next client should be moved to. Clients are distributed round robin.
+    *
+    * @return the next I/O thread.
+    */
+    QThread* nextThread();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of I/O threads.
+    *
+    * @return the number of threads.
+    */
+    inline int size() const;
+
+    //=========================================================================================================
+    /**
+    * Returns a reasonable number of I/O threads for this machine, i.e. half of the cores but at most four.
+    *
+    * @return the default number of threads.
+    */
+    static int defaultThreadCount();
+
+private:
+    QVector<QThread*>   m_vecThreads;   /**< The event loop threads. */
+    int                 m_iNext;        /**< Index of the thread which gets the next client. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int IoThreadPool::size() const
+{
+    return m_vecThreads.size();
+}
+
+} // NAMESPACE
+
+#endif // IOTHREADPOOL_H
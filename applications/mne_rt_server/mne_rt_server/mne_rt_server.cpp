@@ -316,6 +316,15 @@ void MNERTServer::init()
     QString t_sJsonCommand =
             "{"
             "   \"commands\": {"
+            "       \"addcon\": {"
+            "           \"description\": \"Activates a connector which acquires concurrently to the selected one, in its own measurement stream.\","
+            "           \"parameters\": {"
+            "               \"ConID\": {"
+            "                   \"description\": \"Connector ID\","
+            "                   \"type\": \"int\" "
+            "               }"
+            "           }"
+            "        },"
             "       \"clist\": {"
             "           \"description\": \"Prints and sends all available FiffStreamClients.\","
             "           \"parameters\": {}"
@@ -341,6 +350,53 @@ void MNERTServer::init()
             "               }"
             "           }"
             "       },"
+            "       \"merge\": {"
+            "           \"description\": \"Merges the streams of concurrently acquiring connectors into stream 0, aligned and resampled on the server clock. The first connector is the reference, none stops merging.\","
+            "           \"parameters\": {"
+            "               \"sfreq\": {"
+            "                   \"description\": \"Sampling frequency of the merged stream, 0 uses the reference\","
+            "                   \"type\": \"double\" "
+            "               },"
+            "               \"streams\": {"
+            "                   \"description\": \"Connector IDs like 1,3, or none\","
+            "                   \"type\": \"QString\" "
+            "               }"
+            "           }"
+            "        },"
+            "       \"profile\": {"
+            "           \"description\": \"Sets the stream profile of a FiffStreamClient on a slow link, request the measurement info afterwards. Clients with the same profile share the encoded buffers.\","
+            "           \"parameters\": {"
+            "               \"channels\": {"
+            "                   \"description\": \"Channel indices and ranges like 0-9,20, or all\","
+            "                   \"type\": \"QString\" "
+            "               },"
+            "               \"compress\": {"
+            "                   \"description\": \"none or zlib\","
+            "                   \"type\": \"QString\" "
+            "               },"
+            "               \"decim\": {"
+            "                   \"description\": \"Decimation factor, 1 keeps the sampling frequency\","
+            "                   \"type\": \"int\" "
+            "               },"
+            "               \"format\": {"
+            "                   \"description\": \"float or int16\","
+            "                   \"type\": \"QString\" "
+            "               },"
+            "               \"id\": {"
+            "                   \"description\": \"ID/Alias\","
+            "                   \"type\": \"QString\" "
+            "               }"
+            "           }"
+            "        },"
+            "       \"remcon\": {"
+            "           \"description\": \"Stops and deactivates a concurrently acquiring connector.\","
+            "           \"parameters\": {"
+            "               \"ConID\": {"
+            "                   \"description\": \"Connector ID\","
+            "                   \"type\": \"int\" "
+            "               }"
+            "           }"
+            "        },"
             "       \"selcon\": {"
             "           \"description\": \"Selects a new connector, if a measurement is running it will be stopped.\","
             "           \"parameters\": {"
@@ -350,6 +406,36 @@ void MNERTServer::init()
             "               }"
             "           }"
             "        },"
+            "       \"sendpolicy\": {"
+            "           \"description\": \"Sets what happens to raw buffers when the send queue of a FiffStreamClient is full (drop, decimate, disconnect). ID -1 applies to all clients and new ones.\","
+            "           \"parameters\": {"
+            "               \"id\": {"
+            "                   \"description\": \"ID/Alias\","
+            "                   \"type\": \"QString\" "
+            "               },"
+            "               \"policy\": {"
+            "                   \"description\": \"drop, decimate or disconnect\","
+            "                   \"type\": \"QString\" "
+            "               },"
+            "               \"queue\": {"
+            "                   \"description\": \"Maximal number of queued raw buffers\","
+            "                   \"type\": \"int\" "
+            "               }"
+            "           }"
+            "        },"
+            "       \"shmem\": {"
+            "           \"description\": \"Sends the raw buffers of a FiffStreamClient on the same host through a shared memory ring. Size 0 returns to TCP.\","
+            "           \"parameters\": {"
+            "               \"id\": {"
+            "                   \"description\": \"ID/Alias\","
+            "                   \"type\": \"QString\" "
+            "               },"
+            "               \"size\": {"
+            "                   \"description\": \"Bytes of the ring\","
+            "                   \"type\": \"int\" "
+            "               }"
+            "           }"
+            "        },"
             "       \"start\": {"
             "           \"description\": \"Adds specified FiffStreamClient to raw data buffer receivers. If acquisition is not already started, it is triggered.\","
             "           \"parameters\": {"
@@ -371,6 +457,23 @@ void MNERTServer::init()
             "       \"stop-all\": {"
             "           \"description\": \"Stops the whole acquisition process.\","
             "           \"parameters\": {}"
+            "        },"
+            "       \"streams\": {"
+            "           \"description\": \"Prints and sends the measurement streams and their subscribers.\","
+            "           \"parameters\": {}"
+            "        },"
+            "       \"subscribe\": {"
+            "           \"description\": \"Subscribes a FiffStreamClient to the stream of a connector, or to the merged stream 0. Request the measurement info afterwards.\","
+            "           \"parameters\": {"
+            "               \"id\": {"
+            "                   \"description\": \"ID/Alias\","
+            "                   \"type\": \"QString\" "
+            "               },"
+            "               \"stream\": {"
+            "                   \"description\": \"Stream ID\","
+            "                   \"type\": \"int\" "
+            "               }"
+            "           }"
             "        }"
             "    }"
             "}";
@@ -76,9 +76,12 @@ SOURCES += \
     connectormanager.cpp \
     mne_rt_server.cpp \
     fiffstreamserver.cpp \
-    fiffstreamthread.cpp \
+    fiffstreamclient.cpp \
     commandserver.cpp \
-    commandthread.cpp
+    commandclient.cpp \
+    iothreadpool.cpp \
+    streamprofile.cpp \
+    streammerger.cpp
 
 
 HEADERS += \
@@ -87,9 +90,12 @@ HEADERS += \
     connectormanager.h \
     mne_rt_server.h \
     fiffstreamserver.h \
-    fiffstreamthread.h \
+    fiffstreamclient.h \
     commandserver.h \
-    commandthread.h \
+    commandclient.h \
+    iothreadpool.h \
+    streamprofile.h \
+    streammerger.h \
     mne_rt_commands.h
 
 INCLUDEPATH += $${EIGEN_INCLUDE_DIR}
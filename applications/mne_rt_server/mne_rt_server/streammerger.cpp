@@ -0,0 +1,396 @@
+//=============================================================================================================
+/**
+* @file     streammerger.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the StreamMerger class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "streammerger.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QStringList>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVER;
+using namespace FIFFLIB;
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+namespace
+{
+    const double maxLagS = 1.0;         /**< A stream further behind the reference is left out. */
+    const double maxHistoryS = 10.0;    /**< The history of a stream is bounded if the reference stalls. */
+    const double driftWeight = 0.01;    /**< Per buffer weight of a later arrival in the start time estimate. */
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+StreamMerger::StreamMerger(const QList<qint32>& p_qListStreamIds, double p_dSamplingFreq)
+: m_qListStreamIds(p_qListStreamIds)
+, m_dSamplingFreq(qMax(0.0, p_dSamplingFreq))
+, m_dMergedFreq(0.0)
+, m_iChannels(0)
+, m_dGridStartS(0.0)
+, m_iMergedSamples(0)
+, m_bGridStarted(false)
+{
+    m_timer.start();
+}
+
+
+//*************************************************************************************************************
+
+void StreamMerger::setMeasInfo(qint32 p_iStreamId, const FiffInfo& p_fiffInfo)
+{
+    if(!m_qListStreamIds.contains(p_iStreamId) || p_fiffInfo.nchan <= 0 || p_fiffInfo.sfreq <= 0)
+        return;
+
+    //The connectors resend their info with every request, only a changed stream restarts the merging
+    if(m_qMapInputs.contains(p_iStreamId) && m_qMapInputs[p_iStreamId].iChannels == p_fiffInfo.nchan
+            && m_qMapInputs[p_iStreamId].dSamplingFreq == p_fiffInfo.sfreq)
+        return;
+
+    m_qMapInfos.insert(p_iStreamId, p_fiffInfo);
+
+    m_qMapInputs.clear();
+    m_bGridStarted = false;
+    m_iMergedSamples = 0;
+    m_iChannels = 0;
+    m_dMergedFreq = 0.0;
+
+    if(!hasMeasInfo())
+        return;
+
+    for(int i = 0; i < m_qListStreamIds.size(); ++i)
+    {
+        const FiffInfo& t_fiffInfo = m_qMapInfos[m_qListStreamIds[i]];
+
+        Input t_input;
+        t_input.dSamplingFreq = t_fiffInfo.sfreq;
+        t_input.iChannels = t_fiffInfo.nchan;
+        t_input.iRowOffset = m_iChannels;
+        t_input.iFirstSample = 0;
+        t_input.iSamples = 0;
+        t_input.dStartS = 0.0;
+        t_input.bStarted = false;
+        m_qMapInputs.insert(m_qListStreamIds[i], t_input);
+
+        m_iChannels += t_fiffInfo.nchan;
+    }
+
+    //The merged grid follows the reference stream unless a frequency was requested
+    m_dMergedFreq = m_dSamplingFreq > 0.0 ? m_dSamplingFreq : m_qMapInputs[m_qListStreamIds.first()].dSamplingFreq;
+
+    //8th order Butterworth at 80% of the merged Nyquist frequency for the streams which are sampled faster
+    QMap<qint32, Input>::iterator t_it;
+    for(t_it = m_qMapInputs.begin(); t_it != m_qMapInputs.end(); ++t_it)
+        if(t_it->dSamplingFreq > m_dMergedFreq)
+            t_it->iirFilter.setSections(IIRFilter::designSOS(FilterData::Butterworth, FilterData::LPF, 8, 0.8 * m_dMergedFreq / t_it->dSamplingFreq, 0.0));
+}
+
+
+//*************************************************************************************************************
+
+bool StreamMerger::hasMeasInfo() const
+{
+    for(int i = 0; i < m_qListStreamIds.size(); ++i)
+        if(!m_qMapInfos.contains(m_qListStreamIds[i]))
+            return false;
+
+    return !m_qListStreamIds.isEmpty();
+}
+
+
+//*************************************************************************************************************
+
+FiffInfo StreamMerger::mergedInfo() const
+{
+    if(!hasMeasInfo())
+        return FiffInfo();
+
+    //The reference stream provides the measurement wide fields, the channels of the others are appended
+    FiffInfo t_fiffInfo = m_qMapInfos[m_qListStreamIds.first()];
+    t_fiffInfo.sfreq = m_dMergedFreq;
+
+    for(int i = 1; i < m_qListStreamIds.size(); ++i)
+    {
+        const FiffInfo& t_fiffInfoStream = m_qMapInfos[m_qListStreamIds[i]];
+
+        for(int k = 0; k < t_fiffInfoStream.chs.size(); ++k)
+        {
+            FiffChInfo t_chInfo = t_fiffInfoStream.chs[k];
+            QString t_sName = t_chInfo.ch_name;
+
+            //FIFF channel names have at most 15 characters
+            if(t_fiffInfo.ch_names.contains(t_chInfo.ch_name))
+                t_chInfo.ch_name = QString("%1-%2").arg(t_chInfo.ch_name.left(12)).arg(m_qListStreamIds[i]);
+
+            if(t_fiffInfoStream.bads.contains(t_sName))
+                t_fiffInfo.bads.append(t_chInfo.ch_name);
+
+            t_chInfo.scanNo = t_fiffInfo.chs.size() + 1;
+            t_fiffInfo.chs.append(t_chInfo);
+            t_fiffInfo.ch_names.append(t_chInfo.ch_name);
+        }
+
+        t_fiffInfo.lowpass = qMin(t_fiffInfo.lowpass, t_fiffInfoStream.lowpass);
+        t_fiffInfo.highpass = qMax(t_fiffInfo.highpass, t_fiffInfoStream.highpass);
+    }
+
+    t_fiffInfo.nchan = t_fiffInfo.chs.size();
+    t_fiffInfo.lowpass = qMin(t_fiffInfo.lowpass, (float)(m_dMergedFreq / 2.0));
+
+    QMap<qint32, Input>::const_iterator t_it;
+    for(t_it = m_qMapInputs.constBegin(); t_it != m_qMapInputs.constEnd(); ++t_it)
+        if(t_it->iirFilter.sectionCount() > 0)
+            t_fiffInfo.lowpass = qMin(t_fiffInfo.lowpass, (float)(0.4 * m_dMergedFreq));
+
+    return t_fiffInfo;
+}
+
+
+//*************************************************************************************************************
+
+double StreamMerger::samplingFrequency() const
+{
+    return m_dMergedFreq;
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<MatrixXf> StreamMerger::addBuffer(qint32 p_iStreamId, const MatrixXf& p_matData, qint64 p_iArrivalNs)
+{
+    QMap<qint32, Input>::iterator t_it = m_qMapInputs.find(p_iStreamId);
+    if(t_it == m_qMapInputs.end() || p_matData.rows() != t_it->iChannels || p_matData.cols() == 0)
+        return QSharedPointer<MatrixXf>();
+
+    Input& t_input = *t_it;
+    double t_dArrivalS = (p_iArrivalNs < 0 ? now() : p_iArrivalNs) / 1.0e9;
+
+    int t_iCols = (int)t_input.matHistory.cols();
+    t_input.matHistory.conservativeResize(t_input.iChannels, t_iCols + p_matData.cols());
+
+    if(t_input.iirFilter.sectionCount() > 0)
+    {
+        t_input.iirFilter.filter(p_matData.cast<double>(), m_matFiltered);
+        t_input.matHistory.rightCols(p_matData.cols()) = m_matFiltered.cast<float>();
+    }
+    else
+        t_input.matHistory.rightCols(p_matData.cols()) = p_matData;
+    t_input.iSamples += p_matData.cols();
+
+    //A buffer is complete when its last sample period ended, any later arrival is transport delay
+    double t_dStartS = t_dArrivalS - t_input.iSamples / t_input.dSamplingFreq;
+    if(!t_input.bStarted || t_dStartS < t_input.dStartS)
+        t_input.dStartS = t_dStartS;
+    else
+        t_input.dStartS += driftWeight * (t_dStartS - t_input.dStartS);
+    t_input.bStarted = true;
+
+    int t_iMaxHistory = (int)(maxHistoryS * t_input.dSamplingFreq);
+    if(t_input.matHistory.cols() > t_iMaxHistory)
+    {
+        int t_iDrop = (int)t_input.matHistory.cols() - t_iMaxHistory;
+        t_input.matHistory = t_input.matHistory.rightCols(t_iMaxHistory).eval();
+        t_input.iFirstSample += t_iDrop;
+    }
+
+    if(p_iStreamId != m_qListStreamIds.first())
+        return QSharedPointer<MatrixXf>();
+
+    return release();
+}
+
+
+//*************************************************************************************************************
+
+double StreamMerger::streamStartS(qint32 p_iStreamId) const
+{
+    QMap<qint32, Input>::const_iterator t_it = m_qMapInputs.constFind(p_iStreamId);
+    if(t_it == m_qMapInputs.constEnd() || !t_it->bStarted)
+        return 0.0;
+
+    return t_it->dStartS;
+}
+
+
+//*************************************************************************************************************
+
+bool StreamMerger::parseStreamIds(const QString& p_sStreamIds, QList<qint32>& p_qListStreamIds)
+{
+    p_qListStreamIds.clear();
+
+    QStringList t_qListIds = p_sStreamIds.split(",", QString::SkipEmptyParts);
+    for(int i = 0; i < t_qListIds.size(); ++i)
+    {
+        bool t_bIsInt;
+        qint32 t_iStreamId = t_qListIds[i].trimmed().toInt(&t_bIsInt);
+        if(!t_bIsInt || t_iStreamId <= MergedStreamId)
+            return false;
+
+        if(!p_qListStreamIds.contains(t_iStreamId))
+            p_qListStreamIds.append(t_iStreamId);
+    }
+
+    return p_qListStreamIds.size() >= 2;
+}
+
+
+//*************************************************************************************************************
+
+double StreamMerger::lastSampleS(const Input& p_input)
+{
+    return p_input.dStartS + (p_input.iSamples - 1) / p_input.dSamplingFreq;
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<MatrixXf> StreamMerger::release()
+{
+    const Input& t_reference = m_qMapInputs[m_qListStreamIds.first()];
+
+    //Streams which stall are left out, the others bound the released time
+    QList<qint32> t_qListLive;
+    double t_dCoveredS = lastSampleS(t_reference);
+    QMap<qint32, Input>::const_iterator t_it;
+    for(t_it = m_qMapInputs.constBegin(); t_it != m_qMapInputs.constEnd(); ++t_it)
+    {
+        if(t_it->bStarted && t_it->matHistory.cols() > 0 && lastSampleS(*t_it) >= lastSampleS(t_reference) - maxLagS)
+        {
+            t_qListLive.append(t_it.key());
+            t_dCoveredS = qMin(t_dCoveredS, lastSampleS(*t_it));
+        }
+    }
+
+    //The grid starts where all live streams have samples
+    if(!m_bGridStarted)
+    {
+        m_dGridStartS = 0.0;
+        for(int i = 0; i < t_qListLive.size(); ++i)
+        {
+            const Input& t_input = m_qMapInputs[t_qListLive[i]];
+            double t_dFirstS = t_input.dStartS + t_input.iFirstSample / t_input.dSamplingFreq;
+            m_dGridStartS = i == 0 ? t_dFirstS : qMax(m_dGridStartS, t_dFirstS);
+        }
+        m_iMergedSamples = 0;
+        m_bGridStarted = true;
+    }
+
+    qint64 t_iEnd = (qint64)std::floor((t_dCoveredS - m_dGridStartS) * m_dMergedFreq) + 1;
+    int t_iCount = (int)qMax<qint64>(0, t_iEnd - m_iMergedSamples);
+    if(t_iCount == 0)
+        return QSharedPointer<MatrixXf>();
+
+    QSharedPointer<MatrixXf> t_pMatMerged(new MatrixXf(MatrixXf::Zero(m_iChannels, t_iCount)));
+
+    for(int i = 0; i < t_qListLive.size(); ++i)
+    {
+        const Input& t_input = m_qMapInputs[t_qListLive[i]];
+        const int t_iCols = (int)t_input.matHistory.cols();
+
+        for(int j = 0; j < t_iCount; ++j)
+        {
+            double t_dTimeS = m_dGridStartS + (m_iMergedSamples + j) / m_dMergedFreq;
+            double t_dPos = (t_dTimeS - t_input.dStartS) * t_input.dSamplingFreq - t_input.iFirstSample;
+
+            //Rounding at the edges of the history is clamped, beyond it the channels stay zero
+            if(t_dPos < -1.0 || t_dPos > t_iCols)
+                continue;
+            t_dPos = qBound(0.0, t_dPos, (double)(t_iCols - 1));
+
+            int t_iLeft = qMin((int)t_dPos, t_iCols - 1);
+            int t_iRight = qMin(t_iLeft + 1, t_iCols - 1);
+            float t_fWeight = (float)(t_dPos - t_iLeft);
+
+            t_pMatMerged->block(t_input.iRowOffset, j, t_input.iChannels, 1) =
+                    (1.0f - t_fWeight) * t_input.matHistory.col(t_iLeft) + t_fWeight * t_input.matHistory.col(t_iRight);
+        }
+    }
+
+    m_iMergedSamples += t_iCount;
+
+    //Everything before the left neighbour of the next merged sample is done, the last sample is kept for the
+    //interpolation towards the next buffer
+    double t_dNextS = m_dGridStartS + m_iMergedSamples / m_dMergedFreq;
+    QMap<qint32, Input>::iterator t_itInput;
+    for(t_itInput = m_qMapInputs.begin(); t_itInput != m_qMapInputs.end(); ++t_itInput)
+    {
+        if(!t_itInput->bStarted)
+            continue;
+
+        const int t_iCols = (int)t_itInput->matHistory.cols();
+        double t_dPos = (t_dNextS - t_itInput->dStartS) * t_itInput->dSamplingFreq - t_itInput->iFirstSample;
+        int t_iDrop = (int)qBound(0.0, std::floor(t_dPos), (double)qMax(0, t_iCols - 1));
+
+        if(t_iDrop > 0)
+        {
+            t_itInput->matHistory = t_itInput->matHistory.rightCols(t_iCols - t_iDrop).eval();
+            t_itInput->iFirstSample += t_iDrop;
+        }
+    }
+
+    return t_pMatMerged;
+}
@@ -0,0 +1,263 @@
+//=============================================================================================================
+/**
+* @file     streammerger.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the StreamMerger class.
+*
+*/
+
+#ifndef STREAMMERGER_H
+#define STREAMMERGER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MNE INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_info.h>
+#include <utils/filterTools/iirfilter.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMap>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVER
+//=============================================================================================================
+
+namespace RTSERVER
+{
+
+//=============================================================================================================
+/**
+* Aligns the streams of concurrently running connectors, e.g. a MEG system and a separate EEG amplifier, on the
+* clock of the server and resamples them into one merged stream. Each stream has its own sample clock, the time
+* of its first sample is estimated from the arrival times of its buffers: the earliest arrival relative to the
+* samples received so far, i.e. the transport jitter only delays, slowly relaxed to follow the drift between the
+* clocks. The merged samples are linearly interpolated on a common grid, the channels of all streams are stacked.
+* The grid has the sampling frequency of the first stream unless another one is requested.
+*
+* The first stream is the reference, each of its buffers releases the merged samples all streams cover. A stream
+* which falls more than a second behind the reference is left out and its channels are zero until it catches up,
+* so one stalled device does not stall the merged stream. Streams sampled faster than the merged stream pass an
+* anti-aliasing low pass, an 8th order Butterworth at 80% of the merged Nyquist frequency, before they are
+* interpolated.
+*
+* @brief StreamMerger resamples the streams of several connectors into one stream
+*/
+class StreamMerger
+{
+public:
+    typedef QSharedPointer<StreamMerger> SPtr;            /**< Shared pointer type for StreamMerger. */
+    typedef QSharedPointer<const StreamMerger> ConstSPtr; /**< Const shared pointer type for StreamMerger. */
+
+    enum {
+        MergedStreamId = 0      /**< The stream id of the merged stream, connector streams use the connector id. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a StreamMerger.
+    *
+    * @param[in] p_qListStreamIds   The merged streams, the first one is the reference.
+    * @param[in] p_dSamplingFreq    The merged sampling frequency, 0 selects the frequency of the reference.
+    */
+    explicit StreamMerger(const QList<qint32>& p_qListStreamIds, double p_dSamplingFreq = 0.0);
+
+    //=========================================================================================================
+    /**
+    * Returns the merged streams.
+    *
+    * @return the stream ids, the first one is the reference.
+    */
+    inline const QList<qint32>& streamIds() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the measurement info of a stream, which provides its channels and sampling frequency. Buffers of a
+    * stream without measurement info are ignored.
+    *
+    * @param[in] p_iStreamId    The stream id.
+    * @param[in] p_fiffInfo     The measurement info of the stream.
+    */
+    void setMeasInfo(qint32 p_iStreamId, const FIFFLIB::FiffInfo& p_fiffInfo);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the measurement infos of all streams are known.
+    *
+    * @return true if the merged measurement info is available.
+    */
+    bool hasMeasInfo() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the measurement info of the merged stream: the channels of all streams in stream order, duplicate
+    * channel names get the stream id as suffix.
+    *
+    * @return the merged measurement info, empty if hasMeasInfo() is false.
+    */
+    FIFFLIB::FiffInfo mergedInfo() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the merged sampling frequency.
+    *
+    * @return the sampling frequency, 0 until the measurement infos are known.
+    */
+    double samplingFrequency() const;
+
+    //=========================================================================================================
+    /**
+    * Adds a raw buffer of a stream. A buffer of the reference stream releases the merged samples.
+    *
+    * @param[in] p_iStreamId    The stream id.
+    * @param[in] p_matData      The raw buffer.
+    * @param[in] p_iArrivalNs   The arrival time on the clock of the merger, -1 for now.
+    *
+    * @return the merged buffer, a null pointer if no merged samples were released.
+    */
+    QSharedPointer<Eigen::MatrixXf> addBuffer(qint32 p_iStreamId, const Eigen::MatrixXf& p_matData, qint64 p_iArrivalNs = -1);
+
+    //=========================================================================================================
+    /**
+    * Returns the clock of the merger.
+    *
+    * @return the nanoseconds since the merger was constructed.
+    */
+    inline qint64 now() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the estimated time of the first sample of a stream, which reveals the offset between the clocks.
+    *
+    * @param[in] p_iStreamId    The stream id.
+    *
+    * @return the time in seconds on the clock of the merger, 0 if the stream received no buffer yet.
+    */
+    double streamStartS(qint32 p_iStreamId) const;
+
+    //=========================================================================================================
+    /**
+    * Parses a list of stream ids like "1,3".
+    *
+    * @param[in] p_sStreamIds       The stream ids.
+    * @param[out] p_qListStreamIds  The parsed stream ids.
+    *
+    * @return true if at least two distinct connector stream ids were parsed.
+    */
+    static bool parseStreamIds(const QString& p_sStreamIds, QList<qint32>& p_qListStreamIds);
+
+private:
+    /**
+    * A merged stream.
+    */
+    struct Input {
+        double          dSamplingFreq;  /**< Sampling frequency of the stream. */
+        int             iChannels;      /**< Number of channels. */
+        int             iRowOffset;     /**< First row of the stream in the merged buffers. */
+        Eigen::MatrixXf matHistory;     /**< Samples which are not merged yet, and the one before. */
+        UTILSLIB::IIRFilter iirFilter;  /**< The anti-aliasing low pass, without sections if it is not needed. */
+        qint64          iFirstSample;   /**< Index of the first column of the history. */
+        qint64          iSamples;       /**< Number of samples received. */
+        double          dStartS;        /**< Estimated time of sample 0. */
+        bool            bStarted;       /**< Whether a buffer was received. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Returns the time of the last received sample of a stream.
+    *
+    * @param[in] p_input    The stream.
+    *
+    * @return the time in seconds.
+    */
+    static double lastSampleS(const Input& p_input);
+
+    //=========================================================================================================
+    /**
+    * Interpolates the merged samples up to the time all live streams cover.
+    *
+    * @return the merged buffer, a null pointer if there are no new samples.
+    */
+    QSharedPointer<Eigen::MatrixXf> release();
+
+    QList<qint32>                   m_qListStreamIds;   /**< The merged streams, the first one is the reference. */
+    QMap<qint32, FIFFLIB::FiffInfo> m_qMapInfos;        /**< The measurement infos by stream. */
+    QMap<qint32, Input>             m_qMapInputs;       /**< The stream states by stream, valid once all infos are known. */
+    double                          m_dSamplingFreq;    /**< The requested merged sampling frequency, 0 for the frequency of the reference. */
+    double                          m_dMergedFreq;      /**< The merged sampling frequency in use. */
+    int                             m_iChannels;        /**< Number of merged channels. */
+    double                          m_dGridStartS;      /**< Time of the first merged sample. */
+    qint64                          m_iMergedSamples;   /**< Number of released merged samples. */
+    bool                            m_bGridStarted;     /**< Whether the merged grid started. */
+    Eigen::MatrixXd                 m_matFiltered;      /**< The low pass filtered channels of the current buffer. */
+    QElapsedTimer                   m_timer;            /**< The clock of the arrival times. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline const QList<qint32>& StreamMerger::streamIds() const
+{
+    return m_qListStreamIds;
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 StreamMerger::now() const
+{
+    return m_timer.nsecsElapsed();
+}
+
+} // NAMESPACE
+
+#endif // STREAMMERGER_H
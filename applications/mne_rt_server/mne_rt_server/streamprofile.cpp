@@ -0,0 +1,251 @@
+//=============================================================================================================
+/**
+* @file     streamprofile.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the StreamProfile class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "streamprofile.h"
+
+#include <fiff/fiff_file.h>
+#include <fiff/fiff_stream.h>
+#include <realtime/rtClient/rawbuffercodec.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QStringList>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVER;
+using namespace FIFFLIB;
+using namespace REALTIMELIB;
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+StreamProfile::StreamProfile(const QList<int>& p_qListChannels, int p_iDecimation, bool p_bInt16, bool p_bCompress)
+: m_qListChannels(p_qListChannels)
+, m_iDecimation(qMax(1, p_iDecimation))
+, m_bInt16(p_bInt16)
+, m_bCompress(p_bCompress)
+, m_iPhase(0)
+{
+    std::sort(m_qListChannels.begin(), m_qListChannels.end());
+    m_qListChannels.erase(std::unique(m_qListChannels.begin(), m_qListChannels.end()), m_qListChannels.end());
+
+    //8th order Butterworth at 80% of the decimated Nyquist frequency
+    if(m_iDecimation > 1)
+        m_iirFilter.setSections(IIRFilter::designSOS(FilterData::Butterworth, FilterData::LPF, 8, 0.8 / m_iDecimation, 0.0));
+}
+
+
+//*************************************************************************************************************
+
+QString StreamProfile::key() const
+{
+    //Consecutive channels are written as ranges
+    QStringList t_qListRanges;
+    for(int i = 0; i < m_qListChannels.size(); )
+    {
+        int j = i;
+        while(j + 1 < m_qListChannels.size() && m_qListChannels[j + 1] == m_qListChannels[j] + 1)
+            ++j;
+
+        t_qListRanges << (i == j ? QString::number(m_qListChannels[i])
+                                 : QString("%1-%2").arg(m_qListChannels[i]).arg(m_qListChannels[j]));
+        i = j + 1;
+    }
+
+    return QString("ch=%1;decim=%2;%3;%4").arg(m_qListChannels.isEmpty() ? QString("all") : t_qListRanges.join(","))
+            .arg(m_iDecimation).arg(m_bInt16 ? "int16" : "float").arg(m_bCompress ? "zlib" : "none");
+}
+
+
+//*************************************************************************************************************
+
+bool StreamProfile::isFullStream() const
+{
+    return m_qListChannels.isEmpty() && m_iDecimation == 1 && !m_bInt16 && !m_bCompress;
+}
+
+
+//*************************************************************************************************************
+
+FiffInfo StreamProfile::applyTo(const FiffInfo& p_fiffInfo) const
+{
+    RowVectorXi t_vecSel;
+    if(!m_qListChannels.isEmpty())
+    {
+        QList<int> t_qListValid;
+        for(int i = 0; i < m_qListChannels.size() && m_qListChannels[i] < p_fiffInfo.nchan; ++i)
+            t_qListValid.append(m_qListChannels[i]);
+
+        t_vecSel.resize(t_qListValid.size());
+        for(int i = 0; i < t_qListValid.size(); ++i)
+            t_vecSel[i] = t_qListValid[i];
+    }
+
+    FiffInfo t_fiffInfo = p_fiffInfo.pick_info(t_vecSel);
+
+    if(m_iDecimation > 1)
+    {
+        t_fiffInfo.sfreq = p_fiffInfo.sfreq / m_iDecimation;
+        t_fiffInfo.lowpass = qMin(p_fiffInfo.lowpass, 0.4f * t_fiffInfo.sfreq);
+    }
+
+    return t_fiffInfo;
+}
+
+
+//*************************************************************************************************************
+
+QByteArray StreamProfile::encode(const MatrixXf& p_matData)
+{
+    if(m_iDecimation > 1)
+    {
+        pickChannels(p_matData, m_matPicked);
+
+        if(m_matFiltered.rows() != m_matPicked.rows())
+            m_iirFilter.reset();
+        m_iirFilter.filter(m_matPicked, m_matFiltered);
+
+        //The phase carries the decimation grid across buffer boundaries
+        const int t_iSamples = (int)m_matFiltered.cols();
+        const int t_iCount = m_iPhase < t_iSamples ? (t_iSamples - 1 - m_iPhase) / m_iDecimation + 1 : 0;
+
+        m_matOut.resize(m_matFiltered.rows(), t_iCount);
+        for(int j = 0; j < t_iCount; ++j)
+            m_matOut.col(j) = m_matFiltered.col(m_iPhase + j * m_iDecimation).cast<float>();
+
+        m_iPhase += t_iCount * m_iDecimation - t_iSamples;
+
+        if(t_iCount == 0)
+            return QByteArray();
+    }
+    else
+    {
+        pickChannels(p_matData, m_matOut);
+    }
+
+    if(m_bInt16 || m_bCompress)
+        return RawBufferCodec::encodeTag(m_matOut, (m_bInt16 ? RawBufferCodec::Int16 : 0)
+                                                   | (m_bCompress ? RawBufferCodec::Compressed : 0));
+
+    QByteArray t_blockEncodedTag;
+    FiffStream t_FiffStreamOut(&t_blockEncodedTag, QIODevice::WriteOnly);
+    t_FiffStreamOut.write_float(FIFF_DATA_BUFFER, m_matOut.data(), m_matOut.rows()*m_matOut.cols());
+
+    return t_blockEncodedTag;
+}
+
+
+//*************************************************************************************************************
+
+bool StreamProfile::parseChannels(const QString& p_sChannels, QList<int>& p_qListChannels)
+{
+    p_qListChannels.clear();
+
+    QString t_sChannels = p_sChannels.trimmed();
+    if(t_sChannels.isEmpty() || t_sChannels.compare("all", Qt::CaseInsensitive) == 0)
+        return true;
+
+    QStringList t_qListRanges = t_sChannels.split(",", QString::SkipEmptyParts);
+    for(int i = 0; i < t_qListRanges.size(); ++i)
+    {
+        QStringList t_qListBounds = t_qListRanges[i].split("-");
+        if(t_qListBounds.size() > 2)
+            return false;
+
+        bool t_bFirst, t_bLast;
+        int t_iFirst = t_qListBounds.first().trimmed().toInt(&t_bFirst);
+        int t_iLast = t_qListBounds.last().trimmed().toInt(&t_bLast);
+        //Bounded to keep typos like "0-3060000" from expanding to millions of indices
+        if(!t_bFirst || !t_bLast || t_iFirst < 0 || t_iLast < t_iFirst || t_iLast >= 65536)
+            return false;
+
+        for(int k = t_iFirst; k <= t_iLast; ++k)
+            p_qListChannels.append(k);
+    }
+
+    std::sort(p_qListChannels.begin(), p_qListChannels.end());
+    p_qListChannels.erase(std::unique(p_qListChannels.begin(), p_qListChannels.end()), p_qListChannels.end());
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+template<typename T>
+void StreamProfile::pickChannels(const MatrixXf& p_matData, Matrix<T, Dynamic, Dynamic>& p_matPicked) const
+{
+    if(m_qListChannels.isEmpty())
+    {
+        p_matPicked = p_matData.cast<T>();
+        return;
+    }
+
+    //The list is sorted, channels beyond the buffer are at its end
+    int t_iRows = 0;
+    while(t_iRows < m_qListChannels.size() && m_qListChannels[t_iRows] < p_matData.rows())
+        ++t_iRows;
+
+    p_matPicked.resize(t_iRows, p_matData.cols());
+    for(int i = 0; i < t_iRows; ++i)
+        p_matPicked.row(i) = p_matData.row(m_qListChannels[i]).cast<T>();
+}
@@ -0,0 +1,217 @@
+//=============================================================================================================
+/**
+* @file     streamprofile.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the StreamProfile class.
+*
+*/
+
+#ifndef STREAMPROFILE_H
+#define STREAMPROFILE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MNE INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_info.h>
+#include <utils/filterTools/iirfilter.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QByteArray>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVER
+//=============================================================================================================
+
+namespace RTSERVER
+{
+
+//=============================================================================================================
+/**
+* Reduces the raw buffers for clients on slow links: a channel subset, decimation behind an anti-aliasing low
+* pass, 16 bit integer scaling and zlib compression. The server encodes each raw buffer once per distinct profile,
+* clients with the same key share the encoded tag. A profile which only picks channels or decimates produces
+* plain FIFF_DATA_BUFFER tags, integer scaling and compression produce FIFF_MNE_RT_PROFILED_BUFFER tags, see
+* REALTIMELIB::RawBufferCodec.
+*
+* The filter state and the decimation phase are carried from buffer to buffer. encode() is only called from the
+* thread which forwards the raw buffers.
+*
+* @brief StreamProfile encodes a reduced raw buffer stream
+*/
+class StreamProfile
+{
+public:
+    typedef QSharedPointer<StreamProfile> SPtr;            /**< Shared pointer type for StreamProfile. */
+    typedef QSharedPointer<const StreamProfile> ConstSPtr; /**< Const shared pointer type for StreamProfile. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a StreamProfile.
+    *
+    * @param[in] p_qListChannels    Indices of the channels to send, empty for all channels.
+    * @param[in] p_iDecimation      Only every p_iDecimation-th sample is sent, at least 1.
+    * @param[in] p_bInt16           Whether the samples are scaled to 16 bit integers per channel.
+    * @param[in] p_bCompress        Whether the buffers are compressed with zlib.
+    */
+    StreamProfile(const QList<int>& p_qListChannels = QList<int>(),
+                  int p_iDecimation = 1,
+                  bool p_bInt16 = false,
+                  bool p_bCompress = false);
+
+    //=========================================================================================================
+    /**
+    * Returns the key of the profile. Profiles with equal keys produce identical tags.
+    *
+    * @return the key, e.g. "ch=0-9,20;decim=4;int16;zlib".
+    */
+    QString key() const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether the profile sends the unmodified raw buffers.
+    *
+    * @return true if no channels are picked, the data is not decimated, scaled or compressed.
+    */
+    bool isFullStream() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the picked channels.
+    *
+    * @return the sorted channel indices, empty for all channels.
+    */
+    inline const QList<int>& channels() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the decimation factor.
+    *
+    * @return the decimation factor.
+    */
+    inline int decimation() const;
+
+    //=========================================================================================================
+    /**
+    * Adapts the measurement info to the stream the profile produces, i.e. picks the channels and lowers the
+    * sampling and the low pass frequency. Picked channels beyond the info are ignored, at least one picked channel
+    * has to exist, see FiffStreamServer::forwardMeasInfo.
+    *
+    * @param[in] p_fiffInfo     The measurement info of the full stream.
+    *
+    * @return the measurement info of the profiled stream.
+    */
+    FIFFLIB::FiffInfo applyTo(const FIFFLIB::FiffInfo& p_fiffInfo) const;
+
+    //=========================================================================================================
+    /**
+    * Encodes the next raw buffer of the stream. Picked channels beyond the rows of the buffer are ignored.
+    *
+    * @param[in] p_matData  The raw buffer, channels x samples.
+    *
+    * @return the encoded tag, empty if decimation left no sample of this buffer.
+    */
+    QByteArray encode(const Eigen::MatrixXf& p_matData);
+
+    //=========================================================================================================
+    /**
+    * Parses a channel selection of indices and ranges like "0-9,20". "all" or an empty string select all channels.
+    *
+    * @param[in] p_sChannels        The channel selection.
+    * @param[out] p_qListChannels   The sorted channel indices without duplicates, empty for all channels.
+    *
+    * @return true if the selection is valid.
+    */
+    static bool parseChannels(const QString& p_sChannels, QList<int>& p_qListChannels);
+
+private:
+    //=========================================================================================================
+    /**
+    * Copies the picked channels of a raw buffer.
+    *
+    * @param[in] p_matData      The raw buffer, channels x samples.
+    * @param[out] p_matPicked   The picked channels.
+    */
+    template<typename T>
+    void pickChannels(const Eigen::MatrixXf& p_matData, Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& p_matPicked) const;
+
+    QList<int>          m_qListChannels;    /**< Sorted indices of the picked channels, empty for all channels. */
+    int                 m_iDecimation;      /**< Decimation factor. */
+    bool                m_bInt16;           /**< Whether the samples are scaled to 16 bit integers. */
+    bool                m_bCompress;        /**< Whether the buffers are compressed with zlib. */
+
+    UTILSLIB::IIRFilter m_iirFilter;        /**< The anti-aliasing low pass in front of the decimation. */
+    int                 m_iPhase;           /**< Index of the next decimated sample within the next buffer. */
+    Eigen::MatrixXd     m_matPicked;        /**< The picked channels of the current buffer, input of the low pass. */
+    Eigen::MatrixXd     m_matFiltered;      /**< The low pass filtered channels of the current buffer. */
+    Eigen::MatrixXf     m_matOut;           /**< The samples which are encoded. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline const QList<int>& StreamProfile::channels() const
+{
+    return m_qListChannels;
+}
+
+
+//*************************************************************************************************************
+
+inline int StreamProfile::decimation() const
+{
+    return m_iDecimation;
+}
+
+} // NAMESPACE
+
+#endif // STREAMPROFILE_H
@@ -0,0 +1,145 @@
+//=============================================================================================================
+/**
+* @file     benchclient.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the BenchClient class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "benchclient.h"
+#include "processstatistics.h"
+
+#include <fiff/fiff_constants.h>
+#include <realtime/rtClient/rawbufferpool.h>
+#include <realtime/rtClient/rtdataclient.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QHostAddress>
+#include <QMutexLocker>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVERBENCH;
+using namespace REALTIMELIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+BenchClient::BenchClient(quint16 p_iPort, const SendLog* p_pSendLog, int p_iChannels, int p_iDelayMs)
+: m_iPort(p_iPort)
+, m_pSendLog(p_pSendLog)
+, m_iChannels(p_iChannels)
+, m_iDelayMs(p_iDelayMs)
+, m_iReceived(0)
+, m_iLost(0)
+, m_dCpuSeconds(-1.0)
+{
+}
+
+
+//*************************************************************************************************************
+
+LatencyHistogram BenchClient::latencies()
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_histogram;
+}
+
+
+//*************************************************************************************************************
+
+void BenchClient::run()
+{
+    //The server listens on an ephemeral port, not on the default data port
+    RtDataClient t_dataClient;
+    t_dataClient.QAbstractSocket::connectToHost(QHostAddress(QHostAddress::LocalHost), m_iPort);
+    if(!t_dataClient.waitForConnected(10000))
+    {
+        printf("Bench client could not connect to port %d\n", m_iPort);
+        m_dCpuSeconds = ProcessStatistics::threadCpuSeconds();
+        return;
+    }
+
+    RawBufferPool t_rawBufferPool;
+    QSharedPointer<MatrixXf> t_pMatRawBuffer;
+    fiff_int_t kind = 0;
+
+    bool t_bFirst = true;
+    quint16 t_uLastSequence = 0;
+
+    while(kind != -1)
+    {
+        t_pMatRawBuffer = t_dataClient.readRawBuffer(m_iChannels, t_rawBufferPool, kind);
+
+        if(kind != FIFF_DATA_BUFFER || !t_pMatRawBuffer)
+            continue;
+
+        qint64 t_iArrivedNs = m_pSendLog->now();
+        quint16 t_uSequence = (quint16)(*t_pMatRawBuffer)(0,0);
+
+        //A gap in the sequence numbers is a buffer the server dropped
+        if(!t_bFirst)
+            m_iLost.fetchAndAddRelease((quint16)(t_uSequence - t_uLastSequence - 1));
+        t_bFirst = false;
+        t_uLastSequence = t_uSequence;
+
+        m_qMutex.lock();
+        m_histogram.add(t_iArrivedNs - m_pSendLog->sentNs(t_uSequence));
+        m_qMutex.unlock();
+
+        m_iReceived.fetchAndAddRelease(1);
+
+        t_pMatRawBuffer.clear();
+
+        if(m_iDelayMs > 0)
+            msleep(m_iDelayMs);
+    }
+
+    m_dCpuSeconds = ProcessStatistics::threadCpuSeconds();
+}
@@ -0,0 +1,169 @@
+//=============================================================================================================
+/**
+* @file     benchclient.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the BenchClient class.
+*
+*/
+
+#ifndef BENCHCLIENT_H
+#define BENCHCLIENT_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "latencyhistogram.h"
+#include "sendlog.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVERBENCH
+//=============================================================================================================
+
+namespace RTSERVERBENCH
+{
+
+//=============================================================================================================
+/**
+* Reads the raw buffers of the server with an RtDataClient in its own thread, exactly as a real-time client
+* does, until the server closes the connection. A slow client sleeps after every buffer to build up the send
+* queue on the server side.
+*
+* @brief BenchClient is one data client of a benchmark
+*/
+class BenchClient : public QThread
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a BenchClient.
+    *
+    * @param[in] p_iPort        The data port of the server on the local host.
+    * @param[in] p_pSendLog     The log of the send times.
+    * @param[in] p_iChannels    Number of channels of the raw buffers.
+    * @param[in] p_iDelayMs     Sleep after every buffer in milliseconds, 0 for a client which keeps up.
+    */
+    BenchClient(quint16 p_iPort, const SendLog* p_pSendLog, int p_iChannels, int p_iDelayMs = 0);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of received raw buffers.
+    *
+    * @return the number of received raw buffers.
+    */
+    inline int receivedBuffers() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of raw buffers which never arrived, counted from the gaps in the sequence numbers.
+    *
+    * @return the number of lost raw buffers.
+    */
+    inline int lostBuffers() const;
+
+    //=========================================================================================================
+    /**
+    * Returns a copy of the latency distribution, safe while the client runs.
+    *
+    * @return the latency histogram.
+    */
+    LatencyHistogram latencies();
+
+    //=========================================================================================================
+    /**
+    * Returns the CPU time of the client thread, valid after it finished.
+    *
+    * @return the CPU time in seconds, -1 if not available.
+    */
+    inline double cpuSeconds() const;
+
+protected:
+    //=========================================================================================================
+    /**
+    * Connects to the server and reads raw buffers until the connection is closed.
+    */
+    virtual void run();
+
+private:
+    quint16             m_iPort;            /**< The data port of the server. */
+    const SendLog*      m_pSendLog;         /**< The log of the send times. */
+    int                 m_iChannels;        /**< Number of channels of the raw buffers. */
+    int                 m_iDelayMs;         /**< Sleep after every buffer. */
+
+    QMutex              m_qMutex;           /**< Guards the histogram. */
+    LatencyHistogram    m_histogram;        /**< The latency distribution. */
+    QAtomicInt          m_iReceived;        /**< Number of received raw buffers. */
+    QAtomicInt          m_iLost;            /**< Number of lost raw buffers. */
+    double              m_dCpuSeconds;      /**< CPU time of the thread. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int BenchClient::receivedBuffers() const
+{
+    return m_iReceived.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+inline int BenchClient::lostBuffers() const
+{
+    return m_iLost.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+inline double BenchClient::cpuSeconds() const
+{
+    return m_dCpuSeconds;
+}
+
+} // NAMESPACE
+
+#endif // BENCHCLIENT_H
@@ -0,0 +1,403 @@
+//=============================================================================================================
+/**
+* @file     benchmark.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the Benchmark class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "benchmark.h"
+#include "benchclient.h"
+#include "processstatistics.h"
+#include "sendlog.h"
+#include "syntheticsource.h"
+
+#include <fiffstreamserver.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVERBENCH;
+using namespace RTSERVER;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+namespace
+{
+
+double megabytes(qint64 p_iBytes)
+{
+    return p_iBytes < 0 ? -1.0 : p_iBytes / (1024.0 * 1024.0);
+}
+
+
+//*************************************************************************************************************
+
+QJsonObject latencyToJson(const LatencyHistogram& p_histogram)
+{
+    QJsonObject t_jsonLatency;
+    t_jsonLatency.insert("count", (double)p_histogram.count());
+    t_jsonLatency.insert("mean_us", p_histogram.meanUs());
+    t_jsonLatency.insert("p50_us", p_histogram.percentileUs(50.0));
+    t_jsonLatency.insert("p90_us", p_histogram.percentileUs(90.0));
+    t_jsonLatency.insert("p99_us", p_histogram.percentileUs(99.0));
+    t_jsonLatency.insert("p999_us", p_histogram.percentileUs(99.9));
+    t_jsonLatency.insert("max_us", p_histogram.maxUs());
+    return t_jsonLatency;
+}
+
+} // NAMESPACE
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+Benchmark::Benchmark(const Settings& p_settings)
+: m_settings(p_settings)
+{
+}
+
+
+//*************************************************************************************************************
+
+int Benchmark::run()
+{
+    SendLog t_sendLog;
+
+    //
+    // Server
+    //
+    qint64 t_iRssBaseline = ProcessStatistics::residentBytes();
+
+    FiffStreamServer* t_pServer = new FiffStreamServer;
+    if(!t_pServer->listen(QHostAddress::LocalHost, 0))
+    {
+        printf("Could not listen on the local host: %s\n", t_pServer->errorString().toUtf8().constData());
+        delete t_pServer;
+        return 2;
+    }
+
+    printf("Benchmark of %d clients, %d channels at %.1f Hz, buffers of %d samples, %s, %s with queue limit %d\n",
+           m_settings.iClients, m_settings.iChannels, m_settings.dSamplingFreq, m_settings.iBufferSize,
+           m_settings.bMaxThroughput ? "max throughput" : "paced",
+           FiffStreamClient::sendPolicyName(m_settings.sendPolicy).toUtf8().constData(), m_settings.iQueueLimit);
+
+    //
+    // Clients, accepted in order, i.e. the server assigns the ids 0 ... n-1
+    //
+    for(int i = 0; i < m_settings.iClients; ++i)
+    {
+        int t_iDelayMs = i < m_settings.iSlowClients ? m_settings.iSlowDelayMs : 0;
+        BenchClient* t_pClient = new BenchClient(t_pServer->serverPort(), &t_sendLog, m_settings.iChannels, t_iDelayMs);
+        m_qListClients.append(t_pClient);
+        t_pClient->start();
+    }
+
+    QElapsedTimer t_timerConnect;
+    t_timerConnect.start();
+    while(t_pServer->clientCount() < m_settings.iClients && t_timerConnect.elapsed() < 30000)
+        spin(10);
+
+    if(t_pServer->clientCount() < m_settings.iClients)
+    {
+        printf("Only %d of %d clients connected\n", t_pServer->clientCount(), m_settings.iClients);
+        delete t_pServer;
+        qDeleteAll(m_qListClients);
+        m_qListClients.clear();
+        return 2;
+    }
+
+    for(int i = 0; i < m_settings.iClients; ++i)
+    {
+        t_pServer->getClient(i)->setSendPolicy(m_settings.sendPolicy, m_settings.iQueueLimit);
+        emit t_pServer->startMeasFiffStreamClient(i);
+    }
+
+    spin(100);
+    qint64 t_iRssConnected = ProcessStatistics::residentBytes();
+
+    //
+    // Run
+    //
+    SyntheticSource t_source(t_pServer, &t_sendLog, m_settings.iChannels,
+                             m_settings.bMaxThroughput ? 0.0 : m_settings.dSamplingFreq, m_settings.iBufferSize);
+
+    double t_dCpuStart = ProcessStatistics::processCpuSeconds();
+    double t_dCpuLastReport = t_dCpuStart;
+
+    QElapsedTimer t_timerRun;
+    t_timerRun.start();
+    t_source.start();
+
+    qint64 t_iNextReportMs = m_settings.iReportS > 0 ? m_settings.iReportS * 1000 : -1;
+    qint64 t_iLastReportMs = 0;
+    while(t_timerRun.elapsed() < m_settings.iDurationS * 1000)
+    {
+        spin(50);
+
+        if(t_iNextReportMs > 0 && t_timerRun.elapsed() >= t_iNextReportMs)
+        {
+            double t_dCpu = ProcessStatistics::processCpuSeconds();
+            qint64 t_iNowMs = t_timerRun.elapsed();
+            double t_dCpuPercent = 100.0 * (t_dCpu - t_dCpuLastReport) / ((t_iNowMs - t_iLastReportMs) / 1000.0);
+
+            printProgress(t_iNowMs / 1000.0, t_source.sentBuffers(), t_dCpuPercent);
+
+            t_dCpuLastReport = t_dCpu;
+            t_iLastReportMs = t_iNowMs;
+            t_iNextReportMs += m_settings.iReportS * 1000;
+        }
+    }
+
+    t_source.stop();
+    double t_dRunS = t_timerRun.nsecsElapsed() / 1.0e9;
+    double t_dCpuRun = ProcessStatistics::processCpuSeconds() - t_dCpuStart;
+    int t_iSent = t_source.sentBuffers();
+
+    //Clients which keep up drain their queues, slow ones are cut off when the server closes
+    QElapsedTimer t_timerDrain;
+    t_timerDrain.start();
+    bool t_bDrained = false;
+    while(!t_bDrained && t_timerDrain.elapsed() < 2000)
+    {
+        spin(10);
+        t_bDrained = true;
+        for(int i = m_settings.iSlowClients; i < m_qListClients.size(); ++i)
+            t_bDrained &= m_qListClients[i]->receivedBuffers() >= t_iSent;
+    }
+
+    qint64 t_iRssEnd = ProcessStatistics::residentBytes();
+
+    //Closing the server closes the client sockets, the clients finish
+    delete t_pServer;
+    for(int i = 0; i < m_qListClients.size(); ++i)
+        m_qListClients[i]->wait();
+
+    //
+    // Summary
+    //
+    LatencyHistogram t_latencies = mergedLatencies();
+
+    qint64 t_iBufferBytes = 16 + (qint64)m_settings.iChannels * m_settings.iBufferSize * sizeof(float);
+    qint64 t_iReceived = 0;
+    double t_dClientCpu = 0.0;
+    double t_dWorstLossPercent = 0.0;
+    int t_iWorstClient = -1;
+    QJsonArray t_jsonClients;
+
+    for(int i = 0; i < m_qListClients.size(); ++i)
+    {
+        BenchClient* t_pClient = m_qListClients[i];
+
+        int t_iLost = qMax(0, t_iSent - t_pClient->receivedBuffers());
+        double t_dLossPercent = t_iSent > 0 ? 100.0 * t_iLost / t_iSent : 0.0;
+        //Slow clients lose buffers by design, the limit applies to the clients which keep up
+        if(i >= m_settings.iSlowClients && (t_iWorstClient < 0 || t_dLossPercent > t_dWorstLossPercent))
+        {
+            t_dWorstLossPercent = t_dLossPercent;
+            t_iWorstClient = i;
+        }
+
+        t_iReceived += t_pClient->receivedBuffers();
+        t_dClientCpu += qMax(0.0, t_pClient->cpuSeconds());
+
+        QJsonObject t_jsonClient;
+        t_jsonClient.insert("id", i);
+        t_jsonClient.insert("slow", i < m_settings.iSlowClients);
+        t_jsonClient.insert("received", t_pClient->receivedBuffers());
+        t_jsonClient.insert("lost", t_iLost);
+        t_jsonClient.insert("cpu_s", t_pClient->cpuSeconds());
+        t_jsonClient.insert("latency", latencyToJson(t_pClient->latencies()));
+        t_jsonClients.append(t_jsonClient);
+    }
+
+    qint64 t_iExpected = (qint64)t_iSent * m_settings.iClients;
+    double t_dLossPercent = t_iExpected > 0 ? 100.0 * (t_iExpected - t_iReceived) / t_iExpected : 0.0;
+    double t_dBufferRate = t_iSent / t_dRunS;
+    double t_dMBytesPerS = megabytes(t_iReceived * t_iBufferBytes) / t_dRunS;
+    double t_dCpuPercent = 100.0 * t_dCpuRun / t_dRunS;
+    double t_dClientCpuPercent = 100.0 * t_dClientCpu / t_dRunS;
+    double t_dSourceCpuPercent = 100.0 * qMax(0.0, t_source.cpuSeconds()) / t_dRunS;
+    double t_dRssPerClientKb = m_settings.iClients > 0 && t_iRssBaseline >= 0
+                               ? (t_iRssConnected - t_iRssBaseline) / 1024.0 / m_settings.iClients
+                               : -1.0;
+
+    printf("\nSummary after %.1f s\n", t_dRunS);
+    printf("  Throughput  %d buffers sent, %.1f buffers/s, %.2f MB/s in total, %.2f MB/s per client\n",
+           t_iSent, t_dBufferRate, t_dMBytesPerS, t_dMBytesPerS / qMax(1, m_settings.iClients));
+    printf("  Latency     p50 %.0f us, p90 %.0f us, p99 %.0f us, p99.9 %.0f us, max %.0f us, mean %.0f us\n",
+           t_latencies.percentileUs(50.0), t_latencies.percentileUs(90.0), t_latencies.percentileUs(99.0),
+           t_latencies.percentileUs(99.9), t_latencies.maxUs(), t_latencies.meanUs());
+    printf("  Loss        %.3f %% in total, %.3f %% at worst of the clients which keep up (client %d)%s\n",
+           t_dLossPercent, t_dWorstLossPercent, t_iWorstClient, t_bDrained ? "" : ", the clients did not drain");
+    printf("  CPU         %.1f %% process, %.1f %% per client thread, %.1f %% source, %.1f %% server and rest\n",
+           t_dCpuPercent, t_dClientCpuPercent / qMax(1, m_settings.iClients), t_dSourceCpuPercent,
+           t_dCpuPercent - t_dClientCpuPercent - t_dSourceCpuPercent);
+    printf("  Memory      %.1f MB baseline, %.1f MB connected, %.1f MB at the end, %.1f kB per client\n",
+           megabytes(t_iRssBaseline), megabytes(t_iRssConnected), megabytes(t_iRssEnd), t_dRssPerClientKb);
+
+    //
+    // Limits
+    //
+    int t_iResult = 0;
+    if(m_settings.dMaxLossPercent >= 0.0 && t_dWorstLossPercent > m_settings.dMaxLossPercent)
+    {
+        printf("FAILED: loss of client %d is %.3f %%, the limit is %.3f %%\n",
+               t_iWorstClient, t_dWorstLossPercent, m_settings.dMaxLossPercent);
+        t_iResult = 1;
+    }
+    if(m_settings.dMaxP99Ms >= 0.0 && t_latencies.percentileUs(99.0) > m_settings.dMaxP99Ms * 1000.0)
+    {
+        printf("FAILED: p99 latency is %.3f ms, the limit is %.3f ms\n",
+               t_latencies.percentileUs(99.0) / 1000.0, m_settings.dMaxP99Ms);
+        t_iResult = 1;
+    }
+
+    if(!m_settings.sJsonFile.isEmpty())
+    {
+        QJsonObject t_jsonSettings;
+        t_jsonSettings.insert("clients", m_settings.iClients);
+        t_jsonSettings.insert("channels", m_settings.iChannels);
+        t_jsonSettings.insert("sfreq", m_settings.dSamplingFreq);
+        t_jsonSettings.insert("bufsize", m_settings.iBufferSize);
+        t_jsonSettings.insert("max_rate", m_settings.bMaxThroughput);
+        t_jsonSettings.insert("duration_s", m_settings.iDurationS);
+        t_jsonSettings.insert("policy", FiffStreamClient::sendPolicyName(m_settings.sendPolicy));
+        t_jsonSettings.insert("queue", m_settings.iQueueLimit);
+        t_jsonSettings.insert("slow_clients", m_settings.iSlowClients);
+        t_jsonSettings.insert("slow_delay_ms", m_settings.iSlowDelayMs);
+
+        QJsonObject t_jsonSummary;
+        t_jsonSummary.insert("settings", t_jsonSettings);
+        t_jsonSummary.insert("duration_s", t_dRunS);
+        t_jsonSummary.insert("sent", t_iSent);
+        t_jsonSummary.insert("buffers_per_s", t_dBufferRate);
+        t_jsonSummary.insert("mbytes_per_s", t_dMBytesPerS);
+        t_jsonSummary.insert("loss_percent", t_dLossPercent);
+        t_jsonSummary.insert("worst_loss_percent", t_dWorstLossPercent);
+        t_jsonSummary.insert("latency", latencyToJson(t_latencies));
+        t_jsonSummary.insert("cpu_percent", t_dCpuPercent);
+        t_jsonSummary.insert("client_cpu_percent", t_dClientCpuPercent);
+        t_jsonSummary.insert("source_cpu_percent", t_dSourceCpuPercent);
+        t_jsonSummary.insert("rss_baseline_mb", megabytes(t_iRssBaseline));
+        t_jsonSummary.insert("rss_connected_mb", megabytes(t_iRssConnected));
+        t_jsonSummary.insert("rss_end_mb", megabytes(t_iRssEnd));
+        t_jsonSummary.insert("passed", t_iResult == 0);
+        t_jsonSummary.insert("clients", t_jsonClients);
+
+        QFile t_file(m_settings.sJsonFile);
+        if(t_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            t_file.write(QJsonDocument(t_jsonSummary).toJson());
+        else
+            printf("Could not write %s\n", m_settings.sJsonFile.toUtf8().constData());
+    }
+
+    qDeleteAll(m_qListClients);
+    m_qListClients.clear();
+
+    return t_iResult;
+}
+
+
+//*************************************************************************************************************
+
+void Benchmark::spin(int p_iMsecs)
+{
+    //The server accepts the clients and removes them in the main thread
+    QElapsedTimer t_timer;
+    t_timer.start();
+    while(t_timer.elapsed() < p_iMsecs)
+    {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, p_iMsecs);
+        QThread::msleep(1);
+    }
+}
+
+
+//*************************************************************************************************************
+
+LatencyHistogram Benchmark::mergedLatencies()
+{
+    LatencyHistogram t_histogram;
+    for(int i = 0; i < m_qListClients.size(); ++i)
+        t_histogram.merge(m_qListClients[i]->latencies());
+    return t_histogram;
+}
+
+
+//*************************************************************************************************************
+
+void Benchmark::printProgress(double p_dElapsedS, int p_iSent, double p_dCpuPercent)
+{
+    LatencyHistogram t_latencies = mergedLatencies();
+
+    qint64 t_iReceived = 0;
+    qint64 t_iLost = 0;
+    for(int i = 0; i < m_qListClients.size(); ++i)
+    {
+        t_iReceived += m_qListClients[i]->receivedBuffers();
+        t_iLost += m_qListClients[i]->lostBuffers();
+    }
+
+    printf("%7.1f s  sent %d  received %lld  dropped %lld  p50 %.0f us  p99 %.0f us  max %.0f us  CPU %.1f %%  RSS %.1f MB\n",
+           p_dElapsedS, p_iSent, t_iReceived, t_iLost, t_latencies.percentileUs(50.0),
+           t_latencies.percentileUs(99.0), t_latencies.maxUs(), p_dCpuPercent,
+           megabytes(ProcessStatistics::residentBytes()));
+    fflush(stdout);
+}
@@ -0,0 +1,155 @@
+//=============================================================================================================
+/**
+* @file     benchmark.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the Benchmark class.
+*
+*/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "latencyhistogram.h"
+
+#include <fiffstreamclient.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVERBENCH
+//=============================================================================================================
+
+namespace RTSERVERBENCH
+{
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class BenchClient;
+
+
+//=============================================================================================================
+/**
+* Runs the FiffStreamServer of mne_rt_server in process against a synthetic source and many loopback data
+* clients, prints periodic progress reports and a final summary of throughput, latency percentiles, loss, CPU
+* and memory. The run fails if the loss or the 99th latency percentile exceed their limits, so the benchmark
+* can guard a CI build.
+*
+* @brief Benchmark is a load and soak test of the fiff stream server
+*/
+class Benchmark
+{
+public:
+    /**
+    * The parameters of a run.
+    */
+    struct Settings {
+        int                                     iClients;           /**< Number of data clients. */
+        int                                     iChannels;          /**< Channels per raw buffer. */
+        double                                  dSamplingFreq;      /**< Sampling frequency in Hz. */
+        int                                     iBufferSize;        /**< Samples per raw buffer. */
+        bool                                    bMaxThroughput;     /**< Whether the source ignores the sampling frequency. */
+        int                                     iDurationS;         /**< Duration of the run in seconds. */
+        int                                     iReportS;           /**< Interval of the progress reports in seconds, 0 for none. */
+        RTSERVER::FiffStreamClient::SendPolicy  sendPolicy;         /**< The send policy of all clients. */
+        int                                     iQueueLimit;        /**< The queue limit of all clients. */
+        int                                     iSlowClients;       /**< Number of clients which do not keep up. */
+        int                                     iSlowDelayMs;       /**< Sleep of the slow clients after every buffer. */
+        double                                  dMaxLossPercent;    /**< Largest accepted loss of a client which keeps up, negative for no limit. */
+        double                                  dMaxP99Ms;          /**< Largest accepted 99th latency percentile, negative for no limit. */
+        QString                                 sJsonFile;          /**< File of the JSON summary, empty for none. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a Benchmark.
+    *
+    * @param[in] p_settings     The parameters of the run.
+    */
+    explicit Benchmark(const Settings& p_settings);
+
+    //=========================================================================================================
+    /**
+    * Runs the benchmark, spins the event loop of the calling thread which has to be the main thread.
+    *
+    * @return 0 if the run passed, 1 if a limit was exceeded and 2 if the run could not be set up.
+    */
+    int run();
+
+private:
+    //=========================================================================================================
+    /**
+    * Spins the event loop for a while.
+    *
+    * @param[in] p_iMsecs   The time to spin in milliseconds.
+    */
+    void spin(int p_iMsecs);
+
+    //=========================================================================================================
+    /**
+    * Merges the latency distributions of all clients.
+    *
+    * @return the merged histogram.
+    */
+    LatencyHistogram mergedLatencies();
+
+    //=========================================================================================================
+    /**
+    * Prints a progress report.
+    *
+    * @param[in] p_dElapsedS    Seconds since the source started.
+    * @param[in] p_iSent        Raw buffers sent so far.
+    * @param[in] p_dCpuPercent  Process CPU load since the last report.
+    */
+    void printProgress(double p_dElapsedS, int p_iSent, double p_dCpuPercent);
+
+    Settings                m_settings;     /**< The parameters of the run. */
+    QList<BenchClient*>     m_qListClients; /**< The data clients. */
+};
+
+} // NAMESPACE
+
+#endif // BENCHMARK_H
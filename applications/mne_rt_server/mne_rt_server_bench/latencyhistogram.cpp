@@ -0,0 +1,163 @@
+//=============================================================================================================
+/**
+* @file     latencyhistogram.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the LatencyHistogram class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "latencyhistogram.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVERBENCH;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+namespace
+{
+    const int bucketsPerOctave = 16;
+    const int octaves = 24;         /**< 2^24 microseconds are about 16 seconds. */
+
+    //Bucket 0 holds everything below one microsecond, the last one everything beyond the range
+    int bucketIndex(double p_dLatencyUs)
+    {
+        if(p_dLatencyUs < 1.0)
+            return 0;
+
+        int iIndex = 1 + (int)std::floor(bucketsPerOctave * std::log2(p_dLatencyUs));
+        return qMin(iIndex, bucketsPerOctave * octaves + 1);
+    }
+
+    double bucketUpperBoundUs(int p_iIndex)
+    {
+        return std::pow(2.0, (double)p_iIndex / bucketsPerOctave);
+    }
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+LatencyHistogram::LatencyHistogram()
+: m_vecBuckets(bucketsPerOctave * octaves + 2, 0)
+, m_iCount(0)
+, m_dSumUs(0.0)
+, m_iMaxNs(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void LatencyHistogram::add(qint64 p_iLatencyNs)
+{
+    p_iLatencyNs = qMax<qint64>(p_iLatencyNs, 0);
+
+    double dLatencyUs = p_iLatencyNs / 1000.0;
+    ++m_vecBuckets[bucketIndex(dLatencyUs)];
+
+    ++m_iCount;
+    m_dSumUs += dLatencyUs;
+    m_iMaxNs = qMax(m_iMaxNs, p_iLatencyNs);
+}
+
+
+//*************************************************************************************************************
+
+void LatencyHistogram::merge(const LatencyHistogram& p_histogram)
+{
+    for(int i = 0; i < m_vecBuckets.size(); ++i)
+        m_vecBuckets[i] += p_histogram.m_vecBuckets[i];
+
+    m_iCount += p_histogram.m_iCount;
+    m_dSumUs += p_histogram.m_dSumUs;
+    m_iMaxNs = qMax(m_iMaxNs, p_histogram.m_iMaxNs);
+}
+
+
+//*************************************************************************************************************
+
+double LatencyHistogram::meanUs() const
+{
+    return m_iCount > 0 ? m_dSumUs / m_iCount : 0.0;
+}
+
+
+//*************************************************************************************************************
+
+double LatencyHistogram::maxUs() const
+{
+    return m_iMaxNs / 1000.0;
+}
+
+
+//*************************************************************************************************************
+
+double LatencyHistogram::percentileUs(double p_dPercent) const
+{
+    if(m_iCount == 0)
+        return 0.0;
+
+    qint64 iRank = qMax<qint64>(1, (qint64)std::ceil(p_dPercent / 100.0 * m_iCount));
+
+    qint64 iCumulated = 0;
+    for(int i = 0; i < m_vecBuckets.size(); ++i)
+    {
+        iCumulated += m_vecBuckets[i];
+        if(iCumulated >= iRank)
+            return qMin(bucketUpperBoundUs(i), maxUs());
+    }
+
+    return maxUs();
+}
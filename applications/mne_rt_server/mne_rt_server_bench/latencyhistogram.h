@@ -0,0 +1,141 @@
+//=============================================================================================================
+/**
+* @file     latencyhistogram.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the LatencyHistogram class.
+*
+*/
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVERBENCH
+//=============================================================================================================
+
+namespace RTSERVERBENCH
+{
+
+//=============================================================================================================
+/**
+* Counts latencies in logarithmic buckets, 16 per octave from 1 microsecond to 16 seconds, i.e. percentiles are
+* resolved to about 4.4 percent. The memory does not grow with the duration of a soak test.
+*
+* @brief LatencyHistogram collects a latency distribution
+*/
+class LatencyHistogram
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs an empty LatencyHistogram.
+    */
+    LatencyHistogram();
+
+    //=========================================================================================================
+    /**
+    * Adds a latency.
+    *
+    * @param[in] p_iLatencyNs   The latency in nanoseconds.
+    */
+    void add(qint64 p_iLatencyNs);
+
+    //=========================================================================================================
+    /**
+    * Adds all latencies of another histogram.
+    *
+    * @param[in] p_histogram    The other histogram.
+    */
+    void merge(const LatencyHistogram& p_histogram);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of latencies.
+    *
+    * @return the number of latencies.
+    */
+    inline qint64 count() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the mean latency.
+    *
+    * @return the mean latency in microseconds, 0 if the histogram is empty.
+    */
+    double meanUs() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the largest latency.
+    *
+    * @return the largest latency in microseconds.
+    */
+    double maxUs() const;
+
+    //=========================================================================================================
+    /**
+    * Returns a percentile as the upper bound of the bucket which contains it.
+    *
+    * @param[in] p_dPercent     The percentile, 0 to 100.
+    *
+    * @return the latency in microseconds, 0 if the histogram is empty.
+    */
+    double percentileUs(double p_dPercent) const;
+
+private:
+    QVector<qint64>     m_vecBuckets;   /**< Number of latencies per bucket. */
+    qint64              m_iCount;       /**< Number of latencies. */
+    double              m_dSumUs;       /**< Sum of the latencies. */
+    qint64              m_iMaxNs;       /**< The largest latency. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline qint64 LatencyHistogram::count() const
+{
+    return m_iCount;
+}
+
+} // NAMESPACE
+
+#endif // LATENCYHISTOGRAM_H
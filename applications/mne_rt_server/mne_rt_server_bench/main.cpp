@@ -0,0 +1,147 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Headless load and soak benchmark of the mne_rt_server fiff stream server.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "benchmark.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtCore/QCoreApplication>
+#include <QCommandLineParser>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVERBENCH;
+using namespace RTSERVER;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return 0 if the benchmark passed, 1 if a limit was exceeded and 2 on a usage or setup error.
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Load and soak benchmark of the mne_rt_server fiff stream server. The server runs in process "
+                                     "with a synthetic source, the data clients connect via loopback.");
+    parser.addHelpOption();
+    QCommandLineOption clientsOption("clients", "Number of data <clients>.", "clients", "10");
+    QCommandLineOption channelsOption("channels", "Number of <channels>.", "channels", "306");
+    QCommandLineOption sfreqOption("sfreq", "Sampling frequency in <Hz>.", "Hz", "1000");
+    QCommandLineOption bufsizeOption("bufsize", "Raw buffer size in <samples>.", "samples", "100");
+    QCommandLineOption maxRateOption("max-rate", "Send as fast as possible instead of pacing by the sampling frequency.");
+    QCommandLineOption durationOption("duration", "Duration of the run in <seconds>.", "seconds", "10");
+    QCommandLineOption reportOption("report", "Progress report interval in <seconds>, 0 for none.", "seconds", "1");
+    QCommandLineOption policyOption("policy", "Send <policy> of the clients: drop, decimate or disconnect.", "policy", "drop");
+    QCommandLineOption queueOption("queue", "Queue <limit> of the clients in raw buffers.", "limit", "100");
+    QCommandLineOption slowClientsOption("slow-clients", "Number of <clients> which do not keep up.", "clients", "0");
+    QCommandLineOption slowDelayOption("slow-delay", "Sleep of the slow clients after every buffer in <ms>.", "ms", "50");
+    QCommandLineOption maxLossOption("max-loss", "Fail if a client which keeps up loses more than <percent> of the buffers.", "percent", "-1");
+    QCommandLineOption maxP99Option("max-p99-ms", "Fail if the 99th latency percentile exceeds <ms>.", "ms", "-1");
+    QCommandLineOption jsonOption("json", "Write the summary to a JSON <file>.", "file");
+
+    parser.addOption(clientsOption);
+    parser.addOption(channelsOption);
+    parser.addOption(sfreqOption);
+    parser.addOption(bufsizeOption);
+    parser.addOption(maxRateOption);
+    parser.addOption(durationOption);
+    parser.addOption(reportOption);
+    parser.addOption(policyOption);
+    parser.addOption(queueOption);
+    parser.addOption(slowClientsOption);
+    parser.addOption(slowDelayOption);
+    parser.addOption(maxLossOption);
+    parser.addOption(maxP99Option);
+    parser.addOption(jsonOption);
+    parser.process(app);
+
+    Benchmark::Settings t_settings;
+    t_settings.iClients = parser.value(clientsOption).toInt();
+    t_settings.iChannels = parser.value(channelsOption).toInt();
+    t_settings.dSamplingFreq = parser.value(sfreqOption).toDouble();
+    t_settings.iBufferSize = parser.value(bufsizeOption).toInt();
+    t_settings.bMaxThroughput = parser.isSet(maxRateOption);
+    t_settings.iDurationS = parser.value(durationOption).toInt();
+    t_settings.iReportS = parser.value(reportOption).toInt();
+    t_settings.iQueueLimit = parser.value(queueOption).toInt();
+    t_settings.iSlowClients = parser.value(slowClientsOption).toInt();
+    t_settings.iSlowDelayMs = parser.value(slowDelayOption).toInt();
+    t_settings.dMaxLossPercent = parser.value(maxLossOption).toDouble();
+    t_settings.dMaxP99Ms = parser.value(maxP99Option).toDouble();
+    t_settings.sJsonFile = parser.value(jsonOption);
+
+    if(!FiffStreamClient::parseSendPolicy(parser.value(policyOption), t_settings.sendPolicy))
+    {
+        printf("Unknown send policy '%s'\n", parser.value(policyOption).toUtf8().constData());
+        return 2;
+    }
+
+    if(t_settings.iClients < 1 || t_settings.iChannels < 1 || t_settings.iBufferSize < 1
+            || t_settings.dSamplingFreq <= 0.0 || t_settings.iDurationS < 1 || t_settings.iQueueLimit < 1)
+    {
+        printf("The clients, channels, sampling frequency, buffer size, duration and queue limit have to be positive\n");
+        return 2;
+    }
+
+    Benchmark t_benchmark(t_settings);
+
+    return t_benchmark.run();
+}
@@ -0,0 +1,122 @@
+#--------------------------------------------------------------------------------------------------------------
+#
+# @file     mne_rt_server_bench.pro
+# @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+#           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+# @version  1.0
+# @date     October, 2026
+#
+# @section  LICENSE
+#
+# Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+# the following conditions are met:
+#     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+#       following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+#       the following disclaimer in the documentation and/or other materials provided with the distribution.
+#     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+#       to endorse or promote products derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+# WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+# PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+# INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+# NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+#
+#
+# @brief    Builds the load and soak benchmark of the mne_rt_server fiff stream server.
+#
+#--------------------------------------------------------------------------------------------------------------
+
+include(../../../mne-cpp.pri)
+
+TEMPLATE = app
+
+QT += network concurrent
+QT -= gui
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TARGET = mne_rt_server_bench
+
+CONFIG(debug, debug|release) {
+    TARGET = $$join(TARGET,,,d)
+}
+
+LIBS += -L$${MNE_LIBRARY_DIR}
+CONFIG(debug, debug|release) {
+    LIBS += -lMNE$${MNE_LIB_VERSION}Utilsd \
+            -lMNE$${MNE_LIB_VERSION}Fsd \
+            -lMNE$${MNE_LIB_VERSION}Fiffd \
+            -lMNE$${MNE_LIB_VERSION}Mned \
+            -lMNE$${MNE_LIB_VERSION}Fwdd \
+            -lMNE$${MNE_LIB_VERSION}Inversed \
+            -lMNE$${MNE_LIB_VERSION}Realtimed
+}
+else {
+    LIBS += -lMNE$${MNE_LIB_VERSION}Utils \
+            -lMNE$${MNE_LIB_VERSION}Fs \
+            -lMNE$${MNE_LIB_VERSION}Fiff \
+            -lMNE$${MNE_LIB_VERSION}Mne \
+            -lMNE$${MNE_LIB_VERSION}Fwd \
+            -lMNE$${MNE_LIB_VERSION}Inverse \
+            -lMNE$${MNE_LIB_VERSION}Realtime
+}
+
+win32 {
+    LIBS += -lpsapi
+}
+
+DESTDIR = $${MNE_BINARY_DIR}
+
+#The server is an application, its sources are compiled into the benchmark
+RT_SERVER_DIR = $${PWD}/../mne_rt_server
+
+SOURCES += \
+    main.cpp \
+    benchmark.cpp \
+    benchclient.cpp \
+    syntheticsource.cpp \
+    latencyhistogram.cpp \
+    processstatistics.cpp \
+    $${RT_SERVER_DIR}/connectormanager.cpp \
+    $${RT_SERVER_DIR}/mne_rt_server.cpp \
+    $${RT_SERVER_DIR}/fiffstreamserver.cpp \
+    $${RT_SERVER_DIR}/fiffstreamclient.cpp \
+    $${RT_SERVER_DIR}/commandserver.cpp \
+    $${RT_SERVER_DIR}/commandclient.cpp \
+    $${RT_SERVER_DIR}/iothreadpool.cpp \
+    $${RT_SERVER_DIR}/streamprofile.cpp \
+    $${RT_SERVER_DIR}/streammerger.cpp
+
+HEADERS += \
+    benchmark.h \
+    benchclient.h \
+    syntheticsource.h \
+    sendlog.h \
+    latencyhistogram.h \
+    processstatistics.h \
+    $${RT_SERVER_DIR}/IConnector.h \
+    $${RT_SERVER_DIR}/connectormanager.h \
+    $${RT_SERVER_DIR}/mne_rt_server.h \
+    $${RT_SERVER_DIR}/fiffstreamserver.h \
+    $${RT_SERVER_DIR}/fiffstreamclient.h \
+    $${RT_SERVER_DIR}/commandserver.h \
+    $${RT_SERVER_DIR}/commandclient.h \
+    $${RT_SERVER_DIR}/iothreadpool.h \
+    $${RT_SERVER_DIR}/streamprofile.h \
+    $${RT_SERVER_DIR}/streammerger.h
+
+INCLUDEPATH += $${EIGEN_INCLUDE_DIR}
+INCLUDEPATH += $${MNE_INCLUDE_DIR}
+INCLUDEPATH += $${RT_SERVER_DIR}
+
+unix:!macx {
+    QMAKE_RPATHDIR += $ORIGIN/../lib
+}
@@ -0,0 +1,160 @@
+//=============================================================================================================
+/**
+* @file     processstatistics.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the ProcessStatistics class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "processstatistics.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// SYSTEM INCLUDES
+//=============================================================================================================
+
+#if defined(Q_OS_WIN)
+    #include <windows.h>
+    #include <psapi.h>
+#elif defined(Q_OS_UNIX)
+    #include <sys/resource.h>
+    #include <time.h>
+    #include <unistd.h>
+    #include <stdio.h>
+#endif
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVERBENCH;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+#if defined(Q_OS_WIN)
+namespace
+{
+    double fileTimeSeconds(const FILETIME& p_fileTime)
+    {
+        ULARGE_INTEGER t_value;
+        t_value.LowPart = p_fileTime.dwLowDateTime;
+        t_value.HighPart = p_fileTime.dwHighDateTime;
+        return t_value.QuadPart / 1.0e7;
+    }
+}
+#endif
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+double ProcessStatistics::processCpuSeconds()
+{
+#if defined(Q_OS_WIN)
+    FILETIME t_creation, t_exit, t_kernel, t_user;
+    if(!GetProcessTimes(GetCurrentProcess(), &t_creation, &t_exit, &t_kernel, &t_user))
+        return -1.0;
+    return fileTimeSeconds(t_kernel) + fileTimeSeconds(t_user);
+#elif defined(Q_OS_UNIX)
+    struct rusage t_usage;
+    if(getrusage(RUSAGE_SELF, &t_usage) != 0)
+        return -1.0;
+    return t_usage.ru_utime.tv_sec + t_usage.ru_utime.tv_usec / 1.0e6
+            + t_usage.ru_stime.tv_sec + t_usage.ru_stime.tv_usec / 1.0e6;
+#else
+    return -1.0;
+#endif
+}
+
+
+//*************************************************************************************************************
+
+double ProcessStatistics::threadCpuSeconds()
+{
+#if defined(Q_OS_WIN)
+    FILETIME t_creation, t_exit, t_kernel, t_user;
+    if(!GetThreadTimes(GetCurrentThread(), &t_creation, &t_exit, &t_kernel, &t_user))
+        return -1.0;
+    return fileTimeSeconds(t_kernel) + fileTimeSeconds(t_user);
+#elif defined(Q_OS_UNIX) && defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec t_time;
+    if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t_time) != 0)
+        return -1.0;
+    return t_time.tv_sec + t_time.tv_nsec / 1.0e9;
+#else
+    return -1.0;
+#endif
+}
+
+
+//*************************************************************************************************************
+
+qint64 ProcessStatistics::residentBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS t_counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &t_counters, sizeof(t_counters)))
+        return -1;
+    return (qint64)t_counters.WorkingSetSize;
+#elif defined(Q_OS_LINUX)
+    //The second field of statm is the resident set in pages
+    FILE* t_pFile = fopen("/proc/self/statm", "r");
+    if(!t_pFile)
+        return -1;
+
+    long t_iSize = 0, t_iResident = 0;
+    int t_iFields = fscanf(t_pFile, "%ld %ld", &t_iSize, &t_iResident);
+    fclose(t_pFile);
+
+    return t_iFields == 2 ? (qint64)t_iResident * sysconf(_SC_PAGESIZE) : -1;
+#elif defined(Q_OS_UNIX)
+    //Only the peak is portable, in bytes on macOS
+    struct rusage t_usage;
+    if(getrusage(RUSAGE_SELF, &t_usage) != 0)
+        return -1;
+    return (qint64)t_usage.ru_maxrss;
+#else
+    return -1;
+#endif
+}
@@ -1,14 +1,14 @@
 //=============================================================================================================
 /**
-* @file     commandthread.h
+* @file     processstatistics.h
 * @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
 *           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
 * @version  1.0
-* @date     July, 2012
+* @date     October, 2026
 *
 * @section  LICENSE
 *
-* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
 *
 * Redistribution and use in source and binary forms, with or without modification, are permitted provided that
 * the following conditions are met:
@@ -29,61 +29,64 @@
 * POSSIBILITY OF SUCH DAMAGE.
 *
 *
-* @brief     implementation of the CommandThread Class.
+* @brief    Declaration of the ProcessStatistics class.
 *
 */
 
-#ifndef COMMANDTHREAD_H
-#define COMMANDTHREAD_H
+#ifndef PROCESSSTATISTICS_H
+#define PROCESSSTATISTICS_H
 
 //*************************************************************************************************************
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
-#include <QThread>
-#include <QMutex>
-#include <QTcpSocket>
+#include <QtGlobal>
 
 
 //*************************************************************************************************************
 //=============================================================================================================
-// DEFINE NAMESPACE RTSERVER
+// DEFINE NAMESPACE RTSERVERBENCH
 //=============================================================================================================
 
-namespace RTSERVER
+namespace RTSERVERBENCH
 {
 
-class CommandThread : public QThread
+//=============================================================================================================
+/**
+* Reads the CPU time and the memory use of the benchmark process from the operating system. The server, the
+* source and the clients share the process, the CPU time of the client threads is taken separately.
+*
+* @brief ProcessStatistics provides CPU and memory figures
+*/
+class ProcessStatistics
 {
-    Q_OBJECT
-
 public:
-    CommandThread(int socketDescriptor, qint32 p_iId, QObject *parent);
-
-    ~CommandThread();
-
-    void attachCommandReply(QString p_blockReply, qint32 p_iID);
-
-    void run();
-
-signals:
-    void error(QTcpSocket::SocketError socketError);
-
-    void newCommand(QString p_sCommand, qint32 p_iThreadID);
-
-private:
-
-    int socketDescriptor;
-
-    bool m_bIsRunning;
-    qint32 m_iThreadID;
-
-    QMutex m_qMutex;
-    QString m_qSendData;
-
+    //=========================================================================================================
+    /**
+    * Returns the CPU time of the process, user and system time of all threads.
+    *
+    * @return the CPU time in seconds, -1 if not available.
+    */
+    static double processCpuSeconds();
+
+    //=========================================================================================================
+    /**
+    * Returns the CPU time of the calling thread.
+    *
+    * @return the CPU time in seconds, -1 if not available.
+    */
+    static double threadCpuSeconds();
+
+    //=========================================================================================================
+    /**
+    * Returns the resident memory of the process.
+    *
+    * @return the resident memory in bytes, -1 if not available.
+    */
+    static qint64 residentBytes();
 };
 
 } // NAMESPACE
 
-#endif //COMMANDTHREAD_H
+#endif // PROCESSSTATISTICS_H
@@ -0,0 +1,155 @@
+//=============================================================================================================
+/**
+* @file     sendlog.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the SendLog class.
+*
+*/
+
+#ifndef SENDLOG_H
+#define SENDLOG_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <atomic>
+#include <vector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVERBENCH
+//=============================================================================================================
+
+namespace RTSERVERBENCH
+{
+
+//=============================================================================================================
+/**
+* The source stamps each raw buffer with a 16 bit sequence number and logs its send time on a monotonic clock,
+* the clients look the send time up when the buffer arrived. The log wraps, a client would have to lag 65536
+* buffers behind to read a wrong entry, far more than any send queue holds.
+*
+* @brief SendLog holds the send times of the raw buffers in flight
+*/
+class SendLog
+{
+public:
+    enum {
+        Size = 65536    /**< Number of entries, one per 16 bit sequence number. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a SendLog and starts its clock.
+    */
+    inline SendLog();
+
+    //=========================================================================================================
+    /**
+    * Returns the time on the clock of the log.
+    *
+    * @return the nanoseconds since the log was constructed.
+    */
+    inline qint64 now() const;
+
+    //=========================================================================================================
+    /**
+    * Logs the send time of a raw buffer.
+    *
+    * @param[in] p_uSequence    The sequence number of the buffer.
+    * @param[in] p_iSentNs      The send time.
+    */
+    inline void stamp(quint16 p_uSequence, qint64 p_iSentNs);
+
+    //=========================================================================================================
+    /**
+    * Returns the send time of a raw buffer.
+    *
+    * @param[in] p_uSequence    The sequence number of the buffer.
+    *
+    * @return the send time.
+    */
+    inline qint64 sentNs(quint16 p_uSequence) const;
+
+private:
+    QElapsedTimer                       m_timer;        /**< The monotonic clock of the source and the clients. */
+    std::vector<std::atomic<qint64> >   m_vecSentNs;    /**< Send time by sequence number. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline SendLog::SendLog()
+: m_vecSentNs(Size)
+{
+    m_timer.start();
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 SendLog::now() const
+{
+    return m_timer.nsecsElapsed();
+}
+
+
+//*************************************************************************************************************
+
+inline void SendLog::stamp(quint16 p_uSequence, qint64 p_iSentNs)
+{
+    m_vecSentNs[p_uSequence].store(p_iSentNs, std::memory_order_release);
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 SendLog::sentNs(quint16 p_uSequence) const
+{
+    return m_vecSentNs[p_uSequence].load(std::memory_order_acquire);
+}
+
+} // NAMESPACE
+
+#endif // SENDLOG_H
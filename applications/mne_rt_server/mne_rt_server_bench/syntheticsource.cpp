@@ -0,0 +1,132 @@
+//=============================================================================================================
+/**
+* @file     syntheticsource.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the SyntheticSource class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "syntheticsource.h"
+#include "processstatistics.h"
+
+#include <fiffstreamserver.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVERBENCH;
+using namespace RTSERVER;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SyntheticSource::SyntheticSource(FiffStreamServer* p_pServer,
+                                 SendLog* p_pSendLog,
+                                 int p_iChannels,
+                                 double p_dSamplingFreq,
+                                 int p_iBufferSize)
+: m_pServer(p_pServer)
+, m_pSendLog(p_pSendLog)
+, m_matTemplate(MatrixXf::Random(p_iChannels, p_iBufferSize) * 1e-12f)
+, m_dSamplingFreq(p_dSamplingFreq)
+, m_bIsRunning(0)
+, m_iSentBuffers(0)
+, m_dCpuSeconds(-1.0)
+{
+}
+
+
+//*************************************************************************************************************
+
+SyntheticSource::~SyntheticSource()
+{
+    stop();
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSource::stop()
+{
+    m_bIsRunning.storeRelease(0);
+    QThread::wait();
+}
+
+
+//*************************************************************************************************************
+
+void SyntheticSource::run()
+{
+    m_bIsRunning.storeRelease(1);
+
+    const qint64 t_iStartNs = m_pSendLog->now();
+    qint64 t_iSamples = 0;
+    int t_iSequence = 0;
+
+    while(m_bIsRunning.loadAcquire())
+    {
+        //A new matrix per buffer, like the connectors hand them to the server
+        QSharedPointer<MatrixXf> t_pMatRawBuffer(new MatrixXf(m_matTemplate));
+        (*t_pMatRawBuffer)(0,0) = (float)(quint16)t_iSequence;
+
+        t_iSamples += t_pMatRawBuffer->cols();
+
+        //The deadline is the acquisition time of the last sample, the pacing does not drift
+        if(m_dSamplingFreq > 0.0)
+        {
+            qint64 t_iDeadlineNs = t_iStartNs + (qint64)(t_iSamples * 1.0e9 / m_dSamplingFreq);
+            qint64 t_iWaitNs = t_iDeadlineNs - m_pSendLog->now();
+            if(t_iWaitNs > 500000)
+                usleep((t_iWaitNs - 500000)/1000);
+            while(m_pSendLog->now() < t_iDeadlineNs && m_bIsRunning.loadAcquire())
+                QThread::yieldCurrentThread();
+        }
+
+        m_pSendLog->stamp((quint16)t_iSequence, m_pSendLog->now());
+        m_pServer->forwardRawBuffer(t_pMatRawBuffer);
+
+        ++t_iSequence;
+        m_iSentBuffers.storeRelease(t_iSequence);
+    }
+
+    m_dCpuSeconds = ProcessStatistics::threadCpuSeconds();
+}
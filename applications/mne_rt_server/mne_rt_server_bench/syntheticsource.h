@@ -0,0 +1,176 @@
+//=============================================================================================================
+/**
+* @file     syntheticsource.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the SyntheticSource class.
+*
+*/
+
+#ifndef SYNTHETICSOURCE_H
+#define SYNTHETICSOURCE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "sendlog.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+namespace RTSERVER
+{
+    class FiffStreamServer;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE RTSERVERBENCH
+//=============================================================================================================
+
+namespace RTSERVERBENCH
+{
+
+//=============================================================================================================
+/**
+* Stands in for a connector: forwards raw buffers of random data to the FiffStreamServer from its own thread,
+* paced by absolute deadlines like the FiffSimulator or as fast as possible. The first sample of every buffer
+* carries its 16 bit sequence number, the send time goes to the SendLog.
+*
+* @brief SyntheticSource produces the raw buffers of a benchmark
+*/
+class SyntheticSource : public QThread
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a SyntheticSource.
+    *
+    * @param[in] p_pServer          The server which forwards the buffers to the clients.
+    * @param[in] p_pSendLog         The log of the send times.
+    * @param[in] p_iChannels        Number of channels.
+    * @param[in] p_dSamplingFreq    Sampling frequency in Hz, 0 for maximal throughput.
+    * @param[in] p_iBufferSize      Samples per buffer.
+    */
+    SyntheticSource(RTSERVER::FiffStreamServer* p_pServer,
+                    SendLog* p_pSendLog,
+                    int p_iChannels,
+                    double p_dSamplingFreq,
+                    int p_iBufferSize);
+
+    //=========================================================================================================
+    /**
+    * Destroys the SyntheticSource, stops the thread first.
+    */
+    ~SyntheticSource();
+
+    //=========================================================================================================
+    /**
+    * Stops forwarding and waits for the thread.
+    */
+    void stop();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of forwarded buffers.
+    *
+    * @return the number of forwarded buffers.
+    */
+    inline int sentBuffers() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the CPU time of the source thread, valid after it finished.
+    *
+    * @return the CPU time in seconds, -1 if not available.
+    */
+    inline double cpuSeconds() const;
+
+protected:
+    //=========================================================================================================
+    /**
+    * Forwards buffers until stop() is called.
+    */
+    virtual void run();
+
+private:
+    RTSERVER::FiffStreamServer* m_pServer;          /**< The server which forwards the buffers. */
+    SendLog*                    m_pSendLog;         /**< The log of the send times. */
+    Eigen::MatrixXf             m_matTemplate;      /**< Random data, copied into every buffer. */
+    double                      m_dSamplingFreq;    /**< Sampling frequency, 0 for maximal throughput. */
+    QAtomicInt                  m_bIsRunning;       /**< Whether the thread keeps forwarding. */
+    QAtomicInt                  m_iSentBuffers;     /**< Number of forwarded buffers. */
+    double                      m_dCpuSeconds;      /**< CPU time of the thread. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int SyntheticSource::sentBuffers() const
+{
+    return m_iSentBuffers.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+inline double SyntheticSource::cpuSeconds() const
+{
+    return m_dCpuSeconds;
+}
+
+} // NAMESPACE
+
+#endif // SYNTHETICSOURCE_H
@@ -905,14 +905,28 @@ void RealTimeMultiSampleArrayModel::updateSpharaOptions(const QString& sSytemTyp
 void RealTimeMultiSampleArrayModel::filterChanged(QList<FilterData> filterData)
 {
     m_filterData = filterData;
+    m_filterDataFIR.clear();
+
+    //IIR filters are not filtered blockwise, their sections are chained and run causally over the stream
+    MatrixXd matSOS(0, 6);
 
     m_iMaxFilterLength = 1;
     for(int i=0; i<filterData.size(); ++i) {
+        if(filterData.at(i).isIIR()) {
+            matSOS.conservativeResize(matSOS.rows() + filterData.at(i).m_matSOS.rows(), 6);
+            matSOS.bottomRows(filterData.at(i).m_matSOS.rows()) = filterData.at(i).m_matSOS;
+            continue;
+        }
+
+        m_filterDataFIR.append(filterData.at(i));
+
         if(m_iMaxFilterLength<filterData.at(i).m_iFilterOrder) {
             m_iMaxFilterLength = filterData.at(i).m_iFilterOrder;
         }
     }
 
+    m_iirFilter.setSections(matSOS);
+
     m_matOverlap.conservativeResize(m_pFiffInfo->chs.size(), m_iMaxFilterLength);
     m_matOverlap.setZero();
 
@@ -1208,13 +1222,34 @@ void RealTimeMultiSampleArrayModel::filterChannelsConcurrently(const MatrixXd &d
     if(iDataIndex >= m_matDataFiltered.cols() || data.cols() < m_iMaxFilterLength)
         return;
 
+    //The IIR filters keep their state between blocks. Zero-phase filtering of every block on its own would show a
+    //jump at each block border. All rows are filtered, so the state of a channel doesn't depend on the selection.
+    MatrixXd matDataIIR;
+    if(m_iirFilter.sectionCount() > 0) {
+        m_iirFilter.filter(data, matDataIIR);
+
+        if(m_filterDataFIR.isEmpty()) {
+            for(qint32 i = 0; i < data.rows(); ++i) {
+                if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name))
+                    m_matDataFiltered.row(i).segment(iDataIndex, data.cols()) = matDataIIR.row(i);
+                else
+                    m_matDataFiltered.row(i).segment(iDataIndex, data.cols()) = data.row(i);
+            }
+
+            m_bDrawFilterFront = true;
+            return;
+        }
+    }
+
+    const MatrixXd& matDataIn = m_iirFilter.sectionCount() > 0 ? matDataIIR : data;
+
     //Generate QList structure which can be handled by the QConcurrent framework
     QList<QPair<QList<FilterData>,QPair<int,RowVectorXd> > > timeData;
     QList<int> notFilterChannelIndex;
 
     for(qint32 i = 0; i < data.rows(); ++i) {
         if(m_filterChannelList.contains(m_pFiffInfo->chs.at(i).ch_name))
-            timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(m_filterData,QPair<int,RowVectorXd>(i,data.row(i))));
+            timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(m_filterDataFIR,QPair<int,RowVectorXd>(i,matDataIn.row(i))));
         else
             notFilterChannelIndex.append(i);
     }
@@ -47,6 +47,7 @@
 #include <fiff/fiff_info.h>
 
 #include <utils/filterTools/filterdata.h>
+#include <utils/filterTools/iirfilter.h>
 #include <utils/mnemath.h>
 #include <utils/detecttrigger.h>
 #include <utils/ioutils.h>
@@ -553,7 +554,7 @@ private:
     qint32                              m_iMaxSamples;                              /**< Max samples per window */
     qint32                              m_iCurrentSample;                           /**< Current sample which holds the current position in the data matrix */
     qint32                              m_iCurrentSampleFreeze;                     /**< Current sample which holds the current position in the data matrix when freezing tool is active */
-    qint32                              m_iMaxFilterLength;                         /**< Max order of the current filters */
+    qint32                              m_iMaxFilterLength;                         /**< Max order of the current FIR filters */
     qint32                              m_iCurrentBlockSize;                        /**< Current block size */
     qint32                              m_iResidual;                                /**< Current amount of samples which were to size */
     int                                 m_iCurrentTriggerChIndex;                   /**< The index of the current trigger channel */
@@ -603,6 +604,8 @@ private:
     QMap<int,QList<QPair<int,double> > >m_qMapDetectedTriggerOldFreeze;             /**< Old detected trigger for each trigger channel while display is freezed. */
     QMap<qint32,float>                  m_qMapChScaling;                            /**< Channel scaling map. */
     QList<FilterData>                   m_filterData;                               /**< List of currently active filters. */
+    QList<FilterData>                   m_filterDataFIR;                            /**< The FIR filters of m_filterData, which are applied blockwise with overlap add. */
+    IIRFilter                           m_iirFilter;                                /**< The chained sections of the IIR filters of m_filterData, which run causally over the stream. */
     QList<RealTimeSampleArrayChInfo>    m_qListChInfo;                              /**< Channel info list. ToDo: Obsolete*/
     QStringList                         m_filterChannelList;                        /**< List of channels which are to be filtered.*/
     QStringList                         m_visibleChannelList;                       /**< List of currently visible channels in the view.*/
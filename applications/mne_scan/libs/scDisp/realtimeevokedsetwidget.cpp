@@ -199,6 +199,7 @@ RealTimeEvokedSetWidget::~RealTimeEvokedSetWidget()
             settings.setValue(QString("RTESW/%1/filterType").arg(t_sRTESWName), (int)filter.m_Type);
             settings.setValue(QString("RTESW/%1/filterDesignMethod").arg(t_sRTESWName), (int)filter.m_designMethod);
             settings.setValue(QString("RTESW/%1/filterTransition").arg(t_sRTESWName), filter.m_dParksWidth*(filter.m_sFreq/2));
+            settings.setValue(QString("RTESW/%1/filterRipple").arg(t_sRTESWName), filter.m_dRipple);
             settings.setValue(QString("RTESW/%1/filterUserDesignActive").arg(t_sRTESWName), m_pFilterWindow->userDesignedFiltersIsActive());
             settings.setValue(QString("RTESW/%1/filterChannelType").arg(t_sRTESWName), m_pFilterWindow->getChannelType());
         }
@@ -458,7 +459,8 @@ void RealTimeEvokedSetWidget::init()
                                                 settings.value(QString("RTESW/%1/filterDesignMethod").arg(t_sRTESWName), 0).toInt(),
                                                 settings.value(QString("RTESW/%1/filterTransition").arg(t_sRTESWName), 5.0).toDouble(),
                                                 settings.value(QString("RTESW/%1/filterUserDesignActive").arg(t_sRTESWName), false).toBool(),
-                                                settings.value(QString("RTESW/%1/filterChannelType").arg(t_sRTESWName), "MEG").toString());
+                                                settings.value(QString("RTESW/%1/filterChannelType").arg(t_sRTESWName), "MEG").toString(),
+                                                settings.value(QString("RTESW/%1/filterRipple").arg(t_sRTESWName), 1.0).toDouble());
 
         //
         //-------- Init channel selection manager --------
@@ -125,6 +125,22 @@ public:
     */
     inline int type() const;
 
+    //=========================================================================================================
+    /**
+    * Returns the trace id of the latest block, see UTILSLIB::Tracer.
+    *
+    * @return the buffer id, 0 if the block is not traced.
+    */
+    inline quint64 traceId() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the trace id of the latest block, see UTILSLIB::Tracer.
+    *
+    * @param[in] iTraceId   the buffer id, 0 if the block is not traced.
+    */
+    inline void setTraceId(quint64 iTraceId);
+
 signals:
     void notify();
 
@@ -142,6 +158,7 @@ private:
     int     m_iMetaTypeId;      /**< QMetaType id of the Measurement */
     QString m_qString_Name;     /**< Name of the Measurement */
     bool    m_bVisibility;      /**< Visibility status */
+    quint64 m_iTraceId;         /**< Trace id of the latest block */
 };
 
 
@@ -201,6 +218,24 @@ inline int NewMeasurement::type() const
     return m_iMetaTypeId;
 }
 
+
+//*************************************************************************************************************
+
+inline quint64 NewMeasurement::traceId() const
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_iTraceId;
+}
+
+
+//*************************************************************************************************************
+
+inline void NewMeasurement::setTraceId(quint64 iTraceId)
+{
+    QMutexLocker locker(&m_qMutex);
+    m_iTraceId = iTraceId;
+}
+
 } //NAMESPACE
 
 Q_DECLARE_METATYPE(SCMEASLIB::NewMeasurement::SPtr)
@@ -46,6 +46,8 @@
 #include "../Management/pluginoutputdata.h"
 #include "../Management/plugininputdata.h"
 
+#include <utils/tracer.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -56,6 +58,7 @@
 #include <QCoreApplication>
 #include <QSharedPointer>
 #include <QAction>
+#include <QAtomicInt>
 
 
 //*************************************************************************************************************
@@ -111,6 +114,12 @@ public:
     typedef QVector< QSharedPointer< PluginInputConnector > > InputConnectorList;  /**< List of input connectors. */
     typedef QVector< QSharedPointer< PluginOutputConnector > > OutputConnectorList; /**< List of output connectors. */
 
+    //=========================================================================================================
+    /**
+    * Constructs the IPlugin.
+    */
+    IPlugin() : m_iTraceStage(-1) {}
+
     //=========================================================================================================
     /**
     * Destroys the IPlugin.
@@ -179,6 +188,15 @@ public:
     */
     virtual QString getName() const = 0;
 
+    //=========================================================================================================
+    /**
+    * Returns the trace stage of the plugin, see UTILSLIB::Tracer. Plugins time the processing of a block with
+    * UTILSLIB::TraceScope traceScope(traceStage()). The stage is registered on the first call only.
+    *
+    * @return the stage id.
+    */
+    inline int traceStage() const;
+
     //=========================================================================================================
     /**
     * True if multi instantiation of plugin is allowed.
@@ -223,6 +241,7 @@ protected:
 
 private:
     QList< QAction* >   m_qListPluginActions;  /**< List of plugin actions */
+    mutable QAtomicInt  m_iTraceStage;         /**< The trace stage id, -1 until traceStage() was called. */
 };
 
 //*************************************************************************************************************
@@ -236,6 +255,21 @@ inline bool IPlugin::multiInstanceAllowed() const
 }
 
 
+//*************************************************************************************************************
+
+inline int IPlugin::traceStage() const
+{
+    //registerStage returns the same id for the same name, so concurrent first calls store the same value
+    int iStage = m_iTraceStage.loadAcquire();
+    if(iStage < 0) {
+        iStage = UTILSLIB::Tracer::registerStage(getName());
+        m_iTraceStage.storeRelease(iStage);
+    }
+
+    return iStage;
+}
+
+
 //*************************************************************************************************************
 
 inline QList< QAction* > IPlugin::getPluginActions()
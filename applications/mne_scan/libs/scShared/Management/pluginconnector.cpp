@@ -41,6 +41,8 @@
 #include "pluginconnector.h"
 #include "../Interfaces/IPlugin.h"
 
+#include <utils/tracer.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -48,6 +50,7 @@
 //=============================================================================================================
 
 using namespace SCSHAREDLIB;
+using namespace UTILSLIB;
 
 
 //*************************************************************************************************************
@@ -60,5 +63,18 @@ PluginConnector::PluginConnector(IPlugin *parent, const QString &name, const QSt
 , m_pPlugin(parent)
 , m_sName(name)
 , m_sDescription(descr)
+, m_iTraceStage(-1)
+{
+}
+
+
+//*************************************************************************************************************
+
+int PluginConnector::traceStage()
 {
+    if(m_iTraceStage < 0) {
+        m_iTraceStage = Tracer::registerStage(QString("%1::%2").arg(m_pPlugin ? m_pPlugin->getName() : QString("Unknown")).arg(m_sName));
+    }
+
+    return m_iTraceStage;
 }
@@ -130,6 +130,15 @@ signals:
 
 
 protected:
+    //=========================================================================================================
+    /**
+     * Returns the trace stage of this connector, see UTILSLIB::Tracer. The stage is registered on first use
+     * and named after the plugin and the connector.
+     *
+     * @return the stage id.
+     */
+    int traceStage();
+
     IPlugin* m_pPlugin;  /**< Plugin to which connector belongs to */
 
     //actual obeserver pattern - think of an other implementation --> currently similiar to OpenWalnut
@@ -139,6 +148,7 @@ protected:
 private:
     QString m_sName;        /**< Connection name */
     QString m_sDescription; /**< Connection description */
+    int     m_iTraceStage;  /**< Trace stage id, -1 until first used */
 
 };
 
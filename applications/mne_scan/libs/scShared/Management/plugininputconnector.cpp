@@ -41,6 +41,8 @@
 #include "plugininputconnector.h"
 #include "../Interfaces/IPlugin.h"
 
+#include <utils/tracer.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -48,6 +50,7 @@
 //=============================================================================================================
 
 using namespace SCSHAREDLIB;
+using namespace UTILSLIB;
 
 
 //*************************************************************************************************************
@@ -81,5 +84,8 @@ bool PluginInputConnector::isOutputConnector() const
 
 void PluginInputConnector::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 {
+    //The receiving plugin works on the traced buffer of the measurement while it handles the block
+    TraceScope traceScope(traceStage(), pMeasurement ? pMeasurement->traceId() : 0);
+
     emit notify(pMeasurement);
 }
@@ -46,6 +46,8 @@
 
 #include <scMeas/newmeasurement.h>
 
+#include <utils/tracer.h>
+
 #include <QDebug>
 #include <QSharedPointer>
 
@@ -90,6 +92,10 @@ PluginOutputData<T>::PluginOutputData(IPlugin *parent, const QString &name, cons
 template <class T>
 void PluginOutputData<T>::update()
 {
+    //Blocks produced while working on a traced buffer continue it, all other blocks start a new one
+    UTILSLIB::TraceBufferScope traceBuffer(traceStage());
+    m_pMeasurement->setTraceId(traceBuffer.bufferId());
+
     emit notify(qSharedPointerDynamicCast<SCMEASLIB::NewMeasurement>(m_pMeasurement));
 }
 
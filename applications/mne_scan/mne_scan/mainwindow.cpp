@@ -42,6 +42,8 @@
 #include <scShared/Management/pluginscenemanager.h>
 #include <scShared/Management/displaymanager.h>
 
+#include <utils/tracer.h>
+
 //GUI
 #include "mainwindow.h"
 #include "runwidget.h"
@@ -72,6 +74,7 @@
 //=============================================================================================================
 
 using namespace MNESCAN;
+using namespace UTILSLIB;
 
 
 //*************************************************************************************************************
@@ -347,6 +350,56 @@ void MainWindow::setMaxLogLevel()
 
 //*************************************************************************************************************
 
+void MainWindow::toggleTracing(bool state)
+{
+    if(state) {
+        Tracer::reset();
+    }
+
+    Tracer::setEnabled(state);
+    m_pActionExportTrace->setEnabled(state);
+
+    writeToLog(state ? tr("latency tracing started") : tr("latency tracing stopped"), _LogKndMessage, _LogLvMin);
+}
+
+//*************************************************************************************************************
+
+void MainWindow::exportTrace()
+{
+    QString path = QFileDialog::getSaveFileName(
+                this,
+                "Save Latency Trace",
+                QStandardPaths::writableLocation(QStandardPaths::DataLocation),
+                tr("Chrome trace (*.json)"));
+
+    if(!path.isEmpty() && Tracer::exportChromeTrace(path)) {
+        writeToLog(tr("latency trace written to %1").arg(path), _LogKndMessage, _LogLvMin);
+    }
+
+    QList<TraceStageStatistics> qListStatistics = Tracer::statistics();
+
+    for(int i = 0; i < qListStatistics.size(); ++i) {
+        const TraceStageStatistics& stats = qListStatistics.at(i);
+
+        if(stats.iCount == 0) {
+            continue;
+        }
+
+        QString sMessage = tr("%1: %2 blocks, duration p50 %3 ms, p99 %4 ms, max %5 ms")
+                .arg(stats.sName).arg(stats.iCount)
+                .arg(stats.dDurationP50, 0, 'f', 3).arg(stats.dDurationP99, 0, 'f', 3).arg(stats.dDurationMax, 0, 'f', 3);
+
+        if(stats.iLatencyCount > 0) {
+            sMessage += tr(", latency since acquisition p50 %1 ms, p99 %2 ms")
+                    .arg(stats.dLatencyP50, 0, 'f', 3).arg(stats.dLatencyP99, 0, 'f', 3);
+        }
+
+        writeToLog(sMessage, _LogKndMessage, _LogLvMin);
+    }
+}
+
+//*************************************************************************************************************
+
 void MainWindow::createActions()
 {
     //File QMenu
@@ -393,6 +446,16 @@ void MainWindow::createActions()
     m_pActionGroupLgLv->addAction(m_pActionMinLgLv);
     m_pActionGroupLgLv->addAction(m_pActionNormLgLv);
     m_pActionGroupLgLv->addAction(m_pActionMaxLgLv);
+    m_pActionTracing = new QAction(tr("Latency &tracing"), this);
+    m_pActionTracing->setCheckable(true);
+    m_pActionTracing->setStatusTip(tr("Trace the latency of every stage of the processing chain"));
+    connect(m_pActionTracing, &QAction::toggled, this, &MainWindow::toggleTracing);
+
+    m_pActionExportTrace = new QAction(tr("&Export latency trace..."), this);
+    m_pActionExportTrace->setEnabled(false);
+    m_pActionExportTrace->setStatusTip(tr("Save the latency trace and log the per stage latency statistics"));
+    connect(m_pActionExportTrace, &QAction::triggered, this, &MainWindow::exportTrace);
+
     if (m_eLogLevelCurrent == _LogLvMin){
         m_pActionMinLgLv->setChecked(true);}
     else if (m_eLogLevelCurrent == _LogLvNormal){
@@ -460,6 +523,9 @@ void MainWindow::createMenus()
     m_pMenuLgLv->addAction(m_pActionNormLgLv);
     m_pMenuLgLv->addAction(m_pActionMaxLgLv);
     m_pMenuView->addSeparator();
+    m_pMenuView->addAction(m_pActionTracing);
+    m_pMenuView->addAction(m_pActionExportTrace);
+    m_pMenuView->addSeparator();
 
     menuBar()->addSeparator();
 
@@ -214,6 +214,9 @@ private:
     QAction*                            m_pActionNormLgLv;          /**< set normal log level */
     QAction*                            m_pActionMaxLgLv;           /**< set maximal log level */
 
+    QAction*                            m_pActionTracing;           /**< switch latency tracing on/off */
+    QAction*                            m_pActionExportTrace;       /**< export latency trace and statistics */
+
     QAction*                            m_pActionHelpContents;      /**< open help contents */
     QAction*                            m_pActionAbout;             /**< show about dialog */
 
@@ -280,6 +283,9 @@ private:
     void setNormalLogLevel();           /**< Sets normal log level as current log level.*/
     void setMaxLogLevel();              /**< Sets maximal log level as current log level.*/
 
+    void toggleTracing(bool state);     /**< Switches the latency tracing of the processing chain on or off.*/
+    void exportTrace();                 /**< Writes the latency trace to a file and the per stage statistics to the log.*/
+
     void startMeasurement();            /**< Runs application.*/
     void stopMeasurement();             /**< Stops application.*/
 
@@ -443,30 +443,6 @@ void MNE::updateRTE(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 }
 
 
-//*************************************************************************************************************
-
-void MNE::updateInvOp(MNEInverseOperator::SPtr p_pInvOp)
-{
-    qDebug() << "MNE::updateInvOp - START";
-    m_pInvOp = p_pInvOp;
-
-    double snr = 3.0;
-    double lambda2 = 1.0 / pow(snr, 2); //ToDO estimate lambda using covariance
-
-    QString method("dSPM"); //"MNE" | "dSPM" | "sLORETA"
-
-    m_qMutex.lock();
-
-    m_pMinimumNorm = MinimumNorm::SPtr(new MinimumNorm(*m_pInvOp.data(), lambda2, method));
-
-    //
-    //   Set up the inverse according to the parameters
-    //
-    m_pMinimumNorm->doInverseSetup(m_iNumAverages,false);
-    m_qMutex.unlock();
-}
-
-
 //*************************************************************************************************************
 
 void MNE::run()
@@ -499,9 +475,16 @@ void MNE::run()
     // Init Real-Time inverse estimator
     //
     m_pRtInvOp = RtInvOp::SPtr(new RtInvOp(m_pFiffInfo, m_pClusteredFwd));
-    connect(m_pRtInvOp.data(), &RtInvOp::invOperatorCalculated,
-            this, &MNE::updateInvOp);
-    m_pMinimumNorm.reset();
+
+    //
+    //   Set up the inverse according to the parameters. RtInvOp prepares the kernels in the background.
+    //
+    double snr = 3.0;
+    double lambda2 = 1.0 / pow(snr, 2); //ToDO estimate lambda using covariance
+
+    QString method("dSPM"); //"MNE" | "dSPM" | "sLORETA"
+
+    m_pRtInvOp->setMinimumNormSettings(method, lambda2, m_iNumAverages, false);
 
     //
     // Start the rt helpers
@@ -559,22 +542,21 @@ void MNE::run()
         qint32 t_evokedSize = m_qVecFiffEvoked.size();
         m_qMutex.unlock();
 
+        //Use the latest prepared operator, a rebuild in progress never blocks this thread
+        MinimumNorm::SPtr pMinimumNorm = m_pRtInvOp->minimumNorm();
+
         if(m_pMatrixDataBuffer)
         {
             //qDebug()<<"MNE::run - Processing RTMSA data";
-            if(m_pMinimumNorm && ((skip_count % m_iDownSample) == 0))
+            if(pMinimumNorm && ((skip_count % m_iDownSample) == 0))
             {
                 MatrixXd rawSegment = m_pMatrixDataBuffer->pop();
 
                 float tmin = 1 / m_pFiffInfo->sfreq;
                 float tstep = 1 / m_pFiffInfo->sfreq;
 
-                m_qMutex.lock();
-
                 //TODO: Add picking here. See evoked part as input.
-                MNESourceEstimate sourceEstimate = m_pMinimumNorm->calculateInverse(rawSegment, tmin, tstep);
-
-                m_qMutex.unlock();
+                MNESourceEstimate sourceEstimate = pMinimumNorm->calculateInverse(rawSegment, tmin, tstep);
 
                 m_pRTSEOutput->data()->setValue(sourceEstimate);
             }
@@ -590,7 +572,7 @@ void MNE::run()
         if(t_evokedSize > 0)
         {
             qDebug() << "MNE::run - Processing RTE data - t_evokedSize" << t_evokedSize;
-            if(m_pMinimumNorm && ((skip_count % m_iDownSample) == 0))
+            if(pMinimumNorm && ((skip_count % m_iDownSample) == 0))
             {
                 m_qMutex.lock();
                 FiffEvoked t_fiffEvoked = m_qVecFiffEvoked[0];
@@ -601,13 +583,9 @@ void MNE::run()
                 float tmin = ((float)t_fiffEvoked.first) / t_fiffEvoked.info.sfreq;
                 float tstep = 1/t_fiffEvoked.info.sfreq;
 
-                m_qMutex.lock();
-
-                t_fiffEvoked = t_fiffEvoked.pick_channels(m_pInvOp->noise_cov->names);
+                t_fiffEvoked = t_fiffEvoked.pick_channels(pMinimumNorm->getPreparedInverseOperator().noise_cov->names);
 
-                MNESourceEstimate sourceEstimate = m_pMinimumNorm->calculateInverse(t_fiffEvoked.data, tmin, tstep);
-
-                m_qMutex.unlock();
+                MNESourceEstimate sourceEstimate = pMinimumNorm->calculateInverse(t_fiffEvoked.data, tmin, tstep);
 
                 m_pRTSEOutput->data()->setValue(sourceEstimate);
             }
@@ -183,14 +183,6 @@ public:
     */
     void updateRTE(SCMEASLIB::NewMeasurement::SPtr pMeasurement);
 
-    //=========================================================================================================
-    /**
-    * Slot to update the inverse operator
-    *
-    * @param[in] p_pInvOp    The inverse operator to update
-    */
-    void updateInvOp(MNEInverseOperator::SPtr p_pInvOp);
-
 signals:
     //=========================================================================================================
     /**
@@ -247,9 +239,7 @@ private:
     QStringList                 m_qListPickChannels;        /**< Channels to pick */
 
     RtInvOp::SPtr               m_pRtInvOp;         /**< Real-time inverse operator. */
-    MNEInverseOperator::SPtr    m_pInvOp;           /**< The inverse operator. */
 
-    MinimumNorm::SPtr           m_pMinimumNorm;     /**< Minimum Norm Estimation. */
     qint32                      m_iDownSample;      /**< Sampling rate */
 
     QString                     m_sAvrType;         /**< The average type */
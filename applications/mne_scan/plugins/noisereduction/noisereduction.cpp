@@ -126,6 +126,7 @@ NoiseReduction::~NoiseReduction()
             settings.setValue(QString("RTNRW/%1/filterType").arg(t_sRTMSAName), (int)filter.m_Type);
             settings.setValue(QString("RTNRW/%1/filterDesignMethod").arg(t_sRTMSAName), (int)filter.m_designMethod);
             settings.setValue(QString("RTNRW/%1/filterTransition").arg(t_sRTMSAName), filter.m_dParksWidth*(filter.m_sFreq/2));
+            settings.setValue(QString("RTNRW/%1/filterRipple").arg(t_sRTMSAName), filter.m_dRipple);
             settings.setValue(QString("RTNRW/%1/filterUserDesignActive").arg(t_sRTMSAName), m_pFilterWindow->userDesignedFiltersIsActive());
             settings.setValue(QString("RTNRW/%1/filterChannelType").arg(t_sRTMSAName), m_pFilterWindow->getChannelType());
         }
@@ -209,6 +210,7 @@ bool NoiseReduction::stop()
     m_pNoiseReductionBuffer->clear();
 
     m_pNoiseReductionBuffer->clear();
+    m_traceIds.clear();
 
     return true;
 }
@@ -286,6 +288,7 @@ void NoiseReduction::update(SCMEASLIB::NewMeasurement::SPtr pMeasurement)
 
         for(unsigned char i = 0; i < m_pRTMSA->getMultiArraySize(); ++i) {
             t_mat = m_pRTMSA->getMultiSampleArray()[i];
+            m_traceIds.push();
             m_pNoiseReductionBuffer->push(&t_mat);
         }
     }
@@ -609,7 +612,8 @@ void NoiseReduction::initFilter()
                                             settings.value(QString("RTNRW/%1/filterDesignMethod").arg(t_sRTMSAName), 0).toInt(),
                                             settings.value(QString("RTNRW/%1/filterTransition").arg(t_sRTMSAName), 5.0).toDouble(),
                                             settings.value(QString("RTNRW/%1/filterUserDesignActive").arg(t_sRTMSAName), false).toBool(),
-                                            settings.value(QString("RTNRW/%1/filterChannelType").arg(t_sRTMSAName), "MEG").toString());
+                                            settings.value(QString("RTNRW/%1/filterChannelType").arg(t_sRTMSAName), "MEG").toString(),
+                                            settings.value(QString("RTNRW/%1/filterRipple").arg(t_sRTMSAName), 1.0).toDouble());
 }
 
 
@@ -735,6 +739,9 @@ void NoiseReduction::run()
         //Dispatch the inputs
         MatrixXd t_mat = m_pNoiseReductionBuffer->pop();
 
+        //The output block continues the trace of the input block
+        TraceScope traceScope(traceStage(), m_traceIds.pop());
+
         m_mutex.lock();
 
         //Do SSP's and compensators here
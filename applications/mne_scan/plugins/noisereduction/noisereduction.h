@@ -54,6 +54,7 @@
 #include <realtime/rtProcessing/rtfilter.h>
 
 #include <utils/generics/circularmatrixbuffer.h>
+#include <utils/tracer.h>
 
 #include <scMeas/newrealtimemultisamplearray.h>
 
@@ -298,6 +299,7 @@ private:
     FIFFLIB::FiffInfo::SPtr                         m_pFiffInfo;                /**< Fiff measurement info.*/
 
     IOBUFFER::CircularMatrixBuffer<double>::SPtr    m_pNoiseReductionBuffer;    /**< Holds incoming data.*/
+    UTILSLIB::TraceIdQueue                          m_traceIds;                 /**< The trace ids of the buffered blocks.*/
 
     NoiseReductionOptionsWidget::SPtr               m_pOptionsWidget;           /**< The noise reduction option widget object.*/
     QAction*                                        m_pActionShowOptionsWidget; /**< The noise reduction option widget action.*/
@@ -91,11 +91,15 @@ RapMusicToolboxSetupWidget::RapMusicToolboxSetupWidget(RapMusicToolbox* toolbox,
     else
         ui.m_qLabel_surfaceStat->setText("loaded");
 
+    ui.m_qSpinBox_WindowBuffers->setValue(m_pRapMusicToolbox->m_iWindowBuffers);
+
     connect(ui.m_qPushButton_About, &QPushButton::released, this, &RapMusicToolboxSetupWidget::showAboutDialog);
     connect(ui.m_qPushButton_FwdFileDialog, &QPushButton::released, this, &RapMusicToolboxSetupWidget::showFwdFileDialog);
     connect(ui.m_qPushButton_AtlasDirDialog, &QPushButton::released, this, &RapMusicToolboxSetupWidget::showAtlasDirDialog);
     connect(ui.m_qPushButton_SurfaceDirDialog, &QPushButton::released, this, &RapMusicToolboxSetupWidget::showSurfaceDirDialog);
     connect(ui.m_qPushButonStartClustering, &QPushButton::released, this, &RapMusicToolboxSetupWidget::clusteringTriggered);
+    connect(ui.m_qSpinBox_WindowBuffers, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+            this, &RapMusicToolboxSetupWidget::setWindowBuffers);
 }
 
 
@@ -134,6 +138,15 @@ void RapMusicToolboxSetupWidget::clusteringTriggered()
 }
 
 
+//*************************************************************************************************************
+
+void RapMusicToolboxSetupWidget::setWindowBuffers(int value)
+{
+    QMutexLocker locker(&m_pRapMusicToolbox->m_qMutex);
+    m_pRapMusicToolbox->m_iWindowBuffers = value;
+}
+
+
 //*************************************************************************************************************
 
 void RapMusicToolboxSetupWidget::showAboutDialog()
@@ -125,6 +125,14 @@ private:
     */
     void clusteringTriggered();
 
+    //=========================================================================================================
+    /**
+    * Sets the number of buffers spanned by the sliding localization window
+    *
+    * @param[in] value  The number of buffers.
+    */
+    void setWindowBuffers(int value);
+
     //=========================================================================================================
     /**
     * Shows the About Dialogs
@@ -78,6 +78,8 @@ RapMusicToolbox::RapMusicToolbox()
 , m_sSurfaceDir("./MNE-sample-data/subjects/sample/surf")
 , m_iNumAverages(10)
 , m_iDownSample(4)
+, m_iWindowBuffers(4)
+, m_iStcSteps(4)
 {
 
 }
@@ -326,7 +328,8 @@ void RapMusicToolbox::run()
     m_bProcessData = true;
     m_qMutex.unlock();
 
-    qint32 skip_count = 0;
+    qint32 t_iBufferSize = 0;
+    qint32 t_iWindowBuffers = 0;
     while(true)
     {
         {
@@ -339,28 +342,57 @@ void RapMusicToolbox::run()
         qint32 t_evokedSize = m_qVecFiffEvoked.size();
         m_qMutex.unlock();
 
-        if(t_evokedSize > 0)
+        if(t_evokedSize > 0 && m_pPwlRapMusic)
         {
-            if(m_pPwlRapMusic && ((skip_count % 10) == 0))
+            m_qMutex.lock();
+            FiffEvoked t_fiffEvoked = m_qVecFiffEvoked[0];
+            m_qVecFiffEvoked.pop_front();
+            qint32 t_iNewWindowBuffers = m_iWindowBuffers;
+            qint32 t_iStcSteps = m_iStcSteps;
+            m_qMutex.unlock();
+
+            //The sliding window spans several buffers, a new buffer length or window length starts a new window
+            const qint32 t_iNumSamples = t_fiffEvoked.data.cols();
+            if(t_iNumSamples != t_iBufferSize || t_iNewWindowBuffers != t_iWindowBuffers)
             {
-                m_qMutex.lock();
-                FiffEvoked t_fiffEvoked = m_qVecFiffEvoked[0];
-                m_pPwlRapMusic->setStcAttr(t_fiffEvoked.data.cols()/4.0,0.0);
-                m_qVecFiffEvoked.pop_front();
-                m_qMutex.unlock();
+                t_iBufferSize = t_iNumSamples;
+                t_iWindowBuffers = t_iNewWindowBuffers;
+                m_pPwlRapMusic->setStcAttr(t_iBufferSize * t_iWindowBuffers, 0.0);
+                m_pPwlRapMusic->resetIncremental();
+            }
 
-                qDebug() << "m_pRapMusic->calculateInverse";
+            //Every buffer is localized in steps through the incremental signal subspace update, so the source
+            //estimate stays time resolved. Each step only adds its samples to the sliding window.
+            float t_fTstep = 1.0f/t_fiffEvoked.info.sfreq;
+            float t_fTmin = t_fiffEvoked.times.size() > 0 ? t_fiffEvoked.times[0] : 0.0f;
+            MNESourceEstimate sourceEstimate;
 
-                MNESourceEstimate sourceEstimate = m_pPwlRapMusic->calculateInverse(t_fiffEvoked);
-                m_pRTSEOutput->data()->setValue(sourceEstimate);
-            }
-            else
+            for(qint32 i = 0; i < t_iStcSteps; ++i)
             {
-                m_qMutex.lock();
-                m_qVecFiffEvoked.pop_front();
-                m_qMutex.unlock();
+                qint32 t_iStart = i * t_iNumSamples / t_iStcSteps;
+                qint32 t_iEnd = (i + 1) * t_iNumSamples / t_iStcSteps;
+                if(t_iEnd <= t_iStart)
+                    continue;
+
+                MNESourceEstimate t_stepEstimate = m_pPwlRapMusic->calculateInverseIncremental(t_fiffEvoked.data.middleCols(t_iStart, t_iEnd - t_iStart),
+                                                                                               t_fTmin + t_iStart * t_fTstep,
+                                                                                               t_fTstep);
+                if(t_stepEstimate.isEmpty())
+                    break;
+
+                if(sourceEstimate.isEmpty())
+                {
+                    sourceEstimate = t_stepEstimate;
+                    sourceEstimate.data = MatrixXd::Zero(t_stepEstimate.data.rows(), t_iNumSamples);
+                    sourceEstimate.times = RowVectorXf::LinSpaced(t_iNumSamples, t_fTmin, t_fTmin + (t_iNumSamples - 1) * t_fTstep);
+                    sourceEstimate.tmin = t_fTmin;
+                }
+
+                sourceEstimate.data.middleCols(t_iStart, t_iEnd - t_iStart) = t_stepEstimate.data;
             }
-            ++skip_count;
+
+            if(!sourceEstimate.isEmpty())
+                m_pRTSEOutput->data()->setValue(sourceEstimate);
         }
     }
 }
@@ -216,6 +216,9 @@ private:
     PwlRapMusic::SPtr           m_pPwlRapMusic;     /**< Powell RAP MUSIC. */
     qint32                      m_iDownSample;      /**< Sampling rate */
 
+    qint32                      m_iWindowBuffers;   /**< Number of buffers spanned by the sliding localization window. */
+    qint32                      m_iStcSteps;        /**< Number of localizations per buffer, i.e. time steps of the source estimate. */
+
 //    RealTimeSourceEstimate::SPtr m_pRTSE_MNE; /**< Source Estimate output channel. */
 };
 
@@ -0,0 +1,226 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Example of a Powell RAP MUSIC scan sharded over worker processes.
+*
+*/
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_evoked.h>
+#include <fiff/fiff.h>
+
+#include <mne/mne.h>
+#include <mne/mne_sourceestimate.h>
+
+#include <inverse/rapMusic/pwlrapmusic.h>
+#include <inverse/rapMusic/pwlrapmusicshardserver.h>
+
+#include <iostream>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QProcess>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNELIB;
+using namespace FIFFLIB;
+using namespace INVERSELIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Command Line Parser
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Sharded Powell RAP-MUSIC Example. Run with --worker on every worker host, or let the coordinator spawn local workers with --spawn.");
+    parser.addHelpOption();
+    QCommandLineOption fwdFileOption("fwd", "Path to forward solution <file>.", "file", "./MNE-sample-data/MEG/sample/sample_audvis-meg-eeg-oct-6-fwd.fif");
+    QCommandLineOption evokedFileOption("ave", "Path to evoked <file>.", "file", "./MNE-sample-data/MEG/sample/sample_audvis-ave.fif");
+    QCommandLineOption numDipolePairsOption("numDip", "<number> of dipole pairs to localize.", "number", "2");
+    QCommandLineOption workerOption("worker", "Run as worker and serve a grid range to a coordinator.");
+    QCommandLineOption portOption("port", "<port> of the worker, first port of spawned workers.", "port", QString::number(PWL_SHARD_DEFAULT_PORT));
+    QCommandLineOption workersOption("workers", "Comma separated <list> of running workers (host:port).", "list", "");
+    QCommandLineOption spawnOption("spawn", "<number> of local worker processes to spawn.", "number", "0");
+    QCommandLineOption compareOption("compare", "Compare against the scan in this process.");
+
+    parser.addOption(fwdFileOption);
+    parser.addOption(evokedFileOption);
+    parser.addOption(numDipolePairsOption);
+    parser.addOption(workerOption);
+    parser.addOption(portOption);
+    parser.addOption(workersOption);
+    parser.addOption(spawnOption);
+    parser.addOption(compareOption);
+    parser.process(app);
+
+    QFile t_fileFwd(parser.value(fwdFileOption));
+    MNEForwardSolution t_Fwd(t_fileFwd);
+    if(t_Fwd.isEmpty())
+        return 1;
+
+    quint16 t_iPort = parser.value(portOption).toUShort();
+    qint32 numDipolePairs = parser.value(numDipolePairsOption).toInt();
+
+    //
+    // Worker - the whole, unclustered forward solution, only the grid range of the coordinator is scanned
+    //
+    if(parser.isSet(workerOption))
+    {
+        PwlRapMusic t_pwlRapMusic(t_Fwd, false, numDipolePairs);
+
+        PwlRapMusicShardServer t_server(t_pwlRapMusic);
+        if(!t_server.listen(QHostAddress::Any, t_iPort))
+        {
+            std::cout << "Listening on port " << t_iPort << " failed." << std::endl;
+            return 1;
+        }
+
+        std::cout << "Worker listening on port " << t_iPort << std::endl;
+
+        return app.exec();
+    }
+
+    //
+    // Coordinator
+    //
+    fiff_int_t setno = 0;
+    QPair<QVariant, QVariant> baseline(QVariant(), 0);
+    QFile t_fileEvoked(parser.value(evokedFileOption));
+    FiffEvoked evoked(t_fileEvoked, setno, baseline);
+    if(evoked.isEmpty())
+        return 1;
+
+    FiffEvoked pickedEvoked = evoked.pick_channels(t_Fwd.info.ch_names);
+
+    QStringList t_qListWorkers;
+    if(!parser.value(workersOption).isEmpty())
+        t_qListWorkers = parser.value(workersOption).split(",", QString::SkipEmptyParts);
+
+    QList<QProcess*> t_qListProcesses;
+    int t_iNumSpawn = parser.value(spawnOption).toInt();
+    for(int i = 0; i < t_iNumSpawn; ++i)
+    {
+        QProcess* t_pProcess = new QProcess(&app);
+        t_pProcess->setProcessChannelMode(QProcess::ForwardedChannels);
+        t_pProcess->start(QCoreApplication::applicationFilePath(), QStringList() << "--worker"
+                                                                                 << "--fwd" << parser.value(fwdFileOption)
+                                                                                 << "--port" << QString::number(t_iPort + i));
+        t_qListProcesses.append(t_pProcess);
+        t_qListWorkers.append(QString("127.0.0.1:%1").arg(t_iPort + i));
+    }
+
+    PwlRapMusic t_pwlRapMusic(t_Fwd, false, numDipolePairs);
+
+    if(!t_qListWorkers.isEmpty())
+    {
+        //Workers need some time to read their forward solution
+        bool t_bConnected = false;
+        for(int t_iTry = 0; t_iTry < 60 && !t_bConnected; ++t_iTry)
+        {
+            t_bConnected = t_pwlRapMusic.connectShards(t_qListWorkers);
+            if(!t_bConnected)
+                QThread::sleep(1);
+        }
+
+        if(!t_bConnected)
+            std::cout << "Workers not available, scanning in this process." << std::endl;
+    }
+
+    QElapsedTimer t_timer;
+    t_timer.start();
+
+    QList< DipolePair<double> > t_RapDipoles;
+    t_pwlRapMusic.calculateInverse(pickedEvoked.data, t_RapDipoles);
+
+    std::cout << "Sharded scan on " << t_qListWorkers.size() << " workers: " << t_timer.elapsed() << " ms" << std::endl;
+    for(int i = 0; i < t_RapDipoles.size(); ++i)
+        std::cout << "Pair " << i+1 << ": " << t_RapDipoles[i].m_iIdx1 << " - " << t_RapDipoles[i].m_iIdx2 << "; Correlation " << t_RapDipoles[i].m_vCorrelation << std::endl;
+
+    if(parser.isSet(compareOption))
+    {
+        t_pwlRapMusic.clearShards();
+
+        t_timer.restart();
+
+        QList< DipolePair<double> > t_RapDipolesLocal;
+        t_pwlRapMusic.calculateInverse(pickedEvoked.data, t_RapDipolesLocal);
+
+        std::cout << "Local scan: " << t_timer.elapsed() << " ms" << std::endl;
+
+        bool t_bEqual = t_RapDipoles.size() == t_RapDipolesLocal.size();
+        for(int i = 0; t_bEqual && i < t_RapDipoles.size(); ++i)
+            t_bEqual = t_RapDipoles[i].m_iIdx1 == t_RapDipolesLocal[i].m_iIdx1 && t_RapDipoles[i].m_iIdx2 == t_RapDipolesLocal[i].m_iIdx2;
+
+        std::cout << (t_bEqual ? "Sharded and local scan found the same pairs." : "Sharded and local scan differ!") << std::endl;
+    }
+
+    t_pwlRapMusic.clearShards();
+
+    for(int i = 0; i < t_qListProcesses.size(); ++i)
+    {
+        t_qListProcesses[i]->kill();
+        t_qListProcesses[i]->waitForFinished();
+    }
+
+    return 0;
+}
@@ -52,7 +52,8 @@ SUBDIRS += \
     ex_read_evoked \
     ex_read_fwd \
     ex_read_raw \
-    ex_read_write_raw
+    ex_read_write_raw \
+    ex_sharded_inverse_pwl_rap_music
 
 !contains(MNECPP_CONFIG, minimalVersion) {
     qtHaveModule(charts) {
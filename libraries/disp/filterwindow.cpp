@@ -69,6 +69,7 @@ FilterWindow::FilterWindow(QWidget *parent, Qt::WindowFlags type)
 , ui(new Ui::FilterWindowWidget)
 , m_iWindowSize(4016)
 , m_iFilterTaps(512)
+, m_iMaxFilterTaps(512)
 , m_dSFreq(600)
 {
     ui->setupUi(this);
@@ -146,8 +147,13 @@ void FilterWindow::setMaxFilterTaps(int iMaxNumberFilterTaps)
     if(iMaxNumberFilterTaps>512)
         iMaxNumberFilterTaps = 512;
 
-    ui->m_spinBox_filterTaps->setMaximum(iMaxNumberFilterTaps);
-    ui->m_spinBox_filterTaps->setMinimum(16);
+    m_iMaxFilterTaps = iMaxNumberFilterTaps;
+
+    //IIR designs use the spin box for the filter order, which has its own range
+    if(ui->m_comboBox_designMethod->currentIndex() < 2) {
+        ui->m_spinBox_filterTaps->setMaximum(iMaxNumberFilterTaps);
+        ui->m_spinBox_filterTaps->setMinimum(16);
+    }
 
     //Update filter depending on new window size
     filterParametersChanged();
@@ -172,7 +178,7 @@ void FilterWindow::setSamplingRate(double dSamplingRate)
 
 //*************************************************************************************************************
 
-void FilterWindow::setFilterParameters(double hp, double lp, int order, int type, int designMethod, double transition, bool activateFilter, const QString &sChannelType)
+void FilterWindow::setFilterParameters(double hp, double lp, int order, int type, int designMethod, double transition, bool activateFilter, const QString &sChannelType, double ripple)
 {
     ui->m_doubleSpinBox_highpass->setValue(lp);
     ui->m_doubleSpinBox_lowpass->setValue(hp);
@@ -191,8 +197,13 @@ void FilterWindow::setFilterParameters(double hp, double lp, int order, int type
         ui->m_comboBox_designMethod->setCurrentText("Tschebyscheff");
     if(designMethod == 1)
         ui->m_comboBox_designMethod->setCurrentText("Cosine");
+    if(designMethod == 3)
+        ui->m_comboBox_designMethod->setCurrentText("Butterworth");
+    if(designMethod == 4)
+        ui->m_comboBox_designMethod->setCurrentText("Chebyshev");
 
     ui->m_doubleSpinBox_transitionband->setValue(transition);
+    ui->m_doubleSpinBox_ripple->setValue(ripple);
 
     for(int i=0; i<m_lActivationCheckBoxList.size(); i++) {
         if(m_lActivationCheckBoxList.at(i)->text() == "Activate user designed filter")
@@ -282,10 +293,14 @@ void FilterWindow::initSpinBoxes()
     connect(ui->m_spinBox_filterTaps,static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged),
                 this,&FilterWindow::filterParametersChanged);
 
+    connect(ui->m_doubleSpinBox_ripple,static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+                this,&FilterWindow::filterParametersChanged);
+
     //Intercept events from the spin boxes to get control over key events
     ui->m_doubleSpinBox_lowpass->installEventFilter(this);
     ui->m_doubleSpinBox_highpass->installEventFilter(this);
     ui->m_doubleSpinBox_transitionband->installEventFilter(this);
+    ui->m_doubleSpinBox_ripple->installEventFilter(this);
 }
 
 
@@ -426,7 +441,7 @@ void FilterWindow::keyPressEvent(QKeyEvent * event)
 
 bool FilterWindow::eventFilter(QObject *obj, QEvent *event)
 {
-    if(obj == ui->m_doubleSpinBox_highpass || obj == ui->m_doubleSpinBox_lowpass || obj == ui->m_doubleSpinBox_transitionband) {
+    if(obj == ui->m_doubleSpinBox_highpass || obj == ui->m_doubleSpinBox_lowpass || obj == ui->m_doubleSpinBox_transitionband || obj == ui->m_doubleSpinBox_ripple) {
         if (event->type() == QEvent::KeyPress) {
             QKeyEvent *keyEvent = static_cast<QKeyEvent *>(event);
 
@@ -553,8 +568,29 @@ void FilterWindow::changeStateSpinBoxes(int currentIndex)
             ui->m_spinBox_filterTaps->setVisible(true);
             ui->m_label_filterTaps->setVisible(true);
             break;
+
+        case 2: //Butterworth
+        case 3: //Chebyshev
+            ui->m_spinBox_filterTaps->setVisible(true);
+            ui->m_label_filterTaps->setVisible(true);
+            break;
+    }
+
+    //IIR designs are parametrized by their order instead of the number of taps
+    if(ui->m_comboBox_designMethod->currentIndex() < 2) {
+        ui->m_label_filterTaps->setText("Filter taps:");
+        ui->m_spinBox_filterTaps->setSingleStep(2);
+        ui->m_spinBox_filterTaps->setRange(16, m_iMaxFilterTaps);
+    } else {
+        ui->m_label_filterTaps->setText("Filter order:");
+        ui->m_spinBox_filterTaps->setSingleStep(1);
+        ui->m_spinBox_filterTaps->setRange(1, 10);
     }
 
+    //The pass band ripple only applies to the Chebyshev design
+    ui->m_doubleSpinBox_ripple->setVisible(ui->m_comboBox_designMethod->currentIndex() == 3);
+    ui->m_label_ripple->setVisible(ui->m_comboBox_designMethod->currentIndex() == 3);
+
     //Change visibility of spin boxes depending on filter type
     switch(ui->m_comboBox_filterType->currentIndex()) {
         case 0: //Bandpass
@@ -612,7 +648,7 @@ void FilterWindow::filterParametersChanged()
 
     //Calculate the needed fft length
     m_iFilterTaps = ui->m_spinBox_filterTaps->value();
-    if(ui->m_spinBox_filterTaps->value()%2 != 0)
+    if(ui->m_spinBox_filterTaps->value()%2 != 0 && ui->m_comboBox_designMethod->currentIndex() < 2)
         m_iFilterTaps--;
 
     int fftLength = m_iWindowSize + ui->m_spinBox_filterTaps->value() * 4; // *2 to take into account the overlap in front and back after the convolution. Another *2 to take into account the appended and prepended data.
@@ -645,6 +681,12 @@ void FilterWindow::filterParametersChanged()
     if(ui->m_comboBox_designMethod->currentText() == "Cosine")
         dMethod = FilterData::Cosine;
 
+    if(ui->m_comboBox_designMethod->currentText() == "Butterworth")
+        dMethod = FilterData::Butterworth;
+
+    if(ui->m_comboBox_designMethod->currentText() == "Chebyshev")
+        dMethod = FilterData::Chebyshev;
+
     //Generate filters
     QSharedPointer<FilterData> userDefinedFilterOperator;
 
@@ -660,7 +702,8 @@ void FilterWindow::filterParametersChanged()
                                                                (double)trans_width/nyquistFrequency,
                                                                samplingFrequency,
                                                                fftLength,
-                                                               dMethod));
+                                                               dMethod,
+                                                               ui->m_doubleSpinBox_ripple->value()));
     }
 
     if(ui->m_comboBox_filterType->currentText() == "Highpass") {
@@ -673,7 +716,8 @@ void FilterWindow::filterParametersChanged()
                                                         (double)trans_width/nyquistFrequency,
                                                         samplingFrequency,
                                                         fftLength,
-                                                        dMethod));
+                                                        dMethod,
+                                                        ui->m_doubleSpinBox_ripple->value()));
     }
 
     if(ui->m_comboBox_filterType->currentText() == "Bandpass") {
@@ -686,7 +730,8 @@ void FilterWindow::filterParametersChanged()
                                   (double)trans_width/nyquistFrequency,
                                   samplingFrequency,
                                   fftLength,
-                                  dMethod));
+                                  dMethod,
+                                  ui->m_doubleSpinBox_ripple->value()));
     }
 
     //Replace old with new filter operator
@@ -168,8 +168,9 @@ public:
     * @param[in] transition         The transition frequency.
     * @param[in] activateFilter     The filter activation flag.
     * @param[in] channelType        the channel Type.
+    * @param[in] ripple             The pass band ripple in dB of the Chebyshev design.
     */
-    void setFilterParameters(double hp, double lp, int order, int type, int designMethod, double transition, bool activateFilter, const QString &sChannelType);
+    void setFilterParameters(double hp, double lp, int order, int type, int designMethod, double transition, bool activateFilter, const QString &sChannelType, double ripple = 1.0);
 
     //=========================================================================================================
     /**
@@ -289,6 +290,7 @@ private:
 
     int                         m_iWindowSize;              /**< The current window size of the loaded fiff data in the DataWindow class.*/
     int                         m_iFilterTaps;              /**< The current number of filter taps.*/
+    int                         m_iMaxFilterTaps;           /**< The maximum number of FIR filter taps.*/
     double                      m_dSFreq;                   /**< The current sampling frequency.*/
 
     FiffInfo::SPtr              m_pFiffInfo;                /**< The current fiffInfo.*/
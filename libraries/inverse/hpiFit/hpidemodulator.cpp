@@ -0,0 +1,251 @@
+//=============================================================================================================
+/**
+* @file     hpidemodulator.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    HPIDemodulator class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "hpidemodulator.h"
+
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Dense>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+using namespace INVERSELIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+HPIDemodulator::HPIDemodulator()
+: m_dSFreq(0.0)
+, m_dTimeConstant(0.2)
+, m_dForget(1.0)
+, m_iBlockSize(0)
+, m_dBlockForget(1.0)
+, m_iSampleCount(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+HPIDemodulator::HPIDemodulator(const QVector<int>& vFreqs, double dSFreq, double dTimeConstant)
+: m_dSFreq(0.0)
+, m_dTimeConstant(0.2)
+, m_dForget(1.0)
+, m_iBlockSize(0)
+, m_dBlockForget(1.0)
+, m_iSampleCount(0)
+{
+    setup(vFreqs, dSFreq, dTimeConstant);
+}
+
+
+//*************************************************************************************************************
+
+void HPIDemodulator::setup(const QVector<int>& vFreqs, double dSFreq, double dTimeConstant)
+{
+    m_dSFreq = dSFreq;
+    m_dTimeConstant = dTimeConstant;
+    m_dForget = (dSFreq > 0.0 && dTimeConstant > 0.0) ? std::exp(-1.0 / (dTimeConstant * dSFreq)) : 1.0;
+
+    m_vecOmega.resize(vFreqs.size());
+
+    for(int i = 0; i < vFreqs.size(); ++i) {
+        m_vecOmega[i] = dSFreq > 0.0 ? 2.0 * M_PI * vFreqs.at(i) / dSFreq : 0.0;
+    }
+
+    m_iBlockSize = 0;
+
+    reset();
+}
+
+
+//*************************************************************************************************************
+
+void HPIDemodulator::reset()
+{
+    m_vecPhase = VectorXd::Zero(m_vecOmega.size());
+    m_matProjection.resize(0, 0);
+    m_matGram = MatrixXd::Zero(2 * m_vecOmega.size(), 2 * m_vecOmega.size());
+    m_iSampleCount = 0;
+}
+
+
+//*************************************************************************************************************
+
+void HPIDemodulator::append(const MatrixXd& matData)
+{
+    const int iNumCoils = m_vecOmega.size();
+
+    if(iNumCoils == 0 || matData.cols() == 0) {
+        return;
+    }
+
+    if(matData.cols() != m_iBlockSize) {
+        computeBasis(matData.cols());
+    }
+
+    if(m_matProjection.rows() != matData.rows()) {
+        reset();
+        m_matProjection = MatrixXd::Zero(matData.rows(), 2 * iNumCoils);
+    }
+
+    //Project the block onto the basis relative to the block start
+    MatrixXd matBlockProjection = matData * m_matBasis;
+
+    //Rotate the projections and the gram matrix to the absolute phase of the block:
+    //sin(phi + wn) = cos(phi) sin(wn) + sin(phi) cos(wn), cos(phi + wn) = cos(phi) cos(wn) - sin(phi) sin(wn)
+    MatrixXd matRotation = MatrixXd::Zero(2 * iNumCoils, 2 * iNumCoils);
+
+    for(int i = 0; i < iNumCoils; ++i) {
+        double dCos = std::cos(m_vecPhase[i]);
+        double dSin = std::sin(m_vecPhase[i]);
+
+        matRotation(i, i) = dCos;
+        matRotation(iNumCoils + i, i) = dSin;
+        matRotation(i, iNumCoils + i) = -dSin;
+        matRotation(iNumCoils + i, iNumCoils + i) = dCos;
+    }
+
+    m_matProjection *= m_dBlockForget;
+    m_matProjection.noalias() += matBlockProjection * matRotation;
+
+    m_matGram *= m_dBlockForget;
+    m_matGram.noalias() += matRotation.transpose() * m_matBlockGram * matRotation;
+
+    //Advance the coil phases to the start of the next block
+    for(int i = 0; i < iNumCoils; ++i) {
+        m_vecPhase[i] = std::fmod(m_vecPhase[i] + m_vecOmega[i] * matData.cols(), 2.0 * M_PI);
+    }
+
+    m_iSampleCount += matData.cols();
+}
+
+
+//*************************************************************************************************************
+
+bool HPIDemodulator::isValid() const
+{
+    return m_vecOmega.size() > 0
+            && m_matProjection.rows() > 0
+            && m_iSampleCount >= m_dTimeConstant * m_dSFreq;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd HPIDemodulator::topographies() const
+{
+    if(m_matProjection.rows() == 0) {
+        return MatrixXd();
+    }
+
+    //Least-squares solution of data = topo * basis^T with the accumulated normal equations
+    return m_matGram.ldlt().solve(m_matProjection.transpose()).transpose();
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd HPIDemodulator::amplitudes() const
+{
+    const int iNumCoils = m_vecOmega.size();
+
+    MatrixXd matTopo = topographies();
+    MatrixXd matAmp(matTopo.rows(), iNumCoils);
+
+    if(matTopo.rows() == 0) {
+        return matAmp;
+    }
+
+    for(int i = 0; i < iNumCoils; ++i) {
+        double dSS = matTopo.col(i).squaredNorm();
+        double dCC = matTopo.col(iNumCoils + i).squaredNorm();
+        double dSC = matTopo.col(i).dot(matTopo.col(iNumCoils + i));
+
+        //Phase which maximizes |cos(phi) * sin_topo + sin(phi) * cos_topo|^2
+        double dPhi = 0.5 * std::atan2(2.0 * dSC, dSS - dCC);
+
+        matAmp.col(i) = std::cos(dPhi) * matTopo.col(i) + std::sin(dPhi) * matTopo.col(iNumCoils + i);
+    }
+
+    return matAmp;
+}
+
+
+//*************************************************************************************************************
+
+void HPIDemodulator::computeBasis(int iBlockSize)
+{
+    const int iNumCoils = m_vecOmega.size();
+
+    m_iBlockSize = iBlockSize;
+    m_dBlockForget = std::pow(m_dForget, iBlockSize);
+
+    MatrixXd matBasis(iBlockSize, 2 * iNumCoils);
+    m_matBasis.resize(iBlockSize, 2 * iNumCoils);
+
+    for(int n = 0; n < iBlockSize; ++n) {
+        //The newest sample has weight one, older samples are forgotten exponentially
+        double dWeight = std::pow(m_dForget, iBlockSize - 1 - n);
+
+        for(int i = 0; i < iNumCoils; ++i) {
+            matBasis(n, i) = std::sin(m_vecOmega[i] * n);
+            matBasis(n, iNumCoils + i) = std::cos(m_vecOmega[i] * n);
+        }
+
+        m_matBasis.row(n) = dWeight * matBasis.row(n);
+    }
+
+    m_matBlockGram = matBasis.transpose() * m_matBasis;
+}
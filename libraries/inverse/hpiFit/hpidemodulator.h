@@ -0,0 +1,220 @@
+//=============================================================================================================
+/**
+* @file     hpidemodulator.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    HPIDemodulator class declaration.
+*
+*/
+
+#ifndef HPIDEMODULATOR_H
+#define HPIDEMODULATOR_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../inverse_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE INVERSELIB
+//=============================================================================================================
+
+namespace INVERSELIB
+{
+
+
+//=============================================================================================================
+/**
+* Continuous HPI amplitude demodulation. Every appended block is projected onto a precomputed sine/cosine basis
+* of the coil frequencies. The projections are rotated to the absolute phase of the block and accumulated with
+* exponential forgetting, which gives the recursive (exponentially weighted) least-squares estimate of the
+* sine/cosine topographies of all coils at the cost of a single matrix product per block. The same model is
+* solved by HPIFit::fitHPI for a single block.
+*
+* @brief Continuous HPI amplitude demodulation.
+*/
+class INVERSESHARED_EXPORT HPIDemodulator
+{
+
+public:
+    typedef QSharedPointer<HPIDemodulator> SPtr;             /**< Shared pointer type for HPIDemodulator. */
+    typedef QSharedPointer<const HPIDemodulator> ConstSPtr;  /**< Const shared pointer type for HPIDemodulator. */
+
+    //=========================================================================================================
+    /**
+    * Default constructor. setup has to be called before data can be appended.
+    */
+    explicit HPIDemodulator();
+
+    //=========================================================================================================
+    /**
+    * Constructs the demodulator for the given coil frequencies.
+    *
+    * @param[in] vFreqs         The frequencies for each coil in Hz.
+    * @param[in] dSFreq         The sampling frequency in Hz.
+    * @param[in] dTimeConstant  The time constant of the exponential forgetting in seconds.
+    */
+    HPIDemodulator(const QVector<int>& vFreqs, double dSFreq, double dTimeConstant = 0.2);
+
+    //=========================================================================================================
+    /**
+    * Sets the coil frequencies, the sampling frequency and the time constant and resets the estimate.
+    *
+    * @param[in] vFreqs         The frequencies for each coil in Hz.
+    * @param[in] dSFreq         The sampling frequency in Hz.
+    * @param[in] dTimeConstant  The time constant of the exponential forgetting in seconds.
+    */
+    void setup(const QVector<int>& vFreqs, double dSFreq, double dTimeConstant = 0.2);
+
+    //=========================================================================================================
+    /**
+    * Discards the accumulated estimate. The next appended block starts a new estimate.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Updates the estimate with the next block of continuous data.
+    *
+    * @param[in] matData    The data block (channels x samples). The number of channels has to stay the same,
+    *                       a change resets the estimate.
+    */
+    void append(const Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+    * Returns whether enough data was accumulated to provide a stable estimate, i.e. at least one time constant.
+    *
+    * @return Whether the amplitudes can be used.
+    */
+    bool isValid() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of samples the estimate was accumulated from since the last reset.
+    *
+    * @return The number of accumulated samples.
+    */
+    inline qint64 sampleCount() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of coils.
+    *
+    * @return The number of coils.
+    */
+    inline int coilCount() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the sine and cosine topographies of all coils (channels x 2*coils, sine components first), as
+    * HPIFit::fitHPI computes them for a single block.
+    *
+    * @return The sine and cosine topographies.
+    */
+    Eigen::MatrixXd topographies() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the in-phase amplitude topography for each coil (channels x coils). The sine and cosine
+    * topography of a coil are combined with the phase which maximizes the topography energy. This makes the
+    * result independent of the coil phase relative to the sampling clock.
+    *
+    * @return The amplitude topographies.
+    */
+    Eigen::MatrixXd amplitudes() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Precomputes the weighted demodulation basis and its gram matrix for the given block size.
+    *
+    * @param[in] iBlockSize     The number of samples per block.
+    */
+    void computeBasis(int iBlockSize);
+
+    Eigen::VectorXd     m_vecOmega;             /**< The coil angular frequencies in radians per sample. */
+    Eigen::VectorXd     m_vecPhase;             /**< The phase of each coil at the first sample of the next block. */
+    double              m_dSFreq;               /**< The sampling frequency in Hz. */
+    double              m_dTimeConstant;        /**< The time constant of the forgetting in seconds. */
+    double              m_dForget;              /**< The forgetting factor per sample. */
+
+    int                 m_iBlockSize;           /**< The block size the basis was computed for. */
+    double              m_dBlockForget;         /**< The forgetting factor per block. */
+    Eigen::MatrixXd     m_matBasis;             /**< The weighted sine/cosine basis relative to the block start (samples x 2*coils). */
+    Eigen::MatrixXd     m_matBlockGram;         /**< The gram matrix of the weighted basis (2*coils x 2*coils). */
+
+    Eigen::MatrixXd     m_matProjection;        /**< The accumulated projections of the data onto the basis (channels x 2*coils). */
+    Eigen::MatrixXd     m_matGram;              /**< The accumulated gram matrix of the basis (2*coils x 2*coils). */
+    qint64              m_iSampleCount;         /**< The number of samples accumulated since the last reset. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline qint64 HPIDemodulator::sampleCount() const
+{
+    return m_iSampleCount;
+}
+
+
+//*************************************************************************************************************
+
+inline int HPIDemodulator::coilCount() const
+{
+    return m_vecOmega.size();
+}
+
+} //NAMESPACE
+
+#endif // HPIDEMODULATOR_H
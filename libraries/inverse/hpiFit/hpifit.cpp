@@ -119,22 +119,13 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
 
     vGof.clear();
 
-    struct SensorInfo sensors;
     struct CoilParam coil;
-    int numCh = pFiffInfo->nchan;
     int samF = pFiffInfo->sfreq;
     int samLoc = t_mat.cols(); // minimum samples required to localize numLoc times in a second
 
-    //Get HPI coils from digitizers and set number of coils
-    int numCoils = 0;
-    QList<FiffDigPoint> lHPIPoints;
-
-    for(int i = 0; i < pFiffInfo->dig.size(); ++i) {
-        if(pFiffInfo->dig[i].kind == FIFFV_POINT_HPI) {
-            numCoils++;
-            lHPIPoints.append(pFiffInfo->dig[i]);
-        }
-    }
+    // Create digitized HPI coil position matrix and set number of coils
+    Eigen::MatrixXd headHPI = getDigitizedCoils(pFiffInfo);
+    int numCoils = headHPI.rows();
 
     //Set coil frequencies
     Eigen::VectorXd coilfreq(numCoils);
@@ -170,29 +161,205 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
         }
     }
 
-    // Create digitized HPI coil position matrix
-    Eigen::MatrixXd headHPI(numCoils,3);
+    // Get the indices of inner layer channels and exclude bad channels.
+    QVector<int> innerind = getInnerChannels(pFiffInfo);
+
+    // Initialize inner layer sensors and the projector restricted to them
+    MatrixXd matProjectorsInnerind;
+    struct SensorInfo sensors = getSensors(innerind, t_matProjectors, pFiffInfo, matProjectorsInnerind);
+
+    //UTILSLIB::IOUtils::write_eigen_matrix(matProjectorsInnerind, "matProjectorsInnerind.txt");
+    //UTILSLIB::IOUtils::write_eigen_matrix(t_matProjectors, "t_matProjectors.txt");
+
+    Eigen::MatrixXd topo(innerind.size(), numCoils*2);
+    Eigen::MatrixXd amp(innerind.size(), numCoils);
+    Eigen::MatrixXd ampC(innerind.size(), numCoils);
+
+    // Get the data from inner layer channels
+    Eigen::MatrixXd innerdata(innerind.size(), t_mat.cols());
+
+    for(int j = 0; j < innerind.size(); ++j) {
+        innerdata.row(j) << t_mat.row(innerind[j]);
+    }
+
+    // Calculate topo
+    topo = innerdata * UTILSLIB::MNEMath::pinv(simsig).transpose(); // topo: # of good inner channel x 8
+
+    // Select sine or cosine component depending on the relative size
+    amp  = topo.leftCols(numCoils); // amp: # of good inner channel x 4
+    ampC = topo.rightCols(numCoils);
+
+    for(int j = 0; j < numCoils; ++j) {
+       float nS = 0.0;
+       float nC = 0.0;
+       for(int i = 0; i < innerind.size(); ++i) {
+           nS += amp(i,j)*amp(i,j);
+           nC += ampC(i,j)*ampC(i,j);
+       }
+
+       if(nC > nS) {
+         for(int i = 0; i < innerind.size(); ++i) {
+           amp(i,j) = ampC(i,j);
+         }
+       }
+    }
+
+    //Find good seed point/starting point for the coil position in 3D space
+    VectorXi chIdcs(numCoils);
+    Eigen::MatrixXd coilPos = getSeedPoints(amp, innerind, pFiffInfo, chIdcs);
+
+    coil.pos = coilPos;
+
+    coil = dipfit(coil, sensors, amp, numCoils, matProjectorsInnerind);
+
+    Eigen::Matrix4d trans = computeTransformation(headHPI, coil.pos);
+    //Eigen::Matrix4d trans = computeTransformation(coil.pos, headHPI);
+
+    // Store the final result
+    storeResult(trans, coil.pos, headHPI, transDevHead, vGof, fittedPointSet);
+
+    if(bDoDebug) {
+        //Calculate GOF
+        MatrixXd temp = coil.pos;
+        temp.conservativeResize(coil.pos.rows(),coil.pos.cols()+1);
+
+        temp.block(0,3,numCoils,1).setOnes();
+        temp.transposeInPlace();
 
-    // check the pFiffInfo->dig information. If dig is empty, set the headHPI is 0;
-    if (lHPIPoints.size() > 0) {
-        for (int i = 0; i < lHPIPoints.size(); ++i) {
-            headHPI(i,0) = lHPIPoints.at(i).r[0];
-            headHPI(i,1) = lHPIPoints.at(i).r[1];
-            headHPI(i,2) = lHPIPoints.at(i).r[2];
+        MatrixXd testPos = trans * temp;
+        MatrixXd diffPos = testPos.block(0,0,3,numCoils) - headHPI.transpose();
+
+        // DEBUG HPI fitting and write debug results
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dpfiterror" << coil.dpfiterror << std::endl << coil.pos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Initial seed point for HPI coils" << std::endl << coil.pos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - temp" << std::endl << temp << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - testPos" << std::endl << testPos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Diff fitted - original" << std::endl << diffPos << std::endl;
+        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dev/head trans" << std::endl << trans << std::endl;
+
+        QString sTimeStamp = QDateTime::currentDateTime().toString("yyMMdd_hhmmss");
+
+        if(!QDir(sHPIResourceDir).exists()) {
+            QDir().mkdir(sHPIResourceDir);
         }
+
+        UTILSLIB::IOUtils::write_eigen_matrix(coilPos, QString("%1/%2_coilPosSeed_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(coil.pos, QString("%1/%2_coilPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(headHPI, QString("%1/%2_headHPI_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        MatrixXd testPosCut = testPos.transpose();//block(0,0,3,4);
+        UTILSLIB::IOUtils::write_eigen_matrix(testPosCut, QString("%1/%2_testPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        MatrixXi idx_mat(chIdcs.rows(),1);
+        idx_mat.col(0) = chIdcs;
+        UTILSLIB::IOUtils::write_eigen_matrix(idx_mat, QString("%1/%2_idx_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        MatrixXd coilFreq_mat(coilfreq.rows(),1);
+        coilFreq_mat.col(0) = coilfreq;
+        UTILSLIB::IOUtils::write_eigen_matrix(coilFreq_mat, QString("%1/%2_coilFreq_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(diffPos, QString("%1/%2_diffPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+
+        UTILSLIB::IOUtils::write_eigen_matrix(amp, QString("%1/%2_amp_mat").arg(sHPIResourceDir).arg(sTimeStamp));
+    }
+}
+
+
+//*************************************************************************************************************
+
+double HPIFit::fitHPIFromAmplitudes(const MatrixXd& matAmplitudes,
+                                    const MatrixXd& t_matProjectors,
+                                    FiffCoordTrans& transDevHead,
+                                    QVector<double>& vGof,
+                                    FiffDigPointSet& fittedPointSet,
+                                    MatrixXd& matCoilPos,
+                                    FiffInfo::SPtr pFiffInfo)
+{
+    vGof.clear();
+
+    Eigen::MatrixXd headHPI = getDigitizedCoils(pFiffInfo);
+    int numCoils = headHPI.rows();
+
+    if(numCoils == 0 || matAmplitudes.cols() < numCoils || matAmplitudes.rows() != pFiffInfo->nchan) {
+        std::cout<<std::endl<< "HPIFit::fitHPIFromAmplitudes - Amplitudes do not match the coils and channels. Returning.";
+        return -1.0;
+    }
+
+    if(t_matProjectors.rows() != pFiffInfo->nchan || t_matProjectors.cols() != pFiffInfo->nchan) {
+        std::cout<<std::endl<< "HPIFit::fitHPIFromAmplitudes - No projector passed. Returning.";
+        return -1.0;
+    }
+
+    QVector<int> innerind = getInnerChannels(pFiffInfo);
+
+    MatrixXd matProjectorsInnerind;
+    struct SensorInfo sensors = getSensors(innerind, t_matProjectors, pFiffInfo, matProjectorsInnerind);
+
+    Eigen::MatrixXd amp(innerind.size(), numCoils);
+
+    for(int j = 0; j < innerind.size(); ++j) {
+        amp.row(j) = matAmplitudes.row(innerind.at(j)).head(numCoils);
+    }
+
+    struct CoilParam coil;
+    coil.mom = Eigen::MatrixXd::Zero(numCoils,3);
+    coil.dpfiterror = Eigen::VectorXd::Zero(numCoils);
+    coil.dpfitnumitr = Eigen::VectorXd::Zero(numCoils);
+
+    //Warm start from the previous positions if available
+    if(matCoilPos.rows() == numCoils && matCoilPos.cols() == 3) {
+        coil.pos = matCoilPos;
     } else {
-        for (int i = 0; i < numCoils; ++i) {
-            headHPI(i,0) = 0;
-            headHPI(i,1) = 0;
-            headHPI(i,2) = 0;
+        VectorXi chIdcs(numCoils);
+        coil.pos = getSeedPoints(amp, innerind, pFiffInfo, chIdcs);
+    }
+
+    coil = dipfit(coil, sensors, amp, numCoils, matProjectorsInnerind);
+
+    matCoilPos = coil.pos;
+
+    Eigen::Matrix4d trans = computeTransformation(headHPI, coil.pos);
+
+    storeResult(trans, coil.pos, headHPI, transDevHead, vGof, fittedPointSet);
+
+    return coil.dpfiterror.maxCoeff();
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd HPIFit::getDigitizedCoils(FiffInfo::SPtr pFiffInfo)
+{
+    QList<FiffDigPoint> lHPIPoints;
+
+    for(int i = 0; i < pFiffInfo->dig.size(); ++i) {
+        if(pFiffInfo->dig[i].kind == FIFFV_POINT_HPI) {
+            lHPIPoints.append(pFiffInfo->dig[i]);
         }
     }
 
-    // Get the indices of inner layer channels and exclude bad channels.
+    Eigen::MatrixXd headHPI(lHPIPoints.size(),3);
+
+    for (int i = 0; i < lHPIPoints.size(); ++i) {
+        headHPI(i,0) = lHPIPoints.at(i).r[0];
+        headHPI(i,1) = lHPIPoints.at(i).r[1];
+        headHPI(i,2) = lHPIPoints.at(i).r[2];
+    }
+
+    return headHPI;
+}
+
+
+//*************************************************************************************************************
+
+QVector<int> HPIFit::getInnerChannels(FiffInfo::SPtr pFiffInfo)
+{
     //TODO: Only supports babymeg and vectorview gradiometeres for hpi fitting.
     QVector<int> innerind(0);
 
-    for (int i = 0; i < numCh; ++i) {
+    for (int i = 0; i < pFiffInfo->nchan; ++i) {
         if(pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_BABY_MAG ||
                 pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T1 ||
                 pFiffInfo->chs[i].chpos.coil_type == FIFFV_COIL_VV_PLANAR_T2 ||
@@ -204,9 +371,20 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
         }
     }
 
+    return innerind;
+}
+
+
+//*************************************************************************************************************
+
+SensorInfo HPIFit::getSensors(const QVector<int>& innerind,
+                              const MatrixXd& t_matProjectors,
+                              FiffInfo::SPtr pFiffInfo,
+                              MatrixXd& matProjectorsInnerind)
+{
     //Create new projector based on the excluded channels, first exclude the rows then the columns
     MatrixXd matProjectorsRows(innerind.size(),t_matProjectors.cols());
-    MatrixXd matProjectorsInnerind(innerind.size(),innerind.size());
+    matProjectorsInnerind.resize(innerind.size(),innerind.size());
 
     for (int i = 0; i < matProjectorsRows.rows(); ++i) {
         matProjectorsRows.row(i) = t_matProjectors.row(innerind.at(i));
@@ -216,10 +394,7 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
         matProjectorsInnerind.col(i) = matProjectorsRows.col(innerind.at(i));
     }
 
-    //UTILSLIB::IOUtils::write_eigen_matrix(matProjectorsInnerind, "matProjectorsInnerind.txt");
-    //UTILSLIB::IOUtils::write_eigen_matrix(t_matProjectors, "t_matProjectors.txt");
-
-    // Initialize inner layer sensors
+    struct SensorInfo sensors;
     sensors.coilpos = Eigen::MatrixXd::Zero(innerind.size(),3);
     sensors.coilori = Eigen::MatrixXd::Zero(innerind.size(),3);
     sensors.tra = Eigen::MatrixXd::Identity(innerind.size(),innerind.size());
@@ -233,42 +408,21 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
         sensors.coilori(i,2) = pFiffInfo->chs[innerind.at(i)].chpos.ez[2];
     }
 
-    Eigen::MatrixXd topo(innerind.size(), numCoils*2);
-    Eigen::MatrixXd amp(innerind.size(), numCoils);
-    Eigen::MatrixXd ampC(innerind.size(), numCoils);
-
-    // Get the data from inner layer channels
-    Eigen::MatrixXd innerdata(innerind.size(), t_mat.cols());
-
-    for(int j = 0; j < innerind.size(); ++j) {
-        innerdata.row(j) << t_mat.row(innerind[j]);
-    }
-
-    // Calculate topo
-    topo = innerdata * UTILSLIB::MNEMath::pinv(simsig).transpose(); // topo: # of good inner channel x 8
+    return sensors;
+}
 
-    // Select sine or cosine component depending on the relative size
-    amp  = topo.leftCols(numCoils); // amp: # of good inner channel x 4
-    ampC = topo.rightCols(numCoils);
 
-    for(int j = 0; j < numCoils; ++j) {
-       float nS = 0.0;
-       float nC = 0.0;
-       for(int i = 0; i < innerind.size(); ++i) {
-           nS += amp(i,j)*amp(i,j);
-           nC += ampC(i,j)*ampC(i,j);
-       }
+//*************************************************************************************************************
 
-       if(nC > nS) {
-         for(int i = 0; i < innerind.size(); ++i) {
-           amp(i,j) = ampC(i,j);
-         }
-       }
-    }
+MatrixXd HPIFit::getSeedPoints(const MatrixXd& amp,
+                               const QVector<int>& innerind,
+                               FiffInfo::SPtr pFiffInfo,
+                               VectorXi& chIdcs)
+{
+    int numCoils = amp.cols();
 
-    //Find good seed point/starting point for the coil position in 3D space
     //Find biggest amplitude per pickup coil (sensor) and store corresponding sensor channel index
-    VectorXi chIdcs(numCoils);
+    chIdcs.resize(numCoils);
 
     for (int j = 0; j < numCoils; j++) {
         double maxVal = 0;
@@ -306,15 +460,20 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
         //std::cout << "HPIFit::fitHPI - Coil " << j << " max value index " << chIdx << std::endl;
     }
 
-    coil.pos = coilPos;
+    return coilPos;
+}
 
-    coil = dipfit(coil, sensors, amp, numCoils, matProjectorsInnerind);
 
-    Eigen::Matrix4d trans = computeTransformation(headHPI, coil.pos);
-    //Eigen::Matrix4d trans = computeTransformation(coil.pos, headHPI);
+//*************************************************************************************************************
 
-    // Store the final result to fiff info
-    // Set final device/head matrix and its inverse to the fiff info
+void HPIFit::storeResult(const Matrix4d& trans,
+                         const MatrixXd& coilPos,
+                         const MatrixXd& headHPI,
+                         FiffCoordTrans& transDevHead,
+                         QVector<double>& vGof,
+                         FiffDigPointSet& fittedPointSet)
+{
+    // Set final device/head matrix and its inverse
     transDevHead.from = 1;
     transDevHead.to = 4;
 
@@ -328,67 +487,30 @@ void HPIFit::fitHPI(const MatrixXd& t_mat,
     transDevHead.invtrans = transDevHead.trans.inverse();
 
     //Calculate GOF
-    MatrixXd temp = coil.pos;
-    temp.conservativeResize(coil.pos.rows(),coil.pos.cols()+1);
+    MatrixXd temp = coilPos;
+    temp.conservativeResize(coilPos.rows(),coilPos.cols()+1);
 
-    temp.block(0,3,numCoils,1).setOnes();
+    temp.block(0,3,coilPos.rows(),1).setOnes();
     temp.transposeInPlace();
 
     MatrixXd testPos = trans * temp;
-    MatrixXd diffPos = testPos.block(0,0,3,numCoils) - headHPI.transpose();
+    MatrixXd diffPos = testPos.block(0,0,3,coilPos.rows()) - headHPI.transpose();
 
     for(int i = 0; i < diffPos.cols(); ++i) {
         vGof.append(diffPos.col(i).norm());
     }
 
     //Generate final fitted points and store in digitizer set
-    for(int i = 0; i < coil.pos.rows(); ++i) {
+    for(int i = 0; i < coilPos.rows(); ++i) {
         FiffDigPoint digPoint;
         digPoint.kind = FIFFV_POINT_EEG;
         digPoint.ident = i;
-        digPoint.r[0] = coil.pos(i,0);
-        digPoint.r[1] = coil.pos(i,1);
-        digPoint.r[2] = coil.pos(i,2);
+        digPoint.r[0] = coilPos(i,0);
+        digPoint.r[1] = coilPos(i,1);
+        digPoint.r[2] = coilPos(i,2);
 
         fittedPointSet << digPoint;
     }
-
-    if(bDoDebug) {
-        // DEBUG HPI fitting and write debug results
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dpfiterror" << coil.dpfiterror << std::endl << coil.pos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Initial seed point for HPI coils" << std::endl << coil.pos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - temp" << std::endl << temp << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - testPos" << std::endl << testPos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - Diff fitted - original" << std::endl << diffPos << std::endl;
-        std::cout << std::endl << std::endl << "HPIFit::fitHPI - dev/head trans" << std::endl << trans << std::endl;
-
-        QString sTimeStamp = QDateTime::currentDateTime().toString("yyMMdd_hhmmss");
-
-        if(!QDir(sHPIResourceDir).exists()) {
-            QDir().mkdir(sHPIResourceDir);
-        }
-
-        UTILSLIB::IOUtils::write_eigen_matrix(coilPos, QString("%1/%2_coilPosSeed_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        UTILSLIB::IOUtils::write_eigen_matrix(coil.pos, QString("%1/%2_coilPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        UTILSLIB::IOUtils::write_eigen_matrix(headHPI, QString("%1/%2_headHPI_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        MatrixXd testPosCut = testPos.transpose();//block(0,0,3,4);
-        UTILSLIB::IOUtils::write_eigen_matrix(testPosCut, QString("%1/%2_testPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        MatrixXi idx_mat(chIdcs.rows(),1);
-        idx_mat.col(0) = chIdcs;
-        UTILSLIB::IOUtils::write_eigen_matrix(idx_mat, QString("%1/%2_idx_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        MatrixXd coilFreq_mat(coilfreq.rows(),1);
-        coilFreq_mat.col(0) = coilfreq;
-        UTILSLIB::IOUtils::write_eigen_matrix(coilFreq_mat, QString("%1/%2_coilFreq_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        UTILSLIB::IOUtils::write_eigen_matrix(diffPos, QString("%1/%2_diffPos_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-
-        UTILSLIB::IOUtils::write_eigen_matrix(amp, QString("%1/%2_amp_mat").arg(sHPIResourceDir).arg(sTimeStamp));
-    }
 }
 
 
@@ -145,7 +145,104 @@ public:
                         bool bDoDebug = false,
                         const QString& sHPIResourceDir = QString("./HPIFittingDebug"));
 
+    //=========================================================================================================
+    /**
+    * Fits the HPI coils to already demodulated amplitude topographies, e.g. from the HPIDemodulator. The coil
+    * positions of a previous fit can be passed as starting point for the dipole fits, which saves most of the
+    * iterations as long as the head moves only a little between two fits.
+    *
+    * @param[in] matAmplitudes      The amplitude topography for each coil (channels x coils).
+    * @param[in] t_matProjectors    The projectors to apply. Bad channels are still included.
+    * @param[out] transDevHead      The final dev head transformation matrix
+    * @param[out] vGof              The goodness of fit in mm for each fitted HPI coil.
+    * @param[out] fittedPointSet    The final fitted positions in form of a digitizer set.
+    * @param[in,out] matCoilPos     The starting coil positions (coils x 3) and the fitted positions on return.
+    *                               If the size does not match the number of coils, the starting positions are
+    *                               derived from the amplitudes as in fitHPI.
+    * @param[in] p_pFiffInfo        Associated Fiff Information.
+    *
+    * @return The maximal relative dipole fit error of all coils, or a negative value if the fit was not possible.
+    */
+    static double fitHPIFromAmplitudes(const Eigen::MatrixXd& matAmplitudes,
+                                       const Eigen::MatrixXd& t_matProjectors,
+                                       FIFFLIB::FiffCoordTrans &transDevHead,
+                                       QVector<double> &vGof,
+                                       FIFFLIB::FiffDigPointSet& fittedPointSet,
+                                       Eigen::MatrixXd& matCoilPos,
+                                       QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
+
 protected:
+    //=========================================================================================================
+    /**
+    * Returns the digitized HPI coil positions in head space (coils x 3).
+    *
+    * @param[in] p_pFiffInfo     Associated Fiff Information.
+    *
+    * @return The digitized HPI coil positions.
+    */
+    static Eigen::MatrixXd getDigitizedCoils(QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
+
+    //=========================================================================================================
+    /**
+    * Returns the indices of the good inner layer channels which are used for the fitting.
+    *
+    * @param[in] p_pFiffInfo     Associated Fiff Information.
+    *
+    * @return The channel indices.
+    */
+    static QVector<int> getInnerChannels(QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
+
+    //=========================================================================================================
+    /**
+    * Returns the sensor information and the projector restricted to the given channels.
+    *
+    * @param[in] innerind           The channel indices.
+    * @param[in] t_matProjectors    The projectors for all channels.
+    * @param[in] p_pFiffInfo        Associated Fiff Information.
+    * @param[out] matProjectorsInnerind The projectors restricted to the given channels.
+    *
+    * @return The sensor information.
+    */
+    static struct SensorInfo getSensors(const QVector<int>& innerind,
+                                        const Eigen::MatrixXd& t_matProjectors,
+                                        QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo,
+                                        Eigen::MatrixXd& matProjectorsInnerind);
+
+    //=========================================================================================================
+    /**
+    * Generates the starting coil positions by projecting the position of the channel with the biggest
+    * amplitude 3cm inwards.
+    *
+    * @param[in] amp            The amplitudes of the given channels (channels x coils).
+    * @param[in] innerind       The channel indices the amplitude rows correspond to.
+    * @param[in] p_pFiffInfo    Associated Fiff Information.
+    * @param[out] chIdcs        The channel index with the biggest amplitude for each coil.
+    *
+    * @return The starting coil positions (coils x 3).
+    */
+    static Eigen::MatrixXd getSeedPoints(const Eigen::MatrixXd& amp,
+                                         const QVector<int>& innerind,
+                                         QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo,
+                                         Eigen::VectorXi& chIdcs);
+
+    //=========================================================================================================
+    /**
+    * Stores the dev head transformation, the goodness of fit and the fitted positions.
+    *
+    * @param[in] trans          The transformation from device to head space.
+    * @param[in] coilPos        The fitted coil positions (coils x 3).
+    * @param[in] headHPI        The digitized coil positions (coils x 3).
+    * @param[out] transDevHead  The final dev head transformation matrix
+    * @param[out] vGof          The goodness of fit in mm for each fitted HPI coil.
+    * @param[out] fittedPointSet The final fitted positions in form of a digitizer set.
+    */
+    static void storeResult(const Eigen::Matrix4d& trans,
+                            const Eigen::MatrixXd& coilPos,
+                            const Eigen::MatrixXd& headHPI,
+                            FIFFLIB::FiffCoordTrans &transDevHead,
+                            QVector<double> &vGof,
+                            FIFFLIB::FiffDigPointSet& fittedPointSet);
+
     //=========================================================================================================
     /**
     * Fits dipoles for the given coils and a given data set.
@@ -38,7 +38,7 @@ include(../../mne-cpp.pri)
 TEMPLATE = lib
 
 QT       -= gui
-QT       += concurrent
+QT       += concurrent network
 
 DEFINES += INVERSE_LIBRARY
 
@@ -100,6 +100,9 @@ SOURCES += \
     minimumNorm/minimumnorm.cpp \
     rapMusic/rapmusic.cpp \
     rapMusic/pwlrapmusic.cpp \
+    rapMusic/signalsubspacetracker.cpp \
+    rapMusic/pwlrapmusicshard.cpp \
+    rapMusic/pwlrapmusicshardserver.cpp \
     rapMusic/dipole.cpp \
     dipoleFit/dipole_fit.cpp \
     dipoleFit/dipole_fit_data.cpp \
@@ -112,7 +115,8 @@ SOURCES += \
     c/mne_meas_data.cpp \
     c/mne_meas_data_set.cpp \
     hpiFit/hpifit.cpp \
-    hpiFit/hpifitdata.cpp
+    hpiFit/hpifitdata.cpp \
+    hpiFit/hpidemodulator.cpp
 
 
 HEADERS +=\
@@ -121,6 +125,9 @@ HEADERS +=\
     minimumNorm/minimumnorm.h \
     rapMusic/rapmusic.h \
     rapMusic/pwlrapmusic.h \
+    rapMusic/signalsubspacetracker.h \
+    rapMusic/pwlrapmusicshard.h \
+    rapMusic/pwlrapmusicshardserver.h \
     rapMusic/dipole.h \
     dipoleFit/analyze_types.h \
     dipoleFit/dipole_fit.h \
@@ -134,7 +141,8 @@ HEADERS +=\
     c/mne_meas_data.h \
     c/mne_meas_data_set.h \
     hpiFit/hpifit.h \
-    hpiFit/hpifitdata.h
+    hpiFit/hpifitdata.h \
+    hpiFit/hpidemodulator.h
 
 
 INCLUDEPATH += $${EIGEN_INCLUDE_DIR}
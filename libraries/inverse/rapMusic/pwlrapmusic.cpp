@@ -39,6 +39,8 @@
 
 #include "pwlrapmusic.h"
 
+#include <utils/mnemath.h>
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -59,15 +61,22 @@ using namespace INVERSELIB;
 
 PwlRapMusic::PwlRapMusic()
 : RapMusic()
+, m_iShardRowTimeout(PWL_SHARD_ROW_TIMEOUT)
 {
+    //Powell scans row wise -> pair indices are computed on the fly
+    m_bUsePairIdxCombinations = false;
 }
 
 
 //*************************************************************************************************************
 
 PwlRapMusic::PwlRapMusic(MNEForwardSolution& p_pFwd, bool p_bSparsed, int p_iN, double p_dThr)
-: RapMusic(p_pFwd, p_bSparsed, p_iN, p_dThr)
+: RapMusic()
+, m_iShardRowTimeout(PWL_SHARD_ROW_TIMEOUT)
 {
+    //Powell scans row wise -> pair indices are computed on the fly
+    m_bUsePairIdxCombinations = false;
+
     //Init
     init(p_pFwd, p_bSparsed, p_iN, p_dThr);
 }
@@ -89,6 +98,52 @@ const char* PwlRapMusic::getName() const
 }
 
 
+//*************************************************************************************************************
+
+bool PwlRapMusic::connectShards(const QStringList &p_qListWorkers, int p_iRowTimeout)
+{
+    clearShards();
+    m_iShardRowTimeout = p_iRowTimeout;
+
+    if(!m_bIsInit || p_qListWorkers.isEmpty())
+        return false;
+
+    double t_dGainNorm = m_ForwardSolution.sol->data.squaredNorm();
+    int t_iNumShards = p_qListWorkers.size();
+
+    for(int i = 0; i < t_iNumShards; ++i)
+    {
+        QStringList t_qListAddress = p_qListWorkers[i].split(":");
+        quint16 t_iPort = t_qListAddress.size() > 1 ? t_qListAddress[1].toUShort() : PWL_SHARD_DEFAULT_PORT;
+
+        //Evenly sized grid ranges -> every shard scans the same number of pairs per Powell row
+        int t_iFirst = (int)(((qint64)m_iNumGridPoints * i) / t_iNumShards);
+        int t_iLast = (int)(((qint64)m_iNumGridPoints * (i+1)) / t_iNumShards);
+
+        PwlRapMusicShard::SPtr t_pShard(new PwlRapMusicShard(t_qListAddress[0], t_iPort));
+        if(!t_pShard->connectToWorker(m_iNumChannels, m_iNumGridPoints, t_dGainNorm, t_iFirst, t_iLast))
+        {
+            std::cout << "Connecting shard " << t_pShard->address().toStdString() << " failed, scanning locally." << std::endl;
+            clearShards();
+            return false;
+        }
+
+        std::cout << "Shard " << t_pShard->address().toStdString() << ": grid points " << t_iFirst << " to " << t_iLast-1 << std::endl;
+        m_qListShards.append(t_pShard);
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void PwlRapMusic::clearShards()
+{
+    m_qListShards.clear();
+}
+
+
 //*************************************************************************************************************
 
 MNESourceEstimate PwlRapMusic::calculateInverse(const FiffEvoked &p_fiffEvoked, bool pick_normal)
@@ -109,51 +164,34 @@ MNESourceEstimate PwlRapMusic::calculateInverse(const MatrixXd &data, float tmin
 
 MNESourceEstimate PwlRapMusic::calculateInverse(const MatrixXd& p_matMeasurement, QList< DipolePair<double> > &p_RapDipoles) const
 {
-    MNESourceEstimate p_SourceEstimate;
+    return RapMusic::calculateInverse(p_matMeasurement, p_RapDipoles);
+}
 
-    //if not initialized -> break
-    if(!m_bIsInit)
-    {
-        std::cout << "RAP MUSIC wasn't initialized!"; //ToDo: catch this earlier
-        return p_SourceEstimate; //false
-    }
 
-    //Test if data are correct
-    if(p_matMeasurement.rows() != m_iNumChannels)
+//*************************************************************************************************************
+
+void PwlRapMusic::calculateInverseFromSubspace(const MatrixXT& p_matPhi_s, int p_iRank, QList< DipolePair<double> > &p_RapDipoles) const
+{
+    //An empty window has no signal subspace to scan
+    if(p_iRank < 1 || p_matPhi_s.cols() == 0)
     {
-        std::cout << "Lead Field channels do not fit to number of measurement channels!"; //ToDo: catch this earlier
-        return p_SourceEstimate;
+        std::cout << "Warning: The measurement data has no signal subspace, no sources are searched." << std::endl;
+        p_RapDipoles.clear();
+        return;
     }
 
-    //Inits
-    //Stop the time for benchmark purpose
-    clock_t start, end;
-    start = clock();
-
-//    //Map HPCMatrix to Eigen Matrix
-//    Eigen::Map<MatrixXT>
-//        t_MappedMatMeasurement(	p_pMatMeasurement->data(),
-//        p_pMatMeasurement->rows(),
-//        p_pMatMeasurement->cols() );
+    int t_iMaxSearch = m_iN < p_iRank ? m_iN : p_iRank; //The smallest of Rank and Iterations
 
-    //Calculate the signal subspace (t_pMatPhi_s)
-    MatrixXT* t_pMatPhi_s = NULL;//(m_iNumChannels, m_iN < t_r ? m_iN : t_r);
-    int t_r = calcPhi_s(/*(MatrixXT)*/p_matMeasurement, t_pMatPhi_s);
-
-    int t_iMaxSearch = m_iN < t_r ? m_iN : t_r; //The smallest of Rank and Iterations
-
-    if (t_r < m_iN)
+    if (p_iRank < m_iN)
     {
-        std::cout << "Warning: Rank " << t_r << " of the measurement data is smaller than the " << m_iN;
+        std::cout << "Warning: Rank " << p_iRank << " of the measurement data is smaller than the " << m_iN;
         std::cout << " sources to find." << std::endl;
         std::cout << "         Searching now for " << t_iMaxSearch << " correlated sources.";
         std::cout << std::endl << std::endl;
     }
 
-    //Create Orthogonal Projector
-    //OrthProj
-    MatrixXT t_matOrthProj(m_iNumChannels,m_iNumChannels);
-    t_matOrthProj.setIdentity();
+    //Orthonormal basis Q_A of the found sources - the orthogonal projector is applied as rank-k update I - Q_A*Q_A^T
+    MatrixXT t_matQ_A(m_iNumChannels, 0);
 
     //A_k_1
     MatrixXT t_matA_k_1(m_iNumChannels, t_iMaxSearch);
@@ -177,120 +215,83 @@ MNESourceEstimate PwlRapMusic::calculateInverse(const MatrixXd& p_matMeasurement
 
     std::cout << "##### Calculation of PWL RAP MUSIC started ######\n\n";
 
-    MatrixXT t_matProj_Phi_s(t_matOrthProj.rows(), t_pMatPhi_s->cols());
-    //new Version: Calculate projection before
-    MatrixXT t_matProj_LeadField(m_ForwardSolution.sol->data.rows(), m_ForwardSolution.sol->data.cols());
+    MatrixXT t_matProj_Phi_s(m_iNumChannels, p_matPhi_s.cols());
+    //Gain matrix in the basis of the found sources (Q_A^T*G) and its correlation with the signal subspace (G^T*U_B)
+    MatrixXT t_matQ_A_T_G;
+    MatrixXT t_matG_T_U_B;
+
+    bool t_bSharded = !m_qListShards.isEmpty();
 
     for(int r = 0; r < t_iMaxSearch ; ++r)
     {
-        t_matProj_Phi_s = t_matOrthProj*(*t_pMatPhi_s);
-
-        //new Version: Calculating Projection before
-        t_matProj_LeadField = t_matOrthProj * m_ForwardSolution.sol->data;//Subtract the found sources from the current found source
+        t_matProj_Phi_s = p_matPhi_s;
+        if(t_matQ_A.cols() > 0)
+            t_matProj_Phi_s.noalias() -= t_matQ_A*(t_matQ_A.transpose()*p_matPhi_s);
 
         //###First Option###
         //Step 1: lt. Mosher 1998 -> Maybe tmp_Proj_Phi_S is already orthogonal -> so no SVD needed -> U_B = tmp_Proj_Phi_S;
-        Eigen::JacobiSVD< MatrixXT > t_svdProj_Phi_S(t_matProj_Phi_s, Eigen::ComputeThinU);
+        VectorXT t_vecSigma_Phi_S;
+        MatrixXT t_matU_Phi_S, t_matV_Phi_S;
+        MNEMath::gram_svd(t_matProj_Phi_s, t_vecSigma_Phi_S, t_matU_Phi_S, t_matV_Phi_S);
         MatrixXT t_matU_B;
-        useFullRank(t_svdProj_Phi_S.matrixU(), t_svdProj_Phi_S.singularValues().asDiagonal(), t_matU_B);
+        useFullRank(t_matU_Phi_S, t_vecSigma_Phi_S.asDiagonal(), t_matU_B);
+
+        //Everything the scan needs from the projector and the signal subspace, computed once per recursion
+        if(t_bSharded)
+        {
+            for(int i = 0; i < m_qListShards.size() && t_bSharded; ++i)
+                t_bSharded = m_qListShards[i]->sendSubspace(t_matQ_A, t_matU_B);
 
-        //Inits
-        VectorXT t_vecRoh(m_iNumLeadFieldCombinations,1);
-        t_vecRoh.setZero();
+            if(!t_bSharded)
+            {
+                std::cout << "Sending the subspace to the shards failed, scanning locally." << std::endl;
+                resetShards();
+            }
+        }
+        if(!t_bSharded)
+            prepareSubcorrScan(t_matQ_A, t_matU_B, t_matQ_A_T_G, t_matG_T_U_B);
 
         //subcorr benchmark
         //Stop the time
         clock_t start_subcorr, end_subcorr;
         start_subcorr = clock();
 
-        double t_val_roh_k;
+        //Powell - the best pair found so far decides the next row, the search ends when a row doesn't improve it
+        double t_val_roh_k = -1;
 
-        //Powell
-        int t_iCurrentRow = 2;
+        int t_iCurrentRow = m_iNumGridPoints > 2 ? 2 : 0;
 
         int t_iIdx1 = -1;
         int t_iIdx2 = -1;
 
-        int t_iMaxIdx_old = -1;
-
-        int t_iMaxFound = 0;
-
-        Eigen::VectorXi t_pVecIdxElements(m_iNumGridPoints);
-
-        PowellIdxVec(t_iCurrentRow, m_iNumGridPoints, t_pVecIdxElements);
-
-        int t_iNumVecElements = m_iNumGridPoints;
-
-        while(t_iMaxFound == 0)
+        while(true)
         {
+            double t_dRowMax = -1;
+            int t_iRowIdx1 = -1;
+            int t_iRowIdx2 = -1;
 
-            //Multithreading correlation calculation
-            #ifdef _OPENMP
-            #pragma omp parallel num_threads(m_iMaxNumThreads)
-            #endif
+            if(t_bSharded && !scanPowellRowSharded(t_iCurrentRow, t_dRowMax, t_iRowIdx1, t_iRowIdx2))
             {
-            #ifdef _OPENMP
-            #pragma omp for
-            #endif
-                for(int i = 0; i < t_iNumVecElements; i++)
-                {
-                    int k = t_pVecIdxElements(i);
-                    //new Version: calculate matrix multiplication before
-                    //Create Lead Field combinations -> It would be better to use a pointer construction, to increase performance
-                    MatrixX6T t_matProj_G(t_matProj_LeadField.rows(),6);
-
-                    int idx1 = m_ppPairIdxCombinations[k]->x1;
-                    int idx2 = m_ppPairIdxCombinations[k]->x2;
-
-                    RapMusic::getGainMatrixPair(t_matProj_LeadField, t_matProj_G, idx1, idx2);
-
-                    t_vecRoh(k) = RapMusic::subcorr(t_matProj_G, t_matU_B);//t_vecRoh holds the correlations roh_k
-                }
+                std::cout << "Shard scan failed, scanning locally." << std::endl;
+                t_bSharded = false;
+                prepareSubcorrScan(t_matQ_A, t_matU_B, t_matQ_A_T_G, t_matG_T_U_B);
             }
 
-    //         if(r==0)
-    //         {
-    //             std::fstream filestr;
-    //             std::stringstream filename;
-    //             filename << "Roh_gold.txt";
-    //
-    //             filestr.open ( filename.str().c_str(), std::fstream::out);
-    //             for(int i = 0; i < m_iNumLeadFieldCombinations; ++i)
-    //             {
-    //               filestr << t_vecRoh(i) << "\n";
-    //             }
-    //             filestr.close();
-    //
-    //             //exit(0);
-    //         }
-
-            //Find the maximum of correlation - can't put this in the for loop because it's running in different threads.
+            if(!t_bSharded)
+                scanPowellRow(t_iCurrentRow, 0, m_iNumGridPoints, t_matQ_A_T_G, t_matG_T_U_B, t_dRowMax, t_iRowIdx1, t_iRowIdx2);
 
-            VectorXT::Index t_iMaxIdx;
-
-            t_val_roh_k = t_vecRoh.maxCoeff(&t_iMaxIdx);//p_vecCor = ^roh_k
-
-            if((int)t_iMaxIdx == t_iMaxIdx_old)
-            {
-                t_iMaxFound = 1;
+            if(t_iIdx1 >= 0 && (t_dRowMax <= t_val_roh_k || (t_iRowIdx1 == t_iIdx1 && t_iRowIdx2 == t_iIdx2)))
                 break;
-            }
-            else
-            {
-                t_iMaxIdx_old = t_iMaxIdx;
-                //get positions in sparsed leadfield from index combinations;
-                t_iIdx1 = m_ppPairIdxCombinations[t_iMaxIdx]->x1;
-                t_iIdx2 = m_ppPairIdxCombinations[t_iMaxIdx]->x2;
-            }
 
+            t_val_roh_k = t_dRowMax;
+            t_iIdx1 = t_iRowIdx1;
+            t_iIdx2 = t_iRowIdx2;
 
             //set new index
             if(t_iIdx1 == t_iCurrentRow)
                 t_iCurrentRow = t_iIdx2;
             else
                 t_iCurrentRow = t_iIdx1;
-
-            PowellIdxVec(t_iCurrentRow, m_iNumGridPoints, t_pVecIdxElements);
         }
 
         //subcorr benchmark
@@ -308,10 +309,9 @@ MNESourceEstimate PwlRapMusic::calculateInverse(const MatrixXd& p_matMeasurement
         MatrixX6T t_matG_k_1(m_ForwardSolution.sol->data.rows(),6);
         RapMusic::getGainMatrixPair(m_ForwardSolution.sol->data, t_matG_k_1, t_iIdx1, t_iIdx2);
 
-        MatrixX6T t_matProj_G_k_1(t_matOrthProj.rows(), t_matG_k_1.cols());
-        t_matProj_G_k_1 = t_matOrthProj * t_matG_k_1;//Subtract the found sources from the current found source
-//         MatrixX6T t_matProj_G_k_1(t_matProj_LeadField.rows(), 6);
-//         getLeadFieldPair(t_matProj_LeadField, t_matProj_G_k_1, t_iIdx1, t_iIdx2);
+        MatrixX6T t_matProj_G_k_1 = t_matG_k_1;
+        if(t_matQ_A.cols() > 0)
+            t_matProj_G_k_1.noalias() -= t_matQ_A*(t_matQ_A.transpose()*t_matG_k_1);//Subtract the found sources from the current found source
 
         //Calculate source direction
         //source direction (p_pMatPhi) for current source r (phi_k_1)
@@ -332,24 +332,101 @@ MNESourceEstimate PwlRapMusic::calculateInverse(const MatrixXd& p_matMeasurement
         //Calculate A_k_1 = [a_theta_1..a_theta_k_1] matrix for subtraction of found source
         RapMusic::calcA_k_1(t_matG_k_1, t_vec_phi_k_1, r, t_matA_k_1);
 
-        //Calculate new orthogonal Projector (Pi_k_1)
-        calcOrthProj(t_matA_k_1, t_matOrthProj);
+        //Update the orthonormal basis of the found sources (replaces the full projector Pi_k_1)
+        RapMusic::calcOrthBasis(t_matA_k_1.leftCols(r+1), t_matQ_A);
 
         //garbage collecting
         //ToDo
     }
 
     std::cout << "##### Calculation of PWL RAP MUSIC completed ######"<< std::endl << std::endl << std::endl;
+}
+
+
+//*************************************************************************************************************
+
+void PwlRapMusic::scanPowellRow(int p_iRow, int p_iFirst, int p_iLast,
+                                const MatrixXT& p_matQ_A_T_G, const MatrixXT& p_matG_T_U_B,
+                                double &p_dMaxCorr, int &p_iIdx1, int &p_iIdx2) const
+{
+    p_dMaxCorr = -1;
+    p_iIdx1 = -1;
+    p_iIdx2 = -1;
+
+    int t_iNumElements = p_iLast - p_iFirst;
+    if(t_iNumElements <= 0)
+        return;
+
+    VectorXT t_vecRoh(t_iNumElements);
+
+    //Multithreading correlation calculation
+    #ifdef _OPENMP
+    #pragma omp parallel for num_threads(m_iMaxNumThreads)
+    #endif
+    for(int i = 0; i < t_iNumElements; ++i)
+    {
+        int j = p_iFirst + i;
+        t_vecRoh(i) = j < p_iRow ? subcorrScan(j, p_iRow, p_matQ_A_T_G, p_matG_T_U_B)
+                                 : subcorrScan(p_iRow, j, p_matQ_A_T_G, p_matG_T_U_B);
+    }
+
+    //Find the maximum of correlation - can't put this in the for loop because it's running in different threads.
+    VectorXT::Index t_iMaxIdx;
+    p_dMaxCorr = t_vecRoh.maxCoeff(&t_iMaxIdx);
 
-    end = clock();
+    int j = p_iFirst + (int)t_iMaxIdx;
+    p_iIdx1 = j < p_iRow ? j : p_iRow;
+    p_iIdx2 = j < p_iRow ? p_iRow : j;
+}
+
+
+//*************************************************************************************************************
 
-    float t_fElapsedTime = ( (float)(end-start) / (float)CLOCKS_PER_SEC ) * 1000.0f;
-    std::cout << "Total Time Elapsed: " << t_fElapsedTime << " ms" << std::endl << std::endl;
+bool PwlRapMusic::scanPowellRowSharded(int p_iRow, double &p_dMaxCorr, int &p_iIdx1, int &p_iIdx2) const
+{
+    //Send all requests first -> the shards scan their ranges at the same time
+    for(int i = 0; i < m_qListShards.size(); ++i)
+    {
+        if(!m_qListShards[i]->requestRow(p_iRow))
+        {
+            resetShards();
+            return false;
+        }
+    }
 
-    //garbage collecting
-    delete t_pMatPhi_s;
+    p_dMaxCorr = -1;
+    p_iIdx1 = -1;
+    p_iIdx2 = -1;
 
-    return p_SourceEstimate;
+    for(int i = 0; i < m_qListShards.size(); ++i)
+    {
+        double t_dCorr;
+        int t_iIdx1, t_iIdx2;
+        //A failed shard leaves the replies of the others in their sockets -> reset all before giving up
+        if(!m_qListShards[i]->readRowResult(t_dCorr, t_iIdx1, t_iIdx2, m_iShardRowTimeout))
+        {
+            resetShards();
+            return false;
+        }
+
+        if(t_iIdx1 >= 0 && t_dCorr > p_dMaxCorr)
+        {
+            p_dMaxCorr = t_dCorr;
+            p_iIdx1 = t_iIdx1;
+            p_iIdx2 = t_iIdx2;
+        }
+    }
+
+    return p_iIdx1 >= 0;
+}
+
+
+//*************************************************************************************************************
+
+void PwlRapMusic::resetShards() const
+{
+    for(int i = 0; i < m_qListShards.size(); ++i)
+        m_qListShards[i]->reset();
 }
 
 
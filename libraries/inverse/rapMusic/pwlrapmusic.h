@@ -42,6 +42,7 @@
 
 #include "../inverse_global.h"
 #include "rapmusic.h"
+#include "pwlrapmusicshard.h"
 
 #include "dipole.h"
 
@@ -49,6 +50,8 @@
 #include <mne/mne_sourceestimate.h>
 #include <time.h>
 
+#include <QList>
+#include <QStringList>
 #include <QVector>
 
 
@@ -95,6 +98,8 @@ using namespace MNELIB;
 */
 class INVERSESHARED_EXPORT PwlRapMusic : public RapMusic
 {
+    friend class PwlRapMusicShardServer;
+
 public:
 
     //=========================================================================================================
@@ -117,6 +122,26 @@ public:
 
     virtual ~PwlRapMusic();
 
+    //=========================================================================================================
+    /**
+    * Distributes the Powell scan over worker processes, each running a PwlRapMusicShardServer with the same
+    * forward solution. The grid points are split evenly over the workers, every Powell row is scanned by all
+    * workers at once and the best pair of the row is merged here. If a worker fails or doesn't reply within
+    * the row timeout, all workers are disconnected and the scan continues in this process.
+    *
+    * @param[in] p_qListWorkers Addresses of the workers as host:port (port defaults to 4219).
+    * @param[in] p_iRowTimeout  Timeout in ms for the result of a Powell row.
+    *
+    * @return true if all workers accepted their shard, false otherwise (no sharding is used then).
+    */
+    bool connectShards(const QStringList &p_qListWorkers, int p_iRowTimeout = PWL_SHARD_ROW_TIMEOUT);
+
+    //=========================================================================================================
+    /**
+    * Disconnects the workers, the scan runs in this process again.
+    */
+    void clearShards();
+
     //=========================================================================================================
     /**
     *
@@ -146,6 +171,50 @@ public:
 
     virtual MNESourceEstimate calculateInverse(const MatrixXd& p_matMeasurement, QList< DipolePair<double> > &p_RapDipoles) const;
 
+protected:
+    virtual void calculateInverseFromSubspace(const MatrixXT& p_matPhi_s, int p_iRank, QList< DipolePair<double> > &p_RapDipoles) const;
+
+    //=========================================================================================================
+    /**
+    * Scans the pairs (p_iRow, j) of a Powell row for j in [p_iFirst, p_iLast).
+    *
+    * @param[in] p_iRow         The Powell row (grid point).
+    * @param[in] p_iFirst       First grid point to combine with the row.
+    * @param[in] p_iLast        Grid point behind the last one to combine with the row.
+    * @param[in] p_matQ_A_T_G   The gain matrix in the basis of the found sources Q_A^T*G.
+    * @param[in] p_matG_T_U_B   The correlation of the gain matrix with the signal subspace G^T*U_B.
+    * @param[out] p_dMaxCorr    The best correlation of the scanned pairs (-1 if the range is empty).
+    * @param[out] p_iIdx1       The smaller grid point of the best pair.
+    * @param[out] p_iIdx2       The larger grid point of the best pair.
+    */
+    void scanPowellRow(int p_iRow, int p_iFirst, int p_iLast,
+                       const MatrixXT& p_matQ_A_T_G, const MatrixXT& p_matG_T_U_B,
+                       double &p_dMaxCorr, int &p_iIdx1, int &p_iIdx2) const;
+
+    //=========================================================================================================
+    /**
+    * Scans a Powell row on all shards and merges their results.
+    *
+    * @param[in] p_iRow         The Powell row (grid point).
+    * @param[out] p_dMaxCorr    The best correlation of the row.
+    * @param[out] p_iIdx1       The smaller grid point of the best pair.
+    * @param[out] p_iIdx2       The larger grid point of the best pair.
+    *
+    * @return true if all shards replied, false otherwise. On failure all shards are reset, so no reply of
+    *         this row is left for the next one.
+    */
+    bool scanPowellRowSharded(int p_iRow, double &p_dMaxCorr, int &p_iIdx1, int &p_iIdx2) const;
+
+    //=========================================================================================================
+    /**
+    * Resets all shards after a failed request.
+    */
+    void resetShards() const;
+
+    QList<PwlRapMusicShard::SPtr> m_qListShards;    /**< Workers of the sharded scan, empty if the scan runs locally. */
+    int m_iShardRowTimeout;                         /**< Timeout in ms for the result of a Powell row. */
+
+public:
     static int PowellOffset(int p_iRow, int p_iNumPoints);
 
     static void PowellIdxVec(int p_iRow, int p_iNumPoints, Eigen::VectorXi& p_pVecElements);
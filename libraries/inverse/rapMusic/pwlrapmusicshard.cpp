@@ -0,0 +1,302 @@
+//=============================================================================================================
+/**
+* @file     pwlrapmusicshard.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Implementation of the PwlRapMusicShard Class.
+*
+*/
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "pwlrapmusicshard.h"
+
+#include <iostream>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QTcpSocket>
+#include <QtEndian>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace INVERSELIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+PwlRapMusicShard::PwlRapMusicShard(const QString &p_sHost, quint16 p_iPort)
+: m_pSocket(new QTcpSocket)
+, m_sHost(p_sHost)
+, m_iPort(p_iPort)
+, m_iFirst(0)
+, m_iLast(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+bool PwlRapMusicShard::connectToWorker(int p_iNumChannels, int p_iNumGridPoints, double p_dGainNorm, int p_iFirst, int p_iLast, int p_iMsecs)
+{
+    m_iFirst = p_iFirst;
+    m_iLast = p_iLast;
+    m_receiveBuffer.clear();
+
+    if(m_pSocket->state() != QAbstractSocket::ConnectedState)
+    {
+        m_pSocket->connectToHost(m_sHost, m_iPort);
+        if(!m_pSocket->waitForConnected(p_iMsecs))
+        {
+            std::cout << "Shard " << address().toStdString() << ": " << m_pSocket->errorString().toStdString() << std::endl;
+            return false;
+        }
+    }
+
+    QByteArray t_payload;
+    QDataStream t_out(&t_payload, QIODevice::WriteOnly);
+    t_out << (qint32)PWL_SHARD_HELLO << (qint32)p_iNumChannels << (qint32)p_iNumGridPoints << p_dGainNorm << (qint32)p_iFirst << (qint32)p_iLast;
+
+    if(!writeFrame(m_pSocket.data(), t_payload))
+        return false;
+
+    QByteArray t_reply;
+    if(!waitForFrame(t_reply, p_iMsecs))
+    {
+        std::cout << "Shard " << address().toStdString() << ": no reply from worker." << std::endl;
+        return false;
+    }
+
+    QDataStream t_in(t_reply);
+    qint32 t_iCmd = 0;
+    bool t_bAccepted = false;
+    t_in >> t_iCmd >> t_bAccepted;
+
+    if(t_iCmd != PWL_SHARD_HELLO_ACK || !t_bAccepted)
+    {
+        std::cout << "Shard " << address().toStdString() << ": the forward solution of the worker doesn't match." << std::endl;
+        m_pSocket->disconnectFromHost();
+        return false;
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool PwlRapMusicShard::sendSubspace(const MatrixXd &p_matQ_A, const MatrixXd &p_matU_B)
+{
+    QByteArray t_payload;
+    QDataStream t_out(&t_payload, QIODevice::WriteOnly);
+    t_out << (qint32)PWL_SHARD_SUBSPACE;
+    writeMatrix(t_out, p_matQ_A);
+    writeMatrix(t_out, p_matU_B);
+
+    return writeFrame(m_pSocket.data(), t_payload);
+}
+
+
+//*************************************************************************************************************
+
+bool PwlRapMusicShard::requestRow(int p_iRow)
+{
+    QByteArray t_payload;
+    QDataStream t_out(&t_payload, QIODevice::WriteOnly);
+    t_out << (qint32)PWL_SHARD_SCAN_ROW << (qint32)p_iRow;
+
+    return writeFrame(m_pSocket.data(), t_payload);
+}
+
+
+//*************************************************************************************************************
+
+bool PwlRapMusicShard::readRowResult(double &p_dCorr, int &p_iIdx1, int &p_iIdx2, int p_iMsecs)
+{
+    QByteArray t_reply;
+    if(!waitForFrame(t_reply, p_iMsecs))
+        return false;
+
+    QDataStream t_in(t_reply);
+    qint32 t_iCmd = 0, t_iIdx1 = -1, t_iIdx2 = -1;
+    double t_dCorr = 0;
+    t_in >> t_iCmd >> t_dCorr >> t_iIdx1 >> t_iIdx2;
+
+    if(t_iCmd != PWL_SHARD_ROW_RESULT || t_in.status() != QDataStream::Ok)
+        return false;
+
+    p_dCorr = t_dCorr;
+    p_iIdx1 = t_iIdx1;
+    p_iIdx2 = t_iIdx2;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool PwlRapMusicShard::isConnected() const
+{
+    return m_pSocket->state() == QAbstractSocket::ConnectedState;
+}
+
+
+//*************************************************************************************************************
+
+QString PwlRapMusicShard::address() const
+{
+    return QString("%1:%2").arg(m_sHost).arg(m_iPort);
+}
+
+
+//*************************************************************************************************************
+
+void PwlRapMusicShard::reset()
+{
+    m_pSocket->abort();
+    m_receiveBuffer.clear();
+}
+
+
+//*************************************************************************************************************
+
+bool PwlRapMusicShard::writeFrame(QTcpSocket* p_pSocket, const QByteArray &p_payload)
+{
+    if(p_pSocket->state() != QAbstractSocket::ConnectedState)
+        return false;
+
+    uchar t_size[4];
+    qToBigEndian<quint32>((quint32)p_payload.size(), t_size);
+
+    if(p_pSocket->write((const char*)t_size, 4) != 4 || p_pSocket->write(p_payload) != p_payload.size())
+        return false;
+
+    p_pSocket->flush();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool PwlRapMusicShard::takeFrame(QByteArray &p_buffer, QByteArray &p_payload)
+{
+    if(p_buffer.size() < 4)
+        return false;
+
+    quint32 t_iSize = qFromBigEndian<quint32>((const uchar*)p_buffer.constData());
+    if((quint32)p_buffer.size() - 4 < t_iSize)
+        return false;
+
+    p_payload = p_buffer.mid(4, t_iSize);
+    p_buffer.remove(0, 4 + t_iSize);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void PwlRapMusicShard::writeMatrix(QDataStream &p_stream, const MatrixXd &p_mat)
+{
+    p_stream << (qint32)p_mat.rows() << (qint32)p_mat.cols();
+    for(qint32 j = 0; j < p_mat.cols(); ++j)
+        for(qint32 i = 0; i < p_mat.rows(); ++i)
+            p_stream << p_mat(i,j);
+}
+
+
+//*************************************************************************************************************
+
+bool PwlRapMusicShard::readMatrix(QDataStream &p_stream, MatrixXd &p_mat)
+{
+    qint32 t_iRows = 0, t_iCols = 0;
+    p_stream >> t_iRows >> t_iCols;
+
+    p_mat.resize(0,0);
+
+    if(p_stream.status() != QDataStream::Ok || t_iRows < 0 || t_iCols < 0)
+        return false;
+
+    //Check the dimensions before allocating, the payload has to hold all elements
+    qint64 t_iNumElements = (qint64)t_iRows * (qint64)t_iCols;
+    if(t_iNumElements > PWL_SHARD_MAX_MATRIX_SIZE
+            || !p_stream.device()
+            || p_stream.device()->bytesAvailable() < t_iNumElements * (qint64)sizeof(double))
+    {
+        p_stream.setStatus(QDataStream::ReadCorruptData);
+        return false;
+    }
+
+    p_mat.resize(t_iRows, t_iCols);
+    for(qint32 j = 0; j < t_iCols; ++j)
+        for(qint32 i = 0; i < t_iRows; ++i)
+            p_stream >> p_mat(i,j);
+
+    if(p_stream.status() != QDataStream::Ok)
+    {
+        p_mat.resize(0,0);
+        return false;
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool PwlRapMusicShard::waitForFrame(QByteArray &p_payload, int p_iMsecs)
+{
+    while(!takeFrame(m_receiveBuffer, p_payload))
+    {
+        if(m_pSocket->bytesAvailable() == 0 && !m_pSocket->waitForReadyRead(p_iMsecs))
+        {
+            std::cout << "Shard " << address().toStdString() << ": " << m_pSocket->errorString().toStdString() << std::endl;
+            return false;
+        }
+
+        m_receiveBuffer.append(m_pSocket->readAll());
+    }
+
+    return true;
+}
@@ -0,0 +1,305 @@
+//=============================================================================================================
+/**
+* @file     pwlrapmusicshard.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    PwlRapMusicShard class declaration.
+*
+*/
+#ifndef PWLRAPMUSICSHARD_H
+#define PWLRAPMUSICSHARD_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../inverse_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QSharedPointer>
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class QTcpSocket;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE INVERSELIB
+//=============================================================================================================
+
+namespace INVERSELIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// SOME DEFINES
+//=============================================================================================================
+
+#define PWL_SHARD_DEFAULT_PORT  4219    /**< Default port of a PwlRapMusicShardServer */
+#define PWL_SHARD_MAX_MATRIX_SIZE   (1 << 24)   /**< Maximal number of elements of a received matrix */
+#define PWL_SHARD_ROW_TIMEOUT   10000   /**< Default timeout in ms for the result of a Powell row */
+
+//=============================================================================================================
+/**
+* Commands of the shard protocol. Every message is a frame of a quint32 payload size followed by the payload,
+* which starts with the qint32 command.
+*/
+enum PwlShardCommand
+{
+    PWL_SHARD_HELLO = 1,    /**< Coordinator -> worker: channels, grid points, gain norm, grid range of the shard. */
+    PWL_SHARD_HELLO_ACK,    /**< Worker -> coordinator: whether the worker forward solution matches. */
+    PWL_SHARD_SUBSPACE,     /**< Coordinator -> worker: Q_A and U_B of the current recursion step. */
+    PWL_SHARD_SCAN_ROW,     /**< Coordinator -> worker: Powell row to scan. */
+    PWL_SHARD_ROW_RESULT    /**< Worker -> coordinator: best correlation and pair of the shard. */
+};
+
+
+//=============================================================================================================
+/**
+* Coordinator side of a Powell RAP MUSIC worker. A shard owns the grid points [first, last) of the pair
+* index space: for every Powell row it evaluates the pairs (row, j) with j inside its range and returns its
+* best correlation. The worker process holds the same forward solution and runs a PwlRapMusicShardServer.
+*
+* Requests are split in send and read, so a coordinator can keep all shards busy at once. The socket is
+* used blocking, a shard has to be connected and used from the same thread.
+*
+* @brief Remote grid range of a sharded Powell RAP MUSIC scan.
+*/
+class INVERSESHARED_EXPORT PwlRapMusicShard
+{
+public:
+    typedef QSharedPointer<PwlRapMusicShard> SPtr;            /**< Shared pointer type for PwlRapMusicShard. */
+    typedef QSharedPointer<const PwlRapMusicShard> ConstSPtr; /**< Const shared pointer type for PwlRapMusicShard. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a shard handle of the worker at the given address.
+    *
+    * @param[in] p_sHost    Host name or IP of the worker.
+    * @param[in] p_iPort    Port of the worker.
+    */
+    PwlRapMusicShard(const QString &p_sHost, quint16 p_iPort = PWL_SHARD_DEFAULT_PORT);
+
+    //=========================================================================================================
+    /**
+    * Connects to the worker and assigns the grid range. The worker checks the dimensions and the norm of the
+    * gain matrix against its own forward solution.
+    *
+    * @param[in] p_iNumChannels     Number of channels of the forward solution.
+    * @param[in] p_iNumGridPoints   Number of grid points of the forward solution.
+    * @param[in] p_dGainNorm        Squared Frobenius norm of the gain matrix.
+    * @param[in] p_iFirst           First grid point of the shard.
+    * @param[in] p_iLast            Grid point behind the last one of the shard.
+    * @param[in] p_iMsecs           Connection timeout.
+    *
+    * @return true if the worker accepted the shard, false otherwise.
+    */
+    bool connectToWorker(int p_iNumChannels, int p_iNumGridPoints, double p_dGainNorm, int p_iFirst, int p_iLast, int p_iMsecs = 30000);
+
+    //=========================================================================================================
+    /**
+    * Sends the orthonormal basis of the found sources and the signal subspace of a recursion step.
+    *
+    * @param[in] p_matQ_A   Orthonormal basis of the found sources.
+    * @param[in] p_matU_B   Basis of the projected signal subspace.
+    *
+    * @return true if sent, false otherwise.
+    */
+    bool sendSubspace(const Eigen::MatrixXd &p_matQ_A, const Eigen::MatrixXd &p_matU_B);
+
+    //=========================================================================================================
+    /**
+    * Requests the scan of a Powell row. The result is read with readRowResult.
+    *
+    * @param[in] p_iRow     The Powell row (grid point) to scan.
+    *
+    * @return true if sent, false otherwise.
+    */
+    bool requestRow(int p_iRow);
+
+    //=========================================================================================================
+    /**
+    * Waits for the result of the last requested row.
+    *
+    * @param[out] p_dCorr   Best correlation of the shard.
+    * @param[out] p_iIdx1   First grid point of the best pair.
+    * @param[out] p_iIdx2   Second grid point of the best pair.
+    * @param[in] p_iMsecs   Timeout, -1 waits forever.
+    *
+    * @return true if a result was received, false otherwise.
+    */
+    bool readRowResult(double &p_dCorr, int &p_iIdx1, int &p_iIdx2, int p_iMsecs = -1);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the shard is connected.
+    *
+    * @return true if connected.
+    */
+    bool isConnected() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the address of the worker as host:port.
+    *
+    * @return the address.
+    */
+    QString address() const;
+
+    //=========================================================================================================
+    /**
+    * Drops the connection and all received bytes, e.g. after a failed row left the replies of a request in
+    * the socket. The shard can be connected again with connectToWorker.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Returns the first grid point of the shard.
+    *
+    * @return the first grid point.
+    */
+    inline int first() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the grid point behind the last one of the shard.
+    *
+    * @return the grid point behind the last one.
+    */
+    inline int last() const;
+
+    //=========================================================================================================
+    /**
+    * Writes a frame (payload size and payload) to the socket.
+    *
+    * @param[in] p_pSocket  The socket.
+    * @param[in] p_payload  The payload.
+    *
+    * @return true if written, false otherwise.
+    */
+    static bool writeFrame(QTcpSocket* p_pSocket, const QByteArray &p_payload);
+
+    //=========================================================================================================
+    /**
+    * Takes the next complete frame out of the buffer.
+    *
+    * @param[in, out] p_buffer  Received bytes, the frame is removed.
+    * @param[out] p_payload     The payload of the frame.
+    *
+    * @return true if a complete frame was available.
+    */
+    static bool takeFrame(QByteArray &p_buffer, QByteArray &p_payload);
+
+    //=========================================================================================================
+    /**
+    * Writes the dimensions and the elements (column major) of a matrix.
+    *
+    * @param[in] p_stream   The stream.
+    * @param[in] p_mat      The matrix.
+    */
+    static void writeMatrix(QDataStream &p_stream, const Eigen::MatrixXd &p_mat);
+
+    //=========================================================================================================
+    /**
+    * Reads a matrix written by writeMatrix. The dimensions are received from the network, they are checked
+    * against the remaining bytes and PWL_SHARD_MAX_MATRIX_SIZE before the matrix is allocated.
+    *
+    * @param[in] p_stream   The stream.
+    * @param[out] p_mat     The matrix, empty if the data are invalid.
+    *
+    * @return true if a valid matrix was read, false otherwise.
+    */
+    static bool readMatrix(QDataStream &p_stream, Eigen::MatrixXd &p_mat);
+
+private:
+    //=========================================================================================================
+    /**
+    * Blocks until a complete frame is received.
+    *
+    * @param[out] p_payload The payload.
+    * @param[in] p_iMsecs   Timeout, -1 waits forever.
+    *
+    * @return true if a frame was received.
+    */
+    bool waitForFrame(QByteArray &p_payload, int p_iMsecs);
+
+    QSharedPointer<QTcpSocket> m_pSocket;   /**< Connection to the worker. */
+    QByteArray m_receiveBuffer;             /**< Received bytes which don't make a frame yet. */
+    QString m_sHost;                        /**< Host of the worker. */
+    quint16 m_iPort;                        /**< Port of the worker. */
+    int m_iFirst;                           /**< First grid point of the shard. */
+    int m_iLast;                            /**< Grid point behind the last one of the shard. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int PwlRapMusicShard::first() const
+{
+    return m_iFirst;
+}
+
+
+//*************************************************************************************************************
+
+inline int PwlRapMusicShard::last() const
+{
+    return m_iLast;
+}
+
+} //NAMESPACE
+
+#endif // PWLRAPMUSICSHARD_H
@@ -0,0 +1,191 @@
+//=============================================================================================================
+/**
+* @file     pwlrapmusicshardserver.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Implementation of the PwlRapMusicShardServer Class.
+*
+*/
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "pwlrapmusicshardserver.h"
+
+#include <iostream>
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDataStream>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace INVERSELIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+PwlRapMusicShardServer::PwlRapMusicShardServer(const PwlRapMusic &p_pwlRapMusic, QObject *parent)
+: QTcpServer(parent)
+, m_pwlRapMusic(p_pwlRapMusic)
+, m_dGainNorm(0)
+, m_iFirst(0)
+, m_iLast(0)
+{
+    if(m_pwlRapMusic.m_bIsInit)
+        m_dGainNorm = m_pwlRapMusic.m_ForwardSolution.sol->data.squaredNorm();
+}
+
+
+//*************************************************************************************************************
+
+void PwlRapMusicShardServer::incomingConnection(qintptr socketDescriptor)
+{
+    if(m_pSocket)
+    {
+        std::cout << "New coordinator connected, dropping the previous one." << std::endl;
+        m_pSocket->abort();
+        m_pSocket->deleteLater();
+    }
+
+    m_pSocket = new QTcpSocket(this);
+    m_pSocket->setSocketDescriptor(socketDescriptor);
+    m_pSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    m_receiveBuffer.clear();
+
+    connect(m_pSocket.data(), &QTcpSocket::readyRead,
+            this, &PwlRapMusicShardServer::readRequests);
+    connect(m_pSocket.data(), &QTcpSocket::disconnected,
+            m_pSocket.data(), &QTcpSocket::deleteLater);
+}
+
+
+//*************************************************************************************************************
+
+void PwlRapMusicShardServer::readRequests()
+{
+    QTcpSocket* t_pSocket = qobject_cast<QTcpSocket*>(sender());
+    if(!t_pSocket || t_pSocket != m_pSocket)
+        return;
+
+    m_receiveBuffer.append(t_pSocket->readAll());
+
+    QByteArray t_payload;
+    while(PwlRapMusicShard::takeFrame(m_receiveBuffer, t_payload))
+        processRequest(t_payload);
+}
+
+
+//*************************************************************************************************************
+
+void PwlRapMusicShardServer::processRequest(const QByteArray &p_payload)
+{
+    QDataStream t_in(p_payload);
+    qint32 t_iCmd = 0;
+    t_in >> t_iCmd;
+
+    QByteArray t_reply;
+    QDataStream t_out(&t_reply, QIODevice::WriteOnly);
+
+    switch(t_iCmd)
+    {
+        case PWL_SHARD_HELLO:
+        {
+            qint32 t_iNumChannels = 0, t_iNumGridPoints = 0, t_iFirst = 0, t_iLast = 0;
+            double t_dGainNorm = 0;
+            t_in >> t_iNumChannels >> t_iNumGridPoints >> t_dGainNorm >> t_iFirst >> t_iLast;
+
+            bool t_bAccepted = m_pwlRapMusic.m_bIsInit
+                    && t_iNumChannels == m_pwlRapMusic.m_iNumChannels
+                    && t_iNumGridPoints == m_pwlRapMusic.m_iNumGridPoints
+                    && std::fabs(t_dGainNorm - m_dGainNorm) <= 1e-9 * m_dGainNorm
+                    && t_iFirst >= 0 && t_iFirst <= t_iLast && t_iLast <= t_iNumGridPoints;
+
+            if(t_bAccepted)
+            {
+                m_iFirst = t_iFirst;
+                m_iLast = t_iLast;
+                std::cout << "Serving grid points " << m_iFirst << " to " << m_iLast-1 << std::endl;
+            }
+            else
+                std::cout << "Rejected coordinator, the forward solutions don't match." << std::endl;
+
+            t_out << (qint32)PWL_SHARD_HELLO_ACK << t_bAccepted;
+            break;
+        }
+        case PWL_SHARD_SUBSPACE:
+        {
+            MatrixXd t_matQ_A, t_matU_B;
+            bool t_bValid = PwlRapMusicShard::readMatrix(t_in, t_matQ_A);
+            t_bValid = t_bValid && PwlRapMusicShard::readMatrix(t_in, t_matU_B);
+
+            if(!t_bValid || t_matQ_A.rows() != m_pwlRapMusic.m_iNumChannels || t_matU_B.rows() != m_pwlRapMusic.m_iNumChannels)
+            {
+                std::cout << "Received subspace doesn't match the number of channels." << std::endl;
+                m_pSocket->abort();
+                return;
+            }
+
+            m_pwlRapMusic.prepareSubcorrScan(t_matQ_A, t_matU_B, m_matQ_A_T_G, m_matG_T_U_B);
+            return; //No reply
+        }
+        case PWL_SHARD_SCAN_ROW:
+        {
+            qint32 t_iRow = -1;
+            t_in >> t_iRow;
+
+            double t_dCorr = -1;
+            int t_iIdx1 = -1, t_iIdx2 = -1;
+            if(t_iRow >= 0 && t_iRow < m_pwlRapMusic.m_iNumGridPoints && m_matG_T_U_B.rows() > 0)
+                m_pwlRapMusic.scanPowellRow(t_iRow, m_iFirst, m_iLast, m_matQ_A_T_G, m_matG_T_U_B, t_dCorr, t_iIdx1, t_iIdx2);
+
+            t_out << (qint32)PWL_SHARD_ROW_RESULT << t_dCorr << (qint32)t_iIdx1 << (qint32)t_iIdx2;
+            break;
+        }
+        default:
+            std::cout << "Unknown shard command " << t_iCmd << std::endl;
+            return;
+    }
+
+    PwlRapMusicShard::writeFrame(m_pSocket.data(), t_reply);
+}
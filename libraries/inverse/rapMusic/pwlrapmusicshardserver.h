@@ -0,0 +1,125 @@
+//=============================================================================================================
+/**
+* @file     pwlrapmusicshardserver.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    PwlRapMusicShardServer class declaration.
+*
+*/
+#ifndef PWLRAPMUSICSHARDSERVER_H
+#define PWLRAPMUSICSHARDSERVER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../inverse_global.h"
+#include "pwlrapmusic.h"
+#include "pwlrapmusicshard.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QByteArray>
+#include <QPointer>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE INVERSELIB
+//=============================================================================================================
+
+namespace INVERSELIB
+{
+
+//=============================================================================================================
+/**
+* Worker side of a sharded Powell RAP MUSIC scan. The server answers the requests of one coordinator at a
+* time: it checks the forward solution on hello, prepares the scan quantities of every recursion step and
+* returns the best pair of its grid range for every requested Powell row.
+*
+* @brief Serves a grid range of the Powell RAP MUSIC scan to a coordinator.
+*/
+class INVERSESHARED_EXPORT PwlRapMusicShardServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    //=========================================================================================================
+    /**
+    * Constructs the server of the given, initialized Powell RAP MUSIC.
+    *
+    * @param[in] p_pwlRapMusic  The Powell RAP MUSIC which holds the forward solution of the worker.
+    * @param[in] parent         Parent QObject (optional)
+    */
+    explicit PwlRapMusicShardServer(const PwlRapMusic &p_pwlRapMusic, QObject *parent = 0);
+
+protected:
+    //=========================================================================================================
+    /**
+    * Accepts a coordinator connection, a previous coordinator is dropped.
+    */
+    void incomingConnection(qintptr socketDescriptor);
+
+private:
+    //=========================================================================================================
+    /**
+    * Reads the available bytes and processes every complete request.
+    */
+    void readRequests();
+
+    //=========================================================================================================
+    /**
+    * Processes a single request and writes its reply.
+    *
+    * @param[in] p_payload  The request.
+    */
+    void processRequest(const QByteArray &p_payload);
+
+    const PwlRapMusic &m_pwlRapMusic;   /**< Powell RAP MUSIC with the forward solution of the worker. */
+    double m_dGainNorm;                 /**< Squared Frobenius norm of the gain matrix of the worker. */
+
+    QPointer<QTcpSocket> m_pSocket;     /**< Connection to the coordinator. */
+    QByteArray m_receiveBuffer;         /**< Received bytes which don't make a frame yet. */
+
+    int m_iFirst;                       /**< First grid point of the shard. */
+    int m_iLast;                        /**< Grid point behind the last one of the shard. */
+    PwlRapMusic::MatrixXT m_matQ_A_T_G; /**< Gain matrix in the basis of the found sources of the current step. */
+    PwlRapMusic::MatrixXT m_matG_T_U_B; /**< Correlation of the gain matrix with the signal subspace of the current step. */
+};
+
+} //NAMESPACE
+
+#endif // PWLRAPMUSICSHARDSERVER_H
@@ -66,6 +66,7 @@ RapMusic::RapMusic()
 , m_iNumChannels(0)
 , m_iNumLeadFieldCombinations(0)
 , m_ppPairIdxCombinations(NULL)
+, m_bUsePairIdxCombinations(true)
 , m_iMaxNumThreads(1)
 , m_bIsInit(false)
 , m_iSamplesStcWindow(-1)
@@ -83,6 +84,7 @@ RapMusic::RapMusic(MNEForwardSolution& p_pFwd, bool p_bSparsed, int p_iN, double
 , m_iNumChannels(0)
 , m_iNumLeadFieldCombinations(0)
 , m_ppPairIdxCombinations(NULL)
+, m_bUsePairIdxCombinations(true)
 , m_iMaxNumThreads(1)
 , m_bIsInit(false)
 , m_iSamplesStcWindow(-1)
@@ -155,18 +157,42 @@ bool RapMusic::init(MNEForwardSolution& p_pFwd, bool p_bSparsed, int p_iN, doubl
 
     //##### Calc lead field combination #####
 
-    std::cout << "Calculate gain matrix combinations. \n";
-
     m_iNumLeadFieldCombinations = MNEMath::nchoose2(m_iNumGridPoints+1);
 
-    m_ppPairIdxCombinations = (Pair **)malloc(m_iNumLeadFieldCombinations * sizeof(Pair *));
+    //The full pair table grows with n^2/2 -> it's only built when the scan runs over all pairs
+    if(m_bUsePairIdxCombinations)
+    {
+        std::cout << "Calculate gain matrix combinations. \n";
 
-    calcPairCombinations(m_iNumGridPoints, m_iNumLeadFieldCombinations, m_ppPairIdxCombinations);
+        m_ppPairIdxCombinations = (Pair **)malloc(m_iNumLeadFieldCombinations * sizeof(Pair *));
 
-    std::cout << "Gain matrix combinations calculated. \n\n";
+        calcPairCombinations(m_iNumGridPoints, m_iNumLeadFieldCombinations, m_ppPairIdxCombinations);
+
+        std::cout << "Gain matrix combinations calculated. \n\n";
+    }
 
     //##### Calc lead field combination end #####
 
+    //##### Cache the Gram matrix of the gain matrix #####
+
+    //G^T*G holds the 6x6 Gram matrix of every gain pair contiguously -> no m x 6 pair has to be touched during the scan
+    qint64 t_iNumGramEntries = (qint64)(3*m_iNumGridPoints) * (qint64)(3*m_iNumGridPoints);
+    if(t_iNumGramEntries <= MAX_GAIN_GRAM_CACHE_ENTRIES)
+    {
+        std::cout << "Calculate gain matrix Gram cache. \n";
+
+        m_matGainGram = MatrixXT::Zero(3*m_iNumGridPoints, 3*m_iNumGridPoints);
+        m_matGainGram.selfadjointView<Eigen::Lower>().rankUpdate(m_ForwardSolution.sol->data.transpose());
+        m_matGainGram.triangularView<Eigen::StrictlyUpper>() = m_matGainGram.transpose();
+
+        std::cout << "Gain matrix Gram cache calculated. \n\n";
+    }
+    else
+    {
+        std::cout << "Gain matrix too large for the Gram cache, pair Gram matrices are computed on the fly. \n\n";
+        m_matGainGram.resize(0,0);
+    }
+
     std::cout << "Number of grid points: " << m_iNumGridPoints << "\n\n";
 
     std::cout << "Number of combinated points: " << m_iNumLeadFieldCombinations << "\n\n";
@@ -265,32 +291,45 @@ MNESourceEstimate RapMusic::calculateInverse(const FiffEvoked &p_fiffEvoked, boo
         qint32 t_iSamplesOverlap = (qint32)floor(((float)m_iSamplesStcWindow)*m_fStcOverlap);
         qint32 t_iSamplesDiscard = t_iSamplesOverlap/2;
 
-        MatrixXd data = MatrixXd::Zero(t_iNumSensors, m_iSamplesStcWindow);
-
         qint32 curSample = 0;
         qint32 curResultSample = 0;
         qint32 stcWindowSize = m_iSamplesStcWindow - 2*t_iSamplesDiscard;
 
+        //Consecutive windows overlap -> the signal subspace is only updated with the samples entering the window.
+        //The tracker is local, so the streaming state of calculateInverseIncremental is left untouched.
+        SignalSubspaceTracker t_subspaceTracker(t_iNumSensors, m_iSamplesStcWindow);
+        qint32 t_iNextSample = 0;
+
+        MatrixXT t_matPhi_s;
+
         while(!last)
         {
             QList< DipolePair<double> > t_RapDipoles;
 
             //Data
+            qint32 t_iWindowStart = curSample;
             if(curSample + m_iSamplesStcWindow >= t_iNumSteps) //last
             {
                 last = true;
-                data = p_fiffEvoked.data.block(0, p_fiffEvoked.data.cols()-m_iSamplesStcWindow, t_iNumSensors, m_iSamplesStcWindow);
+                t_iWindowStart = p_fiffEvoked.data.cols()-m_iSamplesStcWindow;
             }
-            else
-                data = p_fiffEvoked.data.block(0, curSample, t_iNumSensors, m_iSamplesStcWindow);
 
+            qint32 t_iFirstNew = std::max(t_iNextSample, t_iWindowStart);
+            qint32 t_iWindowEnd = t_iWindowStart + m_iSamplesStcWindow;
+            if(t_iWindowEnd > t_iFirstNew)
+                t_subspaceTracker.append(p_fiffEvoked.data.block(0, t_iFirstNew, t_iNumSensors, t_iWindowEnd - t_iFirstNew));
+            t_iNextSample = t_iWindowEnd;
 
             curSample += (m_iSamplesStcWindow - t_iSamplesOverlap);
             if(first)
                 curSample -= t_iSamplesDiscard; //shift on start t_iSamplesDiscard backwards
 
             //Calculate
-            calculateInverse(data, t_RapDipoles);
+            if(m_bIsInit)
+            {
+                int t_r = t_subspaceTracker.calcPhi_s(t_matPhi_s);
+                calculateInverseFromSubspace(t_matPhi_s, t_r, t_RapDipoles);
+            }
 
             //Assign Result
             if(last)
@@ -330,50 +369,100 @@ MNESourceEstimate RapMusic::calculateInverse(const FiffEvoked &p_fiffEvoked, boo
 
 MNESourceEstimate RapMusic::calculateInverse(const MatrixXd &data, float tmin, float tstep) const
 {
-    MNESourceEstimate p_sourceEstimate;
-
     if(data.rows() != m_iNumChannels)
     {
         std::cout << "Number of FiffEvoked channels (" << data.rows() << ") doesn't match the number of channels (" << m_iNumChannels << ") of the forward solution." << std::endl;
-        return p_sourceEstimate;
+        return MNESourceEstimate();
     }
 //    else
 //        std::cout << "Number of FiffEvoked channels (" << data.rows() << ") matchs the number of channels (" << m_iNumChannels << ") of the forward solution." << std::endl;
 
+    QList< DipolePair<double> > t_RapDipoles;
+    calculateInverse(data, t_RapDipoles);
+
+    return createSourceEstimate(t_RapDipoles, data.cols(), tmin, tstep);
+}
+
+
+//*************************************************************************************************************
+
+MNESourceEstimate RapMusic::calculateInverseIncremental(const MatrixXd& p_matBlock, float tmin, float tstep)
+{
+    if(!m_bIsInit)
+    {
+        std::cout << "RAP MUSIC wasn't initialized!";
+        return MNESourceEstimate();
+    }
+
+    if(p_matBlock.rows() != m_iNumChannels)
+    {
+        std::cout << "Number of data channels (" << p_matBlock.rows() << ") doesn't match the number of channels (" << m_iNumChannels << ") of the forward solution." << std::endl;
+        return MNESourceEstimate();
+    }
+
+    //The sliding window follows setStcAttr - without a window every block is localized on its own
+    int t_iWindowSize = m_iSamplesStcWindow > 3 ? m_iSamplesStcWindow : p_matBlock.cols();
+    if(m_subspaceTracker.windowSize() != t_iWindowSize)
+        m_subspaceTracker.init(m_iNumChannels, t_iWindowSize);
+
+    m_subspaceTracker.append(p_matBlock);
+
+    MatrixXT t_matPhi_s;
+    int t_r = m_subspaceTracker.calcPhi_s(t_matPhi_s);
+
+    QList< DipolePair<double> > t_RapDipoles;
+    calculateInverseFromSubspace(t_matPhi_s, t_r, t_RapDipoles);
+
+    return createSourceEstimate(t_RapDipoles, p_matBlock.cols(), tmin, tstep);
+}
+
+
+//*************************************************************************************************************
+
+void RapMusic::resetIncremental()
+{
+    m_subspaceTracker.reset();
+}
+
+
+//*************************************************************************************************************
+
+MNESourceEstimate RapMusic::createSourceEstimate(const QList< DipolePair<double> > &p_RapDipoles, int p_iNumSamples, float tmin, float tstep) const
+{
+    MNESourceEstimate p_sourceEstimate;
+
     //
     // Rap MUSIC Source estimate
     //
-    p_sourceEstimate.data = MatrixXd::Zero(m_ForwardSolution.nsource, data.cols());
+    p_sourceEstimate.data = MatrixXd::Zero(m_ForwardSolution.nsource, p_iNumSamples);
 
     //Results
     p_sourceEstimate.vertices = VectorXi(m_ForwardSolution.src[0].vertno.size() + m_ForwardSolution.src[1].vertno.size());
     p_sourceEstimate.vertices << m_ForwardSolution.src[0].vertno, m_ForwardSolution.src[1].vertno;
 
-    p_sourceEstimate.times = RowVectorXf::Zero(data.cols());
-    p_sourceEstimate.times[0] = tmin;
+    p_sourceEstimate.times = RowVectorXf::Zero(p_iNumSamples);
+    if(p_iNumSamples > 0)
+        p_sourceEstimate.times[0] = tmin;
     for(qint32 i = 1; i < p_sourceEstimate.times.size(); ++i)
         p_sourceEstimate.times[i] = p_sourceEstimate.times[i-1] + tstep;
     p_sourceEstimate.tmin = tmin;
     p_sourceEstimate.tstep = tstep;
 
-    QList< DipolePair<double> > t_RapDipoles;
-    calculateInverse(data, t_RapDipoles);
-
-    for(qint32 i = 0; i < t_RapDipoles.size(); ++i)
+    for(qint32 i = 0; i < p_RapDipoles.size(); ++i)
     {
-        double dip1 = sqrt( pow(t_RapDipoles[i].m_Dipole1.phi_x(),2) +
-                            pow(t_RapDipoles[i].m_Dipole1.phi_y(),2) +
-                            pow(t_RapDipoles[i].m_Dipole1.phi_z(),2) ) * t_RapDipoles[i].m_vCorrelation;
+        double dip1 = sqrt( pow(p_RapDipoles[i].m_Dipole1.phi_x(),2) +
+                            pow(p_RapDipoles[i].m_Dipole1.phi_y(),2) +
+                            pow(p_RapDipoles[i].m_Dipole1.phi_z(),2) ) * p_RapDipoles[i].m_vCorrelation;
 
-        double dip2 = sqrt( pow(t_RapDipoles[i].m_Dipole2.phi_x(),2) +
-                            pow(t_RapDipoles[i].m_Dipole2.phi_y(),2) +
-                            pow(t_RapDipoles[i].m_Dipole2.phi_z(),2) ) * t_RapDipoles[i].m_vCorrelation;
+        double dip2 = sqrt( pow(p_RapDipoles[i].m_Dipole2.phi_x(),2) +
+                            pow(p_RapDipoles[i].m_Dipole2.phi_y(),2) +
+                            pow(p_RapDipoles[i].m_Dipole2.phi_z(),2) ) * p_RapDipoles[i].m_vCorrelation;
 
-        RowVectorXd dip1Time = RowVectorXd::Constant(data.cols(), dip1);
-        RowVectorXd dip2Time = RowVectorXd::Constant(data.cols(), dip2);
+        RowVectorXd dip1Time = RowVectorXd::Constant(p_iNumSamples, dip1);
+        RowVectorXd dip2Time = RowVectorXd::Constant(p_iNumSamples, dip2);
 
-        p_sourceEstimate.data.block(t_RapDipoles[i].m_iIdx1, 0, 1, data.cols()) = dip1Time;
-        p_sourceEstimate.data.block(t_RapDipoles[i].m_iIdx2, 0, 1, data.cols()) = dip2Time;
+        p_sourceEstimate.data.block(p_RapDipoles[i].m_iIdx1, 0, 1, p_iNumSamples) = dip1Time;
+        p_sourceEstimate.data.block(p_RapDipoles[i].m_iIdx2, 0, 1, p_iNumSamples) = dip2Time;
     }
 
     return p_sourceEstimate;
@@ -415,59 +504,74 @@ MNESourceEstimate RapMusic::calculateInverse(const MatrixXd& p_matMeasurement, Q
     MatrixXT* t_pMatPhi_s = NULL;//(m_iNumChannels, m_iN < t_r ? m_iN : t_r);
     int t_r = calcPhi_s(/*(MatrixXT)*/p_matMeasurement, t_pMatPhi_s);
 
-    int t_iMaxSearch = m_iN < t_r ? m_iN : t_r; //The smallest of Rank and Iterations
+    calculateInverseFromSubspace(*t_pMatPhi_s, t_r, p_RapDipoles);
+
+    end = clock();
+
+    float t_fElapsedTime = ( (float)(end-start) / (float)CLOCKS_PER_SEC ) * 1000.0f;
+    std::cout << "Total Time Elapsed: " << t_fElapsedTime << " ms" << std::endl << std::endl;
+
+    //garbage collecting
+    delete t_pMatPhi_s;
+
+    return p_SourceEstimate;
+}
+
+
+//*************************************************************************************************************
+
+void RapMusic::calculateInverseFromSubspace(const MatrixXT& p_matPhi_s, int p_iRank, QList< DipolePair<double> > &p_RapDipoles) const
+{
+    //An empty window has no signal subspace to scan
+    if(p_iRank < 1 || p_matPhi_s.cols() == 0)
+    {
+        std::cout << "Warning: The measurement data has no signal subspace, no sources are searched." << std::endl;
+        p_RapDipoles.clear();
+        return;
+    }
 
-    if (t_r < m_iN)
+    int t_iMaxSearch = m_iN < p_iRank ? m_iN : p_iRank; //The smallest of Rank and Iterations
+
+    if (p_iRank < m_iN)
     {
-        std::cout << "Warning: Rank " << t_r << " of the measurement data is smaller than the " << m_iN;
+        std::cout << "Warning: Rank " << p_iRank << " of the measurement data is smaller than the " << m_iN;
         std::cout << " sources to find." << std::endl;
         std::cout << "         Searching now for " << t_iMaxSearch << " correlated sources.";
         std::cout << std::endl << std::endl;
     }
 
-    //Create Orthogonal Projector
-    //OrthProj
-    MatrixXT t_matOrthProj(m_iNumChannels,m_iNumChannels);
-    t_matOrthProj.setIdentity();
+    //Orthonormal basis Q_A of the found sources - the orthogonal projector is applied as rank-k update I - Q_A*Q_A^T
+    MatrixXT t_matQ_A(m_iNumChannels, 0);
 
     //A_k_1
     MatrixXT t_matA_k_1(m_iNumChannels, t_iMaxSearch);
     t_matA_k_1.setZero();
 
-//    if (m_pMatGrid != NULL)
-//    {
-//        if(p_pRapDipoles != NULL)
-//            p_pRapDipoles->initRapDipoles(m_pMatGrid);
-//        else
-//            p_pRapDipoles = new RapDipoles<T>(m_pMatGrid);
-//    }
-//    else
-//    {
-//        if(p_pRapDipoles != NULL)
-//            delete p_pRapDipoles;
-
-//        p_pRapDipoles = new RapDipoles<T>();
-//    }
     p_RapDipoles.clear();
 
     std::cout << "##### Calculation of RAP MUSIC started ######\n\n";
 
-    MatrixXT t_matProj_Phi_s(t_matOrthProj.rows(), t_pMatPhi_s->cols());
-    //new Version: Calculate projection before
-    MatrixXT t_matProj_LeadField(m_ForwardSolution.sol->data.rows(), m_ForwardSolution.sol->data.cols());
+    MatrixXT t_matProj_Phi_s(m_iNumChannels, p_matPhi_s.cols());
+    //Gain matrix in the basis of the found sources (Q_A^T*G) and its correlation with the signal subspace (G^T*U_B)
+    MatrixXT t_matQ_A_T_G;
+    MatrixXT t_matG_T_U_B;
 
     for(int r = 0; r < t_iMaxSearch ; ++r)
     {
-        t_matProj_Phi_s = t_matOrthProj*(*t_pMatPhi_s);
-
-        //new Version: Calculating Projection before
-        t_matProj_LeadField = t_matOrthProj * m_ForwardSolution.sol->data;//Subtract the found sources from the current found source
+        t_matProj_Phi_s = p_matPhi_s;
+        if(t_matQ_A.cols() > 0)
+            t_matProj_Phi_s.noalias() -= t_matQ_A*(t_matQ_A.transpose()*p_matPhi_s);
 
         //###First Option###
         //Step 1: lt. Mosher 1998 -> Maybe tmp_Proj_Phi_S is already orthogonal -> so no SVD needed -> U_B = tmp_Proj_Phi_S;
-        Eigen::JacobiSVD< MatrixXT > t_svdProj_Phi_S(t_matProj_Phi_s, Eigen::ComputeThinU);
+        VectorXT t_vecSigma_Phi_S;
+        MatrixXT t_matU_Phi_S, t_matV_Phi_S;
+        MNEMath::gram_svd(t_matProj_Phi_s, t_vecSigma_Phi_S, t_matU_Phi_S, t_matV_Phi_S);
         MatrixXT t_matU_B;
-        useFullRank(t_svdProj_Phi_S.matrixU(), t_svdProj_Phi_S.singularValues().asDiagonal(), t_matU_B);
+        useFullRank(t_matU_Phi_S, t_vecSigma_Phi_S.asDiagonal(), t_matU_B);
+
+        //Everything the scan needs from the projector and the signal subspace, computed once per recursion
+        prepareSubcorrScan(t_matQ_A, t_matU_B, t_matQ_A_T_G, t_matG_T_U_B);
 
         //Inits
         VectorXT t_vecRoh(m_iNumLeadFieldCombinations,1);
@@ -488,36 +592,13 @@ MNESourceEstimate RapMusic::calculateInverse(const MatrixXd& p_matMeasurement, Q
         #endif
             for(int i = 0; i < m_iNumLeadFieldCombinations; i++)
             {
-                //new Version: calculate matrix multiplication before
-                //Create Lead Field combinations -> It would be better to use a pointer construction, to increase performance
-                MatrixX6T t_matProj_G(t_matProj_LeadField.rows(),6);
-
                 int idx1 = m_ppPairIdxCombinations[i]->x1;
                 int idx2 = m_ppPairIdxCombinations[i]->x2;
 
-                RapMusic::getGainMatrixPair(t_matProj_LeadField, t_matProj_G, idx1, idx2);
-
-                t_vecRoh(i) = RapMusic::subcorr(t_matProj_G, t_matU_B);//t_vecRoh holds the correlations roh_k
+                t_vecRoh(i) = subcorrScan(idx1, idx2, t_matQ_A_T_G, t_matG_T_U_B);//t_vecRoh holds the correlations roh_k
             }
         }
 
-
-//         if(r==0)
-//         {
-//             std::fstream filestr;
-//             std::stringstream filename;
-//             filename << "Roh_gold.txt";
-//
-//             filestr.open ( filename.str().c_str(), std::fstream::out);
-//             for(int i = 0; i < m_iNumLeadFieldCombinations; ++i)
-//             {
-//               filestr << t_vecRoh(i) << "\n";
-//             }
-//             filestr.close();
-//
-//             //exit(0);
-//         }
-
         //subcorr benchmark
         end_subcorr = clock();
 
@@ -539,14 +620,13 @@ MNESourceEstimate RapMusic::calculateInverse(const MatrixXd& p_matMeasurement, Q
         std::cout << "Iteration: " << r+1 << " of " << t_iMaxSearch
             << "; Correlation: " << t_val_roh_k<< "; Position (Idx+1): " << t_iIdx1+1 << " - " << t_iIdx2+1 <<"\n\n";
 
-        //Calculations with the max correlated dipole pair G_k_1 -> ToDo Obsolet when taking direkt Projected Lead Field
+        //Calculations with the max correlated dipole pair G_k_1
         MatrixX6T t_matG_k_1(m_ForwardSolution.sol->data.rows(),6);
         RapMusic::getGainMatrixPair(m_ForwardSolution.sol->data, t_matG_k_1, t_iIdx1, t_iIdx2);
 
-        MatrixX6T t_matProj_G_k_1(t_matOrthProj.rows(), t_matG_k_1.cols());
-        t_matProj_G_k_1 = t_matOrthProj * t_matG_k_1;//Subtract the found sources from the current found source
-//         MatrixX6T t_matProj_G_k_1(t_matProj_LeadField.rows(), 6);
-//         getLeadFieldPair(t_matProj_LeadField, t_matProj_G_k_1, t_iIdx1, t_iIdx2);
+        MatrixX6T t_matProj_G_k_1 = t_matG_k_1;
+        if(t_matQ_A.cols() > 0)
+            t_matProj_G_k_1.noalias() -= t_matQ_A*(t_matQ_A.transpose()*t_matG_k_1);//Subtract the found sources from the current found source
 
         //Calculate source direction
         //source direction (p_pMatPhi) for current source r (phi_k_1)
@@ -567,24 +647,11 @@ MNESourceEstimate RapMusic::calculateInverse(const MatrixXd& p_matMeasurement, Q
         //Calculate A_k_1 = [a_theta_1..a_theta_k_1] matrix for subtraction of found source
         RapMusic::calcA_k_1(t_matG_k_1, t_vec_phi_k_1, r, t_matA_k_1);
 
-        //Calculate new orthogonal Projector (Pi_k_1)
-        calcOrthProj(t_matA_k_1, t_matOrthProj);
-
-        //garbage collecting
-        //ToDo
+        //Update the orthonormal basis of the found sources (replaces the full projector Pi_k_1)
+        RapMusic::calcOrthBasis(t_matA_k_1.leftCols(r+1), t_matQ_A);
     }
 
     std::cout << "##### Calculation of RAP MUSIC completed ######"<< std::endl << std::endl << std::endl;
-
-    end = clock();
-
-    float t_fElapsedTime = ( (float)(end-start) / (float)CLOCKS_PER_SEC ) * 1000.0f;
-    std::cout << "Total Time Elapsed: " << t_fElapsedTime << " ms" << std::endl << std::endl;
-
-    //garbage collecting
-    delete t_pMatPhi_s;
-
-    return p_SourceEstimate;
 }
 
 
@@ -599,20 +666,33 @@ int RapMusic::calcPhi_s(const MatrixXT& p_matMeasurement, MatrixXT* &p_pMatPhi_s
     else
         t_matF = MatrixXT(p_matMeasurement);
 
-    Eigen::JacobiSVD<MatrixXT> t_svdF(t_matF, Eigen::ComputeThinU);
+    //FF^T is symmetric positive semi-definite -> its SVD is the eigendecomposition
+    VectorXT t_vecSigma_F;
+    MatrixXT t_matU_F;
+    if (p_matMeasurement.cols() > p_matMeasurement.rows())
+    {
+        Eigen::SelfAdjointEigenSolver<MatrixXT> t_eigF(t_matF);
+        t_vecSigma_F = t_eigF.eigenvalues().reverse().cwiseMax(0.0);
+        t_matU_F = t_eigF.eigenvectors().rowwise().reverse();
+    }
+    else
+    {
+        MatrixXT t_matV_F;
+        MNEMath::gram_svd(t_matF, t_vecSigma_F, t_matU_F, t_matV_F);
+    }
 
-    int t_r = getRank(t_svdF.singularValues().asDiagonal());
+    int t_r = getRank(t_vecSigma_F.asDiagonal());
 
     int t_iCols = t_r;//t_r < m_iN ? m_iN : t_r;
 
     if (p_pMatPhi_s != NULL)
         delete p_pMatPhi_s;
 
-    //m_iNumChannels has to be equal to t_svdF.matrixU().rows()
+    //m_iNumChannels has to be equal to t_matU_F.rows()
     p_pMatPhi_s = new MatrixXT(m_iNumChannels, t_iCols);
 
     //assign the signal subspace
-    memcpy(p_pMatPhi_s->data(), t_svdF.matrixU().data(), sizeof(double) * m_iNumChannels * t_iCols);
+    memcpy(p_pMatPhi_s->data(), t_matU_F.data(), sizeof(double) * m_iNumChannels * t_iCols);
 
     return t_r;
 }
@@ -627,10 +707,12 @@ double RapMusic::subcorr(MatrixX6T& p_matProj_G, const MatrixXT& p_matU_B)
     Matrix6T t_matSigma_A(6, 6);
     Matrix6XT t_matU_A_T(6, p_matProj_G.rows()); //rows and cols are changed, because of CV_SVD_U_T
 
-    Eigen::JacobiSVD<MatrixXT> t_svdProj_G(p_matProj_G, Eigen::ComputeThinU);
+    VectorXT t_vecSigma_A;
+    MatrixXT t_matU_A, t_matV_A;
+    MNEMath::gram_svd(p_matProj_G, t_vecSigma_A, t_matU_A, t_matV_A);
 
-    t_matSigma_A = t_svdProj_G.singularValues().asDiagonal();
-    t_matU_A_T = t_svdProj_G.matrixU().transpose();
+    t_matSigma_A = t_vecSigma_A.asDiagonal();
+    t_matU_A_T = t_matU_A.transpose();
 
     //lt. Mosher 1998 ToDo: Only Retain those Components of U_A and U_B that correspond to nonzero singular values
     //for U_A and U_B the number of columns corresponds to their ranks
@@ -644,24 +726,13 @@ double RapMusic::subcorr(MatrixX6T& p_matProj_G, const MatrixXT& p_matU_B)
     //Step 2: compute the subspace correlation
     t_matCor = t_matU_A_T_full*p_matU_B;//lt. Mosher 1998: C = U_A^T * U_B
 
-    VectorXT t_vecSigma_C;
+    //The largest singular value of C is the square root of the largest eigenvalue of the small C*C^T
+    MatrixXT t_matCorCor_T(t_matCor.rows(), t_matCor.rows());
+    t_matCorCor_T.noalias() = t_matCor*t_matCor.transpose();
 
-    if (t_matCor.cols() > t_matCor.rows())
-    {
-        MatrixXT t_matCor_H(t_matCor.cols(), t_matCor.rows());
-        t_matCor_H = t_matCor.adjoint(); //for complex it has to be adjunct
-        //ToDo -> use instead adjointInPlace
-
-        Eigen::JacobiSVD<MatrixXT> t_svdCor_H(t_matCor_H);
-
-        t_vecSigma_C = t_svdCor_H.singularValues();
-    }
-    else
-    {
-        Eigen::JacobiSVD<MatrixXT> t_svdCor(t_matCor);
+    Eigen::SelfAdjointEigenSolver<MatrixXT> t_eigCor(t_matCorCor_T, Eigen::EigenvaluesOnly);
 
-        t_vecSigma_C = t_svdCor.singularValues();
-    }
+    VectorXT t_vecSigma_C = t_eigCor.eigenvalues().reverse().cwiseMax(0.0).cwiseSqrt();
 
     //Step 3
     double t_dRetSigma_C;
@@ -684,11 +755,13 @@ double RapMusic::subcorr(MatrixX6T& p_matProj_G, const MatrixXT& p_matU_B, Vecto
     Matrix6XT U_A_T(6, p_matProj_G.rows()); //rows and cols are changed, because of CV_SVD_U_T
     Matrix6T V_A(6, 6);
 
-    Eigen::JacobiSVD<MatrixXT> svdOfProj_G(p_matProj_G, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    VectorXT t_vecSigma_A;
+    MatrixXT t_matU_A, t_matV_A;
+    MNEMath::gram_svd(p_matProj_G, t_vecSigma_A, t_matU_A, t_matV_A);
 
-    sigma_A = svdOfProj_G.singularValues().asDiagonal();
-    U_A_T = svdOfProj_G.matrixU().transpose();
-    V_A = svdOfProj_G.matrixV();
+    sigma_A = t_vecSigma_A.asDiagonal();
+    U_A_T = t_matU_A.transpose();
+    V_A = t_matV_A;
 
     //lt. Mosher 1998 ToDo: Only Retain those Components of U_A and U_B that correspond to nonzero singular values
     //for U_A and U_B the number of columns corresponds to their ranks
@@ -705,26 +778,20 @@ double RapMusic::subcorr(MatrixX6T& p_matProj_G, const MatrixXT& p_matU_B, Vecto
     //Step 4
     Matrix6XT U_C;
 
-    if (t_matCor.cols() > t_matCor.rows())
-    {
-        MatrixX6T Cor_H(t_matCor.cols(), 6);
-        Cor_H = t_matCor.adjoint(); //for complex it has to be adjunct
-
-        Eigen::JacobiSVD<MatrixXT> svdOfCor_H(Cor_H, Eigen::ComputeThinV);
+    //The left singular vectors of C are the eigenvectors of the small C*C^T
+    Matrix6T t_matCorCor_T;
+    t_matCorCor_T.noalias() = t_matCor*t_matCor.transpose();
 
-        U_C = svdOfCor_H.matrixV(); //because t_matCor Hermitesch U and V are exchanged
-        sigma_C = svdOfCor_H.singularValues();
-    }
-    else
-    {
-        Eigen::JacobiSVD<MatrixXT> svdOfCor(t_matCor, Eigen::ComputeThinU);
+    Eigen::SelfAdjointEigenSolver<Matrix6T> t_eigCor(t_matCorCor_T);
 
-        U_C = svdOfCor.matrixU();
-        sigma_C = svdOfCor.singularValues();
-    }
+    U_C = t_eigCor.eigenvectors().rowwise().reverse();
+    sigma_C = t_eigCor.eigenvalues().reverse().cwiseMax(0.0).cwiseSqrt();
 
-    Matrix6T sigma_a_inv;
-    sigma_a_inv = sigma_A.inverse();
+    //Pseudo inverse - singular values of a rank deficient pair are zero
+    Matrix6T sigma_a_inv = Matrix6T::Zero();
+    for(int i = 0; i < 6; ++i)
+        if(sigma_A(i,i) > 0)
+            sigma_a_inv(i,i) = 1.0/sigma_A(i,i);
 
     Matrix6XT X;
     X = (V_A*sigma_a_inv)*U_C;//X = V_A*Sigma_A^-1*U_C
@@ -769,44 +836,78 @@ void RapMusic::calcA_k_1(   const MatrixX6T& p_matG_k_1,
 
 //*************************************************************************************************************
 
-void RapMusic::calcOrthProj(const MatrixXT& p_matA_k_1, MatrixXT& p_matOrthProj) const
+void RapMusic::calcOrthBasis(const MatrixXT& p_matA_k_1, MatrixXT& p_matQ_A)
 {
-    //Calculate OrthProj=I-A_k_1*(A_k_1'*A_k_1)^-1*A_k_1' //Wetterling -> A_k_1 = Gain
+    //Column pivoting drops linear dependent manifold vectors
+    Eigen::ColPivHouseholderQR<MatrixXT> t_qrA(p_matA_k_1);
 
-    MatrixXT t_matA_k_1_tmp(p_matA_k_1.cols(), p_matA_k_1.cols());
-    t_matA_k_1_tmp = p_matA_k_1.adjoint()*p_matA_k_1;//A_k_1'*A_k_1 = A_k_1_tmp -> A_k_1' has to be adjoint for complex
+    int t_iRank = t_qrA.rank();
 
+    p_matQ_A = t_qrA.householderQ() * MatrixXT::Identity(p_matA_k_1.rows(), t_iRank);
+}
 
-    int t_size = t_matA_k_1_tmp.cols();
 
-    while (!t_matA_k_1_tmp.block(0,0,t_size,t_size).fullPivLu().isInvertible())
-    {
-        --t_size;
-    }
+//*************************************************************************************************************
 
-    MatrixXT t_matA_k_1_tmp_inv(t_matA_k_1_tmp.rows(), t_matA_k_1_tmp.cols());
-    t_matA_k_1_tmp_inv.setZero();
+void RapMusic::prepareSubcorrScan(  const MatrixXT& p_matQ_A,
+                                    const MatrixXT& p_matU_B,
+                                    MatrixXT& p_matQ_A_T_G,
+                                    MatrixXT& p_matG_T_U_B) const
+{
+    const MatrixXT& t_matG = m_ForwardSolution.sol->data;
 
-    t_matA_k_1_tmp_inv.block(0,0,t_size,t_size) = t_matA_k_1_tmp.block(0,0,t_size,t_size).inverse();//(A_k_1_tmp)^-1 = A_k_1_tmp_inv
+    p_matQ_A_T_G.resize(p_matQ_A.cols(), t_matG.cols());
+    if(p_matQ_A.cols() > 0)
+        p_matQ_A_T_G.noalias() = p_matQ_A.transpose() * t_matG;
 
+    p_matG_T_U_B.resize(t_matG.cols(), p_matU_B.cols());
+    p_matG_T_U_B.noalias() = t_matG.transpose() * p_matU_B;
+}
 
-    t_matA_k_1_tmp = MatrixXT::Zero(p_matA_k_1.rows(), p_matA_k_1.cols());
 
-    t_matA_k_1_tmp = p_matA_k_1*t_matA_k_1_tmp_inv;//(A_k_1*A_k_1_tmp_inv) = A_k_1_tmp
+//*************************************************************************************************************
 
+double RapMusic::subcorrScan(   int p_iIdx1, int p_iIdx2,
+                                const MatrixXT& p_matQ_A_T_G,
+                                const MatrixXT& p_matG_T_U_B) const
+{
+    //Gram matrix of the projected pair: (P*G)^T*(P*G) = G^T*G - (Q_A^T*G)^T*(Q_A^T*G)
+    Matrix6T t_matGram;
+    getGainGramPair(p_iIdx1, p_iIdx2, t_matGram);
 
-    MatrixXT t_matA_k_1_tmp2(p_matA_k_1.rows(), p_matA_k_1.rows());
+    if(p_matQ_A_T_G.rows() > 0)
+    {
+        MatrixX6T t_matC(p_matQ_A_T_G.rows(), 6);
+        t_matC.leftCols(3) = p_matQ_A_T_G.middleCols(3*p_iIdx1, 3);
+        t_matC.rightCols(3) = p_matQ_A_T_G.middleCols(3*p_iIdx2, 3);
 
-    t_matA_k_1_tmp2 = t_matA_k_1_tmp*p_matA_k_1.adjoint();//(A_k_1_tmp)*A_k_1' -> here A_k_1' is only transposed - it has to be adjoint
+        t_matGram.noalias() -= t_matC.transpose() * t_matC;
+    }
 
+    //Since P*U_B = U_B: (P*G)^T*U_B = G^T*U_B
+    Matrix6XT t_matB(6, p_matG_T_U_B.cols());
+    t_matB.topRows(3) = p_matG_T_U_B.middleRows(3*p_iIdx1, 3);
+    t_matB.bottomRows(3) = p_matG_T_U_B.middleRows(3*p_iIdx2, 3);
 
-    MatrixXT I(m_iNumChannels,m_iNumChannels);
-    I.setIdentity();
+    //Eigenvalues of the Gram matrix are the squared singular values Sigma_A of the projected pair and
+    //U_A = P*G*V_A*Sigma_A^-1 -> C = U_A^T*U_B = Sigma_A^-1*V_A^T*B
+    Eigen::SelfAdjointEigenSolver<Matrix6T> t_eigGram(t_matGram);
 
-    p_matOrthProj = I-t_matA_k_1_tmp2; //OrthProj=I-A_k_1*(A_k_1'*A_k_1)^-1*A_k_1';
+    Matrix6XT t_matCor = Matrix6XT::Zero(6, t_matB.cols());
+    for(int i = 0; i < 6; ++i)
+    {
+        double t_dSigma = sqrt(std::max(t_eigGram.eigenvalues()(i), 0.0));
+        if(t_dSigma > 0.00001) //lt. Mosher 1998: Only retain components of U_A with nonzero singular values
+            t_matCor.row(i) = (t_eigGram.eigenvectors().col(i).transpose() * t_matB) / t_dSigma;
+    }
 
-    //garbage collecting
-    //ToDo
+    //The largest singular value of C is the square root of the largest eigenvalue of C*C^T
+    Matrix6T t_matCorCor_T;
+    t_matCorCor_T.noalias() = t_matCor * t_matCor.transpose();
+
+    Eigen::SelfAdjointEigenSolver<Matrix6T> t_eigCor(t_matCorCor_T, Eigen::EigenvaluesOnly);
+
+    return sqrt(std::max(t_eigCor.eigenvalues()(5), 0.0));
 }
 
 
@@ -866,6 +967,27 @@ void RapMusic::getGainMatrixPair(   const MatrixXT& p_matGainMarix,
 }
 
 
+//*************************************************************************************************************
+
+void RapMusic::getGainGramPair(int p_iIdx1, int p_iIdx2, Matrix6T& p_matGram) const
+{
+    if(m_matGainGram.size() > 0)
+    {
+        p_matGram.block<3,3>(0,0) = m_matGainGram.block<3,3>(3*p_iIdx1, 3*p_iIdx1);
+        p_matGram.block<3,3>(0,3) = m_matGainGram.block<3,3>(3*p_iIdx1, 3*p_iIdx2);
+        p_matGram.block<3,3>(3,0) = m_matGainGram.block<3,3>(3*p_iIdx2, 3*p_iIdx1);
+        p_matGram.block<3,3>(3,3) = m_matGainGram.block<3,3>(3*p_iIdx2, 3*p_iIdx2);
+    }
+    else
+    {
+        MatrixX6T t_matG(m_iNumChannels, 6);
+        getGainMatrixPair(m_ForwardSolution.sol->data, t_matG, p_iIdx1, p_iIdx2);
+
+        p_matGram.noalias() = t_matG.transpose() * t_matG;
+    }
+}
+
+
 //*************************************************************************************************************
 
 void RapMusic::insertSource(    int p_iDipoleIdx1, int p_iDipoleIdx2,
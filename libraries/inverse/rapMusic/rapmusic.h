@@ -44,6 +44,7 @@
 #include "../IInverseAlgorithm.h"
 
 #include "dipole.h"
+#include "signalsubspacetracker.h"
 
 #include <mne/mne_forwardsolution.h>
 #include <mne/mne_sourceestimate.h>
@@ -61,6 +62,8 @@
 #include <Eigen/Core>
 #include <Eigen/SVD>
 #include <Eigen/LU>
+#include <Eigen/QR>
+#include <Eigen/Eigenvalues>
 
 
 //*************************************************************************************************************
@@ -87,6 +90,8 @@ using namespace MNELIB;
 #define NOT_TRANSPOSED   0  /**< Defines NOT_TRANSPOSED */
 #define IS_TRANSPOSED   1   /**< Defines IS_TRANSPOSED */
 
+#define MAX_GAIN_GRAM_CACHE_ENTRIES 4194304     /**< Maximal number of entries (32 MB) of the cached gain Gram matrix, larger gain matrices are scanned uncached */
+
 
 //=============================================================================================================
 /**
@@ -170,6 +175,26 @@ public:
 
     virtual MNESourceEstimate calculateInverse(const MatrixXd& p_matMeasurement, QList< DipolePair<double> > &p_RapDipoles) const;
 
+    //=========================================================================================================
+    /**
+    * Localizes the sliding window which ends with the given data block. Only the new block enters the signal
+    * subspace update, the window length is set by setStcAttr (the block length if no window is set).
+    * Intended for streaming data, where every incoming buffer should produce a localization.
+    *
+    * @param[in] p_matBlock     The new data block (channels x samples).
+    * @param[in] tmin           Time of the first sample of the block.
+    * @param[in] tstep          Time between two samples.
+    *
+    * @return the source estimate of the current window, covering the samples of the block.
+    */
+    MNESourceEstimate calculateInverseIncremental(const MatrixXd& p_matBlock, float tmin, float tstep);
+
+    //=========================================================================================================
+    /**
+    * Clears the sliding window used by calculateInverseIncremental, e.g. after a gap in the data stream.
+    */
+    void resetIncremental();
+
     virtual const char* getName() const;
 
     virtual const MNESourceSpace& getSourceSpace() const;
@@ -195,6 +220,29 @@ protected:
     */
     int calcPhi_s(const MatrixXT& p_matMeasurement, MatrixXT* &p_pMatPhi_s) const;
 
+    //=========================================================================================================
+    /**
+    * Runs the RAP MUSIC recursion on an already computed signal subspace.
+    *
+    * @param[in] p_matPhi_s     The signal subspace Phi_s (channels x r).
+    * @param[in] p_iRank        The rank r of the measurement.
+    * @param[out] p_RapDipoles  The found dipole pairs.
+    */
+    virtual void calculateInverseFromSubspace(const MatrixXT& p_matPhi_s, int p_iRank, QList< DipolePair<double> > &p_RapDipoles) const;
+
+    //=========================================================================================================
+    /**
+    * Creates a source estimate of the given length, in which every found dipole is constant over time.
+    *
+    * @param[in] p_RapDipoles   The found dipole pairs.
+    * @param[in] p_iNumSamples  Number of samples of the estimate.
+    * @param[in] tmin           Time of the first sample.
+    * @param[in] tstep          Time between two samples.
+    *
+    * @return the source estimate.
+    */
+    MNESourceEstimate createSourceEstimate(const QList< DipolePair<double> > &p_RapDipoles, int p_iNumSamples, float tmin, float tstep) const;
+
     //=========================================================================================================
     /**
     * Computes the subspace correlation between the projected G_rho and the projected signal subspace Phi_s.
@@ -245,12 +293,54 @@ protected:
 
     //=========================================================================================================
     /**
-    * Calculates the orthogonal projector Phi_A_k_1 like in the paper Mosher 1999 (13)
+    * Calculates an orthonormal basis Q_A of the manifold vectors. The orthogonal projector of Mosher 1999 (13)
+    * is then I - Q_A*Q_A^T, which can be applied as a rank-k update instead of a full m x m multiplication.
+    *
+    * @param[in] p_matA_k_1 The found manifold vectors.
+    * @param[out] p_matQ_A  The orthonormal basis (m x rank of A_k_1).
+    */
+    static void calcOrthBasis(const MatrixXT& p_matA_k_1, MatrixXT& p_matQ_A);
+
+    //=========================================================================================================
+    /**
+    * Prepares the per recursion quantities of the subspace correlation scan, so that each pair only needs
+    * fixed size 6 x 6 operations (see subcorrScan).
     *
-    * @param[in] p_matA_k_1 The array of the manifold vectors.
-    * @param[out] p_matOrthProj The orthogonal projector.
+    * @param[in] p_matQ_A       Orthonormal basis of the found sources (see calcOrthBasis).
+    * @param[in] p_matU_B       The matrix U is the subspace projection of the orthogonal projected Phi_s.
+    * @param[out] p_matQ_A_T_G  The gain matrix in the basis of the found sources Q_A^T*G.
+    * @param[out] p_matG_T_U_B  The correlation of the gain matrix with the signal subspace G^T*U_B.
     */
-    void calcOrthProj(const MatrixXT& p_matA_k_1, MatrixXT& p_matOrthProj) const;
+    void prepareSubcorrScan(const MatrixXT& p_matQ_A,
+                            const MatrixXT& p_matU_B,
+                            MatrixXT& p_matQ_A_T_G,
+                            MatrixXT& p_matG_T_U_B) const;
+
+    //=========================================================================================================
+    /**
+    * Computes the same correlation as subcorr for the projected gain pair of the given grid points, but
+    * works on the cached pair Gram matrix and the quantities of prepareSubcorrScan. The projected m x 6 pair
+    * is never formed.
+    *
+    * @param[in] p_iIdx1        first Lead Field index point
+    * @param[in] p_iIdx2        second Lead Field index point
+    * @param[in] p_matQ_A_T_G   The gain matrix in the basis of the found sources Q_A^T*G.
+    * @param[in] p_matG_T_U_B   The correlation of the gain matrix with the signal subspace G^T*U_B.
+    * @return   The maximal correlation c_1 of the subspace correlation.
+    */
+    double subcorrScan( int p_iIdx1, int p_iIdx2,
+                        const MatrixXT& p_matQ_A_T_G,
+                        const MatrixXT& p_matG_T_U_B) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the 6 x 6 Gram matrix G_pair^T*G_pair of a gain matrix pair, from the cache if available.
+    *
+    * @param[in] p_iIdx1    first Lead Field index point
+    * @param[in] p_iIdx2    second Lead Field index point
+    * @param[out] p_matGram The Gram matrix of the pair.
+    */
+    void getGainGramPair(int p_iIdx1, int p_iIdx2, Matrix6T& p_matGram) const;
 
     //=========================================================================================================
     /**
@@ -325,6 +415,11 @@ protected:
     int m_iNumLeadFieldCombinations;    /**< Number of Lead Filed combinations (grid points + 1 over 2)*/
 
     Pair** m_ppPairIdxCombinations; /**< Index combination vector with grid pair indices. */
+    bool m_bUsePairIdxCombinations; /**< Whether init builds the index combination vector (not needed by row wise scans). */
+
+    MatrixXT m_matGainGram;         /**< Cached Gram matrix G^T*G of the gain matrix (empty if too large). */
+
+    SignalSubspaceTracker m_subspaceTracker;    /**< Sliding window signal subspace of calculateInverseIncremental. */
 
     int m_iMaxNumThreads;   /**< Number of available CPU threads. */
 
@@ -0,0 +1,189 @@
+//=============================================================================================================
+/**
+* @file     signalsubspacetracker.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the SignalSubspaceTracker Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "signalsubspacetracker.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Eigenvalues>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace INVERSELIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SignalSubspaceTracker::SignalSubspaceTracker(int p_iNumChannels, int p_iWindowSize)
+: m_iNumChannels(0)
+, m_iWindowSize(0)
+, m_iWritePos(0)
+, m_iNumSamples(0)
+, m_iNumDowndated(0)
+{
+    init(p_iNumChannels, p_iWindowSize);
+}
+
+
+//*************************************************************************************************************
+
+void SignalSubspaceTracker::init(int p_iNumChannels, int p_iWindowSize)
+{
+    m_iNumChannels = p_iNumChannels > 0 ? p_iNumChannels : 0;
+    m_iWindowSize = p_iWindowSize > 0 ? p_iWindowSize : 0;
+
+    m_matWindow = MatrixXd::Zero(m_iNumChannels, m_iWindowSize);
+
+    reset();
+}
+
+
+//*************************************************************************************************************
+
+void SignalSubspaceTracker::reset()
+{
+    m_matFFT = MatrixXd::Zero(m_iNumChannels, m_iNumChannels);
+
+    m_iWritePos = 0;
+    m_iNumSamples = 0;
+    m_iNumDowndated = 0;
+}
+
+
+//*************************************************************************************************************
+
+void SignalSubspaceTracker::append(const MatrixXd& p_matBlock)
+{
+    if(p_matBlock.rows() != m_iNumChannels || m_iWindowSize == 0)
+        return;
+
+    //Only the last window of a long block can end up in the window
+    int t_iStart = p_matBlock.cols() > m_iWindowSize ? p_matBlock.cols() - m_iWindowSize : 0;
+    if(t_iStart > 0)
+        reset();
+
+    int t_iPos = t_iStart;
+    while(t_iPos < p_matBlock.cols())
+    {
+        //Contiguous chunk until the end of the ring buffer
+        int t_iChunk = std::min<int>(p_matBlock.cols() - t_iPos, m_iWindowSize - m_iWritePos);
+
+        //Downdate the samples which are overwritten
+        int t_iNumEvicted = std::max<int>(0, m_iNumSamples + t_iChunk - m_iWindowSize);
+        if(t_iNumEvicted > 0)
+        {
+            m_matFFT.selfadjointView<Lower>().rankUpdate(m_matWindow.middleCols(m_iWritePos, t_iNumEvicted), -1.0);
+            m_iNumDowndated += t_iNumEvicted;
+        }
+
+        m_matWindow.middleCols(m_iWritePos, t_iChunk) = p_matBlock.middleCols(t_iPos, t_iChunk);
+        m_matFFT.selfadjointView<Lower>().rankUpdate(m_matWindow.middleCols(m_iWritePos, t_iChunk), 1.0);
+
+        m_iNumSamples = std::min(m_iNumSamples + t_iChunk, m_iWindowSize);
+        m_iWritePos = (m_iWritePos + t_iChunk) % m_iWindowSize;
+        t_iPos += t_iChunk;
+    }
+
+    if(m_iNumDowndated >= m_iWindowSize)
+        refresh();
+}
+
+
+//*************************************************************************************************************
+
+int SignalSubspaceTracker::calcPhi_s(MatrixXd& p_matPhi_s) const
+{
+    if(m_iNumSamples == 0)
+    {
+        p_matPhi_s.resize(m_iNumChannels, 0);
+        return 0;
+    }
+
+    SelfAdjointEigenSolver<MatrixXd> t_eigFFT(m_matFFT);//only the lower triangle is read
+
+    //RapMusic::calcPhi_s thresholds the singular values of F*F^T if the window is longer than the number of
+    //channels and the singular values of F otherwise - keep the same rank decision
+    bool t_bUseFFT = m_iNumSamples > m_iNumChannels;
+
+    int t_iRank = 0;
+    for(int i = m_iNumChannels-1; i >= 0; --i)
+    {
+        double t_dLambda = std::max(t_eigFFT.eigenvalues()(i), 0.0);
+        double t_dSigma = t_bUseFFT ? t_dLambda : sqrt(t_dLambda);
+        if(t_dSigma > 0.00001)
+            ++t_iRank;
+        else
+            break;
+    }
+    if(t_iRank == 0)
+        t_iRank = 1;
+
+    //Eigenvalues are ascending -> the signal subspace are the last columns in reverse order
+    p_matPhi_s = t_eigFFT.eigenvectors().rightCols(t_iRank).rowwise().reverse();
+
+    return t_iRank;
+}
+
+
+//*************************************************************************************************************
+
+void SignalSubspaceTracker::refresh()
+{
+    m_matFFT.setZero();
+
+    if(m_iNumSamples == m_iWindowSize)
+        m_matFFT.selfadjointView<Lower>().rankUpdate(m_matWindow, 1.0);
+    else
+        m_matFFT.selfadjointView<Lower>().rankUpdate(m_matWindow.leftCols(m_iNumSamples), 1.0);
+
+    m_iNumDowndated = 0;
+}
@@ -0,0 +1,189 @@
+//=============================================================================================================
+/**
+* @file     signalsubspacetracker.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    SignalSubspaceTracker class declaration.
+*
+*/
+
+#ifndef SIGNALSUBSPACETRACKER_H
+#define SIGNALSUBSPACETRACKER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../inverse_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE INVERSELIB
+//=============================================================================================================
+
+namespace INVERSELIB
+{
+
+
+//=============================================================================================================
+/**
+* Tracks the signal subspace Phi_s (lt. Mosher 1998) of a sliding window over streamed measurement data.
+* The windowed F*F^T is updated with a symmetric rank-k update for every incoming block and downdated with
+* the samples which leave the window, so the cost per block only depends on the block length and not on the
+* window length. To bound the accumulated round-off of the downdates, F*F^T is recomputed from the stored
+* window once as many samples as the window holds have passed through it.
+*
+* @brief Sliding window signal subspace for streaming RAP MUSIC.
+*/
+class INVERSESHARED_EXPORT SignalSubspaceTracker
+{
+public:
+    //=========================================================================================================
+    /**
+    * Constructs a signal subspace tracker.
+    *
+    * @param[in] p_iNumChannels     Number of channels of the streamed data.
+    * @param[in] p_iWindowSize      Number of samples of the sliding window.
+    */
+    SignalSubspaceTracker(int p_iNumChannels = 0, int p_iWindowSize = 0);
+
+    //=========================================================================================================
+    /**
+    * (Re-)Initializes the tracker and drops all samples.
+    *
+    * @param[in] p_iNumChannels     Number of channels of the streamed data.
+    * @param[in] p_iWindowSize      Number of samples of the sliding window.
+    */
+    void init(int p_iNumChannels, int p_iWindowSize);
+
+    //=========================================================================================================
+    /**
+    * Drops all samples of the window.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Appends a data block to the window. Samples which leave the window are downdated.
+    *
+    * @param[in] p_matBlock     The incoming data (channels x samples).
+    */
+    void append(const Eigen::MatrixXd& p_matBlock);
+
+    //=========================================================================================================
+    /**
+    * Computes the signal subspace of the current window. The rank is determined like in RapMusic::calcPhi_s.
+    *
+    * @param[out] p_matPhi_s    The signal subspace (channels x rank).
+    *
+    * @return the rank of the windowed measurement.
+    */
+    int calcPhi_s(Eigen::MatrixXd& p_matPhi_s) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the current number of samples within the window.
+    *
+    * @return the number of samples.
+    */
+    inline int numSamples() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the size of the sliding window.
+    *
+    * @return the window size in samples.
+    */
+    inline int windowSize() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the windowed F*F^T (only the lower triangle is maintained).
+    *
+    * @return the windowed F*F^T.
+    */
+    inline const Eigen::MatrixXd& getFFT() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Recomputes F*F^T from the stored window.
+    */
+    void refresh();
+
+    Eigen::MatrixXd m_matWindow;    /**< Ring buffer of the windowed samples (channels x window size). */
+    Eigen::MatrixXd m_matFFT;       /**< Windowed F*F^T, lower triangle. */
+
+    int m_iNumChannels;             /**< Number of channels. */
+    int m_iWindowSize;              /**< Number of samples of the sliding window. */
+    int m_iWritePos;                /**< Next write position within the ring buffer. */
+    int m_iNumSamples;              /**< Number of valid samples within the ring buffer. */
+    int m_iNumDowndated;            /**< Number of downdated samples since the last refresh. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline int SignalSubspaceTracker::numSamples() const
+{
+    return m_iNumSamples;
+}
+
+
+//*************************************************************************************************************
+
+inline int SignalSubspaceTracker::windowSize() const
+{
+    return m_iWindowSize;
+}
+
+
+//*************************************************************************************************************
+
+inline const Eigen::MatrixXd& SignalSubspaceTracker::getFFT() const
+{
+    return m_matFFT;
+}
+
+} //NAMESPACE
+
+#endif // SIGNALSUBSPACETRACKER_H
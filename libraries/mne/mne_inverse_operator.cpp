@@ -48,6 +48,8 @@
 //=============================================================================================================
 
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 
 //*************************************************************************************************************
@@ -143,6 +145,7 @@ MNEInverseOperator::MNEInverseOperator(const MNEInverseOperator &p_MNEInverseOpe
 , whitener(p_MNEInverseOperator.whitener)
 , reginv(p_MNEInverseOperator.reginv)
 , noisenorm(p_MNEInverseOperator.noisenorm)
+, m_noiseNormCache(p_MNEInverseOperator.m_noiseNormCache)
 {
 
 }
@@ -823,7 +826,7 @@ MNEInverseOperator MNEInverseOperator::make_inverse_operator(const FiffInfo &inf
     for(qint32 i = 0; i < gain.rows(); ++i)
         gain.row(i) = gain.row(i).array() * source_std.array();
 
-    double trace_GRGT = (gain * gain.transpose()).trace();//pow(gain.norm(), 2);
+    double trace_GRGT = gain.squaredNorm();//trace(G*G^T) without forming the product
     double scaling_source_cov = (double)n_nzero / trace_GRGT;
 
     p_source_cov->data.array() *= scaling_source_cov;
@@ -837,22 +840,19 @@ MNEInverseOperator MNEInverseOperator::make_inverse_operator(const FiffInfo &inf
     // 12. Decompose the combined matrix
     //
     printf("Computing SVD of whitened and weighted lead field matrix.\n");
-    JacobiSVD<MatrixXd> svd(gain, ComputeThinU | ComputeThinV);
-    std::cout << "ToDo Sorting Necessary?" << std::endl;
-    VectorXd p_sing = svd.singularValues();
-    MatrixXd t_U = svd.matrixU();
-    MNEMath::sort<double>(p_sing, t_U);
-    FiffNamedMatrix::SDPtr p_eigen_fields = FiffNamedMatrix::SDPtr(new FiffNamedMatrix( svd.matrixU().cols(),
-                                                                                        svd.matrixU().rows(),
+    VectorXd p_sing;
+    MatrixXd t_U, t_V;
+    if(!MNEMath::gram_svd(gain, p_sing, t_U, t_V))
+        printf("\tGram matrix decomposition not accurate enough, used BDCSVD instead.\n");
+
+    FiffNamedMatrix::SDPtr p_eigen_fields = FiffNamedMatrix::SDPtr(new FiffNamedMatrix( t_U.cols(),
+                                                                                        t_U.rows(),
                                                                                         defaultQStringList,
                                                                                         gain_info.ch_names,
                                                                                         t_U.transpose() ));
 
-    p_sing = svd.singularValues();
-    MatrixXd t_V = svd.matrixV();
-    MNEMath::sort<double>(p_sing, t_V);
-    FiffNamedMatrix::SDPtr p_eigen_leads = FiffNamedMatrix::SDPtr(new FiffNamedMatrix( svd.matrixV().rows(),
-                                                                                       svd.matrixV().cols(),
+    FiffNamedMatrix::SDPtr p_eigen_leads = FiffNamedMatrix::SDPtr(new FiffNamedMatrix( t_V.rows(),
+                                                                                       t_V.cols(),
                                                                                        defaultQStringList,
                                                                                        defaultQStringList,
                                                                                        t_V ));
@@ -1005,55 +1005,32 @@ MNEInverseOperator MNEInverseOperator::prepare_inverse_operator(qint32 nave ,flo
     //
     //   Finally, compute the noise-normalization factors
     //
+    //   The prepared operator is scaled -> it starts with its own cache
+    //
+    inv.m_noiseNormCache.clear();
     if (dSPM || sLORETA)
     {
-        VectorXd noise_norm = VectorXd::Zero(inv.eigen_leads->nrow);
-        VectorXd noise_weight;
-        if (dSPM)
-        {
-           printf("\tComputing noise-normalization factors (dSPM)...");
-           noise_weight = VectorXd(inv.reginv);
-        }
-        else
-        {
-           printf("\tComputing noise-normalization factors (sLORETA)...");
-           VectorXd tmp = (VectorXd::Constant(inv.sing.size(), 1) + inv.sing.cwiseProduct(inv.sing)/lambda2);
-           noise_weight = inv.reginv.cwiseProduct(tmp.cwiseSqrt());
-        }
-        VectorXd one;
-        if (inv.eigen_leads_weighted)
+        NoiseNormKey key(nave, QPair<float, qint32>(lambda2, dSPM ? 1 : 2));
+        VectorXd noise_norm;
+
+        if (m_noiseNormCache.find(key, noise_norm))
         {
-           for (k = 0; k < inv.eigen_leads->nrow; ++k)
-           {
-              one = inv.eigen_leads->data.block(k,0,1,inv.eigen_leads->data.cols()).cwiseProduct(noise_weight);
-              noise_norm[k] = sqrt(one.dot(one));
-           }
+            printf("\tUsing cached noise-normalization factors (%s)\n", dSPM ? "dSPM" : "sLORETA");
         }
         else
         {
-//            qDebug() << 32;
-            double c;
-            for (k = 0; k < inv.eigen_leads->nrow; ++k)
+            VectorXd noise_weight;
+            if (dSPM)
             {
-//                qDebug() << 321;
-                c = sqrt(inv.source_cov->data(k,0));
-//                qDebug() << 322;
-//                qDebug() << "inv.eigen_leads->data" << inv.eigen_leads->data.rows() << "x" << inv.eigen_leads->data.cols();
-//                qDebug() << "noise_weight" << noise_weight.rows() << "x" << noise_weight.cols();
-                one = c*(inv.eigen_leads->data.row(k).transpose()).cwiseProduct(noise_weight);//ToDo eigenleads data -> pointer
-                noise_norm[k] = sqrt(one.dot(one));
-//                qDebug() << 324;
+               printf("\tComputing noise-normalization factors (dSPM)...");
+               noise_weight = VectorXd(inv.reginv);
+            }
+            else
+            {
+               printf("\tComputing noise-normalization factors (sLORETA)...");
+               VectorXd tmp = (VectorXd::Constant(inv.sing.size(), 1) + inv.sing.cwiseProduct(inv.sing)/lambda2);
+               noise_weight = inv.reginv.cwiseProduct(tmp.cwiseSqrt());
             }
-        }
-
-//        qDebug() << 4;
-
-        //
-        //   Compute the final result
-        //
-        VectorXd noise_norm_new;
-        if (inv.source_ori == FIFFV_MNE_FREE_ORI)
-        {
             //
             //   The three-component case is a little bit more involved
             //   The variances at three consequtive entries must be squeared and
@@ -1062,30 +1039,25 @@ MNEInverseOperator MNEInverseOperator::prepare_inverse_operator(qint32 nave ,flo
             //   Even in this case return only one noise-normalization factor
             //   per source location
             //
-            VectorXd* t = MNEMath::combine_xyz(noise_norm.transpose());
-            noise_norm_new = t->cwiseSqrt();//double otherwise values are getting too small
-            delete t;
-            //
-            //   This would replicate the same value on three consequtive
-            //   entries
-            //
-            //   noise_norm = kron(sqrt(mne_combine_xyz(noise_norm)),ones(3,1));
+            qint32 nComp = inv.source_ori == FIFFV_MNE_FREE_ORI ? 3 : 1;
+            noise_norm = calc_noise_norm(inv.eigen_leads->data,
+                                         noise_weight,
+                                         inv.eigen_leads_weighted ? VectorXd() : VectorXd(inv.source_cov->data.col(0)),
+                                         nComp);
+
+            m_noiseNormCache.insert(key, noise_norm);
+
+            printf("[done]\n");
         }
-        VectorXd vOnes = VectorXd::Ones(noise_norm_new.size());
-        VectorXd tmp = vOnes.cwiseQuotient(noise_norm_new.cwiseAbs());
-//        if(inv.noisenorm)
-//            delete inv.noisenorm;
 
         typedef Eigen::Triplet<double> T;
         std::vector<T> tripletList;
-        tripletList.reserve(noise_norm_new.size());
-        for(qint32 i = 0; i < noise_norm_new.size(); ++i)
-            tripletList.push_back(T(i, i, tmp[i]));
+        tripletList.reserve(noise_norm.size());
+        for(qint32 i = 0; i < noise_norm.size(); ++i)
+            tripletList.push_back(T(i, i, 1.0/std::fabs(noise_norm[i])));
 
-        inv.noisenorm = SparseMatrix<double>(noise_norm_new.size(),noise_norm_new.size());
+        inv.noisenorm = SparseMatrix<double>(noise_norm.size(),noise_norm.size());
         inv.noisenorm.setFromTriplets(tripletList.begin(), tripletList.end());
-
-        printf("[done]\n");
     }
     else
     {
@@ -1098,6 +1070,117 @@ MNEInverseOperator MNEInverseOperator::prepare_inverse_operator(qint32 nave ,flo
 }
 
 
+//*************************************************************************************************************
+
+void MNEInverseOperator::clear_noise_norm_cache() const
+{
+    m_noiseNormCache.clear();
+}
+
+
+//*************************************************************************************************************
+
+MNEInverseOperator::NoiseNormCache::NoiseNormCache()
+{
+}
+
+
+//*************************************************************************************************************
+
+MNEInverseOperator::NoiseNormCache::NoiseNormCache(const NoiseNormCache &p_cache)
+{
+    QMutexLocker t_locker(&p_cache.m_qMutex);
+    m_qMapNoiseNorm = p_cache.m_qMapNoiseNorm;
+}
+
+
+//*************************************************************************************************************
+
+MNEInverseOperator::NoiseNormCache& MNEInverseOperator::NoiseNormCache::operator=(const NoiseNormCache &p_cache)
+{
+    if(this == &p_cache)
+        return *this;
+
+    //Copy first, both locks are never held at once
+    p_cache.m_qMutex.lock();
+    QMap<NoiseNormKey, VectorXd> t_qMapNoiseNorm = p_cache.m_qMapNoiseNorm;
+    p_cache.m_qMutex.unlock();
+
+    QMutexLocker t_locker(&m_qMutex);
+    m_qMapNoiseNorm = t_qMapNoiseNorm;
+
+    return *this;
+}
+
+
+//*************************************************************************************************************
+
+bool MNEInverseOperator::NoiseNormCache::find(const NoiseNormKey &p_key, VectorXd &p_vecNoiseNorm) const
+{
+    QMutexLocker t_locker(&m_qMutex);
+
+    QMap<NoiseNormKey, VectorXd>::const_iterator it = m_qMapNoiseNorm.constFind(p_key);
+    if(it == m_qMapNoiseNorm.constEnd())
+        return false;
+
+    p_vecNoiseNorm = it.value();
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void MNEInverseOperator::NoiseNormCache::insert(const NoiseNormKey &p_key, const VectorXd &p_vecNoiseNorm)
+{
+    QMutexLocker t_locker(&m_qMutex);
+    m_qMapNoiseNorm.insert(p_key, p_vecNoiseNorm);
+}
+
+
+//*************************************************************************************************************
+
+void MNEInverseOperator::NoiseNormCache::clear()
+{
+    QMutexLocker t_locker(&m_qMutex);
+    m_qMapNoiseNorm.clear();
+}
+
+
+//*************************************************************************************************************
+
+VectorXd MNEInverseOperator::calc_noise_norm(const MatrixXd& eigen_leads, const VectorXd& noise_weight, const VectorXd& source_cov, qint32 nComp)
+{
+    //
+    //   Row blocks of whole source locations -> the xyz components are combined within a block
+    //
+    qint32 nLoc = eigen_leads.rows() / nComp;
+    qint32 nLocPerBlock = 512;
+
+    VectorXd noise_weight_sq = noise_weight.cwiseAbs2();
+
+    QList<NoiseNormBlock> blocks;
+    for(qint32 first = 0; first < nLoc; first += nLocPerBlock)
+    {
+        NoiseNormBlock block;
+        block.pEigenLeads = &eigen_leads;
+        block.pNoiseWeightSq = &noise_weight_sq;
+        block.pSourceCov = source_cov.size() > 0 ? &source_cov : NULL;
+        block.iFirstLoc = first;
+        block.iNumLoc = std::min(nLocPerBlock, nLoc - first);
+        block.iNumComp = nComp;
+        blocks.append(block);
+    }
+
+    QtConcurrent::blockingMap(blocks, &NoiseNormBlock::calc);
+
+    VectorXd noise_norm(nLoc);
+    for(qint32 i = 0; i < blocks.size(); ++i)
+        noise_norm.segment(blocks[i].iFirstLoc, blocks[i].iNumLoc) = blocks[i].vecNoiseNorm;
+
+    return noise_norm;
+}
+
+
 //*************************************************************************************************************
 
 bool MNEInverseOperator::read_inverse_operator(QIODevice& p_IODevice, MNEInverseOperator& inv)
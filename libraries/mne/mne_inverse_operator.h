@@ -74,6 +74,9 @@
 //=============================================================================================================
 
 #include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
 
 
 //*************************************************************************************************************
@@ -157,6 +160,35 @@ struct RegionMT
 };
 
 
+//=========================================================================================================
+/**
+* Row block of whole source locations, used for the parallel noise-normalization
+*/
+struct NoiseNormBlock
+{
+    const MatrixXd* pEigenLeads;        /**< Eigen leads (sources x eigen fields) */
+    const VectorXd* pNoiseWeightSq;     /**< Squared noise weights of the eigen fields */
+    const VectorXd* pSourceCov;         /**< Source covariance diagonal (NULL if the eigen leads are weighted) */
+
+    qint32      iFirstLoc;      /**< First source location of the block */
+    qint32      iNumLoc;        /**< Number of source locations of the block */
+    qint32      iNumComp;       /**< Number of components per source location (1 or 3) */
+
+    VectorXd    vecNoiseNorm;   /**< Resulting noise norm per source location */
+
+    void calc()
+    {
+        // Squared row norms of the weighted eigen leads
+        VectorXd vecRowNormSq = pEigenLeads->middleRows(iFirstLoc*iNumComp, iNumLoc*iNumComp).cwiseAbs2() * (*pNoiseWeightSq);
+        if(pSourceCov)
+            vecRowNormSq = vecRowNormSq.cwiseProduct(pSourceCov->segment(iFirstLoc*iNumComp, iNumLoc*iNumComp));
+
+        // Combine xyz
+        vecNoiseNorm = Map<MatrixXd>(vecRowNormSq.data(), iNumComp, iNumLoc).colwise().sum().transpose().cwiseSqrt();
+    }
+};
+
+
 //=============================================================================================================
 /**
 * Inverse operator
@@ -310,6 +342,14 @@ public:
     */
     MNEInverseOperator prepare_inverse_operator(qint32 nave ,float lambda2, bool dSPM, bool sLORETA = false) const;
 
+    //=========================================================================================================
+    /**
+    * The noise-normalization factors of prepare_inverse_operator are cached per (nave, lambda2, method). The
+    * cache has to be cleared when the decomposition of this operator is changed afterwards. The cache is guarded,
+    * prepare_inverse_operator may be called concurrently on a shared operator.
+    */
+    void clear_noise_norm_cache() const;
+
     //=========================================================================================================
     /**
     * mne_read_inverse_operator
@@ -381,7 +421,44 @@ public:
     SparseMatrix<double> noisenorm;         /**< These are the noise-normalization factors */
 
 private:
+    typedef QPair<qint32, QPair<float, qint32> > NoiseNormKey;  /**< nave, lambda2 and method (1 = dSPM, 2 = sLORETA) */
+
+    //=========================================================================================================
+    /**
+    * Noise-normalization factors by key. Every access locks, the cache is written from the const
+    * prepare_inverse_operator. Copies get their own lock.
+    */
+    class NoiseNormCache
+    {
+    public:
+        NoiseNormCache();
+        NoiseNormCache(const NoiseNormCache &p_cache);
+        NoiseNormCache& operator=(const NoiseNormCache &p_cache);
+
+        bool find(const NoiseNormKey &p_key, VectorXd &p_vecNoiseNorm) const;
+        void insert(const NoiseNormKey &p_key, const VectorXd &p_vecNoiseNorm);
+        void clear();
+
+    private:
+        QMap<NoiseNormKey, VectorXd> m_qMapNoiseNorm;   /**< The cached factors. */
+        mutable QMutex m_qMutex;                        /**< Guards the cached factors. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Computes the noise norm of every source location in parallel row blocks.
+    *
+    * @param[in] eigen_leads    The eigen leads of the prepared operator.
+    * @param[in] noise_weight   The dSPM or sLORETA weights of the eigen fields.
+    * @param[in] source_cov     The source covariance diagonal, empty if the eigen leads are weighted.
+    * @param[in] nComp          Number of components per source location (1 or 3).
+    *
+    * @return the noise norm of every source location.
+    */
+    static VectorXd calc_noise_norm(const MatrixXd& eigen_leads, const VectorXd& noise_weight, const VectorXd& source_cov, qint32 nComp);
+
     MatrixXd m_K;                           /**< Everytime a new kernel is assamebled a copy is stored here */
+    mutable NoiseNormCache m_noiseNormCache;    /**< Noise-normalization factors of prepared operators */
 };
 
 //*************************************************************************************************************
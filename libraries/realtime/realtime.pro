@@ -91,6 +91,9 @@ SOURCES += \
     rtClient/rtclient.cpp \
     rtClient/rtdataclient.cpp \
     rtClient/rtcmdclient.cpp \
+    rtClient/rawbufferpool.cpp \
+    rtClient/sharedmemoryring.cpp \
+    rtClient/rawbuffercodec.cpp \
     rtCommand/command.cpp \
     rtCommand/commandmanager.cpp \
     rtCommand/commandparser.cpp \
@@ -107,6 +110,9 @@ HEADERS +=  \
     rtClient/rtclient.h \
     rtClient/rtcmdclient.h \
     rtClient/rtdataclient.h \
+    rtClient/rawbufferpool.h \
+    rtClient/sharedmemoryring.h \
+    rtClient/rawbuffercodec.h \
     rtCommand/command.h \
     rtCommand/commandmanager.h \
     rtCommand/commandparser.h \
@@ -0,0 +1,234 @@
+//=============================================================================================================
+/**
+* @file     rawbuffercodec.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the RawBufferCodec class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rawbuffercodec.h"
+
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_file.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
+
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace REALTIMELIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+namespace
+{
+    const int payloadHeaderSize = 3 * (int)sizeof(qint32);    /**< Channels, samples and flags. */
+
+    void putFloat(float p_fValue, uchar* p_pDest)
+    {
+        quint32 t_iBits;
+        std::memcpy(&t_iBits, &p_fValue, sizeof(float));
+        qToBigEndian<quint32>(t_iBits, p_pDest);
+    }
+
+    float getFloat(const uchar* p_pSrc)
+    {
+        quint32 t_iBits = qFromBigEndian<quint32>(p_pSrc);
+        float t_fValue;
+        std::memcpy(&t_fValue, &t_iBits, sizeof(float));
+        return t_fValue;
+    }
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+QByteArray RawBufferCodec::encodeTag(const MatrixXf& p_matData, int p_iFlags)
+{
+    const int t_iRows = (int)p_matData.rows();
+    const int t_iCols = (int)p_matData.cols();
+
+    //
+    // Body, channel by channel
+    //
+    QByteArray t_blockBody;
+    if(p_iFlags & Int16)
+    {
+        t_blockBody.resize(t_iRows * (int)sizeof(float) + t_iRows * t_iCols * (int)sizeof(quint16));
+        uchar* t_pScales = reinterpret_cast<uchar*>(t_blockBody.data());
+        uchar* t_pSamples = t_pScales + t_iRows * sizeof(float);
+
+        for(int i = 0; i < t_iRows; ++i)
+        {
+            float t_fMax = t_iCols > 0 ? p_matData.row(i).cwiseAbs().maxCoeff() : 0.0f;
+            float t_fScale = t_fMax > 0.0f ? t_fMax / 32767.0f : 1.0f;
+            putFloat(t_fScale, t_pScales + i * sizeof(float));
+
+            //Differences wrap around, the decoder accumulates them the same way
+            qint32 t_iPrevious = 0;
+            for(int j = 0; j < t_iCols; ++j)
+            {
+                qint32 t_iValue = qBound(-32767, qRound(p_matData(i, j) / t_fScale), 32767);
+                qToBigEndian<quint16>((quint16)(t_iValue - t_iPrevious), t_pSamples);
+                t_pSamples += sizeof(quint16);
+                t_iPrevious = t_iValue;
+            }
+        }
+    }
+    else
+    {
+        t_blockBody.resize(t_iRows * t_iCols * (int)sizeof(float));
+        uchar* t_pSamples = reinterpret_cast<uchar*>(t_blockBody.data());
+
+        for(int i = 0; i < t_iRows; ++i)
+            for(int j = 0; j < t_iCols; ++j, t_pSamples += sizeof(float))
+                putFloat(p_matData(i, j), t_pSamples);
+    }
+
+    //Fast compression level, the server encodes each buffer once per profile in the acquisition thread
+    if(p_iFlags & Compressed)
+        t_blockBody = qCompress(t_blockBody, 1);
+
+    //
+    // Tag header and payload
+    //
+    const qint32 t_iPayloadSize = payloadHeaderSize + t_blockBody.size();
+
+    QByteArray t_blockTag(4 * (int)sizeof(qint32) + payloadHeaderSize, Qt::Uninitialized);
+    uchar* t_pHeader = reinterpret_cast<uchar*>(t_blockTag.data());
+    qToBigEndian<qint32>(FIFF_MNE_RT_PROFILED_BUFFER, t_pHeader);
+    qToBigEndian<qint32>(FIFFT_BYTE, t_pHeader + 4);
+    qToBigEndian<qint32>(t_iPayloadSize, t_pHeader + 8);
+    qToBigEndian<qint32>(FIFFV_NEXT_SEQ, t_pHeader + 12);
+    qToBigEndian<qint32>(t_iRows, t_pHeader + 16);
+    qToBigEndian<qint32>(t_iCols, t_pHeader + 20);
+    qToBigEndian<qint32>(p_iFlags & (Int16 | Compressed), t_pHeader + 24);
+
+    t_blockTag.append(t_blockBody);
+
+    return t_blockTag;
+}
+
+
+//*************************************************************************************************************
+
+bool RawBufferCodec::readDimensions(const char* p_pPayload, qint32 p_iSize, int& p_iRows, int& p_iCols)
+{
+    if(!p_pPayload || p_iSize < payloadHeaderSize)
+        return false;
+
+    const uchar* t_pHeader = reinterpret_cast<const uchar*>(p_pPayload);
+    p_iRows = qFromBigEndian<qint32>(t_pHeader);
+    p_iCols = qFromBigEndian<qint32>(t_pHeader + 4);
+
+    return p_iRows >= 0 && p_iCols >= 0;
+}
+
+
+//*************************************************************************************************************
+
+bool RawBufferCodec::decode(const char* p_pPayload, qint32 p_iSize, MatrixXf& p_matData)
+{
+    int t_iRows, t_iCols;
+    if(!readDimensions(p_pPayload, p_iSize, t_iRows, t_iCols))
+        return false;
+
+    const qint32 t_iFlags = qFromBigEndian<qint32>(reinterpret_cast<const uchar*>(p_pPayload) + 8);
+
+    QByteArray t_blockBody;
+    const uchar* t_pBody = reinterpret_cast<const uchar*>(p_pPayload) + payloadHeaderSize;
+    qint64 t_iBodySize = p_iSize - payloadHeaderSize;
+
+    if(t_iFlags & Compressed)
+    {
+        t_blockBody = qUncompress(t_pBody, (int)t_iBodySize);
+        t_pBody = reinterpret_cast<const uchar*>(t_blockBody.constData());
+        t_iBodySize = t_blockBody.size();
+    }
+
+    const qint64 t_iCount = (qint64)t_iRows * t_iCols;
+    const qint64 t_iExpected = (t_iFlags & Int16) ? t_iRows * (qint64)sizeof(float) + t_iCount * (qint64)sizeof(quint16)
+                                                  : t_iCount * (qint64)sizeof(float);
+    if(t_iBodySize != t_iExpected)
+        return false;
+
+    if(p_matData.rows() != t_iRows || p_matData.cols() != t_iCols)
+        p_matData.resize(t_iRows, t_iCols);
+
+    if(t_iFlags & Int16)
+    {
+        const uchar* t_pSamples = t_pBody + t_iRows * sizeof(float);
+
+        for(int i = 0; i < t_iRows; ++i)
+        {
+            const float t_fScale = getFloat(t_pBody + i * sizeof(float));
+
+            quint16 t_iValue = 0;
+            for(int j = 0; j < t_iCols; ++j)
+            {
+                t_iValue += qFromBigEndian<quint16>(t_pSamples);
+                t_pSamples += sizeof(quint16);
+                p_matData(i, j) = (qint16)t_iValue * t_fScale;
+            }
+        }
+    }
+    else
+    {
+        for(int i = 0; i < t_iRows; ++i)
+            for(int j = 0; j < t_iCols; ++j, t_pBody += sizeof(float))
+                p_matData(i, j) = getFloat(t_pBody);
+    }
+
+    return true;
+}
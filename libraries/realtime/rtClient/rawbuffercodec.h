@@ -0,0 +1,135 @@
+//=============================================================================================================
+/**
+* @file     rawbuffercodec.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the RawBufferCodec class.
+*
+*/
+
+#ifndef RAWBUFFERCODEC_H
+#define RAWBUFFERCODEC_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MNE INCLUDES
+//=============================================================================================================
+
+#include "../realtime_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QByteArray>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE REALTIMELIB
+//=============================================================================================================
+
+namespace REALTIMELIB
+{
+
+
+//=============================================================================================================
+/**
+* Encodes raw buffers of reduced size for slow links, as FIFF_MNE_RT_PROFILED_BUFFER tags. The data may be
+* scaled to 16 bit integers per channel and compressed losslessly with zlib. The integers are stored as
+* differences of consecutive samples, which compress well for smooth signals.
+*
+* The payload is big endian like all FIFF tags: channels, samples and flags as 32 bit integers, followed by the
+* (compressed) body. The body holds one scale factor per channel and the 16 bit differences channel by channel,
+* or the float samples channel by channel.
+*
+* @brief Encoding of profiled raw buffers
+*/
+class REALTIMESHARED_EXPORT RawBufferCodec
+{
+public:
+    /**
+    * The encoding of a profiled raw buffer.
+    */
+    enum Flag {
+        Int16       = 0x1,      /**< The samples are scaled to 16 bit integers per channel. */
+        Compressed  = 0x2       /**< The body is compressed with zlib. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Encodes a raw buffer as FIFF_MNE_RT_PROFILED_BUFFER tag, including the tag header.
+    *
+    * @param[in] p_matData  The raw buffer, channels x samples.
+    * @param[in] p_iFlags   Combination of Flag values.
+    *
+    * @return the encoded tag.
+    */
+    static QByteArray encodeTag(const Eigen::MatrixXf& p_matData, int p_iFlags);
+
+    //=========================================================================================================
+    /**
+    * Reads the dimensions from the payload of a FIFF_MNE_RT_PROFILED_BUFFER tag.
+    *
+    * @param[in] p_pPayload     The tag data.
+    * @param[in] p_iSize        Bytes of the tag data.
+    * @param[out] p_iRows       Number of channels.
+    * @param[out] p_iCols       Number of samples.
+    *
+    * @return true if the payload header is valid.
+    */
+    static bool readDimensions(const char* p_pPayload, qint32 p_iSize, int& p_iRows, int& p_iCols);
+
+    //=========================================================================================================
+    /**
+    * Decodes the payload of a FIFF_MNE_RT_PROFILED_BUFFER tag. The storage of the matrix is reused if its size
+    * matches.
+    *
+    * @param[in] p_pPayload     The tag data.
+    * @param[in] p_iSize        Bytes of the tag data.
+    * @param[out] p_matData     The raw buffer, channels x samples.
+    *
+    * @return true if the payload was decoded.
+    */
+    static bool decode(const char* p_pPayload, qint32 p_iSize, Eigen::MatrixXf& p_matData);
+};
+
+} // NAMESPACE
+
+#endif // RAWBUFFERCODEC_H
@@ -0,0 +1,144 @@
+//=============================================================================================================
+/**
+* @file     rawbufferpool.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the RawBufferPool class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rawbufferpool.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace REALTIMELIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RawBufferPool::RawBufferPool(int p_iCapacity)
+: m_pData(new Data)
+{
+    m_pData->iCapacity = qMax(1, p_iCapacity);
+    m_pData->iAllocated = 0;
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<MatrixXf> RawBufferPool::acquire(int p_iRows, int p_iCols)
+{
+    MatrixXf* t_pMatrix = Q_NULLPTR;
+
+    m_pData->mutex.lock();
+    if(!m_pData->listIdle.isEmpty())
+    {
+        t_pMatrix = m_pData->listIdle.takeLast();
+    }
+    else
+    {
+        ++m_pData->iAllocated;
+    }
+    m_pData->mutex.unlock();
+
+    if(!t_pMatrix)
+        t_pMatrix = new MatrixXf;
+
+    //Keeps the storage if the size did not change
+    t_pMatrix->resize(p_iRows, p_iCols);
+
+    return QSharedPointer<MatrixXf>(t_pMatrix, Recycler(m_pData));
+}
+
+
+//*************************************************************************************************************
+
+int RawBufferPool::allocatedCount() const
+{
+    QMutexLocker t_locker(&m_pData->mutex);
+    return m_pData->iAllocated;
+}
+
+
+//*************************************************************************************************************
+
+int RawBufferPool::idleCount() const
+{
+    QMutexLocker t_locker(&m_pData->mutex);
+    return m_pData->listIdle.size();
+}
+
+
+//*************************************************************************************************************
+
+RawBufferPool::Data::~Data()
+{
+    qDeleteAll(listIdle);
+}
+
+
+//*************************************************************************************************************
+
+RawBufferPool::Recycler::Recycler(const QSharedPointer<Data>& p_pData)
+: m_pData(p_pData)
+{
+}
+
+
+//*************************************************************************************************************
+
+void RawBufferPool::Recycler::operator()(MatrixXf* p_pMatrix) const
+{
+    QSharedPointer<Data> t_pData = m_pData.toStrongRef();
+
+    if(t_pData)
+    {
+        QMutexLocker t_locker(&t_pData->mutex);
+        if(t_pData->listIdle.size() < t_pData->iCapacity)
+        {
+            t_pData->listIdle.append(p_pMatrix);
+            return;
+        }
+    }
+
+    delete p_pMatrix;
+}
@@ -0,0 +1,152 @@
+//=============================================================================================================
+/**
+* @file     rawbufferpool.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the RawBufferPool class.
+*
+*/
+
+#ifndef RAWBUFFERPOOL_H
+#define RAWBUFFERPOOL_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MNE INCLUDES
+//=============================================================================================================
+
+#include "../realtime_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QMutex>
+#include <QList>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE REALTIMELIB
+//=============================================================================================================
+
+namespace REALTIMELIB
+{
+
+
+//=============================================================================================================
+/**
+* Hands out raw buffer matrices which return to the pool when the last shared pointer to them is released.
+* Consumers keep a buffer as long as they need it, the receiving thread reuses the storage afterwards instead
+* of allocating a new matrix per buffer. The pool may be destroyed before the buffers, released buffers are
+* deleted then.
+*
+* @brief Pool of recyclable raw buffer matrices
+*/
+class REALTIMESHARED_EXPORT RawBufferPool
+{
+public:
+    typedef QSharedPointer<RawBufferPool> SPtr;               /**< Shared pointer type for RawBufferPool. */
+    typedef QSharedPointer<const RawBufferPool> ConstSPtr;    /**< Const shared pointer type for RawBufferPool. */
+
+    //=========================================================================================================
+    /**
+    * Creates the pool.
+    *
+    * @param[in] p_iCapacity    Number of released matrices which are kept for reuse.
+    */
+    explicit RawBufferPool(int p_iCapacity = 16);
+
+    //=========================================================================================================
+    /**
+    * Returns a matrix of the requested size. A released matrix is reused, its content is undefined.
+    *
+    * @param[in] p_iRows    Number of rows, i.e. channels.
+    * @param[in] p_iCols    Number of columns, i.e. samples.
+    *
+    * @return the matrix, it returns to the pool when the last shared pointer is released.
+    */
+    QSharedPointer<Eigen::MatrixXf> acquire(int p_iRows, int p_iCols);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of matrices which were created by the pool so far.
+    *
+    * @return the number of created matrices.
+    */
+    int allocatedCount() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of released matrices which wait for reuse.
+    *
+    * @return the number of idle matrices.
+    */
+    int idleCount() const;
+
+private:
+    /**
+    * The state shared by the pool and the deleters of the handed out matrices.
+    */
+    struct Data {
+        ~Data();
+
+        mutable QMutex          mutex;          /**< Guards the idle list. */
+        QList<Eigen::MatrixXf*> listIdle;       /**< Released matrices. */
+        int                     iCapacity;      /**< Maximal number of idle matrices. */
+        int                     iAllocated;     /**< Number of created matrices. */
+    };
+
+    /**
+    * Deleter of the handed out matrices, returns them to the pool if it still exists.
+    */
+    struct Recycler {
+        explicit Recycler(const QSharedPointer<Data>& p_pData);
+        void operator()(Eigen::MatrixXf* p_pMatrix) const;
+
+        QWeakPointer<Data> m_pData;     /**< The pool state, the pool may be gone. */
+    };
+
+    QSharedPointer<Data> m_pData;       /**< The pool state. */
+};
+
+} // NAMESPACE
+
+#endif // RAWBUFFERPOOL_H
@@ -44,6 +44,18 @@
 #include "rtcmdclient.h"
 #include "rtdataclient.h"
 
+#include <utils/tracer.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QHostAddress>
+#include <QMetaMethod>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -51,6 +63,7 @@
 //=============================================================================================================
 
 using namespace REALTIMELIB;
+using namespace UTILSLIB;
 
 
 //*************************************************************************************************************
@@ -66,6 +79,8 @@ RtClient::RtClient(QString p_sRtServerHostname, QString p_sClientAlias, QObject
 , m_sClientAlias(p_sClientAlias)
 , m_sRtServerHostName(p_sRtServerHostname)
 {
+    qRegisterMetaType<Eigen::MatrixXf>("Eigen::MatrixXf");
+    qRegisterMetaType<QSharedPointer<Eigen::MatrixXf> >("QSharedPointer<Eigen::MatrixXf>");
 }
 
 
@@ -141,7 +156,9 @@ void RtClient::run()
     //
     // Inits
     //
-    MatrixXf t_matRawBuffer;
+    //The buffers are read in place and recycled, no allocation per buffer
+    RawBufferPool t_rawBufferPool;
+    QSharedPointer<MatrixXf> t_pMatRawBuffer;
 
     fiff_int_t kind;
 
@@ -163,12 +180,40 @@ void RtClient::run()
 //    qDebug() << t_cmdClient.readAvailableData();
 
 
-    // read meas info
+    // read meas info, the shared memory ring is requested in the same round trip
+    QList<Command> t_qListCommands;
     t_cmdClient["measinfo"].pValues()[0].setValue(clientId);
-    t_cmdClient["measinfo"].send();
+    t_qListCommands.append(t_cmdClient["measinfo"]);
+
+    // on the same host the raw buffers bypass the loopback socket, TCP is the fallback
+    QHostAddress t_hostAddress(m_sRtServerHostName);
+    bool t_bLocal = (t_hostAddress.isLoopback() || m_sRtServerHostName.compare("localhost", Qt::CaseInsensitive) == 0)
+            && t_cmdClient.hasCommand("shmem");
+    if(t_bLocal)
+    {
+        t_cmdClient["shmem"].pValues()[0].setValue(QString::number(clientId));
+        t_cmdClient["shmem"].pValues()[1].setValue(16*1024*1024);
+        t_qListCommands.append(t_cmdClient["shmem"]);
+    }
+
+    QList<qint32> t_qListIds = t_cmdClient.sendCommands(t_qListCommands);
 
     m_pFiffInfo = t_dataClient.readInfo();
 
+    if(t_bLocal && t_qListIds.size() == 2 && t_cmdClient.waitForReplies(t_qListIds))
+    {
+        t_cmdClient.takeReply(t_qListIds[0]);
+        QString t_sKey = RtCmdClient::sharedMemoryKey(t_cmdClient.takeReply(t_qListIds[1]));
+
+        if(!t_sKey.isEmpty())
+        {
+            if(t_dataClient.attachSharedMemory(t_sKey))
+                qInfo() << "Receiving raw buffers via shared memory" << t_sKey;
+            else
+                t_cmdClient.requestSharedMemory(clientId, 0);
+        }
+    }
+
     // start measurement
     t_cmdClient["start"].pValues()[0].setValue(clientId);
     t_cmdClient["start"].send();
@@ -179,17 +224,27 @@ void RtClient::run()
 //        while(m_bIsMeasuring)
 
 
-        t_dataClient.readRawBuffer(m_pFiffInfo->nchan, t_matRawBuffer, kind);
+        t_pMatRawBuffer = t_dataClient.readRawBuffer(m_pFiffInfo->nchan, t_rawBufferPool, kind);
 
-        if(kind == FIFF_DATA_BUFFER)
+        if(kind == FIFF_DATA_BUFFER && t_pMatRawBuffer)
         {
-            to += t_matRawBuffer.cols();
+            //The buffer enters the processing chain here
+            static const int s_iTraceStage = Tracer::registerStage("RtClient");
+            TraceBufferScope traceBuffer(s_iTraceStage);
+
+            to += t_pMatRawBuffer->cols();
             printf("Reading %d ... %d  =  %9.3f ... %9.3f secs...", from, to, ((float)from)/m_pFiffInfo->sfreq, ((float)to)/m_pFiffInfo->sfreq);
-            from += t_matRawBuffer.cols();
+            from += t_pMatRawBuffer->cols();
+
+            emit sharedRawBufferReceived(t_pMatRawBuffer);
+
+            //The copying signal is kept for existing receivers
+            if(isSignalConnected(QMetaMethod::fromSignal(&RtClient::rawBufferReceived)))
+                emit rawBufferReceived(*t_pMatRawBuffer);
 
-            emit rawBufferReceived(t_matRawBuffer);
+            t_pMatRawBuffer.clear();
         }
-        else if(FIFF_DATA_BUFFER == FIFF_BLOCK_END)
+        else if(FIFF_DATA_BUFFER == FIFF_BLOCK_END || kind == -1)
             m_bIsRunning = false;
 
         printf("[done]\n");
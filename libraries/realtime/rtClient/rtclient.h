@@ -168,12 +168,22 @@ private:
 signals:
     //=========================================================================================================
     /**
-    * Emits a received raw buffer - ToDo change the emits to fiff raw data.
+    * Emits a received raw buffer - ToDo change the emits to fiff raw data. The buffer is copied for every
+    * queued receiver, use sharedRawBufferReceived to avoid the copies. Only emitted if it is connected.
     *
     * @param[in] p_rawBuffer    the received raw buffer
     */
     void rawBufferReceived(Eigen::MatrixXf p_rawBuffer);
 
+    //=========================================================================================================
+    /**
+    * Emits a received raw buffer. All receivers share the buffer, it is recycled by the client once the last
+    * receiver released it.
+    *
+    * @param[in] p_pRawBuffer   the received raw buffer
+    */
+    void sharedRawBufferReceived(QSharedPointer<Eigen::MatrixXf> p_pRawBuffer);
+
     //=========================================================================================================
     /**
     * Emitted when connection status changed
@@ -201,4 +211,9 @@ inline FiffInfo::SPtr& RtClient::getFiffInfo()
 Q_DECLARE_METATYPE(Eigen::MatrixXf);    /**< Provides QT META type declaration of the Eigen::MatrixXf type. For signal/slot usage.*/
 #endif
 
+#ifndef metatype_sharedpointermatrixxf
+#define metatype_sharedpointermatrixxf
+Q_DECLARE_METATYPE(QSharedPointer<Eigen::MatrixXf>);    /**< Provides QT META type declaration of the shared raw buffer type. For signal/slot usage.*/
+#endif
+
 #endif // RTCLIENT_H
@@ -41,6 +41,7 @@
 //=============================================================================================================
 
 #include "rtcmdclient.h"
+#include "../rtCommand/commandparser.h"
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -48,6 +49,7 @@
 //=============================================================================================================
 
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QThread>
 
 #include <iostream>
@@ -69,9 +71,16 @@ using namespace REALTIMELIB;
 
 RtCmdClient::RtCmdClient(QObject *parent) :
         QTcpSocket(parent)
+        , m_iNextRequestId(0)
+        , m_iReplyBlockSize(0)
+        , m_bBinaryEncoding(false)
 {
     QObject::connect(&m_commandManager, &CommandManager::triggered, this,
             &RtCmdClient::sendCommandJSON);
+
+    //Also called while waitForReadyRead blocks
+    QObject::connect(this, &QTcpSocket::readyRead, this,
+            &RtCmdClient::readReplies);
 }
 
 //*************************************************************************************************************
@@ -115,6 +124,15 @@ void RtCmdClient::sendCommandJSON(const Command &p_command)
 
     QString t_sReply;
 
+    //The reply has to be the next block on the socket
+    if(!m_qListPendingIds.isEmpty() && !waitForReplies(m_qListPendingIds))
+    {
+        qWarning() << "Pipelined commands did not receive a reply!";
+        m_qListPendingIds.clear();
+        m_qMapReplyParts.clear();
+        m_iReplyBlockSize = 0;
+    }
+
     if (this->state() == QAbstractSocket::ConnectedState)
     {
         // Send request
@@ -190,6 +208,153 @@ void RtCmdClient::sendCommandJSON(const Command &p_command)
 }
 
 
+//*************************************************************************************************************
+
+QList<qint32> RtCmdClient::sendCommands(const QList<Command> &p_qListCommands)
+{
+    QList<qint32> t_qListIds;
+
+    if (this->state() != QAbstractSocket::ConnectedState)
+    {
+        qWarning() << "Requests were not send, because client is not connected!";
+        return t_qListIds;
+    }
+
+    QByteArray t_blockRequests;
+
+    for(qint32 i = 0; i < p_qListCommands.size(); ++i)
+    {
+        qint32 t_iId = m_iNextRequestId++;
+
+        QByteArray t_blockRequest;
+        if(m_bBinaryEncoding)
+            t_blockRequest = CommandParser::encodeCommand(p_qListCommands[i], t_iId);
+        else
+        {
+            QDataStream out(&t_blockRequest, QIODevice::WriteOnly);
+            out.setVersion(QDataStream::Qt_5_1);
+            out << QString("{\"id\":%1,\"commands\":{%2}}").arg(t_iId).arg(p_qListCommands[i].toStringReadySend());
+        }
+
+        //Same framing as the blocking commands, the server reads all blocks of the write
+        QByteArray t_blockFrame;
+        QDataStream out(&t_blockFrame, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_1);
+        out << (quint16)t_blockRequest.size();
+        t_blockFrame.append(t_blockRequest);
+
+        t_blockRequests.append(t_blockFrame);
+        t_qListIds.append(t_iId);
+        m_qListPendingIds.append(t_iId);
+    }
+
+    this->write(t_blockRequests);
+    this->flush();
+
+    return t_qListIds;
+}
+
+
+//*************************************************************************************************************
+
+bool RtCmdClient::waitForReplies(const QList<qint32> &p_qListIds, qint32 msecs)
+{
+    QElapsedTimer t_timer;
+    t_timer.start();
+
+    forever
+    {
+        bool t_bComplete = true;
+        for(qint32 i = 0; i < p_qListIds.size() && t_bComplete; ++i)
+            t_bComplete = !m_qListPendingIds.contains(p_qListIds[i]);
+
+        if(t_bComplete)
+            return true;
+
+        if(this->state() != QAbstractSocket::ConnectedState || (msecs != -1 && t_timer.elapsed() >= msecs))
+            return false;
+
+        //readyRead reads the replies
+        this->waitForReadyRead(100);
+    }
+}
+
+
+//*************************************************************************************************************
+
+QString RtCmdClient::takeReply(qint32 p_iId)
+{
+    QMutexLocker t_locker(&m_qMutex);
+
+    return m_qMapReplies.take(p_iId);
+}
+
+
+//*************************************************************************************************************
+
+void RtCmdClient::readReplies()
+{
+    QDataStream in(this);
+    in.setVersion(QDataStream::Qt_5_1);
+
+    //The blocking commands read their reply themselves
+    while(!m_qListPendingIds.isEmpty())
+    {
+        if(m_iReplyBlockSize == 0)
+        {
+            if(this->bytesAvailable() < (int)sizeof(quint16))
+                return;
+
+            in >> m_iReplyBlockSize;
+        }
+
+        if(this->bytesAvailable() < m_iReplyBlockSize)
+            return;
+
+        QByteArray t_blockReply = this->read(m_iReplyBlockSize);
+        m_iReplyBlockSize = 0;
+
+        qint32 t_iId;
+        QString t_sReply;
+        QByteArray t_blockPart;
+        bool t_bLast;
+        if(CommandParser::decodeReplyPart(t_blockReply, t_iId, t_blockPart, t_bLast))
+        {
+            //A split reply is decoded when its last frame arrived
+            if(!t_bLast)
+            {
+                if(m_qListPendingIds.contains(t_iId))
+                    m_qMapReplyParts[t_iId].append(t_blockPart);
+                continue;
+            }
+
+            t_sReply = QString::fromUtf8(m_qMapReplyParts.take(t_iId).append(t_blockPart));
+        }
+        else
+        {
+            //Servers without request ids answer in order
+            QDataStream t_streamReply(t_blockReply);
+            t_streamReply.setVersion(QDataStream::Qt_5_1);
+            t_streamReply >> t_sReply;
+            t_iId = m_qListPendingIds.first();
+        }
+
+        //A reply after a timeout is dropped
+        if(!m_qListPendingIds.removeOne(t_iId))
+            continue;
+
+        m_qMutex.lock();
+        m_qMapReplies.insert(t_iId, t_sReply);
+        //Replies which are never taken do not pile up
+        while(m_qMapReplies.size() > 256)
+            m_qMapReplies.erase(m_qMapReplies.begin());
+        m_qMutex.unlock();
+
+        emit reply(t_iId, t_sReply);
+    }
+}
+
+
 //*************************************************************************************************************
 
 qint32 RtCmdClient::requestBufsize()
@@ -302,6 +467,47 @@ qint32 RtCmdClient::requestConnectors(QMap<qint32, QString> &p_qMapConnectors)
 }
 
 
+//*************************************************************************************************************
+
+QString RtCmdClient::requestSharedMemory(qint32 p_iClientId, qint32 p_iSize)
+{
+    //Older servers do not know the command
+    if(!m_commandManager.hasCommand("shmem"))
+        return QString();
+
+    //Send
+    m_commandManager["shmem"].pValues()[0].setValue(QString::number(p_iClientId));
+    m_commandManager["shmem"].pValues()[1].setValue(p_iSize);
+    m_commandManager["shmem"].send();
+
+    //Receive
+    m_qMutex.lock();
+    QString t_sJsonShmem = m_sAvailableData;
+    m_qMutex.unlock();
+
+    return sharedMemoryKey(t_sJsonShmem);
+}
+
+
+//*************************************************************************************************************
+
+QString RtCmdClient::sharedMemoryKey(const QString &p_sReply)
+{
+    //Parse
+    QJsonParseError error;
+    QJsonDocument t_jsonDocumentOrigin = QJsonDocument::fromJson(p_sReply.toUtf8(), &error);
+
+    if(error.error == QJsonParseError::NoError && t_jsonDocumentOrigin.isObject()
+            && t_jsonDocumentOrigin.object().value(QString("shmem")) != QJsonValue::Undefined)
+    {
+        return t_jsonDocumentOrigin.object().value(QString("shmem")).toObject().value(QString("key")).toString();
+    }
+
+    qCritical() << "Unable to parse JSON response: " << error.errorString();
+    return QString();
+}
+
+
 ////*************************************************************************************************************
 
 //void RtCmdClient::requestMeasInfo(qint32 p_id)
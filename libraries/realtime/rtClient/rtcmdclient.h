@@ -55,6 +55,8 @@
 //=============================================================================================================
 
 #include <QDataStream>
+#include <QList>
+#include <QMap>
 #include <QMutex>
 #include <QSharedPointer>
 #include <QString>
@@ -79,6 +81,10 @@ namespace REALTIMELIB
 /**
 * The real-time command client class provides an interface to communicate with the command port 4217 of a running mne_rt_server.
 *
+* Besides the blocking commands, several commands can be pipelined: sendCommands writes them at once, each with a
+* request id, and the replies are matched by id as they arrive. On remote links a startup sequence then costs one
+* round trip instead of one per command. Optionally the pipelined commands are binary encoded.
+*
 * @brief Real-time command client
 */
 class REALTIMESHARED_EXPORT RtCmdClient : public QTcpSocket
@@ -134,6 +140,55 @@ public:
     */
     void sendCommandJSON(const Command &p_command);
 
+    //=========================================================================================================
+    /**
+    * Sends several commands in one write without waiting for the replies. Each command gets a request id, the
+    * replies are emitted by reply() and kept for takeReply(). A blocking command waits for the pending replies
+    * first.
+    *
+    * @param[in] p_qListCommands    The commands with their parameter values.
+    *
+    * @return the request ids in the order of the commands, empty if the client is not connected.
+    */
+    QList<qint32> sendCommands(const QList<Command> &p_qListCommands);
+
+    //=========================================================================================================
+    /**
+    * Waits until the replies to the given requests arrived.
+    *
+    * @param[in] p_qListIds     The request ids.
+    * @param[in] msecs          time to wait in milliseconds, if -1 function will not time out. Default value is 30000.
+    *
+    * @return true if all replies arrived.
+    */
+    bool waitForReplies(const QList<qint32> &p_qListIds, qint32 msecs = 30000);
+
+    //=========================================================================================================
+    /**
+    * Returns and removes the reply to a request. The latest replies are kept until they are taken.
+    *
+    * @param[in] p_iId  The request id.
+    *
+    * @return the reply, empty if it did not arrive (yet).
+    */
+    QString takeReply(qint32 p_iId);
+
+    //=========================================================================================================
+    /**
+    * Selects the binary command encoding for pipelined commands, the server has to support it. JSON is the default.
+    *
+    * @param[in] p_bBinary  True to encode binary.
+    */
+    inline void setBinaryEncoding(bool p_bBinary);
+
+    //=========================================================================================================
+    /**
+    * Returns whether pipelined commands are binary encoded.
+    *
+    * @return true if binary encoded.
+    */
+    inline bool binaryEncoding() const;
+
     //=========================================================================================================
     /**
     * Returns the available data.
@@ -164,6 +219,27 @@ public:
     */
     qint32 requestConnectors(QMap<qint32, QString> &p_qMapConnectors);
 
+    //=========================================================================================================
+    /**
+    * Requests a shared memory ring for the raw buffers of a data client on the same host as mne_rt_server.
+    *
+    * @param[in] p_iClientId    The id of the data client
+    * @param[in] p_iSize        Bytes of the ring, 0 returns to TCP
+    *
+    * @return the key of the ring, empty if the server uses TCP.
+    */
+    QString requestSharedMemory(qint32 p_iClientId, qint32 p_iSize);
+
+    //=========================================================================================================
+    /**
+    * Returns the key of the shared memory ring from the JSON reply to a shmem command.
+    *
+    * @param[in] p_sReply   The reply.
+    *
+    * @return the key of the ring, empty if the server uses TCP.
+    */
+    static QString sharedMemoryKey(const QString &p_sReply);
+
     //=========================================================================================================
     /**
     * Wait for ready read until data are available.
@@ -203,10 +279,32 @@ signals:
     */
     void response(QString p_sResponse);
 
+    //=========================================================================================================
+    /**
+    * Emits the reply to a pipelined command.
+    *
+    * @param[in] p_iId      the request id
+    * @param[in] p_sReply   the received reply
+    */
+    void reply(qint32 p_iId, QString p_sReply);
+
 private:
+    //=========================================================================================================
+    /**
+    * Reads the replies to the pipelined commands which are available on the socket.
+    */
+    void readReplies();
+
     CommandManager  m_commandManager;   /**< The command manager. */
     QMutex          m_qMutex;           /**< Access serialization between threads */
     QString         m_sAvailableData;   /**< The last received response. */
+
+    qint32                  m_iNextRequestId;   /**< Id of the next pipelined command. */
+    QList<qint32>           m_qListPendingIds;  /**< Pipelined commands which wait for their reply, in send order. */
+    QMap<qint32, QString>   m_qMapReplies;      /**< Replies which were not taken yet. */
+    QMap<qint32, QByteArray> m_qMapReplyParts;  /**< Leading parts of split replies which are currently received. */
+    quint16                 m_iReplyBlockSize;  /**< Size of the reply block which is currently received, 0 while waiting for a new block. */
+    bool                    m_bBinaryEncoding;  /**< Whether pipelined commands are binary encoded. */
 };
 
 //*************************************************************************************************************
@@ -232,6 +330,22 @@ inline bool RtCmdClient::hasCommand(const QString &p_sCommand) const
     return m_commandManager.hasCommand(p_sCommand);
 }
 
+
+//*************************************************************************************************************
+
+inline void RtCmdClient::setBinaryEncoding(bool p_bBinary)
+{
+    m_bBinaryEncoding = p_bBinary;
+}
+
+
+//*************************************************************************************************************
+
+inline bool RtCmdClient::binaryEncoding() const
+{
+    return m_bBinaryEncoding;
+}
+
 } // NAMESPACE
 
 #endif // RTCMDCLIENT_H
@@ -41,7 +41,17 @@
 //=============================================================================================================
 
 #include "rtdataclient.h"
+#include "rawbuffercodec.h"
 #include <fiff/fiff_file.h>
+#include <utils/ioutils.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
 
 
 //*************************************************************************************************************
@@ -50,6 +60,15 @@
 //=============================================================================================================
 
 using namespace REALTIMELIB;
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// CONST
+//=============================================================================================================
+
+const int ringLivenessMsecs = 500;      /**< Wait for a shared memory record before the socket is checked. */
 
 
 //*************************************************************************************************************
@@ -60,6 +79,10 @@ using namespace REALTIMELIB;
 RtDataClient::RtDataClient(QObject *parent)
 : QTcpSocket(parent)
 , m_clientID(-1)
+, m_pRecord(Q_NULLPTR)
+, m_iRecordSize(0)
+, m_iRecordOffset(0)
+, m_bWatchSocket(false)
 {
     getClientId();
 }
@@ -360,25 +383,247 @@ FiffInfo::SPtr RtDataClient::readInfo()
 
 void RtDataClient::readRawBuffer(qint32 p_nChannels, MatrixXf& data, fiff_int_t& kind)
 {
-//        data = [];
+    fiff_int_t t_type;
+    qint32 t_iSize;
 
-    FiffStream t_fiffStream(this);
-    //
-    // Find the start
-    //
-    FiffTag::SPtr t_pTag;
+    if(!readTagHeader(kind, t_type, t_iSize))
+    {
+        kind = -1;
+        return;
+    }
+
+    if(kind == FIFF_DATA_BUFFER && t_type == FIFFT_FLOAT && p_nChannels > 0)
+    {
+        qint32 nSamples = (t_iSize/4)/p_nChannels;
+
+        //No reallocation as long as the buffer size does not change
+        data.resize(p_nChannels, nSamples);
+        if(!readFloatData(data.data(), data.size(), t_iSize))
+            kind = -1;
+    }
+    else if(kind == FIFF_MNE_RT_PROFILED_BUFFER)
+    {
+        const char* t_pPayload = readPayload(t_iSize);
+
+        if(!t_pPayload)
+            kind = -1;
+        else if(RawBufferCodec::decode(t_pPayload, t_iSize, data))
+            kind = FIFF_DATA_BUFFER;
+    }
+    else if(!readBytes(Q_NULLPTR, t_iSize))
+    {
+        kind = -1;
+    }
+
+    finishTag();
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<MatrixXf> RtDataClient::readRawBuffer(qint32 p_nChannels, RawBufferPool& p_pool, fiff_int_t& kind)
+{
+    fiff_int_t t_type;
+    qint32 t_iSize;
+
+    if(!readTagHeader(kind, t_type, t_iSize))
+    {
+        kind = -1;
+        return QSharedPointer<MatrixXf>();
+    }
+
+    if(kind == FIFF_DATA_BUFFER && t_type == FIFFT_FLOAT && p_nChannels > 0)
+    {
+        QSharedPointer<MatrixXf> t_pMatRawBuffer = p_pool.acquire(p_nChannels, (t_iSize/4)/p_nChannels);
+
+        bool t_bRead = readFloatData(t_pMatRawBuffer->data(), t_pMatRawBuffer->size(), t_iSize);
+        finishTag();
+
+        if(t_bRead)
+            return t_pMatRawBuffer;
+    }
+    else if(kind == FIFF_MNE_RT_PROFILED_BUFFER)
+    {
+        const char* t_pPayload = readPayload(t_iSize);
+        int t_iRows, t_iCols;
+
+        if(t_pPayload)
+        {
+            QSharedPointer<MatrixXf> t_pMatRawBuffer;
+            if(RawBufferCodec::readDimensions(t_pPayload, t_iSize, t_iRows, t_iCols))
+            {
+                t_pMatRawBuffer = p_pool.acquire(t_iRows, t_iCols);
+                if(RawBufferCodec::decode(t_pPayload, t_iSize, *t_pMatRawBuffer))
+                    kind = FIFF_DATA_BUFFER;
+                else
+                    t_pMatRawBuffer.clear();
+            }
+            finishTag();
+
+            return t_pMatRawBuffer;
+        }
+        finishTag();
+    }
+    else
+    {
+        bool t_bRead = readBytes(Q_NULLPTR, t_iSize);
+        finishTag();
+
+        if(t_bRead)
+            return QSharedPointer<MatrixXf>();
+    }
+
+    kind = -1;
+    return QSharedPointer<MatrixXf>();
+}
+
+
+//*************************************************************************************************************
+
+bool RtDataClient::attachSharedMemory(const QString& p_sKey)
+{
+    detachSharedMemory();
+
+    SharedMemoryRing::SPtr t_pSharedMemoryRing(new SharedMemoryRing);
+    if(!t_pSharedMemoryRing->attach(p_sKey))
+        return false;
+
+    m_pSharedMemoryRing = t_pSharedMemoryRing;
+    m_bWatchSocket = this->state() == QAbstractSocket::ConnectedState;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void RtDataClient::detachSharedMemory()
+{
+    finishTag();
+    m_pSharedMemoryRing.clear();
+}
 
-    t_fiffStream.read_rt_tag(t_pTag);
 
-    kind = t_pTag->kind;
+//*************************************************************************************************************
 
-    if(kind == FIFF_DATA_BUFFER)
+bool RtDataClient::readTagHeader(fiff_int_t& p_kind, fiff_int_t& p_type, qint32& p_iSize)
+{
+    //A shared memory record holds exactly one tag
+    if(m_pSharedMemoryRing)
     {
-        qint32 nSamples = (t_pTag->size()/4)/p_nChannels;
-        data = MatrixXf(Map< MatrixXf >(t_pTag->toFloat(), p_nChannels, nSamples));
+        finishTag();
+        while(!m_pSharedMemoryRing->beginRead(m_pRecord, m_iRecordSize, ringLivenessMsecs))
+        {
+            //A server which died without closing the ring has dropped the data connection as well
+            if(m_bWatchSocket)
+                this->waitForReadyRead(0);
+
+            if(m_pSharedMemoryRing->isClosed() || (m_bWatchSocket && this->state() != QAbstractSocket::ConnectedState))
+            {
+                m_pRecord = Q_NULLPTR;
+                return false;
+            }
+        }
     }
-//        else
-//            data = tag.data;
+
+    //kind, type, size and next, big endian
+    uchar t_header[4*sizeof(qint32)];
+    if(!readBytes(reinterpret_cast<char*>(t_header), sizeof(t_header)))
+        return false;
+
+    p_kind = qFromBigEndian<qint32>(t_header);
+    p_type = qFromBigEndian<qint32>(t_header + sizeof(qint32));
+    p_iSize = qFromBigEndian<qint32>(t_header + 2*sizeof(qint32));
+
+    return p_iSize >= 0;
+}
+
+
+//*************************************************************************************************************
+
+bool RtDataClient::readFloatData(float* p_pData, qint64 p_iCount, qint32 p_iSize)
+{
+    qint64 t_iBytes = p_iCount*(qint64)sizeof(float);
+
+    if(!readBytes(reinterpret_cast<char*>(p_pData), t_iBytes) || !readBytes(Q_NULLPTR, p_iSize - t_iBytes))
+        return false;
+
+    IOUtils::swap_floatp(p_pData, p_iCount);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RtDataClient::readBytes(char* p_pData, qint64 p_iSize)
+{
+    if(m_pRecord)
+    {
+        if(p_iSize > m_iRecordSize - m_iRecordOffset)
+            return false;
+
+        if(p_pData)
+            memcpy(p_pData, m_pRecord + m_iRecordOffset, p_iSize);
+        m_iRecordOffset += p_iSize;
+
+        return true;
+    }
+
+    char t_skipped[4096];
+    qint64 t_iRead = 0;
+
+    while(t_iRead < p_iSize)
+    {
+        qint64 t_iChunk = p_pData ? this->read(p_pData + t_iRead, p_iSize - t_iRead)
+                                  : this->read(t_skipped, qMin<qint64>(sizeof(t_skipped), p_iSize - t_iRead));
+        if(t_iChunk < 0)
+            return false;
+
+        t_iRead += t_iChunk;
+
+        if(t_iRead < p_iSize && this->bytesAvailable() == 0
+                && !this->waitForReadyRead(10) && this->state() != QAbstractSocket::ConnectedState)
+            return false;
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+const char* RtDataClient::readPayload(qint32 p_iSize)
+{
+    //The record stays valid until finishTag, no copy needed
+    if(m_pRecord)
+    {
+        if(p_iSize > m_iRecordSize - m_iRecordOffset)
+            return Q_NULLPTR;
+
+        const char* t_pPayload = m_pRecord + m_iRecordOffset;
+        m_iRecordOffset += p_iSize;
+
+        return t_pPayload;
+    }
+
+    if(m_blockPayload.size() < p_iSize)
+        m_blockPayload.resize(p_iSize);
+
+    return readBytes(m_blockPayload.data(), p_iSize) ? m_blockPayload.constData() : Q_NULLPTR;
+}
+
+
+//*************************************************************************************************************
+
+void RtDataClient::finishTag()
+{
+    if(m_pRecord && m_pSharedMemoryRing)
+        m_pSharedMemoryRing->endRead();
+
+    m_pRecord = Q_NULLPTR;
+    m_iRecordSize = 0;
+    m_iRecordOffset = 0;
 }
 
 
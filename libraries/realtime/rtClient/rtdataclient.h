@@ -44,6 +44,8 @@
 //=============================================================================================================
 
 #include "../realtime_global.h"
+#include "rawbufferpool.h"
+#include "sharedmemoryring.h"
 
 
 //*************************************************************************************************************
@@ -61,6 +63,7 @@
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QByteArray>
 #include <QSharedPointer>
 #include <QString>
 #include <QTcpSocket>
@@ -138,14 +141,56 @@ public:
 
     //=========================================================================================================
     /**
-    * Reads fiff measurement information of a data the connection
+    * Reads the next tag of the data connection. A raw buffer is read directly into data and byte swapped in
+    * place, the storage of data is reused as long as the buffer size does not change. A profiled buffer is decoded
+    * with the dimensions it carries and reported as FIFF_DATA_BUFFER.
     *
     * @param[in] p_nChannels    Number of channels to reshape the received data
     * @param[out] data          The read data - ToDo change this to raw buffer data object
-    * @param[out] kind          Data kind
+    * @param[out] kind          Data kind, -1 if the connection was closed
     */
     void readRawBuffer(qint32 p_nChannels, MatrixXf& data, fiff_int_t& kind);
 
+    //=========================================================================================================
+    /**
+    * Reads the next tag of the data connection. A raw buffer is read directly into a matrix of the pool and
+    * byte swapped in place, the matrix returns to the pool when all consumers released it. A profiled buffer is
+    * decoded with the dimensions it carries and reported as FIFF_DATA_BUFFER.
+    *
+    * @param[in] p_nChannels    Number of channels to reshape the received data
+    * @param[in] p_pool         The pool which provides the raw buffer matrices
+    * @param[out] kind          Data kind, -1 if the connection was closed
+    *
+    * @return the raw buffer, or a null pointer if the tag is no raw buffer.
+    */
+    QSharedPointer<MatrixXf> readRawBuffer(qint32 p_nChannels, RawBufferPool& p_pool, fiff_int_t& kind);
+
+    //=========================================================================================================
+    /**
+    * Attaches to the shared memory ring which mne_rt_server created for this client, see RtCmdClient::
+    * requestSharedMemory. The raw buffers are read from the ring from now on, the measurement info still comes
+    * through the socket. If the socket is connected, losing it ends the reading like on TCP.
+    *
+    * @param[in] p_sKey     The key of the ring
+    *
+    * @return true if the ring was attached.
+    */
+    bool attachSharedMemory(const QString& p_sKey);
+
+    //=========================================================================================================
+    /**
+    * Detaches from the shared memory ring, the raw buffers are read from the socket again.
+    */
+    void detachSharedMemory();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the raw buffers are read from a shared memory ring.
+    *
+    * @return true if a shared memory ring is attached.
+    */
+    inline bool usesSharedMemory() const;
+
     //=========================================================================================================
     /**
     * Sets the alias of the data client
@@ -155,14 +200,85 @@ public:
     void setClientAlias(const QString &p_sAlias);
 
 private:
+    //=========================================================================================================
+    /**
+    * Reads a tag header, waits until it is complete.
+    *
+    * @param[out] p_kind    The tag kind
+    * @param[out] p_type    The tag data type
+    * @param[out] p_iSize   The size of the tag data in bytes
+    *
+    * @return true if the header was read, false if the connection was closed.
+    */
+    bool readTagHeader(fiff_int_t& p_kind, fiff_int_t& p_type, qint32& p_iSize);
+
+    //=========================================================================================================
+    /**
+    * Reads the data of a float raw buffer tag into the destination and swaps it to host byte order.
+    *
+    * @param[out] p_pData       The destination of at least p_iCount floats
+    * @param[in] p_iCount       The number of floats to read
+    * @param[in] p_iSize        The size of the tag data in bytes, surplus bytes are skipped
+    *
+    * @return true if the data was read, false if the connection was closed.
+    */
+    bool readFloatData(float* p_pData, qint64 p_iCount, qint32 p_iSize);
+
+    //=========================================================================================================
+    /**
+    * Reads bytes of the current tag from the shared memory record, or from the socket and waits until all of
+    * them arrived.
+    *
+    * @param[out] p_pData       The destination, Q_NULLPTR to skip the bytes
+    * @param[in] p_iSize        The number of bytes
+    *
+    * @return true if the bytes were read, false if the connection was closed.
+    */
+    bool readBytes(char* p_pData, qint64 p_iSize);
+
+    //=========================================================================================================
+    /**
+    * Reads the data of a tag as a whole. The data is valid until the next tag is read.
+    *
+    * @param[in] p_iSize        The size of the tag data in bytes
+    *
+    * @return the tag data, Q_NULLPTR if the connection was closed.
+    */
+    const char* readPayload(qint32 p_iSize);
+
+    //=========================================================================================================
+    /**
+    * Releases the shared memory record of the tag which was read last.
+    */
+    void finishTag();
+
     qint32 m_clientID;  /**< Corresponding client id of the data client at mne_rt_server */
 
+    SharedMemoryRing::SPtr  m_pSharedMemoryRing;    /**< The ring of a local mne_rt_server, null for the socket. */
+    const char*             m_pRecord;              /**< The shared memory record which is being read. */
+    qint32                  m_iRecordSize;          /**< Bytes of the record. */
+    qint32                  m_iRecordOffset;        /**< Bytes of the record which were read. */
+    bool                    m_bWatchSocket;         /**< Whether a lost socket ends reading from the ring. */
+
+    QByteArray              m_blockPayload;         /**< Reused storage of profiled buffers read from the socket. */
+
 signals:
     
 public slots:
     
 };
 
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool RtDataClient::usesSharedMemory() const
+{
+    return !m_pSharedMemoryRing.isNull();
+}
+
 } // NAMESPACE
 
 #endif // RTDATACLIENT_H
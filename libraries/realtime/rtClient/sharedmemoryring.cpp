@@ -0,0 +1,346 @@
+//=============================================================================================================
+/**
+* @file     sharedmemoryring.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the SharedMemoryRing class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "sharedmemoryring.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInteger>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cstring>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace REALTIMELIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// CONST
+//=============================================================================================================
+
+const quint32 ringMagic = 0x4d4e4552;           /**< Identifies a segment created by SharedMemoryRing, "MNER". */
+const quint32 recordHeaderSize = 8;             /**< Size and flags in front of each record. */
+const quint32 recordWrapFlag = 1;               /**< The rest of the data area is unused, the next record starts at 0. */
+const qint32 minCapacity = 64*1024;             /**< Smallest ring. */
+const qint32 maxCapacity = 1024*1024*1024;      /**< Largest ring. */
+const int spinPolls = 1000;                     /**< Polls of an empty ring which only yield the thread. */
+const unsigned long pollSleepUsecs = 100;       /**< Sleep between the later polls of an empty ring. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE LOCAL STRUCTS
+//=============================================================================================================
+
+/**
+* The header at the start of the segment. The positions count bytes and wrap around at 2^32, the capacity is a
+* power of two which keeps the difference of both positions valid.
+*/
+struct SharedMemoryRing::Header
+{
+    quint32                         uMagic;         /**< ringMagic once the writer initialized the header. */
+    quint32                         uCapacity;      /**< Bytes of the data area. */
+    QBasicAtomicInteger<quint32>    uWritePos;      /**< End of the last written record, advanced by the writer. */
+    QBasicAtomicInteger<quint32>    uReadPos;       /**< Start of the next unread record, advanced by the reader. */
+    QBasicAtomicInteger<quint32>    uClosed;        /**< Set by the writer when it closed the ring. */
+    quint32                         uReserved[3];   /**< Keeps the data area 16 byte aligned. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+SharedMemoryRing::SharedMemoryRing()
+: m_bIsWriter(false)
+, m_uReadSize(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    if(m_bIsWriter)
+        close();
+}
+
+
+//*************************************************************************************************************
+
+bool SharedMemoryRing::create(const QString& p_sKey, qint32 p_iCapacity)
+{
+    quint32 t_uCapacity = minCapacity;
+    while((qint64)t_uCapacity < qMin(p_iCapacity, maxCapacity))
+        t_uCapacity <<= 1;
+
+    m_sharedMemory.setKey(p_sKey);
+    if(!m_sharedMemory.create(sizeof(Header) + t_uCapacity))
+    {
+        //A segment which a crashed server left behind is released by attaching and detaching it
+        if(m_sharedMemory.error() == QSharedMemory::AlreadyExists && m_sharedMemory.attach())
+            m_sharedMemory.detach();
+
+        if(!m_sharedMemory.create(sizeof(Header) + t_uCapacity))
+        {
+            qWarning() << "SharedMemoryRing::create - unable to create segment" << p_sKey << ":" << m_sharedMemory.errorString();
+            return false;
+        }
+    }
+
+    Header* t_pHeader = header();
+    t_pHeader->uCapacity = t_uCapacity;
+    t_pHeader->uWritePos.store(0);
+    t_pHeader->uReadPos.store(0);
+    t_pHeader->uClosed.store(0);
+    t_pHeader->uMagic = ringMagic;
+
+    m_sKey = p_sKey;
+    m_bIsWriter = true;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool SharedMemoryRing::attach(const QString& p_sKey)
+{
+    m_sharedMemory.setKey(p_sKey);
+    if(!m_sharedMemory.attach())
+    {
+        qWarning() << "SharedMemoryRing::attach - unable to attach segment" << p_sKey << ":" << m_sharedMemory.errorString();
+        return false;
+    }
+
+    if(m_sharedMemory.size() < (int)sizeof(Header) || header()->uMagic != ringMagic
+            || m_sharedMemory.size() < (int)(sizeof(Header) + header()->uCapacity))
+    {
+        qWarning() << "SharedMemoryRing::attach - segment" << p_sKey << "is no ring";
+        m_sharedMemory.detach();
+        return false;
+    }
+
+    m_sKey = p_sKey;
+    m_bIsWriter = false;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void SharedMemoryRing::close()
+{
+    if(!isValid() || !m_bIsWriter)
+        return;
+
+    header()->uClosed.storeRelease(1);
+}
+
+
+//*************************************************************************************************************
+
+bool SharedMemoryRing::isClosed() const
+{
+    return isValid() && header()->uClosed.loadAcquire() != 0;
+}
+
+
+//*************************************************************************************************************
+
+qint32 SharedMemoryRing::capacity() const
+{
+    return isValid() ? (qint32)header()->uCapacity : 0;
+}
+
+
+//*************************************************************************************************************
+
+bool SharedMemoryRing::write(const char* p_pData, qint32 p_iSize)
+{
+    if(!isValid() || p_iSize < 0)
+        return false;
+
+    Header* t_pHeader = header();
+    const quint32 t_uCapacity = t_pHeader->uCapacity;
+    const quint32 t_uRecordSize = recordHeaderSize + (((quint32)p_iSize + 7) & ~7u);
+
+    //A record may take at most half of the ring, a wrap never blocks it forever
+    if(t_uRecordSize > t_uCapacity/2 || t_pHeader->uClosed.load())
+        return false;
+
+    quint32 t_uWritePos = t_pHeader->uWritePos.load();
+    const quint32 t_uReadPos = t_pHeader->uReadPos.loadAcquire();
+
+    quint32 t_uOffset = t_uWritePos & (t_uCapacity - 1);
+    quint32 t_uWrap = t_uCapacity - t_uOffset < t_uRecordSize ? t_uCapacity - t_uOffset : 0;
+
+    if(t_uWritePos - t_uReadPos + t_uWrap + t_uRecordSize > t_uCapacity)
+        return false;
+
+    char* t_pData = data();
+
+    if(t_uWrap > 0)
+    {
+        quint32 t_uWrapHeader[2] = {0, recordWrapFlag};
+        memcpy(t_pData + t_uOffset, t_uWrapHeader, recordHeaderSize);
+        t_uWritePos += t_uWrap;
+        t_uOffset = 0;
+    }
+
+    quint32 t_uRecordHeader[2] = {(quint32)p_iSize, 0};
+    memcpy(t_pData + t_uOffset, t_uRecordHeader, recordHeaderSize);
+    memcpy(t_pData + t_uOffset + recordHeaderSize, p_pData, p_iSize);
+
+    t_pHeader->uWritePos.storeRelease(t_uWritePos + t_uRecordSize);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool SharedMemoryRing::beginRead(const char*& p_pData, qint32& p_iSize, int p_iMsecs)
+{
+    if(!isValid())
+        return false;
+
+    if(m_uReadSize > 0)
+        endRead();
+
+    Header* t_pHeader = header();
+    const quint32 t_uCapacity = t_pHeader->uCapacity;
+    quint32 t_uReadPos = t_pHeader->uReadPos.load();
+
+    QElapsedTimer t_timer;
+    t_timer.start();
+
+    //Records written before close are read first, the closed flag is released after them
+    for(int t_iPoll = 0; t_pHeader->uWritePos.loadAcquire() == t_uReadPos; ++t_iPoll)
+    {
+        if(t_pHeader->uClosed.loadAcquire() && t_pHeader->uWritePos.loadAcquire() == t_uReadPos)
+            return false;
+
+        if(p_iMsecs >= 0 && t_timer.elapsed() >= p_iMsecs)
+            return false;
+
+        if(t_iPoll < spinPolls)
+            QThread::yieldCurrentThread();
+        else
+            QThread::usleep(pollSleepUsecs);
+    }
+
+    quint32 t_uRecordHeader[2];
+    memcpy(t_uRecordHeader, data() + (t_uReadPos & (t_uCapacity - 1)), recordHeaderSize);
+
+    if(t_uRecordHeader[1] & recordWrapFlag)
+    {
+        t_uReadPos += t_uCapacity - (t_uReadPos & (t_uCapacity - 1));
+        t_pHeader->uReadPos.storeRelease(t_uReadPos);
+        memcpy(t_uRecordHeader, data(), recordHeaderSize);
+    }
+
+    p_pData = data() + (t_uReadPos & (t_uCapacity - 1)) + recordHeaderSize;
+    p_iSize = (qint32)t_uRecordHeader[0];
+    m_uReadSize = recordHeaderSize + ((t_uRecordHeader[0] + 7) & ~7u);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void SharedMemoryRing::endRead()
+{
+    if(!isValid() || m_uReadSize == 0)
+        return;
+
+    Header* t_pHeader = header();
+    t_pHeader->uReadPos.storeRelease(t_pHeader->uReadPos.load() + m_uReadSize);
+    m_uReadSize = 0;
+}
+
+
+//*************************************************************************************************************
+
+qint32 SharedMemoryRing::usedBytes() const
+{
+    if(!isValid())
+        return 0;
+
+    return (qint32)(header()->uWritePos.loadAcquire() - header()->uReadPos.loadAcquire());
+}
+
+
+//*************************************************************************************************************
+
+SharedMemoryRing::Header* SharedMemoryRing::header() const
+{
+    return static_cast<Header*>(const_cast<void*>(m_sharedMemory.constData()));
+}
+
+
+//*************************************************************************************************************
+
+char* SharedMemoryRing::data() const
+{
+    return static_cast<char*>(const_cast<void*>(m_sharedMemory.constData())) + sizeof(Header);
+}
@@ -0,0 +1,235 @@
+//=============================================================================================================
+/**
+* @file     sharedmemoryring.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the SharedMemoryRing class.
+*
+*/
+
+#ifndef SHAREDMEMORYRING_H
+#define SHAREDMEMORYRING_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MNE INCLUDES
+//=============================================================================================================
+
+#include "../realtime_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QSharedMemory>
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE REALTIMELIB
+//=============================================================================================================
+
+namespace REALTIMELIB
+{
+
+
+//=============================================================================================================
+/**
+* A single producer, single consumer ring of records in a shared memory segment. mne_rt_server writes the
+* encoded raw buffer tags of a local client into the ring, the client reads them without going through the
+* loopback socket. The reader polls the write position, it yields for a short while and then sleeps briefly
+* between the polls. The segment is the only shared object, a writer which crashed leaves nothing behind which
+* could wake a reader of the next ring.
+*
+* The creator owns the segment. When it closes the ring, a waiting reader sees the ring closed. A writer which
+* died without closing is noticed by the timeout of beginRead.
+*
+* @brief Shared memory ring transport for raw buffers
+*/
+class REALTIMESHARED_EXPORT SharedMemoryRing
+{
+public:
+    typedef QSharedPointer<SharedMemoryRing> SPtr;               /**< Shared pointer type for SharedMemoryRing. */
+    typedef QSharedPointer<const SharedMemoryRing> ConstSPtr;    /**< Const shared pointer type for SharedMemoryRing. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a ring which is neither created nor attached.
+    */
+    SharedMemoryRing();
+
+    //=========================================================================================================
+    /**
+    * Closes the ring if it was created by this object and detaches from the segment.
+    */
+    ~SharedMemoryRing();
+
+    //=========================================================================================================
+    /**
+    * Creates the segment, this object becomes the writer.
+    *
+    * @param[in] p_sKey         The key of the segment, shared with the reader.
+    * @param[in] p_iCapacity    Bytes of the ring, rounded up to a power of two.
+    *
+    * @return true if the ring was created.
+    */
+    bool create(const QString& p_sKey, qint32 p_iCapacity);
+
+    //=========================================================================================================
+    /**
+    * Attaches to a ring which was created by another process, this object becomes the reader.
+    *
+    * @param[in] p_sKey     The key of the segment.
+    *
+    * @return true if the ring was attached.
+    */
+    bool attach(const QString& p_sKey);
+
+    //=========================================================================================================
+    /**
+    * Marks the ring as closed, a waiting reader returns once it read the remaining records. Called by the writer.
+    */
+    void close();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the writer closed the ring.
+    *
+    * @return true if the ring was closed.
+    */
+    bool isClosed() const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether the ring was created or attached.
+    *
+    * @return true if the ring is usable.
+    */
+    inline bool isValid() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the key of the ring.
+    *
+    * @return the key.
+    */
+    inline QString key() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the bytes of the ring.
+    *
+    * @return the capacity.
+    */
+    qint32 capacity() const;
+
+    //=========================================================================================================
+    /**
+    * Appends a record and wakes the reader. Never blocks.
+    *
+    * @param[in] p_pData    The record.
+    * @param[in] p_iSize    Bytes of the record.
+    *
+    * @return true if the record was written, false if the ring is full or the record does not fit at all.
+    */
+    bool write(const char* p_pData, qint32 p_iSize);
+
+    //=========================================================================================================
+    /**
+    * Waits until a record is available and returns it. The record stays valid until endRead is called.
+    *
+    * @param[out] p_pData   The record.
+    * @param[out] p_iSize   Bytes of the record.
+    * @param[in] p_iMsecs   Milliseconds to wait for a record, -1 waits until the ring is closed.
+    *
+    * @return true if a record was read, false if the ring was closed or no record arrived in time.
+    */
+    bool beginRead(const char*& p_pData, qint32& p_iSize, int p_iMsecs = -1);
+
+    //=========================================================================================================
+    /**
+    * Releases the record returned by beginRead, the writer may reuse its space.
+    */
+    void endRead();
+
+    //=========================================================================================================
+    /**
+    * Returns the bytes which are written but not yet read.
+    *
+    * @return the used bytes.
+    */
+    qint32 usedBytes() const;
+
+private:
+    struct Header;
+
+    //=========================================================================================================
+    /**
+    * Returns the header at the start of the segment.
+    */
+    Header* header() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the data area which follows the header.
+    */
+    char* data() const;
+
+    QSharedMemory                       m_sharedMemory;     /**< The segment, header followed by the data area. */
+    QString                             m_sKey;             /**< The key of the segment. */
+    bool                                m_bIsWriter;        /**< Whether this object created the ring. */
+    quint32                             m_uReadSize;        /**< Bytes of the record which is being read, 0 if none. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool SharedMemoryRing::isValid() const
+{
+    return m_sharedMemory.isAttached();
+}
+
+
+//*************************************************************************************************************
+
+inline QString SharedMemoryRing::key() const
+{
+    return m_sKey;
+}
+
+} // NAMESPACE
+
+#endif // SHAREDMEMORYRING_H
@@ -46,6 +46,7 @@
 // Qt INCLUDES
 //=============================================================================================================
 
+#include <QDataStream>
 #include <QDebug>
 #include <QStringList>
 #include <QJsonObject>
@@ -67,6 +68,7 @@ using namespace REALTIMELIB;
 
 CommandParser::CommandParser(QObject *parent)
 : QObject(parent)
+, m_iRequestId(-1)
 {
 }
 
@@ -90,6 +92,8 @@ bool CommandParser::exists(const QString& p_sCommand)
 
 bool CommandParser::parse(const QString &p_sInput, QStringList &p_qListCommandsParsed)
 {
+    m_iRequestId = -1;
+
     if(p_sInput.size() <= 0)
         return false;
 
@@ -114,6 +118,10 @@ bool CommandParser::parse(const QString &p_sInput, QStringList &p_qListCommandsP
         else
             return false;
 
+        //Pipelined requests carry an id to match the reply
+        if(t_jsonDocument.object().value(QString("id")).isDouble())
+            m_iRequestId = t_jsonDocument.object().value(QString("id")).toInt();
+
         //iterate over commands
         QJsonObject::Iterator it;
         QJsonObject::Iterator itParam;
@@ -180,3 +188,210 @@ bool CommandParser::parse(const QString &p_sInput, QStringList &p_qListCommandsP
 
     return true;
 }
+
+
+//*************************************************************************************************************
+
+bool CommandParser::parse(const QByteArray &p_blockInput, QStringList &p_qListCommandsParsed)
+{
+    m_iRequestId = -1;
+    p_qListCommandsParsed.clear();
+
+    if(!isBinaryCommand(p_blockInput))
+        return false;
+
+    QDataStream t_streamIn(p_blockInput);
+    t_streamIn.setVersion(QDataStream::Qt_5_1);
+
+    quint8 t_iTag;
+    qint32 t_iId;
+    quint8 t_iNameSize;
+    t_streamIn >> t_iTag >> t_iId >> t_iNameSize;
+
+    //The reply is tagged even if the command turns out to be unknown
+    m_iRequestId = t_iId;
+
+    QByteArray t_blockName(t_iNameSize, 0);
+    t_streamIn.readRawData(t_blockName.data(), t_iNameSize);
+
+    quint8 t_iCount;
+    t_streamIn >> t_iCount;
+
+    //The values are handed on as strings, the command manager converts them to the parameter types
+    QStringList t_qListValues;
+    for(quint8 i = 0; i < t_iCount; ++i)
+    {
+        quint8 t_iType;
+        t_streamIn >> t_iType;
+
+        if(t_iType == BinaryInt)
+        {
+            qint32 t_iValue;
+            t_streamIn >> t_iValue;
+            t_qListValues.append(QString::number(t_iValue));
+        }
+        else if(t_iType == BinaryDouble)
+        {
+            double t_dValue;
+            t_streamIn >> t_dValue;
+            t_qListValues.append(QString::number(t_dValue, 'g', 17));
+        }
+        else
+        {
+            quint16 t_iSize;
+            t_streamIn >> t_iSize;
+            QByteArray t_blockValue(t_iSize, 0);
+            t_streamIn.readRawData(t_blockValue.data(), t_iSize);
+            t_qListValues.append(QString::fromUtf8(t_blockValue));
+        }
+    }
+
+    if(t_streamIn.status() != QDataStream::Ok)
+        return false;
+
+    QString t_sCommand = QString::fromUtf8(t_blockName);
+
+    //Print command
+    printf("%s\r\n", t_sCommand.toUtf8().constData());
+
+    if(!exists(t_sCommand))
+        return false;
+
+    //Binary clients read the replies as JSON
+    RawCommand t_rawCommand(t_sCommand, true);
+    m_rawCommand = t_rawCommand;
+    m_rawCommand.pValues().append(t_qListValues);
+
+    // push command to processed commands
+    p_qListCommandsParsed.push_back(t_sCommand);
+
+    notify();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+QByteArray CommandParser::encodeCommand(const Command &p_command, qint32 p_iId)
+{
+    QByteArray t_blockCommand;
+    QDataStream t_streamOut(&t_blockCommand, QIODevice::WriteOnly);
+    t_streamOut.setVersion(QDataStream::Qt_5_1);
+
+    QByteArray t_blockName = p_command.command().toUtf8().left(255);
+    t_streamOut << (quint8)BinaryCommandTag << p_iId << (quint8)t_blockName.size();
+    t_streamOut.writeRawData(t_blockName.constData(), t_blockName.size());
+
+    const QList<QString> t_qListNames = p_command.pNames();
+    t_streamOut << (quint8)t_qListNames.size();
+
+    for(qint32 i = 0; i < t_qListNames.size(); ++i)
+    {
+        const QVariant t_value = p_command[t_qListNames[i]];
+
+        switch(t_value.type())
+        {
+            case QVariant::Bool:
+            case QVariant::Int:
+            case QVariant::UInt:
+                t_streamOut << (quint8)BinaryInt << (qint32)t_value.toInt();
+                break;
+            case QVariant::Double:
+                t_streamOut << (quint8)BinaryDouble << t_value.toDouble();
+                break;
+            default:
+            {
+                QByteArray t_blockValue = t_value.toString().toUtf8().left(65535);
+                t_streamOut << (quint8)BinaryString << (quint16)t_blockValue.size();
+                t_streamOut.writeRawData(t_blockValue.constData(), t_blockValue.size());
+            }
+        }
+    }
+
+    return t_blockCommand;
+}
+
+
+//*************************************************************************************************************
+
+QByteArray CommandParser::encodeReply(qint32 p_iId, const QString &p_sReply)
+{
+    QByteArray t_blockReply;
+    QDataStream t_streamOut(&t_blockReply, QIODevice::WriteOnly);
+    t_streamOut.setVersion(QDataStream::Qt_5_1);
+
+    t_streamOut << (quint8)TaggedReplyTag << p_iId;
+    t_blockReply.append(p_sReply.toUtf8());
+
+    return t_blockReply;
+}
+
+
+//*************************************************************************************************************
+
+bool CommandParser::decodeReply(const QByteArray &p_blockFrame, qint32 &p_iId, QString &p_sReply)
+{
+    if(p_blockFrame.size() < 5 || (quint8)p_blockFrame.at(0) != TaggedReplyTag)
+        return false;
+
+    QDataStream t_streamIn(p_blockFrame);
+    t_streamIn.setVersion(QDataStream::Qt_5_1);
+
+    quint8 t_iTag;
+    t_streamIn >> t_iTag >> p_iId;
+    p_sReply = QString::fromUtf8(p_blockFrame.constData() + 5, p_blockFrame.size() - 5);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+QList<QByteArray> CommandParser::splitReply(const QByteArray &p_blockReply, int p_iMaxFrameSize)
+{
+    QList<QByteArray> t_qListFrames;
+
+    if(p_blockReply.size() <= p_iMaxFrameSize || p_blockReply.size() < 5 || p_iMaxFrameSize <= 5)
+    {
+        t_qListFrames.append(p_blockReply);
+        return t_qListFrames;
+    }
+
+    //Tag and id are repeated in every frame
+    QByteArray t_blockHeader = p_blockReply.left(5);
+    int t_iPartSize = p_iMaxFrameSize - 5;
+
+    for(int t_iPos = 5; t_iPos < p_blockReply.size(); t_iPos += t_iPartSize)
+    {
+        QByteArray t_blockFrame = t_blockHeader + p_blockReply.mid(t_iPos, t_iPartSize);
+        if(t_iPos + t_iPartSize < p_blockReply.size())
+            t_blockFrame[0] = (char)TaggedReplyPartTag;
+
+        t_qListFrames.append(t_blockFrame);
+    }
+
+    return t_qListFrames;
+}
+
+
+//*************************************************************************************************************
+
+bool CommandParser::decodeReplyPart(const QByteArray &p_blockFrame, qint32 &p_iId, QByteArray &p_blockPart, bool &p_bLast)
+{
+    if(p_blockFrame.size() < 5)
+        return false;
+
+    quint8 t_iTag = (quint8)p_blockFrame.at(0);
+    if(t_iTag != TaggedReplyTag && t_iTag != TaggedReplyPartTag)
+        return false;
+
+    QDataStream t_streamIn(p_blockFrame);
+    t_streamIn.setVersion(QDataStream::Qt_5_1);
+
+    t_streamIn >> t_iTag >> p_iId;
+    p_blockPart = p_blockFrame.mid(5);
+    p_bLast = (t_iTag == TaggedReplyTag);
+
+    return true;
+}
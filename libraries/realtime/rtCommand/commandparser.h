@@ -54,6 +54,8 @@
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QByteArray>
+#include <QList>
 #include <QObject>
 #include <QVector>
 #include <QMultiMap>
@@ -67,11 +69,38 @@
 namespace REALTIMELIB
 {
 
+//=============================================================================================================
+/**
+* Parses CLI commands, JSON commands and binary commands and notifies the attached command managers.
+*
+* A request can carry an id, {"id": 7, "commands": {...}} in JSON, binary commands always do. The replies to such a
+* request are collected into one tagged reply frame, so a client can send several requests in one write and
+* match the replies by id.
+*
+* Binary command: tag (quint8), id (qint32), name (quint8 length + UTF-8), parameter count (quint8) and per
+* parameter a type (quint8) followed by a qint32, a double or a UTF-8 string with quint16 length. Tagged reply:
+* tag (quint8), id (qint32) and the UTF-8 reply up to the end of the frame. A reply which exceeds a frame is split
+* into parts with the part tag, the last frame has the reply tag. All numbers are big endian. A QString frame starts
+* with 0x00 or 0xFF, the tag tells the frames apart.
+*
+* @brief Parses commands and notifies the command managers
+*/
 class REALTIMESHARED_EXPORT CommandParser : public QObject, public Subject
 {
     Q_OBJECT
 public:
 
+    enum BinaryTag {
+        BinaryCommandTag = 0xBC,    /**< First byte of a binary command. */
+        TaggedReplyTag = 0xBD,      /**< First byte of a reply to a request with id. */
+        TaggedReplyPartTag = 0xBE   /**< First byte of a leading part of a split tagged reply. */
+    };
+
+    enum BinaryType {
+        BinaryInt = 0,              /**< qint32 parameter. */
+        BinaryDouble = 1,           /**< double parameter. */
+        BinaryString = 2            /**< UTF-8 string parameter with quint16 length. */
+    };
 
     //=========================================================================================================
     /**
@@ -100,6 +129,92 @@ public:
     */
     bool parse(const QString &p_sInput, QStringList &p_qListCommandsParsed);
 
+    //=========================================================================================================
+    /**
+    * Parses a binary command and notifies all attached observers (command managers). The replies are JSON.
+    *
+    * @param[in] p_blockInput            Binary command, see encodeCommand.
+    * @param[out] p_qListCommandsParsed  List of parsed commands.
+    */
+    bool parse(const QByteArray &p_blockInput, QStringList &p_qListCommandsParsed);
+
+    //=========================================================================================================
+    /**
+    * Returns the id of the last parsed request.
+    *
+    * @return the request id, -1 if the request had none.
+    */
+    inline qint32 requestId() const;
+
+    //=========================================================================================================
+    /**
+    * Checks whether a frame holds a binary command.
+    *
+    * @param[in] p_blockFrame   The frame content.
+    *
+    * @return true if the frame is a binary command.
+    */
+    static inline bool isBinaryCommand(const QByteArray &p_blockFrame);
+
+    //=========================================================================================================
+    /**
+    * Encodes a command with its parameter values as binary command.
+    *
+    * @param[in] p_command  The command.
+    * @param[in] p_iId      The request id.
+    *
+    * @return the binary command.
+    */
+    static QByteArray encodeCommand(const Command &p_command, qint32 p_iId);
+
+    //=========================================================================================================
+    /**
+    * Encodes the reply to a request with id.
+    *
+    * @param[in] p_iId      The request id.
+    * @param[in] p_sReply   The reply.
+    *
+    * @return the tagged reply.
+    */
+    static QByteArray encodeReply(qint32 p_iId, const QString &p_sReply);
+
+    //=========================================================================================================
+    /**
+    * Decodes a tagged reply.
+    *
+    * @param[in] p_blockFrame   The frame content.
+    * @param[out] p_iId         The request id.
+    * @param[out] p_sReply      The reply.
+    *
+    * @return true if the frame is a tagged reply.
+    */
+    static bool decodeReply(const QByteArray &p_blockFrame, qint32 &p_iId, QString &p_sReply);
+
+    //=========================================================================================================
+    /**
+    * Splits a tagged reply into frames of at most the given size. The leading frames carry the part tag, the
+    * UTF-8 bytes of the reply are concatenated before they are decoded.
+    *
+    * @param[in] p_blockReply       The tagged reply, see encodeReply.
+    * @param[in] p_iMaxFrameSize    The maximal frame size, larger than 5.
+    *
+    * @return the frames, the reply itself if it fits into one frame.
+    */
+    static QList<QByteArray> splitReply(const QByteArray &p_blockReply, int p_iMaxFrameSize);
+
+    //=========================================================================================================
+    /**
+    * Decodes a frame of a tagged reply, either a whole reply or a part of a split reply.
+    *
+    * @param[in] p_blockFrame   The frame content.
+    * @param[out] p_iId         The request id.
+    * @param[out] p_blockPart   The UTF-8 bytes of the frame.
+    * @param[out] p_bLast       Whether the frame completes the reply.
+    *
+    * @return true if the frame belongs to a tagged reply.
+    */
+    static bool decodeReplyPart(const QByteArray &p_blockFrame, qint32 &p_iId, QByteArray &p_blockPart, bool &p_bLast);
+
     //=========================================================================================================
     /**
     * Returns the stored RawCommand
@@ -121,6 +236,7 @@ signals:
 
 private:
     RawCommand m_rawCommand;
+    qint32 m_iRequestId;    /**< Id of the last parsed request, -1 if it had none. */
 };
 
 //*************************************************************************************************************
@@ -133,6 +249,22 @@ RawCommand& CommandParser::getRawCommand()
     return m_rawCommand;
 }
 
+
+//*************************************************************************************************************
+
+qint32 CommandParser::requestId() const
+{
+    return m_iRequestId;
+}
+
+
+//*************************************************************************************************************
+
+bool CommandParser::isBinaryCommand(const QByteArray &p_blockFrame)
+{
+    return !p_blockFrame.isEmpty() && (quint8)p_blockFrame.at(0) == BinaryCommandTag;
+}
+
 } // NAMESPACE
 
 #endif // COMMANDPARSER_H
@@ -92,6 +92,118 @@ double          m_dValueThreshold = 300e-6;          /**< Threshold to detect ar
 // DEFINE MEMBER METHODS
 //=============================================================================================================
 
+RtAveBuffer::RtAveBuffer()
+: iCapacity(0)
+, iHead(0)
+, iCount(0)
+, iEvictions(0)
+, bFloat(false)
+{
+}
+
+
+//*************************************************************************************************************
+
+void RtAveBuffer::init(qint32 capacity, bool bFloatStorage)
+{
+    iCapacity = capacity > 0 ? capacity : 0;
+    bFloat = bFloatStorage;
+    iHead = 0;
+    iCount = 0;
+    iEvictions = 0;
+
+    matSum.resize(0,0);
+    vecRing.clear();
+    vecRingFloat.clear();
+
+    //Slots are allocated lazily on first use, afterwards they are overwritten in place
+    if(bFloat) {
+        vecRingFloat.resize(iCapacity);
+    } else {
+        vecRing.resize(iCapacity);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtAveBuffer::add(const MatrixXd& epoch)
+{
+    if(matSum.rows() != epoch.rows() || matSum.cols() != epoch.cols()) {
+        matSum = MatrixXd::Zero(epoch.rows(), epoch.cols());
+    }
+
+    //Cumulative: no epochs need to be kept
+    if(iCapacity == 0) {
+        matSum += epoch;
+        ++iCount;
+        return;
+    }
+
+    bool bEvict = iCount == iCapacity;
+
+    if(bFloat) {
+        MatrixXf& slot = vecRingFloat[iHead];
+        if(bEvict) {
+            matSum -= slot.cast<double>();
+        }
+        slot = epoch.cast<float>();
+        //Add the stored (rounded) values so that the later subtraction cancels exactly
+        matSum += slot.cast<double>();
+    } else {
+        MatrixXd& slot = vecRing[iHead];
+        if(bEvict) {
+            matSum -= slot;
+        }
+        slot = epoch;
+        matSum += slot;
+    }
+
+    iHead = (iHead + 1) % iCapacity;
+
+    if(bEvict) {
+        //Rebuild once per ring turn, which keeps the amortized cost per epoch constant
+        if(++iEvictions >= iCapacity) {
+            resum();
+        }
+    } else {
+        ++iCount;
+    }
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd RtAveBuffer::average() const
+{
+    if(iCount == 0) {
+        return matSum;
+    }
+
+    return matSum / iCount;
+}
+
+
+//*************************************************************************************************************
+
+void RtAveBuffer::resum()
+{
+    matSum.setZero();
+
+    for(int i = 0; i < iCount; ++i) {
+        if(bFloat) {
+            matSum += vecRingFloat.at(i).cast<double>();
+        } else {
+            matSum += vecRing.at(i);
+        }
+    }
+
+    iEvictions = 0;
+}
+
+
+//*************************************************************************************************************
+
 RtAve::RtAve(quint32 numAverages,
              quint32 p_iPreStimSamples,
              quint32 p_iPostStimSamples,
@@ -113,6 +225,8 @@ RtAve::RtAve(quint32 numAverages,
 , m_iAverageMode(0)
 , m_iNewAverageMode(0)
 , m_bDoBaselineCorrection(false)
+, m_bFloatStorage(false)
+, m_bNewFloatStorage(false)
 , m_pairBaselineSec(qMakePair(QVariant(QString::number(p_iBaselineFromSecs)),QVariant(QString::number(p_iBaselineToSecs))))
 , m_pStimEvokedSet(FiffEvokedSet::SPtr(new FiffEvokedSet))
 , m_bActivateThreshold(false)
@@ -143,6 +257,7 @@ void RtAve::append(const MatrixXd &p_DataSegment)
         m_pRawMatrixBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(30, p_DataSegment.rows(), p_DataSegment.cols()));
     }
 
+    m_traceIds.push();
     m_pRawMatrixBuffer->push(&p_DataSegment);
 }
 
@@ -165,6 +280,15 @@ void RtAve::setAverageMode(qint32 mode)
 }
 
 
+//*************************************************************************************************************
+
+void RtAve::setFloatStorage(bool bFloatStorage)
+{
+    QMutexLocker locker(&m_qMutex);
+    m_bNewFloatStorage = bFloatStorage;
+}
+
+
 //*************************************************************************************************************
 
 void RtAve::setPreStim(qint32 samples, qint32 secs)
@@ -286,6 +410,7 @@ bool RtAve::stop()
     m_pRawMatrixBuffer->releaseFromPop();
 
     m_pRawMatrixBuffer->clear();
+    m_traceIds.clear();
 
     return true;
 }
@@ -295,6 +420,8 @@ bool RtAve::stop()
 
 void RtAve::run()
 {
+    static const int s_iTraceStage = Tracer::registerStage("RtAve");
+
     //Do initial reset
     reset();
 
@@ -311,6 +438,7 @@ void RtAve::run()
 
             //Acquire Data m_pRawMatrixBuffer is thread safe
             MatrixXd rawSegment = m_pRawMatrixBuffer->pop();
+            TraceScope traceScope(s_iTraceStage, m_traceIds.pop());
 
             //QMutexLocker locker(&m_qMutex);
             doAveraging(rawSegment);
@@ -334,7 +462,21 @@ void RtAve::doAveraging(const MatrixXd& rawSegment)
     //QElapsedTimer time;
     //time.start();
 
-    QList<QPair<int,double> > lDetectedTriggers = DetectTrigger::detectTriggerFlanksMax(rawSegment, m_iTriggerChIndex, 0, m_fTriggerThreshold, true);
+    if(m_lTriggerChannels.isEmpty() || m_lTriggerChannels.first() != m_iTriggerChIndex) {
+        m_lTriggerChannels.clear();
+        m_lTriggerChannels.append(m_iTriggerChIndex);
+        m_vecLastTriggerSample.resize(0);
+        m_vecTriggerBlockedSamples.resize(0);
+    }
+
+    //Only rising flanks are reported, a trigger which is held across blocks is therefore counted once.
+    //The baseline of the stim channel is removed, so that a DC offset above the threshold does not hide the triggers.
+    int iNumEvents = DetectTrigger::detectTriggerEdges(rawSegment, m_lTriggerChannels, 0, m_fTriggerThreshold, true, m_vecTriggerEvents, &m_vecLastTriggerSample, 100, true, &m_vecTriggerBlockedSamples);
+
+    QList<QPair<int,double> > lDetectedTriggers;
+    for(int i = 0; i < iNumEvents; ++i) {
+        lDetectedTriggers.append(qMakePair(m_vecTriggerEvents.at(i).iSample, m_vecTriggerEvents.at(i).dValue));
+    }
 
     //qDebug()<<"RtAve::doAveraging() - time for detection"<<time.elapsed();
     //time.start();
@@ -386,7 +528,7 @@ void RtAve::doAveraging(const MatrixXd& rawSegment)
                 generateEvoked(dTriggerType);
 
                 //If number of averages was reached emit new average
-                if(m_mapStimAve[dTriggerType].size() > 0) {
+                if(m_mapStimAve.contains(dTriggerType) && m_mapStimAve.constFind(dTriggerType)->iCount > 0) {
                     emit evokedStim(m_pStimEvokedSet);
                 }
 
@@ -394,7 +536,7 @@ void RtAve::doAveraging(const MatrixXd& rawSegment)
 
                 //qDebug()<<"RtAve::run() - Number of calculated averages:" << m_iNumberCalcAverages[dTriggerType];
                 //qDebug()<<"RtAve::run() - dTriggerType:" << dTriggerType;
-                //qDebug()<<"RtAve::run() - m_mapStimAve[dTriggerType].size():" << m_mapStimAve[dTriggerType].size();
+                //qDebug()<<"RtAve::run() - m_mapStimAve[dTriggerType].iCount:" << m_mapStimAve[dTriggerType].iCount;
             } else {
                 //qDebug()<<"4";
                 fillBackBuffer(rawSegment, dTriggerType);
@@ -516,18 +658,14 @@ void RtAve::mergeData(double dTriggerType)
     bool bArtifactedDetected = checkForArtifact(mergedData);
 
     if(bArtifactedDetected == false) {
-        //Add cut data to average buffer
-        m_mapStimAve[dTriggerType].append(mergedData);
-
-        //Pop data from buffer
-        if(m_mapStimAve[dTriggerType].size() > m_iNumAverages && m_iNumAverages >= 1) {
-            m_mapStimAve[dTriggerType].pop_front();
+        //Add cut data to the running sum
+        if(!m_mapStimAve.contains(dTriggerType)) {
+            //Running mode keeps m_iNumAverages epochs (at least the last one), cumulative mode keeps none
+            qint32 iCapacity = m_iAverageMode == 0 ? qMax(m_iNumAverages, 1) : 0;
+            m_mapStimAve[dTriggerType].init(iCapacity, m_bFloatStorage);
         }
 
-        //Proceed a bit different if we use zero number of averages
-        if(m_mapStimAve[dTriggerType].size() > 1 && m_iNumAverages == 0) {
-            m_mapStimAve[dTriggerType].pop_front();
-        }
+        m_mapStimAve[dTriggerType].add(mergedData);
     }
 }
 
@@ -647,7 +785,7 @@ void RtAve::generateEvoked(double dTriggerType)
 {
     QMutexLocker locker(&m_qMutex);
 
-    if(m_mapStimAve[dTriggerType].isEmpty()) {
+    if(!m_mapStimAve.contains(dTriggerType) || m_mapStimAve[dTriggerType].iCount == 0) {
         return;
     }
 
@@ -679,42 +817,24 @@ void RtAve::generateEvoked(double dTriggerType)
     }
 
     // Generate final evoked
-    MatrixXd finalAverage = MatrixXd::Zero(m_mapStimAve[dTriggerType].first().rows(), m_iPreStimSamples+m_iPostStimSamples);
-
-    if(m_iAverageMode == 0) {
-        for(int i = 0; i < m_mapStimAve[dTriggerType].size(); ++i) {
-            finalAverage += m_mapStimAve[dTriggerType].at(i);
-        }
-
-        if(m_mapStimAve[dTriggerType].isEmpty()) {
-            finalAverage = finalAverage/1;
-        } else {
-            finalAverage = finalAverage/m_mapStimAve[dTriggerType].size();
-        }
+    MatrixXd finalAverage = m_mapStimAve[dTriggerType].average();
 
-        if(m_bDoBaselineCorrection) {
-            finalAverage = MNEMath::rescale(finalAverage, evoked.times, m_pairBaselineSec, QString("mean"));
-        }
+    if(m_bDoBaselineCorrection) {
+        finalAverage = MNEMath::rescale(finalAverage, evoked.times, m_pairBaselineSec, QString("mean"));
+    }
 
-        evoked.data = finalAverage;
+    evoked.data = finalAverage;
 
+    if(m_iAverageMode == 0) {
         if(m_mapNumberCalcAverages[dTriggerType] < m_iNumAverages) {
             m_mapNumberCalcAverages[dTriggerType]++;
         }
-
-        evoked.nave = m_mapNumberCalcAverages[dTriggerType];
     } else if(m_iAverageMode == 1) {
-        MatrixXd tempMatrix = m_mapStimAve[dTriggerType].last();
-
-        if(m_bDoBaselineCorrection) {
-            tempMatrix = MNEMath::rescale(tempMatrix, evoked.times, m_pairBaselineSec, QString("mean"));
-        }
-
-        evoked += tempMatrix;
-
         m_mapNumberCalcAverages[dTriggerType]++;
     }
 
+    evoked.nave = m_mapNumberCalcAverages[dTriggerType];
+
     //Add new data to evoked data set
     if(iEvokedIdx != -1) {
         //Evoked data is already present
@@ -741,6 +861,7 @@ void RtAve::reset()
     m_iTriggerChIndex = m_iNewTriggerIndex;
     m_iAverageMode = m_iNewAverageMode;
     m_iNumAverages = m_iNewNumAverages;
+    m_bFloatStorage = m_bNewFloatStorage;
 
     qDebug()<<"RtAve::reset() - 2";
 
@@ -757,6 +878,8 @@ void RtAve::reset()
 //    m_mapNumberCalcAverages.clear();
 
     m_qMapDetectedTrigger.clear();
+    m_vecLastTriggerSample.resize(0);
+    m_vecTriggerBlockedSamples.resize(0);
     m_mapStimAve.clear();
     m_mapDataPre.clear();
     m_mapDataPost.clear();
@@ -48,6 +48,8 @@
 #include <fiff/fiff_info.h>
 
 #include <utils/generics/circularmatrixbuffer.h>
+#include <utils/detecttrigger.h>
+#include <utils/tracer.h>
 
 
 //*************************************************************************************************************
@@ -58,6 +60,7 @@
 #include <QThread>
 #include <QMutex>
 #include <QSharedPointer>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -89,6 +92,59 @@ namespace REALTIMELIB
 //=============================================================================================================
 
 
+//=============================================================================================================
+/**
+* Running sum of the accepted epochs of one trigger type. In running mode the epochs are kept in a ring of
+* preallocated slots so the evicted epoch can be subtracted again; in cumulative mode (capacity 0) only the sum
+* is kept. Either way an epoch costs one add (and one subtract) independent of the number of averages.
+*/
+struct REALTIMESHARED_EXPORT RtAveBuffer
+{
+    Eigen::MatrixXd             matSum;         /**< Sum of the epochs currently averaged. */
+    QVector<Eigen::MatrixXd>    vecRing;        /**< Epoch ring in double precision. */
+    QVector<Eigen::MatrixXf>    vecRingFloat;   /**< Epoch ring in single precision (float storage). */
+    qint32                      iCapacity;      /**< Ring size, 0 for a cumulative (ring-less) sum. */
+    qint32                      iHead;          /**< Ring slot the next epoch is written to. */
+    qint32                      iCount;         /**< Number of epochs in the sum. */
+    qint32                      iEvictions;     /**< Evictions since the sum was last rebuilt from the ring. */
+    bool                        bFloat;         /**< Whether the ring stores single precision epochs. */
+
+    RtAveBuffer();
+
+    //=========================================================================================================
+    /**
+    * Clears the buffer and sets its layout.
+    *
+    * @param[in] capacity         Number of epochs in the moving average, 0 for a cumulative average.
+    * @param[in] bFloatStorage    Whether to store the ring epochs in single precision.
+    */
+    void init(qint32 capacity, bool bFloatStorage);
+
+    //=========================================================================================================
+    /**
+    * Adds an epoch to the sum and, once the ring is full, subtracts the epoch it replaces.
+    *
+    * @param[in] epoch    The new epoch.
+    */
+    void add(const Eigen::MatrixXd& epoch);
+
+    //=========================================================================================================
+    /**
+    * Returns the current average, i.e. the sum divided by the number of epochs.
+    *
+    * @return the average.
+    */
+    Eigen::MatrixXd average() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Rebuilds the sum from the ring to bound the round-off accumulated by add/subtract.
+    */
+    void resum();
+};
+
+
 //=============================================================================================================
 /**
 * Real-time averaging and returns evoked data
@@ -154,6 +210,15 @@ public:
     */
     void setAverageMode(qint32 mode);
 
+    //=========================================================================================================
+    /**
+    * Sets whether the epochs of the running average are stored in single precision. The running sum itself is
+    * always accumulated in double precision. Halves the memory of large running averages.
+    *
+    * @param[in] bFloatStorage     whether to store the epochs as float
+    */
+    void setFloatStorage(bool bFloatStorage);
+
     //=========================================================================================================
     /**
     * Sets the number of pre stimulus samples
@@ -332,11 +397,18 @@ private:
 
     float                                           m_fTriggerThreshold;        /**< Threshold to detect trigger */
 
+    QList<int>                                      m_lTriggerChannels;         /**< The trigger channel passed to the edge detection. */
+    QVector<UTILSLIB::TriggerEvent>                 m_vecTriggerEvents;         /**< Reused event storage of the edge detection. */
+    Eigen::VectorXd                                 m_vecLastTriggerSample;     /**< The last trigger sample of the previous block, to find flanks at block borders. */
+    Eigen::VectorXi                                 m_vecTriggerBlockedSamples; /**< The samples of the next block which still lie within the burst length of a trigger. */
+
     bool                                            m_bActivateThreshold;       /**< Whether to do threshold artifact reduction or not. */
     bool                                            m_bActivateVariance;        /**< Whether to do variance artifact reduction or not. */
     bool                                            m_bIsRunning;               /**< Holds if real-time Covariance estimation is running.*/
     bool                                            m_bAutoAspect;              /**< Auto aspect detection on or off. */
     bool                                            m_bDoBaselineCorrection;    /**< Whether to perform baseline correction. */
+    bool                                            m_bFloatStorage;            /**< Whether the running average epochs are stored in single precision. */
+    bool                                            m_bNewFloatStorage;         /**< New single precision storage flag. */
 
     QPair<QVariant,QVariant>                        m_pairBaselineSec;          /**< Baseline information in seconds form where the seconds are seen relative to the trigger, meaning they can also be negative [from to]*/
     QPair<QVariant,QVariant>                        m_pairBaselineSamp;         /**< Baseline information in samples form where the seconds are seen relative to the trigger, meaning they can also be negative [from to]*/
@@ -345,7 +417,7 @@ private:
     FIFFLIB::FiffEvokedSet::SPtr                    m_pStimEvokedSet;           /**< Holds the evoked information. */
 
     QMap<int,QList<int> >                           m_qMapDetectedTrigger;      /**< Detected trigger for each trigger channel. */
-    QMap<double,QList<Eigen::MatrixXd> >            m_mapStimAve;               /**< the current stimulus average buffer. Holds m_iNumAverages vectors */
+    QMap<double,RtAveBuffer>                        m_mapStimAve;               /**< The running sums of the current stimulus averages. Ring holds m_iNumAverages epochs in running mode. */
     QMap<double,Eigen::MatrixXd>                    m_mapDataPre;               /**< The matrix holding the pre stim data. */
     QMap<double,Eigen::MatrixXd>                    m_mapDataPost;              /**< The matrix holding the post stim data. */
     QMap<double,qint32>                             m_mapMatDataPostIdx;        /**< Current index inside of the matrix m_matDataPost */
@@ -353,6 +425,7 @@ private:
     QMap<double,qint32>                             m_mapNumberCalcAverages;    /**< The number of currently calculated averages for each trigger type. */
 
     IOBUFFER::CircularMatrixBuffer<double>::SPtr    m_pRawMatrixBuffer;         /**< The Circular Raw Matrix Buffer. */
+    UTILSLIB::TraceIdQueue                          m_traceIds;                 /**< The trace ids of the buffered blocks. */
 
 signals:
     //=========================================================================================================
@@ -403,7 +476,8 @@ inline bool RtAve::controlValuesChanged()
             || m_iNewPostStimSamples != m_iPostStimSamples
             || m_iNewTriggerIndex != m_iTriggerChIndex
             || m_iNewAverageMode != m_iAverageMode
-            || m_iNewNumAverages != m_iNumAverages) {
+            || m_iNewNumAverages != m_iNumAverages
+            || m_bNewFloatStorage != m_bFloatStorage) {
         result = true;
     }
 
@@ -43,6 +43,7 @@
 #include "rtcov.h"
 
 #include <iostream>
+#include <cmath>
 #include <fiff/fiff_cov.h>
 
 
@@ -52,6 +53,8 @@
 //=============================================================================================================
 
 #include <QDebug>
+#include <QMutexLocker>
+#include <QtConcurrent/QtConcurrent>
 
 
 //*************************************************************************************************************
@@ -61,6 +64,83 @@
 
 using namespace REALTIMELIB;
 using namespace FIFFLIB;
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define RTCOV_TILE_SIZE 64      /**< Channels per tile of the parallel scatter update. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace
+{
+
+/**
+* One tile of the upper triangle of a symmetric rank-k update S += alpha * X * X^T.
+*/
+struct RtCovTile
+{
+    const MatrixXd* pData;      /**< Centered data, channels x samples. */
+    MatrixXd*       pScatter;   /**< Scatter matrix to update, upper triangle only. */
+    int             iRow;       /**< First row of the tile. */
+    int             iRows;      /**< Number of rows of the tile. */
+    int             iCol;       /**< First column of the tile. */
+    int             iCols;      /**< Number of columns of the tile. */
+    double          dAlpha;     /**< Scale of the update. */
+};
+
+
+//*************************************************************************************************************
+
+void calcCovTile(RtCovTile& tile)
+{
+    if(tile.iRow == tile.iCol) {
+        tile.pScatter->block(tile.iRow, tile.iCol, tile.iRows, tile.iCols).selfadjointView<Upper>().rankUpdate(tile.pData->middleRows(tile.iRow, tile.iRows), tile.dAlpha);
+    } else {
+        tile.pScatter->block(tile.iRow, tile.iCol, tile.iRows, tile.iCols).noalias() += tile.dAlpha * tile.pData->middleRows(tile.iRow, tile.iRows) * tile.pData->middleRows(tile.iCol, tile.iCols).transpose();
+    }
+}
+
+
+//*************************************************************************************************************
+
+void scatterUpdate(const MatrixXd& matData, MatrixXd& matScatter, double dAlpha)
+{
+    int iChannels = matData.rows();
+
+    if(iChannels <= RTCOV_TILE_SIZE) {
+        matScatter.selfadjointView<Upper>().rankUpdate(matData, dAlpha);
+        return;
+    }
+
+    //Tiles of the upper triangle are disjoint and can be computed concurrently
+    QList<RtCovTile> qListTiles;
+    for(int i = 0; i < iChannels; i += RTCOV_TILE_SIZE) {
+        for(int j = i; j < iChannels; j += RTCOV_TILE_SIZE) {
+            RtCovTile tile;
+            tile.pData = &matData;
+            tile.pScatter = &matScatter;
+            tile.iRow = i;
+            tile.iRows = qMin(RTCOV_TILE_SIZE, iChannels - i);
+            tile.iCol = j;
+            tile.iCols = qMin(RTCOV_TILE_SIZE, iChannels - j);
+            tile.dAlpha = dAlpha;
+            qListTiles.append(tile);
+        }
+    }
+
+    QtConcurrent::blockingMap(qListTiles, calcCovTile);
+}
+
+} // anonymous namespace
 
 
 //*************************************************************************************************************
@@ -68,10 +148,115 @@ using namespace FIFFLIB;
 // DEFINE MEMBER METHODS
 //=============================================================================================================
 
+RtCovAccumulator::RtCovAccumulator()
+: dWeight(0.0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void RtCovAccumulator::clear()
+{
+    vecMean.resize(0);
+    matScatter.resize(0,0);
+    dWeight = 0.0;
+}
+
+
+//*************************************************************************************************************
+
+void RtCovAccumulator::add(const MatrixXd& data, double dDecay)
+{
+    if(data.cols() == 0) {
+        return;
+    }
+
+    double dBlockWeight = data.cols();
+    VectorXd vecBlockMean = data.rowwise().mean();
+    MatrixXd matCentered = data.colwise() - vecBlockMean;
+
+    if(dWeight <= 0.0 || vecMean.size() != data.rows()) {
+        vecMean = vecBlockMean;
+        matScatter = MatrixXd::Zero(data.rows(), data.rows());
+        scatterUpdate(matCentered, matScatter, 1.0);
+        dWeight = dBlockWeight;
+        return;
+    }
+
+    if(dDecay != 1.0) {
+        matScatter.triangularView<Upper>() *= dDecay;
+    }
+
+    double dOldWeight = dWeight * dDecay;
+    double dNewWeight = dOldWeight + dBlockWeight;
+    VectorXd vecDelta = vecBlockMean - vecMean;
+
+    //Pairwise merge: M2 = M2_a + M2_b + delta*delta^T * n_a*n_b/n
+    scatterUpdate(matCentered, matScatter, 1.0);
+    matScatter.selfadjointView<Upper>().rankUpdate(vecDelta, dOldWeight * dBlockWeight / dNewWeight);
+
+    vecMean += vecDelta * (dBlockWeight / dNewWeight);
+    dWeight = dNewWeight;
+}
+
+
+//*************************************************************************************************************
+
+void RtCovAccumulator::remove(const MatrixXd& data)
+{
+    double dBlockWeight = data.cols();
+    double dOldWeight = dWeight - dBlockWeight;
+
+    if(dOldWeight <= 0.0) {
+        clear();
+        return;
+    }
+
+    VectorXd vecBlockMean = data.rowwise().mean();
+    MatrixXd matCentered = data.colwise() - vecBlockMean;
+
+    //Reverse the pairwise merge
+    VectorXd vecOldMean = (dWeight * vecMean - dBlockWeight * vecBlockMean) / dOldWeight;
+    VectorXd vecDelta = vecBlockMean - vecOldMean;
+
+    scatterUpdate(matCentered, matScatter, -1.0);
+    matScatter.selfadjointView<Upper>().rankUpdate(vecDelta, -dOldWeight * dBlockWeight / dWeight);
+
+    vecMean = vecOldMean;
+    dWeight = dOldWeight;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd RtCovAccumulator::covariance() const
+{
+    if(dWeight <= 1.0) {
+        return MatrixXd::Zero(matScatter.rows(), matScatter.cols());
+    }
+
+    MatrixXd matCov = matScatter.selfadjointView<Upper>();
+    matCov /= (dWeight - 1.0);
+
+    return matCov;
+}
+
+
+//*************************************************************************************************************
+
 RtCov::RtCov(qint32 p_iMaxSamples, FiffInfo::SPtr p_pFiffInfo, QObject *parent)
 : QThread(parent)
 , m_iMaxSamples(p_iMaxSamples)
 , m_iNewMaxSamples(0)
+, m_iWindowMode(Tumbling)
+, m_iNewWindowMode(Tumbling)
+, m_iEmitInterval(0)
+, m_iNewEmitInterval(0)
+, m_iSamplesSinceEmit(0)
+, m_iSamplesSeen(0)
+, m_iWindowSamples(0)
+, m_iEvictedSamples(0)
 , m_pFiffInfo(p_pFiffInfo)
 , m_bIsRunning(false)
 {
@@ -97,6 +282,7 @@ void RtCov::append(const MatrixXd &p_DataSegment)
     if(!m_pRawMatrixBuffer)
         m_pRawMatrixBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(32, p_DataSegment.rows(), p_DataSegment.cols()));
 
+    m_traceIds.push();
     m_pRawMatrixBuffer->push(&p_DataSegment);
 }
 
@@ -105,10 +291,29 @@ void RtCov::append(const MatrixXd &p_DataSegment)
 
 void RtCov::setSamples(qint32 samples)
 {
+    QMutexLocker locker(&mutex);
     m_iNewMaxSamples = samples;
 }
 
 
+//*************************************************************************************************************
+
+void RtCov::setWindowMode(qint32 mode)
+{
+    QMutexLocker locker(&mutex);
+    m_iNewWindowMode = mode;
+}
+
+
+//*************************************************************************************************************
+
+void RtCov::setEmitInterval(qint32 samples)
+{
+    QMutexLocker locker(&mutex);
+    m_iNewEmitInterval = samples > 0 ? samples : 0;
+}
+
+
 //*************************************************************************************************************
 
 bool RtCov::start()
@@ -133,6 +338,7 @@ bool RtCov::stop()
     m_pRawMatrixBuffer->releaseFromPop();
 
     m_pRawMatrixBuffer->clear();
+    m_traceIds.clear();
 
     return true;
 }
@@ -142,75 +348,172 @@ bool RtCov::stop()
 
 void RtCov::run()
 {
-    //SETUP
-    QStringList exclude;
-    for(int i = 0; i<m_pFiffInfo->chs.size(); i++) {
-        if(m_pFiffInfo->chs.at(i).kind == FIFFV_STIM_CH) {
-            exclude << m_pFiffInfo->chs.at(i).ch_name;
-        }
-    }
-    bool doProj = true;
+    static const int s_iTraceStage = Tracer::registerStage("RtCov");
 
-    quint32 n_samples = 0;
+    //SETUP
+    initPicks();
 
-    FiffCov::SPtr cov(new FiffCov());
-    VectorXd mu;
+    m_accumulator.clear();
+    m_qListWindow.clear();
+    m_iSamplesSeen = 0;
+    m_iSamplesSinceEmit = 0;
+    m_iWindowSamples = 0;
+    m_iEvictedSamples = 0;
 
     while(m_bIsRunning)
     {
         if(m_pRawMatrixBuffer)
         {
             MatrixXd rawSegment = m_pRawMatrixBuffer->pop();
+            TraceScope traceScope(s_iTraceStage, m_traceIds.pop());
 
-            if(n_samples == 0)
-            {
-                mu = rawSegment.rowwise().sum();
-                cov->data = rawSegment * rawSegment.transpose();
+            if(!m_bIsRunning || rawSegment.rows() != m_pFiffInfo->chs.size()) {
+                continue;
             }
-            else
-            {
-                mu.array() += rawSegment.rowwise().sum().array();
-                cov->data += rawSegment * rawSegment.transpose();
+
+            updateSettings();
+
+            //Exclude the stim channels before the product
+            MatrixXd data(m_vecPicks.size(), rawSegment.cols());
+            for(int i = 0; i < m_vecPicks.size(); ++i) {
+                data.row(i) = rawSegment.row(m_vecPicks[i]);
             }
-            n_samples += rawSegment.cols();
 
-            if(n_samples > m_iMaxSamples)
-            {
-                mu /= (float)n_samples;
-                cov->data.array() -= n_samples * (mu * mu.transpose()).array();
-                cov->data.array() /= (n_samples - 1);
+            quint32 iSamples = data.cols();
+            m_iSamplesSeen += iSamples;
+            m_iSamplesSinceEmit += iSamples;
+
+            switch(m_iWindowMode) {
+                case Sliding: {
+                    m_accumulator.add(data);
+                    m_qListWindow.append(data);
+                    m_iWindowSamples += iSamples;
+
+                    //Drop the oldest blocks as long as the window stays filled
+                    while(m_qListWindow.size() > 1 && m_iWindowSamples - m_qListWindow.first().cols() >= m_iMaxSamples) {
+                        m_accumulator.remove(m_qListWindow.first());
+                        m_iWindowSamples -= m_qListWindow.first().cols();
+                        m_iEvictedSamples += m_qListWindow.first().cols();
+                        m_qListWindow.removeFirst();
+                    }
+
+                    //Rebuild once per window turn to bound the round-off of the downdates
+                    if(m_iEvictedSamples >= m_iMaxSamples) {
+                        m_accumulator.clear();
+                        for(int i = 0; i < m_qListWindow.size(); ++i) {
+                            m_accumulator.add(m_qListWindow.at(i));
+                        }
+                        m_iEvictedSamples = 0;
+                    }
+                    break;
+                }
+                case Exponential: {
+                    //Per sample forgetting factor of an effective window of m_iMaxSamples
+                    double dDecay = std::pow(1.0 - 1.0/qMax(m_iMaxSamples, (quint32)2), (double)iSamples);
+                    m_accumulator.add(data, dDecay);
+                    break;
+                }
+                default: {
+                    m_accumulator.add(data);
+
+                    if(m_iSamplesSeen > m_iMaxSamples) {
+                        emitCovariance();
+
+                        m_accumulator.clear();
+                        m_iSamplesSeen = 0;
+                        m_iSamplesSinceEmit = 0;
+                    }
+                    break;
+                }
+            }
 
-                cov->kind = FIFFV_MNE_NOISE_COV;
-                cov->diag = false;
-                cov->dim = cov->data.rows();
+            if(m_iWindowMode == Sliding || m_iWindowMode == Exponential) {
+                quint32 iInterval = m_iEmitInterval > 0 ? m_iEmitInterval : m_iMaxSamples;
 
-                //ToDo do picks
-                cov->names = m_pFiffInfo->ch_names;
-                cov->projs = m_pFiffInfo->projs;
-                cov->bads = m_pFiffInfo->bads;
-                cov->nfree = n_samples;
+                if(m_iSamplesSeen >= m_iMaxSamples && m_iSamplesSinceEmit >= iInterval) {
+                    emitCovariance();
+                    m_iSamplesSinceEmit = 0;
+                }
+            }
+        }
+    }
+}
 
-                // regularize noise covariance
-                *cov.data() = cov->regularize(*m_pFiffInfo, 0.05, 0.05, 0.1, doProj, exclude);
 
-                emit covCalculated(cov);
+//*************************************************************************************************************
 
-                cov = FiffCov::SPtr(new FiffCov());
-                n_samples = 0;
-            }
+void RtCov::initPicks()
+{
+    m_qListExclude.clear();
+    m_qListPickNames.clear();
 
+    QList<int> qListPicks;
+    for(int i = 0; i < m_pFiffInfo->chs.size(); ++i) {
+        if(m_pFiffInfo->chs.at(i).kind == FIFFV_STIM_CH) {
+            m_qListExclude << m_pFiffInfo->chs.at(i).ch_name;
+        } else {
+            qListPicks.append(i);
+            m_qListPickNames << m_pFiffInfo->chs.at(i).ch_name;
+        }
+    }
+
+    m_vecPicks.resize(qListPicks.size());
+    for(int i = 0; i < qListPicks.size(); ++i) {
+        m_vecPicks[i] = qListPicks.at(i);
+    }
+}
 
-//            qint32 samples = rawSegment.cols();
-//            VectorXf mu = rawSegment.rowwise().sum().array() / (float)samples;
 
-//            MatrixXf noise_covariance = rawSegment * rawSegment.transpose();// noise_covariance == raw_covariance
-//            noise_covariance.array() -= samples * (mu * mu.transpose()).array();
-//            noise_covariance.array() /= (samples - 1);
+//*************************************************************************************************************
 
-//            std::cout << "Noise Covariance:\n" << noise_covariance.block(0,0,10,10) << std::endl;
+void RtCov::updateSettings()
+{
+    QMutexLocker locker(&mutex);
 
-//            printf("%d raw buffer (%d x %d) generated\r\n", count, tmp.rows(), tmp.cols());
+    m_iEmitInterval = m_iNewEmitInterval;
 
-        }
+    bool bReset = false;
+
+    if(m_iNewMaxSamples > 0 && m_iNewMaxSamples != m_iMaxSamples) {
+        m_iMaxSamples = m_iNewMaxSamples;
+        bReset = true;
+    }
+
+    if(m_iNewWindowMode != m_iWindowMode) {
+        m_iWindowMode = m_iNewWindowMode;
+        bReset = true;
+    }
+
+    if(bReset) {
+        m_accumulator.clear();
+        m_qListWindow.clear();
+        m_iSamplesSeen = 0;
+        m_iSamplesSinceEmit = 0;
+        m_iWindowSamples = 0;
+        m_iEvictedSamples = 0;
     }
 }
+
+
+//*************************************************************************************************************
+
+void RtCov::emitCovariance()
+{
+    FiffCov::SPtr cov(new FiffCov());
+
+    cov->data = m_accumulator.covariance();
+
+    cov->kind = FIFFV_MNE_NOISE_COV;
+    cov->diag = false;
+    cov->dim = cov->data.rows();
+
+    cov->names = m_qListPickNames;
+    cov->projs = m_pFiffInfo->projs;
+    cov->bads = m_pFiffInfo->bads;
+    cov->nfree = (qint32)m_accumulator.dWeight;
+
+    // regularize noise covariance
+    *cov.data() = cov->regularize(*m_pFiffInfo, 0.05, 0.05, 0.1, true, m_qListExclude);
+
+    emit covCalculated(cov);
+}
@@ -59,6 +59,7 @@
 //=============================================================================================================
 
 #include <utils/generics/circularmatrixbuffer.h>
+#include <utils/tracer.h>
 
 
 //*************************************************************************************************************
@@ -69,6 +70,7 @@
 #include <QThread>
 #include <QMutex>
 #include <QSharedPointer>
+#include <QList>
 
 
 //*************************************************************************************************************
@@ -98,6 +100,53 @@ using namespace IOBUFFER;
 using namespace FIFFLIB;
 
 
+//=============================================================================================================
+/**
+* Streaming mean and centered scatter matrix, merged block by block (Chan/Welford). Only the upper triangle of the
+* scatter matrix is maintained. Blocks can be added with an exponential decay of the previous state or removed
+* again to slide a window over the data.
+*/
+struct REALTIMESHARED_EXPORT RtCovAccumulator
+{
+    Eigen::VectorXd     vecMean;        /**< Weighted mean of the accumulated samples. */
+    Eigen::MatrixXd     matScatter;     /**< Centered scatter matrix, upper triangle only. */
+    double              dWeight;        /**< Sum of the sample weights. */
+
+    RtCovAccumulator();
+
+    //=========================================================================================================
+    /**
+    * Clears the accumulator.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Merges a block of samples into the accumulator.
+    *
+    * @param[in] data       The block, channels x samples.
+    * @param[in] dDecay     Factor applied to the weight of the previous state before merging (1.0 = no decay).
+    */
+    void add(const Eigen::MatrixXd& data, double dDecay = 1.0);
+
+    //=========================================================================================================
+    /**
+    * Removes a previously added block of samples from the accumulator.
+    *
+    * @param[in] data       The block, channels x samples.
+    */
+    void remove(const Eigen::MatrixXd& data);
+
+    //=========================================================================================================
+    /**
+    * Returns the full, symmetric sample covariance.
+    *
+    * @return the covariance matrix.
+    */
+    Eigen::MatrixXd covariance() const;
+};
+
+
 //=============================================================================================================
 /**
 * Real-time covariance estimation
@@ -111,6 +160,12 @@ public:
     typedef QSharedPointer<RtCov> SPtr;             /**< Shared pointer type for RtCov. */
     typedef QSharedPointer<const RtCov> ConstSPtr;  /**< Const shared pointer type for RtCov. */
 
+    enum WindowMode {
+        Tumbling = 0,       /**< Estimate over consecutive, disjoint windows. */
+        Sliding = 1,        /**< Estimate over the most recent samples. */
+        Exponential = 2     /**< Exponentially weighted estimate. */
+    };
+
     //=========================================================================================================
     /**
     * Creates the real-time covariance estimation object.
@@ -151,6 +206,23 @@ public:
     */
     void setSamples(qint32 samples);
 
+    //=========================================================================================================
+    /**
+    * Set the window mode. Tumbling emits one covariance per p_iMaxSamples and starts over, sliding keeps the
+    * last p_iMaxSamples samples and exponential weighs the samples with an effective window of p_iMaxSamples.
+    *
+    * @param[in] mode       window mode to set
+    */
+    void setWindowMode(qint32 mode);
+
+    //=========================================================================================================
+    /**
+    * Set the number of samples between two emitted covariances in the sliding and exponential mode.
+    *
+    * @param[in] samples    emit interval in samples, 0 emits once per window
+    */
+    void setEmitInterval(qint32 samples);
+
     //=========================================================================================================
     /**
     * Starts the RtCov by starting the producer's thread.
@@ -186,17 +258,53 @@ protected:
     virtual void run();
 
 private:
+    //=========================================================================================================
+    /**
+    * Picks the channels entering the covariance, i.e. all but the stimulus channels.
+    */
+    void initPicks();
+
+    //=========================================================================================================
+    /**
+    * Takes over the settings changed from outside and resets the estimation if the window changed.
+    */
+    void updateSettings();
+
+    //=========================================================================================================
+    /**
+    * Creates, regularizes and emits the covariance of the current accumulator state.
+    */
+    void emitCovariance();
+
     QMutex      mutex;                  /**< Provides access serialization between threads*/
 
     quint32      m_iMaxSamples;         /**< Maximal amount of samples received, before covariance is estimated.*/
 
     quint32      m_iNewMaxSamples;      /**< New maximal amount of samples received, before covariance is estimated.*/
 
+    qint32       m_iWindowMode;         /**< The window mode, see WindowMode. */
+    qint32       m_iNewWindowMode;      /**< New window mode. */
+
+    quint32      m_iEmitInterval;       /**< Samples between two emitted covariances in sliding/exponential mode, 0 once per window. */
+    quint32      m_iNewEmitInterval;    /**< New emit interval. */
+
+    quint32      m_iSamplesSinceEmit;   /**< Samples accumulated since the last covariance was emitted. */
+    qint64       m_iSamplesSeen;        /**< Samples accumulated since the last reset. */
+    quint32      m_iWindowSamples;      /**< Samples currently held in the sliding window. */
+    quint32      m_iEvictedSamples;     /**< Samples evicted since the accumulator was last rebuilt from the window. */
+
+    Eigen::VectorXi     m_vecPicks;             /**< Rows of the data which enter the covariance (all but stim channels). */
+    QStringList         m_qListPickNames;       /**< Names of the picked channels. */
+    QStringList         m_qListExclude;         /**< Excluded (stim) channel names. */
+    RtCovAccumulator    m_accumulator;          /**< The streaming covariance accumulator. */
+    QList<Eigen::MatrixXd> m_qListWindow;       /**< Picked blocks currently held in the sliding window. */
+
     FiffInfo::SPtr  m_pFiffInfo;        /**< Holds the fiff measurement information. */
 
     bool        m_bIsRunning;           /**< Holds if real-time Covariance estimation is running.*/
 
     CircularMatrixBuffer<double>::SPtr m_pRawMatrixBuffer;   /**< The Circular Raw Matrix Buffer. */
+    UTILSLIB::TraceIdQueue m_traceIds;                      /**< The trace ids of the buffered blocks. */
 };
 
 //*************************************************************************************************************
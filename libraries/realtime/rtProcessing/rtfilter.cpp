@@ -52,20 +52,6 @@ using namespace UTILSLIB;
 using namespace FIFFLIB;
 
 
-//*************************************************************************************************************
-//=============================================================================================================
-// DEFINE GLOBAL METHODS
-//=============================================================================================================
-
-void doFilterPerChannelRTMSA(QPair<QList<FilterData>,QPair<int,RowVectorXd> > &channelDataTime)
-{
-    for(int i = 0; i < channelDataTime.first.size(); ++i) {
-        //channelDataTime.second.second = channelDataTime.first.at(i).applyConvFilter(channelDataTime.second.second, true, FilterData::ZeroPad);
-        channelDataTime.second.second = channelDataTime.first.at(i).applyFFTFilter(channelDataTime.second.second, true, FilterData::ZeroPad); //FFT Convolution for rt is not suitable. FFT make the signal filtering non causal.
-    }
-}
-
-
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -87,68 +73,105 @@ RtFilter::~RtFilter()
 
 MatrixXd RtFilter::filterChannelsConcurrently(const MatrixXd& matDataIn, int iMaxFilterLength, const QVector<int>& lFilterChannelList, const QList<FilterData>& lFilterData)
 {
-    //Initialise the overlay matrix
-    if(m_matOverlap.cols() != iMaxFilterLength || m_matOverlap.rows() < matDataIn.rows()) {
-        m_matOverlap.resize(matDataIn.rows(), iMaxFilterLength);
-        m_matOverlap.setZero();
+    static const int s_iTraceStage = Tracer::registerStage("RtFilter");
+    TraceScope traceScope(s_iTraceStage);
+
+    //Update the engine only if the filters or the channel selection changed
+    RowVectorXd vecCoeffs = OverlapSaveFilter::cascade(lFilterData);
+    if(vecCoeffs.cols() != m_overlapSave.length() || vecCoeffs != m_overlapSave.coefficients()) {
+        m_overlapSave.setCoefficients(vecCoeffs);
     }
 
-    if(m_matDelay.cols() != iMaxFilterLength/2 || m_matOverlap.rows() < matDataIn.rows()) {
-        m_matDelay.resize(matDataIn.rows(), iMaxFilterLength/2);
-        m_matDelay.setZero();
+    //IIR filters are not part of the FIR cascade. Their sections are chained and run causally after it.
+    MatrixXd matSOS(0, 6);
+    for(int i = 0; i < lFilterData.size(); ++i) {
+        if(lFilterData.at(i).isIIR()) {
+            matSOS.conservativeResize(matSOS.rows() + lFilterData.at(i).m_matSOS.rows(), 6);
+            matSOS.bottomRows(lFilterData.at(i).m_matSOS.rows()) = lFilterData.at(i).m_matSOS;
+        }
     }
 
-    //Resize output matrix to match input matrix
-    MatrixXd matDataOut(matDataIn.rows(), matDataIn.cols());
+    if(matSOS.rows() != m_iirFilter.sectionCount() || matSOS != m_iirFilter.sections()) {
+        m_iirFilter.setSections(matSOS);
+    }
 
-    //Generate QList structure which can be handled by the QConcurrent framework
-    QList<QPair<QList<FilterData>,QPair<int,RowVectorXd> > > timeData;
-    QList<int> notFilterChannelIndex;
+    if(lFilterChannelList != m_lFilterChannelList || m_vecIsFiltered.size() != matDataIn.rows()) {
+        m_lFilterChannelList = lFilterChannelList;
 
-    //Only select channels specified in lFilterChannelList
-    for(qint32 i = 0; i < matDataIn.rows(); ++i) {
-        int pos = lFilterChannelList.indexOf(i);
-        if(pos != -1 && pos < matDataIn.rows()) {
-            timeData.append(QPair<QList<FilterData>,QPair<int,RowVectorXd> >(lFilterData,QPair<int,RowVectorXd>(pos,matDataIn.row(pos))));
-        } else {
-            notFilterChannelIndex.append(i);
+        m_vecIsFiltered.fill(false, matDataIn.rows());
+        for(int i = 0; i < lFilterChannelList.size(); ++i) {
+            if(lFilterChannelList.at(i) >= 0 && lFilterChannelList.at(i) < matDataIn.rows()) {
+                m_vecIsFiltered[lFilterChannelList.at(i)] = true;
+            }
         }
+
+        m_overlapSave.reset();
+        m_iirFilter.reset();
     }
 
-    //Do the concurrent filtering
-    if(!timeData.isEmpty()) {
-        QFuture<void> future = QtConcurrent::map(timeData,
-                                             doFilterPerChannelRTMSA);
+    //Only the FIR part has a fixed delay, the IIR part is minimum phase and not compensated
+    int iDelay = iMaxFilterLength/2;
+    if(m_overlapSave.length() > 0) {
+        iDelay = m_overlapSave.delay();
+    } else if(m_iirFilter.sectionCount() > 0) {
+        iDelay = 0;
+    }
+
+    if(m_matDelay.cols() != iDelay || m_matDelay.rows() != matDataIn.rows()) {
+        m_matDelay = MatrixXd::Zero(matDataIn.rows(), iDelay);
+    }
 
-        future.waitForFinished();
+    MatrixXd matDataOut(matDataIn.rows(), matDataIn.cols());
+
+    //Gather the filtered channels into one contiguous matrix
+    int iNumFiltered = 0;
+    for(int i = 0; i < m_vecIsFiltered.size(); ++i) {
+        if(m_vecIsFiltered.at(i)) {
+            ++iNumFiltered;
+        }
+    }
 
-        //Do the overlap add method and store in matDataOut
-        int iFilteredNumberCols = timeData.at(0).second.second.cols();
+    if(iNumFiltered > 0) {
+        if(m_matFilterIn.rows() != iNumFiltered || m_matFilterIn.cols() != matDataIn.cols()) {
+            m_matFilterIn.resize(iNumFiltered, matDataIn.cols());
+        }
 
-        for(int r = 0; r < timeData.size(); r++) {
-            //Get the currently filtered data. This data has a delay of filterLength/2 in front and back.
-            RowVectorXd tempData = timeData.at(r).second.second;
+        for(int i = 0, r = 0; i < m_vecIsFiltered.size(); ++i) {
+            if(m_vecIsFiltered.at(i)) {
+                m_matFilterIn.row(r++) = matDataIn.row(i);
+            }
+        }
 
-            //Perform the actual overlap add by adding the last filterlength data to the newly filtered one
-            tempData.head(iMaxFilterLength) += m_matOverlap.row(timeData.at(r).second.first);
+        m_overlapSave.filter(m_matFilterIn, m_matFilterOut);
 
-            //Write the newly calulated filtered data to the filter data matrix. Keep in mind that the current block also effect last part of the last block (begin at dataIndex-iFilterDelay).
-            int start = 0;
-            matDataOut.row(timeData.at(r).second.first).segment(start,iFilteredNumberCols-iMaxFilterLength) = tempData.head(iFilteredNumberCols-iMaxFilterLength);
+        if(m_iirFilter.sectionCount() > 0) {
+            m_iirFilter.filter(m_matFilterOut, m_matFilterOut);
+        }
 
-            //Refresh the m_matOverlap with the new calculated filtered data.
-            m_matOverlap.row(timeData.at(r).second.first) = timeData.at(r).second.second.tail(iMaxFilterLength);
+        for(int i = 0, r = 0; i < m_vecIsFiltered.size(); ++i) {
+            if(m_vecIsFiltered.at(i)) {
+                matDataOut.row(i) = m_matFilterOut.row(r++);
+            }
         }
     }
 
-    //Fill filtered data with raw data if the channel was not filtered
-    for(int i = 0; i < notFilterChannelIndex.size(); ++i) {
-        matDataOut.row(notFilterChannelIndex.at(i)) << m_matDelay.row(notFilterChannelIndex.at(i)), matDataIn.row(notFilterChannelIndex.at(i)).head(matDataIn.cols() - iMaxFilterLength/2);
+    //Delay the channels which are not filtered by the filter delay
+    int iCols = matDataIn.cols();
+    for(int i = 0; i < m_vecIsFiltered.size(); ++i) {
+        if(m_vecIsFiltered.at(i)) {
+            continue;
+        }
 
-        //matDataOut.row(notFilterChannelIndex.at(i)).segment(0, matDataIn.row(notFilterChannelIndex.at(i)).cols()) = matDataIn.row(notFilterChannelIndex.at(i));
+        if(iCols >= iDelay) {
+            matDataOut.row(i).head(iDelay) = m_matDelay.row(i);
+            matDataOut.row(i).tail(iCols - iDelay) = matDataIn.row(i).head(iCols - iDelay);
+            m_matDelay.row(i) = matDataIn.row(i).tail(iDelay);
+        } else {
+            matDataOut.row(i) = m_matDelay.row(i).head(iCols);
+            m_matDelay.row(i).head(iDelay - iCols) = m_matDelay.row(i).tail(iDelay - iCols).eval();
+            m_matDelay.row(i).tail(iCols) = matDataIn.row(i);
+        }
     }
 
-    m_matDelay = matDataIn.block(0, matDataIn.cols()-iMaxFilterLength/2, matDataIn.rows(), iMaxFilterLength/2);
-
     return matDataOut;
 }
@@ -43,6 +43,9 @@
 #include "../realtime_global.h"
 
 #include <utils/filterTools/filterdata.h>
+#include <utils/filterTools/overlapsavefilter.h>
+#include <utils/filterTools/iirfilter.h>
+#include <utils/tracer.h>
 #include <fiff/fiff_info.h>
 
 
@@ -52,8 +55,7 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
-#include <QtConcurrent/QtConcurrent>
-#include <QFuture>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -62,7 +64,6 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
-#include <unsupported/Eigen/FFT>
 
 
 //*************************************************************************************************************
@@ -82,9 +83,9 @@ namespace REALTIMELIB
 
 //=============================================================================================================
 /**
-* Real-time noise Spectrum estimation
+* Real-time filtering of streamed data blocks
 *
-* @brief Real-time Noise estimation
+* @brief Real-time filtering
 */
 class REALTIMESHARED_EXPORT RtFilter
 {
@@ -107,17 +108,29 @@ public:
 
     //=========================================================================================================
     /**
-    * Calculates the filtered version of the raw input data
+    * Calculates the filtered version of the raw input data. The FIR filters are combined into one FIR filter which
+    * is streamed over the selected channels with the overlap-save method, IIR filters are run causally as a
+    * cascade of second-order sections afterwards. The state is carried over between calls, so consecutive blocks
+    * are filtered as one continuous signal. Channels which are not filtered are delayed by the FIR filter delay so
+    * that all channels stay aligned.
     *
-    * @param [in] matDataIn     data which is to be filtered
-    * @param [out] matDataOut    data which is to be filtered
-    * @param [in] iDataIndex    current position in the global data matrix
+    * @param [in] matDataIn             data which is to be filtered
+    * @param [in] iMaxFilterLength      length of the longest filter, used as delay if no filter is given
+    * @param [in] lFilterChannelList    rows of matDataIn which are to be filtered
+    * @param [in] lFilterData           the filters which are applied one after another
+    *
+    * @return the filtered data
     */
     Eigen::MatrixXd filterChannelsConcurrently(const Eigen::MatrixXd& matDataIn, int iMaxFilterLength, const QVector<int>& lFilterChannelList, const QList<UTILSLIB::FilterData> &lFilterData);
 
 protected:
-    Eigen::MatrixXd                 m_matOverlap;                   /**< Last overlap block */
+    UTILSLIB::OverlapSaveFilter     m_overlapSave;                  /**< The block-streaming filter engine */
+    UTILSLIB::IIRFilter             m_iirFilter;                    /**< The causal second-order-section engine for IIR filters */
     Eigen::MatrixXd                 m_matDelay;                     /**< Last delay block */
+    Eigen::MatrixXd                 m_matFilterIn;                  /**< The gathered channels to be filtered */
+    Eigen::MatrixXd                 m_matFilterOut;                 /**< The filtered channels */
+    QVector<int>                    m_lFilterChannelList;           /**< The channel selection the state belongs to */
+    QVector<bool>                   m_vecIsFiltered;                /**< Whether a row is filtered, indexed by row */
 
 private:
 
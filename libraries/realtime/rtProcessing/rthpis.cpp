@@ -101,6 +101,42 @@ void RtHPISWorker::doWork(const Eigen::MatrixXd& matData,
 }
 
 
+//*************************************************************************************************************
+
+void RtHPISWorker::doWorkContinuous(const Eigen::MatrixXd& matAmplitudes,
+                                    const Eigen::MatrixXd& matProjectors,
+                                    QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo,
+                                    bool bRestart)
+{
+    if(bRestart) {
+        m_matCoilPos.resize(0,0);
+    }
+
+    FittingResult fitResult;
+    fitResult.devHeadTrans.from = 1;
+    fitResult.devHeadTrans.to = 4;
+
+    double dError = HPIFit::fitHPIFromAmplitudes(matAmplitudes,
+                                                 matProjectors,
+                                                 fitResult.devHeadTrans,
+                                                 fitResult.errorDistances,
+                                                 fitResult.fittedCoils,
+                                                 m_matCoilPos,
+                                                 pFiffInfo);
+
+    //Do not start the next fit from positions which did not explain the data
+    if(dError < 0.0 || dError > 0.1) {
+        m_matCoilPos.resize(0,0);
+    }
+
+    if(dError >= 0.0) {
+        emit resultReady(fitResult);
+    }
+
+    emit continuousFitFinished();
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS RtHPIS
@@ -109,6 +145,13 @@ void RtHPISWorker::doWork(const Eigen::MatrixXd& matData,
 RtHPIS::RtHPIS(FiffInfo::SPtr p_pFiffInfo, QObject *parent)
 : QObject(parent)
 , m_pFiffInfo(p_pFiffInfo)
+, m_bContinuous(false)
+, m_bReset(true)
+, m_bRestart(true)
+, m_iFitInterval(100)
+, m_iFitIntervalSamples(0)
+, m_iSamplesSinceFit(0)
+, m_iFitPending(0)
 {
     qRegisterMetaType<REALTIMELIB::FittingResult>("REALTIMELIB::FittingResult");
     qRegisterMetaType<QVector<int> >("QVector<int>");
@@ -123,9 +166,15 @@ RtHPIS::RtHPIS(FiffInfo::SPtr p_pFiffInfo, QObject *parent)
     connect(this, &RtHPIS::operate,
             worker, &RtHPISWorker::doWork);
 
+    connect(this, &RtHPIS::operateContinuous,
+            worker, &RtHPISWorker::doWorkContinuous);
+
     connect(worker, &RtHPISWorker::resultReady,
             this, &RtHPIS::handleResults);
 
+    connect(worker, &RtHPISWorker::continuousFitFinished,
+            this, &RtHPIS::onContinuousFitFinished, Qt::DirectConnection);
+
     m_workerThread.start();
 }
 
@@ -143,10 +192,52 @@ RtHPIS::~RtHPIS()
 
 void RtHPIS::append(const MatrixXd &data)
 {
-    emit operate(data,
-                 m_matProjectors,
-                 m_vCoilFreqs,
-                 m_pFiffInfo);
+    QMutexLocker locker(&m_mutex);
+
+    if(!m_bContinuous) {
+        emit operate(data,
+                     m_matProjectors,
+                     m_vCoilFreqs,
+                     m_pFiffInfo);
+        return;
+    }
+
+    if(m_bReset) {
+        m_demodulator.setup(m_vCoilFreqs, m_pFiffInfo->sfreq);
+        m_iFitIntervalSamples = qMax(1, qRound(m_pFiffInfo->sfreq * m_iFitInterval / 1000.0));
+        m_iSamplesSinceFit = 0;
+        m_bReset = false;
+        m_bRestart = true;
+    }
+
+    m_demodulator.append(data);
+    m_iSamplesSinceFit += data.cols();
+
+    //Skip this fit if the previous one is still running, the next interval will catch up with the latest amplitudes
+    if(m_iSamplesSinceFit >= m_iFitIntervalSamples
+            && m_demodulator.isValid()
+            && m_iFitPending.testAndSetAcquire(0, 1)) {
+        m_iSamplesSinceFit = 0;
+
+        emit operateContinuous(m_demodulator.amplitudes(),
+                               m_matProjectors,
+                               m_pFiffInfo,
+                               m_bRestart);
+
+        m_bRestart = false;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void RtHPIS::setContinuousMode(bool bContinuous, int iFitInterval)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_bContinuous = bContinuous;
+    m_iFitInterval = iFitInterval;
+    m_bReset = true;
 }
 
 
@@ -154,7 +245,10 @@ void RtHPIS::append(const MatrixXd &data)
 
 void RtHPIS::setCoilFrequencies(const QVector<int>& vCoilFreqs)
 {
+    QMutexLocker locker(&m_mutex);
+
     m_vCoilFreqs = vCoilFreqs;
+    m_bReset = true;
 }
 
 
@@ -162,7 +256,10 @@ void RtHPIS::setCoilFrequencies(const QVector<int>& vCoilFreqs)
 
 void RtHPIS::setProjectionMatrix(const Eigen::MatrixXd& matProjectors)
 {
+    QMutexLocker locker(&m_mutex);
+
     m_matProjectors = matProjectors;
+    m_bRestart = true;
 }
 
 
@@ -172,3 +269,11 @@ void RtHPIS::handleResults(const REALTIMELIB::FittingResult& fitResult)
 {
     emit newFittingResultAvailable(fitResult);
 }
+
+
+//*************************************************************************************************************
+
+void RtHPIS::onContinuousFitFinished()
+{
+    m_iFitPending.storeRelease(0);
+}
@@ -50,6 +50,7 @@
 #include <fiff/fiff_dig_point_set.h>
 #include <fiff/fiff_dig_point.h>
 #include <fiff/fiff_coord_trans.h>
+#include <inverse/hpiFit/hpidemodulator.h>
 
 
 //*************************************************************************************************************
@@ -67,6 +68,7 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QAtomicInt>
 #include <QSharedPointer>
 #include <QVector>
 
@@ -129,8 +131,27 @@ public:
                 const QVector<int>& vFreqs,
                 QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
 
+    //=========================================================================================================
+    /**
+    * Perform one HPI fit from continuously demodulated amplitudes. The dipole fits start from the coil
+    * positions of the previous fit, unless the previous fit failed or a restart is requested.
+    *
+    * @param[in] matAmplitudes      The amplitude topography for each coil (channels x coils).
+    * @param[in] matProjectors      The projectors to apply. Bad channels are still included.
+    * @param[in] pFiffInfo          Associated Fiff Information.
+    * @param[in] bRestart           Whether to discard the previous coil positions.
+    */
+    void doWorkContinuous(const Eigen::MatrixXd& matAmplitudes,
+                          const Eigen::MatrixXd& matProjectors,
+                          QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo,
+                          bool bRestart);
+
+protected:
+    Eigen::MatrixXd     m_matCoilPos;           /**< The coil positions of the last continuous fit, used as starting point for the next one. */
+
 signals:
     void resultReady(const REALTIMELIB::FittingResult &fitResult);
+    void continuousFitFinished();
 };
 
 //=============================================================================================================
@@ -170,6 +191,17 @@ public:
     */
     void append(const Eigen::MatrixXd &data);
 
+    //=========================================================================================================
+    /**
+    * Switches the continuous HPI mode on or off. In continuous mode the appended blocks are demodulated
+    * incrementally and a warm-started fit is started every fit interval, as long as the previous fit has
+    * finished. Otherwise every appended block is fitted from scratch.
+    *
+    * @param[in] bContinuous    Whether to use the continuous mode.
+    * @param[in] iFitInterval   The interval between two fits in ms.
+    */
+    void setContinuousMode(bool bContinuous, int iFitInterval = 100);
+
     //=========================================================================================================
     /**
     * Set the coil frequencies.
@@ -193,18 +225,38 @@ protected:
     */
     void handleResults(const FittingResult &fitResult);
 
+    //=========================================================================================================
+    /**
+    * Marks the running continuous fit as finished. Called from the worker thread.
+    */
+    void onContinuousFitFinished();
+
     QSharedPointer<FIFFLIB::FiffInfo>               m_pFiffInfo;           /**< Holds the fiff measurement information. */
 
     QThread             m_workerThread;         /**< The worker thread. */
+    QMutex              m_mutex;                /**< Guards the coil frequencies, the projectors and the demodulator. */
     QVector<int>        m_vCoilFreqs;           /**< Vector contains the HPI coil frequencies. */
     Eigen::MatrixXd     m_matProjectors;        /**< Holds the matrix with the SSP and compensator projectors.*/
 
+    bool                        m_bContinuous;          /**< Whether the continuous HPI mode is active. */
+    bool                        m_bReset;               /**< Whether the demodulator has to be set up again before the next block. */
+    bool                        m_bRestart;             /**< Whether the next continuous fit has to discard the previous coil positions. */
+    int                         m_iFitInterval;         /**< The interval between two continuous fits in ms. */
+    qint64                      m_iFitIntervalSamples;  /**< The number of samples between two continuous fits. */
+    qint64                      m_iSamplesSinceFit;     /**< The number of samples appended since the last continuous fit. */
+    QAtomicInt                  m_iFitPending;          /**< Whether a continuous fit is running in the worker thread. */
+    INVERSELIB::HPIDemodulator  m_demodulator;          /**< The continuous HPI amplitude demodulation. */
+
 signals:
     void newFittingResultAvailable(const REALTIMELIB::FittingResult &fitResult);
     void operate(const Eigen::MatrixXd& matData,
                  const Eigen::MatrixXd& matProjectors,
                  const QVector<int>& vFreqs,
                  QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
+    void operateContinuous(const Eigen::MatrixXd& matAmplitudes,
+                           const Eigen::MatrixXd& matProjectors,
+                           QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo,
+                           bool bRestart);
 };
 
 //*************************************************************************************************************
@@ -56,6 +56,8 @@
 //=============================================================================================================
 
 using namespace REALTIMELIB;
+using namespace UTILSLIB;
+using namespace INVERSELIB;
 
 
 //*************************************************************************************************************
@@ -68,8 +70,17 @@ RtInvOp::RtInvOp(FiffInfo::SPtr &p_pFiffInfo, MNEForwardSolution::SPtr &p_pFwd,
 , m_bIsRunning(false)
 , m_pFiffInfo(p_pFiffInfo)
 , m_pFwd(p_pFwd)
+, m_sMethod("dSPM")
+, m_fLambda(1.0f / 9.0f)
+, m_iNumAverages(1)
+, m_bPickNormal(false)
+, m_iBuildTime(-1)
+, m_iPublishedCovTime(-1)
+, m_iDroppedCount(0)
 {
     qRegisterMetaType<MNEInverseOperator::SPtr>("MNEInverseOperator::SPtr");
+
+    m_timer.start();
 }
 
 
@@ -88,18 +99,74 @@ void RtInvOp::appendNoiseCov(FiffCov &p_noiseCov)
     mutex.lock();
     //Use here a circular buffer
     m_vecNoiseCov.push_back(p_noiseCov);
+    m_vecNoiseCovTime.push_back(m_timer.elapsed());
+    m_traceIds.push();
 
     qDebug() << "RtInvOp m_vecNoiseCov" << m_vecNoiseCov.size();
 
+    m_noiseCovAvailable.wakeOne();
     mutex.unlock();
 }
 
 
+//*************************************************************************************************************
+
+void RtInvOp::setMinimumNormSettings(const QString &sMethod, float fLambda, qint32 iNumAverages, bool bPickNormal)
+{
+    QMutexLocker locker(&mutex);
+
+    m_sMethod = sMethod;
+    m_fLambda = fLambda;
+    m_iNumAverages = iNumAverages;
+    m_bPickNormal = bPickNormal;
+}
+
+
+//*************************************************************************************************************
+
+MinimumNorm::SPtr RtInvOp::minimumNorm()
+{
+    QMutexLocker locker(&mutex);
+    return m_pMinimumNorm;
+}
+
+
+//*************************************************************************************************************
+
+qint64 RtInvOp::buildTime()
+{
+    QMutexLocker locker(&mutex);
+    return m_iBuildTime;
+}
+
+
+//*************************************************************************************************************
+
+qint64 RtInvOp::staleness()
+{
+    QMutexLocker locker(&mutex);
+    return m_iPublishedCovTime < 0 ? -1 : m_timer.elapsed() - m_iPublishedCovTime;
+}
+
+
+//*************************************************************************************************************
+
+int RtInvOp::droppedCount()
+{
+    QMutexLocker locker(&mutex);
+    return m_iDroppedCount;
+}
+
+
 //*************************************************************************************************************
 
 bool RtInvOp::stop()
 {
+    mutex.lock();
     m_bIsRunning = false;
+    m_noiseCovAvailable.wakeAll();
+    mutex.unlock();
+
     QThread::wait();
 
     return true;
@@ -110,21 +177,67 @@ bool RtInvOp::stop()
 
 void RtInvOp::run()
 {
+    static const int s_iTraceStage = Tracer::registerStage("RtInvOp");
+
+    //Rebuilds must not compete with acquisition and source estimation
+    setPriority(QThread::LowPriority);
+
     m_bIsRunning = true;
 
     while(m_bIsRunning)
     {
-        if(m_vecNoiseCov.size() > 0)
-        {
-            // Restrict forward solution as necessary for MEG
-            MNEForwardSolution t_forwardMeg = m_pFwd->pick_types(true, false);
+        mutex.lock();
 
-            mutex.lock();
-            MNEInverseOperator::SPtr t_invOpMeg(new MNEInverseOperator(*m_pFiffInfo.data(), t_forwardMeg, m_vecNoiseCov[0], 0.2f, 0.8f));
-            m_vecNoiseCov.pop_front();
+        while(m_bIsRunning && m_vecNoiseCov.isEmpty()) {
+            m_noiseCovAvailable.wait(&mutex);
+        }
+
+        if(!m_bIsRunning) {
             mutex.unlock();
+            break;
+        }
 
-            emit invOperatorCalculated(t_invOpMeg);
+        //Only the newest covariance is built, older ones would be outdated before they are published
+        while(m_vecNoiseCov.size() > 1) {
+            m_vecNoiseCov.pop_front();
+            m_vecNoiseCovTime.pop_front();
+            m_traceIds.pop();
+            ++m_iDroppedCount;
         }
+
+        FiffCov t_noiseCov = m_vecNoiseCov.takeFirst();
+        qint64 iCovTime = m_vecNoiseCovTime.takeFirst();
+        quint64 iTraceId = m_traceIds.pop();
+
+        QString sMethod = m_sMethod;
+        float fLambda = m_fLambda;
+        qint32 iNumAverages = m_iNumAverages;
+        bool bPickNormal = m_bPickNormal;
+
+        mutex.unlock();
+
+        TraceScope traceScope(s_iTraceStage, iTraceId);
+
+        QElapsedTimer buildTimer;
+        buildTimer.start();
+
+        // Restrict forward solution as necessary for MEG
+        MNEForwardSolution t_forwardMeg = m_pFwd->pick_types(true, false);
+
+        MNEInverseOperator::SPtr t_invOpMeg(new MNEInverseOperator(*m_pFiffInfo.data(), t_forwardMeg, t_noiseCov, 0.2f, 0.8f));
+
+        //Prepare the kernel here, so consumers only have to swap a pointer
+        MinimumNorm::SPtr t_pMinimumNorm(new MinimumNorm(*t_invOpMeg.data(), fLambda, sMethod));
+        t_pMinimumNorm->doInverseSetup(iNumAverages, bPickNormal);
+
+        mutex.lock();
+        m_pMinimumNorm = t_pMinimumNorm;
+        m_iBuildTime = buildTimer.elapsed();
+        m_iPublishedCovTime = iCovTime;
+        mutex.unlock();
+
+        qDebug() << "RtInvOp published operator - build time" << buildTimer.elapsed() << "ms";
+
+        emit invOperatorCalculated(t_invOpMeg);
     }
 }
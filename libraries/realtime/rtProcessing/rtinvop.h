@@ -59,6 +59,10 @@
 #include <mne/mne_forwardsolution.h>
 #include <mne/mne_inverse_operator.h>
 
+#include <inverse/minimumNorm/minimumnorm.h>
+
+#include <utils/tracer.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -67,6 +71,8 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
 #include <QSharedPointer>
 
 
@@ -99,7 +105,9 @@ using namespace MNELIB;
 
 //=============================================================================================================
 /**
-* Real-time inverse dSPM, sLoreta inverse operator estimation
+* Real-time inverse dSPM, sLoreta inverse operator estimation. The operators are built and prepared on a low
+* priority thread and published as a ready to use minimum norm kernel, so consumers never wait for a rebuild.
+* While an operator is built, newer noise covariances supersede the queued ones.
 *
 * @brief Real-time inverse operator estimation
 */
@@ -134,6 +142,52 @@ public:
     */
     void appendNoiseCov(FiffCov &p_NoiseCov);
 
+    //=========================================================================================================
+    /**
+    * Sets the parameters the published minimum norm kernels are prepared with. They are used from the next
+    * rebuild on.
+    *
+    * @param[in] sMethod        The minimum norm method ("MNE" | "dSPM" | "sLORETA").
+    * @param[in] fLambda        The regularization parameter.
+    * @param[in] iNumAverages   The number of averages of the data the kernel is applied to.
+    * @param[in] bPickNormal    Whether to pick the normal component of the current.
+    */
+    void setMinimumNormSettings(const QString &sMethod, float fLambda, qint32 iNumAverages, bool bPickNormal = false);
+
+    //=========================================================================================================
+    /**
+    * Returns the latest published, fully prepared minimum norm estimator. Only the shared pointer is copied,
+    * the call never waits for a running rebuild.
+    *
+    * @return The minimum norm estimator, or a null pointer if no operator was built yet.
+    */
+    INVERSELIB::MinimumNorm::SPtr minimumNorm();
+
+    //=========================================================================================================
+    /**
+    * Returns how long building and preparing the published operator took.
+    *
+    * @return The build time in ms, or -1 if no operator was built yet.
+    */
+    qint64 buildTime();
+
+    //=========================================================================================================
+    /**
+    * Returns the age of the noise covariance the published operator was built from.
+    *
+    * @return The time since the noise covariance was appended in ms, or -1 if no operator was built yet.
+    */
+    qint64 staleness();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of noise covariances which were superseded by newer ones before an operator was built
+    * from them.
+    *
+    * @return The number of dropped noise covariances.
+    */
+    int droppedCount();
+
     //=========================================================================================================
     /**
     * Stops the RtInv by stopping the producer's thread.
@@ -170,12 +224,26 @@ protected:
 
 private:
     QMutex      mutex;                  /**< Provides access serialization between threads. */
+    QWaitCondition m_noiseCovAvailable; /**< Wakes the build thread when a noise covariance was appended or RtInv stops. */
     bool        m_bIsRunning;           /**< Whether RtInv is running. */
 
     QVector<FiffCov> m_vecNoiseCov;     /**< Noise covariance matrices. */
+    QVector<qint64> m_vecNoiseCovTime;  /**< The time each queued noise covariance was appended, in ms of m_timer. */
+    UTILSLIB::TraceIdQueue m_traceIds;  /**< The trace ids of the queued noise covariance matrices. */
 
     FiffInfo::SPtr m_pFiffInfo;         /**< The fiff measurement information. */
     MNEForwardSolution::SPtr m_pFwd;    /**< The forward solution. */
+
+    QString     m_sMethod;              /**< The minimum norm method. */
+    float       m_fLambda;              /**< The regularization parameter. */
+    qint32      m_iNumAverages;         /**< The number of averages the kernel is prepared for. */
+    bool        m_bPickNormal;          /**< Whether to pick the normal component of the current. */
+
+    INVERSELIB::MinimumNorm::SPtr m_pMinimumNorm;   /**< The published minimum norm estimator. */
+    QElapsedTimer m_timer;              /**< The time base of the build time and staleness metrics. */
+    qint64      m_iBuildTime;           /**< The time it took to build the published operator in ms. */
+    qint64      m_iPublishedCovTime;    /**< The time the noise covariance of the published operator was appended. */
+    int         m_iDroppedCount;        /**< The number of superseded noise covariances. */
 };
 
 //*************************************************************************************************************
@@ -44,6 +44,7 @@
 #include "rtnoise.h"
 
 #include <iostream>
+#include <limits>
 #include <fiff/fiff_cov.h>
 
 
@@ -53,6 +54,7 @@
 //=============================================================================================================
 
 #include <QDebug>
+#include <QMutexLocker>
 
 
 //*************************************************************************************************************
@@ -79,6 +81,7 @@ RtNoise::RtNoise(qint32 p_iMaxSamples, FiffInfo::SPtr p_pFiffInfo, qint32 p_data
 , m_iBlockSize(0)
 , m_iSensors(0)
 , m_iBlockIndex(0)
+, m_dAlpha(0.0)
 {
     qRegisterMetaType<Eigen::MatrixXd>("Eigen::MatrixXd");
     //qRegisterMetaType<QVector<double>>("QVector<double>");
@@ -86,14 +89,6 @@ RtNoise::RtNoise(qint32 p_iMaxSamples, FiffInfo::SPtr p_pFiffInfo, qint32 p_data
     m_Fs = m_pFiffInfo->sfreq;
 
     m_bSendDataToBuffer = true;
-
-    m_fWin.clear();
-
-    //create a hanning window
-    m_fWin = hanning(m_iFFTlength,0);
-
-    qDebug()<<"Hanning window is created.";
-
 }
 
 
@@ -106,52 +101,16 @@ RtNoise::~RtNoise()
     }
 }
 
+
 //*************************************************************************************************************
 
-QVector <float> RtNoise::hanning(int N, short itype)
+void RtNoise::setExponentialAveraging(double dAlpha)
 {
-    int half, i, idx, n;
-    QVector <float> w(N,0.0);
-
-    if(itype==1)    //periodic function
-        n = N-1;
-    else
-        n = N;
-
-    if(n%2==0)
-    {
-        half = n/2;
-        for(i=0; i<half; i++) //CALC_HANNING   Calculates Hanning window samples.
-            w[i] = 0.5 * (1 - cos(2*3.14159265*(i+1) / (n+1)));
-
-        idx = half-1;
-        for(i=half; i<n; i++) {
-            w[i] = w[idx];
-            idx--;
-        }
-    }
-    else
-    {
-        half = (n+1)/2;
-        for(i=0; i<half; i++) //CALC_HANNING   Calculates Hanning window samples.
-            w[i] = 0.5 * (1 - cos(23.14159265*(i+1) / (n+1)));
-
-        idx = half-2;
-        for(i=half; i<n; i++) {
-            w[i] = w[idx];
-            idx--;
-        }
-    }
-
-    if(itype==1)    //periodic function
-    {
-        for(i=N-1; i>=1; i--)
-            w[i] = w[i-1];
-        w[0] = 0.0;
-    }
-    return(w);
+    QMutexLocker locker(&mutex);
+    m_dAlpha = dAlpha;
 }
 
+
 //*************************************************************************************************************
 
 void RtNoise::append(const MatrixXd &p_DataSegment)
@@ -208,105 +167,39 @@ void RtNoise::run()
             MatrixXd block = m_pRawMatrixBuffer->pop();
 
             if(FirstStart){
-                //init the circ buffer and parameters
+                //init the parameters and the Welch estimator
                 if(m_dataLength < 0) m_dataLength = 10;
                 m_iNumOfBlocks = m_dataLength;//60;
                 m_iBlockSize =  block.cols();
                 m_iSensors =  block.rows();
 
-                m_matCircBuf.resize(m_iSensors,m_iNumOfBlocks*m_iBlockSize);
+                m_pWelchPsd = WelchPsd::SPtr(new WelchPsd(m_iFFTlength, m_Fs, 0.5));
 
                 m_iBlockIndex = 0;
                 FirstStart = false;
             }
-            //concate blocks
-            for (int i=0; i< m_iSensors; i++)
-                for (int j=0; j< m_iBlockSize; j++)
-                    m_matCircBuf(i,j+m_iBlockIndex*m_iBlockSize) = block(i,j);
-
 
-            m_iBlockIndex ++;
-            if (m_iBlockIndex >= m_iNumOfBlocks){
+            mutex.lock();
+            m_pWelchPsd->setExponentialAveraging(m_dAlpha);
+            mutex.unlock();
 
-                //m_pRawMatrixBuffer.clear(); //empty the buffer
+            //Segments are windowed and transformed as soon as they are complete
+            m_pWelchPsd->append(block);
 
-                m_bSendDataToBuffer = false;
-                //stop collect block and start to calculate the spectrum
+            m_iBlockIndex ++;
+            if (m_iBlockIndex >= m_iNumOfBlocks && m_pWelchPsd->segmentCount() > 0){
                 m_iBlockIndex = 0;
 
-                MatrixXd sum_psdx = MatrixXd::Zero(m_iSensors,m_iFFTlength/2+1);
-
-                int nb = floor(m_iNumOfBlocks*m_iBlockSize/m_iFFTlength)+1;
-                qDebug()<<"nb"<<nb<<"NumOfBlocks"<<m_iNumOfBlocks<<"BlockSize"<<m_iBlockSize;
-                MatrixXd t_mat(m_iSensors,m_iFFTlength);
-                MatrixXd t_psdx(m_iSensors,m_iFFTlength/2+1);
-                for (int n = 0; n<nb; n++){
-                    //collect a data block with data length of m_iFFTlength;
-                    if(n==nb-1)
-                    {
-                        for(qint32 ii=0; ii<m_iSensors; ii++)
-                        for(qint32 jj=0; jj<m_iFFTlength; jj++)
-                            if(jj+n*m_iFFTlength<m_iNumOfBlocks*m_iBlockSize)
-                                t_mat(ii,jj) = m_matCircBuf(ii,jj+n*m_iFFTlength);
-                            else
-                                t_mat(ii,jj) = 0.0;
-
-                    }
-                    else
-                    {
-                        for(qint32 ii=0; ii<m_iSensors; ii++)
-                        for(qint32 jj=0; jj<m_iFFTlength; jj++)
-                            t_mat(ii,jj) = m_matCircBuf(ii,jj+n*m_iFFTlength);
-                    }
-
-                    //FFT calculation by row
-                    for(qint32 i = 0; i < t_mat.rows(); i++){
-                        RowVectorXd data;
-
-                        data = t_mat.row(i);
-
-                        //zero-pad data to m_iFFTlength
-                        RowVectorXd t_dataZeroPad = RowVectorXd::Zero(m_iFFTlength);
-                        t_dataZeroPad.head(data.cols()) = data;
-
-                        for (qint32 lk = 0; lk<m_iFFTlength; lk++)
-                            t_dataZeroPad[lk] = t_dataZeroPad[lk]*m_fWin[lk];
-
-                        //generate fft object
-                        Eigen::FFT<double> fft;
-                        fft.SetFlag(fft.HalfSpectrum);
-
-                        //fft-transform data sequence
-                        RowVectorXcd t_freqData(m_iFFTlength/2+1);
-                        fft.fwd(t_freqData,t_dataZeroPad);
-
-                        // calculate spectrum from FFT
-                        for(qint32 j=0; j<m_iFFTlength/2+1;j++)
-                        {
-                            double mag_abs = sqrt(t_freqData(j).real()* t_freqData(j).real() +  t_freqData(j).imag()*t_freqData(j).imag());
-                            double spower = (1.0/(m_Fs*m_iFFTlength))* mag_abs;
-                            if (j>0&&j<m_iFFTlength/2) spower = 2.0*spower;
-                            sum_psdx(i,j) = sum_psdx(i,j) + spower;
-                        }
-                     }//row computing is done
-                }//nb
-
                 //DB-calculation
-                for(qint32 ii=0; ii<m_iSensors; ii++)
-                    for(qint32 jj=0; jj<m_iFFTlength/2+1; jj++)
-                        t_psdx(ii,jj) = 10.0*log10(sum_psdx(ii,jj)/nb);
+                MatrixXd t_psdx = 10.0 * m_pWelchPsd->psd().array().max(std::numeric_limits<double>::min()).log10();
 
                 qDebug()<<"Send spectrum to Noise Estimator";
                 emit SpecCalculated(t_psdx); //send back the spectrum result
-                if(m_pRawMatrixBuffer->size()>0)
-                    m_pRawMatrixBuffer->clear();
 
-                m_bSendDataToBuffer = true;
+                if(m_dAlpha <= 0.0) {
+                    m_pWelchPsd->reset();
+                }
             }
-
         }
-
     }
-
 }
-
@@ -60,6 +60,7 @@
 //=============================================================================================================
 
 #include <utils/generics/circularmatrixbuffer.h>
+#include <utils/welchpsd.h>
 
 
 //*************************************************************************************************************
@@ -79,7 +80,6 @@
 //=============================================================================================================
 
 #include <Eigen/Core>
-#include <unsupported/Eigen/FFT>
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -98,6 +98,7 @@ namespace REALTIMELIB
 using namespace Eigen;
 using namespace IOBUFFER;
 using namespace FIFFLIB;
+using namespace UTILSLIB;
 
 
 //=============================================================================================================
@@ -117,8 +118,9 @@ public:
     /**
     * Creates the real-time covariance estimation object.
     *
-    * @param[in] p_iMaxSamples      Number of samples to use for each data chunk
+    * @param[in] p_iMaxSamples      FFT length, i.e. number of samples of each Welch segment
     * @param[in] p_pFiffInfo        Associated Fiff Information
+    * @param[in] p_dataLen          Number of blocks between two emitted spectra
     * @param[in] parent     Parent QObject (optional)
     */
     explicit RtNoise(qint32 p_iMaxSamples, FiffInfo::SPtr p_pFiffInfo, qint32 p_dataLen, QObject *parent = 0);
@@ -145,6 +147,14 @@ public:
     */
     inline bool isRunning();
 
+    //=========================================================================================================
+    /**
+    * Sets the exponential averaging of the spectrum. With 0 (default) each emitted spectrum is the linear
+    * average of the segments since the last emission, otherwise the average runs on with the given weight.
+    *
+    * @param[in] dAlpha     weight of the newest segment (0, 1], 0 for linear averaging
+    */
+    void setExponentialAveraging(double dAlpha);
 
     //=========================================================================================================
     /**
@@ -180,8 +190,6 @@ protected:
     */
     virtual void run();
 
-    QVector <float> hanning(int N, short itype);
-
 private:
     QMutex      mutex;                  /**< Provides access serialization between threads*/
 
@@ -191,9 +199,10 @@ private:
 
     CircularMatrixBuffer<double>::SPtr m_pRawMatrixBuffer;   /**< The Circular Raw Matrix Buffer. */
 
-    QVector <float> m_fWin;
+    WelchPsd::SPtr m_pWelchPsd;         /**< The streaming Welch estimator. */
 
     double m_Fs;
+    double m_dAlpha;                    /**< Exponential averaging weight, 0 for linear averaging. */
 
     qint32 m_iFFTlength;
     qint32 m_dataLength;
@@ -204,8 +213,6 @@ protected:
     int m_iSensors;
     int m_iBlockIndex;
 
-    MatrixXd m_matCircBuf;
-
 public:
     MatrixXd m_matSpecData;
     QMutex ReadMutex;
@@ -67,6 +67,104 @@ using namespace Eigen;
 using namespace UTILSLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+/**
+* The number of samples which are gathered and checked at once. A chunk of all trigger channels fits into L1.
+*/
+static const int s_iChunkSize = 64;
+
+//=============================================================================================================
+
+static void appendEvent(QVector<TriggerEvent>& vecEvents, int& iCount, int iChannel, int iSample, double dValue)
+{
+    if(iCount >= vecEvents.size()) {
+        vecEvents.resize(qMax(64, 2 * vecEvents.size()));
+    }
+
+    TriggerEvent& event = vecEvents[iCount++];
+    event.iChannel = iChannel;
+    event.iSample = iSample;
+    event.dValue = dValue;
+}
+
+//=============================================================================================================
+
+/**
+* A run of trigger channels which are adjacent rows in the data matrix, e.g. the STI channels of a MEG system.
+*/
+struct TriggerRowRun {
+    int iSrcRow;        /**< The first row of the run in the data matrix. */
+    int iDstRow;        /**< The first row of the run in the gathered chunk. */
+    int iLength;        /**< The number of rows of the run. */
+};
+
+//=============================================================================================================
+
+static QVector<TriggerRowRun> triggerRowRuns(const MatrixXd& data, const QList<int>& lTriggerChannels)
+{
+    //Invalid channels are not part of any run and are read as a constant zero row
+    QVector<TriggerRowRun> vecRuns;
+
+    for(int i = 0; i < lTriggerChannels.size(); ++i) {
+        int iChIdx = lTriggerChannels.at(i);
+
+        if(iChIdx < 0 || iChIdx >= data.rows()) {
+            continue;
+        }
+
+        if(!vecRuns.isEmpty()) {
+            TriggerRowRun& lastRun = vecRuns.last();
+
+            if(lastRun.iSrcRow + lastRun.iLength == iChIdx && lastRun.iDstRow + lastRun.iLength == i) {
+                ++lastRun.iLength;
+                continue;
+            }
+        }
+
+        TriggerRowRun run;
+        run.iSrcRow = iChIdx;
+        run.iDstRow = i;
+        run.iLength = 1;
+        vecRuns.append(run);
+    }
+
+    return vecRuns;
+}
+
+//=============================================================================================================
+
+static void gatherChunk(const MatrixXd& data, const QVector<TriggerRowRun>& vecRuns, int iStart, int iChunk, MatrixXd& matChunk)
+{
+    //Walk the column major data once for all channels and copy whole runs, this touches every cache line only once
+    for(int j = 0; j < iChunk; ++j) {
+        const double* pCol = data.data() + static_cast<std::ptrdiff_t>(iStart + j) * data.rows();
+
+        for(int r = 0; r < vecRuns.size(); ++r) {
+            const TriggerRowRun& run = vecRuns.at(r);
+            matChunk.col(j).segment(run.iDstRow, run.iLength) = Map<const VectorXd>(pCol + run.iSrcRow, run.iLength);
+        }
+    }
+}
+
+//=============================================================================================================
+
+static VectorXd initialSamples(const MatrixXd& data, const QVector<TriggerRowRun>& vecRuns, int iNumChannels, VectorXd* pVecLastSamples)
+{
+    //Without a previous block the first sample can not be a flank
+    if(pVecLastSamples && pVecLastSamples->size() == iNumChannels) {
+        return *pVecLastSamples;
+    }
+
+    MatrixXd matFirst = MatrixXd::Zero(iNumChannels, 1);
+    gatherChunk(data, vecRuns, 0, 1, matFirst);
+
+    return matFirst.col(0);
+}
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -167,6 +265,153 @@ QList<QPair<int,double> > DetectTrigger::detectTriggerFlanksMax(const MatrixXd &
 }
 
 
+//*************************************************************************************************************
+
+int DetectTrigger::detectTriggerEdges(const MatrixXd &data, const QList<int>& lTriggerChannels, int iOffsetIndex, double dThreshold, bool bRising, QVector<TriggerEvent>& vecEvents, VectorXd* pVecLastSamples, int iBurstLengthSamp, bool bRemoveOffset, VectorXi* pVecBlockedSamples)
+{
+    int iCount = 0;
+    const int iNumSamples = data.cols();
+    const int iNumChannels = lTriggerChannels.size();
+
+    if(iNumSamples == 0 || iNumChannels == 0) {
+        return iCount;
+    }
+
+    QVector<TriggerRowRun> vecRuns = triggerRowRuns(data, lTriggerChannels);
+    VectorXd vecPrev = initialSamples(data, vecRuns, iNumChannels, pVecLastSamples);
+
+    //Per channel threshold, raised by the baseline of the channel if the offset is removed
+    VectorXd vecThreshold = VectorXd::Constant(iNumChannels, dThreshold);
+    VectorXd vecBaseline = vecPrev;
+
+    //First sample at which each channel may fire again after a burst, continued from the previous block
+    VectorXi vecBlockedUntil = VectorXi::Zero(iNumChannels);
+
+    if(pVecBlockedSamples && pVecBlockedSamples->size() == iNumChannels) {
+        vecBlockedUntil = *pVecBlockedSamples;
+    }
+
+    MatrixXd matChunk = MatrixXd::Zero(iNumChannels, s_iChunkSize);
+    VectorXd vecMin(iNumChannels), vecMax(iNumChannels);
+    VectorXi vecActive(iNumChannels);
+
+    for(int iStart = 0; iStart < iNumSamples; iStart += s_iChunkSize) {
+        int iChunk = qMin(s_iChunkSize, iNumSamples - iStart);
+        gatherChunk(data, vecRuns, iStart, iChunk, matChunk);
+
+        //A flank in either direction requires the chunk and its predecessor to lie on both sides of the threshold.
+        //The row wise reductions run over the column major chunk and are vectorized across all channels.
+        vecMin.noalias() = matChunk.leftCols(iChunk).rowwise().minCoeff().cwiseMin(vecPrev);
+        vecMax.noalias() = matChunk.leftCols(iChunk).rowwise().maxCoeff().cwiseMax(vecPrev);
+
+        //The baseline is the running minimum, taken from the chunk minima instead of an extra pass over the block
+        if(bRemoveOffset) {
+            vecBaseline = vecBaseline.cwiseMin(vecMin);
+            vecThreshold = vecBaseline.array() + dThreshold;
+        }
+
+        int iNumActive = 0;
+        for(int i = 0; i < iNumChannels; ++i) {
+            if(vecMin(i) < vecThreshold(i) && vecMax(i) >= vecThreshold(i)) {
+                vecActive(iNumActive++) = i;
+            }
+        }
+
+        //Walk the crossing channels sample by sample so the events come out ordered by sample
+        for(int j = 0; j < iChunk && iNumActive > 0; ++j) {
+            for(int k = 0; k < iNumActive; ++k) {
+                int i = vecActive(k);
+                double dPrev = j > 0 ? matChunk(i, j - 1) : vecPrev(i);
+                double dCur = matChunk(i, j);
+
+                bool bFlank = bRising ? (dPrev < vecThreshold(i) && dCur >= vecThreshold(i))
+                                      : (dPrev >= vecThreshold(i) && dCur < vecThreshold(i));
+
+                if(bFlank && iStart + j >= vecBlockedUntil(i)) {
+                    appendEvent(vecEvents, iCount, lTriggerChannels.at(i), iOffsetIndex + iStart + j, dCur);
+
+                    if(iBurstLengthSamp > 0) {
+                        vecBlockedUntil(i) = iStart + j + iBurstLengthSamp + 1;
+                    }
+                }
+            }
+        }
+
+        vecPrev = matChunk.col(iChunk - 1);
+    }
+
+    if(pVecLastSamples) {
+        *pVecLastSamples = vecPrev;
+    }
+
+    if(pVecBlockedSamples) {
+        *pVecBlockedSamples = (vecBlockedUntil.array() - iNumSamples).cwiseMax(0).matrix();
+    }
+
+    return iCount;
+}
+
+
+//*************************************************************************************************************
+
+int DetectTrigger::detectDigitalTriggers(const MatrixXd &data, const QList<int>& lTriggerChannels, int iOffsetIndex, quint32 uMask, QVector<TriggerEvent>& vecEvents, VectorXd* pVecLastSamples)
+{
+    int iCount = 0;
+    const int iNumSamples = data.cols();
+    const int iNumChannels = lTriggerChannels.size();
+
+    if(iNumSamples == 0 || iNumChannels == 0) {
+        return iCount;
+    }
+
+    QVector<TriggerRowRun> vecRuns = triggerRowRuns(data, lTriggerChannels);
+    VectorXd vecPrev = initialSamples(data, vecRuns, iNumChannels, pVecLastSamples);
+
+    MatrixXd matChunk = MatrixXd::Zero(iNumChannels, s_iChunkSize);
+    VectorXd vecMin(iNumChannels), vecMax(iNumChannels);
+    VectorXi vecActive(iNumChannels);
+
+    for(int iStart = 0; iStart < iNumSamples; iStart += s_iChunkSize) {
+        int iChunk = qMin(s_iChunkSize, iNumSamples - iStart);
+        gatherChunk(data, vecRuns, iStart, iChunk, matChunk);
+
+        //The code can only change if the chunk and its predecessor are not constant
+        vecMin.noalias() = matChunk.leftCols(iChunk).rowwise().minCoeff().cwiseMin(vecPrev);
+        vecMax.noalias() = matChunk.leftCols(iChunk).rowwise().maxCoeff().cwiseMax(vecPrev);
+
+        int iNumActive = 0;
+        for(int i = 0; i < iNumChannels; ++i) {
+            if(vecMin(i) != vecMax(i)) {
+                vecActive(iNumActive++) = i;
+            }
+        }
+
+        for(int j = 0; j < iChunk && iNumActive > 0; ++j) {
+            for(int k = 0; k < iNumActive; ++k) {
+                int i = vecActive(k);
+                double dPrev = j > 0 ? matChunk(i, j - 1) : vecPrev(i);
+
+                quint32 uLastCode = static_cast<quint32>(qRound(dPrev)) & uMask;
+                quint32 uCode = static_cast<quint32>(qRound(matChunk(i, j))) & uMask;
+
+                if(uCode != uLastCode && uCode != 0) {
+                    appendEvent(vecEvents, iCount, lTriggerChannels.at(i), iOffsetIndex + iStart + j, uCode);
+                }
+            }
+        }
+
+        vecPrev = matChunk.col(iChunk - 1);
+    }
+
+    if(pVecLastSamples) {
+        *pVecLastSamples = vecPrev;
+    }
+
+    return iCount;
+}
+
+
+
 //*************************************************************************************************************
 
 QMap<int,QList<QPair<int,double> > > DetectTrigger::detectTriggerFlanksGrad(const MatrixXd& data, const QList<int>& lTriggerChannels, int iOffsetIndex, double dThreshold, bool bRemoveOffset, const QString& type, int iBurstLengthSamp)
@@ -50,6 +50,7 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -82,6 +83,17 @@ using namespace Eigen;
 //=============================================================================================================
 
 
+//=============================================================================================================
+/**
+* A trigger flank as found by DetectTrigger::detectTriggerEdges and DetectTrigger::detectDigitalTriggers.
+*/
+struct TriggerEvent {
+    int     iChannel;       /**< The row of the trigger channel in the data matrix. */
+    int     iSample;        /**< The sample index of the flank, including the offset index. */
+    double  dValue;         /**< The signal value at the flank, or the decoded code for digital triggers. */
+};
+
+
 //=============================================================================================================
 /**
 * Routines for detecting trigger flanks in a given signal
@@ -162,6 +174,54 @@ public:
     * @param return     This list holds the found trigger indices and corresponding signal values.
     */
     static QList<QPair<int,double> > detectTriggerFlanksGrad(const MatrixXd &data, int iTriggerChannelIdx, int iOffsetIndex, double dThreshold, bool bRemoveOffset, const QString& type, int iBurstLengthSamp = 100);
+
+    //=========================================================================================================
+    /**
+    * detectTriggerEdges detects threshold crossings of all given trigger channels in one pass over the data.
+    * The trigger rows are gathered in short chunks, whose minimum and maximum are computed for all channels at
+    * once with vectorized reductions. Only channels which actually cross the threshold within a chunk are walked
+    * sample by sample. Since trigger channels are idle most of the time, this is much faster than
+    * detectTriggerFlanksMax and detectTriggerFlanksGrad on long or high-rate blocks.
+    *
+    * @param[in]        data  the data used to find the trigger flanks
+    * @param[in]        lTriggerChannels  The indeces of the trigger channels
+    * @param[in]        iOffsetIndex  the offset index gets added to the found trigger flank index
+    * @param[in]        dThreshold  the signal threshold value used to find the trigger flank
+    * @param[in]        bRising  detect rising (true) or falling (false) flanks
+    * @param[out]       vecEvents  The found flanks, ordered by sample. The vector is only grown, never
+    *                              shrunk, so it can be reused across blocks without allocations.
+    * @param[in,out]    pVecLastSamples  The last sample of each trigger channel of the previous block, which is
+    *                                    updated for the next block. Pass it to find flanks at block borders.
+    * @param[in]        iBurstLengthSamp  The length in samples which is skipped after a trigger was found
+    * @param[in]        bRemoveOffset  remove the baseline of each channel, i.e. the minimum of the last sample of the
+    *                                  previous block and the block up to the current chunk, before the threshold
+    *                                  is applied
+    * @param[in,out]    pVecBlockedSamples  The number of samples of each trigger channel at the start of the next block,
+    *                                       which still lie within the burst length of a previous flank. Pass it to
+    *                                       carry the burst length across block borders.
+    *
+    * @param return     The number of found flanks, i.e. the number of valid entries in vecEvents.
+    */
+    static int detectTriggerEdges(const MatrixXd &data, const QList<int>& lTriggerChannels, int iOffsetIndex, double dThreshold, bool bRising, QVector<TriggerEvent>& vecEvents, VectorXd* pVecLastSamples = Q_NULLPTR, int iBurstLengthSamp = 0, bool bRemoveOffset = false, VectorXi* pVecBlockedSamples = Q_NULLPTR);
+
+    //=========================================================================================================
+    /**
+    * detectDigitalTriggers decodes digital trigger channels, e.g. a composite stim channel. An event is
+    * reported whenever the masked code changes to a non zero value. Chunks with a constant value are skipped
+    * with vectorized reductions as in detectTriggerEdges.
+    *
+    * @param[in]        data  the data used to find the triggers
+    * @param[in]        lTriggerChannels  The indeces of the trigger channels
+    * @param[in]        iOffsetIndex  the offset index gets added to the found trigger index
+    * @param[in]        uMask  the bits of the trigger code which are considered
+    * @param[out]       vecEvents  The found triggers with the masked code as value, ordered by sample.
+    *                              The vector is only grown, never shrunk.
+    * @param[in,out]    pVecLastSamples  The last sample of each trigger channel of the previous block, which is
+    *                                    updated for the next block.
+    *
+    * @param return     The number of found triggers, i.e. the number of valid entries in vecEvents.
+    */
+    static int detectDigitalTriggers(const MatrixXd &data, const QList<int>& lTriggerChannels, int iOffsetIndex, quint32 uMask, QVector<TriggerEvent>& vecEvents, VectorXd* pVecLastSamples = Q_NULLPTR);
 };
 
 //*************************************************************************************************************
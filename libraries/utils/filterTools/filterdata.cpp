@@ -46,6 +46,7 @@
 
 #include "parksmcclellan.h"
 #include "cosinefilter.h"
+#include "iirfilter.h"
 
 
 //*************************************************************************************************************
@@ -98,6 +99,7 @@ FilterData::FilterData()
 , m_sFreq(1000)
 , m_dLowpassFreq(4)
 , m_dHighpassFreq(40)
+, m_dRipple(1.0)
 {
 
 }
@@ -105,7 +107,7 @@ FilterData::FilterData()
 
 //*************************************************************************************************************
 
-FilterData::FilterData(QString unique_name, FilterType type, int order, double centerfreq, double bandwidth, double parkswidth, double sFreq, qint32 fftlength, DesignMethod designMethod)
+FilterData::FilterData(QString unique_name, FilterType type, int order, double centerfreq, double bandwidth, double parkswidth, double sFreq, qint32 fftlength, DesignMethod designMethod, double ripple)
 : m_Type(type)
 , m_iFilterOrder(order)
 , m_iFFTlength(fftlength)
@@ -115,6 +117,7 @@ FilterData::FilterData(QString unique_name, FilterType type, int order, double c
 , m_dCenterFreq(centerfreq)
 , m_dBandwidth(bandwidth)
 , m_sFreq(sFreq)
+, m_dRipple(ripple)
 {
     designFilter();
 }
@@ -124,6 +127,8 @@ FilterData::FilterData(QString unique_name, FilterType type, int order, double c
 
 void FilterData::designFilter()
 {
+    m_matSOS.resize(0,0);
+
     switch(m_designMethod) {
         case Tschebyscheff: {
             ParksMcClellan filter(m_iFilterOrder, m_dCenterFreq, m_dBandwidth, m_dParksWidth, (ParksMcClellan::TPassType)m_Type);
@@ -183,6 +188,17 @@ void FilterData::designFilter()
 
             break;
         }
+
+        case Butterworth:
+        case Chebyshev: {
+            m_matSOS = IIRFilter::designSOS(m_designMethod, m_Type, m_iFilterOrder, m_dCenterFreq, m_dBandwidth, m_dRipple);
+
+            //IIR filters have no FIR coefficients. The frequency response is still provided for plotting and frequency-domain filtering.
+            m_dCoeffA.resize(0);
+            m_dFFTCoeffA = IIRFilter::frequencyResponse(m_matSOS, m_iFFTlength);
+
+            break;
+        }
     }
 
     switch(m_Type) {
@@ -227,6 +243,9 @@ void FilterData::fftTransformCoeffs()
 
 RowVectorXd FilterData::applyConvFilter(const RowVectorXd& data, bool keepOverhead, CompensateEdgeEffects compensateEdgeEffects) const
 {
+    if(isIIR())
+        return applyIIRWithOverhead(data, keepOverhead);
+
     if(data.cols()<m_dCoeffA.cols() && compensateEdgeEffects==MirrorData){
         qDebug()<<QString("Error in FilterData: Number of filter taps(%1) bigger then data size(%2). Not enough data to perform mirroring!").arg(m_dCoeffA.cols()).arg(data.cols());
         return data;
@@ -268,6 +287,9 @@ RowVectorXd FilterData::applyConvFilter(const RowVectorXd& data, bool keepOverhe
 
 RowVectorXd FilterData::applyFFTFilter(const RowVectorXd& data, bool keepOverhead, CompensateEdgeEffects compensateEdgeEffects) const
 {
+    if(isIIR())
+        return applyIIRWithOverhead(data, keepOverhead);
+
     if(data.cols()<m_dCoeffA.cols() && compensateEdgeEffects==MirrorData) {
         qDebug()<<QString("Error in FilterData: Number of filter taps(%1) bigger then data size(%2). Not enough data to perform mirroring!").arg(m_dCoeffA.cols()).arg(data.cols());
         return data;
@@ -323,6 +345,47 @@ RowVectorXd FilterData::applyFFTFilter(const RowVectorXd& data, bool keepOverhea
 }
 
 
+//*************************************************************************************************************
+
+RowVectorXd FilterData::applyIIRFilter(const RowVectorXd& data, bool zeroPhase) const
+{
+    if(zeroPhase)
+        return IIRFilter::filterZeroPhase(m_matSOS, data);
+
+    IIRFilter filter(m_matSOS);
+    MatrixXd matFiltered;
+    filter.filter(data, matFiltered);
+
+    return matFiltered;
+}
+
+
+//*************************************************************************************************************
+
+bool FilterData::isIIR() const
+{
+    return m_matSOS.rows() > 0;
+}
+
+
+//*************************************************************************************************************
+
+RowVectorXd FilterData::applyIIRWithOverhead(const RowVectorXd& data, bool keepOverhead) const
+{
+    RowVectorXd t_filtered = applyIIRFilter(data, true);
+
+    if(!keepOverhead)
+        return t_filtered;
+
+    //Callers of the FIR versions expect the result of a linear phase filter with m_iFilterOrder taps, i.e. the data
+    //delayed by half the order followed by the overhead. The zero-phase result is placed accordingly.
+    RowVectorXd t_result = RowVectorXd::Zero(data.cols() + m_iFilterOrder);
+    t_result.segment(m_iFilterOrder/2, data.cols()) = t_filtered;
+
+    return t_result;
+}
+
+
 //*************************************************************************************************************
 
 QString FilterData::getStringForDesignMethod(const FilterData::DesignMethod &designMethod)
@@ -338,6 +401,12 @@ QString FilterData::getStringForDesignMethod(const FilterData::DesignMethod &des
     if(designMethod == FilterData::Tschebyscheff)
         designMethodString = "Tschebyscheff";
 
+    if(designMethod == FilterData::Butterworth)
+        designMethodString = "Butterworth";
+
+    if(designMethod == FilterData::Chebyshev)
+        designMethodString = "Chebyshev";
+
     return designMethodString;
 }
 
@@ -379,6 +448,12 @@ FilterData::DesignMethod FilterData::getDesignMethodForString(const QString &des
     if(designMethodString == "Cosine")
         designMethod = FilterData::Cosine;
 
+    if(designMethodString == "Butterworth")
+        designMethod = FilterData::Butterworth;
+
+    if(designMethodString == "Chebyshev")
+        designMethod = FilterData::Chebyshev;
+
     return designMethod;
 }
 
@@ -102,7 +102,9 @@ public:
     enum DesignMethod {
         Tschebyscheff,
         Cosine,
-        External
+        External,
+        Butterworth,
+        Chebyshev
     } m_designMethod;
 
     enum FilterType {
@@ -134,9 +136,10 @@ public:
     * @param [in] parkswidth determines the width of the filter slopes (steepness)
     * @param [in] sFreq sampling frequency
     * @param [in] fftlength length of the fft (multiple integer of 2^x)
-    * @param [in] designMethod specifies the design method to use. Choose between Cosind and Tschebyscheff
+    * @param [in] designMethod specifies the design method to use. Choose between Cosind and Tschebyscheff (FIR) or Butterworth and Chebyshev (IIR)
+    * @param [in] ripple the pass band ripple in dB, only used by the Chebyshev design
     */
-    FilterData(QString unique_name, FilterType type, int order, double centerfreq, double bandwidth, double parkswidth, double sFreq, qint32 fftlength=4096, DesignMethod designMethod = Cosine);
+    FilterData(QString unique_name, FilterType type, int order, double centerfreq, double bandwidth, double parkswidth, double sFreq, qint32 fftlength=4096, DesignMethod designMethod = Cosine, double ripple = 1.0);
 
     /**
      * @brief fftTransformCoeffs transforms the calculated filter coefficients to frequency-domain
@@ -169,6 +172,21 @@ public:
     */
     RowVectorXd applyFFTFilter(const RowVectorXd& data, bool keepOverhead = false, CompensateEdgeEffects compensateEdgeEffects = MirrorData) const;
 
+    /**
+    * Applies the IIR filter (Butterworth and Chebyshev designs) to the input data.
+    *
+    * @param [in] data holds the data to be filtered
+    * @param [in] zeroPhase whether to filter forward and backward (offline, no phase shift) or causally (real-time capable)
+    *
+    * @return the filtered data in form of a RowVectorXd
+    */
+    RowVectorXd applyIIRFilter(const RowVectorXd& data, bool zeroPhase = true) const;
+
+    /**
+     * @brief isIIR returns whether the filter is stored as second-order sections instead of FIR coefficients
+     */
+    bool isIIR() const;
+
     /**
      * @brief getStringForDesignMethod returns the current design method as a string
      */
@@ -206,6 +224,20 @@ public:
 
     RowVectorXcd    m_dFFTCoeffA;       /**< the FFT-transformed forward filter coefficient set, required for frequency-domain filtering, zero-padded to m_iFFTlength. */
     RowVectorXcd    m_dFFTCoeffB;       /**< the FFT-transformed backward filter coefficient set, required for frequency-domain filtering, zero-padded to m_iFFTlength. */
+
+    MatrixXd        m_matSOS;           /**< the second-order sections [b0 b1 b2 a0 a1 a2] of IIR filters, one row per section (empty if FIR filter). */
+    double          m_dRipple;          /**< the pass band ripple in dB of Chebyshev filters. */
+
+private:
+    /**
+    * Zero-phase IIR filtering with the output layout of applyConvFilter and applyFFTFilter.
+    *
+    * @param [in] data holds the data to be filtered
+    * @param [in] keepOverhead whether the result should be laid out like the overhead-keeping FIR results
+    *
+    * @return the filtered data in form of a RowVectorXd
+    */
+    RowVectorXd applyIIRWithOverhead(const RowVectorXd& data, bool keepOverhead) const;
 };
 
 //*************************************************************************************************************
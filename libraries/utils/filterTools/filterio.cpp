@@ -40,6 +40,7 @@
 //=============================================================================================================
 
 #include "filterio.h"
+#include "iirfilter.h"
 
 
 //*************************************************************************************************************
@@ -86,6 +87,7 @@ bool FilterIO::readFilter(QString path, FilterData &filter)
     //Start reading from file
     QTextStream in(&file);
     QVector<double> coefficientsTemp;
+    QVector<QVector<double> > sectionsTemp;
 
     while(!in.atEnd())
     {
@@ -134,9 +136,33 @@ bool FilterIO::readFilter(QString path, FilterData &filter)
             if(line.contains("DesignMethod") && fields.size()==2)
                 filter.m_designMethod = FilterData::getDesignMethodForString(fields.at(1));
 
+            //Read the pass band ripple of Chebyshev filters
+            if(line.contains("Ripple") && fields.size()==2)
+                filter.m_dRipple = fields.at(1).toDouble();
+
+        } else if(fields.size() == 6) { // Read second-order sections of IIR filters
+            QVector<double> section;
+            for(int i=0; i<fields.size(); i++)
+                section.push_back(fields.at(i).toDouble());
+            sectionsTemp.push_back(section);
         } else // Read filter coefficients
             coefficientsTemp.push_back(fields.join("").toDouble());
     }
+
+    if(!sectionsTemp.isEmpty()) {
+        filter.m_matSOS.resize(sectionsTemp.size(), 6);
+        for(int i=0; i<sectionsTemp.size(); i++)
+            for(int j=0; j<6; j++)
+                filter.m_matSOS(i,j) = sectionsTemp.at(i).at(j);
+
+        filter.m_dCoeffA.resize(0);
+        filter.m_dFFTCoeffA = IIRFilter::frequencyResponse(filter.m_matSOS, filter.m_iFFTlength);
+
+        file.close();
+
+        return true;
+    }
+
     // Check if reading was successful and correct
     if(filter.m_iFilterOrder != coefficientsTemp.size())
         filter.m_iFilterOrder = coefficientsTemp.size();
@@ -190,10 +216,18 @@ bool FilterIO::writeFilter(const QString &path, const FilterData &filter)
         out << "#LPFreq " << filter.m_dLowpassFreq << "\n";
         out << "#CenterFreq " << filter.m_dCenterFreq << "\n";
         out << "#DesignMethod " << FilterData::getStringForDesignMethod(filter.m_designMethod) << "\n";
+        if(filter.m_designMethod == FilterData::Chebyshev)
+            out << "#Ripple " << filter.m_dRipple << "\n";
 
         for(int i = 0 ; i<filter.m_dCoeffA.cols() ;i++)
             out << filter.m_dCoeffA(i) << "\n";
 
+        //IIR filters are stored as one line per second-order section: b0 b1 b2 a0 a1 a2
+        for(int i = 0 ; i<filter.m_matSOS.rows() ;i++) {
+            for(int j = 0 ; j<filter.m_matSOS.cols() ;j++)
+                out << qSetRealNumberPrecision(17) << filter.m_matSOS(i,j) << (j<filter.m_matSOS.cols()-1 ? " " : "\n");
+        }
+
         file.close();
 
         return true;
@@ -0,0 +1,559 @@
+//=============================================================================================================
+/**
+* @file     iirfilter.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the IIRFilter class.
+*
+*/
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "iirfilter.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+typedef std::complex<double> Complex;
+typedef std::vector<Complex> ComplexList;
+
+//Zeros, poles and gain of a filter. Continuous time during the design, discrete time after the bilinear transform.
+struct Zpk
+{
+    ComplexList zeros;
+    ComplexList poles;
+    double      gain;
+};
+
+//*************************************************************************************************************
+
+Complex product(const ComplexList& list, const Complex& offset)
+{
+    Complex prod(1.0, 0.0);
+    for(size_t i = 0; i < list.size(); ++i) {
+        prod *= offset - list[i];
+    }
+    return prod;
+}
+
+//*************************************************************************************************************
+
+Zpk analogPrototype(FilterData::DesignMethod designMethod, int iOrder, double dRipple)
+{
+    Zpk zpk;
+    zpk.gain = 1.0;
+
+    double dMu = 0.0;
+    double dEps = 1.0;
+
+    if(designMethod == FilterData::Chebyshev) {
+        dEps = std::sqrt(std::pow(10.0, 0.1 * dRipple) - 1.0);
+        dMu = std::asinh(1.0 / dEps) / iOrder;
+    }
+
+    for(int m = -iOrder + 1; m < iOrder; m += 2) {
+        double dTheta = M_PI * m / (2.0 * iOrder);
+
+        if(designMethod == FilterData::Chebyshev) {
+            zpk.poles.push_back(-std::sinh(Complex(dMu, dTheta)));
+        } else {
+            zpk.poles.push_back(-std::exp(Complex(0.0, dTheta)));
+        }
+    }
+
+    if(designMethod == FilterData::Chebyshev) {
+        zpk.gain = product(zpk.poles, Complex(0.0, 0.0)).real();
+
+        //Even orders start at the bottom of the ripple
+        if(iOrder % 2 == 0) {
+            zpk.gain /= std::sqrt(1.0 + dEps * dEps);
+        }
+    }
+
+    return zpk;
+}
+
+//*************************************************************************************************************
+
+void transformLowpass(Zpk& zpk, double dWo)
+{
+    for(size_t i = 0; i < zpk.zeros.size(); ++i) {
+        zpk.zeros[i] *= dWo;
+    }
+    for(size_t i = 0; i < zpk.poles.size(); ++i) {
+        zpk.poles[i] *= dWo;
+    }
+
+    zpk.gain *= std::pow(dWo, double(zpk.poles.size() - zpk.zeros.size()));
+}
+
+//*************************************************************************************************************
+
+void transformHighpass(Zpk& zpk, double dWo)
+{
+    size_t iDegree = zpk.poles.size() - zpk.zeros.size();
+
+    zpk.gain *= (product(zpk.zeros, Complex(0.0, 0.0)) / product(zpk.poles, Complex(0.0, 0.0))).real();
+
+    for(size_t i = 0; i < zpk.zeros.size(); ++i) {
+        zpk.zeros[i] = dWo / zpk.zeros[i];
+    }
+    for(size_t i = 0; i < zpk.poles.size(); ++i) {
+        zpk.poles[i] = dWo / zpk.poles[i];
+    }
+
+    zpk.zeros.insert(zpk.zeros.end(), iDegree, Complex(0.0, 0.0));
+}
+
+//*************************************************************************************************************
+
+ComplexList splitBand(const ComplexList& list, double dWo)
+{
+    ComplexList result;
+    result.reserve(2 * list.size());
+
+    for(size_t i = 0; i < list.size(); ++i) {
+        Complex root = std::sqrt(list[i] * list[i] - dWo * dWo);
+        result.push_back(list[i] + root);
+        result.push_back(list[i] - root);
+    }
+
+    return result;
+}
+
+//*************************************************************************************************************
+
+void transformBandpass(Zpk& zpk, double dWo, double dBw)
+{
+    size_t iDegree = zpk.poles.size() - zpk.zeros.size();
+
+    for(size_t i = 0; i < zpk.zeros.size(); ++i) {
+        zpk.zeros[i] *= dBw / 2.0;
+    }
+    for(size_t i = 0; i < zpk.poles.size(); ++i) {
+        zpk.poles[i] *= dBw / 2.0;
+    }
+
+    zpk.zeros = splitBand(zpk.zeros, dWo);
+    zpk.poles = splitBand(zpk.poles, dWo);
+    zpk.zeros.insert(zpk.zeros.end(), iDegree, Complex(0.0, 0.0));
+    zpk.gain *= std::pow(dBw, double(iDegree));
+}
+
+//*************************************************************************************************************
+
+void transformBandstop(Zpk& zpk, double dWo, double dBw)
+{
+    size_t iDegree = zpk.poles.size() - zpk.zeros.size();
+
+    zpk.gain *= (product(zpk.zeros, Complex(0.0, 0.0)) / product(zpk.poles, Complex(0.0, 0.0))).real();
+
+    for(size_t i = 0; i < zpk.zeros.size(); ++i) {
+        zpk.zeros[i] = (dBw / 2.0) / zpk.zeros[i];
+    }
+    for(size_t i = 0; i < zpk.poles.size(); ++i) {
+        zpk.poles[i] = (dBw / 2.0) / zpk.poles[i];
+    }
+
+    zpk.zeros = splitBand(zpk.zeros, dWo);
+    zpk.poles = splitBand(zpk.poles, dWo);
+    zpk.zeros.insert(zpk.zeros.end(), iDegree, Complex(0.0, dWo));
+    zpk.zeros.insert(zpk.zeros.end(), iDegree, Complex(0.0, -dWo));
+}
+
+//*************************************************************************************************************
+
+void bilinear(Zpk& zpk)
+{
+    //Sampling frequency 2, i.e. frequencies normalized to Nyquist
+    const double dFs2 = 4.0;
+    size_t iDegree = zpk.poles.size() - zpk.zeros.size();
+
+    zpk.gain *= (product(zpk.zeros, Complex(dFs2, 0.0)) / product(zpk.poles, Complex(dFs2, 0.0))).real();
+
+    for(size_t i = 0; i < zpk.zeros.size(); ++i) {
+        zpk.zeros[i] = (dFs2 + zpk.zeros[i]) / (dFs2 - zpk.zeros[i]);
+    }
+    for(size_t i = 0; i < zpk.poles.size(); ++i) {
+        zpk.poles[i] = (dFs2 + zpk.poles[i]) / (dFs2 - zpk.poles[i]);
+    }
+
+    zpk.zeros.insert(zpk.zeros.end(), iDegree, Complex(-1.0, 0.0));
+}
+
+//*************************************************************************************************************
+
+//Groups roots into conjugate pairs and pairs of real roots and returns the monic quadratic [1 c1 c2] of each group
+std::vector<Vector3d> pairRoots(const ComplexList& list)
+{
+    std::vector<Vector3d> quads;
+    std::vector<double> reals;
+
+    for(size_t i = 0; i < list.size(); ++i) {
+        if(std::abs(list[i].imag()) <= 1e-10 * std::max(1.0, std::abs(list[i]))) {
+            reals.push_back(list[i].real());
+        } else if(list[i].imag() > 0.0) {
+            quads.push_back(Vector3d(1.0, -2.0 * list[i].real(), std::norm(list[i])));
+        }
+    }
+
+    std::sort(reals.begin(), reals.end());
+
+    for(size_t i = 0; i + 1 < reals.size(); i += 2) {
+        quads.push_back(Vector3d(1.0, -(reals[i] + reals[i+1]), reals[i] * reals[i+1]));
+    }
+
+    if(reals.size() % 2 == 1) {
+        quads.push_back(Vector3d(1.0, -reals.back(), 0.0));
+    }
+
+    return quads;
+}
+
+//*************************************************************************************************************
+
+//Radius of the roots of [1 c1 c2], used to order the sections by how close their poles are to the unit circle
+double rootRadius(const Vector3d& vecQuad)
+{
+    if(vecQuad[2] == 0.0) {
+        return std::abs(vecQuad[1]);
+    }
+
+    double dDisc = vecQuad[1] * vecQuad[1] - 4.0 * vecQuad[2];
+
+    if(dDisc < 0.0) {
+        return std::sqrt(vecQuad[2]);
+    }
+
+    return (std::abs(vecQuad[1]) + std::sqrt(dDisc)) / 2.0;
+}
+
+//*************************************************************************************************************
+
+bool closerToOrigin(const Vector3d& vecQuadA, const Vector3d& vecQuadB)
+{
+    return rootRadius(vecQuadA) < rootRadius(vecQuadB);
+}
+
+//*************************************************************************************************************
+
+MatrixXd zpkToSOS(const Zpk& zpk)
+{
+    std::vector<Vector3d> poleQuads = pairRoots(zpk.poles);
+    std::vector<Vector3d> zeroQuads = pairRoots(zpk.zeros);
+
+    //Poles closest to the unit circle go last, they have the highest gain
+    std::sort(poleQuads.begin(), poleQuads.end(), closerToOrigin);
+
+    int iSections = std::max(poleQuads.size(), zeroQuads.size());
+    MatrixXd matSOS = MatrixXd::Zero(iSections, 6);
+
+    for(int i = 0; i < iSections; ++i) {
+        matSOS.row(i) << 1.0, 0.0, 0.0, 1.0, 0.0, 0.0;
+
+        if(i < int(poleQuads.size())) {
+            matSOS.block(i, 3, 1, 3) = poleQuads[i].transpose();
+
+            //Each pole pair gets the remaining zero pair closest to it
+            if(!zeroQuads.empty()) {
+                size_t iBest = 0;
+                double dBest = (zeroQuads[0] - poleQuads[i]).squaredNorm();
+                for(size_t j = 1; j < zeroQuads.size(); ++j) {
+                    double dDist = (zeroQuads[j] - poleQuads[i]).squaredNorm();
+                    if(dDist < dBest) {
+                        dBest = dDist;
+                        iBest = j;
+                    }
+                }
+                matSOS.block(i, 0, 1, 3) = zeroQuads[iBest].transpose();
+                zeroQuads.erase(zeroQuads.begin() + iBest);
+            }
+        } else if(!zeroQuads.empty()) {
+            matSOS.block(i, 0, 1, 3) = zeroQuads.back().transpose();
+            zeroQuads.pop_back();
+        }
+    }
+
+    if(iSections > 0) {
+        matSOS.block(0, 0, 1, 3) *= zpk.gain;
+    }
+
+    return matSOS;
+}
+
+} // anonymous namespace
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+IIRFilter::IIRFilter()
+{
+}
+
+
+//*************************************************************************************************************
+
+IIRFilter::IIRFilter(const MatrixXd& matSOS)
+{
+    setSections(matSOS);
+}
+
+
+//*************************************************************************************************************
+
+void IIRFilter::setSections(const MatrixXd& matSOS)
+{
+    m_matSOS = matSOS;
+    reset();
+}
+
+
+//*************************************************************************************************************
+
+void IIRFilter::filter(const MatrixXd& matDataIn, MatrixXd& matDataOut)
+{
+    matDataOut = matDataIn;
+
+    if(m_matSOS.rows() == 0 || matDataIn.cols() == 0) {
+        return;
+    }
+
+    if(m_matState.rows() != matDataIn.rows() || m_matState.cols() != 2 * m_matSOS.rows()) {
+        m_matState = MatrixXd::Zero(matDataIn.rows(), 2 * m_matSOS.rows());
+        m_vecWork.resize(matDataIn.rows());
+    }
+
+    runSections(m_matSOS, matDataOut, m_matState, m_vecWork);
+}
+
+
+//*************************************************************************************************************
+
+void IIRFilter::reset()
+{
+    m_matState.resize(0, 0);
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd IIRFilter::designSOS(FilterData::DesignMethod designMethod,
+                              FilterData::FilterType type,
+                              int iOrder,
+                              double dCenterFreq,
+                              double dBandwidth,
+                              double dRipple)
+{
+    if(designMethod != FilterData::Butterworth && designMethod != FilterData::Chebyshev) {
+        qDebug() << "IIRFilter::designSOS - Design method is not an IIR design.";
+        return MatrixXd();
+    }
+
+    double dLow = dCenterFreq;
+    double dHigh = dCenterFreq;
+
+    if(type == FilterData::BPF || type == FilterData::NOTCH) {
+        dLow = dCenterFreq - dBandwidth / 2.0;
+        dHigh = dCenterFreq + dBandwidth / 2.0;
+    }
+
+    if(iOrder < 1 || dLow <= 0.0 || dHigh >= 1.0 || dLow > dHigh || type == FilterData::UNKNOWN) {
+        qDebug() << "IIRFilter::designSOS - Invalid order or frequencies. Order:" << iOrder << "Band:" << dLow << dHigh;
+        return MatrixXd();
+    }
+
+    Zpk zpk = analogPrototype(designMethod, iOrder, dRipple);
+
+    //Pre-warp the edge frequencies so that they end up in place after the bilinear transform
+    double dWarpedLow = 4.0 * std::tan(M_PI * dLow / 2.0);
+    double dWarpedHigh = 4.0 * std::tan(M_PI * dHigh / 2.0);
+
+    switch(type) {
+        case FilterData::LPF:
+            transformLowpass(zpk, dWarpedLow);
+            break;
+
+        case FilterData::HPF:
+            transformHighpass(zpk, dWarpedLow);
+            break;
+
+        case FilterData::BPF:
+            transformBandpass(zpk, std::sqrt(dWarpedLow * dWarpedHigh), dWarpedHigh - dWarpedLow);
+            break;
+
+        case FilterData::NOTCH:
+            transformBandstop(zpk, std::sqrt(dWarpedLow * dWarpedHigh), dWarpedHigh - dWarpedLow);
+            break;
+
+        default:
+            break;
+    }
+
+    bilinear(zpk);
+
+    return zpkToSOS(zpk);
+}
+
+
+//*************************************************************************************************************
+
+RowVectorXcd IIRFilter::frequencyResponse(const MatrixXd& matSOS, int iFFTLength)
+{
+    RowVectorXcd vecResponse = RowVectorXcd::Ones(iFFTLength / 2 + 1);
+
+    for(int k = 0; k < vecResponse.cols(); ++k) {
+        Complex z1 = std::polar(1.0, -2.0 * M_PI * k / iFFTLength);
+        Complex z2 = z1 * z1;
+
+        for(int s = 0; s < matSOS.rows(); ++s) {
+            vecResponse[k] *= (matSOS(s,0) + matSOS(s,1) * z1 + matSOS(s,2) * z2)
+                              / (matSOS(s,3) + matSOS(s,4) * z1 + matSOS(s,5) * z2);
+        }
+    }
+
+    return vecResponse;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd IIRFilter::filterZeroPhase(const MatrixXd& matSOSIn, const MatrixXd& matData)
+{
+    if(matSOSIn.rows() == 0 || matData.cols() < 2) {
+        return matData;
+    }
+
+    //The steady state below assumes a0 = 1
+    MatrixXd matSOS = matSOSIn.array().colwise() / matSOSIn.col(3).array();
+
+    int iSections = matSOS.rows();
+
+    //Edge extension as used by common filtfilt implementations, shorter for first order sections
+    int iTaps = 2 * iSections + 1;
+    int iFirstOrder = std::min((matSOS.col(2).array() == 0.0).count(), (matSOS.col(5).array() == 0.0).count());
+    int iPad = std::min(3 * (iTaps - iFirstOrder), int(matData.cols()) - 1);
+    int iCols = matData.cols();
+
+    //Odd reflection around the first and last sample keeps value and slope continuous at the edges
+    MatrixXd matExt(matData.rows(), iCols + 2 * iPad);
+    matExt.block(0, iPad, matData.rows(), iCols) = matData;
+    for(int i = 0; i < iPad; ++i) {
+        matExt.col(iPad - 1 - i) = 2.0 * matData.col(0) - matData.col(i + 1);
+        matExt.col(iPad + iCols + i) = 2.0 * matData.col(iCols - 1) - matData.col(iCols - 2 - i);
+    }
+
+    //Steady state of every section for a unit step at the input of the cascade
+    RowVectorXd vecZi(2 * iSections);
+    double dScale = 1.0;
+    for(int s = 0; s < iSections; ++s) {
+        double dGain = matSOS.row(s).head(3).sum() / matSOS.row(s).tail(3).sum();
+        vecZi[2*s] = dScale * (dGain - matSOS(s,0));
+        vecZi[2*s+1] = dScale * (matSOS(s,2) - matSOS(s,5) * dGain);
+        dScale *= dGain;
+    }
+
+    ArrayXd vecWork(matData.rows());
+
+    //Forward pass
+    MatrixXd matState = matExt.col(0) * vecZi;
+    runSections(matSOS, matExt, matState, vecWork);
+
+    //Backward pass
+    matExt.rowwise().reverseInPlace();
+    matState = matExt.col(0) * vecZi;
+    runSections(matSOS, matExt, matState, vecWork);
+    matExt.rowwise().reverseInPlace();
+
+    return matExt.block(0, iPad, matData.rows(), iCols);
+}
+
+
+//*************************************************************************************************************
+
+void IIRFilter::runSections(const MatrixXd& matSOS, MatrixXd& matData, MatrixXd& matState, ArrayXd& vecWork)
+{
+    //Transposed direct form II. All channels of one sample are updated at once and one section is run over the
+    //whole block before the next, which keeps the state of the section in cache.
+    for(int s = 0; s < matSOS.rows(); ++s) {
+        const double b0 = matSOS(s,0) / matSOS(s,3);
+        const double b1 = matSOS(s,1) / matSOS(s,3);
+        const double b2 = matSOS(s,2) / matSOS(s,3);
+        const double a1 = matSOS(s,4) / matSOS(s,3);
+        const double a2 = matSOS(s,5) / matSOS(s,3);
+
+        MatrixXd::ColXpr z1 = matState.col(2*s);
+        MatrixXd::ColXpr z2 = matState.col(2*s+1);
+
+        for(int t = 0; t < matData.cols(); ++t) {
+            MatrixXd::ColXpr x = matData.col(t);
+
+            vecWork = b0 * x.array() + z1.array();
+            z1.array() = b1 * x.array() - a1 * vecWork + z2.array();
+            z2.array() = b2 * x.array() - a2 * vecWork;
+            x.array() = vecWork;
+        }
+    }
+}
@@ -0,0 +1,230 @@
+//=============================================================================================================
+/**
+* @file     iirfilter.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the IIRFilter class.
+*
+*/
+#ifndef IIRFILTER_H
+#define IIRFILTER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../utils_global.h"
+#include "filterdata.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//=============================================================================================================
+/**
+* Butterworth and Chebyshev type I filters stored as a cascade of second-order sections (biquads). Each row of
+* a section matrix holds [b0 b1 b2 a0 a1 a2] with a0 = 1. The design follows the analog prototype, frequency
+* transformation and bilinear transform route; frequencies are normalized to the Nyquist frequency as in
+* FilterData.
+*
+* An instance filters a continuous multi-channel stream causally and keeps the section states between blocks.
+* The kernel runs section by section over the samples and updates all channels of a sample at once, so the
+* inner loop is a vectorized operation on contiguous channel columns.
+*
+* @brief Second-order-section IIR filter design and filtering
+*/
+class UTILSSHARED_EXPORT IIRFilter
+{
+
+public:
+    typedef QSharedPointer<IIRFilter> SPtr;            /**< Shared pointer type for IIRFilter. */
+    typedef QSharedPointer<const IIRFilter> ConstSPtr; /**< Const shared pointer type for IIRFilter. */
+
+    //=========================================================================================================
+    /**
+    * Constructs an IIRFilter without sections, which passes the data through unchanged.
+    */
+    IIRFilter();
+
+    //=========================================================================================================
+    /**
+    * Constructs an IIRFilter.
+    *
+    * @param [in] matSOS    The second-order sections, one [b0 b1 b2 a0 a1 a2] row per section.
+    */
+    explicit IIRFilter(const MatrixXd& matSOS);
+
+    //=========================================================================================================
+    /**
+    * Sets new second-order sections and clears the carried over state.
+    *
+    * @param [in] matSOS    The second-order sections, one [b0 b1 b2 a0 a1 a2] row per section.
+    */
+    void setSections(const MatrixXd& matSOS);
+
+    //=========================================================================================================
+    /**
+    * Returns the current second-order sections.
+    *
+    * @return the sections.
+    */
+    inline const MatrixXd& sections() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of second-order sections.
+    *
+    * @return the number of sections.
+    */
+    inline qint32 sectionCount() const;
+
+    //=========================================================================================================
+    /**
+    * Filters the next block of a continuous multi-channel stream causally. The number of rows must not change
+    * between calls unless reset() is called in between.
+    *
+    * @param [in] matDataIn     The data block, channels x samples.
+    * @param [out] matDataOut   The filtered block, resized to the dimensions of matDataIn if necessary.
+    */
+    void filter(const MatrixXd& matDataIn, MatrixXd& matDataOut);
+
+    //=========================================================================================================
+    /**
+    * Clears the carried over state, i.e. the next block is treated as the start of a new stream.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Designs a Butterworth or Chebyshev type I filter. For band pass and notch filters the resulting order is
+    * twice the prototype order.
+    *
+    * @param [in] designMethod  FilterData::Butterworth or FilterData::Chebyshev.
+    * @param [in] type          The filter type: LPF, HPF, BPF or NOTCH.
+    * @param [in] iOrder        The order of the low pass prototype.
+    * @param [in] dCenterFreq   The cut off (LPF, HPF) or center frequency (BPF, NOTCH), normalized to Nyquist.
+    * @param [in] dBandwidth    The width of the pass or stop band (BPF, NOTCH), normalized to Nyquist.
+    * @param [in] dRipple       The pass band ripple in dB (Chebyshev only).
+    *
+    * @return the second-order sections, empty if the parameters are not valid.
+    */
+    static MatrixXd designSOS(FilterData::DesignMethod designMethod,
+                              FilterData::FilterType type,
+                              int iOrder,
+                              double dCenterFreq,
+                              double dBandwidth,
+                              double dRipple = 1.0);
+
+    //=========================================================================================================
+    /**
+    * Evaluates the frequency response of second-order sections in the layout of FilterData::m_dFFTCoeffA.
+    *
+    * @param [in] matSOS        The second-order sections.
+    * @param [in] iFFTLength    The FFT length.
+    *
+    * @return the complex response at the iFFTLength/2+1 non-negative FFT frequencies.
+    */
+    static RowVectorXcd frequencyResponse(const MatrixXd& matSOS, int iFFTLength);
+
+    //=========================================================================================================
+    /**
+    * Filters the rows of the data forward and backward, which squares the magnitude response and cancels the
+    * phase. The edges are extended by odd reflection and the states start at their steady state values to keep
+    * transients small.
+    *
+    * @param [in] matSOS    The second-order sections.
+    * @param [in] matData   The data, channels x samples.
+    *
+    * @return the zero-phase filtered data.
+    */
+    static MatrixXd filterZeroPhase(const MatrixXd& matSOS, const MatrixXd& matData);
+
+private:
+    //=========================================================================================================
+    /**
+    * Runs the sections over the data in place.
+    *
+    * @param [in] matSOS        The second-order sections.
+    * @param [in, out] matData  The data, channels x samples.
+    * @param [in, out] matState The section states, channels x (2 * sections).
+    * @param [in, out] vecWork  Work buffer with one entry per channel.
+    */
+    static void runSections(const MatrixXd& matSOS, MatrixXd& matData, MatrixXd& matState, ArrayXd& vecWork);
+
+    MatrixXd    m_matSOS;       /**< The second-order sections. */
+    MatrixXd    m_matState;     /**< The two delay elements of every section, channels x (2 * sections). */
+    ArrayXd     m_vecWork;      /**< Work buffer with one entry per channel. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline const MatrixXd& IIRFilter::sections() const
+{
+    return m_matSOS;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 IIRFilter::sectionCount() const
+{
+    return m_matSOS.rows();
+}
+
+} // NAMESPACE UTILSLIB
+
+#endif // IIRFILTER_H
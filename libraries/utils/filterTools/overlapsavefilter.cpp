@@ -0,0 +1,324 @@
+//=============================================================================================================
+/**
+* @file     overlapsavefilter.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    OverlapSaveFilter class definition.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "overlapsavefilter.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent/QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <unsupported/Eigen/FFT>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define OVERLAPSAVE_CHUNK_ROWS  32      /**< Channels per concurrently processed block, must be even. */
+#define OVERLAPSAVE_MIN_FFT     64      /**< Smallest FFT length used. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+/**
+* Work buffers and FFT plan of one block of channels.
+*/
+struct OverlapSaveWorkspace
+{
+    int                     iRow;           /**< First channel of the block. */
+    int                     iRows;          /**< Number of channels of the block. */
+    Eigen::FFT<double>      fft;            /**< The FFT object, keeps its plan between blocks. */
+    VectorXcd               vecIn;          /**< Time domain input, two channels packed as real and imaginary part. */
+    VectorXcd               vecSpec;        /**< Spectrum of vecIn. */
+    VectorXcd               vecOut;         /**< Filtered time domain signal. */
+
+    const MatrixXd*         pDataIn;        /**< The current input block. */
+    MatrixXd*               pDataOut;       /**< The current output block. */
+    MatrixXd*               pHistory;       /**< The carried over input samples. */
+    const RowVectorXcd*     pFFTCoeffs;     /**< The transformed coefficients. */
+};
+
+}
+
+
+//*************************************************************************************************************
+
+namespace
+{
+
+void calcOverlapSave(QSharedPointer<OverlapSaveWorkspace>& pWorkspace)
+{
+    OverlapSaveWorkspace& ws = *pWorkspace;
+
+    const MatrixXd& matIn = *ws.pDataIn;
+    MatrixXd& matOut = *ws.pDataOut;
+    MatrixXd& matHistory = *ws.pHistory;
+    const RowVectorXcd& vecH = *ws.pFFTCoeffs;
+
+    int iNfft = vecH.cols();
+    int iHist = matHistory.cols();
+    int iCols = matIn.cols();
+    int iStep = iNfft - iHist;      //Valid output samples per FFT
+
+    for(int r = ws.iRow; r < ws.iRow + ws.iRows; r += 2) {
+        bool bPair = r + 1 < ws.iRow + ws.iRows;
+
+        for(int j0 = 0; j0 < iCols; j0 += iStep) {
+            int m = std::min(iStep, iCols - j0);
+
+            //Input window covers the iHist samples preceding output sample j0 and the m new ones
+            for(int i = 0; i < iHist + m; ++i) {
+                int e = j0 + i;
+                double dRe = e < iHist ? matHistory(r, e) : matIn(r, e - iHist);
+                double dIm = bPair ? (e < iHist ? matHistory(r+1, e) : matIn(r+1, e - iHist)) : 0.0;
+                ws.vecIn[i] = std::complex<double>(dRe, dIm);
+            }
+            for(int i = iHist + m; i < iNfft; ++i) {
+                ws.vecIn[i] = std::complex<double>(0.0, 0.0);
+            }
+
+            ws.fft.fwd(ws.vecSpec, ws.vecIn);
+            ws.vecSpec.array() *= vecH.transpose().array();
+            ws.fft.inv(ws.vecOut, ws.vecSpec);
+
+            //The coefficients are real, so real and imaginary part carry the two filtered channels
+            for(int t = 0; t < m; ++t) {
+                matOut(r, j0 + t) = ws.vecOut[iHist + t].real();
+                if(bPair) {
+                    matOut(r+1, j0 + t) = ws.vecOut[iHist + t].imag();
+                }
+            }
+        }
+
+        //Carry over the last iHist input samples
+        int iRowsHist = bPair ? 2 : 1;
+        if(iCols >= iHist) {
+            matHistory.block(r, 0, iRowsHist, iHist) = matIn.block(r, iCols - iHist, iRowsHist, iHist);
+        } else if(iHist > 0) {
+            matHistory.block(r, 0, iRowsHist, iHist - iCols) = matHistory.block(r, iCols, iRowsHist, iHist - iCols).eval();
+            matHistory.block(r, iHist - iCols, iRowsHist, iCols) = matIn.block(r, 0, iRowsHist, iCols);
+        }
+    }
+}
+
+} // anonymous namespace
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+OverlapSaveFilter::OverlapSaveFilter()
+: m_iFFTlength(0)
+, m_iBlockCols(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+OverlapSaveFilter::OverlapSaveFilter(const RowVectorXd& vecCoeffs)
+: m_iFFTlength(0)
+, m_iBlockCols(0)
+{
+    setCoefficients(vecCoeffs);
+}
+
+
+//*************************************************************************************************************
+
+OverlapSaveFilter::~OverlapSaveFilter()
+{
+}
+
+
+//*************************************************************************************************************
+
+void OverlapSaveFilter::setCoefficients(const RowVectorXd& vecCoeffs)
+{
+    m_vecCoeffs = vecCoeffs;
+
+    //Force the FFT length and the transformed coefficients to be recomputed
+    m_iFFTlength = 0;
+    m_iBlockCols = 0;
+    m_matHistory.resize(0,0);
+}
+
+
+//*************************************************************************************************************
+
+void OverlapSaveFilter::filter(const MatrixXd& matDataIn, MatrixXd& matDataOut)
+{
+    if(matDataOut.rows() != matDataIn.rows() || matDataOut.cols() != matDataIn.cols()) {
+        matDataOut.resize(matDataIn.rows(), matDataIn.cols());
+    }
+
+    if(m_vecCoeffs.cols() == 0) {
+        matDataOut = matDataIn;
+        return;
+    }
+
+    if(matDataIn.cols() == 0) {
+        return;
+    }
+
+    prepare(matDataIn.rows(), matDataIn.cols());
+
+    for(int i = 0; i < m_qListWorkspaces.size(); ++i) {
+        m_qListWorkspaces[i]->pDataIn = &matDataIn;
+        m_qListWorkspaces[i]->pDataOut = &matDataOut;
+        m_qListWorkspaces[i]->pHistory = &m_matHistory;
+        m_qListWorkspaces[i]->pFFTCoeffs = &m_vecFFTCoeffs;
+    }
+
+    if(m_qListWorkspaces.size() > 1) {
+        QtConcurrent::blockingMap(m_qListWorkspaces, calcOverlapSave);
+    } else {
+        calcOverlapSave(m_qListWorkspaces.first());
+    }
+}
+
+
+//*************************************************************************************************************
+
+void OverlapSaveFilter::reset()
+{
+    m_matHistory.setZero();
+}
+
+
+//*************************************************************************************************************
+
+RowVectorXd OverlapSaveFilter::cascade(const QList<FilterData>& lFilterData)
+{
+    RowVectorXd vecCoeffs;
+
+    for(int i = 0; i < lFilterData.size(); ++i) {
+        const RowVectorXd& vecNext = lFilterData.at(i).m_dCoeffA;
+
+        if(vecNext.cols() == 0) {
+            continue;
+        }
+
+        if(vecCoeffs.cols() == 0) {
+            vecCoeffs = vecNext;
+            continue;
+        }
+
+        //Filters applied one after another equal the convolution of their impulse responses
+        RowVectorXd vecConv = RowVectorXd::Zero(vecCoeffs.cols() + vecNext.cols() - 1);
+        for(int k = 0; k < vecNext.cols(); ++k) {
+            vecConv.segment(k, vecCoeffs.cols()) += vecNext[k] * vecCoeffs;
+        }
+        vecCoeffs = vecConv;
+    }
+
+    return vecCoeffs;
+}
+
+
+//*************************************************************************************************************
+
+void OverlapSaveFilter::prepare(qint32 iRows, qint32 iCols)
+{
+    int iHist = m_vecCoeffs.cols() - 1;
+
+    if(m_matHistory.rows() != iRows || m_matHistory.cols() != iHist) {
+        m_matHistory = MatrixXd::Zero(iRows, iHist);
+        m_qListWorkspaces.clear();
+    }
+
+    //Pick the FFT length for the first block size seen. Smaller or larger blocks still work, they only take more FFTs.
+    if(m_iFFTlength == 0) {
+        int iMin = qMax(iHist + iCols, 2 * (iHist + 1));
+        m_iFFTlength = OVERLAPSAVE_MIN_FFT;
+        while(m_iFFTlength < iMin) {
+            m_iFFTlength *= 2;
+        }
+        m_iBlockCols = iCols;
+
+        RowVectorXcd vecPadded = RowVectorXcd::Zero(m_iFFTlength);
+        vecPadded.head(m_vecCoeffs.cols()) = m_vecCoeffs.cast<std::complex<double> >();
+
+        Eigen::FFT<double> fft;
+        fft.fwd(m_vecFFTCoeffs, vecPadded);
+
+        m_qListWorkspaces.clear();
+    }
+
+    if(m_qListWorkspaces.isEmpty()) {
+        for(int i = 0; i < iRows; i += OVERLAPSAVE_CHUNK_ROWS) {
+            QSharedPointer<OverlapSaveWorkspace> pWorkspace(new OverlapSaveWorkspace);
+            pWorkspace->iRow = i;
+            pWorkspace->iRows = qMin(OVERLAPSAVE_CHUNK_ROWS, iRows - i);
+            pWorkspace->vecIn.resize(m_iFFTlength);
+            pWorkspace->vecSpec.resize(m_iFFTlength);
+            pWorkspace->vecOut.resize(m_iFFTlength);
+            m_qListWorkspaces.append(pWorkspace);
+        }
+    }
+}
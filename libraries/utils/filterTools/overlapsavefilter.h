@@ -0,0 +1,249 @@
+//=============================================================================================================
+/**
+* @file     overlapsavefilter.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    OverlapSaveFilter class declaration. Streams multi-channel data blocks through an FIR filter using
+*           the overlap-save method [1]. The frequency-domain coefficients are cached per FFT length and the last
+*           NumFilterTaps-1 input samples of every channel are carried over to the next block, so consecutive blocks
+*           are filtered as one continuous signal.
+*
+*           [1] http://en.wikipedia.org/wiki/Overlap%E2%80%93save_method
+*
+*/
+
+#ifndef OVERLAPSAVEFILTER_H
+#define OVERLAPSAVEFILTER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../utils_global.h"
+#include "filterdata.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+struct OverlapSaveWorkspace;
+
+
+//=============================================================================================================
+/**
+* Block-streaming FIR filter engine. All rows of the input are filtered as one batch: two real channels share
+* one complex FFT and the channels are split into blocks which are processed concurrently, each with its own
+* persistent FFT plan and work buffers. After the first block no memory is allocated as long as the block
+* dimensions do not change.
+*
+* @brief Overlap-save FIR filter for streamed multi-channel data
+*/
+class UTILSSHARED_EXPORT OverlapSaveFilter
+{
+
+public:
+    typedef QSharedPointer<OverlapSaveFilter> SPtr;            /**< Shared pointer type for OverlapSaveFilter. */
+    typedef QSharedPointer<const OverlapSaveFilter> ConstSPtr; /**< Const shared pointer type for OverlapSaveFilter. */
+
+    //=========================================================================================================
+    /**
+    * Constructs an OverlapSaveFilter without coefficients, which passes the data through unchanged.
+    */
+    OverlapSaveFilter();
+
+    //=========================================================================================================
+    /**
+    * Constructs an OverlapSaveFilter.
+    *
+    * @param [in] vecCoeffs     The FIR filter coefficients.
+    */
+    explicit OverlapSaveFilter(const RowVectorXd& vecCoeffs);
+
+    //=========================================================================================================
+    /**
+    * Destroys the OverlapSaveFilter.
+    */
+    ~OverlapSaveFilter();
+
+    //=========================================================================================================
+    /**
+    * Sets new FIR filter coefficients and clears the carried over state.
+    *
+    * @param [in] vecCoeffs     The FIR filter coefficients.
+    */
+    void setCoefficients(const RowVectorXd& vecCoeffs);
+
+    //=========================================================================================================
+    /**
+    * Returns the current FIR filter coefficients.
+    *
+    * @return the coefficients.
+    */
+    inline const RowVectorXd& coefficients() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of filter taps.
+    *
+    * @return the filter length.
+    */
+    inline qint32 length() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the delay in samples of a linear phase filter with the current length.
+    *
+    * @return the group delay.
+    */
+    inline qint32 delay() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the FFT length chosen for the current block size.
+    *
+    * @return the FFT length, 0 before the first block.
+    */
+    inline qint32 fftLength() const;
+
+    //=========================================================================================================
+    /**
+    * Filters the next block of a continuous multi-channel stream. The output is the causal convolution with
+    * the filter, i.e. delayed by delay() samples for a linear phase filter. The number of rows must not change
+    * between calls unless reset() is called in between.
+    *
+    * @param [in] matDataIn     The data block, channels x samples.
+    * @param [out] matDataOut   The filtered block, resized to the dimensions of matDataIn if necessary.
+    */
+    void filter(const MatrixXd& matDataIn, MatrixXd& matDataOut);
+
+    //=========================================================================================================
+    /**
+    * Clears the carried over state, i.e. the next block is treated as the start of a new stream.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Combines a list of filters applied one after another into one set of coefficients.
+    *
+    * @param [in] lFilterData   The filters.
+    *
+    * @return the coefficients of the cascade.
+    */
+    static RowVectorXd cascade(const QList<FilterData>& lFilterData);
+
+private:
+    //=========================================================================================================
+    /**
+    * Chooses the FFT length for the block size, caches the transformed coefficients and sets up the work buffers.
+    *
+    * @param [in] iRows     Number of channels.
+    * @param [in] iCols     Number of samples per block.
+    */
+    void prepare(qint32 iRows, qint32 iCols);
+
+    Q_DISABLE_COPY(OverlapSaveFilter)
+
+    RowVectorXd         m_vecCoeffs;        /**< The FIR filter coefficients. */
+    RowVectorXcd        m_vecFFTCoeffs;     /**< The full spectrum of the coefficients zero-padded to m_iFFTlength. */
+    MatrixXd            m_matHistory;       /**< The last length()-1 input samples of every channel. */
+    qint32              m_iFFTlength;       /**< The FFT length. */
+    qint32              m_iBlockCols;       /**< Block size the FFT length was chosen for. */
+
+    QList<QSharedPointer<OverlapSaveWorkspace> > m_qListWorkspaces;    /**< One work buffer set per channel block. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline const RowVectorXd& OverlapSaveFilter::coefficients() const
+{
+    return m_vecCoeffs;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 OverlapSaveFilter::length() const
+{
+    return m_vecCoeffs.cols();
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 OverlapSaveFilter::delay() const
+{
+    return m_vecCoeffs.cols()/2;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 OverlapSaveFilter::fftLength() const
+{
+    return m_iFFTlength;
+}
+
+} // NAMESPACE UTILSLIB
+
+#endif // OVERLAPSAVEFILTER_H
@@ -52,6 +52,8 @@
 //=============================================================================================================
 
 #include <typeinfo>
+#include <atomic>
+#include <climits>
 
 
 //*************************************************************************************************************
@@ -68,7 +70,12 @@
 //=============================================================================================================
 
 #include <QPair>
-#include <QSemaphore>
+#include <QVector>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QThread>
 #include <QSharedPointer>
 
 
@@ -89,9 +96,23 @@ namespace IOBUFFER
 using namespace Eigen;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// SOME DEFINES
+//=============================================================================================================
+
+#define CIRCULARMATRIXBUFFER_SPIN_COUNT 64      /**< Number of yields before a waiting side blocks on the condition. */
+
+
 //=============================================================================================================
 /**
-* Circular Matrix buffer provides a template for thread safe circular matrix buffers.
+* Circular Matrix buffer provides a template for thread safe circular matrix buffers between one producer and
+* one consumer thread. The buffer holds preallocated matrix slots. Read and write positions are atomic
+* counters, so a push or pop which doesn't have to wait takes no lock. Only a side which has to wait blocks on
+* a condition and is woken by the other side.
+*
+* Besides the copying push/pop, slots can be filled and read in place: acquireWrite/commit on the producer
+* side and acquireRead/release on the consumer side.
 *
 * @brief The circular matrix buffer
 */
@@ -121,7 +142,7 @@ public:
 
     //=========================================================================================================
     /**
-    * Adds a whole matrix at the end buffer.
+    * Adds a whole matrix at the end buffer. Blocks while the buffer is full.
     *
     * @param [in] pMatrix pointer to a Matrix which should be apend to the end.
     */
@@ -129,7 +150,18 @@ public:
 
     //=========================================================================================================
     /**
-    * Returns the first matrix (first in first out).
+    * Adds a whole matrix at the end buffer, waits at most msecs for a free slot.
+    *
+    * @param [in] matrix    Matrix which should be apend to the end.
+    * @param [in] msecs     Time to wait for a free slot, 0 returns immediately, -1 waits forever.
+    *
+    * @return true if the matrix was added, false otherwise.
+    */
+    inline bool tryPush(const Matrix<_Tp, Dynamic, Dynamic>& matrix, int msecs = 0);
+
+    //=========================================================================================================
+    /**
+    * Returns the first matrix (first in first out). Blocks while the buffer is empty.
     *
     * @return the first matrix
     */
@@ -137,7 +169,51 @@ public:
 
     //=========================================================================================================
     /**
-    * Clears the buffer.
+    * Copies the first matrix (first in first out) to an existing matrix, waits at most msecs for data.
+    *
+    * @param [out] matrix   The first matrix, keeps its storage if it has the right dimensions already.
+    * @param [in] msecs     Time to wait for data, 0 returns immediately, -1 waits forever.
+    *
+    * @return true if a matrix was popped, false otherwise.
+    */
+    inline bool tryPop(Matrix<_Tp, Dynamic, Dynamic>& matrix, int msecs = 0);
+
+    //=========================================================================================================
+    /**
+    * Returns the next free slot to be filled in place by the producer. The slot is handed to the consumer
+    * with commit().
+    *
+    * @param [in] msecs     Time to wait for a free slot, 0 returns immediately, -1 waits forever.
+    *
+    * @return the slot, NULL on timeout or when released by releaseFromPush().
+    */
+    inline Matrix<_Tp, Dynamic, Dynamic>* acquireWrite(int msecs = -1);
+
+    //=========================================================================================================
+    /**
+    * Hands the slot of the last acquireWrite() to the consumer.
+    */
+    inline void commit();
+
+    //=========================================================================================================
+    /**
+    * Returns the first filled slot to be read in place by the consumer. The slot is given back with release().
+    *
+    * @param [in] msecs     Time to wait for data, 0 returns immediately, -1 waits forever.
+    *
+    * @return the slot, NULL on timeout or when released by releaseFromPop().
+    */
+    inline const Matrix<_Tp, Dynamic, Dynamic>* acquireRead(int msecs = -1);
+
+    //=========================================================================================================
+    /**
+    * Gives the slot of the last acquireRead() back to the producer.
+    */
+    inline void release();
+
+    //=========================================================================================================
+    /**
+    * Clears the buffer. Producer and consumer must not access the buffer meanwhile.
     */
     void clear();
 
@@ -147,6 +223,12 @@ public:
     */
     inline quint32 size() const;
 
+    //=========================================================================================================
+    /**
+    * Number of filled slots.
+    */
+    inline quint32 count() const;
+
     //=========================================================================================================
     /**
     * Rows of the stored matrices of the buffer.
@@ -167,38 +249,61 @@ public:
 
     //=========================================================================================================
     /**
-    * Releases the circular buffer from the acquire statement in the pop() function.
-    * @param [out] bool returns true if resources were freed so that the aquire statement in the pop function can release, otherwise false.
+    * Releases a consumer which waits in pop() - it returns a zero matrix.
+    * @param [out] bool returns true if the buffer is empty, so that a pop can be waiting, otherwise false.
     */
     inline bool releaseFromPop();
 
     //=========================================================================================================
     /**
-    * Releases the circular buffer from the acquire statement in the push() function.
-    * @param [out] bool returns true if resources were freed so that the aquire statement in the push function can release, otherwise false.
+    * Releases a producer which waits in push() - its matrix is skipped.
+    * @param [out] bool returns true if the buffer is full, so that a push can be waiting, otherwise false.
     */
     inline bool releaseFromPush();
 
 private:
     //=========================================================================================================
     /**
-    * Returns the current circular index to the corresponding given index.
+    * Waits until the counter which is advanced by the other side differs from the given one.
+    *
+    * @param [in] counter       The counter advanced by the other side.
+    * @param [in] uiNotValue    The value the counter has to leave.
+    * @param [in] msecs         Time to wait, -1 waits forever.
+    * @param [in] waiting       Number of waiters on this side.
+    * @param [in] condition     Condition of this side.
+    * @param [in] iReleases     Pending releases of this side.
     *
-    * @param [in] index which should be mapped.
-    * @return the mapped index.
+    * @return true if the counter changed, false on timeout or release.
     */
-    inline unsigned int mapIndex(int& index);
+    inline bool waitFor(const std::atomic<quint64>& counter, quint64 uiNotValue, int msecs,
+                        std::atomic<int>& waiting, QWaitCondition& condition, int& iReleases);
+
+    //=========================================================================================================
+    /**
+    * Wakes a waiter of the other side, takes the lock only if somebody is waiting.
+    *
+    * @param [in] waiting       Number of waiters of the other side.
+    * @param [in] condition     Condition of the other side.
+    */
+    inline void wake(const std::atomic<int>& waiting, QWaitCondition& condition);
 
     unsigned int    m_uiMaxNumMatrices;         /**< Holds the maximal number of matrices.*/
     unsigned int    m_uiRows;                   /**< Holds the number rows.*/
     unsigned int    m_uiCols;                   /**< Holds the number cols.*/
-    unsigned int    m_uiMaxNumElements;         /**< Holds the maximal number of buffer elements.*/
-    _Tp*            m_pBuffer;                  /**< Holds the circular buffer.*/
-    int             m_iCurrentReadIndex;        /**< Holds the current read index.*/
-    int             m_iCurrentWriteIndex;       /**< Holds the current write index.*/
-    QSemaphore*     m_pFreeElements;            /**< Holds a semaphore which acquires free elements for thread safe writing. A semaphore is a generalization of a mutex.*/
-    QSemaphore*     m_pUsedElements;            /**< Holds a semaphore which acquires written semaphore for thread safe reading.*/
-    bool            m_bPause;
+
+    std::atomic<quint64>    m_uiWriteCount;     /**< Number of committed matrices, advanced by the producer only.*/
+    QVector< Matrix<_Tp, Dynamic, Dynamic> > m_vecSlots;    /**< Holds the preallocated matrix slots.*/
+    std::atomic<quint64>    m_uiReadCount;      /**< Number of released matrices, advanced by the consumer only.*/
+
+    QMutex                  m_mutex;            /**< Guards the conditions, only taken by a waiting side.*/
+    QWaitCondition          m_condNotEmpty;     /**< Signals the consumer that a matrix was committed.*/
+    QWaitCondition          m_condNotFull;      /**< Signals the producer that a slot was released.*/
+    std::atomic<int>        m_iWaitingPop;      /**< Number of waiting consumers.*/
+    std::atomic<int>        m_iWaitingPush;     /**< Number of waiting producers.*/
+    int                     m_iReleasesPop;     /**< Pending releases of the consumer.*/
+    int                     m_iReleasesPush;    /**< Pending releases of the producer.*/
+
+    std::atomic<bool>       m_bPause;           /**< Whether the buffer is paused.*/
 };
 
 
@@ -210,15 +315,16 @@ private:
 template<typename _Tp>
 CircularMatrixBuffer<_Tp>::CircularMatrixBuffer(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols)
 : Buffer(typeid(_Tp).name())
-, m_uiMaxNumMatrices(uiMaxNumMatrices)
+, m_uiMaxNumMatrices(uiMaxNumMatrices > 0 ? uiMaxNumMatrices : 1)
 , m_uiRows(uiRows)
 , m_uiCols(uiCols)
-, m_uiMaxNumElements(m_uiMaxNumMatrices*m_uiRows*m_uiCols)
-, m_pBuffer(new _Tp[m_uiMaxNumElements])
-, m_iCurrentReadIndex(-1)
-, m_iCurrentWriteIndex(-1)
-, m_pFreeElements(new QSemaphore(m_uiMaxNumElements))
-, m_pUsedElements(new QSemaphore(0))
+, m_uiWriteCount(0)
+, m_vecSlots(m_uiMaxNumMatrices, Matrix<_Tp, Dynamic, Dynamic>::Zero(uiRows, uiCols))
+, m_uiReadCount(0)
+, m_iWaitingPop(0)
+, m_iWaitingPush(0)
+, m_iReleasesPop(0)
+, m_iReleasesPush(0)
 , m_bPause(false)
 {
 
@@ -230,9 +336,7 @@ CircularMatrixBuffer<_Tp>::CircularMatrixBuffer(unsigned int uiMaxNumMatrices, u
 template<typename _Tp>
 CircularMatrixBuffer<_Tp>::~CircularMatrixBuffer()
 {
-    delete m_pFreeElements;
-    delete m_pUsedElements;
-    delete [] m_pBuffer;
+
 }
 
 
@@ -243,15 +347,8 @@ inline void CircularMatrixBuffer<_Tp>::push(const Matrix<_Tp, Dynamic, Dynamic>*
 {
     if(!m_bPause)
     {
-        unsigned int t_size = pMatrix->size();
-        if(t_size == m_uiRows*m_uiCols)
-        {
-            m_pFreeElements->acquire(t_size);
-            for(unsigned int i = 0; i < t_size; ++i)
-                m_pBuffer[mapIndex(m_iCurrentWriteIndex)] = pMatrix->data()[i];
-            m_pUsedElements->release(t_size);
-        }
-
+        if((unsigned int)pMatrix->rows() == m_uiRows && (unsigned int)pMatrix->cols() == m_uiCols)
+            tryPush(*pMatrix, -1);
         else {
             printf("Error: Matrix not appended to CircularMatrixBuffer - wrong dimensions\n");
         }
@@ -259,6 +356,25 @@ inline void CircularMatrixBuffer<_Tp>::push(const Matrix<_Tp, Dynamic, Dynamic>*
 }
 
 
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool CircularMatrixBuffer<_Tp>::tryPush(const Matrix<_Tp, Dynamic, Dynamic>& matrix, int msecs)
+{
+    if((unsigned int)matrix.rows() != m_uiRows || (unsigned int)matrix.cols() != m_uiCols)
+        return false;
+
+    Matrix<_Tp, Dynamic, Dynamic>* pSlot = acquireWrite(msecs);
+    if(!pSlot)
+        return false;
+
+    *pSlot = matrix;
+    commit();
+
+    return true;
+}
+
+
 //*************************************************************************************************************
 
 template<typename _Tp>
@@ -266,14 +382,7 @@ inline Matrix<_Tp, Dynamic, Dynamic> CircularMatrixBuffer<_Tp>::pop()
 {
     Matrix<_Tp, Dynamic, Dynamic> matrix(m_uiRows, m_uiCols);
 
-    if(!m_bPause)
-    {
-        m_pUsedElements->acquire(m_uiRows*m_uiCols);
-        for(quint32 i = 0; i < m_uiRows*m_uiCols; ++i)
-            matrix.data()[i] = m_pBuffer[mapIndex(m_iCurrentReadIndex)];
-        m_pFreeElements->release(m_uiRows*m_uiCols);
-    }
-    else
+    if(m_bPause || !tryPop(matrix, -1))
         matrix.setZero();
 
     return matrix;
@@ -283,12 +392,136 @@ inline Matrix<_Tp, Dynamic, Dynamic> CircularMatrixBuffer<_Tp>::pop()
 //*************************************************************************************************************
 
 template<typename _Tp>
-inline unsigned int CircularMatrixBuffer<_Tp>::mapIndex(int& index)
+inline bool CircularMatrixBuffer<_Tp>::tryPop(Matrix<_Tp, Dynamic, Dynamic>& matrix, int msecs)
 {
-    int AuxIndex;
-    AuxIndex = ++index;
-    return index = AuxIndex % m_uiMaxNumElements;
+    const Matrix<_Tp, Dynamic, Dynamic>* pSlot = acquireRead(msecs);
+    if(!pSlot)
+        return false;
+
+    matrix = *pSlot;
+    release();
 
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline Matrix<_Tp, Dynamic, Dynamic>* CircularMatrixBuffer<_Tp>::acquireWrite(int msecs)
+{
+    quint64 uiWrite = m_uiWriteCount.load(std::memory_order_relaxed);
+
+    //Full as long as the consumer hasn't released the slot written one round before
+    if(uiWrite - m_uiReadCount.load(std::memory_order_acquire) >= m_uiMaxNumMatrices
+            && !waitFor(m_uiReadCount, uiWrite - m_uiMaxNumMatrices, msecs, m_iWaitingPush, m_condNotFull, m_iReleasesPush))
+        return NULL;
+
+    return &m_vecSlots[uiWrite % m_uiMaxNumMatrices];
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void CircularMatrixBuffer<_Tp>::commit()
+{
+    m_uiWriteCount.fetch_add(1, std::memory_order_seq_cst);
+    wake(m_iWaitingPop, m_condNotEmpty);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline const Matrix<_Tp, Dynamic, Dynamic>* CircularMatrixBuffer<_Tp>::acquireRead(int msecs)
+{
+    quint64 uiRead = m_uiReadCount.load(std::memory_order_relaxed);
+
+    if(m_uiWriteCount.load(std::memory_order_acquire) == uiRead
+            && !waitFor(m_uiWriteCount, uiRead, msecs, m_iWaitingPop, m_condNotEmpty, m_iReleasesPop))
+        return NULL;
+
+    return &m_vecSlots[uiRead % m_uiMaxNumMatrices];
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void CircularMatrixBuffer<_Tp>::release()
+{
+    m_uiReadCount.fetch_add(1, std::memory_order_seq_cst);
+    wake(m_iWaitingPush, m_condNotFull);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool CircularMatrixBuffer<_Tp>::waitFor(const std::atomic<quint64>& counter, quint64 uiNotValue, int msecs,
+                                               std::atomic<int>& waiting, QWaitCondition& condition, int& iReleases)
+{
+    //Short bursts are usually served within a few yields - no lock and no context switch
+    for(int i = 0; i < CIRCULARMATRIXBUFFER_SPIN_COUNT && msecs != 0; ++i)
+    {
+        QThread::yieldCurrentThread();
+        if(counter.load(std::memory_order_acquire) != uiNotValue)
+            return true;
+    }
+
+    if(msecs == 0)
+        return counter.load(std::memory_order_acquire) != uiNotValue;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker locker(&m_mutex);
+
+    //Announce the waiter before the final check -> the other side either sees it or we see its update
+    waiting.fetch_add(1, std::memory_order_seq_cst);
+
+    bool bChanged = true;
+    while(counter.load(std::memory_order_seq_cst) == uiNotValue)
+    {
+        if(iReleases > 0)
+        {
+            --iReleases;
+            bChanged = false;
+            break;
+        }
+
+        unsigned long ulWait = ULONG_MAX;
+        if(msecs > 0)
+        {
+            qint64 iRemaining = msecs - timer.elapsed();
+            if(iRemaining <= 0)
+            {
+                bChanged = false;
+                break;
+            }
+            ulWait = (unsigned long)iRemaining;
+        }
+
+        condition.wait(&m_mutex, ulWait);
+    }
+
+    waiting.fetch_sub(1, std::memory_order_seq_cst);
+
+    return bChanged;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void CircularMatrixBuffer<_Tp>::wake(const std::atomic<int>& waiting, QWaitCondition& condition)
+{
+    if(waiting.load(std::memory_order_seq_cst) > 0)
+    {
+        QMutexLocker locker(&m_mutex);
+        condition.wakeAll();
+    }
 }
 
 
@@ -297,13 +530,16 @@ inline unsigned int CircularMatrixBuffer<_Tp>::mapIndex(int& index)
 template<typename _Tp>
 void CircularMatrixBuffer<_Tp>::clear()
 {
-    delete m_pFreeElements;
-    m_pFreeElements = new QSemaphore(m_uiMaxNumElements);
-    delete m_pUsedElements;
-    m_pUsedElements = new QSemaphore(0);
+    QMutexLocker locker(&m_mutex);
+
+    m_uiWriteCount.store(0);
+    m_uiReadCount.store(0);
 
-    m_iCurrentReadIndex = -1;
-    m_iCurrentWriteIndex = -1;
+    //A release for a side which is still waiting has to survive
+    if(m_iWaitingPop.load() == 0)
+        m_iReleasesPop = 0;
+    if(m_iWaitingPush.load() == 0)
+        m_iReleasesPush = 0;
 }
 
 
@@ -316,6 +552,15 @@ inline quint32 CircularMatrixBuffer<_Tp>::size() const
 }
 
 
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 CircularMatrixBuffer<_Tp>::count() const
+{
+    return (quint32)(m_uiWriteCount.load() - m_uiReadCount.load());
+}
+
+
 //*************************************************************************************************************
 
 template<typename _Tp>
@@ -348,15 +593,13 @@ inline void CircularMatrixBuffer<_Tp>::pause(bool bPause)
 template<typename _Tp>
 inline bool CircularMatrixBuffer<_Tp>::releaseFromPop()
 {
-   if((uint)m_pUsedElements->available() < m_uiRows*m_uiCols)
-    {
-        //The last matrix which is to be popped from the buffer is supposed to be a zero matrix
-        unsigned int t_size = m_uiRows*m_uiCols;
-        for(unsigned int i = 0; i < t_size; ++i)
-            m_pBuffer[mapIndex(m_iCurrentWriteIndex)] = 0;
+    QMutexLocker locker(&m_mutex);
 
-        //Release (create) values from m_pUsedElements so that the pop function can leave the acquire statement in the pop function
-        m_pUsedElements->release(m_uiRows*m_uiCols);
+    if(m_uiWriteCount.load() == m_uiReadCount.load())
+    {
+        //The waiting pop returns a zero matrix
+        ++m_iReleasesPop;
+        m_condNotEmpty.wakeAll();
 
         return true;
     }
@@ -370,15 +613,13 @@ inline bool CircularMatrixBuffer<_Tp>::releaseFromPop()
 template<typename _Tp>
 inline bool CircularMatrixBuffer<_Tp>::releaseFromPush()
 {
-    if((uint)m_pFreeElements->available() < m_uiRows*m_uiCols)
-    {
-        //The last matrix which is to be pushed to the buffer is supposed to be a zero matrix
-        unsigned int t_size = m_uiRows*m_uiCols;
-        for(unsigned int i = 0; i < t_size; ++i)
-            m_pBuffer[mapIndex(m_iCurrentWriteIndex)] = 0;
+    QMutexLocker locker(&m_mutex);
 
-        //Release (create) values from m_pFreeElements so that the push function can leave the acquire statement in the push function
-        m_pFreeElements->release(m_uiRows*m_uiCols);
+    if(m_uiWriteCount.load() - m_uiReadCount.load() >= m_uiMaxNumMatrices)
+    {
+        //The waiting push skips its matrix
+        ++m_iReleasesPush;
+        m_condNotFull.wakeAll();
 
         return true;
     }
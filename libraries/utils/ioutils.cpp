@@ -49,6 +49,17 @@
 #include <QDataStream>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// SIMD INCLUDES
+//=============================================================================================================
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IOUTILS_SSE2
+#endif
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // Eigen INCLUDES
@@ -225,6 +236,29 @@ void IOUtils::swap_floatp(float *source)
 }
 
 
+//*************************************************************************************************************
+
+void IOUtils::swap_floatp(float *source, qint64 count)
+{
+    qint64 i = 0;
+
+#ifdef IOUTILS_SSE2
+    //Swap the bytes of each 16 bit word, then the words of each 32 bit float
+    for(; i + 4 <= count; i += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2,3,0,1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2,3,0,1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(source + i), v);
+    }
+#endif
+
+    for(; i < count; ++i)
+        swap_floatp(source + i);
+}
+
+
 //*************************************************************************************************************
 
 void IOUtils::swap_doublep(double *source)
@@ -193,6 +193,15 @@ public:
     */
     static void swap_floatp (float *source);
 
+    //=========================================================================================================
+    /**
+    * swap float array in place, four floats at a time where SSE2 is available
+    *
+    * @param[in, out] source     floats to swap
+    * @param[in] count           number of floats
+    */
+    static void swap_floatp (float *source, qint64 count);
+
     //=========================================================================================================
     /**
     * swap double
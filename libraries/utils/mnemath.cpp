@@ -49,6 +49,7 @@
 #include <iostream>
 #include <algorithm>    // std::sort
 #include <vector>       // std::vector
+#include <limits>
 
 //DEBUG fstream
 //#include <fstream>
@@ -367,6 +368,79 @@ qint32 MNEMath::rank(const MatrixXd& A, double tol)
 }
 
 
+//*************************************************************************************************************
+
+bool MNEMath::gram_svd(const MatrixXd& A, VectorXd& s, MatrixXd& U, MatrixXd& V, double tol)
+{
+    //Work on the short side: A*A' for wide, A'*A for tall matrices
+    bool bWide = A.rows() <= A.cols();
+    qint32 k = bWide ? A.rows() : A.cols();
+    qint32 n = bWide ? A.cols() : A.rows();
+
+    MatrixXd matGram = MatrixXd::Zero(k, k);
+    if(bWide)
+        matGram.selfadjointView<Lower>().rankUpdate(A);
+    else
+        matGram.selfadjointView<Lower>().rankUpdate(A.transpose());
+
+    SelfAdjointEigenSolver<MatrixXd> t_eig(matGram);
+
+    //Eigenvalues are ascending -> reverse to get descending singular values
+    VectorXd eig = t_eig.eigenvalues().reverse();
+    MatrixXd matShort = t_eig.eigenvectors().rowwise().reverse();
+
+    //Eigenvalues below the round-off level of the Gram matrix carry no information
+    double t_dThr = (k > 0 ? eig[0] : 0.0) * n * std::numeric_limits<double>::epsilon();
+    qint32 rnk = 0;
+    s = VectorXd::Zero(k);
+    for(qint32 i = 0; i < k; ++i)
+    {
+        if(eig[i] > t_dThr)
+        {
+            s[i] = sqrt(eig[i]);
+            ++rnk;
+        }
+    }
+
+    //Recover the singular vectors of the long side: A'*U*S^-1 or A*V*S^-1
+    MatrixXd matLong = MatrixXd::Zero(n, k);
+    if(bWide)
+        matLong.leftCols(rnk).noalias() = A.transpose() * matShort.leftCols(rnk);
+    else
+        matLong.leftCols(rnk).noalias() = A * matShort.leftCols(rnk);
+    matLong.leftCols(rnk) *= s.head(rnk).cwiseInverse().asDiagonal();
+
+    //Accuracy check - the squared condition number of the Gram matrix shows up as loss of orthonormality
+    MatrixXd matCheck = MatrixXd::Zero(rnk, rnk);
+    matCheck.selfadjointView<Lower>().rankUpdate(matLong.leftCols(rnk).transpose());
+    matCheck.diagonal().array() -= 1.0;
+    double t_dErr = rnk > 0 ? matCheck.triangularView<Lower>().toDenseMatrix().cwiseAbs().maxCoeff() : 0.0;
+
+    if(t_dErr > tol)
+    {
+        BDCSVD<MatrixXd> t_svd(A, ComputeThinU | ComputeThinV);
+        s = t_svd.singularValues();
+        U = t_svd.matrixU();
+        V = t_svd.matrixV();
+
+        return false;
+    }
+
+    if(bWide)
+    {
+        U = matShort;
+        V = matLong;
+    }
+    else
+    {
+        U = matLong;
+        V = matShort;
+    }
+
+    return true;
+}
+
+
 //*************************************************************************************************************
 
 MatrixXd MNEMath::rescale(const MatrixXd &data, const RowVectorXf &times, QPair<QVariant,QVariant> baseline, QString mode)
@@ -0,0 +1,800 @@
+//=============================================================================================================
+/**
+* @file     tracer.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Definition of the Tracer class.
+*
+*/
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "tracer.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThreadStorage>
+#include <QThread>
+#include <QWaitCondition>
+#include <QSharedPointer>
+#include <QVector>
+#include <QHash>
+#include <QStringList>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+const int TRACE_RING_SIZE = 4096;           //Events per thread between two collections, power of two
+const int TRACE_COLLECT_INTERVAL = 50;      //Milliseconds between two collections while tracing is on
+const int TRACE_HISTORY_SIZE = 65536;       //Events kept for the trace export
+const int TRACE_BUCKETS_PER_OCTAVE = 8;
+const int TRACE_NUM_BUCKETS = 40 * TRACE_BUCKETS_PER_OCTAVE;   //1 ns to about 18 minutes
+const quint64 TRACE_MAX_OPEN_BUFFERS = 65536;
+
+enum TraceEventKind {
+    StageEvent,
+    BufferCreated
+};
+
+struct TraceEvent
+{
+    int         iStage;
+    int         iKind;
+    int         iThread;
+    qint64      iBegin;
+    qint64      iEnd;
+    quint64     iBufferId;
+};
+
+//Single producer (the owning thread), single consumer (the collector under the registry mutex)
+struct TraceRing
+{
+    TraceRing(int iThreadIndex)
+    : iThread(iThreadIndex)
+    , uiHead(0)
+    , uiTail(0)
+    , uiDropped(0)
+    , bOrphaned(false)
+    , events(TRACE_RING_SIZE)
+    {
+    }
+
+    int                     iThread;
+    QString                 sThreadName;
+    std::atomic<quint32>    uiHead;
+    std::atomic<quint32>    uiTail;
+    std::atomic<quint32>    uiDropped;
+    std::atomic<bool>       bOrphaned;
+    QVector<TraceEvent>     events;
+};
+
+//Per thread data, deleted by QThreadStorage when the thread ends. The ring stays with the registry until drained.
+struct TraceThreadData
+{
+    TraceThreadData()
+    : iCurrentBuffer(0)
+    {
+    }
+
+    ~TraceThreadData()
+    {
+        if(pRing) {
+            pRing->bOrphaned = true;
+        }
+    }
+
+    QSharedPointer<TraceRing>   pRing;
+    quint64                     iCurrentBuffer;
+};
+
+struct TraceHistogram
+{
+    TraceHistogram()
+    : vecDuration(TRACE_NUM_BUCKETS, 0)
+    , vecLatency(TRACE_NUM_BUCKETS, 0)
+    , iCount(0)
+    , iLatencyCount(0)
+    , iMaxDuration(0)
+    {
+    }
+
+    QVector<qint64>     vecDuration;
+    QVector<qint64>     vecLatency;
+    qint64              iCount;
+    qint64              iLatencyCount;
+    qint64              iMaxDuration;
+};
+
+struct TraceRegistry
+{
+    TraceRegistry()
+    : iNextThread(1)
+    , iHistoryHead(0)
+    , iHistoryCount(0)
+    {
+        timer.start();
+        history.resize(TRACE_HISTORY_SIZE);
+    }
+
+    QMutex                              mutex;
+    QElapsedTimer                       timer;
+    QStringList                         stageNames;
+    QHash<QString, int>                 stageIds;
+    QList<QSharedPointer<TraceRing> >   rings;
+    int                                 iNextThread;
+
+    QVector<TraceEvent>                 history;
+    int                                 iHistoryHead;
+    int                                 iHistoryCount;
+    QHash<quint64, qint64>              bufferCreation;
+    QVector<TraceHistogram>             histograms;
+};
+
+std::atomic<bool> s_bEnabled(false);
+std::atomic<quint64> s_uiNextBufferId(1);
+
+//*************************************************************************************************************
+
+TraceRegistry& registry()
+{
+    static TraceRegistry s_registry;
+    return s_registry;
+}
+
+//*************************************************************************************************************
+
+QThreadStorage<TraceThreadData*>& threadStorage()
+{
+    static QThreadStorage<TraceThreadData*> s_storage;
+    return s_storage;
+}
+
+//*************************************************************************************************************
+
+TraceThreadData* threadData()
+{
+    QThreadStorage<TraceThreadData*>& storage = threadStorage();
+
+    if(!storage.hasLocalData()) {
+        TraceThreadData* pData = new TraceThreadData;
+
+        TraceRegistry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        pData->pRing = QSharedPointer<TraceRing>(new TraceRing(reg.iNextThread++));
+        if(QThread::currentThread()) {
+            pData->pRing->sThreadName = QThread::currentThread()->objectName();
+        }
+        reg.rings.append(pData->pRing);
+
+        storage.setLocalData(pData);
+    }
+
+    return storage.localData();
+}
+
+//*************************************************************************************************************
+
+void push(const TraceEvent& event)
+{
+    TraceRing& ring = *threadData()->pRing;
+
+    quint32 uiHead = ring.uiHead.load(std::memory_order_relaxed);
+    if(uiHead - ring.uiTail.load(std::memory_order_acquire) >= quint32(TRACE_RING_SIZE)) {
+        ring.uiDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring.events[uiHead & (TRACE_RING_SIZE - 1)] = event;
+    ring.events[uiHead & (TRACE_RING_SIZE - 1)].iThread = ring.iThread;
+    ring.uiHead.store(uiHead + 1, std::memory_order_release);
+}
+
+//*************************************************************************************************************
+
+int bucket(qint64 iNanoSecs)
+{
+    if(iNanoSecs <= 1) {
+        return 0;
+    }
+
+    int iBucket = int(std::log2(double(iNanoSecs)) * TRACE_BUCKETS_PER_OCTAVE);
+    return std::min(iBucket, TRACE_NUM_BUCKETS - 1);
+}
+
+//*************************************************************************************************************
+
+double percentile(const QVector<qint64>& vecHistogram, qint64 iCount, double dFraction)
+{
+    if(iCount == 0) {
+        return 0.0;
+    }
+
+    qint64 iRank = qint64(std::ceil(dFraction * iCount));
+    qint64 iSum = 0;
+
+    for(int i = 0; i < vecHistogram.size(); ++i) {
+        iSum += vecHistogram[i];
+        if(iSum >= iRank) {
+            //Geometric center of the bucket, in milliseconds
+            return std::pow(2.0, (i + 0.5) / TRACE_BUCKETS_PER_OCTAVE) * 1e-6;
+        }
+    }
+
+    return std::pow(2.0, double(TRACE_NUM_BUCKETS) / TRACE_BUCKETS_PER_OCTAVE) * 1e-6;
+}
+
+//*************************************************************************************************************
+
+//Moves all pending events of all threads into the history and the histograms. Expects the registry mutex to be held.
+void collect(TraceRegistry& reg)
+{
+    QVector<TraceEvent> pending;
+
+    for(int r = reg.rings.size() - 1; r >= 0; --r) {
+        TraceRing& ring = *reg.rings[r];
+
+        bool bOrphaned = ring.bOrphaned.load(std::memory_order_acquire);
+        quint32 uiTail = ring.uiTail.load(std::memory_order_relaxed);
+        quint32 uiHead = ring.uiHead.load(std::memory_order_acquire);
+
+        for(; uiTail != uiHead; ++uiTail) {
+            pending.append(ring.events[uiTail & (TRACE_RING_SIZE - 1)]);
+        }
+        ring.uiTail.store(uiTail, std::memory_order_release);
+
+        quint32 uiDropped = ring.uiDropped.exchange(0, std::memory_order_relaxed);
+        if(uiDropped > 0) {
+            qDebug() << "Tracer - Thread" << ring.iThread << "dropped" << uiDropped << "events. Collect more often.";
+        }
+
+        if(bOrphaned) {
+            reg.rings.removeAt(r);
+        }
+    }
+
+    //Creation stamps first, the stages of a buffer may have been recorded by threads which were drained earlier
+    for(int i = 0; i < pending.size(); ++i) {
+        if(pending[i].iKind == BufferCreated) {
+            reg.bufferCreation.insert(pending[i].iBufferId, pending[i].iBegin);
+        }
+    }
+
+    quint64 uiNewest = s_uiNextBufferId.load(std::memory_order_relaxed);
+    if(reg.bufferCreation.size() > int(TRACE_MAX_OPEN_BUFFERS)) {
+        QHash<quint64, qint64>::iterator it = reg.bufferCreation.begin();
+        while(it != reg.bufferCreation.end()) {
+            if(it.key() + TRACE_MAX_OPEN_BUFFERS / 2 < uiNewest) {
+                it = reg.bufferCreation.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for(int i = 0; i < pending.size(); ++i) {
+        const TraceEvent& event = pending[i];
+
+        reg.history[reg.iHistoryHead] = event;
+        reg.iHistoryHead = (reg.iHistoryHead + 1) % TRACE_HISTORY_SIZE;
+        reg.iHistoryCount = std::min(reg.iHistoryCount + 1, TRACE_HISTORY_SIZE);
+
+        if(event.iKind != StageEvent) {
+            continue;
+        }
+
+        if(reg.histograms.size() <= event.iStage) {
+            reg.histograms.resize(event.iStage + 1);
+        }
+
+        TraceHistogram& hist = reg.histograms[event.iStage];
+        qint64 iDuration = event.iEnd - event.iBegin;
+        hist.vecDuration[bucket(iDuration)]++;
+        hist.iCount++;
+        hist.iMaxDuration = std::max(hist.iMaxDuration, iDuration);
+
+        QHash<quint64, qint64>::const_iterator itCreated = reg.bufferCreation.constFind(event.iBufferId);
+        if(event.iBufferId != 0 && itCreated != reg.bufferCreation.constEnd()) {
+            hist.vecLatency[bucket(event.iEnd - itCreated.value())]++;
+            hist.iLatencyCount++;
+        }
+    }
+}
+
+//*************************************************************************************************************
+
+//Drains the rings every TRACE_COLLECT_INTERVAL ms, so that they do not overflow between two statistics requests
+class TraceCollector : public QThread
+{
+public:
+    TraceCollector()
+    : m_bStop(false)
+    {
+    }
+
+    ~TraceCollector()
+    {
+        stopCollecting();
+    }
+
+    void startCollecting()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_bStop = false;
+
+        if(!isRunning()) {
+            start(QThread::LowPriority);
+        }
+    }
+
+    void stopCollecting()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_bStop = true;
+            m_condition.wakeAll();
+        }
+
+        wait();
+    }
+
+protected:
+    void run()
+    {
+        QMutexLocker locker(&m_mutex);
+
+        while(!m_bStop) {
+            m_condition.wait(&m_mutex, TRACE_COLLECT_INTERVAL);
+
+            if(m_bStop) {
+                break;
+            }
+
+            TraceRegistry& reg = registry();
+            QMutexLocker registryLocker(&reg.mutex);
+            collect(reg);
+        }
+    }
+
+private:
+    QMutex          m_mutex;
+    QWaitCondition  m_condition;
+    bool            m_bStop;
+};
+
+//*************************************************************************************************************
+
+TraceCollector& collector()
+{
+    //Constructed after the registry, hence stopped before the registry is destroyed
+    registry();
+
+    static TraceCollector s_collector;
+    return s_collector;
+}
+
+} // anonymous namespace
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+void Tracer::setEnabled(bool bEnabled)
+{
+    //Make sure the time base exists before the first event is recorded
+    registry();
+    s_bEnabled.store(bEnabled, std::memory_order_release);
+
+    if(bEnabled) {
+        collector().startCollecting();
+    } else {
+        collector().stopCollecting();
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool Tracer::isEnabled()
+{
+    return s_bEnabled.load(std::memory_order_relaxed);
+}
+
+
+//*************************************************************************************************************
+
+qint64 Tracer::now()
+{
+    return registry().timer.nsecsElapsed();
+}
+
+
+//*************************************************************************************************************
+
+int Tracer::registerStage(const QString& sName)
+{
+    TraceRegistry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    QHash<QString, int>::const_iterator it = reg.stageIds.constFind(sName);
+    if(it != reg.stageIds.constEnd()) {
+        return it.value();
+    }
+
+    int iStage = reg.stageNames.size();
+    reg.stageNames.append(sName);
+    reg.stageIds.insert(sName, iStage);
+
+    return iStage;
+}
+
+
+//*************************************************************************************************************
+
+quint64 Tracer::createBuffer(int iStage)
+{
+    if(!isEnabled()) {
+        return 0;
+    }
+
+    TraceEvent event;
+    event.iStage = iStage;
+    event.iKind = BufferCreated;
+    event.iBegin = now();
+    event.iEnd = event.iBegin;
+    event.iBufferId = s_uiNextBufferId.fetch_add(1, std::memory_order_relaxed);
+
+    push(event);
+
+    return event.iBufferId;
+}
+
+
+//*************************************************************************************************************
+
+quint64 Tracer::currentBuffer()
+{
+    if(!isEnabled()) {
+        return 0;
+    }
+
+    return threadData()->iCurrentBuffer;
+}
+
+
+//*************************************************************************************************************
+
+void Tracer::setCurrentBuffer(quint64 iBufferId)
+{
+    if(!isEnabled()) {
+        return;
+    }
+
+    threadData()->iCurrentBuffer = iBufferId;
+}
+
+
+//*************************************************************************************************************
+
+void Tracer::record(int iStage, qint64 iBegin, qint64 iEnd, quint64 iBufferId)
+{
+    if(!isEnabled()) {
+        return;
+    }
+
+    TraceEvent event;
+    event.iStage = iStage;
+    event.iKind = StageEvent;
+    event.iBegin = iBegin;
+    event.iEnd = iEnd;
+    event.iBufferId = iBufferId;
+
+    push(event);
+}
+
+
+//*************************************************************************************************************
+
+QList<TraceStageStatistics> Tracer::statistics()
+{
+    TraceRegistry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    collect(reg);
+
+    QList<TraceStageStatistics> qListStatistics;
+
+    for(int i = 0; i < reg.stageNames.size(); ++i) {
+        TraceStageStatistics stats;
+        stats.sName = reg.stageNames[i];
+        stats.iCount = 0;
+        stats.dDurationP50 = 0.0;
+        stats.dDurationP99 = 0.0;
+        stats.dDurationMax = 0.0;
+        stats.iLatencyCount = 0;
+        stats.dLatencyP50 = 0.0;
+        stats.dLatencyP99 = 0.0;
+
+        if(i < reg.histograms.size()) {
+            const TraceHistogram& hist = reg.histograms[i];
+            stats.iCount = hist.iCount;
+            stats.dDurationP50 = percentile(hist.vecDuration, hist.iCount, 0.5);
+            stats.dDurationP99 = percentile(hist.vecDuration, hist.iCount, 0.99);
+            stats.dDurationMax = hist.iMaxDuration * 1e-6;
+            stats.iLatencyCount = hist.iLatencyCount;
+            stats.dLatencyP50 = percentile(hist.vecLatency, hist.iLatencyCount, 0.5);
+            stats.dLatencyP99 = percentile(hist.vecLatency, hist.iLatencyCount, 0.99);
+        }
+
+        qListStatistics.append(stats);
+    }
+
+    return qListStatistics;
+}
+
+
+//*************************************************************************************************************
+
+bool Tracer::exportChromeTrace(const QString& sPath)
+{
+    QFile file(sPath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "Tracer::exportChromeTrace - Could not open" << sPath << "for writing.";
+        return false;
+    }
+
+    TraceRegistry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    collect(reg);
+
+    QTextStream out(&file);
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+    out.setRealNumberPrecision(3);
+
+    out << "{\"traceEvents\":[\n";
+
+    bool bFirst = true;
+
+    //Thread names
+    for(int i = 0; i < reg.rings.size(); ++i) {
+        if(reg.rings[i]->sThreadName.isEmpty()) {
+            continue;
+        }
+
+        out << (bFirst ? "" : ",\n")
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << reg.rings[i]->iThread
+            << ",\"args\":{\"name\":\"" << reg.rings[i]->sThreadName << "\"}}";
+        bFirst = false;
+    }
+
+    //Events, oldest first. Time stamps in microseconds.
+    int iStart = (reg.iHistoryHead - reg.iHistoryCount + TRACE_HISTORY_SIZE) % TRACE_HISTORY_SIZE;
+    for(int i = 0; i < reg.iHistoryCount; ++i) {
+        const TraceEvent& event = reg.history[(iStart + i) % TRACE_HISTORY_SIZE];
+        QString sName = event.iStage >= 0 && event.iStage < reg.stageNames.size() ? reg.stageNames[event.iStage] : QString("unknown");
+
+        out << (bFirst ? "" : ",\n")
+            << "{\"name\":\"" << sName << "\",\"pid\":1,\"tid\":" << event.iThread
+            << ",\"ts\":" << event.iBegin * 1e-3;
+
+        if(event.iKind == BufferCreated) {
+            out << ",\"ph\":\"i\",\"s\":\"t\"";
+        } else {
+            out << ",\"ph\":\"X\",\"dur\":" << (event.iEnd - event.iBegin) * 1e-3;
+        }
+
+        out << ",\"args\":{\"buffer\":" << event.iBufferId << "}}";
+        bFirst = false;
+    }
+
+    out << "\n]}\n";
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void Tracer::reset()
+{
+    TraceRegistry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    collect(reg);
+
+    reg.iHistoryHead = 0;
+    reg.iHistoryCount = 0;
+    reg.bufferCreation.clear();
+    reg.histograms.clear();
+}
+
+
+//*************************************************************************************************************
+
+TraceScope::TraceScope(int iStage, quint64 iBufferId)
+: m_iStage(iStage)
+, m_iBegin(-1)
+, m_iBufferId(0)
+, m_iPrevBufferId(0)
+{
+    if(!Tracer::isEnabled()) {
+        return;
+    }
+
+    m_iPrevBufferId = Tracer::currentBuffer();
+    m_iBufferId = iBufferId != 0 ? iBufferId : m_iPrevBufferId;
+    Tracer::setCurrentBuffer(m_iBufferId);
+    m_iBegin = Tracer::now();
+}
+
+
+//*************************************************************************************************************
+
+TraceScope::~TraceScope()
+{
+    if(m_iBegin < 0) {
+        return;
+    }
+
+    Tracer::record(m_iStage, m_iBegin, Tracer::now(), m_iBufferId);
+    Tracer::setCurrentBuffer(m_iPrevBufferId);
+}
+
+
+//*************************************************************************************************************
+
+TraceBufferScope::TraceBufferScope(int iStage)
+: m_iBufferId(Tracer::currentBuffer())
+, m_bCreated(false)
+{
+    if(m_iBufferId != 0 || !Tracer::isEnabled()) {
+        return;
+    }
+
+    m_iBufferId = Tracer::createBuffer(iStage);
+    m_bCreated = true;
+    Tracer::setCurrentBuffer(m_iBufferId);
+}
+
+
+//*************************************************************************************************************
+
+TraceBufferScope::~TraceBufferScope()
+{
+    if(m_bCreated) {
+        Tracer::setCurrentBuffer(0);
+    }
+}
+
+
+//*************************************************************************************************************
+
+TraceIdQueue::TraceIdQueue()
+: m_iHead(0)
+, m_iTail(0)
+, m_iOverflow(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TraceIdQueue::push()
+{
+    quint64 iBufferId = Tracer::currentBuffer();
+
+    //Once an id did not fit, the following ones have to queue up behind it as well
+    if(m_iOverflow.loadAcquire() > 0) {
+        m_iOverflow.fetchAndAddOrdered(1);
+        return;
+    }
+
+    quint32 iHead = m_iHead.loadAcquire();
+    if(iHead - m_iTail.loadAcquire() >= quint32(TRACE_ID_QUEUE_SIZE)) {
+        m_iOverflow.fetchAndAddOrdered(1);
+        return;
+    }
+
+    m_vecIds[iHead & (TRACE_ID_QUEUE_SIZE - 1)] = iBufferId;
+    m_iHead.storeRelease(iHead + 1);
+}
+
+
+//*************************************************************************************************************
+
+quint64 TraceIdQueue::pop()
+{
+    forever {
+        quint32 iTail = m_iTail.loadAcquire();
+
+        if(iTail == m_iHead.loadAcquire()) {
+            //The ring is empty, continue with the ids which did not fit
+            quint32 iOverflow = m_iOverflow.loadAcquire();
+            while(iOverflow > 0 && !m_iOverflow.testAndSetOrdered(iOverflow, iOverflow - 1)) {
+                iOverflow = m_iOverflow.loadAcquire();
+            }
+            return 0;
+        }
+
+        //The slot is only reused by push() after the tail moved past it, i.e. the id is valid if the tail did not move
+        quint64 iBufferId = m_vecIds[iTail & (TRACE_ID_QUEUE_SIZE - 1)];
+        if(m_iTail.testAndSetOrdered(iTail, iTail + 1)) {
+            return iBufferId;
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TraceIdQueue::clear()
+{
+    quint32 iTail = m_iTail.loadAcquire();
+    while(!m_iTail.testAndSetOrdered(iTail, m_iHead.loadAcquire())) {
+        iTail = m_iTail.loadAcquire();
+    }
+
+    m_iOverflow.storeRelease(0);
+}
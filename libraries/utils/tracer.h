@@ -0,0 +1,350 @@
+//=============================================================================================================
+/**
+* @file     tracer.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Declaration of the Tracer class.
+*
+*/
+#ifndef TRACER_H
+#define TRACER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "utils_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QString>
+#include <QList>
+#include <QAtomicInteger>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define TRACE_ID_QUEUE_SIZE 256     /**< Capacity of a TraceIdQueue, power of two. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//=============================================================================================================
+/**
+* Latency statistics of one processing stage. Durations are the time spent inside the stage, latencies the
+* time from the creation of the traced buffer to the end of the stage. All values are in milliseconds; the
+* percentiles are read from a logarithmic histogram and are accurate to about 5 %.
+*/
+struct UTILSSHARED_EXPORT TraceStageStatistics
+{
+    QString     sName;              /**< The stage name. */
+    qint64      iCount;             /**< Number of recorded stage executions. */
+    double      dDurationP50;       /**< Median duration. */
+    double      dDurationP99;       /**< 99th percentile of the duration. */
+    double      dDurationMax;       /**< Maximum duration. */
+    qint64      iLatencyCount;      /**< Number of executions which belonged to a traced buffer. */
+    double      dLatencyP50;        /**< Median latency since buffer creation. */
+    double      dLatencyP99;        /**< 99th percentile of the latency since buffer creation. */
+};
+
+
+//=============================================================================================================
+/**
+* Process wide tracing of the real-time processing chain. Stages are registered once by name. Buffers get an id
+* and a monotonic creation time stamp when they enter the chain; every stage execution is recorded with its
+* begin and end time and the id of the buffer it worked on. Events are written to a lock-free single producer
+* ring per thread, so recording never blocks the processing threads. While tracing is on, a background thread
+* drains the rings periodically, and they are drained again whenever statistics or a trace export are
+* requested. Tracing is off by default, in which case recording costs one atomic load.
+*
+* The id of the buffer a thread currently works on is kept per thread (see TraceScope and TraceBufferScope), so
+* it follows direct calls. Where buffers are handed over between threads the id has to be passed along, e.g. with
+* TraceIdQueue.
+*
+* @brief Low overhead latency tracing of the real-time processing chain
+*/
+class UTILSSHARED_EXPORT Tracer
+{
+
+public:
+    //=========================================================================================================
+    /**
+    * Switches tracing on or off.
+    *
+    * @param [in] bEnabled      Whether events are recorded.
+    */
+    static void setEnabled(bool bEnabled);
+
+    //=========================================================================================================
+    /**
+    * Returns whether tracing is on.
+    *
+    * @return true if events are recorded.
+    */
+    static bool isEnabled();
+
+    //=========================================================================================================
+    /**
+    * Returns the monotonic time used for all time stamps.
+    *
+    * @return nanoseconds since the first use of the tracer.
+    */
+    static qint64 now();
+
+    //=========================================================================================================
+    /**
+    * Returns the id of a stage, registering it if the name is new.
+    *
+    * @param [in] sName     The stage name.
+    *
+    * @return the stage id.
+    */
+    static int registerStage(const QString& sName);
+
+    //=========================================================================================================
+    /**
+    * Creates a new traced buffer and stamps its creation time. The current buffer of the calling thread is not
+    * changed, see TraceBufferScope.
+    *
+    * @param [in] iStage    The stage which creates the buffer.
+    *
+    * @return the buffer id, 0 if tracing is off.
+    */
+    static quint64 createBuffer(int iStage);
+
+    //=========================================================================================================
+    /**
+    * Returns the buffer the calling thread currently works on.
+    *
+    * @return the buffer id, 0 if none or if tracing is off.
+    */
+    static quint64 currentBuffer();
+
+    //=========================================================================================================
+    /**
+    * Sets the buffer the calling thread currently works on.
+    *
+    * @param [in] iBufferId     The buffer id, 0 for none.
+    */
+    static void setCurrentBuffer(quint64 iBufferId);
+
+    //=========================================================================================================
+    /**
+    * Records one stage execution.
+    *
+    * @param [in] iStage        The stage id.
+    * @param [in] iBegin        Begin time stamp as returned by now().
+    * @param [in] iEnd          End time stamp as returned by now().
+    * @param [in] iBufferId     The buffer the stage worked on, 0 if unknown.
+    */
+    static void record(int iStage, qint64 iBegin, qint64 iEnd, quint64 iBufferId = 0);
+
+    //=========================================================================================================
+    /**
+    * Returns the statistics of all stages recorded since the last reset().
+    *
+    * @return the statistics, one entry per registered stage.
+    */
+    static QList<TraceStageStatistics> statistics();
+
+    //=========================================================================================================
+    /**
+    * Writes the most recent events to a file in the Chrome trace event format (chrome://tracing, Perfetto).
+    *
+    * @param [in] sPath     The file path.
+    *
+    * @return true if the file was written.
+    */
+    static bool exportChromeTrace(const QString& sPath);
+
+    //=========================================================================================================
+    /**
+    * Discards all recorded events and statistics. Registered stages are kept.
+    */
+    static void reset();
+};
+
+
+//=============================================================================================================
+/**
+* Records the lifetime of the scope as one execution of a stage and makes the given buffer the current buffer
+* of the thread while the scope is alive.
+*
+* @brief Scoped stage execution
+*/
+class UTILSSHARED_EXPORT TraceScope
+{
+
+public:
+    //=========================================================================================================
+    /**
+    * Starts the stage execution.
+    *
+    * @param [in] iStage        The stage id as returned by Tracer::registerStage().
+    * @param [in] iBufferId     The buffer the stage works on. 0 keeps the current buffer of the thread.
+    */
+    explicit TraceScope(int iStage, quint64 iBufferId = 0);
+
+    //=========================================================================================================
+    /**
+    * Ends the stage execution and records it.
+    */
+    ~TraceScope();
+
+private:
+    Q_DISABLE_COPY(TraceScope)
+
+    int         m_iStage;           /**< The stage id. */
+    qint64      m_iBegin;           /**< Begin time stamp, -1 if tracing was off. */
+    quint64     m_iBufferId;        /**< The buffer of this execution. */
+    quint64     m_iPrevBufferId;    /**< The current buffer of the thread before the scope. */
+};
+
+
+//=============================================================================================================
+/**
+* Continues the current buffer of the thread or, if there is none, creates a new buffer and makes it the current
+* buffer while the scope is alive. Used where blocks enter the processing chain, so that a source which produces
+* one block after the other starts a new buffer for every block.
+*
+* @brief Scoped buffer creation
+*/
+class UTILSSHARED_EXPORT TraceBufferScope
+{
+
+public:
+    //=========================================================================================================
+    /**
+    * Continues or creates the buffer.
+    *
+    * @param [in] iStage        The stage which creates the buffer.
+    */
+    explicit TraceBufferScope(int iStage);
+
+    //=========================================================================================================
+    /**
+    * Clears the current buffer of the thread again if it was created by this scope.
+    */
+    ~TraceBufferScope();
+
+    //=========================================================================================================
+    /**
+    * Returns the buffer of the scope.
+    *
+    * @return the buffer id, 0 if tracing is off.
+    */
+    inline quint64 bufferId() const;
+
+private:
+    Q_DISABLE_COPY(TraceBufferScope)
+
+    quint64     m_iBufferId;        /**< The continued or created buffer. */
+    bool        m_bCreated;         /**< Whether the buffer was created by this scope. */
+};
+
+
+//=============================================================================================================
+/**
+* Carries buffer ids along with data which is queued between threads. The producer pushes the current buffer
+* of its thread together with the data, the consumer pops it together with the data. The queue is a lock-free
+* ring for one producer thread. Ids which do not fit into the ring are counted instead, they are popped as 0 in
+* their place so that the ids stay aligned with the data.
+*
+* @brief FIFO of buffer ids for queued hand-overs
+*/
+class UTILSSHARED_EXPORT TraceIdQueue
+{
+
+public:
+    //=========================================================================================================
+    /**
+    * Constructs an empty queue.
+    */
+    TraceIdQueue();
+
+    //=========================================================================================================
+    /**
+    * Enqueues the current buffer of the calling thread. Must only be called by one thread at a time.
+    */
+    void push();
+
+    //=========================================================================================================
+    /**
+    * Dequeues the oldest buffer id.
+    *
+    * @return the buffer id, 0 if the queue is empty.
+    */
+    quint64 pop();
+
+    //=========================================================================================================
+    /**
+    * Removes all ids, e.g. when the corresponding data buffer is cleared.
+    */
+    void clear();
+
+private:
+    Q_DISABLE_COPY(TraceIdQueue)
+
+    quint64                     m_vecIds[TRACE_ID_QUEUE_SIZE];  /**< The ring of queued ids. */
+    QAtomicInteger<quint32>     m_iHead;                        /**< Number of ids pushed to the ring, written by push(). */
+    QAtomicInteger<quint32>     m_iTail;                        /**< Number of ids popped from the ring. */
+    QAtomicInteger<quint32>     m_iOverflow;                    /**< Ids queued behind the ring which did not fit. */
+};
+
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline quint64 TraceBufferScope::bufferId() const
+{
+    return m_iBufferId;
+}
+
+} // NAMESPACE UTILSLIB
+
+#endif // TRACER_H
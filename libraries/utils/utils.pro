@@ -86,8 +86,12 @@ SOURCES += \
     filterTools/parksmcclellan.cpp \
     filterTools/filterdata.cpp \
     filterTools/filterio.cpp \
+    filterTools/overlapsavefilter.cpp \
+    filterTools/iirfilter.cpp \
     detecttrigger.cpp \
     spectrogram.cpp \
+    welchpsd.cpp \
+    tracer.cpp \
     warp.cpp \
     filterTools/sphara.cpp \
     sphere.cpp \
@@ -113,8 +117,12 @@ HEADERS += \
     filterTools/parksmcclellan.h \
     filterTools/filterdata.h \
     filterTools/filterio.h \
+    filterTools/overlapsavefilter.h \
+    filterTools/iirfilter.h \
     detecttrigger.h \
     spectrogram.h \
+    welchpsd.h \
+    tracer.h \
     warp.h \
     filterTools/sphara.h \
     sphere.h \
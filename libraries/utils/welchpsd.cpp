@@ -0,0 +1,310 @@
+//=============================================================================================================
+/**
+* @file     welchpsd.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    WelchPsd class definition.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "welchpsd.h"
+
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QtConcurrent/QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <unsupported/Eigen/FFT>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define WELCHPSD_CHUNK_ROWS 32      /**< Channels transformed per concurrent task, must be even. */
+#define WELCHPSD_PI 3.14159265358979323846      /**< Pi, M_PI isn't defined by every compiler. */
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE GLOBAL METHODS
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+/**
+* A range of channels of one windowed segment to be transformed, with its FFT plan and work vectors.
+*/
+struct WelchPsdChunk
+{
+    int                     iRow;           /**< First channel of the chunk. */
+    int                     iRows;          /**< Number of channels of the chunk. */
+    Eigen::FFT<double>      fft;            /**< The FFT object, keeps its plan between segments. */
+    VectorXcd               vecPacked;      /**< Two windowed channels packed as real and imaginary part. */
+    VectorXcd               vecSpectrum;    /**< Spectrum of vecPacked. */
+
+    const MatrixXd*         pWindowed;      /**< The windowed segment, channels x nfft. */
+    MatrixXd*               pPeriodogram;   /**< The periodogram to write, channels x (nfft/2+1). */
+    double                  dScale;         /**< PSD normalization. */
+};
+
+} // NAMESPACE UTILSLIB
+
+
+//*************************************************************************************************************
+
+namespace
+{
+
+void calcWelchPsdChunk(QSharedPointer<WelchPsdChunk>& pChunk)
+{
+    WelchPsdChunk& chunk = *pChunk;
+
+    const MatrixXd& matWindowed = *chunk.pWindowed;
+    MatrixXd& matPeriodogram = *chunk.pPeriodogram;
+
+    int iNfft = matWindowed.cols();
+    int iBins = iNfft/2 + 1;
+
+    Eigen::FFT<double>& fft = chunk.fft;
+    VectorXcd& vecPacked = chunk.vecPacked;
+    VectorXcd& vecSpectrum = chunk.vecSpectrum;
+
+    //Two real channels x and y are transformed at once as z = x + iy
+    for(int r = chunk.iRow; r < chunk.iRow + chunk.iRows; r += 2) {
+        bool bPair = r + 1 < chunk.iRow + chunk.iRows;
+
+        vecPacked.real() = matWindowed.row(r).transpose();
+        if(bPair) {
+            vecPacked.imag() = matWindowed.row(r+1).transpose();
+        } else {
+            vecPacked.imag().setZero();
+        }
+
+        fft.fwd(vecSpectrum, vecPacked);
+
+        for(int k = 0; k < iBins; ++k) {
+            std::complex<double> Z = vecSpectrum[k];
+            std::complex<double> Zc = std::conj(vecSpectrum[(iNfft - k) % iNfft]);
+
+            //X = (Z + conj(Z_-k))/2, Y = (Z - conj(Z_-k))/2i
+            double dScale = (k > 0 && 2*k != iNfft) ? 2.0 * chunk.dScale : chunk.dScale;
+
+            matPeriodogram(r,k) = 0.25 * std::norm(Z + Zc) * dScale;
+            if(bPair) {
+                matPeriodogram(r+1,k) = 0.25 * std::norm(Z - Zc) * dScale;
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+WelchPsd::WelchPsd(qint32 iNfft, double dSFreq, double dOverlap, double dAlpha)
+: m_iNfft(iNfft > 1 ? iNfft : 2)
+, m_iFill(0)
+, m_iSegments(0)
+, m_dSFreq(dSFreq)
+, m_dAlpha(0.0)
+{
+    if(dOverlap < 0.0 || dOverlap >= 1.0) {
+        qWarning("WelchPsd::WelchPsd - Overlap %f out of range [0, 1). Using 0.5.", dOverlap);
+        dOverlap = 0.5;
+    }
+
+    m_iHop = qMax(1, (qint32)std::floor(m_iNfft * (1.0 - dOverlap) + 0.5));
+
+    setExponentialAveraging(dAlpha);
+
+    m_vecWindow = hannWindow(m_iNfft);
+    m_dScale = 1.0 / (m_dSFreq * m_vecWindow.squaredNorm());
+}
+
+
+//*************************************************************************************************************
+
+void WelchPsd::setExponentialAveraging(double dAlpha)
+{
+    m_dAlpha = (dAlpha > 0.0 && dAlpha <= 1.0) ? dAlpha : 0.0;
+}
+
+
+//*************************************************************************************************************
+
+qint32 WelchPsd::append(const MatrixXd& matData)
+{
+    if(m_matSegment.rows() != matData.rows()) {
+        m_matSegment.resize(matData.rows(), m_iNfft);
+        m_matWindowed.resize(matData.rows(), m_iNfft);
+        m_matPeriodogram.resize(matData.rows(), m_iNfft/2 + 1);
+
+        //Set up the FFT plans and work vectors once, they are reused for every segment
+        m_qListChunks.clear();
+        for(int i = 0; i < matData.rows(); i += WELCHPSD_CHUNK_ROWS) {
+            QSharedPointer<WelchPsdChunk> pChunk(new WelchPsdChunk);
+            pChunk->iRow = i;
+            pChunk->iRows = qMin(WELCHPSD_CHUNK_ROWS, (int)matData.rows() - i);
+            pChunk->vecPacked.resize(m_iNfft);
+            pChunk->vecSpectrum.resize(m_iNfft);
+            m_qListChunks.append(pChunk);
+        }
+
+        m_iFill = 0;
+        reset();
+    }
+
+    qint32 iSegments = 0;
+    qint32 iCol = 0;
+
+    while(iCol < matData.cols()) {
+        qint32 iCopy = qMin(m_iNfft - m_iFill, (qint32)matData.cols() - iCol);
+        m_matSegment.middleCols(m_iFill, iCopy) = matData.middleCols(iCol, iCopy);
+        m_iFill += iCopy;
+        iCol += iCopy;
+
+        if(m_iFill == m_iNfft) {
+            processSegment();
+            ++iSegments;
+
+            //Keep the overlapping tail as the head of the next segment
+            qint32 iKeep = m_iNfft - m_iHop;
+            if(iKeep > 0) {
+                m_matSegment.leftCols(iKeep) = m_matSegment.rightCols(iKeep).eval();
+            }
+            m_iFill = iKeep;
+        }
+    }
+
+    return iSegments;
+}
+
+
+//*************************************************************************************************************
+
+void WelchPsd::reset()
+{
+    m_iSegments = 0;
+    m_matPsd = MatrixXd::Zero(m_matSegment.rows(), m_iNfft/2 + 1);
+}
+
+
+//*************************************************************************************************************
+
+void WelchPsd::clear()
+{
+    m_iFill = 0;
+    reset();
+}
+
+
+//*************************************************************************************************************
+
+RowVectorXd WelchPsd::frequencies() const
+{
+    return RowVectorXd::LinSpaced(m_iNfft/2 + 1, 0.0, (m_iNfft/2) * m_dSFreq / m_iNfft);
+}
+
+
+//*************************************************************************************************************
+
+RowVectorXd WelchPsd::hannWindow(qint32 iLength)
+{
+    RowVectorXd vecWindow(iLength);
+
+    for(qint32 i = 0; i < iLength; ++i) {
+        vecWindow[i] = 0.5 * (1.0 - std::cos(2.0 * WELCHPSD_PI * i / iLength));
+    }
+
+    return vecWindow;
+}
+
+
+//*************************************************************************************************************
+
+void WelchPsd::processSegment()
+{
+    m_matWindowed.array() = m_matSegment.array().rowwise() * m_vecWindow.array();
+
+    for(int i = 0; i < m_qListChunks.size(); ++i) {
+        m_qListChunks[i]->pWindowed = &m_matWindowed;
+        m_qListChunks[i]->pPeriodogram = &m_matPeriodogram;
+        m_qListChunks[i]->dScale = m_dScale;
+    }
+
+    if(m_qListChunks.size() > 1) {
+        QtConcurrent::blockingMap(m_qListChunks, calcWelchPsdChunk);
+    } else if(!m_qListChunks.isEmpty()) {
+        calcWelchPsdChunk(m_qListChunks.first());
+    }
+
+    ++m_iSegments;
+
+    if(m_iSegments == 1) {
+        m_matPsd = m_matPeriodogram;
+    } else if(m_dAlpha > 0.0) {
+        m_matPsd = (1.0 - m_dAlpha) * m_matPsd + m_dAlpha * m_matPeriodogram;
+    } else {
+        m_matPsd += (m_matPeriodogram - m_matPsd) / m_iSegments;
+    }
+}
@@ -0,0 +1,233 @@
+//=============================================================================================================
+/**
+* @file     welchpsd.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    WelchPsd class declaration.
+*
+*/
+
+#ifndef WELCHPSD_H
+#define WELCHPSD_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "utils_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+struct WelchPsdChunk;
+
+
+//=============================================================================================================
+/**
+* Streaming Welch power spectral density estimation. Incoming blocks (channels x samples) are cut into
+* overlapping segments of nfft samples. Each segment is weighted with a precomputed periodic Hann window and
+* all channels are transformed in one pass, packing two real channels into one complex FFT. The channels are split
+* into chunks which are transformed concurrently, each with its own persistent FFT plan and work vectors. The
+* periodograms are averaged either linearly over all segments since the last reset or exponentially.
+*
+* @brief Streaming Welch PSD estimation
+*/
+class UTILSSHARED_EXPORT WelchPsd
+{
+public:
+    typedef QSharedPointer<WelchPsd> SPtr;              /**< Shared pointer type for WelchPsd. */
+    typedef QSharedPointer<const WelchPsd> ConstSPtr;   /**< Const shared pointer type for WelchPsd. */
+
+    //=========================================================================================================
+    /**
+    * Creates the Welch estimator.
+    *
+    * @param[in] iNfft          Segment and FFT length in samples.
+    * @param[in] dSFreq         Sampling frequency in Hz.
+    * @param[in] dOverlap       Overlap of consecutive segments as fraction of the segment length [0, 1).
+    * @param[in] dAlpha         Weight of the newest periodogram for exponential averaging, 0 averages linearly.
+    */
+    WelchPsd(qint32 iNfft, double dSFreq, double dOverlap = 0.5, double dAlpha = 0.0);
+
+    //=========================================================================================================
+    /**
+    * Sets the exponential averaging weight.
+    *
+    * @param[in] dAlpha     Weight of the newest periodogram (0, 1], 0 averages linearly.
+    */
+    void setExponentialAveraging(double dAlpha);
+
+    //=========================================================================================================
+    /**
+    * Appends a block of data and processes all segments completed by it.
+    *
+    * @param[in] matData    The data block, channels x samples.
+    *
+    * @return the number of segments processed.
+    */
+    qint32 append(const Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+    * Restarts the averaging. Samples of a not yet completed segment are kept.
+    */
+    void reset();
+
+    //=========================================================================================================
+    /**
+    * Restarts the averaging and drops all buffered samples.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Returns the averaged one-sided power spectral density, channels x (nfft/2+1), in units^2/Hz.
+    *
+    * @return the power spectral density.
+    */
+    inline const Eigen::MatrixXd& psd() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of segments averaged since the last reset.
+    *
+    * @return the number of segments.
+    */
+    inline qint32 segmentCount() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the segment and FFT length.
+    *
+    * @return the FFT length.
+    */
+    inline qint32 nfft() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the frequencies of the PSD bins.
+    *
+    * @return the bin frequencies in Hz.
+    */
+    Eigen::RowVectorXd frequencies() const;
+
+    //=========================================================================================================
+    /**
+    * Creates a periodic Hann window.
+    *
+    * @param[in] iLength    Window length.
+    *
+    * @return the window.
+    */
+    static Eigen::RowVectorXd hannWindow(qint32 iLength);
+
+private:
+    //=========================================================================================================
+    /**
+    * Windows and transforms the completed segment and merges its periodogram into the average.
+    */
+    void processSegment();
+
+    qint32              m_iNfft;            /**< Segment and FFT length. */
+    qint32              m_iHop;             /**< Samples between the starts of two segments. */
+    qint32              m_iFill;            /**< Number of valid samples in m_matSegment. */
+    qint32              m_iSegments;        /**< Segments averaged since the last reset. */
+    double              m_dSFreq;           /**< Sampling frequency. */
+    double              m_dAlpha;           /**< Exponential averaging weight, 0 for linear averaging. */
+    double              m_dScale;           /**< PSD normalization 1/(fs * sum(w^2)). */
+
+    Eigen::RowVectorXd  m_vecWindow;        /**< The precomputed window. */
+    Eigen::MatrixXd     m_matSegment;       /**< The segment currently being filled, channels x nfft. */
+    Eigen::MatrixXd     m_matWindowed;      /**< The windowed segment. */
+    Eigen::MatrixXd     m_matPeriodogram;   /**< Periodogram of the latest segment. */
+    Eigen::MatrixXd     m_matPsd;           /**< The averaged power spectral density. */
+
+    QList<QSharedPointer<WelchPsdChunk> > m_qListChunks;   /**< One FFT plan and work vector set per channel chunk. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline const Eigen::MatrixXd& WelchPsd::psd() const
+{
+    return m_matPsd;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 WelchPsd::segmentCount() const
+{
+    return m_iSegments;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 WelchPsd::nfft() const
+{
+    return m_iNfft;
+}
+
+} // NAMESPACE UTILSLIB
+
+#endif // WELCHPSD_H
@@ -0,0 +1,338 @@
+//=============================================================================================================
+/**
+* @file     test_circular_matrix_buffer.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Tests the lock-free CircularMatrixBuffer and benchmarks it against the semaphore based buffer.
+*
+*/
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "circularmatrixbuffer_old.h"
+
+#include <utils/generics/circularmatrixbuffer.h>
+
+#include <algorithm>
+#include <vector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QtConcurrent>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace IOBUFFER;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestCircularMatrixBuffer
+*
+* @brief The TestCircularMatrixBuffer class verifies the producer/consumer behaviour of CircularMatrixBuffer
+* and compares throughput and latency against the semaphore based CircularMatrixBuffer_old.
+*
+*/
+class TestCircularMatrixBuffer: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestCircularMatrixBuffer();
+
+private slots:
+    void initTestCase();
+    void pushPopOrder();
+    void zeroCopyOrder();
+    void nonBlocking();
+    void releaseFromPop();
+    void releaseFromPush();
+    void benchmarkSemaphore();
+    void benchmarkLockFree();
+    void benchmarkLockFreeZeroCopy();
+    void cleanupTestCase();
+
+private:
+    template<class T_Buffer, class T_Push, class T_Pop>
+    void benchmark(const QString &sName, T_Buffer &buffer, T_Push push, T_Pop pop);
+
+    int m_iRows;        /**< Channels of a block. */
+    int m_iCols;        /**< Samples of a block. */
+    int m_iNumBlocks;   /**< Number of blocks per run. */
+};
+
+
+//*************************************************************************************************************
+
+TestCircularMatrixBuffer::TestCircularMatrixBuffer()
+: m_iRows(306)
+, m_iCols(100)
+, m_iNumBlocks(10000)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestCircularMatrixBuffer::initTestCase()
+{
+    qDebug() << "Block size" << m_iRows << "x" << m_iCols << "; blocks per run" << m_iNumBlocks;
+}
+
+
+//*************************************************************************************************************
+
+void TestCircularMatrixBuffer::pushPopOrder()
+{
+    CircularMatrixBuffer<float> buffer(8, m_iRows, m_iCols);
+
+    QFuture<void> producer = QtConcurrent::run([&]() {
+        MatrixXf matBlock(m_iRows, m_iCols);
+        for(int i = 0; i < m_iNumBlocks; ++i) {
+            matBlock.setConstant((float)i);
+            buffer.push(&matBlock);
+        }
+    });
+
+    bool bInOrder = true;
+    for(int i = 0; i < m_iNumBlocks; ++i) {
+        MatrixXf matBlock = buffer.pop();
+        bInOrder &= matBlock(0,0) == (float)i && matBlock(m_iRows-1, m_iCols-1) == (float)i;
+    }
+
+    producer.waitForFinished();
+
+    QVERIFY(bInOrder);
+    QCOMPARE(buffer.count(), (quint32)0);
+}
+
+
+//*************************************************************************************************************
+
+void TestCircularMatrixBuffer::zeroCopyOrder()
+{
+    CircularMatrixBuffer<float> buffer(4, m_iRows, m_iCols);
+
+    QFuture<void> producer = QtConcurrent::run([&]() {
+        for(int i = 0; i < m_iNumBlocks; ++i) {
+            MatrixXf* pSlot = buffer.acquireWrite();
+            pSlot->setConstant((float)i);
+            buffer.commit();
+        }
+    });
+
+    bool bInOrder = true;
+    for(int i = 0; i < m_iNumBlocks; ++i) {
+        const MatrixXf* pSlot = buffer.acquireRead();
+        bInOrder &= (*pSlot)(1,1) == (float)i;
+        buffer.release();
+    }
+
+    producer.waitForFinished();
+
+    QVERIFY(bInOrder);
+}
+
+
+//*************************************************************************************************************
+
+void TestCircularMatrixBuffer::nonBlocking()
+{
+    CircularMatrixBuffer<float> buffer(2, 3, 3);
+    MatrixXf matBlock = MatrixXf::Ones(3, 3);
+
+    QVERIFY(!buffer.tryPop(matBlock));
+    QVERIFY(!buffer.tryPop(matBlock, 10));
+    QVERIFY(buffer.acquireRead(0) == NULL);
+
+    QVERIFY(buffer.tryPush(matBlock));
+    QVERIFY(buffer.tryPush(matBlock));
+    QVERIFY(!buffer.tryPush(matBlock));
+    QVERIFY(!buffer.tryPush(matBlock, 10));
+    QVERIFY(buffer.acquireWrite(0) == NULL);
+    QVERIFY(!buffer.tryPush(MatrixXf::Ones(2, 3)));
+
+    QCOMPARE(buffer.count(), (quint32)2);
+
+    MatrixXf matOut;
+    QVERIFY(buffer.tryPop(matOut));
+    QCOMPARE(matOut.sum(), 9.0f);
+
+    buffer.clear();
+    QCOMPARE(buffer.count(), (quint32)0);
+}
+
+
+//*************************************************************************************************************
+
+void TestCircularMatrixBuffer::releaseFromPop()
+{
+    CircularMatrixBuffer<float> buffer(2, 3, 3);
+
+    QFuture<MatrixXf> consumer = QtConcurrent::run([&]() {
+        return buffer.pop();
+    });
+
+    QThread::msleep(50);
+    QVERIFY(buffer.releaseFromPop());
+
+    consumer.waitForFinished();
+    QCOMPARE(consumer.result().sum(), 0.0f);
+}
+
+
+//*************************************************************************************************************
+
+void TestCircularMatrixBuffer::releaseFromPush()
+{
+    CircularMatrixBuffer<float> buffer(2, 3, 3);
+    MatrixXf matBlock = MatrixXf::Ones(3, 3);
+    buffer.push(&matBlock);
+    buffer.push(&matBlock);
+
+    QFuture<void> producer = QtConcurrent::run([&]() {
+        buffer.push(&matBlock);
+    });
+
+    QThread::msleep(50);
+    QVERIFY(buffer.releaseFromPush());
+
+    producer.waitForFinished();
+    QCOMPARE(buffer.count(), (quint32)2);
+}
+
+
+//*************************************************************************************************************
+
+template<class T_Buffer, class T_Push, class T_Pop>
+void TestCircularMatrixBuffer::benchmark(const QString &sName, T_Buffer &buffer, T_Push push, T_Pop pop)
+{
+    std::vector<qint64> vecPushed(m_iNumBlocks);
+    std::vector<qint64> vecLatency(m_iNumBlocks);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    //The block index travels in the first element, the latency is measured from push to pop
+    QFuture<void> producer = QtConcurrent::run([&]() {
+        MatrixXf matBlock = MatrixXf::Random(m_iRows, m_iCols);
+        for(int i = 0; i < m_iNumBlocks; ++i) {
+            matBlock(0,0) = (float)i;
+            vecPushed[i] = timer.nsecsElapsed();
+            push(buffer, matBlock);
+        }
+    });
+
+    MatrixXf matBlock(m_iRows, m_iCols);
+    for(int i = 0; i < m_iNumBlocks; ++i) {
+        pop(buffer, matBlock);
+        int k = (int)matBlock(0,0);
+        vecLatency[k] = timer.nsecsElapsed() - vecPushed[k];
+    }
+
+    producer.waitForFinished();
+    double dSeconds = timer.nsecsElapsed() * 1e-9;
+
+    std::sort(vecLatency.begin(), vecLatency.end());
+
+    qDebug() << sName << ":" << m_iNumBlocks / dSeconds << "blocks/s;"
+             << "latency p50" << vecLatency[m_iNumBlocks/2] / 1000.0 << "us,"
+             << "p99" << vecLatency[(m_iNumBlocks*99)/100] / 1000.0 << "us,"
+             << "max" << vecLatency[m_iNumBlocks-1] / 1000.0 << "us";
+}
+
+
+//*************************************************************************************************************
+
+void TestCircularMatrixBuffer::benchmarkSemaphore()
+{
+    CircularMatrixBuffer_old<float> buffer(8, m_iRows, m_iCols);
+
+    QBENCHMARK_ONCE {
+        benchmark("Semaphore", buffer,
+                  [](CircularMatrixBuffer_old<float> &b, const MatrixXf &m) { b.push(&m); },
+                  [](CircularMatrixBuffer_old<float> &b, MatrixXf &m) { m = b.pop(); });
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestCircularMatrixBuffer::benchmarkLockFree()
+{
+    CircularMatrixBuffer<float> buffer(8, m_iRows, m_iCols);
+
+    QBENCHMARK_ONCE {
+        benchmark("Lock-free push/pop", buffer,
+                  [](CircularMatrixBuffer<float> &b, const MatrixXf &m) { b.push(&m); },
+                  [](CircularMatrixBuffer<float> &b, MatrixXf &m) { b.tryPop(m, -1); });
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestCircularMatrixBuffer::benchmarkLockFreeZeroCopy()
+{
+    CircularMatrixBuffer<float> buffer(8, m_iRows, m_iCols);
+
+    QBENCHMARK_ONCE {
+        benchmark("Lock-free acquire/commit", buffer,
+                  [](CircularMatrixBuffer<float> &b, const MatrixXf &m) { *b.acquireWrite() = m; b.commit(); },
+                  [](CircularMatrixBuffer<float> &b, MatrixXf &m) { m(0,0) = (*b.acquireRead())(0,0); b.release(); });
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestCircularMatrixBuffer::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestCircularMatrixBuffer)
+#include "test_circular_matrix_buffer.moc"
@@ -0,0 +1,410 @@
+//=============================================================================================================
+/**
+* @file     test_detect_trigger.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Verifies the vectorized trigger edge detection and compares its speed against the per channel scans
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/detecttrigger.h>
+
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestDetectTrigger
+*
+* @brief The TestDetectTrigger class compares DetectTrigger::detectTriggerEdges against a per sample reference
+* and measures it against detectTriggerFlanksMax and detectTriggerFlanksGrad on a 340-channel 20 kHz buffer.
+*
+*/
+class TestDetectTrigger: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestDetectTrigger();
+
+private slots:
+    void initTestCase();
+    void compareReference();
+    void blockBorders();
+    void fallingEdges();
+    void invalidChannels();
+    void removeOffset();
+    void burstAcrossBlocks();
+    void digitalMask();
+    void benchmarkDetection();
+    void cleanupTestCase();
+
+private:
+    MatrixXd simulateData(int iNumSamples, int iPulseDistance) const;
+    QList<QPair<int,int> > referenceEdges(const MatrixXd& matData, double dThreshold, bool bRising) const;
+    QList<QPair<int,int> > toSampleChannelPairs(const QVector<TriggerEvent>& vecEvents, int iCount) const;
+
+    double m_dSFreq;            /**< Sampling frequency of the simulated buffer. */
+    int m_iChannels;            /**< Channels of the simulated buffer. */
+    QList<int> m_lStimChannels; /**< The trigger channels of the simulated buffer. */
+    double m_dThreshold;        /**< Trigger threshold. */
+};
+
+
+//*************************************************************************************************************
+
+TestDetectTrigger::TestDetectTrigger()
+: m_dSFreq(20000.0)
+, m_iChannels(340)
+, m_dThreshold(0.5)
+{
+    for(int i = 306; i < 322; ++i) {
+        m_lStimChannels.append(i);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::initTestCase()
+{
+    qsrand(42);
+    qDebug() << "Buffer of" << m_iChannels << "channels at" << m_dSFreq << "Hz with" << m_lStimChannels.size() << "trigger channels";
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::compareReference()
+{
+    MatrixXd matData = simulateData(20000, 500);
+
+    QVector<TriggerEvent> vecEvents;
+    int iCount = DetectTrigger::detectTriggerEdges(matData, m_lStimChannels, 0, m_dThreshold, true, vecEvents);
+
+    QList<QPair<int,int> > lRef = referenceEdges(matData, m_dThreshold, true);
+
+    QVERIFY(iCount > 0);
+    QCOMPARE(toSampleChannelPairs(vecEvents, iCount), lRef);
+
+    for(int i = 0; i < iCount; ++i) {
+        QCOMPARE(vecEvents.at(i).dValue, matData(vecEvents.at(i).iChannel, vecEvents.at(i).iSample));
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::blockBorders()
+{
+    MatrixXd matData = simulateData(20000, 300);
+    int iBlockSize = 333;
+
+    QVector<TriggerEvent> vecEvents;
+    VectorXd vecLastSamples;
+    QList<QPair<int,int> > lBlocks;
+
+    for(int i = 0; i < matData.cols(); i += iBlockSize) {
+        int iCols = qMin(iBlockSize, (int)matData.cols() - i);
+        int iCount = DetectTrigger::detectTriggerEdges(matData.middleCols(i, iCols), m_lStimChannels, i, m_dThreshold, true, vecEvents, &vecLastSamples);
+        lBlocks.append(toSampleChannelPairs(vecEvents, iCount));
+    }
+
+    QCOMPARE(lBlocks, referenceEdges(matData, m_dThreshold, true));
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::fallingEdges()
+{
+    MatrixXd matData = simulateData(20000, 500);
+
+    QVector<TriggerEvent> vecEvents;
+    int iCount = DetectTrigger::detectTriggerEdges(matData, m_lStimChannels, 0, m_dThreshold, false, vecEvents);
+
+    QCOMPARE(toSampleChannelPairs(vecEvents, iCount), referenceEdges(matData, m_dThreshold, false));
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::invalidChannels()
+{
+    MatrixXd matData = MatrixXd::Zero(4, 100);
+    matData.row(2).tail(50).setOnes();
+
+    QList<int> lChannels;
+    lChannels << -1 << 2 << 7;
+
+    QVector<TriggerEvent> vecEvents;
+    int iCount = DetectTrigger::detectTriggerEdges(matData, lChannels, 1000, m_dThreshold, true, vecEvents);
+
+    QCOMPARE(iCount, 1);
+    QCOMPARE(vecEvents.at(0).iChannel, 2);
+    QCOMPARE(vecEvents.at(0).iSample, 1050);
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::removeOffset()
+{
+    //The stim channel idles at a DC offset above the threshold, one pulse rises exactly at a block border
+    MatrixXd matData = MatrixXd::Constant(2, 1000, 2.0);
+    QList<int> lPulses;
+    lPulses << 100 << 400 << 500 << 700;
+
+    for(int i = 0; i < lPulses.size(); ++i) {
+        matData.row(1).segment(lPulses.at(i), 10).array() += 1.0;
+    }
+
+    QList<int> lChannels;
+    lChannels << 1;
+
+    QVector<TriggerEvent> vecEvents;
+    QCOMPARE(DetectTrigger::detectTriggerEdges(matData, lChannels, 0, m_dThreshold, true, vecEvents), 0);
+
+    VectorXd vecLastSamples;
+    QList<int> lFound;
+
+    for(int i = 0; i < matData.cols(); i += 250) {
+        int iCount = DetectTrigger::detectTriggerEdges(matData.middleCols(i, 250), lChannels, i, m_dThreshold, true, vecEvents, &vecLastSamples, 0, true);
+
+        for(int j = 0; j < iCount; ++j) {
+            QCOMPARE(vecEvents.at(j).dValue, 3.0);
+            lFound.append(vecEvents.at(j).iSample);
+        }
+    }
+
+    QCOMPARE(lFound, lPulses);
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::burstAcrossBlocks()
+{
+    //Pulses every 60 samples with a burst length of 100 samples, so the refractory window spans most block borders
+    MatrixXd matData = MatrixXd::Zero(1, 3000);
+    for(int i = 10; i < matData.cols(); i += 60) {
+        matData.row(0).segment(i, 5).setOnes();
+    }
+
+    QList<int> lChannels;
+    lChannels << 0;
+    int iBurstLength = 100;
+
+    QVector<TriggerEvent> vecEvents;
+    int iCount = DetectTrigger::detectTriggerEdges(matData, lChannels, 0, m_dThreshold, true, vecEvents, Q_NULLPTR, iBurstLength);
+    QList<QPair<int,int> > lRef = toSampleChannelPairs(vecEvents, iCount);
+
+    QCOMPARE(iCount, 25);
+
+    VectorXd vecLastSamples;
+    VectorXi vecBlockedSamples;
+    QList<QPair<int,int> > lBlocks;
+    int iUnblocked = 0;
+
+    for(int i = 0; i < matData.cols(); i += 37) {
+        int iCols = qMin(37, (int)matData.cols() - i);
+        int iBlockCount = DetectTrigger::detectTriggerEdges(matData.middleCols(i, iCols), lChannels, i, m_dThreshold, true, vecEvents, &vecLastSamples, iBurstLength, false, &vecBlockedSamples);
+        lBlocks.append(toSampleChannelPairs(vecEvents, iBlockCount));
+
+        iUnblocked += DetectTrigger::detectTriggerEdges(matData.middleCols(i, iCols), lChannels, i, m_dThreshold, true, vecEvents, Q_NULLPTR, iBurstLength);
+    }
+
+    QCOMPARE(lBlocks, lRef);
+
+    //Without the carried window every block starts unblocked and fires again
+    QVERIFY(iUnblocked > lRef.size());
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::digitalMask()
+{
+    MatrixXd matData = MatrixXd::Zero(1, 300);
+    matData(0,100) = matData(0,101) = 3;
+    matData(0,200) = 5;
+    matData(0,201) = 5 | 16;
+    matData(0,202) = 16;
+
+    QList<int> lChannels;
+    lChannels << 0;
+
+    //Bit 4 is masked, so sample 201 does not change the code and sample 202 decodes to zero
+    QVector<TriggerEvent> vecEvents;
+    int iCount = DetectTrigger::detectDigitalTriggers(matData, lChannels, 0, 0xF, vecEvents);
+
+    QCOMPARE(iCount, 2);
+    QCOMPARE(vecEvents.at(0).iSample, 100);
+    QCOMPARE(vecEvents.at(0).dValue, 3.0);
+    QCOMPARE(vecEvents.at(1).iSample, 200);
+    QCOMPARE(vecEvents.at(1).dValue, 5.0);
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::benchmarkDetection()
+{
+    int iNumSamples = 20000;
+    int iNumRuns = 20;
+    MatrixXd matData = simulateData(iNumSamples, 500);
+
+    QVector<TriggerEvent> vecEvents;
+    int iCount = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    for(int i = 0; i < iNumRuns; ++i) {
+        iCount = DetectTrigger::detectTriggerEdges(matData, m_lStimChannels, 0, m_dThreshold, true, vecEvents);
+    }
+    qint64 iElapsedEdges = timer.nsecsElapsed();
+
+    timer.restart();
+    for(int i = 0; i < iNumRuns; ++i) {
+        DetectTrigger::detectTriggerFlanksMax(matData, m_lStimChannels, 0, m_dThreshold, false);
+    }
+    qint64 iElapsedMax = timer.nsecsElapsed();
+
+    timer.restart();
+    for(int i = 0; i < iNumRuns; ++i) {
+        DetectTrigger::detectTriggerFlanksGrad(matData, m_lStimChannels, 0, m_dThreshold, false, "Rising");
+    }
+    qint64 iElapsedGrad = timer.nsecsElapsed();
+
+    double dEdgesMs = iElapsedEdges / (1.0e6 * iNumRuns);
+
+    qDebug() << "One second of" << m_iChannels << "channels:" << iCount << "flanks";
+    qDebug() << "detectTriggerEdges" << dEdgesMs << "ms";
+    qDebug() << "detectTriggerFlanksMax" << iElapsedMax / (1.0e6 * iNumRuns) << "ms";
+    qDebug() << "detectTriggerFlanksGrad" << iElapsedGrad / (1.0e6 * iNumRuns) << "ms";
+
+    QCOMPARE(iCount, referenceEdges(matData, m_dThreshold, true).size());
+    QVERIFY(dEdgesMs < 1000.0 * iNumSamples / m_dSFreq);
+}
+
+
+//*************************************************************************************************************
+
+void TestDetectTrigger::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestDetectTrigger::simulateData(int iNumSamples, int iPulseDistance) const
+{
+    MatrixXd matData = 0.01 * MatrixXd::Random(m_iChannels, iNumSamples);
+
+    //Pulses of random code and width, placed at jittered positions
+    for(int i = 0; i < m_lStimChannels.size(); ++i) {
+        int iChIdx = m_lStimChannels.at(i);
+
+        for(int s = qrand() % iPulseDistance; s < iNumSamples; s += iPulseDistance / 2 + qrand() % iPulseDistance) {
+            int iWidth = qMin(10 + qrand() % 100, iNumSamples - s);
+            matData.row(iChIdx).segment(s, iWidth).setConstant(1 + qrand() % 5);
+        }
+    }
+
+    return matData;
+}
+
+
+//*************************************************************************************************************
+
+QList<QPair<int,int> > TestDetectTrigger::referenceEdges(const MatrixXd& matData, double dThreshold, bool bRising) const
+{
+    QList<QPair<int,int> > lEdges;
+
+    for(int j = 1; j < matData.cols(); ++j) {
+        for(int i = 0; i < m_lStimChannels.size(); ++i) {
+            int iChIdx = m_lStimChannels.at(i);
+            bool bAbove = matData(iChIdx, j) >= dThreshold;
+            bool bWasAbove = matData(iChIdx, j - 1) >= dThreshold;
+
+            if(bAbove != bWasAbove && bAbove == bRising) {
+                lEdges.append(qMakePair(j, iChIdx));
+            }
+        }
+    }
+
+    return lEdges;
+}
+
+
+//*************************************************************************************************************
+
+QList<QPair<int,int> > TestDetectTrigger::toSampleChannelPairs(const QVector<TriggerEvent>& vecEvents, int iCount) const
+{
+    //Events are ordered by sample, events of the same sample are ordered by channel
+    QList<QPair<int,int> > lPairs;
+
+    for(int i = 0; i < iCount; ++i) {
+        lPairs.append(qMakePair(vecEvents.at(i).iSample, vecEvents.at(i).iChannel));
+    }
+
+    return lPairs;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestDetectTrigger)
+#include "test_detect_trigger.moc"
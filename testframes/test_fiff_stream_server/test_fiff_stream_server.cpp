@@ -0,0 +1,646 @@
+//=============================================================================================================
+/**
+* @file     test_fiff_stream_server.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Connects many loopback clients to the FiffStreamServer and measures the raw buffer forwarding latency
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiffstreamserver.h>
+#include <streamprofile.h>
+#include <streammerger.h>
+
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_stream.h>
+#include <realtime/rtClient/rawbuffercodec.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QtEndian>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVER;
+using namespace FIFFLIB;
+using namespace REALTIMELIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestFiffStreamServer
+*
+* @brief The TestFiffStreamServer class connects many loopback clients to a FiffStreamServer, checks that every
+* client receives the identical byte stream and measures the time until a forwarded buffer reached all clients.
+* Clients which do not read keep a bounded send queue. Clients with equal stream profiles share one encoding.
+* Clients receive only the measurement stream they subscribed to, several streams are merged on a common time grid.
+*
+*/
+class TestFiffStreamServer: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestFiffStreamServer();
+
+private slots:
+    void initTestCase();
+    void forwardingLatency();
+    void identicalStreams();
+    void boundedQueue();
+    void sharedProfiles();
+    void profileEncoding();
+    void streamSubscription();
+    void streamMerger();
+    void streamMergerAntiAliasing();
+    void disconnectClients();
+    void cleanupTestCase();
+
+private:
+    int readClients(qint64 iExpectedBytes);
+
+    FiffStreamServer m_server;              /**< The server under test. */
+    QList<QTcpSocket*> m_listClients;       /**< The loopback clients. */
+    QVector<QByteArray> m_vecReceived;      /**< The bytes received by each client. */
+    QByteArray m_blockExpected;             /**< The byte stream every client has to receive. */
+
+    int m_iNumClients;      /**< Number of loopback clients. */
+    int m_iChannels;        /**< Channels of the forwarded buffers. */
+    int m_iSamples;         /**< Samples of the forwarded buffers. */
+    int m_iNumBuffers;      /**< Number of forwarded buffers. */
+};
+
+
+//*************************************************************************************************************
+
+TestFiffStreamServer::TestFiffStreamServer()
+: m_iNumClients(100)
+, m_iChannels(306)
+, m_iSamples(50)
+, m_iNumBuffers(200)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::initTestCase()
+{
+    QVERIFY(m_server.listen(QHostAddress::LocalHost, 0));
+
+    for(int i = 0; i < m_iNumClients; ++i) {
+        QTcpSocket* pSocket = new QTcpSocket(this);
+        pSocket->connectToHost(QHostAddress::LocalHost, m_server.serverPort());
+        m_listClients.append(pSocket);
+    }
+    m_vecReceived.resize(m_iNumClients);
+
+    QTRY_COMPARE_WITH_TIMEOUT(m_server.clientCount(), m_iNumClients, 10000);
+
+    qDebug() << m_iNumClients << "clients connected, buffers of" << m_iChannels << "x" << m_iSamples;
+
+    //All clients start to accept raw buffers
+    FiffStream t_FiffStreamOut(&m_blockExpected, QIODevice::WriteOnly);
+    t_FiffStreamOut.start_block(FIFFB_RAW_DATA);
+
+    for(int i = 0; i < m_iNumClients; ++i) {
+        emit m_server.startMeasFiffStreamClient(i);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(readClients(m_blockExpected.size()), m_iNumClients, 10000);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::forwardingLatency()
+{
+    QSharedPointer<MatrixXf> pMatData(new MatrixXf(MatrixXf::Random(m_iChannels, m_iSamples)));
+
+    FiffStream t_FiffStreamOut(&m_blockExpected, QIODevice::WriteOnly);
+    t_FiffStreamOut.device()->seek(m_blockExpected.size());
+
+    QVector<double> vecLatencyMs;
+    QElapsedTimer timer;
+
+    for(int i = 0; i < m_iNumBuffers; ++i) {
+        (*pMatData)(0,0) = i;
+        t_FiffStreamOut.write_float(FIFF_DATA_BUFFER, pMatData->data(), pMatData->size());
+
+        timer.start();
+        m_server.forwardRawBuffer(pMatData);
+
+        //Spin the event loop until the buffer arrived at every client
+        while(readClients(m_blockExpected.size()) < m_iNumClients && timer.elapsed() < 10000) {
+            QCoreApplication::processEvents();
+        }
+        vecLatencyMs.append(timer.nsecsElapsed() / 1.0e6);
+
+        QCOMPARE(readClients(m_blockExpected.size()), m_iNumClients);
+    }
+
+    std::sort(vecLatencyMs.begin(), vecLatencyMs.end());
+    double dMean = std::accumulate(vecLatencyMs.begin(), vecLatencyMs.end(), 0.0) / vecLatencyMs.size();
+
+    qDebug() << "Buffer reached all" << m_iNumClients << "clients after" << dMean << "ms on average, median"
+             << vecLatencyMs.at(vecLatencyMs.size() / 2) << "ms, max" << vecLatencyMs.last() << "ms";
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::identicalStreams()
+{
+    for(int i = 0; i < m_iNumClients; ++i) {
+        QCOMPARE(m_vecReceived.at(i).size(), m_blockExpected.size());
+        QVERIFY(m_vecReceived.at(i) == m_blockExpected);
+    }
+
+    QCOMPARE(m_server.getClient(0)->queueDepth(), 0);
+    QVERIFY(m_server.getClient(0)->maxQueueDepth() >= 1);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::boundedQueue()
+{
+    const int iQueueLimit = 5;
+    const int iNumBuffers = 500;
+
+    for(int i = 0; i < m_iNumClients; ++i) {
+        m_server.getClient(i)->setSendPolicy(FiffStreamClient::DropOldest, iQueueLimit);
+    }
+
+    //The clients stop reading, the socket buffers fill up and the server has to drop buffers
+    QSharedPointer<MatrixXf> pMatData(new MatrixXf(MatrixXf::Random(m_iChannels, m_iSamples)));
+    for(int i = 0; i < iNumBuffers; ++i) {
+        m_server.forwardRawBuffer(pMatData);
+        QVERIFY(m_server.getClient(0)->queueDepth() <= iQueueLimit);
+    }
+
+    FiffStreamClient* pClient = m_server.getClient(0);
+    QVERIFY(pClient->droppedBuffers() > 0);
+    QVERIFY(pClient->sentBuffers() >= m_iNumBuffers);
+
+    qDebug() << "Client 0 sent" << pClient->sentBuffers() - m_iNumBuffers << "and dropped" << pClient->droppedBuffers()
+             << "of" << iNumBuffers << "buffers";
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::sharedProfiles()
+{
+    QList<int> qListChannels;
+    QVERIFY(StreamProfile::parseChannels("20, 0-9", qListChannels));
+    QCOMPARE(qListChannels.size(), 11);
+    QVERIFY(!StreamProfile::parseChannels("9-0", qListChannels));
+
+    //Half of the clients ask for the same profile, it is encoded once
+    for(int i = 0; i < m_iNumClients / 2; ++i) {
+        QVERIFY(m_server.setStreamProfile(i, StreamProfile::SPtr(new StreamProfile(QList<int>() << 0 << 1 << 2, 4, true, true))));
+    }
+    QCOMPARE(m_server.profileCount(), 1);
+    QCOMPARE(m_server.getClient(0)->profileKey(), QString("ch=0-2;decim=4;int16;zlib"));
+
+    QVERIFY(m_server.setStreamProfile(m_iNumClients - 1, StreamProfile::SPtr(new StreamProfile(QList<int>(), 2))));
+    QCOMPARE(m_server.profileCount(), 2);
+
+    //A full stream profile is no profile
+    QVERIFY(m_server.setStreamProfile(m_iNumClients - 1, StreamProfile::SPtr(new StreamProfile)));
+    QCOMPARE(m_server.profileCount(), 1);
+    QVERIFY(m_server.getClient(m_iNumClients - 1)->profileKey().isEmpty());
+
+    //Forwarding encodes the shared profile alongside the full stream
+    qRegisterMetaType<QHash<QString, QByteArray> >("QHash<QString, QByteArray>");
+    QSignalSpy spy(&m_server, &FiffStreamServer::remitRawBuffers);
+
+    QSharedPointer<MatrixXf> pMatData(new MatrixXf(MatrixXf::Random(m_iChannels, m_iSamples)));
+    m_server.forwardRawBuffer(pMatData);
+
+    QCOMPARE(spy.count(), 1);
+    QHash<QString, QByteArray> hashEncodedTags = spy.at(0).at(1).value<QHash<QString, QByteArray> >();
+    QCOMPARE(hashEncodedTags.size(), 2);
+
+    QByteArray blockFull;
+    FiffStream t_FiffStreamOut(&blockFull, QIODevice::WriteOnly);
+    t_FiffStreamOut.write_float(FIFF_DATA_BUFFER, pMatData->data(), pMatData->size());
+    QVERIFY(hashEncodedTags.value(QString()) == blockFull);
+
+    QByteArray blockProfiled = hashEncodedTags.value(m_server.getClient(0)->profileKey());
+    QVERIFY(blockProfiled.size() > 16);
+    MatrixXf matDecoded;
+    QVERIFY(RawBufferCodec::decode(blockProfiled.constData() + 16, blockProfiled.size() - 16, matDecoded));
+    QCOMPARE((int)matDecoded.rows(), 3);
+    QCOMPARE((int)matDecoded.cols(), (m_iSamples - 1) / 4 + 1);
+
+    for(int i = 0; i < m_iNumClients / 2; ++i) {
+        QVERIFY(m_server.setStreamProfile(i, StreamProfile::SPtr()));
+    }
+    QCOMPARE(m_server.profileCount(), 0);
+
+    //A profile which picks none of the channels of the stream falls back to the full stream with its info
+    QVERIFY(m_server.setStreamProfile(0, StreamProfile::SPtr(new StreamProfile(QList<int>() << m_iChannels << m_iChannels + 1))));
+    QCOMPARE(m_server.profileCount(), 1);
+    QCOMPARE(m_server.streamChannels(m_server.primaryStream()), -1);
+
+    FiffInfo info;
+    info.sfreq = 1000.0f;
+    for(int i = 0; i < m_iChannels; ++i) {
+        FiffChInfo ch;
+        ch.ch_name = QString("CH %1").arg(i);
+        info.chs.append(ch);
+        info.ch_names.append(ch.ch_name);
+    }
+    info.nchan = info.chs.size();
+
+    m_server.forwardMeasInfo(0, info);
+    QCOMPARE(m_server.streamChannels(m_server.primaryStream()), m_iChannels);
+    QVERIFY(m_server.getClient(0)->profileKey().isEmpty());
+    QCOMPARE(m_server.profileCount(), 0);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::profileEncoding()
+{
+    const int iDecimation = 4;
+    const int iNumBuffers = 40;
+
+    StreamProfile profile(QList<int>() << 1 << 3, iDecimation, true, true);
+
+    //A constant passes the anti-aliasing low pass, the decimation grid continues across buffers
+    MatrixXf matData = MatrixXf::Ones(m_iChannels, m_iSamples);
+    MatrixXf matDecoded;
+    int iSamples = 0;
+
+    for(int i = 0; i < iNumBuffers; ++i) {
+        QByteArray blockTag = profile.encode(matData);
+        QVERIFY(!blockTag.isEmpty());
+
+        const uchar* pHeader = reinterpret_cast<const uchar*>(blockTag.constData());
+        QCOMPARE(qFromBigEndian<qint32>(pHeader), (qint32)FIFF_MNE_RT_PROFILED_BUFFER);
+        qint32 iSize = qFromBigEndian<qint32>(pHeader + 8);
+        QCOMPARE(iSize, (qint32)(blockTag.size() - 16));
+
+        QVERIFY(RawBufferCodec::decode(blockTag.constData() + 16, iSize, matDecoded));
+        QCOMPARE((int)matDecoded.rows(), 2);
+        iSamples += matDecoded.cols();
+    }
+
+    QCOMPARE(iSamples, iNumBuffers * m_iSamples / iDecimation);
+    QVERIFY((matDecoded.array() - 1.0f).abs().maxCoeff() < 1e-3f);
+
+    //The measurement info describes the profiled stream
+    FiffInfo info;
+    info.nchan = 4;
+    info.sfreq = 1000.0f;
+    info.lowpass = 330.0f;
+    for(int i = 0; i < info.nchan; ++i) {
+        FiffChInfo ch;
+        ch.ch_name = QString("CH %1").arg(i);
+        info.chs.append(ch);
+        info.ch_names.append(ch.ch_name);
+    }
+
+    FiffInfo infoProfiled = profile.applyTo(info);
+    QCOMPARE(infoProfiled.nchan, 2);
+    QCOMPARE(infoProfiled.ch_names, QStringList() << "CH 1" << "CH 3");
+    QCOMPARE(infoProfiled.sfreq, 250.0f);
+    QVERIFY(infoProfiled.lowpass <= 100.0f);
+
+    //A 200 Hz tone at 1 kHz would alias to 50 Hz after the decimation, a 10 Hz tone has to pass
+    StreamProfile profileTones(QList<int>() << 0 << 1, iDecimation, false, true);
+    double dMaxAlias = 0.0;
+    double dMaxPass = 0.0;
+    iSamples = 0;
+
+    for(int b = 0; b < iNumBuffers; ++b) {
+        MatrixXf matTones(2, m_iSamples);
+        for(int j = 0; j < matTones.cols(); ++j) {
+            double dTimeS = (b * m_iSamples + j) / 1000.0;
+            matTones(0, j) = (float)std::sin(2.0 * M_PI * 200.0 * dTimeS);
+            matTones(1, j) = (float)std::sin(2.0 * M_PI * 10.0 * dTimeS);
+        }
+
+        QByteArray blockTag = profileTones.encode(matTones);
+        QVERIFY(RawBufferCodec::decode(blockTag.constData() + 16, blockTag.size() - 16, matDecoded));
+        QCOMPARE((int)matDecoded.rows(), 2);
+
+        //The filter settles within the first second
+        for(int j = 0; j < matDecoded.cols(); ++j) {
+            if(iSamples + j >= 250) {
+                dMaxAlias = qMax(dMaxAlias, (double)qAbs(matDecoded(0, j)));
+                dMaxPass = qMax(dMaxPass, (double)qAbs(matDecoded(1, j)));
+            }
+        }
+        iSamples += matDecoded.cols();
+    }
+
+    QCOMPARE(iSamples, iNumBuffers * m_iSamples / iDecimation);
+    QVERIFY(dMaxAlias < 0.01);
+    QVERIFY(dMaxPass > 0.95 && dMaxPass < 1.05);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::streamSubscription()
+{
+    const qint32 iStreamId = 7;
+    const qint32 iClientId = m_iNumClients - 1;
+
+    qRegisterMetaType<QHash<QString, QByteArray> >("QHash<QString, QByteArray>");
+    QSignalSpy spy(&m_server, &FiffStreamServer::remitRawBuffers);
+
+    m_server.setAvailableStreams(QList<qint32>() << m_server.primaryStream() << iStreamId);
+    QVERIFY(m_server.subscribe(iClientId, iStreamId));
+
+    qint32 iClientStream = -2;
+    QVERIFY(m_server.getClientStream(iClientId, iClientStream));
+    QCOMPARE(iClientStream, iStreamId);
+    QCOMPARE(m_server.subscriberCount(iStreamId), 1);
+    QCOMPARE(m_server.subscriberCount(m_server.primaryStream()), m_iNumClients - 1);
+
+    //A stream without subscribers is not encoded at all
+    QSharedPointer<MatrixXf> pMatData(new MatrixXf(MatrixXf::Random(m_iChannels, m_iSamples)));
+    m_server.forwardStreamBuffer(iStreamId + 1, pMatData);
+    QCOMPARE(spy.count(), 0);
+
+    //Profiles belong to a stream, the subscribed stream is encoded for its only client
+    QVERIFY(m_server.setStreamProfile(iClientId, StreamProfile::SPtr(new StreamProfile(QList<int>() << 0, 2))));
+    QCOMPARE(m_server.profileCount(), 1);
+
+    m_server.forwardStreamBuffer(iStreamId, pMatData);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toInt(), iStreamId);
+
+    QHash<QString, QByteArray> hashEncodedTags = spy.at(0).at(1).value<QHash<QString, QByteArray> >();
+    QCOMPARE(hashEncodedTags.size(), 1);
+    QVERIFY(hashEncodedTags.contains(m_server.getClient(iClientId)->profileKey()));
+
+    //Returning to the primary stream resets the profile
+    QVERIFY(m_server.subscribe(iClientId, m_server.primaryStream()));
+    QCOMPARE(m_server.profileCount(), 0);
+    QCOMPARE(m_server.subscriberCount(iStreamId), 0);
+    QVERIFY(m_server.getClient(iClientId)->profileKey().isEmpty());
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::streamMerger()
+{
+    QList<qint32> qListStreamIds;
+    QVERIFY(!StreamMerger::parseStreamIds("1", qListStreamIds));
+    QVERIFY(!StreamMerger::parseStreamIds("0, 1", qListStreamIds));
+    QVERIFY(StreamMerger::parseStreamIds("1, 2, 1", qListStreamIds));
+    QCOMPARE(qListStreamIds, QList<qint32>() << 1 << 2);
+
+    //A MEG stream at 1 kHz is the reference, an EEG stream at 250 Hz is resampled to it
+    FiffInfo infoMeg;
+    infoMeg.sfreq = 1000.0f;
+    infoMeg.lowpass = 330.0f;
+    FiffInfo infoEeg;
+    infoEeg.sfreq = 250.0f;
+    infoEeg.lowpass = 100.0f;
+    QStringList qListMegNames = QStringList() << "MEG 0111" << "EEG 001";
+    for(int i = 0; i < qListMegNames.size(); ++i) {
+        FiffChInfo ch;
+        ch.ch_name = qListMegNames[i];
+        infoMeg.chs.append(ch);
+        infoMeg.ch_names.append(ch.ch_name);
+    }
+    FiffChInfo chEeg;
+    chEeg.ch_name = "EEG 001";
+    infoEeg.chs.append(chEeg);
+    infoEeg.ch_names.append(chEeg.ch_name);
+    infoMeg.nchan = infoMeg.chs.size();
+    infoEeg.nchan = infoEeg.chs.size();
+
+    StreamMerger merger(qListStreamIds);
+    merger.setMeasInfo(1, infoMeg);
+    QVERIFY(!merger.hasMeasInfo());
+    merger.setMeasInfo(2, infoEeg);
+    QVERIFY(merger.hasMeasInfo());
+
+    FiffInfo infoMerged = merger.mergedInfo();
+    QCOMPARE(infoMerged.nchan, 3);
+    QCOMPARE(infoMerged.sfreq, 1000.0f);
+    QCOMPARE(infoMerged.ch_names, QStringList() << "MEG 0111" << "EEG 001" << "EEG 001-2");
+    QCOMPARE(infoMerged.lowpass, 100.0f);
+
+    //Both streams start at 0 s, a buffer arrives when its last sample period ended. Every channel is a ramp of
+    //the sample time, the merged stream has to continue the ramp on its own time grid.
+    const int iMegSamples = 100;
+    const int iEegSamples = 25;
+    qint64 iMerged = 0;
+
+    for(int b = 0; b < 25; ++b) {
+        qint64 iArrivalNs = (qint64)(b + 1) * 100000000;
+
+        if(b < 10) {
+            MatrixXf matEeg(1, iEegSamples);
+            for(int j = 0; j < iEegSamples; ++j)
+                matEeg(0, j) = (b * iEegSamples + j) / 250.0f;
+            QVERIFY(merger.addBuffer(2, matEeg, iArrivalNs).isNull());
+        }
+
+        MatrixXf matMeg(2, iMegSamples);
+        for(int j = 0; j < iMegSamples; ++j) {
+            matMeg(0, j) = (b * iMegSamples + j) / 1000.0f;
+            matMeg(1, j) = 2.0f * matMeg(0, j);
+        }
+
+        QSharedPointer<MatrixXf> pMatMerged = merger.addBuffer(1, matMeg, iArrivalNs);
+        if(!pMatMerged)
+            continue;
+
+        QCOMPARE((int)pMatMerged->rows(), 3);
+        for(int j = 0; j < pMatMerged->cols(); ++j) {
+            float fTimeS = (iMerged + j) / 1000.0f;
+            QVERIFY(qAbs((*pMatMerged)(0, j) - fTimeS) < 1e-3f);
+            QVERIFY(qAbs((*pMatMerged)(1, j) - 2.0f * fTimeS) < 1e-3f);
+
+            //The EEG stream stops after 1 s, more than 1 s behind the reference it is left out
+            if(b < 10)
+                QVERIFY(qAbs((*pMatMerged)(2, j) - fTimeS) < 1e-3f);
+            else if(b >= 20)
+                QCOMPARE((*pMatMerged)(2, j), 0.0f);
+        }
+        iMerged += pMatMerged->cols();
+
+        //The slower stream bounds the released time
+        if(b == 9)
+            QVERIFY(iMerged >= 990 && iMerged <= 1000);
+    }
+
+    QCOMPARE(iMerged, (qint64)2500);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::streamMergerAntiAliasing()
+{
+    //The reference is an EEG stream at 250 Hz, a MEG stream at 1 kHz is merged down to 250 Hz
+    FiffInfo infoEeg;
+    infoEeg.sfreq = 250.0f;
+    infoEeg.lowpass = 125.0f;
+    FiffInfo infoMeg;
+    infoMeg.sfreq = 1000.0f;
+    infoMeg.lowpass = 330.0f;
+    QStringList qListNames = QStringList() << "MEG 0111" << "MEG 0112";
+    for(int i = 0; i < qListNames.size(); ++i) {
+        FiffChInfo ch;
+        ch.ch_name = qListNames[i];
+        infoMeg.chs.append(ch);
+        infoMeg.ch_names.append(ch.ch_name);
+    }
+    FiffChInfo chEeg;
+    chEeg.ch_name = "EEG 001";
+    infoEeg.chs.append(chEeg);
+    infoEeg.ch_names.append(chEeg.ch_name);
+    infoMeg.nchan = infoMeg.chs.size();
+    infoEeg.nchan = infoEeg.chs.size();
+
+    //Without a requested frequency the merged stream follows the reference
+    StreamMerger merger(QList<qint32>() << 1 << 2);
+    merger.setMeasInfo(1, infoEeg);
+    merger.setMeasInfo(2, infoMeg);
+    QCOMPARE(merger.samplingFrequency(), 250.0);
+    QCOMPARE(merger.mergedInfo().lowpass, 100.0f);
+
+    //A 200 Hz tone would alias to 50 Hz without the low pass, a 10 Hz tone has to pass
+    double dMaxAlias = 0.0;
+    double dMaxPass = 0.0;
+    qint64 iMerged = 0;
+
+    for(int b = 0; b < 30; ++b) {
+        qint64 iArrivalNs = (qint64)(b + 1) * 100000000;
+
+        MatrixXf matMeg(2, 100);
+        for(int j = 0; j < matMeg.cols(); ++j) {
+            double dTimeS = (b * 100 + j) / 1000.0;
+            matMeg(0, j) = (float)std::sin(2.0 * M_PI * 200.0 * dTimeS);
+            matMeg(1, j) = (float)std::sin(2.0 * M_PI * 10.0 * dTimeS);
+        }
+        QVERIFY(merger.addBuffer(2, matMeg, iArrivalNs).isNull());
+
+        QSharedPointer<MatrixXf> pMatMerged = merger.addBuffer(1, MatrixXf::Zero(1, 25), iArrivalNs);
+        if(!pMatMerged)
+            continue;
+
+        //The filter settles within the first second
+        for(int j = 0; j < pMatMerged->cols(); ++j) {
+            if(iMerged + j >= 250) {
+                dMaxAlias = qMax(dMaxAlias, (double)qAbs((*pMatMerged)(1, j)));
+                dMaxPass = qMax(dMaxPass, (double)qAbs((*pMatMerged)(2, j)));
+            }
+        }
+        iMerged += pMatMerged->cols();
+    }
+
+    QVERIFY(iMerged >= 700);
+    QVERIFY(dMaxAlias < 0.01);
+    QVERIFY(dMaxPass > 0.95 && dMaxPass < 1.05);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::disconnectClients()
+{
+    for(int i = 0; i < m_listClients.size(); ++i) {
+        m_listClients[i]->disconnectFromHost();
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(m_server.clientCount(), 0, 10000);
+}
+
+
+//*************************************************************************************************************
+
+void TestFiffStreamServer::cleanupTestCase()
+{
+    qDeleteAll(m_listClients);
+    m_listClients.clear();
+}
+
+
+//*************************************************************************************************************
+
+int TestFiffStreamServer::readClients(qint64 iExpectedBytes)
+{
+    int iComplete = 0;
+
+    for(int i = 0; i < m_listClients.size(); ++i) {
+        if(m_listClients[i]->bytesAvailable() > 0) {
+            m_vecReceived[i].append(m_listClients[i]->readAll());
+        }
+
+        if(m_vecReceived.at(i).size() >= iExpectedBytes) {
+            ++iComplete;
+        }
+    }
+
+    return iComplete;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestFiffStreamServer)
+#include "test_fiff_stream_server.moc"
@@ -0,0 +1,250 @@
+//=============================================================================================================
+/**
+* @file     test_hpi_demodulator.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Tests the continuous HPI amplitude demodulation.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <inverse/hpiFit/hpidemodulator.h>
+#include <utils/mnemath.h>
+
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace INVERSELIB;
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestHpiDemodulator
+*
+* @brief The TestHpiDemodulator class compares HPIDemodulator against the block least-squares fit used by
+* HPIFit::fitHPI and measures the throughput on a 306-channel 1 kHz stream.
+*
+*/
+class TestHpiDemodulator: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestHpiDemodulator();
+
+private slots:
+    void initTestCase();
+    void compareBlockFit();
+    void recoverAmplitudes();
+    void trackAmplitudeChange();
+    void benchmarkThroughput();
+    void cleanupTestCase();
+
+private:
+    MatrixXd simulate(const MatrixXd& matAmp, const VectorXd& vecPhase, qint64 iFirstSample, int iSamples) const;
+
+    double m_dSFreq;            /**< Sampling frequency of the simulated stream. */
+    int m_iChannels;            /**< Channels of the simulated stream. */
+    int m_iBlockSize;           /**< Samples per block of the simulated stream. */
+    QVector<int> m_vFreqs;      /**< The coil frequencies. */
+};
+
+
+//*************************************************************************************************************
+
+TestHpiDemodulator::TestHpiDemodulator()
+: m_dSFreq(1000.0)
+, m_iChannels(306)
+, m_iBlockSize(100)
+{
+    m_vFreqs << 155 << 165 << 190 << 220;
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiDemodulator::initTestCase()
+{
+    qDebug() << "Stream" << m_iChannels << "channels at" << m_dSFreq << "Hz in blocks of" << m_iBlockSize;
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiDemodulator::compareBlockFit()
+{
+    //Without forgetting the estimate equals the least-squares fit over all samples, independent of the blocking
+    int iSamples = 1000;
+    MatrixXd matData = MatrixXd::Random(7, iSamples);
+
+    HPIDemodulator demodulator(m_vFreqs, m_dSFreq, 1e12);
+    for(int i = 0; i < iSamples; i += 73) {
+        demodulator.append(matData.middleCols(i, qMin(73, iSamples - i)));
+    }
+
+    MatrixXd matBasis(iSamples, 2 * m_vFreqs.size());
+    for(int n = 0; n < iSamples; ++n) {
+        for(int i = 0; i < m_vFreqs.size(); ++i) {
+            matBasis(n, i) = std::sin(2.0 * M_PI * m_vFreqs.at(i) * n / m_dSFreq);
+            matBasis(n, m_vFreqs.size() + i) = std::cos(2.0 * M_PI * m_vFreqs.at(i) * n / m_dSFreq);
+        }
+    }
+    MatrixXd matRef = matData * MNEMath::pinv(matBasis).transpose();
+
+    QCOMPARE(demodulator.sampleCount(), (qint64)iSamples);
+    QVERIFY((demodulator.topographies() - matRef).norm() / matRef.norm() < 1e-6);
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiDemodulator::recoverAmplitudes()
+{
+    MatrixXd matAmp = MatrixXd::Random(m_iChannels, m_vFreqs.size());
+    VectorXd vecPhase = VectorXd::Random(m_vFreqs.size()) * M_PI;
+
+    HPIDemodulator demodulator(m_vFreqs, m_dSFreq);
+    for(int i = 0; i < 10; ++i) {
+        demodulator.append(simulate(matAmp, vecPhase, i * m_iBlockSize, m_iBlockSize));
+    }
+
+    QVERIFY(demodulator.isValid());
+
+    //The in-phase amplitude is only defined up to the sign
+    MatrixXd matEstimate = demodulator.amplitudes();
+    for(int i = 0; i < m_vFreqs.size(); ++i) {
+        double dSign = matEstimate.col(i).dot(matAmp.col(i)) > 0.0 ? 1.0 : -1.0;
+        QVERIFY((dSign * matEstimate.col(i) - matAmp.col(i)).norm() / matAmp.col(i).norm() < 1e-8);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiDemodulator::trackAmplitudeChange()
+{
+    MatrixXd matAmp = MatrixXd::Random(m_iChannels, m_vFreqs.size());
+    VectorXd vecPhase = VectorXd::Zero(m_vFreqs.size());
+
+    HPIDemodulator demodulator(m_vFreqs, m_dSFreq, 0.1);
+    qint64 iSample = 0;
+    for(int i = 0; i < 20; ++i, iSample += m_iBlockSize) {
+        demodulator.append(simulate(matAmp, vecPhase, iSample, m_iBlockSize));
+    }
+
+    //After ten time constants the old amplitudes are forgotten
+    for(int i = 0; i < 10; ++i, iSample += m_iBlockSize) {
+        demodulator.append(simulate(2.0 * matAmp, vecPhase, iSample, m_iBlockSize));
+    }
+
+    MatrixXd matEstimate = demodulator.amplitudes();
+    for(int i = 0; i < m_vFreqs.size(); ++i) {
+        double dSign = matEstimate.col(i).dot(matAmp.col(i)) > 0.0 ? 1.0 : -1.0;
+        QVERIFY((dSign * matEstimate.col(i) - 2.0 * matAmp.col(i)).norm() / matAmp.col(i).norm() < 1e-3);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiDemodulator::benchmarkThroughput()
+{
+    int iNumBlocks = 3000;
+    MatrixXd matBlock = MatrixXd::Random(m_iChannels, m_iBlockSize);
+
+    HPIDemodulator demodulator(m_vFreqs, m_dSFreq);
+
+    QElapsedTimer timer;
+    timer.start();
+    for(int i = 0; i < iNumBlocks; ++i) {
+        demodulator.append(matBlock);
+    }
+    qint64 iElapsed = qMax(timer.elapsed(), (qint64)1);
+
+    double dSamplesPerSec = 1000.0 * iNumBlocks * m_iBlockSize / iElapsed;
+
+    qDebug() << "HPIDemodulator" << m_vFreqs.size() << "coils :" << iElapsed << "ms,"
+             << dSamplesPerSec << "samples/s (" << dSamplesPerSec / m_dSFreq << "x real-time)";
+
+    QVERIFY(dSamplesPerSec > m_dSFreq);
+}
+
+
+//*************************************************************************************************************
+
+void TestHpiDemodulator::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestHpiDemodulator::simulate(const MatrixXd& matAmp, const VectorXd& vecPhase, qint64 iFirstSample, int iSamples) const
+{
+    MatrixXd matData = MatrixXd::Zero(matAmp.rows(), iSamples);
+
+    for(int n = 0; n < iSamples; ++n) {
+        double dTime = (iFirstSample + n) / m_dSFreq;
+
+        for(int i = 0; i < m_vFreqs.size(); ++i) {
+            matData.col(n) += matAmp.col(i) * std::sin(2.0 * M_PI * m_vFreqs.at(i) * dTime + vecPhase[i]);
+        }
+    }
+
+    return matData;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestHpiDemodulator)
+#include "test_hpi_demodulator.moc"
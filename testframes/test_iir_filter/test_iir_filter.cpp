@@ -0,0 +1,348 @@
+//=============================================================================================================
+/**
+* @file     test_iir_filter.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Checks the IIRFilter designs against reference coefficients and its causal and zero-phase filtering
+*
+*/
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/filterTools/iirfilter.h>
+
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestIIRFilter
+*
+* @brief The TestIIRFilter class compares the IIRFilter designs with reference transfer functions (as computed by
+* scipy.signal.butter and scipy.signal.cheby1) and checks causal block-wise and zero-phase filtering.
+*
+*/
+class TestIIRFilter: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestIIRFilter();
+
+private slots:
+    void initTestCase();
+    void designButterworth();
+    void designChebyshev();
+    void designInvalid();
+    void zeroPhaseNoLag();
+    void zeroPhaseUnnormalized();
+    void blockwiseEqualsOneShot();
+    void cleanupTestCase();
+
+private:
+    bool compareDesign(FilterData::DesignMethod designMethod,
+                       FilterData::FilterType type,
+                       int iOrder,
+                       double dCenterFreq,
+                       double dBandwidth,
+                       double dRipple,
+                       const RowVectorXd& vecB,
+                       const RowVectorXd& vecA) const;
+
+    RowVectorXd convolve(const RowVectorXd& vecA, const RowVectorXd& vecB) const;
+
+    double epsilon;
+};
+
+
+//*************************************************************************************************************
+
+TestIIRFilter::TestIIRFilter()
+: epsilon(0.000000001)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestIIRFilter::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+}
+
+
+//*************************************************************************************************************
+
+RowVectorXd TestIIRFilter::convolve(const RowVectorXd& vecA, const RowVectorXd& vecB) const
+{
+    RowVectorXd vecConv = RowVectorXd::Zero(vecA.cols() + vecB.cols() - 1);
+    for(int k = 0; k < vecB.cols(); ++k) {
+        vecConv.segment(k, vecA.cols()) += vecB[k] * vecA;
+    }
+    return vecConv;
+}
+
+
+//*************************************************************************************************************
+
+bool TestIIRFilter::compareDesign(FilterData::DesignMethod designMethod,
+                                  FilterData::FilterType type,
+                                  int iOrder,
+                                  double dCenterFreq,
+                                  double dBandwidth,
+                                  double dRipple,
+                                  const RowVectorXd& vecB,
+                                  const RowVectorXd& vecA) const
+{
+    MatrixXd matSOS = IIRFilter::designSOS(designMethod, type, iOrder, dCenterFreq, dBandwidth, dRipple);
+
+    if(matSOS.rows() == 0) {
+        return false;
+    }
+
+    //Multiply out the sections to the transfer function b(z)/a(z)
+    RowVectorXd vecNum = RowVectorXd::Ones(1);
+    RowVectorXd vecDen = RowVectorXd::Ones(1);
+    for(int s = 0; s < matSOS.rows(); ++s) {
+        vecNum = convolve(vecNum, matSOS.block(s, 0, 1, 3));
+        vecDen = convolve(vecDen, matSOS.block(s, 3, 1, 3));
+    }
+
+    //Sections with a first order pole and zero carry trailing zero coefficients
+    vecNum /= vecDen[0];
+    vecDen /= vecDen[0];
+    vecNum.conservativeResize(vecB.cols());
+    vecDen.conservativeResize(vecA.cols());
+
+    return (vecNum - vecB).cwiseAbs().maxCoeff() < epsilon && (vecDen - vecA).cwiseAbs().maxCoeff() < epsilon;
+}
+
+
+//*************************************************************************************************************
+
+void TestIIRFilter::designButterworth()
+{
+    RowVectorXd vecB, vecA;
+
+    vecB.resize(5); vecA.resize(5);
+    vecB << 0.004824343357716228, 0.019297373430864913, 0.02894606014629737, 0.019297373430864913, 0.004824343357716228;
+    vecA << 1.0, -2.369513007182038, 2.313988414415881, -1.054665405878568, 0.18737949236818502;
+    QVERIFY(compareDesign(FilterData::Butterworth, FilterData::LPF, 4, 0.2, 0.0, 1.0, vecB, vecA));
+
+    vecB << 0.2754132880723043, -1.1016531522892172, 1.6524797284338257, -1.1016531522892172, 0.2754132880723043;
+    vecA << 1.0, -1.570398851228172, 1.2756133249832797, -0.4844033683350857, 0.07619706461033242;
+    QVERIFY(compareDesign(FilterData::Butterworth, FilterData::HPF, 4, 0.3, 0.0, 1.0, vecB, vecA));
+
+    vecB << 0.06745527388907191, 0.0, -0.13491054777814382, 0.0, 0.06745527388907191;
+    vecA << 1.0, -1.942468776547884, 2.119202397144283, -1.216651635515531, 0.41280159809618855;
+    QVERIFY(compareDesign(FilterData::Butterworth, FilterData::BPF, 2, 0.3, 0.2, 1.0, vecB, vecA));
+
+    vecB << 0.8005924034645702, 0.0, 1.6011848069291403, 0.0, 0.8005924034645702;
+    vecA << 1.0, 0.0, 1.5610180758007177, 0.0, 0.6413515380575626;
+    QVERIFY(compareDesign(FilterData::Butterworth, FilterData::NOTCH, 2, 0.5, 0.1, 1.0, vecB, vecA));
+}
+
+
+//*************************************************************************************************************
+
+void TestIIRFilter::designChebyshev()
+{
+    RowVectorXd vecB, vecA;
+
+    vecB.resize(5); vecA.resize(5);
+    vecB << 0.0018355503720108213, 0.007342201488043285, 0.011013302232064927, 0.007342201488043285, 0.0018355503720108213;
+    vecA << 1.0, -3.0543396764069546, 3.8289992274914573, -2.292451729406226, 0.5507445205808748;
+    QVERIFY(compareDesign(FilterData::Chebyshev, FilterData::LPF, 4, 0.2, 0.0, 1.0, vecB, vecA));
+
+    vecB << 0.07042245757250018, 0.0, -0.14084491514500036, 0.0, 0.07042245757250018;
+    vecA << 1.0, -1.9775094901895591, 2.236874310508627, -1.3789296739554253, 0.5157387561767525;
+    QVERIFY(compareDesign(FilterData::Chebyshev, FilterData::BPF, 2, 0.3, 0.2, 1.0, vecB, vecA));
+
+    vecB << 0.7550085035382538, 0.0, 1.5100170070765075, 0.0, 0.7550085035382538;
+    vecA << 1.0, 0.0, 1.6557169643711134, 0.0, 0.7328169321282065;
+    QVERIFY(compareDesign(FilterData::Chebyshev, FilterData::NOTCH, 2, 0.5, 0.1, 1.0, vecB, vecA));
+
+    //Odd order, which does not start at the bottom of the ripple
+    vecB.resize(4); vecA.resize(4);
+    vecB << 0.32511500961822504, -0.9753450288546751, 0.9753450288546751, -0.32511500961822504;
+    vecA << 1.0, -0.9605012851946955, 0.6506002444529313, 0.010181452701825546;
+    QVERIFY(compareDesign(FilterData::Chebyshev, FilterData::HPF, 3, 0.3, 0.0, 1.0, vecB, vecA));
+
+    //Ripple other than the default
+    vecB.resize(6); vecA.resize(6);
+    vecB << 0.0011272073186843743, 0.005636036593421871, 0.011272073186843742, 0.011272073186843742, 0.005636036593421871, 0.0011272073186843743;
+    vecA << 1.0, -3.4198272430147805, 5.263083698083775, -4.429172158516646, 2.0217044249190903, -0.3997180872735384;
+    QVERIFY(compareDesign(FilterData::Chebyshev, FilterData::LPF, 5, 0.25, 0.0, 0.5, vecB, vecA));
+}
+
+
+//*************************************************************************************************************
+
+void TestIIRFilter::designInvalid()
+{
+    QCOMPARE((int)IIRFilter::designSOS(FilterData::Cosine, FilterData::LPF, 4, 0.2, 0.0).rows(), 0);
+    QCOMPARE((int)IIRFilter::designSOS(FilterData::Butterworth, FilterData::LPF, 0, 0.2, 0.0).rows(), 0);
+    QCOMPARE((int)IIRFilter::designSOS(FilterData::Butterworth, FilterData::LPF, 4, 1.0, 0.0).rows(), 0);
+    QCOMPARE((int)IIRFilter::designSOS(FilterData::Butterworth, FilterData::BPF, 4, 0.1, 0.3).rows(), 0);
+}
+
+
+//*************************************************************************************************************
+
+void TestIIRFilter::zeroPhaseNoLag()
+{
+    MatrixXd matSOS = IIRFilter::designSOS(FilterData::Butterworth, FilterData::LPF, 4, 0.2, 0.0);
+
+    //Sinusoid in the pass band, where a causal filter of this order delays by several samples
+    int iSamples = 2000;
+    double dOmega = M_PI * 0.05;
+    MatrixXd matData(2, iSamples);
+    for(int t = 0; t < iSamples; ++t) {
+        matData(0,t) = std::sin(dOmega * t);
+        matData(1,t) = std::cos(dOmega * t);
+    }
+
+    MatrixXd matZeroPhase = IIRFilter::filterZeroPhase(matSOS, matData);
+
+    QCOMPARE((int)matZeroPhase.rows(), (int)matData.rows());
+    QCOMPARE((int)matZeroPhase.cols(), (int)matData.cols());
+
+    //Away from the edges the output is the input scaled by |H|^2 without any phase shift
+    double dGain = std::norm(IIRFilter::frequencyResponse(matSOS, 40)[1]);
+    MatrixXd matInner = matZeroPhase.middleCols(200, iSamples - 400);
+    QVERIFY((matInner - dGain * matData.middleCols(200, iSamples - 400)).cwiseAbs().maxCoeff() < 0.000001);
+
+    //The causal filter on its own does lag, i.e. the check above is not trivially met
+    IIRFilter filter(matSOS);
+    MatrixXd matCausal;
+    filter.filter(matData, matCausal);
+    QVERIFY((matCausal.middleCols(200, iSamples - 400) - matData.middleCols(200, iSamples - 400)).cwiseAbs().maxCoeff() > 0.1);
+}
+
+
+//*************************************************************************************************************
+
+void TestIIRFilter::zeroPhaseUnnormalized()
+{
+    std::srand(7);
+
+    MatrixXd matSOS = IIRFilter::designSOS(FilterData::Butterworth, FilterData::HPF, 4, 0.1, 0.0);
+    MatrixXd matData = MatrixXd::Random(3, 500).array() + 1.0;
+
+    //Sections with a0 != 1 describe the same filter
+    MatrixXd matSOSScaled = matSOS;
+    for(int s = 0; s < matSOSScaled.rows(); ++s) {
+        matSOSScaled.row(s) *= 0.5 + 1.5 * s;
+    }
+
+    MatrixXd matZeroPhase = IIRFilter::filterZeroPhase(matSOS, matData);
+    MatrixXd matZeroPhaseScaled = IIRFilter::filterZeroPhase(matSOSScaled, matData);
+
+    QVERIFY((matZeroPhaseScaled - matZeroPhase).cwiseAbs().maxCoeff() < 0.000001);
+}
+
+
+//*************************************************************************************************************
+
+void TestIIRFilter::blockwiseEqualsOneShot()
+{
+    std::srand(42);
+
+    MatrixXd matSOS = IIRFilter::designSOS(FilterData::Chebyshev, FilterData::BPF, 3, 0.3, 0.2);
+    MatrixXd matData = MatrixXd::Random(7, 3000);
+
+    IIRFilter filterOneShot(matSOS);
+    MatrixXd matOneShot;
+    filterOneShot.filter(matData, matOneShot);
+
+    //Block sizes which do not divide the signal length, including a single sample block
+    int vecBlockSizes[] = {1, 97, 256, 13, 1000};
+
+    IIRFilter filterBlocks(matSOS);
+    MatrixXd matBlocks(matData.rows(), matData.cols());
+    MatrixXd matBlockOut;
+
+    int iCol = 0;
+    for(int i = 0; iCol < matData.cols(); ++i) {
+        int iCols = qMin(vecBlockSizes[i % 5], (int)matData.cols() - iCol);
+        filterBlocks.filter(matData.middleCols(iCol, iCols), matBlockOut);
+        matBlocks.middleCols(iCol, iCols) = matBlockOut;
+        iCol += iCols;
+    }
+
+    QVERIFY((matBlocks - matOneShot).cwiseAbs().maxCoeff() < epsilon);
+
+    //After a reset the stream starts over
+    filterBlocks.reset();
+    filterBlocks.filter(matData, matBlockOut);
+    QVERIFY((matBlockOut - matOneShot).cwiseAbs().maxCoeff() < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestIIRFilter::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestIIRFilter)
+#include "test_iir_filter.moc"
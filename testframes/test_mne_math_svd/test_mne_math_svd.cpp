@@ -0,0 +1,223 @@
+//=============================================================================================================
+/**
+* @file     test_mne_math_svd.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Accuracy check and benchmark of the Gram matrix based SVD against JacobiSVD and BDCSVD
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/mnemath.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/SVD>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestMneMathSvd
+*
+* @brief The TestMneMathSvd class verifies MNEMath::gram_svd against JacobiSVD and benchmarks both.
+*
+*/
+class TestMneMathSvd: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestMneMathSvd();
+
+private slots:
+    void initTestCase();
+    void compareWide();
+    void compareTall();
+    void compareRankDeficient();
+    void benchmarkGramSvd();
+    void benchmarkBDCSvd();
+    void benchmarkJacobiSvd();
+    void cleanupTestCase();
+
+private:
+    void compare(const MatrixXd& A);
+
+    double epsilon;
+
+    MatrixXd m_matGain;     /**< Whitened gain shaped test matrix (channels x 3*sources). */
+};
+
+
+//*************************************************************************************************************
+
+TestMneMathSvd::TestMneMathSvd()
+: epsilon(0.000001)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestMneMathSvd::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+
+    std::srand(42);
+    m_matGain = MatrixXd::Random(306, 3*2000);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneMathSvd::compare(const MatrixXd& A)
+{
+    VectorXd s;
+    MatrixXd U, V;
+    QVERIFY(MNEMath::gram_svd(A, s, U, V));
+
+    JacobiSVD<MatrixXd> t_svd(A);
+
+    //Singular values relative to the largest one
+    QVERIFY((s - t_svd.singularValues()).cwiseAbs().maxCoeff() / s[0] < epsilon);
+
+    //Reconstruction
+    MatrixXd matRec = U * s.asDiagonal() * V.transpose();
+    QVERIFY((matRec - A).norm() / A.norm() < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneMathSvd::compareWide()
+{
+    compare(m_matGain);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneMathSvd::compareTall()
+{
+    //Shape of a gain matrix pair used by RAP MUSIC
+    compare(m_matGain.leftCols(6));
+}
+
+
+//*************************************************************************************************************
+
+void TestMneMathSvd::compareRankDeficient()
+{
+    //Project out three directions like an SSP operator does
+    MatrixXd matProjVec = MatrixXd::Random(m_matGain.rows(), 3);
+    HouseholderQR<MatrixXd> qr(matProjVec);
+    MatrixXd matQ = qr.householderQ() * MatrixXd::Identity(m_matGain.rows(), 3);
+    MatrixXd matProj = MatrixXd::Identity(m_matGain.rows(), m_matGain.rows()) - matQ * matQ.transpose();
+
+    MatrixXd A = matProj * m_matGain;
+
+    VectorXd s;
+    MatrixXd U, V;
+    QVERIFY(MNEMath::gram_svd(A, s, U, V));
+    QVERIFY(s.tail(3).isZero());
+
+    compare(A);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneMathSvd::benchmarkGramSvd()
+{
+    VectorXd s;
+    MatrixXd U, V;
+    QBENCHMARK {
+        MNEMath::gram_svd(m_matGain, s, U, V);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMneMathSvd::benchmarkBDCSvd()
+{
+    QBENCHMARK {
+        BDCSVD<MatrixXd> t_svd(m_matGain, ComputeThinU | ComputeThinV);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMneMathSvd::benchmarkJacobiSvd()
+{
+    QBENCHMARK_ONCE {
+        JacobiSVD<MatrixXd> t_svd(m_matGain, ComputeThinU | ComputeThinV);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMneMathSvd::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestMneMathSvd)
+#include "test_mne_math_svd.moc"
@@ -0,0 +1,230 @@
+//=============================================================================================================
+/**
+* @file     test_overlap_save_filter.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Checks block-wise OverlapSaveFilter output against a direct convolution
+*
+*/
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/filterTools/overlapsavefilter.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestOverlapSaveFilter
+*
+* @brief The TestOverlapSaveFilter class streams data block-wise through OverlapSaveFilter and compares the
+* output with the direct convolution of the whole signal.
+*
+*/
+class TestOverlapSaveFilter: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestOverlapSaveFilter();
+
+private slots:
+    void initTestCase();
+    void compareAlignedBlocks();
+    void compareUnalignedBlocks();
+    void compareShortBlocks();
+    void compareVaryingBlocks();
+    void compareReset();
+    void cleanupTestCase();
+
+private:
+    void compareBlocks(const QList<int>& qListBlockSizes);
+    MatrixXd filterBlocks(OverlapSaveFilter& filter, const QList<int>& qListBlockSizes) const;
+
+    double epsilon;
+
+    RowVectorXd m_vecCoeffs;        /**< FIR coefficients. */
+    MatrixXd    m_matData;          /**< Input signal, channels x samples. */
+    MatrixXd    m_matReference;     /**< Direct convolution of m_matData with m_vecCoeffs. */
+};
+
+
+//*************************************************************************************************************
+
+TestOverlapSaveFilter::TestOverlapSaveFilter()
+: epsilon(0.000000001)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestOverlapSaveFilter::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+
+    std::srand(42);
+
+    //Odd channel count larger than one chunk, so unpaired channels and concurrent chunks are covered
+    m_vecCoeffs = RowVectorXd::Random(101);
+    m_matData = MatrixXd::Random(37, 3000);
+
+    //Causal convolution, the signal is zero before the first sample
+    m_matReference = MatrixXd::Zero(m_matData.rows(), m_matData.cols());
+    for(int n = 0; n < m_matData.cols(); ++n) {
+        for(int k = 0; k < m_vecCoeffs.cols() && k <= n; ++k) {
+            m_matReference.col(n) += m_vecCoeffs[k] * m_matData.col(n - k);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestOverlapSaveFilter::filterBlocks(OverlapSaveFilter& filter, const QList<int>& qListBlockSizes) const
+{
+    MatrixXd matOut(m_matData.rows(), m_matData.cols());
+    MatrixXd matBlockOut;
+
+    //Cycle through the block sizes until the signal is used up
+    int iCol = 0;
+    for(int i = 0; iCol < m_matData.cols(); ++i) {
+        int iCols = qMin(qListBlockSizes[i % qListBlockSizes.size()], (int)m_matData.cols() - iCol);
+        filter.filter(m_matData.middleCols(iCol, iCols), matBlockOut);
+        matOut.middleCols(iCol, iCols) = matBlockOut;
+        iCol += iCols;
+    }
+
+    return matOut;
+}
+
+
+//*************************************************************************************************************
+
+void TestOverlapSaveFilter::compareBlocks(const QList<int>& qListBlockSizes)
+{
+    OverlapSaveFilter filter(m_vecCoeffs);
+
+    MatrixXd matOut = filterBlocks(filter, qListBlockSizes);
+
+    QVERIFY(filter.fftLength() > 0);
+    QVERIFY((matOut - m_matReference).cwiseAbs().maxCoeff() < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestOverlapSaveFilter::compareAlignedBlocks()
+{
+    //156 + 100 history samples fill an FFT of 256 exactly
+    compareBlocks(QList<int>() << 156);
+}
+
+
+//*************************************************************************************************************
+
+void TestOverlapSaveFilter::compareUnalignedBlocks()
+{
+    compareBlocks(QList<int>() << 333);
+    compareBlocks(QList<int>() << 1000);
+}
+
+
+//*************************************************************************************************************
+
+void TestOverlapSaveFilter::compareShortBlocks()
+{
+    //Blocks shorter than the filter history
+    compareBlocks(QList<int>() << 37);
+}
+
+
+//*************************************************************************************************************
+
+void TestOverlapSaveFilter::compareVaryingBlocks()
+{
+    //The FFT length is chosen for the first block, later ones are larger, smaller and shorter than the history
+    compareBlocks(QList<int>() << 200 << 517 << 1 << 64 << 99 << 1200);
+}
+
+
+//*************************************************************************************************************
+
+void TestOverlapSaveFilter::compareReset()
+{
+    OverlapSaveFilter filter(m_vecCoeffs);
+
+    filterBlocks(filter, QList<int>() << 250);
+    filter.reset();
+
+    MatrixXd matOut = filterBlocks(filter, QList<int>() << 250);
+    QVERIFY((matOut - m_matReference).cwiseAbs().maxCoeff() < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestOverlapSaveFilter::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestOverlapSaveFilter)
+#include "test_overlap_save_filter.moc"
@@ -0,0 +1,548 @@
+//=============================================================================================================
+/**
+* @file     test_rap_music.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Checks the sliding window signal subspace and the sharded Powell scan of RAP MUSIC
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <inverse/rapMusic/signalsubspacetracker.h>
+#include <inverse/rapMusic/pwlrapmusic.h>
+#include <inverse/rapMusic/pwlrapmusicshard.h>
+#include <inverse/rapMusic/pwlrapmusicshardserver.h>
+
+#include <fiff/fiff_evoked.h>
+#include <mne/mne_forwardsolution.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QSemaphore>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/SVD>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace INVERSELIB;
+using namespace MNELIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS ShardWorker
+*
+* @brief The ShardWorker class runs a PwlRapMusicShardServer with its own event loop, like a worker process.
+*/
+class ShardWorker : public QThread
+{
+public:
+    ShardWorker(const PwlRapMusic &p_pwlRapMusic)
+    : m_pwlRapMusic(p_pwlRapMusic)
+    , m_iPort(0)
+    {
+    }
+
+    //Blocks until the server listens
+    quint16 waitForPort()
+    {
+        m_semListening.acquire();
+        return m_iPort;
+    }
+
+protected:
+    void run()
+    {
+        PwlRapMusicShardServer t_server(m_pwlRapMusic);
+        t_server.listen(QHostAddress::LocalHost, 0);
+        m_iPort = t_server.serverPort();
+        m_semListening.release();
+
+        exec();
+    }
+
+private:
+    const PwlRapMusic &m_pwlRapMusic;   /**< The shared algorithm, the scan is const. */
+    quint16 m_iPort;                    /**< The port of the server, 0 if listening failed. */
+    QSemaphore m_semListening;          /**< Released when the server listens. */
+};
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS StallingWorker
+*
+* @brief The StallingWorker class accepts every shard but never replies to a Powell row, like a hung worker.
+*/
+class StallingWorker : public QThread
+{
+public:
+    StallingWorker()
+    : m_iPort(0)
+    {
+    }
+
+    //Blocks until the server listens
+    quint16 waitForPort()
+    {
+        m_semListening.acquire();
+        return m_iPort;
+    }
+
+protected:
+    void run()
+    {
+        QTcpServer t_server;
+        QTcpSocket* t_pSocket = 0;
+        QByteArray t_buffer;
+
+        connect(&t_server, &QTcpServer::newConnection, [&]() {
+            t_pSocket = t_server.nextPendingConnection();
+            connect(t_pSocket, &QTcpSocket::readyRead, [&]() {
+                t_buffer.append(t_pSocket->readAll());
+                QByteArray t_payload;
+                while(PwlRapMusicShard::takeFrame(t_buffer, t_payload)) {
+                    QDataStream t_in(t_payload);
+                    qint32 t_iCmd = 0;
+                    t_in >> t_iCmd;
+                    if(t_iCmd == PWL_SHARD_HELLO) {
+                        QByteArray t_reply;
+                        QDataStream t_out(&t_reply, QIODevice::WriteOnly);
+                        t_out << (qint32)PWL_SHARD_HELLO_ACK << true;
+                        PwlRapMusicShard::writeFrame(t_pSocket, t_reply);
+                    }
+                }
+            });
+        });
+
+        t_server.listen(QHostAddress::LocalHost, 0);
+        m_iPort = t_server.serverPort();
+        m_semListening.release();
+
+        exec();
+    }
+
+private:
+    quint16 m_iPort;                    /**< The port of the server, 0 if listening failed. */
+    QSemaphore m_semListening;          /**< Released when the server listens. */
+};
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestRapMusic
+*
+* @brief The TestRapMusic class streams blocks through the SignalSubspaceTracker and compares the tracked signal
+* subspace with the SVD of the same window after samples entered and left it. The sharded Powell scan has to find
+* the same dipole pairs as the scan in this process.
+*
+*/
+class TestRapMusic: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRapMusic();
+
+private slots:
+    void initTestCase();
+    void trackLongWindow();
+    void trackShortWindow();
+    void trackLongBlock();
+    void shardMatrixFrames();
+    void shardedScan();
+    void shardStalledWorker();
+    void batchKeepsIncrementalState();
+    void cleanupTestCase();
+
+private:
+    void track(int p_iWindowSize, int p_iBlockSize);
+    void compareWindow(const SignalSubspaceTracker& p_tracker, const MatrixXd& p_matWindow);
+
+    double epsilon;
+
+    int m_iNumChannels;     /**< Number of channels. */
+    int m_iNumSources;      /**< Rank of the simulated data. */
+    MatrixXd m_matData;     /**< Simulated data (channels x samples). */
+};
+
+
+//*************************************************************************************************************
+
+TestRapMusic::TestRapMusic()
+: epsilon(0.000001)
+, m_iNumChannels(30)
+, m_iNumSources(4)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::initTestCase()
+{
+    std::srand(42);
+
+    //Fixed topographies with random time courses -> rank m_iNumSources
+    MatrixXd matTopo = MatrixXd::Random(m_iNumChannels, m_iNumSources);
+    m_matData = matTopo * MatrixXd::Random(m_iNumSources, 500);
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::compareWindow(const SignalSubspaceTracker& p_tracker, const MatrixXd& p_matWindow)
+{
+    MatrixXd matPhi_s;
+    int iRank = p_tracker.calcPhi_s(matPhi_s);
+
+    QCOMPARE(iRank, m_iNumSources);
+    QCOMPARE(matPhi_s.rows(), (Index)m_iNumChannels);
+    QCOMPARE(matPhi_s.cols(), (Index)m_iNumSources);
+
+    //Fresh decomposition of the same window
+    JacobiSVD<MatrixXd> t_svd(p_matWindow, ComputeThinU);
+    MatrixXd matU = t_svd.matrixU().leftCols(m_iNumSources);
+
+    //The bases may differ in sign and rotation, the projectors onto the subspaces must agree
+    MatrixXd matProjTracked = matPhi_s * matPhi_s.transpose();
+    MatrixXd matProjFresh = matU * matU.transpose();
+    QVERIFY((matProjTracked - matProjFresh).norm() < epsilon);
+
+    //The accumulated F*F^T matches the window
+    MatrixXd matFFT = p_matWindow * p_matWindow.transpose();
+    MatrixXd matTracked = p_tracker.getFFT().selfadjointView<Lower>();
+    QVERIFY((matTracked - matFFT).norm() / matFFT.norm() < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::track(int p_iWindowSize, int p_iBlockSize)
+{
+    SignalSubspaceTracker t_tracker(m_iNumChannels, p_iWindowSize);
+
+    int iNumSamples = 0;
+    for(int i = 0; i + p_iBlockSize <= m_matData.cols(); i += p_iBlockSize) {
+        t_tracker.append(m_matData.middleCols(i, p_iBlockSize));
+        iNumSamples = i + p_iBlockSize;
+
+        //The window holds the last samples, earlier ones left it
+        int iWindow = std::min(iNumSamples, p_iWindowSize);
+        QCOMPARE(t_tracker.numSamples(), iWindow);
+        if(iWindow >= m_iNumSources)
+            compareWindow(t_tracker, m_matData.middleCols(iNumSamples - iWindow, iWindow));
+    }
+
+    //Several turns of the ring buffer, i.e. samples left the window and the sums were refreshed
+    QVERIFY(iNumSamples > 2*p_iWindowSize);
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::trackLongWindow()
+{
+    //More samples than channels, the block length does not divide the window
+    track(100, 7);
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::trackShortWindow()
+{
+    //Fewer samples than channels
+    track(20, 3);
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::trackLongBlock()
+{
+    //Blocks longer than the window replace it
+    track(40, 60);
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::shardMatrixFrames()
+{
+    MatrixXd matSent = MatrixXd::Random(12, 5);
+
+    QByteArray t_payload;
+    QDataStream t_out(&t_payload, QIODevice::WriteOnly);
+    PwlRapMusicShard::writeMatrix(t_out, matSent);
+
+    //Frames are taken only when complete
+    QByteArray t_buffer;
+    t_buffer.append(char(0)).append(char(0)).append(char(t_payload.size() >> 8)).append(char(t_payload.size() & 0xFF));
+    t_buffer.append(t_payload.left(10));
+
+    QByteArray t_frame;
+    QVERIFY(!PwlRapMusicShard::takeFrame(t_buffer, t_frame));
+    t_buffer.append(t_payload.mid(10));
+    QVERIFY(PwlRapMusicShard::takeFrame(t_buffer, t_frame));
+    QVERIFY(t_buffer.isEmpty());
+
+    MatrixXd matReceived;
+    QDataStream t_in(t_frame);
+    QVERIFY(PwlRapMusicShard::readMatrix(t_in, matReceived));
+    QVERIFY(matReceived == matSent);
+
+    //A truncated payload is rejected before the matrix is allocated
+    QDataStream t_inTruncated(t_payload.left(t_payload.size() - 8));
+    QVERIFY(!PwlRapMusicShard::readMatrix(t_inTruncated, matReceived));
+    QCOMPARE(matReceived.size(), (Index)0);
+
+    //Dimensions beyond the limit are rejected, even if they would fit into the payload
+    QByteArray t_payloadHuge;
+    QDataStream t_outHuge(&t_payloadHuge, QIODevice::WriteOnly);
+    t_outHuge << (qint32)0x10000 << (qint32)0x10000;
+    QDataStream t_inHuge(t_payloadHuge);
+    QVERIFY(!PwlRapMusicShard::readMatrix(t_inHuge, matReceived));
+
+    QByteArray t_payloadNegative;
+    QDataStream t_outNegative(&t_payloadNegative, QIODevice::WriteOnly);
+    t_outNegative << (qint32)-1 << (qint32)4;
+    QDataStream t_inNegative(t_payloadNegative);
+    QVERIFY(!PwlRapMusicShard::readMatrix(t_inNegative, matReceived));
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::shardedScan()
+{
+    QFile t_fileFwd(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis-meg-eeg-oct-6-fwd.fif");
+    QVERIFY(t_fileFwd.exists());
+    MNEForwardSolution t_Fwd(t_fileFwd);
+    QVERIFY(!t_Fwd.isEmpty());
+
+    QFile t_fileEvoked(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif");
+    QVERIFY(t_fileEvoked.exists());
+    QPair<QVariant, QVariant> baseline(QVariant(), 0);
+    FiffEvoked t_evoked(t_fileEvoked, 0, baseline);
+    QVERIFY(!t_evoked.isEmpty());
+    FiffEvoked t_pickedEvoked = t_evoked.pick_channels(t_Fwd.info.ch_names);
+
+    //Two workers in this process, each with its own event loop
+    PwlRapMusic t_pwlRapMusicWorker(t_Fwd, false, 2);
+    QList<ShardWorker*> t_qListWorkers;
+    QStringList t_qListAddresses;
+    for(int i = 0; i < 2; ++i) {
+        ShardWorker* t_pWorker = new ShardWorker(t_pwlRapMusicWorker);
+        t_pWorker->start();
+        quint16 t_iPort = t_pWorker->waitForPort();
+        QVERIFY(t_iPort != 0);
+        t_qListWorkers.append(t_pWorker);
+        t_qListAddresses.append(QString("127.0.0.1:%1").arg(t_iPort));
+    }
+
+    PwlRapMusic t_pwlRapMusic(t_Fwd, false, 2);
+    QVERIFY(t_pwlRapMusic.connectShards(t_qListAddresses));
+
+    QList< DipolePair<double> > t_RapDipolesSharded;
+    t_pwlRapMusic.calculateInverse(t_pickedEvoked.data, t_RapDipolesSharded);
+
+    t_pwlRapMusic.clearShards();
+
+    QList< DipolePair<double> > t_RapDipolesLocal;
+    t_pwlRapMusic.calculateInverse(t_pickedEvoked.data, t_RapDipolesLocal);
+
+    for(int i = 0; i < t_qListWorkers.size(); ++i) {
+        t_qListWorkers[i]->quit();
+        t_qListWorkers[i]->wait();
+        delete t_qListWorkers[i];
+    }
+
+    QVERIFY(!t_RapDipolesLocal.isEmpty());
+    QCOMPARE(t_RapDipolesSharded.size(), t_RapDipolesLocal.size());
+    for(int i = 0; i < t_RapDipolesLocal.size(); ++i) {
+        QCOMPARE(t_RapDipolesSharded[i].m_iIdx1, t_RapDipolesLocal[i].m_iIdx1);
+        QCOMPARE(t_RapDipolesSharded[i].m_iIdx2, t_RapDipolesLocal[i].m_iIdx2);
+        QVERIFY(std::fabs(t_RapDipolesSharded[i].m_vCorrelation - t_RapDipolesLocal[i].m_vCorrelation) < epsilon);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::shardStalledWorker()
+{
+    QFile t_fileFwd(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis-meg-eeg-oct-6-fwd.fif");
+    QVERIFY(t_fileFwd.exists());
+    MNEForwardSolution t_Fwd(t_fileFwd);
+    QVERIFY(!t_Fwd.isEmpty());
+
+    QFile t_fileEvoked(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif");
+    QVERIFY(t_fileEvoked.exists());
+    QPair<QVariant, QVariant> baseline(QVariant(), 0);
+    FiffEvoked t_evoked(t_fileEvoked, 0, baseline);
+    QVERIFY(!t_evoked.isEmpty());
+    FiffEvoked t_pickedEvoked = t_evoked.pick_channels(t_Fwd.info.ch_names);
+
+    const int t_iRowTimeout = 2000;
+
+    //A hung worker first, its row times out while the reply of the real worker waits in the socket
+    StallingWorker t_stallingWorker;
+    t_stallingWorker.start();
+    quint16 t_iStallingPort = t_stallingWorker.waitForPort();
+    QVERIFY(t_iStallingPort != 0);
+
+    PwlRapMusic t_pwlRapMusicWorker(t_Fwd, false, 2);
+    ShardWorker t_worker(t_pwlRapMusicWorker);
+    t_worker.start();
+    quint16 t_iPort = t_worker.waitForPort();
+    QVERIFY(t_iPort != 0);
+
+    PwlRapMusic t_pwlRapMusic(t_Fwd, false, 2);
+    QVERIFY(t_pwlRapMusic.connectShards(QStringList() << QString("127.0.0.1:%1").arg(t_iStallingPort)
+                                                      << QString("127.0.0.1:%1").arg(t_iPort), t_iRowTimeout));
+
+    //The scan gives up after the timeout and continues locally
+    QList< DipolePair<double> > t_RapDipolesStalled;
+    t_pwlRapMusic.calculateInverse(t_pickedEvoked.data, t_RapDipolesStalled);
+
+    //All shards were reset -> the next calculation neither waits for the hung worker nor reads a stale row
+    QElapsedTimer t_timer;
+    t_timer.start();
+    QList< DipolePair<double> > t_RapDipolesAfter;
+    t_pwlRapMusic.calculateInverse(t_pickedEvoked.data, t_RapDipolesAfter);
+    qint64 t_iAfterMsecs = t_timer.elapsed();
+
+    t_pwlRapMusic.clearShards();
+
+    t_timer.restart();
+    QList< DipolePair<double> > t_RapDipolesLocal;
+    t_pwlRapMusic.calculateInverse(t_pickedEvoked.data, t_RapDipolesLocal);
+    qint64 t_iLocalMsecs = t_timer.elapsed();
+
+    t_worker.quit();
+    t_worker.wait();
+    t_stallingWorker.quit();
+    t_stallingWorker.wait();
+
+    QVERIFY(t_iAfterMsecs < t_iLocalMsecs + t_iRowTimeout/2);
+
+    QVERIFY(!t_RapDipolesLocal.isEmpty());
+    QCOMPARE(t_RapDipolesStalled.size(), t_RapDipolesLocal.size());
+    QCOMPARE(t_RapDipolesAfter.size(), t_RapDipolesLocal.size());
+    for(int i = 0; i < t_RapDipolesLocal.size(); ++i) {
+        QCOMPARE(t_RapDipolesStalled[i].m_iIdx1, t_RapDipolesLocal[i].m_iIdx1);
+        QCOMPARE(t_RapDipolesStalled[i].m_iIdx2, t_RapDipolesLocal[i].m_iIdx2);
+        QCOMPARE(t_RapDipolesAfter[i].m_iIdx1, t_RapDipolesLocal[i].m_iIdx1);
+        QCOMPARE(t_RapDipolesAfter[i].m_iIdx2, t_RapDipolesLocal[i].m_iIdx2);
+        QVERIFY(std::fabs(t_RapDipolesAfter[i].m_vCorrelation - t_RapDipolesLocal[i].m_vCorrelation) < epsilon);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::batchKeepsIncrementalState()
+{
+    QFile t_fileFwd(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis-meg-eeg-oct-6-fwd.fif");
+    QVERIFY(t_fileFwd.exists());
+    MNEForwardSolution t_Fwd(t_fileFwd);
+    QVERIFY(!t_Fwd.isEmpty());
+
+    QFile t_fileEvoked(QDir::currentPath()+"/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif");
+    QVERIFY(t_fileEvoked.exists());
+    QPair<QVariant, QVariant> baseline(QVariant(), 0);
+    FiffEvoked t_evoked(t_fileEvoked, 0, baseline);
+    QVERIFY(!t_evoked.isEmpty());
+    FiffEvoked t_pickedEvoked = t_evoked.pick_channels(t_Fwd.info.ch_names);
+
+    const int t_iBlockSize = 50;
+    QVERIFY(t_pickedEvoked.data.cols() >= 3*t_iBlockSize);
+
+    PwlRapMusic t_pwlRapMusic(t_Fwd, false, 1);
+    t_pwlRapMusic.setStcAttr(2*t_iBlockSize, 0.0);
+
+    //Reference: three consecutive blocks streamed through the sliding window
+    for(int i = 0; i < 2; ++i)
+        t_pwlRapMusic.calculateInverseIncremental(t_pickedEvoked.data.middleCols(i*t_iBlockSize, t_iBlockSize), 0.0f, 0.001f);
+    MNESourceEstimate t_stcRef = t_pwlRapMusic.calculateInverseIncremental(t_pickedEvoked.data.middleCols(2*t_iBlockSize, t_iBlockSize), 0.0f, 0.001f);
+
+    //The same stream with a windowed batch localization in between must not change the sliding window
+    t_pwlRapMusic.resetIncremental();
+    for(int i = 0; i < 2; ++i)
+        t_pwlRapMusic.calculateInverseIncremental(t_pickedEvoked.data.middleCols(i*t_iBlockSize, t_iBlockSize), 0.0f, 0.001f);
+    MNESourceEstimate t_stcBatch = t_pwlRapMusic.calculateInverse(t_pickedEvoked);
+    QVERIFY(!t_stcBatch.isEmpty());
+    MNESourceEstimate t_stc = t_pwlRapMusic.calculateInverseIncremental(t_pickedEvoked.data.middleCols(2*t_iBlockSize, t_iBlockSize), 0.0f, 0.001f);
+
+    QVERIFY(!t_stcRef.isEmpty());
+    QCOMPARE(t_stc.data.rows(), t_stcRef.data.rows());
+    QVERIFY((t_stc.data - t_stcRef.data).cwiseAbs().maxCoeff() < epsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestRapMusic::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRapMusic)
+#include "test_rap_music.moc"
@@ -0,0 +1,451 @@
+//=============================================================================================================
+/**
+* @file     test_rt_cmd_client.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Pipelines JSON and binary commands of the RtCmdClient to a loopback CommandServer
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <commandserver.h>
+
+#include <realtime/rtClient/rtcmdclient.h>
+#include <realtime/rtCommand/commandmanager.h>
+#include <realtime/rtCommand/commandparser.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace RTSERVER;
+using namespace REALTIMELIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC DEFINITIONS
+//=============================================================================================================
+
+static const char* s_sJsonCommands =
+        "{"
+        "   \"commands\": {"
+        "       \"echo\": {"
+        "           \"description\": \"Replies the text and the value.\","
+        "           \"parameters\": {"
+        "               \"text\": {"
+        "                   \"description\": \"Text\","
+        "                   \"type\": \"QString\" "
+        "               },"
+        "               \"value\": {"
+        "                   \"description\": \"Value\","
+        "                   \"type\": \"int\" "
+        "               }"
+        "           }"
+        "       },"
+        "       \"large\": {"
+        "           \"description\": \"Replies the given number of two byte UTF-8 characters.\","
+        "           \"parameters\": {"
+        "               \"count\": {"
+        "                   \"description\": \"Count\","
+        "                   \"type\": \"int\" "
+        "               }"
+        "           }"
+        "       },"
+        "       \"scale\": {"
+        "           \"description\": \"Replies the doubled factor.\","
+        "           \"parameters\": {"
+        "               \"factor\": {"
+        "                   \"description\": \"Factor\","
+        "                   \"type\": \"double\" "
+        "               }"
+        "           }"
+        "       },"
+        "       \"silent\": {"
+        "           \"description\": \"Does not reply.\","
+        "           \"parameters\": {}"
+        "       }"
+        "   }"
+        "}";
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestRtCmdClient
+*
+* @brief The TestRtCmdClient class checks the binary command encoding and sends batches of JSON and binary
+* commands to a loopback CommandServer, each reply has to be matched to its request id.
+*/
+class TestRtCmdClient: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtCmdClient();
+
+private slots:
+    void initTestCase();
+    void binaryEncoding();
+    void taggedReply();
+    void pipelinedJson();
+    void pipelinedBinary();
+    void pipelinedThroughput();
+    void splitReply();
+    void cleanupTestCase();
+
+private:
+    void onEcho(Command p_command);
+    void onScale(Command p_command);
+    void onLarge(Command p_command);
+
+    Command echoCommand(const QString &p_sText, int p_iValue);
+    Command scaleCommand(double p_dFactor);
+    void checkMixedBatch(const QList<qint32> &p_qListIds, const QString &p_sUnknownReply);
+
+    CommandManager m_commandManager;    /**< The commands of the server. */
+    CommandServer m_server;             /**< The server under test. */
+    RtCmdClient m_client;               /**< The loopback client. */
+
+    int m_iNumCommands;     /**< Number of commands of the throughput batch. */
+};
+
+
+//*************************************************************************************************************
+
+TestRtCmdClient::TestRtCmdClient()
+: m_commandManager(QByteArray(s_sJsonCommands))
+, m_iNumCommands(200)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::initTestCase()
+{
+    connect(&m_commandManager["echo"], &Command::executed, this, &TestRtCmdClient::onEcho);
+    connect(&m_commandManager["scale"], &Command::executed, this, &TestRtCmdClient::onScale);
+    connect(&m_commandManager["large"], &Command::executed, this, &TestRtCmdClient::onLarge);
+    m_server.registerCommandManager(m_commandManager);
+
+    QVERIFY(m_server.listen(QHostAddress::LocalHost, 0));
+
+    m_client.QTcpSocket::connectToHost(QHostAddress(QHostAddress::LocalHost), m_server.serverPort());
+    QVERIFY(m_client.waitForConnected(1000));
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::binaryEncoding()
+{
+    CommandManager t_commandManager(QByteArray(s_sJsonCommands));
+    CommandParser t_commandParser;
+    t_commandParser.attach(&t_commandManager);
+
+    QString t_sText;
+    int t_iValue = 0;
+    double t_dFactor = 0.0;
+    connect(&t_commandManager["echo"], &Command::executed, [&](Command p_command) {
+        t_sText = p_command.pValues()[0].toString();
+        t_iValue = p_command.pValues()[1].toInt();
+    });
+    connect(&t_commandManager["scale"], &Command::executed, [&](Command p_command) {
+        t_dFactor = p_command.pValues()[0].toDouble();
+    });
+
+    QStringList t_qListParsed;
+
+    //Strings are not escaped, quotes and non ASCII characters pass unchanged
+    QString t_sExpected = QString::fromUtf8("\"quoted\" \xc3\xbc\xc3\xa4 {}");
+    QByteArray t_blockEcho = CommandParser::encodeCommand(echoCommand(t_sExpected, -42), 17);
+    QVERIFY(CommandParser::isBinaryCommand(t_blockEcho));
+    QVERIFY(t_commandParser.parse(t_blockEcho, t_qListParsed));
+    QCOMPARE(t_commandParser.requestId(), 17);
+    QCOMPARE(t_sText, t_sExpected);
+    QCOMPARE(t_iValue, -42);
+
+    //Doubles are exact
+    QVERIFY(t_commandParser.parse(CommandParser::encodeCommand(scaleCommand(0.1), 18), t_qListParsed));
+    QCOMPARE(t_commandParser.requestId(), 18);
+    QCOMPARE(t_dFactor, 0.1);
+
+    //Unknown and truncated commands are rejected
+    Command t_commandUnknown("unknown", "", QStringList(), QList<QVariant>());
+    QVERIFY(!t_commandParser.parse(CommandParser::encodeCommand(t_commandUnknown, 19), t_qListParsed));
+    QVERIFY(!t_commandParser.parse(t_blockEcho.left(t_blockEcho.size() - 2), t_qListParsed));
+
+    //The QString blocks of the text and JSON commands are told apart by their first byte
+    QByteArray t_blockString;
+    QDataStream t_streamOut(&t_blockString, QIODevice::WriteOnly);
+    t_streamOut.setVersion(QDataStream::Qt_5_1);
+    t_streamOut << QString("help");
+    QVERIFY(!CommandParser::isBinaryCommand(t_blockString));
+    QVERIFY(!CommandParser::isBinaryCommand(QByteArray()));
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::taggedReply()
+{
+    QString t_sExpected = QString::fromUtf8("{\"value\": \"\xc3\xbc\"}\r\n");
+
+    qint32 t_iId = -1;
+    QString t_sReply;
+    QVERIFY(CommandParser::decodeReply(CommandParser::encodeReply(42, t_sExpected), t_iId, t_sReply));
+    QCOMPARE(t_iId, 42);
+    QCOMPARE(t_sReply, t_sExpected);
+
+    QVERIFY(CommandParser::decodeReply(CommandParser::encodeReply(43, QString()), t_iId, t_sReply));
+    QCOMPARE(t_iId, 43);
+    QVERIFY(t_sReply.isEmpty());
+
+    //A QString reply of a blocking command is not a tagged reply
+    QByteArray t_blockString;
+    QDataStream t_streamOut(&t_blockString, QIODevice::WriteOnly);
+    t_streamOut.setVersion(QDataStream::Qt_5_1);
+    t_streamOut << QString("reply");
+    QVERIFY(!CommandParser::decodeReply(t_blockString, t_iId, t_sReply));
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::pipelinedJson()
+{
+    m_client.setBinaryEncoding(false);
+
+    QList<Command> t_qListCommands;
+    t_qListCommands << echoCommand("first", 1)
+                    << scaleCommand(1.25)
+                    << Command("silent", "", QStringList(), QList<QVariant>())
+                    << Command("unknown", "", QStringList(), QList<QVariant>())
+                    << echoCommand("last", 5);
+
+    QList<qint32> t_qListIds = m_client.sendCommands(t_qListCommands);
+    QCOMPARE(t_qListIds.size(), t_qListCommands.size());
+
+    //Unknown commands of a JSON request are skipped
+    checkMixedBatch(t_qListIds, QString());
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::pipelinedBinary()
+{
+    m_client.setBinaryEncoding(true);
+
+    QList<Command> t_qListCommands;
+    t_qListCommands << echoCommand("first", 1)
+                    << scaleCommand(1.25)
+                    << Command("silent", "", QStringList(), QList<QVariant>())
+                    << Command("unknown", "", QStringList(), QList<QVariant>())
+                    << echoCommand("last", 5);
+
+    QList<qint32> t_qListIds = m_client.sendCommands(t_qListCommands);
+    QCOMPARE(t_qListIds.size(), t_qListCommands.size());
+
+    checkMixedBatch(t_qListIds, QString("command unknown\r\n"));
+
+    m_client.setBinaryEncoding(false);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::pipelinedThroughput()
+{
+    for(int k = 0; k < 2; ++k) {
+        m_client.setBinaryEncoding(k == 1);
+
+        QList<Command> t_qListCommands;
+        for(int i = 0; i < m_iNumCommands; ++i)
+            t_qListCommands << echoCommand(QString("echo"), i);
+
+        QSignalSpy t_spyReply(&m_client, &RtCmdClient::reply);
+
+        QElapsedTimer t_timer;
+        t_timer.start();
+
+        QList<qint32> t_qListIds = m_client.sendCommands(t_qListCommands);
+        QTRY_COMPARE_WITH_TIMEOUT(t_spyReply.count(), m_iNumCommands, 10000);
+
+        qint64 t_iElapsed = t_timer.nsecsElapsed();
+
+        for(int i = 0; i < m_iNumCommands; ++i) {
+            QCOMPARE(t_spyReply.at(i).at(0).toInt(), t_qListIds[i]);
+            QCOMPARE(m_client.takeReply(t_qListIds[i]), QString("echo:%1").arg(i));
+        }
+
+        qDebug() << (k == 1 ? "binary:" : "JSON:  ") << m_iNumCommands << "commands in one round trip,"
+                 << t_iElapsed/1000.0/m_iNumCommands << "us per command";
+    }
+
+    m_client.setBinaryEncoding(false);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::splitReply()
+{
+    //The split points fall into two byte characters, the parts are decoded together
+    QString t_sExpected(75000, QChar(0xfc));
+    QList<QByteArray> t_qListFrames = CommandParser::splitReply(CommandParser::encodeReply(7, t_sExpected), 65000);
+    QCOMPARE(t_qListFrames.size(), 3);
+
+    QByteArray t_blockReply;
+    for(int i = 0; i < t_qListFrames.size(); ++i) {
+        QVERIFY(t_qListFrames[i].size() <= 65000);
+
+        qint32 t_iId = -1;
+        QByteArray t_blockPart;
+        bool t_bLast = false;
+        QVERIFY(CommandParser::decodeReplyPart(t_qListFrames[i], t_iId, t_blockPart, t_bLast));
+        QCOMPARE(t_iId, 7);
+        QCOMPARE(t_bLast, i == t_qListFrames.size() - 1);
+        t_blockReply.append(t_blockPart);
+    }
+    QCOMPARE(QString::fromUtf8(t_blockReply), t_sExpected);
+
+    //Loopback, the large reply is framed between two small ones
+    for(int k = 0; k < 2; ++k) {
+        m_client.setBinaryEncoding(k == 1);
+
+        QList<Command> t_qListCommands;
+        t_qListCommands << echoCommand("first", 1)
+                        << Command("large", "", QStringList() << "count", QList<QVariant>() << QVariant(75000))
+                        << echoCommand("last", 2);
+
+        QSignalSpy t_spyReply(&m_client, &RtCmdClient::reply);
+        QList<qint32> t_qListIds = m_client.sendCommands(t_qListCommands);
+        QTRY_COMPARE_WITH_TIMEOUT(t_spyReply.count(), 3, 5000);
+
+        QCOMPARE(m_client.takeReply(t_qListIds[0]), QString("first:1"));
+        QCOMPARE(m_client.takeReply(t_qListIds[1]), t_sExpected);
+        QCOMPARE(m_client.takeReply(t_qListIds[2]), QString("last:2"));
+    }
+
+    m_client.setBinaryEncoding(false);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::cleanupTestCase()
+{
+    m_client.disconnectFromHost();
+    m_server.close();
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::onEcho(Command p_command)
+{
+    m_commandManager["echo"].reply(QString("%1:%2").arg(p_command.pValues()[0].toString()).arg(p_command.pValues()[1].toInt()));
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::onScale(Command p_command)
+{
+    m_commandManager["scale"].reply(QString::number(2.0*p_command.pValues()[0].toDouble()));
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::onLarge(Command p_command)
+{
+    m_commandManager["large"].reply(QString(p_command.pValues()[0].toInt(), QChar(0xfc)));
+}
+
+
+//*************************************************************************************************************
+
+Command TestRtCmdClient::echoCommand(const QString &p_sText, int p_iValue)
+{
+    return Command("echo", "", QStringList() << "text" << "value", QList<QVariant>() << QVariant(p_sText) << QVariant(p_iValue));
+}
+
+
+//*************************************************************************************************************
+
+Command TestRtCmdClient::scaleCommand(double p_dFactor)
+{
+    return Command("scale", "", QStringList() << "factor", QList<QVariant>() << QVariant(p_dFactor));
+}
+
+
+//*************************************************************************************************************
+
+void TestRtCmdClient::checkMixedBatch(const QList<qint32> &p_qListIds, const QString &p_sUnknownReply)
+{
+    QSignalSpy t_spyReply(&m_client, &RtCmdClient::reply);
+
+    //Exactly one reply per request, in order
+    QTRY_COMPARE_WITH_TIMEOUT(t_spyReply.count(), p_qListIds.size(), 5000);
+    for(int i = 0; i < p_qListIds.size(); ++i)
+        QCOMPARE(t_spyReply.at(i).at(0).toInt(), p_qListIds[i]);
+
+    QCOMPARE(m_client.takeReply(p_qListIds[0]), QString("first:1"));
+    QCOMPARE(m_client.takeReply(p_qListIds[1]), QString("2.5"));
+    QCOMPARE(m_client.takeReply(p_qListIds[2]), QString());
+    QCOMPARE(m_client.takeReply(p_qListIds[3]), p_sUnknownReply);
+    QCOMPARE(m_client.takeReply(p_qListIds[4]), QString("last:5"));
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtCmdClient)
+#include "test_rt_cmd_client.moc"
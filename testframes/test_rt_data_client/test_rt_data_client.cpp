@@ -0,0 +1,265 @@
+//=============================================================================================================
+/**
+* @file     test_rt_data_client.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Streams raw buffers over a loopback connection into the RtDataClient and checks the in place and pooled reads.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <realtime/rtClient/rtdataclient.h>
+#include <realtime/rtClient/rawbufferpool.h>
+
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_stream.h>
+
+#include <utils/ioutils.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace REALTIMELIB;
+using namespace FIFFLIB;
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestRtDataClient
+*
+* @brief The TestRtDataClient class sends raw buffer tags from a loopback server socket and compares what the
+* RtDataClient reads, in place into a reused matrix and into recycled matrices of a RawBufferPool.
+*
+*/
+class TestRtDataClient: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtDataClient();
+
+private slots:
+    void initTestCase();
+    void swapFloats();
+    void readInPlace();
+    void readPooled();
+    void closedConnection();
+    void cleanupTestCase();
+
+private:
+    void sendBuffer(const MatrixXf& matData);
+
+    QTcpServer m_server;                /**< The loopback server. */
+    QTcpSocket* m_pServerSocket;        /**< The server side of the connection. */
+    RtDataClient* m_pClient;            /**< The client under test. */
+
+    int m_iChannels;        /**< Channels of the sent buffers. */
+    int m_iSamples;         /**< Samples of the sent buffers. */
+    int m_iNumBuffers;      /**< Number of sent buffers per test. */
+};
+
+
+//*************************************************************************************************************
+
+TestRtDataClient::TestRtDataClient()
+: m_pServerSocket(Q_NULLPTR)
+, m_pClient(Q_NULLPTR)
+, m_iChannels(32)
+, m_iSamples(64)
+, m_iNumBuffers(50)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtDataClient::initTestCase()
+{
+    QVERIFY(m_server.listen(QHostAddress::LocalHost, 0));
+
+    m_pClient = new RtDataClient(this);
+    m_pClient->QAbstractSocket::connectToHost(QHostAddress(QHostAddress::LocalHost).toString(), m_server.serverPort());
+    QVERIFY(m_pClient->waitForConnected(1000));
+
+    QVERIFY(m_server.waitForNewConnection(1000));
+    m_pServerSocket = m_server.nextPendingConnection();
+    QVERIFY(m_pServerSocket);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtDataClient::swapFloats()
+{
+    //All lengths and an unaligned start cover the SIMD loop and the scalar tail
+    for(int iCount = 0; iCount < 20; ++iCount) {
+        VectorXf vecData = VectorXf::Random(iCount + 1);
+        VectorXf vecExpected = vecData;
+
+        IOUtils::swap_floatp(vecData.data() + 1, iCount);
+        for(int i = 1; i <= iCount; ++i) {
+            IOUtils::swap_floatp(vecExpected.data() + i);
+        }
+
+        QVERIFY(memcmp(vecData.data(), vecExpected.data(), vecData.size()*sizeof(float)) == 0);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRtDataClient::readInPlace()
+{
+    MatrixXf matRead;
+    fiff_int_t kind;
+
+    //A tag which is no raw buffer leaves the matrix alone
+    QByteArray blockStart;
+    FiffStream t_FiffStreamOut(&blockStart, QIODevice::WriteOnly);
+    t_FiffStreamOut.start_block(FIFFB_RAW_DATA);
+    m_pServerSocket->write(blockStart);
+    QVERIFY(m_pServerSocket->waitForBytesWritten(1000));
+
+    m_pClient->readRawBuffer(m_iChannels, matRead, kind);
+    QCOMPARE(kind, FIFF_BLOCK_START);
+    QCOMPARE(matRead.size(), 0);
+
+    const float* pStorage = Q_NULLPTR;
+
+    for(int i = 0; i < m_iNumBuffers; ++i) {
+        MatrixXf matData = MatrixXf::Random(m_iChannels, m_iSamples);
+        sendBuffer(matData);
+
+        m_pClient->readRawBuffer(m_iChannels, matRead, kind);
+        QCOMPARE(kind, FIFF_DATA_BUFFER);
+        QVERIFY(matRead == matData);
+
+        //The storage is reused, the buffer size does not change
+        if(i == 0) {
+            pStorage = matRead.data();
+        }
+        QVERIFY(matRead.data() == pStorage);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRtDataClient::readPooled()
+{
+    RawBufferPool pool(4);
+    QList<QSharedPointer<MatrixXf> > listConsumer;
+    fiff_int_t kind;
+
+    for(int i = 0; i < m_iNumBuffers; ++i) {
+        MatrixXf matData = MatrixXf::Random(m_iChannels, m_iSamples);
+        sendBuffer(matData);
+
+        QSharedPointer<MatrixXf> pMatRead = m_pClient->readRawBuffer(m_iChannels, pool, kind);
+        QCOMPARE(kind, FIFF_DATA_BUFFER);
+        QVERIFY(pMatRead);
+        QVERIFY(*pMatRead == matData);
+
+        //A consumer keeps the last two buffers
+        listConsumer.append(pMatRead);
+        if(listConsumer.size() > 2) {
+            listConsumer.removeFirst();
+        }
+    }
+
+    //Two buffers held by the consumer and the one being read
+    QVERIFY(pool.allocatedCount() <= 3);
+
+    listConsumer.clear();
+    QCOMPARE(pool.idleCount(), pool.allocatedCount());
+}
+
+
+//*************************************************************************************************************
+
+void TestRtDataClient::closedConnection()
+{
+    MatrixXf matRead;
+    fiff_int_t kind = 0;
+
+    m_pServerSocket->disconnectFromHost();
+
+    m_pClient->readRawBuffer(m_iChannels, matRead, kind);
+    QCOMPARE(kind, -1);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtDataClient::cleanupTestCase()
+{
+    m_pClient->abort();
+}
+
+
+//*************************************************************************************************************
+
+void TestRtDataClient::sendBuffer(const MatrixXf& matData)
+{
+    QByteArray blockBuffer;
+    FiffStream t_FiffStreamOut(&blockBuffer, QIODevice::WriteOnly);
+    t_FiffStreamOut.write_float(FIFF_DATA_BUFFER, matData.data(), matData.size());
+
+    m_pServerSocket->write(blockBuffer);
+    while(m_pServerSocket->bytesToWrite() > 0 && m_pServerSocket->waitForBytesWritten(1000)) {
+    }
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestRtDataClient)
+#include "test_rt_data_client.moc"
@@ -0,0 +1,319 @@
+//=============================================================================================================
+/**
+* @file     test_rt_processing.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Checks the running accumulators of RtAve and RtCov against batch averages and covariances
+*
+*/
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <realtime/rtProcessing/rtave.h>
+#include <realtime/rtProcessing/rtcov.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace REALTIMELIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestRtProcessing
+*
+* @brief The TestRtProcessing class checks the running accumulators of RtAve against batch computations.
+*
+*/
+class TestRtProcessing: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRtProcessing();
+
+private slots:
+    void initTestCase();
+    void aveBufferCumulative();
+    void aveBufferRunning();
+    void aveBufferRunningFloat();
+    void covAccumulatorBlocks();
+    void covAccumulatorSliding();
+    void covAccumulatorDecay();
+    void cleanupTestCase();
+
+private:
+    void compareAveBuffer(qint32 capacity, bool bFloat);
+    MatrixXd batchCovariance(const QList<MatrixXd>& blocks, const QList<double>& weights) const;
+    bool compareCovariance(const MatrixXd& matCov, const MatrixXd& matBatch) const;
+
+    double epsilon;
+
+    QList<MatrixXd> m_qListEpochs;      /**< Random epochs (channels x samples). */
+    QList<MatrixXd> m_qListBlocks;      /**< Random data blocks of varying length (channels x samples). */
+};
+
+
+//*************************************************************************************************************
+
+TestRtProcessing::TestRtProcessing()
+: epsilon(0.000000001)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestRtProcessing::initTestCase()
+{
+    qDebug() << "Epsilon" << epsilon;
+
+    std::srand(42);
+
+    //Enough epochs to turn a ring of 5 several times, with an offset so that rounding errors would accumulate
+    for(int i = 0; i < 23; ++i) {
+        m_qListEpochs.append(MatrixXd::Random(8, 50).array() + 100.0);
+    }
+
+    //More channels than one scatter tile, so the tiled update is covered as well
+    for(int i = 0; i < 17; ++i) {
+        m_qListBlocks.append(MatrixXd::Random(70, 30 + 7*(i % 4)).array() + 10.0);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRtProcessing::compareAveBuffer(qint32 capacity, bool bFloat)
+{
+    RtAveBuffer t_buffer;
+    t_buffer.init(capacity, bFloat);
+
+    for(int i = 0; i < m_qListEpochs.size(); ++i) {
+        t_buffer.add(m_qListEpochs[i]);
+
+        //Batch average of the epochs the buffer should hold, rounded like the ring stores them
+        int iFirst = capacity > 0 ? qMax(0, i + 1 - capacity) : 0;
+        MatrixXd matBatch = MatrixXd::Zero(m_qListEpochs[i].rows(), m_qListEpochs[i].cols());
+        for(int j = iFirst; j <= i; ++j) {
+            if(bFloat) {
+                matBatch += m_qListEpochs[j].cast<float>().cast<double>();
+            } else {
+                matBatch += m_qListEpochs[j];
+            }
+        }
+        matBatch /= (i - iFirst + 1);
+
+        QCOMPARE(t_buffer.iCount, i - iFirst + 1);
+        QVERIFY((t_buffer.average() - matBatch).cwiseAbs().maxCoeff() < epsilon);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRtProcessing::aveBufferCumulative()
+{
+    compareAveBuffer(0, false);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtProcessing::aveBufferRunning()
+{
+    compareAveBuffer(5, false);
+
+    //Ring as long as the epoch list, evicts exactly once
+    compareAveBuffer(m_qListEpochs.size() - 1, false);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtProcessing::aveBufferRunningFloat()
+{
+    compareAveBuffer(5, true);
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd TestRtProcessing::batchCovariance(const QList<MatrixXd>& blocks, const QList<double>& weights) const
+{
+    double dWeight = 0.0;
+    VectorXd vecMean = VectorXd::Zero(blocks.first().rows());
+    for(int i = 0; i < blocks.size(); ++i) {
+        dWeight += weights[i] * blocks[i].cols();
+        vecMean += weights[i] * blocks[i].rowwise().sum();
+    }
+    vecMean /= dWeight;
+
+    MatrixXd matScatter = MatrixXd::Zero(vecMean.size(), vecMean.size());
+    for(int i = 0; i < blocks.size(); ++i) {
+        MatrixXd matCentered = blocks[i].colwise() - vecMean;
+        matScatter += weights[i] * matCentered * matCentered.transpose();
+    }
+
+    return matScatter / (dWeight - 1.0);
+}
+
+
+//*************************************************************************************************************
+
+bool TestRtProcessing::compareCovariance(const MatrixXd& matCov, const MatrixXd& matBatch) const
+{
+    return (matCov - matBatch).cwiseAbs().maxCoeff() / matBatch.cwiseAbs().maxCoeff() < epsilon;
+}
+
+
+//*************************************************************************************************************
+
+void TestRtProcessing::covAccumulatorBlocks()
+{
+    RtCovAccumulator t_acc;
+    QList<MatrixXd> qListBlocks;
+    QList<double> qListWeights;
+
+    for(int i = 0; i < m_qListBlocks.size(); ++i) {
+        t_acc.add(m_qListBlocks[i]);
+        qListBlocks.append(m_qListBlocks[i]);
+        qListWeights.append(1.0);
+
+        QVERIFY(compareCovariance(t_acc.covariance(), batchCovariance(qListBlocks, qListWeights)));
+    }
+
+    t_acc.clear();
+    QCOMPARE(t_acc.dWeight, 0.0);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtProcessing::covAccumulatorSliding()
+{
+    //Window of four blocks slid over all blocks without a rebuild, i.e. several turns of downdates only
+    int iWindow = 4;
+    RtCovAccumulator t_acc;
+    QList<MatrixXd> qListWindow;
+    QList<double> qListWeights;
+
+    for(int i = 0; i < m_qListBlocks.size(); ++i) {
+        t_acc.add(m_qListBlocks[i]);
+        qListWindow.append(m_qListBlocks[i]);
+        qListWeights.append(1.0);
+
+        if(qListWindow.size() > iWindow) {
+            t_acc.remove(qListWindow.first());
+            qListWindow.removeFirst();
+            qListWeights.removeFirst();
+        }
+
+        double dSamples = 0.0;
+        for(int j = 0; j < qListWindow.size(); ++j) {
+            dSamples += qListWindow[j].cols();
+        }
+
+        QCOMPARE(t_acc.dWeight, dSamples);
+        QVERIFY(compareCovariance(t_acc.covariance(), batchCovariance(qListWindow, qListWeights)));
+    }
+
+    //Removing everything empties the accumulator
+    while(!qListWindow.isEmpty()) {
+        t_acc.remove(qListWindow.first());
+        qListWindow.removeFirst();
+    }
+    QCOMPARE(t_acc.dWeight, 0.0);
+}
+
+
+//*************************************************************************************************************
+
+void TestRtProcessing::covAccumulatorDecay()
+{
+    RtCovAccumulator t_acc;
+    QList<MatrixXd> qListBlocks;
+    QList<double> qListWeights;
+
+    for(int i = 0; i < m_qListBlocks.size(); ++i) {
+        //Per block forgetting factor as RtCov uses it in exponential mode
+        double dDecay = std::pow(1.0 - 1.0/120.0, (double)m_qListBlocks[i].cols());
+
+        t_acc.add(m_qListBlocks[i], dDecay);
+
+        //The first block starts the state, every later block decays all previous ones
+        if(i > 0) {
+            for(int j = 0; j < qListWeights.size(); ++j) {
+                qListWeights[j] *= dDecay;
+            }
+        }
+        qListBlocks.append(m_qListBlocks[i]);
+        qListWeights.append(1.0);
+
+        QVERIFY(compareCovariance(t_acc.covariance(), batchCovariance(qListBlocks, qListWeights)));
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestRtProcessing::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestRtProcessing)
+#include "test_rt_processing.moc"
@@ -0,0 +1,490 @@
+//=============================================================================================================
+/**
+* @file     test_shared_memory_ring.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Checks the SharedMemoryRing and compares the raw buffer latency and throughput of shared memory and TCP loopback.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <realtime/rtClient/sharedmemoryring.h>
+#include <realtime/rtClient/rtdataclient.h>
+#include <realtime/rtClient/rawbufferpool.h>
+
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_stream.h>
+
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace REALTIMELIB;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* Reads records of a ring in its own thread and checks the sequence numbers and the content.
+*/
+class RingReader : public QThread
+{
+public:
+    RingReader(const QString& sKey)
+    : m_sKey(sKey)
+    , m_iRecords(0)
+    , m_iErrors(0)
+    {
+    }
+
+    QString m_sKey;         /**< The key of the ring. */
+    int m_iRecords;         /**< Records read until the ring was closed. */
+    int m_iErrors;          /**< Records with wrong sequence number or content. */
+
+protected:
+    void run()
+    {
+        SharedMemoryRing ring;
+        if(!ring.attach(m_sKey)) {
+            m_iErrors = -1;
+            return;
+        }
+
+        const char* pData;
+        qint32 iSize;
+        while(ring.beginRead(pData, iSize)) {
+            qint32 iSequence;
+            memcpy(&iSequence, pData, sizeof(qint32));
+
+            if(iSequence != m_iRecords) {
+                ++m_iErrors;
+            }
+            for(qint32 i = sizeof(qint32); i < iSize; ++i) {
+                if(pData[i] != (char)(iSequence + i)) {
+                    ++m_iErrors;
+                    break;
+                }
+            }
+
+            ++m_iRecords;
+            ring.endRead();
+        }
+    }
+};
+
+
+//=============================================================================================================
+/**
+* Receives raw buffers with an RtDataClient in its own thread, through a shared memory ring if a key is given
+* and through TCP otherwise. The receive time of each buffer is taken from the timer of the test.
+*/
+class TransportReader : public QThread
+{
+public:
+    TransportReader(quint16 uPort, const QString& sKey, int iChannels, int iNumBuffers, const QElapsedTimer& timer)
+    : m_vecReceivedNs(iNumBuffers, 0)
+    , m_uPort(uPort)
+    , m_sKey(sKey)
+    , m_iChannels(iChannels)
+    , m_timer(timer)
+    {
+    }
+
+    QAtomicInt m_iReceived;             /**< Number of received buffers. */
+    QVector<qint64> m_vecReceivedNs;    /**< Receive time of each buffer. */
+
+protected:
+    void run()
+    {
+        RtDataClient t_dataClient;
+
+        if(m_sKey.isEmpty()) {
+            t_dataClient.QAbstractSocket::connectToHost(QHostAddress(QHostAddress::LocalHost).toString(), m_uPort);
+            if(!t_dataClient.waitForConnected(5000)) {
+                return;
+            }
+        }
+        else if(!t_dataClient.attachSharedMemory(m_sKey)) {
+            return;
+        }
+
+        RawBufferPool t_pool;
+        fiff_int_t kind;
+
+        for(int i = 0; i < m_vecReceivedNs.size(); ) {
+            QSharedPointer<MatrixXf> pMatRawBuffer = t_dataClient.readRawBuffer(m_iChannels, t_pool, kind);
+
+            if(kind == -1) {
+                break;
+            }
+
+            if(kind == FIFF_DATA_BUFFER && pMatRawBuffer) {
+                m_vecReceivedNs[i] = m_timer.nsecsElapsed();
+                ++i;
+                m_iReceived.storeRelease(i);
+            }
+        }
+    }
+
+private:
+    quint16 m_uPort;
+    QString m_sKey;
+    int m_iChannels;
+    const QElapsedTimer& m_timer;
+};
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestSharedMemoryRing
+*
+* @brief The TestSharedMemoryRing class checks the record ring across threads and measures how fast raw buffer
+* tags reach an RtDataClient through shared memory compared to the TCP loopback.
+*
+*/
+class TestSharedMemoryRing: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSharedMemoryRing();
+
+private slots:
+    void initTestCase();
+    void ringIntegrity();
+    void closeWakesReader();
+    void readerNoticesLostServer();
+    void transportBenchmark();
+    void cleanupTestCase();
+
+private:
+    bool sendTag(QTcpSocket* pSocket, SharedMemoryRing* pRing);
+    bool waitForReceived(TransportReader& reader, QTcpSocket* pSocket, int iCount);
+    void measure(const QString& sTransport, TransportReader& reader, QTcpSocket* pSocket, SharedMemoryRing* pRing);
+
+    QString m_sKeyPrefix;       /**< Makes the keys unique per test process. */
+    QByteArray m_blockTag;      /**< An encoded raw buffer tag. */
+    QElapsedTimer m_timer;      /**< Common time base of writer and reader. */
+
+    int m_iChannels;            /**< Channels of the benchmark buffers. */
+    int m_iSamples;             /**< Samples of the benchmark buffers. */
+    int m_iLatencyBuffers;      /**< Buffers sent one at a time. */
+    int m_iThroughputBuffers;   /**< Buffers sent back to back. */
+};
+
+
+//*************************************************************************************************************
+
+TestSharedMemoryRing::TestSharedMemoryRing()
+: m_iChannels(306)
+, m_iSamples(50)
+, m_iLatencyBuffers(500)
+, m_iThroughputBuffers(5000)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestSharedMemoryRing::initTestCase()
+{
+    m_sKeyPrefix = QString("test_shared_memory_ring_%1").arg(QCoreApplication::applicationPid());
+
+    MatrixXf matData = MatrixXf::Random(m_iChannels, m_iSamples);
+    FiffStream t_FiffStreamOut(&m_blockTag, QIODevice::WriteOnly);
+    t_FiffStreamOut.write_float(FIFF_DATA_BUFFER, matData.data(), matData.size());
+
+    m_timer.start();
+}
+
+
+//*************************************************************************************************************
+
+void TestSharedMemoryRing::ringIntegrity()
+{
+    //A small ring and records of varying size wrap around many times
+    SharedMemoryRing ring;
+    QVERIFY(ring.create(m_sKeyPrefix + "_integrity", 64*1024));
+    QCOMPARE(ring.capacity(), 64*1024);
+
+    RingReader reader(ring.key());
+    reader.start();
+
+    const int iNumRecords = 20000;
+    QByteArray blockRecord(20000, 0);
+
+    for(int iSequence = 0; iSequence < iNumRecords; ++iSequence) {
+        qint32 iSize = sizeof(qint32) + (iSequence * 7919) % (blockRecord.size() - sizeof(qint32));
+        memcpy(blockRecord.data(), &iSequence, sizeof(qint32));
+        for(qint32 i = sizeof(qint32); i < iSize; ++i) {
+            blockRecord[i] = (char)(iSequence + i);
+        }
+
+        while(!ring.write(blockRecord.constData(), iSize)) {
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    //A record larger than half of the ring is refused
+    QByteArray blockLarge(40*1024, 0);
+    QVERIFY(!ring.write(blockLarge.constData(), blockLarge.size()));
+
+    ring.close();
+    QVERIFY(reader.wait(10000));
+
+    QCOMPARE(reader.m_iErrors, 0);
+    QCOMPARE(reader.m_iRecords, iNumRecords);
+}
+
+
+//*************************************************************************************************************
+
+void TestSharedMemoryRing::closeWakesReader()
+{
+    SharedMemoryRing ring;
+    QVERIFY(ring.create(m_sKeyPrefix + "_close", 64*1024));
+
+    RingReader reader(ring.key());
+    reader.start();
+
+    //The reader sleeps on the empty ring until it is closed
+    QTest::qWait(100);
+    QVERIFY(reader.isRunning());
+
+    ring.close();
+    QVERIFY(ring.isClosed());
+    QVERIFY(reader.wait(5000));
+    QCOMPARE(reader.m_iRecords, 0);
+    QCOMPARE(reader.m_iErrors, 0);
+}
+
+
+//*************************************************************************************************************
+
+void TestSharedMemoryRing::readerNoticesLostServer()
+{
+    SharedMemoryRing ring;
+    QVERIFY(ring.create(m_sKeyPrefix + "_lost", 64*1024));
+
+    //The timed wait returns on the empty ring which is still open
+    SharedMemoryRing reader;
+    QVERIFY(reader.attach(ring.key()));
+
+    const char* pData;
+    qint32 iSize;
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!reader.beginRead(pData, iSize, 50));
+    QVERIFY(timer.elapsed() >= 50 && timer.elapsed() < 5000);
+    QVERIFY(!reader.isClosed());
+
+    //The data client of a local server reads from the ring while its socket stays connected
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+
+    RtDataClient t_dataClient;
+    t_dataClient.QAbstractSocket::connectToHost(QHostAddress(QHostAddress::LocalHost).toString(), server.serverPort());
+    QVERIFY(t_dataClient.waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket* pSocket = server.nextPendingConnection();
+    QVERIFY(pSocket);
+
+    QVERIFY(t_dataClient.attachSharedMemory(ring.key()));
+    QVERIFY(ring.write(m_blockTag.constData(), m_blockTag.size()));
+
+    RawBufferPool t_pool;
+    fiff_int_t kind;
+    QSharedPointer<MatrixXf> pMatRawBuffer = t_dataClient.readRawBuffer(m_iChannels, t_pool, kind);
+    QCOMPARE(kind, FIFF_DATA_BUFFER);
+    QVERIFY(pMatRawBuffer);
+    QCOMPARE((int)pMatRawBuffer->cols(), m_iSamples);
+
+    //A server which dies without closing the ring drops the connection, the reader does not wait forever
+    pSocket->abort();
+    timer.restart();
+    pMatRawBuffer = t_dataClient.readRawBuffer(m_iChannels, t_pool, kind);
+    QCOMPARE(kind, -1);
+    QVERIFY(!pMatRawBuffer);
+    QVERIFY(timer.elapsed() < 5000);
+    QVERIFY(!ring.isClosed());
+}
+
+
+//*************************************************************************************************************
+
+void TestSharedMemoryRing::transportBenchmark()
+{
+    const int iNumBuffers = m_iLatencyBuffers + m_iThroughputBuffers;
+
+    //TCP loopback, as before
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+
+    TransportReader tcpReader(server.serverPort(), QString(), m_iChannels, iNumBuffers, m_timer);
+    tcpReader.start();
+
+    QVERIFY(server.waitForNewConnection(5000));
+    QTcpSocket* pSocket = server.nextPendingConnection();
+    QVERIFY(pSocket);
+
+    measure("TCP", tcpReader, pSocket, Q_NULLPTR);
+    pSocket->disconnectFromHost();
+    QVERIFY(tcpReader.wait(10000));
+
+    //Shared memory ring
+    SharedMemoryRing ring;
+    QVERIFY(ring.create(m_sKeyPrefix + "_transport", 16*1024*1024));
+
+    TransportReader shmReader(0, ring.key(), m_iChannels, iNumBuffers, m_timer);
+    shmReader.start();
+
+    measure("Shared memory", shmReader, Q_NULLPTR, &ring);
+    ring.close();
+    QVERIFY(shmReader.wait(10000));
+}
+
+
+//*************************************************************************************************************
+
+void TestSharedMemoryRing::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+
+bool TestSharedMemoryRing::sendTag(QTcpSocket* pSocket, SharedMemoryRing* pRing)
+{
+    if(pRing) {
+        QElapsedTimer timeout;
+        timeout.start();
+
+        //The ring never blocks, a full ring is retried
+        while(!pRing->write(m_blockTag.constData(), m_blockTag.size())) {
+            if(timeout.elapsed() > 30000) {
+                return false;
+            }
+            QThread::yieldCurrentThread();
+        }
+        return true;
+    }
+
+    pSocket->write(m_blockTag);
+    pSocket->flush();
+
+    //Bounded backlog in the socket buffer
+    while(pSocket->bytesToWrite() > 4*1024*1024) {
+        if(!pSocket->waitForBytesWritten(1000)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool TestSharedMemoryRing::waitForReceived(TransportReader& reader, QTcpSocket* pSocket, int iCount)
+{
+    QElapsedTimer timeout;
+    timeout.start();
+
+    while(reader.m_iReceived.loadAcquire() < iCount) {
+        if(timeout.elapsed() > 30000) {
+            return false;
+        }
+
+        if(pSocket && pSocket->bytesToWrite() > 0) {
+            pSocket->waitForBytesWritten(1);
+        } else {
+            QThread::yieldCurrentThread();
+        }
+    }
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void TestSharedMemoryRing::measure(const QString& sTransport, TransportReader& reader, QTcpSocket* pSocket, SharedMemoryRing* pRing)
+{
+    //Latency: one buffer at a time
+    QVector<double> vecLatencyUs;
+    for(int i = 0; i < m_iLatencyBuffers; ++i) {
+        qint64 iSentNs = m_timer.nsecsElapsed();
+        QVERIFY(sendTag(pSocket, pRing));
+        QVERIFY(waitForReceived(reader, pSocket, i + 1));
+        vecLatencyUs.append((reader.m_vecReceivedNs.at(i) - iSentNs) / 1000.0);
+    }
+    std::sort(vecLatencyUs.begin(), vecLatencyUs.end());
+
+    //Throughput: buffers back to back
+    qint64 iStartNs = m_timer.nsecsElapsed();
+    for(int i = 0; i < m_iThroughputBuffers; ++i) {
+        QVERIFY(sendTag(pSocket, pRing));
+    }
+    QVERIFY(waitForReceived(reader, pSocket, m_iLatencyBuffers + m_iThroughputBuffers));
+    double dSeconds = (reader.m_vecReceivedNs.last() - iStartNs) / 1.0e9;
+
+    double dMegaBytes = (double)m_iThroughputBuffers * m_blockTag.size() / (1024.0*1024.0);
+
+    qDebug() << sTransport << ": latency median" << vecLatencyUs.at(vecLatencyUs.size() / 2) << "us, 99th percentile"
+             << vecLatencyUs.at(vecLatencyUs.size() * 99 / 100) << "us, throughput" << dMegaBytes / dSeconds << "MB/s,"
+             << m_iThroughputBuffers / dSeconds << "buffers/s";
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestSharedMemoryRing)
+#include "test_shared_memory_ring.moc"
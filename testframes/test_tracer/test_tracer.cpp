@@ -0,0 +1,389 @@
+//=============================================================================================================
+/**
+* @file     test_tracer.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Checks the buffer bookkeeping and the event collection of the latency tracer
+*
+*/
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/tracer.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QThread>
+#include <QSemaphore>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+
+
+//=============================================================================================================
+/**
+* Pushes the ids 1 ... iCount to a TraceIdQueue from its own thread and releases the semaphore for each.
+*/
+class TraceIdProducer : public QThread
+{
+public:
+    TraceIdProducer(TraceIdQueue* pQueue, QSemaphore* pAvailable, int iCount)
+    : m_pQueue(pQueue)
+    , m_pAvailable(pAvailable)
+    , m_iCount(iCount)
+    {
+    }
+
+protected:
+    void run()
+    {
+        for(int i = 1; i <= m_iCount; ++i) {
+            Tracer::setCurrentBuffer(i);
+            m_pQueue->push();
+            m_pAvailable->release();
+        }
+        Tracer::setCurrentBuffer(0);
+    }
+
+private:
+    TraceIdQueue*   m_pQueue;
+    QSemaphore*     m_pAvailable;
+    int             m_iCount;
+};
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestTracer
+*
+* @brief The TestTracer class checks how buffers are created and continued and that recorded events end up in the
+* statistics.
+*
+*/
+class TestTracer: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestTracer();
+
+private slots:
+    void initTestCase();
+    void createBufferKeepsCurrent();
+    void consecutiveSourceBlocks();
+    void continuedBuffer();
+    void disabled();
+    void latencyStatistics();
+    void periodicCollection();
+    void idQueueOrder();
+    void idQueueOverflow();
+    void idQueueThreads();
+    void cleanupTestCase();
+
+private:
+    TraceStageStatistics stageStatistics(const QString& sName) const;
+
+    int m_iSourceStage;     /**< Stage which creates the buffers. */
+    int m_iSinkStage;       /**< Stage which works on the buffers. */
+};
+
+
+//*************************************************************************************************************
+
+TestTracer::TestTracer()
+: m_iSourceStage(-1)
+, m_iSinkStage(-1)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::initTestCase()
+{
+    m_iSourceStage = Tracer::registerStage("TestTracer::Source");
+    m_iSinkStage = Tracer::registerStage("TestTracer::Sink");
+
+    QCOMPARE(Tracer::registerStage("TestTracer::Source"), m_iSourceStage);
+    QVERIFY(m_iSinkStage != m_iSourceStage);
+
+    Tracer::setEnabled(true);
+}
+
+
+//*************************************************************************************************************
+
+TraceStageStatistics TestTracer::stageStatistics(const QString& sName) const
+{
+    QList<TraceStageStatistics> qListStatistics = Tracer::statistics();
+
+    for(int i = 0; i < qListStatistics.size(); ++i) {
+        if(qListStatistics[i].sName == sName) {
+            return qListStatistics[i];
+        }
+    }
+
+    return TraceStageStatistics();
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::createBufferKeepsCurrent()
+{
+    Tracer::setCurrentBuffer(0);
+
+    quint64 iBufferId = Tracer::createBuffer(m_iSourceStage);
+
+    QVERIFY(iBufferId != 0);
+    QCOMPARE(Tracer::currentBuffer(), (quint64)0);
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::consecutiveSourceBlocks()
+{
+    //Two blocks of a source plugin, i.e. two PluginOutputData::update() calls on the same thread
+    quint64 iFirst = 0;
+    {
+        TraceBufferScope traceBuffer(m_iSourceStage);
+        iFirst = traceBuffer.bufferId();
+        QVERIFY(iFirst != 0);
+        QCOMPARE(Tracer::currentBuffer(), iFirst);
+    }
+    QCOMPARE(Tracer::currentBuffer(), (quint64)0);
+
+    quint64 iSecond = 0;
+    {
+        TraceBufferScope traceBuffer(m_iSourceStage);
+        iSecond = traceBuffer.bufferId();
+        QCOMPARE(Tracer::currentBuffer(), iSecond);
+    }
+    QCOMPARE(Tracer::currentBuffer(), (quint64)0);
+
+    QVERIFY(iSecond != 0);
+    QVERIFY(iSecond != iFirst);
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::continuedBuffer()
+{
+    quint64 iBufferId = Tracer::createBuffer(m_iSourceStage);
+
+    //A block produced while working on a buffer continues it
+    {
+        TraceScope traceScope(m_iSinkStage, iBufferId);
+        {
+            TraceBufferScope traceBuffer(m_iSourceStage);
+            QCOMPARE(traceBuffer.bufferId(), iBufferId);
+        }
+        QCOMPARE(Tracer::currentBuffer(), iBufferId);
+    }
+
+    QCOMPARE(Tracer::currentBuffer(), (quint64)0);
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::disabled()
+{
+    Tracer::setEnabled(false);
+
+    QCOMPARE(Tracer::createBuffer(m_iSourceStage), (quint64)0);
+    {
+        TraceBufferScope traceBuffer(m_iSourceStage);
+        QCOMPARE(traceBuffer.bufferId(), (quint64)0);
+    }
+
+    Tracer::setEnabled(true);
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::latencyStatistics()
+{
+    Tracer::reset();
+
+    for(int i = 0; i < 10; ++i) {
+        TraceBufferScope traceBuffer(m_iSourceStage);
+        TraceScope traceScope(m_iSinkStage);
+    }
+
+    //Executions outside of a buffer count for the duration only
+    {
+        TraceScope traceScope(m_iSinkStage);
+    }
+
+    TraceStageStatistics stats = stageStatistics("TestTracer::Sink");
+    QCOMPARE(stats.iCount, (qint64)11);
+    QCOMPARE(stats.iLatencyCount, (qint64)10);
+    QVERIFY(stats.dDurationMax >= stats.dDurationP50);
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::periodicCollection()
+{
+    Tracer::reset();
+
+    //More events than one per thread ring holds, recorded in bursts the background collection keeps up with
+    for(int i = 0; i < 5; ++i) {
+        for(int j = 0; j < 3000; ++j) {
+            qint64 iNow = Tracer::now();
+            Tracer::record(m_iSinkStage, iNow, iNow);
+        }
+        QThread::msleep(250);
+    }
+
+    QCOMPARE(stageStatistics("TestTracer::Sink").iCount, (qint64)15000);
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::idQueueOrder()
+{
+    TraceIdQueue queue;
+
+    for(quint64 i = 1; i <= 100; ++i) {
+        Tracer::setCurrentBuffer(i);
+        queue.push();
+    }
+    Tracer::setCurrentBuffer(0);
+
+    for(quint64 i = 1; i <= 100; ++i) {
+        QCOMPARE(queue.pop(), i);
+    }
+    QCOMPARE(queue.pop(), (quint64)0);
+
+    //Clearing drops the queued ids
+    Tracer::setCurrentBuffer(7);
+    queue.push();
+    queue.clear();
+    Tracer::setCurrentBuffer(0);
+    QCOMPARE(queue.pop(), (quint64)0);
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::idQueueOverflow()
+{
+    TraceIdQueue queue;
+
+    for(quint64 i = 1; i <= TRACE_ID_QUEUE_SIZE + 10; ++i) {
+        Tracer::setCurrentBuffer(i);
+        queue.push();
+    }
+
+    for(quint64 i = 1; i <= TRACE_ID_QUEUE_SIZE; ++i) {
+        QCOMPARE(queue.pop(), i);
+    }
+
+    //The ids which did not fit are popped as 0 in their place
+    for(int i = 0; i < 10; ++i) {
+        QCOMPARE(queue.pop(), (quint64)0);
+    }
+
+    //Afterwards the ids are aligned with the pushes again
+    Tracer::setCurrentBuffer(1000);
+    queue.push();
+    Tracer::setCurrentBuffer(0);
+    QCOMPARE(queue.pop(), (quint64)1000);
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::idQueueThreads()
+{
+    TraceIdQueue queue;
+    QSemaphore available;
+    int iCount = 200000;
+
+    TraceIdProducer producer(&queue, &available, iCount);
+    producer.start();
+
+    //Every pop gets the id of its push, or 0 if the id did not fit while the consumer lagged behind
+    quint64 iLast = 0;
+    int iValid = 0;
+    bool bOrdered = true;
+    for(int i = 1; i <= iCount; ++i) {
+        available.acquire();
+        quint64 iBufferId = queue.pop();
+
+        if(iBufferId != 0) {
+            bOrdered = bOrdered && iBufferId == quint64(i) && iBufferId > iLast;
+            iLast = iBufferId;
+            ++iValid;
+        }
+    }
+
+    producer.wait();
+
+    QVERIFY(bOrdered);
+    QVERIFY(iValid > 0);
+    QCOMPARE(queue.pop(), (quint64)0);
+}
+
+
+//*************************************************************************************************************
+
+void TestTracer::cleanupTestCase()
+{
+    Tracer::setEnabled(false);
+    Tracer::reset();
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestTracer)
+#include "test_tracer.moc"
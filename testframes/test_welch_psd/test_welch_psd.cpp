@@ -0,0 +1,255 @@
+//=============================================================================================================
+/**
+* @file     test_welch_psd.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of MNE-CPP authors nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Verifies the streaming Welch PSD estimation and measures its throughput
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <utils/welchpsd.h>
+
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <unsupported/Eigen/FFT>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* DECLARE CLASS TestWelchPsd
+*
+* @brief The TestWelchPsd class compares WelchPsd against a per channel reference implementation and
+* measures the throughput on a 306-channel 1 kHz stream.
+*
+*/
+class TestWelchPsd: public QObject
+{
+    Q_OBJECT
+
+public:
+    TestWelchPsd();
+
+private slots:
+    void initTestCase();
+    void compareReference();
+    void sinePeak();
+    void whiteNoiseLevel();
+    void exponentialAveraging();
+    void benchmarkThroughput();
+    void cleanupTestCase();
+
+private:
+    double m_dSFreq;        /**< Sampling frequency of the simulated stream. */
+    int m_iChannels;        /**< Channels of the simulated stream. */
+    int m_iBlockSize;       /**< Samples per block of the simulated stream. */
+    double m_dEpsilon;      /**< Relative tolerance against the reference. */
+};
+
+
+//*************************************************************************************************************
+
+TestWelchPsd::TestWelchPsd()
+: m_dSFreq(1000.0)
+, m_iChannels(306)
+, m_iBlockSize(100)
+, m_dEpsilon(1e-10)
+{
+}
+
+
+//*************************************************************************************************************
+
+void TestWelchPsd::initTestCase()
+{
+    qDebug() << "Stream" << m_iChannels << "channels at" << m_dSFreq << "Hz in blocks of" << m_iBlockSize;
+}
+
+
+//*************************************************************************************************************
+
+void TestWelchPsd::compareReference()
+{
+    int iNfft = 256;
+    int iChannels = 7;
+    MatrixXd matData = MatrixXd::Random(iChannels, 20*m_iBlockSize + 37);
+
+    WelchPsd welch(iNfft, m_dSFreq, 0.5);
+    for(int i = 0; i < matData.cols(); i += m_iBlockSize) {
+        welch.append(matData.middleCols(i, qMin(m_iBlockSize, (int)matData.cols() - i)));
+    }
+
+    //Reference: every channel and segment transformed on its own
+    RowVectorXd vecWindow = WelchPsd::hannWindow(iNfft);
+    double dScale = 1.0 / (m_dSFreq * vecWindow.squaredNorm());
+    MatrixXd matRef = MatrixXd::Zero(iChannels, iNfft/2 + 1);
+    int iSegments = 0;
+
+    Eigen::FFT<double> fft;
+    for(int s = 0; s + iNfft <= matData.cols(); s += iNfft/2) {
+        ++iSegments;
+        for(int c = 0; c < iChannels; ++c) {
+            VectorXd vecSegment = (matData.row(c).segment(s, iNfft).array() * vecWindow.array()).transpose();
+            VectorXcd vecSpectrum;
+            fft.fwd(vecSpectrum, vecSegment);
+            for(int k = 0; k <= iNfft/2; ++k) {
+                matRef(c,k) += std::norm(vecSpectrum[k]) * dScale * ((k > 0 && k < iNfft/2) ? 2.0 : 1.0);
+            }
+        }
+    }
+    matRef /= iSegments;
+
+    QCOMPARE(welch.segmentCount(), iSegments);
+    QVERIFY((welch.psd() - matRef).norm() / matRef.norm() < m_dEpsilon);
+}
+
+
+//*************************************************************************************************************
+
+void TestWelchPsd::sinePeak()
+{
+    int iNfft = 1000;
+    double dFreq = 40.0;
+
+    MatrixXd matData(3, 10000);
+    for(int t = 0; t < matData.cols(); ++t) {
+        matData.col(t).setConstant(std::sin(2.0 * M_PI * dFreq * t / m_dSFreq));
+    }
+
+    WelchPsd welch(iNfft, m_dSFreq);
+    welch.append(matData);
+
+    RowVectorXd vecFreqs = welch.frequencies();
+    for(int c = 0; c < matData.rows(); ++c) {
+        int iPeak;
+        welch.psd().row(c).maxCoeff(&iPeak);
+        QCOMPARE(vecFreqs[iPeak], dFreq);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestWelchPsd::whiteNoiseLevel()
+{
+    //Uniform noise in [-1, 1] has variance 1/3, i.e. a one-sided density of 2/(3 fs)
+    WelchPsd welch(512, m_dSFreq);
+    welch.append(MatrixXd::Random(m_iChannels, 60000));
+
+    double dLevel = welch.psd().middleCols(1, 254).mean();
+    double dExpected = 2.0 / (3.0 * m_dSFreq);
+
+    QVERIFY(std::fabs(dLevel - dExpected) / dExpected < 0.01);
+}
+
+
+//*************************************************************************************************************
+
+void TestWelchPsd::exponentialAveraging()
+{
+    WelchPsd welch(128, m_dSFreq, 0.0, 1.0);
+
+    //With alpha = 1 only the latest segment counts
+    welch.append(MatrixXd::Random(2, 128));
+    welch.append(MatrixXd::Zero(2, 128));
+
+    QCOMPARE(welch.segmentCount(), 2);
+    QCOMPARE(welch.psd().norm(), 0.0);
+}
+
+
+//*************************************************************************************************************
+
+void TestWelchPsd::benchmarkThroughput()
+{
+    int iNfft = 1024;
+    int iNumBlocks = 3000;
+    MatrixXd matBlock = MatrixXd::Random(m_iChannels, m_iBlockSize);
+
+    WelchPsd welch(iNfft, m_dSFreq, 0.5);
+
+    QElapsedTimer timer;
+    timer.start();
+    for(int i = 0; i < iNumBlocks; ++i) {
+        welch.append(matBlock);
+    }
+    qint64 iElapsed = qMax(timer.elapsed(), (qint64)1);
+
+    double dSamplesPerSec = 1000.0 * iNumBlocks * m_iBlockSize / iElapsed;
+
+    qDebug() << "WelchPsd nfft" << iNfft << ":" << welch.segmentCount() << "segments in" << iElapsed << "ms,"
+             << dSamplesPerSec << "samples/s (" << dSamplesPerSec / m_dSFreq << "x real-time)";
+
+    QVERIFY(dSamplesPerSec > m_dSFreq);
+}
+
+
+//*************************************************************************************************************
+
+void TestWelchPsd::cleanupTestCase()
+{
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_APPLESS_MAIN(TestWelchPsd)
+#include "test_welch_psd.moc"
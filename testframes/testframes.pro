@@ -38,14 +38,28 @@ include(../mne-cpp.pri)
 TEMPLATE = subdirs
 
 SUBDIRS += \
+    test_circular_matrix_buffer \
     test_codecov \
+    test_detect_trigger \
     test_dipole_fit \
     test_fiff_rwr \
     test_fiff_mne_types_io \
     test_forward_solution \
     test_fiff_cov \
     test_fiff_digitizer \
+    test_fiff_stream_server \
+    test_hpi_demodulator \
+    test_iir_filter \
+    test_mne_math_svd \
     test_mne_msh_display_surface_set \
+    test_overlap_save_filter \
+    test_rap_music \
+    test_rt_cmd_client \
+    test_rt_data_client \
+    test_rt_processing \
+    test_shared_memory_ring \
+    test_tracer \
+    test_welch_psd \
 
 !contains(MNECPP_CONFIG, minimalVersion) {
     qtHaveModule(charts) {
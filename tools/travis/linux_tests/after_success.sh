@@ -10,7 +10,7 @@ export LD_LIBRARY_PATH=$(pwd)/lib:$LD_LIBRARY_PATH
 MNECPP_ROOT=$(pwd)
 
 # Tests to run - TODO: find required tests automatically with grep
-tests=( test_codecov test_fiff_rwr test_dipole_fit test_fiff_mne_types_io test_fiff_cov test_fiff_digitizer test_mne_msh_display_surface_set test_geometryinfo test_interpolation )
+tests=( test_codecov test_fiff_rwr test_dipole_fit test_fiff_mne_types_io test_fiff_cov test_fiff_digitizer test_mne_msh_display_surface_set test_geometryinfo test_interpolation test_circular_matrix_buffer test_detect_trigger test_fiff_stream_server test_hpi_demodulator test_iir_filter test_mne_math_svd test_overlap_save_filter test_rap_music test_rt_cmd_client test_rt_data_client test_rt_processing test_shared_memory_ring test_tracer test_welch_psd )
 
 for test in ${tests[*]};
 do
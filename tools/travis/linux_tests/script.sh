@@ -8,4 +8,8 @@ cppcheck --enable=all -f -q -i./include/3rdParty/eigen3 -i/opt/qt59/include ./MN
 qmake -r MNECPP_CONFIG+=withCodeCov
 
 # Build
-make -j2
\ No newline at end of file
+make -j2
+
+# Short load run of the mne_rt_server stream server, fails if clients which keep up lose buffers.
+# This runs here and not in after_success, since only the script phase can fail the build.
+LD_LIBRARY_PATH=$(pwd)/lib:$LD_LIBRARY_PATH ./bin/mne_rt_server_bench --clients 20 --duration 5 --report 0 --max-loss 1
\ No newline at end of file